@@ -37,6 +37,8 @@
  * sink is shut down or reaches EOS. There are also timed variants of these
  * methods, gst_app_sink_try_pull_sample() and gst_app_sink_try_pull_preroll(),
  * which accept a timeout parameter to limit the amount of time to wait.
+ * Applications that handle many small buffers can pull all the queued ones at
+ * once with gst_app_sink_try_pull_samples().
  *
  * Appsink will internally use a queue to collect buffers from the streaming
  * thread. If the application is not pulling samples fast enough, this queue
@@ -138,6 +140,9 @@ struct _GstAppSinkPrivate
   Callbacks *callbacks;
 
   GstSample *sample;
+
+  /* pool lent by the application, proposed upstream */
+  GstBufferPool *pool;
 };
 
 GST_DEBUG_CATEGORY_STATIC (app_sink_debug);
@@ -158,6 +163,7 @@ enum
   SIGNAL_TRY_PULL_SAMPLE,
   SIGNAL_TRY_PULL_OBJECT,
   SIGNAL_PROPOSE_ALLOCATION,
+  SIGNAL_TRY_PULL_SAMPLES,
 
   LAST_SIGNAL
 };
@@ -183,6 +189,7 @@ enum
   PROP_BUFFER_LIST,
   PROP_MAX_TIME,
   PROP_MAX_BYTES,
+  PROP_BUFFER_POOL,
   PROP_LAST
 };
 
@@ -324,6 +331,20 @@ gst_app_sink_class_init (GstAppSinkClass * klass)
           DEFAULT_PROP_WAIT_ON_EOS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAppSink:buffer-pool:
+   *
+   * A buffer pool of the application, proposed to upstream elements in the
+   * allocation query so that they write into buffers of the application.
+   * See gst_app_sink_set_buffer_pool() for when it is proposed.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_BUFFER_POOL,
+      g_param_spec_object ("buffer-pool", "Buffer Pool",
+          "The buffer pool to propose to upstream elements",
+          GST_TYPE_BUFFER_POOL, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstAppSink::eos:
    * @appsink: the appsink element that emitted the signal
@@ -579,6 +600,31 @@ gst_app_sink_class_init (GstAppSinkClass * klass)
       G_STRUCT_OFFSET (GstAppSinkClass, try_pull_object), NULL, NULL, NULL,
       GST_TYPE_MINI_OBJECT, 1, GST_TYPE_CLOCK_TIME);
 
+  /**
+   * GstAppSink::try-pull-samples:
+   * @appsink: the appsink element to emit this signal on
+   * @max_buffers: the maximum number of buffers to pull, 0 for all the
+   *     queued ones
+   * @timeout: the maximum amount of time to wait for a buffer
+   *
+   * This function blocks until a buffer or EOS becomes available or the
+   * appsink element is set to the READY/NULL state or the timeout expires.
+   * It then returns up to @max_buffers of the queued buffers at once in the
+   * buffer list of one sample.
+   *
+   * See gst_app_sink_try_pull_samples() for the details.
+   *
+   * Returns: (nullable): a #GstSample with a #GstBufferList or NULL when the
+   * appsink is stopped or EOS or the timeout expires.
+   *
+   * Since: 1.26
+   */
+  gst_app_sink_signals[SIGNAL_TRY_PULL_SAMPLES] =
+      g_signal_new_class_handler ("try-pull-samples",
+      G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_CALLBACK (gst_app_sink_try_pull_samples), NULL, NULL, NULL,
+      GST_TYPE_SAMPLE, 2, G_TYPE_UINT, GST_TYPE_CLOCK_TIME);
+
   gst_element_class_set_static_metadata (element_class, "AppSink",
       "Generic/Sink", "Allow the application to get access to raw buffer",
       "David Schleef <ds@schleef.org>, Wim Taymans <wim.taymans@gmail.com>");
@@ -655,6 +701,7 @@ gst_app_sink_dispose (GObject * obj)
     gst_sample_unref (priv->sample);
     priv->sample = NULL;
   }
+  gst_clear_object (&priv->pool);
   g_mutex_unlock (&priv->mutex);
 
   g_clear_pointer (&callbacks, callbacks_unref);
@@ -707,6 +754,9 @@ gst_app_sink_set_property (GObject * object, guint prop_id,
     case PROP_WAIT_ON_EOS:
       gst_app_sink_set_wait_on_eos (appsink, g_value_get_boolean (value));
       break;
+    case PROP_BUFFER_POOL:
+      gst_app_sink_set_buffer_pool (appsink, g_value_get_object (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -755,6 +805,9 @@ gst_app_sink_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_WAIT_ON_EOS:
       g_value_set_boolean (value, gst_app_sink_get_wait_on_eos (appsink));
       break;
+    case PROP_BUFFER_POOL:
+      g_value_take_object (value, gst_app_sink_get_buffer_pool (appsink));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2142,6 +2195,221 @@ not_started:
   }
 }
 
+/**
+ * gst_app_sink_try_pull_samples:
+ * @appsink: a #GstAppSink
+ * @max_buffers: the maximum number of buffers to pull, 0 for all the queued
+ *     ones
+ * @timeout: the maximum amount of time to wait for a buffer
+ *
+ * This function blocks until a buffer or EOS becomes available or the appsink
+ * element is set to the READY/NULL state or the timeout expires, like
+ * gst_app_sink_try_pull_sample(). It then takes up to @max_buffers of the
+ * buffers that are queued at that moment, without waiting for more, and
+ * returns them in the #GstBufferList of a single #GstSample.
+ *
+ * All the buffers have the caps and segment of the sample, the list ends
+ * before the next caps or segment change. Buffer lists that were rendered
+ * with #GstAppSink:buffer-list enabled are not split: the sample can hold
+ * more than @max_buffers buffers when the first list is bigger.
+ *
+ * The queue is only locked once for all the buffers, which lowers the
+ * overhead per buffer when the application handles many small buffers.
+ *
+ * Returns: (transfer full) (nullable): a #GstSample with a #GstBufferList or
+ *          NULL when the appsink is stopped or EOS or the timeout expires.
+ *          Call gst_sample_unref() after usage.
+ *
+ * Since: 1.26
+ */
+GstSample *
+gst_app_sink_try_pull_samples (GstAppSink * appsink, guint max_buffers,
+    GstClockTime timeout)
+{
+  GstAppSinkPrivate *priv;
+  GstBufferList *list;
+  GstSample *sample;
+  gboolean timeout_valid;
+  gint64 end_time;
+  guint n_buffers = 0;
+
+  g_return_val_if_fail (GST_IS_APP_SINK (appsink), NULL);
+
+  timeout_valid = GST_CLOCK_TIME_IS_VALID (timeout);
+
+  if (timeout_valid)
+    end_time =
+        g_get_monotonic_time () + timeout / (GST_SECOND / G_TIME_SPAN_SECOND);
+
+  priv = appsink->priv;
+
+  g_mutex_lock (&priv->mutex);
+  gst_buffer_replace (&priv->preroll_buffer, NULL);
+
+  while (TRUE) {
+    GST_DEBUG_OBJECT (appsink, "trying to grab buffers");
+    if (!priv->started)
+      goto not_started;
+
+    if (priv->queue_status_info.queued_buffers > 0)
+      break;
+
+    if (priv->is_eos)
+      goto eos;
+
+    /* nothing to return, wait */
+    GST_DEBUG_OBJECT (appsink, "waiting for a buffer");
+    priv->wait_status |= APP_WAITING;
+    if (timeout_valid) {
+      if (!g_cond_wait_until (&priv->cond, &priv->mutex, end_time))
+        goto expired;
+    } else {
+      g_cond_wait (&priv->cond, &priv->mutex);
+    }
+    priv->wait_status &= ~APP_WAITING;
+  }
+
+  list = gst_buffer_list_new_sized (max_buffers > 0 ?
+      MIN (max_buffers, priv->queue_status_info.queued_buffers) :
+      priv->queue_status_info.queued_buffers);
+
+  while (priv->queue_status_info.queued_buffers > 0) {
+    GstMiniObject *obj = gst_vec_deque_peek_head (priv->queue);
+
+    if (max_buffers > 0 && n_buffers >= max_buffers)
+      break;
+
+    if (GST_IS_EVENT (obj)) {
+      GstEventType type = GST_EVENT_TYPE (obj);
+
+      /* the next buffers go in the next sample */
+      if (n_buffers > 0 && (type == GST_EVENT_CAPS
+              || type == GST_EVENT_SEGMENT))
+        break;
+
+      gst_mini_object_unref (dequeue_object (appsink));
+    } else if (GST_IS_BUFFER_LIST (obj)) {
+      GstBufferList *buffer_list = GST_BUFFER_LIST_CAST (obj);
+      guint i, len = gst_buffer_list_length (buffer_list);
+
+      if (n_buffers > 0 && max_buffers > 0 && n_buffers + len > max_buffers)
+        break;
+
+      dequeue_object (appsink);
+      for (i = 0; i < len; i++)
+        gst_buffer_list_add (list,
+            gst_buffer_ref (gst_buffer_list_get (buffer_list, i)));
+      gst_buffer_list_unref (buffer_list);
+      n_buffers += len;
+    } else {
+      gst_buffer_list_add (list, GST_BUFFER_CAST (dequeue_object (appsink)));
+      n_buffers++;
+    }
+  }
+  GST_DEBUG_OBJECT (appsink, "pulled %u buffers", n_buffers);
+
+  /* a sample of its own, priv->sample would keep the buffers out of their
+   * pool until the next pull */
+  sample = gst_sample_new (NULL, priv->last_caps, &priv->last_segment, NULL);
+  gst_sample_set_buffer_list (sample, list);
+  gst_buffer_list_unref (list);
+
+  if ((priv->wait_status & STREAM_WAITING))
+    g_cond_signal (&priv->cond);
+
+  g_mutex_unlock (&priv->mutex);
+
+  return sample;
+
+  /* special conditions */
+expired:
+  {
+    GST_DEBUG_OBJECT (appsink, "timeout expired, return NULL");
+    priv->wait_status &= ~APP_WAITING;
+    g_mutex_unlock (&priv->mutex);
+    return NULL;
+  }
+eos:
+  {
+    GST_DEBUG_OBJECT (appsink, "we are EOS, return NULL");
+    g_mutex_unlock (&priv->mutex);
+    return NULL;
+  }
+not_started:
+  {
+    GST_DEBUG_OBJECT (appsink, "we are stopped, return NULL");
+    g_mutex_unlock (&priv->mutex);
+    return NULL;
+  }
+}
+
+/**
+ * gst_app_sink_set_buffer_pool:
+ * @appsink: a #GstAppSink
+ * @pool: (nullable) (transfer none): a #GstBufferPool
+ *
+ * Lend @pool to @appsink. When the application does not answer the allocation
+ * queries itself, with the #GstAppSinkCallbacks.propose_allocation callback or
+ * the #GstAppSink::propose-allocation signal, @pool is proposed to upstream
+ * elements. The buffers they allocate from it go back to @pool once the
+ * application has released the pulled samples, so buffers are not allocated
+ * again for each frame.
+ *
+ * @pool is only proposed when the application configured it, with
+ * gst_buffer_pool_set_config(), for a buffer size and for the caps of the
+ * allocation query. Its size, minimum and maximum number of buffers are
+ * proposed with it. Upstream may still set another configuration on @pool
+ * before it activates it, so the application must not rely on its own
+ * configuration being kept. This only has an effect on the next allocation
+ * query.
+ *
+ * Since: 1.26
+ */
+void
+gst_app_sink_set_buffer_pool (GstAppSink * appsink, GstBufferPool * pool)
+{
+  GstAppSinkPrivate *priv;
+
+  g_return_if_fail (GST_IS_APP_SINK (appsink));
+  g_return_if_fail (pool == NULL || GST_IS_BUFFER_POOL (pool));
+
+  priv = appsink->priv;
+
+  g_mutex_lock (&priv->mutex);
+  gst_object_replace ((GstObject **) & priv->pool, (GstObject *) pool);
+  g_mutex_unlock (&priv->mutex);
+}
+
+/**
+ * gst_app_sink_get_buffer_pool:
+ * @appsink: a #GstAppSink
+ *
+ * Get the buffer pool that was lent to @appsink with
+ * gst_app_sink_set_buffer_pool().
+ *
+ * Returns: (transfer full) (nullable): the #GstBufferPool or %NULL. Call
+ * gst_object_unref() after usage.
+ *
+ * Since: 1.26
+ */
+GstBufferPool *
+gst_app_sink_get_buffer_pool (GstAppSink * appsink)
+{
+  GstBufferPool *pool = NULL;
+  GstAppSinkPrivate *priv;
+
+  g_return_val_if_fail (GST_IS_APP_SINK (appsink), NULL);
+
+  priv = appsink->priv;
+
+  g_mutex_lock (&priv->mutex);
+  if (priv->pool)
+    pool = gst_object_ref (priv->pool);
+  g_mutex_unlock (&priv->mutex);
+
+  return pool;
+}
+
 /**
  * gst_app_sink_set_callbacks: (skip)
  * @appsink: a #GstAppSink
@@ -2236,12 +2504,15 @@ gst_app_sink_propose_allocation (GstBaseSink * bsink, GstQuery * query)
   GstAppSink *appsink = GST_APP_SINK_CAST (bsink);
   GstAppSinkPrivate *priv = appsink->priv;
   Callbacks *callbacks = NULL;
+  GstBufferPool *pool = NULL;
   gboolean emit;
 
   g_mutex_lock (&priv->mutex);
   emit = priv->emit_signals;
   if (priv->callbacks)
     callbacks = callbacks_ref (priv->callbacks);
+  if (priv->pool)
+    pool = gst_object_ref (priv->pool);
   g_mutex_unlock (&priv->mutex);
 
   if (callbacks && callbacks->callbacks.propose_allocation) {
@@ -2253,7 +2524,31 @@ gst_app_sink_propose_allocation (GstBaseSink * bsink, GstQuery * query)
         query, &ret);
   }
 
+  /* the application did not answer the query itself, propose its pool when
+   * it was configured for the caps of the query */
+  if (!ret && pool) {
+    GstStructure *config;
+    GstCaps *caps, *query_caps;
+    guint size, min, max;
+
+    gst_query_parse_allocation (query, &query_caps, NULL);
+
+    config = gst_buffer_pool_get_config (pool);
+    if (gst_buffer_pool_config_get_params (config, &caps, &size, &min, &max)
+        && size > 0 && caps && query_caps
+        && gst_caps_is_equal (caps, query_caps)) {
+      GST_DEBUG_OBJECT (appsink, "proposing pool %" GST_PTR_FORMAT, pool);
+      gst_query_add_allocation_pool (query, pool, size, min, max);
+      ret = TRUE;
+    } else {
+      GST_DEBUG_OBJECT (appsink, "pool %" GST_PTR_FORMAT " is not configured "
+          "for caps %" GST_PTR_FORMAT, pool, query_caps);
+    }
+    gst_structure_free (config);
+  }
+
   g_clear_pointer (&callbacks, callbacks_unref);
+  gst_clear_object (&pool);
 
   return ret;
 }
@@ -199,6 +199,16 @@ GstSample *     gst_app_sink_try_pull_sample  (GstAppSink *appsink, GstClockTime
 GST_APP_API
 GstMiniObject * gst_app_sink_try_pull_object    (GstAppSink *appsink, GstClockTime timeout);
 
+GST_APP_API
+GstSample *     gst_app_sink_try_pull_samples (GstAppSink *appsink, guint max_buffers,
+                                               GstClockTime timeout);
+
+GST_APP_API
+void            gst_app_sink_set_buffer_pool  (GstAppSink *appsink, GstBufferPool *pool);
+
+GST_APP_API
+GstBufferPool * gst_app_sink_get_buffer_pool  (GstAppSink *appsink);
+
 GST_APP_API
 void            gst_app_sink_set_callbacks    (GstAppSink * appsink,
                                                GstAppSinkCallbacks *callbacks,
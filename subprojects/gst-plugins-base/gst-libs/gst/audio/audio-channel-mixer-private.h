@@ -0,0 +1,36 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_AUDIO_CHANNEL_MIXER_PRIVATE_H__
+#define __GST_AUDIO_CHANNEL_MIXER_PRIVATE_H__
+
+#include "audio-channel-mixer.h"
+
+G_BEGIN_DECLS
+
+/* Mixes the samples @start to @end of the output channels @first to @last,
+ * excluded. Different ranges can be mixed at the same time from different
+ * threads. */
+G_GNUC_INTERNAL
+void gst_audio_channel_mixer_samples_range (GstAudioChannelMixer * mix,
+    const gpointer in[], gpointer out[], gint start, gint end, gint first,
+    gint last);
+
+G_END_DECLS
+
+#endif /* __GST_AUDIO_CHANNEL_MIXER_PRIVATE_H__ */
@@ -28,6 +28,7 @@
 #include <string.h>
 
 #include "audio-channel-mixer.h"
+#include "audio-channel-mixer-private.h"
 
 #ifndef GST_DISABLE_GST_DEBUG
 #define GST_CAT_DEFAULT ensure_debug_category()
@@ -54,8 +55,21 @@ ensure_debug_category (void)
 
 #define PRECISION_INT 10
 
+/* The samples are mixed in blocks of this many frames. The sums of a block
+ * are kept in a small array on the stack, so they stay in the cache while
+ * all the input channels of an output channel are added. */
+#define MIX_BLOCK_FRAMES 128
+
 typedef void (*MixerFunc) (GstAudioChannelMixer * mix, const gpointer src[],
-    gpointer dst[], gint samples);
+    gpointer dst[], gint start, gint end, gint first, gint last);
+
+/* a non zero coefficient of the matrix */
+typedef struct
+{
+  gint in;
+  gfloat coeff;
+  gint coeff_int;
+} MixerTap;
 
 struct _GstAudioChannelMixer
 {
@@ -70,6 +84,18 @@ struct _GstAudioChannelMixer
    * this is matrix * (2^10) as integers */
   gint **matrix_int;
 
+  /* the non zero coefficients, grouped by output channel. The ones of output
+   * channel j are taps[taps_offset[j]] up to taps[taps_offset[j + 1]],
+   * excluded. Only these are used when mixing, so sparse matrices, like
+   * the ones that mix a few of many channels, are cheap. */
+  MixerTap *taps;
+  gint *taps_offset;
+
+  /* when every output channel is silent or a copy of one input channel, the
+   * input channel of each output channel or -1. Reordering, selecting or
+   * duplicating channels is then done without any arithmetic. */
+  gint *route;
+
   MixerFunc func;
 };
 
@@ -95,6 +121,10 @@ gst_audio_channel_mixer_free (GstAudioChannelMixer * mix)
   g_free (mix->matrix_int);
   mix->matrix_int = NULL;
 
+  g_free (mix->taps);
+  g_free (mix->taps_offset);
+  g_free (mix->route);
+
   g_free (mix);
 }
 
@@ -798,6 +828,56 @@ gst_audio_channel_mixer_setup_matrix_int (GstAudioChannelMixer * mix)
   }
 }
 
+/* only call after mix->matrix_int is set up. The integer formats use the
+ * integer matrix, where small coefficients can become 0. */
+static void
+gst_audio_channel_mixer_setup_taps (GstAudioChannelMixer * mix,
+    gboolean is_int)
+{
+  gint i, j, n_taps = 0;
+  gboolean route = TRUE;
+
+  mix->taps = g_new (MixerTap, mix->in_channels * mix->out_channels);
+  mix->taps_offset = g_new (gint, mix->out_channels + 1);
+
+  for (j = 0; j < mix->out_channels; j++) {
+    mix->taps_offset[j] = n_taps;
+
+    for (i = 0; i < mix->in_channels; i++) {
+      if (is_int ? mix->matrix_int[i][j] == 0 : mix->matrix[i][j] == 0.0f)
+        continue;
+
+      mix->taps[n_taps].in = i;
+      mix->taps[n_taps].coeff = mix->matrix[i][j];
+      mix->taps[n_taps].coeff_int = mix->matrix_int[i][j];
+      n_taps++;
+    }
+
+    /* a single coefficient of 1 copies the input channel. For the integer
+     * formats the rounding of the result makes that exact too. */
+    if (n_taps - mix->taps_offset[j] > 1)
+      route = FALSE;
+    else if (n_taps - mix->taps_offset[j] == 1
+        && (is_int ? mix->taps[n_taps - 1].coeff_int != (1 << PRECISION_INT)
+            : mix->taps[n_taps - 1].coeff != 1.0f))
+      route = FALSE;
+  }
+  mix->taps_offset[mix->out_channels] = n_taps;
+
+  GST_DEBUG ("%d non zero coefficients out of %d, route %d", n_taps,
+      mix->in_channels * mix->out_channels, route);
+
+  if (route) {
+    mix->route = g_new (gint, mix->out_channels);
+    for (j = 0; j < mix->out_channels; j++) {
+      if (mix->taps_offset[j] < mix->taps_offset[j + 1])
+        mix->route[j] = mix->taps[mix->taps_offset[j]].in;
+      else
+        mix->route[j] = -1;
+    }
+  }
+}
+
 static gfloat **
 gst_audio_channel_mixer_setup_matrix (GstAudioChannelMixerFlags flags,
     gint in_channels, GstAudioChannelPosition * in_position,
@@ -848,34 +928,94 @@ _get_out_data_planar_##type (type * out_data[], \
 { \
   (void) total_channels; \
   return &out_data[channel][sample]; \
+} \
+\
+static inline const type * \
+_get_in_ptr_interleaved_##type (const type * in_data[], \
+    gint sample, gint channel, gint total_channels, gint * stride) \
+{ \
+  *stride = total_channels; \
+  return &in_data[0][sample * total_channels + channel]; \
+} \
+\
+static inline const type * \
+_get_in_ptr_planar_##type (const type * in_data[], \
+    gint sample, gint channel, gint total_channels, gint * stride) \
+{ \
+  (void) total_channels; \
+  *stride = 1; \
+  return &in_data[channel][sample]; \
+}
+
+/* All the kernels mix the frames @start to @end of the output channels
+ * @first to @last, block by block and one output channel at a time. */
+
+#define DEFINE_ROUTE_FUNC(name, type, inlayout, outlayout) \
+static void \
+gst_audio_channel_mixer_route_##name##_##inlayout##_##outlayout ( \
+    GstAudioChannelMixer * mix, const type * in_data[], \
+    type * out_data[], gint start, gint end, gint first, gint last) \
+{ \
+  gint in, out, n, n0, len; \
+  gint inchannels, outchannels; \
+  \
+  inchannels = mix->in_channels; \
+  outchannels = mix->out_channels; \
+  \
+  for (n0 = start; n0 < end; n0 += len) { \
+    len = MIN (end - n0, MIX_BLOCK_FRAMES); \
+    \
+    for (out = first; out < last; out++) { \
+      in = mix->route[out]; \
+      \
+      if (in < 0) { \
+        for (n = n0; n < n0 + len; n++) \
+          *_get_out_data_##outlayout##_##type (out_data, n, out, outchannels) = 0; \
+      } else { \
+        for (n = n0; n < n0 + len; n++) \
+          *_get_out_data_##outlayout##_##type (out_data, n, out, outchannels) = \
+              _get_in_data_##inlayout##_##type (in_data, n, in, inchannels); \
+      } \
+    } \
+  } \
 }
 
 #define DEFINE_INTEGER_MIX_FUNC(bits, resbits, inlayout, outlayout) \
 static void \
 gst_audio_channel_mixer_mix_int##bits##_##inlayout##_##outlayout ( \
     GstAudioChannelMixer * mix, const gint##bits * in_data[], \
-    gint##bits * out_data[], gint samples) \
+    gint##bits * out_data[], gint start, gint end, gint first, gint last) \
 { \
-  gint in, out, n; \
-  gint##resbits res; \
+  gint out, n, n0, len, t, stride; \
+  const gint##bits *ip; \
+  gint##resbits coeff, res[MIX_BLOCK_FRAMES]; \
   gint inchannels, outchannels; \
   \
   inchannels = mix->in_channels; \
   outchannels = mix->out_channels; \
   \
-  for (n = 0; n < samples; n++) { \
-    for (out = 0; out < outchannels; out++) { \
+  for (n0 = start; n0 < end; n0 += len) { \
+    len = MIN (end - n0, MIX_BLOCK_FRAMES); \
+    \
+    for (out = first; out < last; out++) { \
+      for (n = 0; n < len; n++) \
+        res[n] = 0; \
+      \
       /* convert */ \
-      res = 0; \
-      for (in = 0; in < inchannels; in++) \
-        res += \
-          _get_in_data_##inlayout##_gint##bits (in_data, n, in, inchannels) * \
-          (gint##resbits) mix->matrix_int[in][out]; \
+      for (t = mix->taps_offset[out]; t < mix->taps_offset[out + 1]; t++) { \
+        ip = _get_in_ptr_##inlayout##_gint##bits (in_data, n0, \
+            mix->taps[t].in, inchannels, &stride); \
+        coeff = mix->taps[t].coeff_int; \
+        for (n = 0; n < len; n++) \
+          res[n] += ip[n * stride] * coeff; \
+      } \
       \
-      /* remove factor from int matrix */ \
-      res = (res + (1 << (PRECISION_INT - 1))) >> PRECISION_INT; \
-      *_get_out_data_##outlayout##_gint##bits (out_data, n, out, outchannels) = \
-          CLAMP (res, G_MININT##bits, G_MAXINT##bits); \
+      for (n = 0; n < len; n++) { \
+        /* remove factor from int matrix */ \
+        gint##resbits r = (res[n] + (1 << (PRECISION_INT - 1))) >> PRECISION_INT; \
+        *_get_out_data_##outlayout##_gint##bits (out_data, n0 + n, out, \
+            outchannels) = CLAMP (r, G_MININT##bits, G_MAXINT##bits); \
+      } \
     } \
   } \
 }
@@ -884,25 +1024,36 @@ gst_audio_channel_mixer_mix_int##bits##_##inlayout##_##outlayout ( \
 static void \
 gst_audio_channel_mixer_mix_##type##_##inlayout##_##outlayout ( \
     GstAudioChannelMixer * mix, const g##type * in_data[], \
-    g##type * out_data[], gint samples) \
+    g##type * out_data[], gint start, gint end, gint first, gint last) \
 { \
-  gint in, out, n; \
-  g##type res; \
+  gint out, n, n0, len, t, stride; \
+  const g##type *ip; \
+  gfloat coeff; \
+  g##type res[MIX_BLOCK_FRAMES]; \
   gint inchannels, outchannels; \
   \
   inchannels = mix->in_channels; \
   outchannels = mix->out_channels; \
   \
-  for (n = 0; n < samples; n++) { \
-    for (out = 0; out < outchannels; out++) { \
+  for (n0 = start; n0 < end; n0 += len) { \
+    len = MIN (end - n0, MIX_BLOCK_FRAMES); \
+    \
+    for (out = first; out < last; out++) { \
+      for (n = 0; n < len; n++) \
+        res[n] = 0.0; \
+      \
       /* convert */ \
-      res = 0.0; \
-      for (in = 0; in < inchannels; in++) \
-        res += \
-          _get_in_data_##inlayout##_g##type (in_data, n, in, inchannels) * \
-          mix->matrix[in][out]; \
+      for (t = mix->taps_offset[out]; t < mix->taps_offset[out + 1]; t++) { \
+        ip = _get_in_ptr_##inlayout##_g##type (in_data, n0, \
+            mix->taps[t].in, inchannels, &stride); \
+        coeff = mix->taps[t].coeff; \
+        for (n = 0; n < len; n++) \
+          res[n] += ip[n * stride] * coeff; \
+      } \
       \
-      *_get_out_data_##outlayout##_g##type (out_data, n, out, outchannels) = res; \
+      for (n = 0; n < len; n++) \
+        *_get_out_data_##outlayout##_g##type (out_data, n0 + n, out, \
+            outchannels) = res[n]; \
     } \
   } \
 }
@@ -912,24 +1063,61 @@ DEFINE_INTEGER_MIX_FUNC (16, 32, interleaved, interleaved);
 DEFINE_INTEGER_MIX_FUNC (16, 32, interleaved, planar);
 DEFINE_INTEGER_MIX_FUNC (16, 32, planar, interleaved);
 DEFINE_INTEGER_MIX_FUNC (16, 32, planar, planar);
+DEFINE_ROUTE_FUNC (int16, gint16, interleaved, interleaved);
+DEFINE_ROUTE_FUNC (int16, gint16, interleaved, planar);
+DEFINE_ROUTE_FUNC (int16, gint16, planar, interleaved);
+DEFINE_ROUTE_FUNC (int16, gint16, planar, planar);
 
 DEFINE_GET_DATA_FUNCS (gint32);
 DEFINE_INTEGER_MIX_FUNC (32, 64, interleaved, interleaved);
 DEFINE_INTEGER_MIX_FUNC (32, 64, interleaved, planar);
 DEFINE_INTEGER_MIX_FUNC (32, 64, planar, interleaved);
 DEFINE_INTEGER_MIX_FUNC (32, 64, planar, planar);
+DEFINE_ROUTE_FUNC (int32, gint32, interleaved, interleaved);
+DEFINE_ROUTE_FUNC (int32, gint32, interleaved, planar);
+DEFINE_ROUTE_FUNC (int32, gint32, planar, interleaved);
+DEFINE_ROUTE_FUNC (int32, gint32, planar, planar);
 
 DEFINE_GET_DATA_FUNCS (gfloat);
 DEFINE_FLOAT_MIX_FUNC (float, interleaved, interleaved);
 DEFINE_FLOAT_MIX_FUNC (float, interleaved, planar);
 DEFINE_FLOAT_MIX_FUNC (float, planar, interleaved);
 DEFINE_FLOAT_MIX_FUNC (float, planar, planar);
+DEFINE_ROUTE_FUNC (float, gfloat, interleaved, interleaved);
+DEFINE_ROUTE_FUNC (float, gfloat, interleaved, planar);
+DEFINE_ROUTE_FUNC (float, gfloat, planar, interleaved);
+DEFINE_ROUTE_FUNC (float, gfloat, planar, planar);
 
 DEFINE_GET_DATA_FUNCS (gdouble);
 DEFINE_FLOAT_MIX_FUNC (double, interleaved, interleaved);
 DEFINE_FLOAT_MIX_FUNC (double, interleaved, planar);
 DEFINE_FLOAT_MIX_FUNC (double, planar, interleaved);
 DEFINE_FLOAT_MIX_FUNC (double, planar, planar);
+DEFINE_ROUTE_FUNC (double, gdouble, interleaved, interleaved);
+DEFINE_ROUTE_FUNC (double, gdouble, interleaved, planar);
+DEFINE_ROUTE_FUNC (double, gdouble, planar, interleaved);
+DEFINE_ROUTE_FUNC (double, gdouble, planar, planar);
+
+#define MIXER_FUNCS(prefix, name) {                                     \
+  { (MixerFunc) prefix##_##name##_interleaved_interleaved,              \
+    (MixerFunc) prefix##_##name##_interleaved_planar },                 \
+  { (MixerFunc) prefix##_##name##_planar_interleaved,                   \
+    (MixerFunc) prefix##_##name##_planar_planar } }
+
+/* indexed by format, non interleaved input and non interleaved output */
+static const MixerFunc mix_funcs[4][2][2] = {
+  MIXER_FUNCS (gst_audio_channel_mixer_mix, int16),
+  MIXER_FUNCS (gst_audio_channel_mixer_mix, int32),
+  MIXER_FUNCS (gst_audio_channel_mixer_mix, float),
+  MIXER_FUNCS (gst_audio_channel_mixer_mix, double)
+};
+
+static const MixerFunc route_funcs[4][2][2] = {
+  MIXER_FUNCS (gst_audio_channel_mixer_route, int16),
+  MIXER_FUNCS (gst_audio_channel_mixer_route, int32),
+  MIXER_FUNCS (gst_audio_channel_mixer_route, float),
+  MIXER_FUNCS (gst_audio_channel_mixer_route, double)
+};
 
 /**
  * gst_audio_channel_mixer_new_with_matrix: (skip):
@@ -953,6 +1141,8 @@ gst_audio_channel_mixer_new_with_matrix (GstAudioChannelMixerFlags flags,
     gint in_channels, gint out_channels, gfloat ** matrix)
 {
   GstAudioChannelMixer *mix;
+  gint format_index = 0;
+  gboolean in_planar, out_planar;
 
   g_return_val_if_fail (format == GST_AUDIO_FORMAT_S16
       || format == GST_AUDIO_FORMAT_S32
@@ -1010,85 +1200,32 @@ gst_audio_channel_mixer_new_with_matrix (GstAudioChannelMixerFlags flags,
 
   switch (format) {
     case GST_AUDIO_FORMAT_S16:
-      if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN) {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int16_planar_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int16_planar_interleaved;
-        }
-      } else {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int16_interleaved_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int16_interleaved_interleaved;
-        }
-      }
+      format_index = 0;
       break;
     case GST_AUDIO_FORMAT_S32:
-      if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN) {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int32_planar_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int32_planar_interleaved;
-        }
-      } else {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int32_interleaved_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int32_interleaved_interleaved;
-        }
-      }
+      format_index = 1;
       break;
     case GST_AUDIO_FORMAT_F32:
-      if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN) {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_float_planar_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_float_planar_interleaved;
-        }
-      } else {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_float_interleaved_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_float_interleaved_interleaved;
-        }
-      }
+      format_index = 2;
       break;
     case GST_AUDIO_FORMAT_F64:
-      if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN) {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_double_planar_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_double_planar_interleaved;
-        }
-      } else {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_double_interleaved_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_double_interleaved_interleaved;
-        }
-      }
+      format_index = 3;
       break;
     default:
       g_assert_not_reached ();
       break;
   }
+
+  gst_audio_channel_mixer_setup_taps (mix, format_index < 2);
+
+  in_planar = (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN) != 0;
+  out_planar = (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) != 0;
+
+  if (mix->route)
+    mix->func = route_funcs[format_index][in_planar][out_planar];
+  else
+    mix->func = mix_funcs[format_index][in_planar][out_planar];
+
   return mix;
 }
 
@@ -1192,5 +1329,17 @@ gst_audio_channel_mixer_samples (GstAudioChannelMixer * mix,
   g_return_if_fail (mix != NULL);
   g_return_if_fail (mix->matrix != NULL);
 
-  mix->func (mix, in, out, samples);
+  mix->func (mix, in, out, 0, samples, 0, mix->out_channels);
+}
+
+void
+gst_audio_channel_mixer_samples_range (GstAudioChannelMixer * mix,
+    const gpointer in[], gpointer out[], gint start, gint end, gint first,
+    gint last)
+{
+  g_return_if_fail (mix != NULL);
+  g_return_if_fail (mix->matrix != NULL);
+  g_return_if_fail (first >= 0 && last <= mix->out_channels);
+
+  mix->func (mix, in, out, start, end, first, last);
 }
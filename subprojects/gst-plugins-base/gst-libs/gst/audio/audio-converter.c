@@ -28,6 +28,7 @@
 #include <string.h>
 
 #include "audio-converter.h"
+#include "audio-channel-mixer-private.h"
 #include "gstaudiopack.h"
 
 /**
@@ -123,6 +124,9 @@ struct _GstAudioConverter
   /* channel mix */
   gboolean mix_passthrough;
   GstAudioChannelMixer *mix;
+  GstAudioLayout mix_layout;
+  guint mix_threads;
+  GstTaskPool *mix_pool;
 
   /* resample */
   GstAudioResampler *resampler;
@@ -293,6 +297,7 @@ get_opt_value (GstAudioConverter * convert, const gchar * opt)
 #define DEFAULT_OPT_DITHER_THRESHOLD 20
 #define DEFAULT_OPT_NOISE_SHAPING_METHOD GST_AUDIO_NOISE_SHAPING_NONE
 #define DEFAULT_OPT_QUANTIZATION 1
+#define DEFAULT_OPT_THREADS 1
 
 #define GET_OPT_RESAMPLER_METHOD(c) get_opt_enum(c, \
     GST_AUDIO_CONVERTER_OPT_RESAMPLER_METHOD, GST_TYPE_AUDIO_RESAMPLER_METHOD, \
@@ -307,6 +312,8 @@ get_opt_value (GstAudioConverter * convert, const gchar * opt)
     DEFAULT_OPT_NOISE_SHAPING_METHOD)
 #define GET_OPT_QUANTIZATION(c) get_opt_uint(c, \
     GST_AUDIO_CONVERTER_OPT_QUANTIZATION, DEFAULT_OPT_QUANTIZATION)
+#define GET_OPT_THREADS(c) get_opt_uint(c, \
+    GST_AUDIO_CONVERTER_OPT_THREADS, DEFAULT_OPT_THREADS)
 #define GET_OPT_MIX_MATRIX(c) get_opt_value(c, \
     GST_AUDIO_CONVERTER_OPT_MIX_MATRIX)
 
@@ -512,6 +519,90 @@ do_convert_in (AudioChain * chain, gpointer user_data)
   return TRUE;
 }
 
+/* a thread mixes at least this many output channels or frames */
+#define MIX_MIN_CHANNELS_PER_THREAD 4
+#define MIX_MIN_FRAMES_PER_THREAD 256
+/* and at least this many output samples */
+#define MIX_MIN_SAMPLES_PER_THREAD (16 * 1024)
+
+typedef struct
+{
+  GstAudioChannelMixer *mix;
+  gpointer *in;
+  gpointer *out;
+  gint start, end;
+  gint first, last;
+} MixTask;
+
+static void
+mix_task_func (gpointer data)
+{
+  MixTask *task = data;
+
+  gst_audio_channel_mixer_samples_range (task->mix, task->in, task->out,
+      task->start, task->end, task->first, task->last);
+}
+
+/* Planar output is split in groups of channels. Interleaved output is split
+ * in ranges of frames instead, the threads would otherwise write to the same
+ * cache lines. */
+static void
+mix_samples (GstAudioConverter * convert, gpointer in[], gpointer out[],
+    gsize num_samples, gboolean out_planar)
+{
+  gint channels = convert->out.channels;
+  gsize units, n_tasks, i;
+  gpointer *ids;
+  MixTask *tasks;
+
+  units = out_planar ? channels / MIX_MIN_CHANNELS_PER_THREAD :
+      num_samples / MIX_MIN_FRAMES_PER_THREAD;
+  n_tasks = MIN (convert->mix_threads, units);
+  n_tasks = MIN (n_tasks, num_samples * channels / MIX_MIN_SAMPLES_PER_THREAD);
+
+  if (n_tasks <= 1) {
+    gst_audio_channel_mixer_samples (convert->mix, in, out, num_samples);
+    return;
+  }
+
+  GST_LOG ("mix %" G_GSIZE_FORMAT " frames with %" G_GSIZE_FORMAT " threads",
+      num_samples, n_tasks);
+
+  tasks = g_newa (MixTask, n_tasks);
+  ids = g_newa (gpointer, n_tasks);
+
+  for (i = 0; i < n_tasks; i++) {
+    tasks[i].mix = convert->mix;
+    tasks[i].in = in;
+    tasks[i].out = out;
+    if (out_planar) {
+      tasks[i].start = 0;
+      tasks[i].end = num_samples;
+      tasks[i].first = channels * i / n_tasks;
+      tasks[i].last = channels * (i + 1) / n_tasks;
+    } else {
+      tasks[i].start = num_samples * i / n_tasks;
+      tasks[i].end = num_samples * (i + 1) / n_tasks;
+      tasks[i].first = 0;
+      tasks[i].last = channels;
+    }
+  }
+
+  /* the calling thread does the first part */
+  for (i = 1; i < n_tasks; i++)
+    ids[i] = gst_task_pool_push (convert->mix_pool, mix_task_func, &tasks[i],
+        NULL);
+
+  mix_task_func (&tasks[0]);
+
+  for (i = 1; i < n_tasks; i++) {
+    if (ids[i])
+      gst_task_pool_join (convert->mix_pool, ids[i]);
+    else
+      mix_task_func (&tasks[i]);
+  }
+}
+
 static gboolean
 do_mix (AudioChain * chain, gpointer user_data)
 {
@@ -523,7 +614,8 @@ do_mix (AudioChain * chain, gpointer user_data)
   out = (chain->allow_ip ? in : audio_chain_alloc_samples (chain, num_samples));
   GST_LOG ("mix %p, %p, %" G_GSIZE_FORMAT, in, out, num_samples);
 
-  gst_audio_channel_mixer_samples (convert->mix, in, out, num_samples);
+  mix_samples (convert, in, out, num_samples,
+      convert->mix_layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED);
 
   audio_chain_set_samples (chain, out, num_samples);
 
@@ -833,14 +925,21 @@ chain_mix (GstAudioConverter * convert, AudioChain * prev)
   GstAudioFormat format = convert->current_format;
   const GValue *opt_matrix = GET_OPT_MIX_MATRIX (convert);
   GstAudioChannelMixerFlags flags = 0;
+  gboolean change_layout;
 
   convert->current_channels = out->channels;
 
-  /* keep the input layout */
-  if (convert->current_layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED) {
+  /* Without resampler, the mixer also changes the layout so that the
+   * samples don't need to be copied once more. Otherwise the input layout is
+   * kept and the resampler changes it. */
+  change_layout = in->rate == out->rate
+      && !(convert->flags & GST_AUDIO_CONVERTER_FLAG_VARIABLE_RATE);
+  convert->mix_layout = change_layout ? out->layout : convert->current_layout;
+
+  if (convert->current_layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED)
     flags |= GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN;
+  if (convert->mix_layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED)
     flags |= GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT;
-  }
 
   if (opt_matrix) {
     gfloat **matrix = NULL;
@@ -872,6 +971,16 @@ chain_mix (GstAudioConverter * convert, AudioChain * prev)
       in->channels, out->channels);
 
   if (!convert->mix_passthrough) {
+    convert->current_layout = convert->mix_layout;
+
+    convert->mix_threads = GET_OPT_THREADS (convert);
+    if (convert->mix_threads == 0)
+      convert->mix_threads = g_get_num_processors ();
+    if (convert->mix_threads > 1)
+      convert->mix_pool =
+          gst_object_ref (gst_work_stealing_task_pool_get_default ());
+    GST_INFO ("mix with up to %u threads", convert->mix_threads);
+
     prev = audio_chain_new (prev, convert);
     prev->allow_ip = FALSE;
     prev->pass_alloc = FALSE;
@@ -954,6 +1063,7 @@ chain_quantize (GstAudioConverter * convert, AudioChain * prev)
   GstAudioDitherMethod dither;
   guint dither_threshold;
   GstAudioNoiseShapingMethod ns;
+  GstAudioQuantizeFlags flags = 0;
 
   dither = GET_OPT_DITHER_METHOD (convert);
   dither_threshold = GET_OPT_DITHER_THRESHOLD (convert);
@@ -988,8 +1098,12 @@ chain_quantize (GstAudioConverter * convert, AudioChain * prev)
   if (out_int && out_depth < 32
       && convert->current_format == GST_AUDIO_FORMAT_S32) {
     GST_INFO ("quantize to %d bits, dither %d, ns %d", out_depth, dither, ns);
+    /* the mixer or the resampler may have changed the layout already */
+    if (convert->current_layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED)
+      flags |= GST_AUDIO_QUANTIZE_FLAG_NON_INTERLEAVED;
+
     convert->quant =
-        gst_audio_quantize_new (dither, ns, 0, convert->current_format,
+        gst_audio_quantize_new (dither, ns, flags, convert->current_format,
         out->channels, 1U << (32 - out_depth));
 
     prev = audio_chain_new (prev, convert);
@@ -1288,6 +1402,33 @@ converter_generic (GstAudioConverter * convert,
   return TRUE;
 }
 
+/* the mixer reads the input samples and writes the output samples directly,
+ * changing the layout if needed */
+static gboolean
+converter_mix (GstAudioConverter * convert,
+    GstAudioConverterFlags flags, gpointer in[], gsize in_frames,
+    gpointer out[], gsize out_frames)
+{
+  AudioChain *chain;
+  gint i;
+
+  chain = convert->chain_end;
+
+  GST_LOG ("mix: %" G_GSIZE_FORMAT " frames", in_frames);
+
+  if (in) {
+    mix_samples (convert, in, out, in_frames,
+        convert->mix_layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED);
+  } else {
+    gsize bytes = in_frames * chain->inc * (convert->out.bpf /
+        convert->out.channels);
+
+    for (i = 0; i < chain->blocks; i++)
+      gst_audio_format_info_fill_silence (convert->out.finfo, out[i], bytes);
+  }
+  return TRUE;
+}
+
 static gboolean
 converter_resample (GstAudioConverter * convert,
     GstAudioConverterFlags flags, gpointer in[], gsize in_frames,
@@ -1428,6 +1569,12 @@ gst_audio_converter_new (GstAudioConverterFlags flags, GstAudioInfo * in_info,
         }
       }
     }
+  } else if (out_info->finfo->format == in_info->finfo->format
+      && is_intermediate_format (in_info->finfo->format)
+      && convert->resampler == NULL && convert->quant == NULL
+      && convert->mix_layout == out_info->layout) {
+    GST_INFO ("same formats and no resampler -> only mixing");
+    convert->convert = converter_mix;
   }
 
   setup_allocators (convert);
@@ -1474,6 +1621,7 @@ gst_audio_converter_free (GstAudioConverter * convert)
     gst_audio_quantize_free (convert->quant);
   if (convert->mix)
     gst_audio_channel_mixer_free (convert->mix);
+  gst_clear_object (&convert->mix_pool);
   if (convert->resampler)
     gst_audio_resampler_free (convert->resampler);
   gst_audio_info_init (&convert->in);
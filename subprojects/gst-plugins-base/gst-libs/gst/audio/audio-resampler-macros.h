@@ -27,6 +27,61 @@
 #define PRECISION_S16 15
 #define PRECISION_S32 31
 
+/* The last steps of the integer inner products on the sums of the products
+ * with each of the filters. The vectorized versions that reduce their sums
+ * before calling these give the same results as the C versions. */
+static inline gint16
+inner_product_gint16_result (gint32 res)
+{
+  res = (res + (1 << (PRECISION_S16 - 1))) >> PRECISION_S16;
+  return CLAMP (res, G_MININT16, G_MAXINT16);
+}
+
+static inline gint16
+inner_product_gint16_linear_result (gint32 r0, gint32 r1, const gint16 * ic)
+{
+  r0 = (gint16) (r0 >> PRECISION_S16);
+  r1 = (gint16) (r1 >> PRECISION_S16);
+  return inner_product_gint16_result ((r0 - r1) * ic[0] +
+      (r1 << PRECISION_S16));
+}
+
+static inline gint16
+inner_product_gint16_cubic_result (const gint32 r[4], const gint16 * ic)
+{
+  return inner_product_gint16_result (
+      (gint32) (gint16) (r[0] >> PRECISION_S16) * ic[0] +
+      (gint32) (gint16) (r[1] >> PRECISION_S16) * ic[1] +
+      (gint32) (gint16) (r[2] >> PRECISION_S16) * ic[2] +
+      (gint32) (gint16) (r[3] >> PRECISION_S16) * ic[3]);
+}
+
+static inline gint32
+inner_product_gint32_result (gint64 res)
+{
+  res = (res + ((gint64) 1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  return CLAMP (res, G_MININT32, G_MAXINT32);
+}
+
+static inline gint32
+inner_product_gint32_linear_result (gint64 r0, gint64 r1, const gint32 * ic)
+{
+  r0 = (gint32) (r0 >> PRECISION_S32);
+  r1 = (gint32) (r1 >> PRECISION_S32);
+  return inner_product_gint32_result ((r0 - r1) * ic[0] +
+      (r1 << PRECISION_S32));
+}
+
+static inline gint32
+inner_product_gint32_cubic_result (const gint64 r[4], const gint32 * ic)
+{
+  return inner_product_gint32_result (
+      (gint64) (gint32) (r[0] >> PRECISION_S32) * ic[0] +
+      (gint64) (gint32) (r[1] >> PRECISION_S32) * ic[1] +
+      (gint64) (gint32) (r[2] >> PRECISION_S32) * ic[2] +
+      (gint64) (gint32) (r[3] >> PRECISION_S32) * ic[3]);
+}
+
 #define DECL_GET_TAPS_FULL_FUNC(type)                           \
 gpointer                                                        \
 get_taps_##type##_full (GstAudioResampler * resampler,          \
@@ -60,6 +115,11 @@ resample_ ##type## _ ##inter## _ ##channels## _ ##arch (GstAudioResampler * resa
     gpointer in[], gsize in_len,  gpointer out[], gsize out_len,        \
     gsize * consumed)
 
+/* The output is produced in chunks of frames for all blocks, so that the
+ * interleaved output of many channels and the filter taps stay in the cache
+ * while the blocks are processed. All blocks use the same sample positions. */
+#define RESAMPLE_CHUNK_BYTES (32 * 1024)
+
 #define MAKE_RESAMPLE_FUNC(type,inter,channels,arch)            \
 DECL_RESAMPLE_FUNC (type, inter, channels, arch)                \
 {                                                               \
@@ -68,30 +128,44 @@ DECL_RESAMPLE_FUNC (type, inter, channels, arch)                \
   gint blocks = resampler->blocks;                              \
   gint ostride = resampler->ostride;                            \
   gint taps_stride = resampler->taps_stride;                    \
-  gint samp_index = 0;                                          \
-  gint samp_phase = 0;                                          \
+  gint samp_index = resampler->samp_index;                      \
+  gint samp_phase = resampler->samp_phase;                      \
+  gsize d0, d1, chunk = MAX (16, RESAMPLE_CHUNK_BYTES /        \
+      (blocks * channels * sizeof (type)));                     \
                                                                 \
-  for (c = 0; c < blocks; c++) {                                \
-    type *ip = in[c];                                           \
-    type *op = ostride == 1 ? out[c] : (type *)out[0] + c;      \
+  for (d0 = 0; d0 < out_len; d0 = d1) {                         \
+    gint chunk_index = samp_index;                              \
+    gint chunk_phase = samp_phase;                              \
                                                                 \
-    samp_index = resampler->samp_index;                         \
-    samp_phase = resampler->samp_phase;                         \
+    d1 = MIN (d0 + chunk, out_len);                             \
                                                                 \
-    for (di = 0; di < out_len; di++) {                          \
-      type *ipp, icoeff[4], *taps;                              \
+    for (c = 0; c < blocks; c++) {                              \
+      type *ip = in[c];                                         \
+      type *op = ostride == 1 ? (type *)out[c] + d0 :           \
+          (type *)out[0] + d0 * ostride + c;                    \
                                                                 \
-      ipp = &ip[samp_index * channels];                         \
+      samp_index = chunk_index;                                 \
+      samp_phase = chunk_phase;                                 \
                                                                 \
-      taps = get_taps_ ##type##_##inter                         \
-              (resampler, &samp_index, &samp_phase, icoeff);    \
-      inner_product_ ##type##_##inter##_##channels##_##arch     \
-              (op, ipp, taps, n_taps, icoeff, taps_stride);     \
-      op += ostride;                                            \
+      for (di = d0; di < d1; di++) {                            \
+        type *ipp, icoeff[4], *taps;                            \
+                                                                \
+        ipp = &ip[samp_index * channels];                       \
+                                                                \
+        taps = get_taps_ ##type##_##inter                       \
+                (resampler, &samp_index, &samp_phase, icoeff);  \
+        inner_product_ ##type##_##inter##_##channels##_##arch   \
+                (op, ipp, taps, n_taps, icoeff, taps_stride);   \
+        op += ostride;                                          \
+      }                                                         \
     }                                                           \
-    if (in_len > samp_index)                                    \
+  }                                                             \
+  if (in_len > samp_index) {                                    \
+    for (c = 0; c < blocks; c++) {                              \
+      type *ip = in[c];                                         \
       memmove (ip, &ip[samp_index * channels],                  \
           (in_len - samp_index) * sizeof(type) * channels);     \
+    }                                                           \
   }                                                             \
   *consumed = samp_index - resampler->samp_index;               \
                                                                 \
@@ -0,0 +1,609 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "audio-resampler-x86-avx2.h"
+
+#if defined (__x86_64__) && defined (HAVE_IMMINTRIN_H) && \
+    defined (__AVX2__) && defined (__FMA__)
+
+#include <immintrin.h>
+
+/* The kernels handle 16 samples of 16 bits, 8 samples of 32 bits or 4
+ * doubles per vector and read up to 15 samples past @len, which is covered
+ * by the TAPS_OVERREAD zero taps that follow the filters. */
+
+static inline gint32
+hsum_epi32 (__m256i s)
+{
+  __m128i t = _mm_add_epi32 (_mm256_castsi256_si128 (s),
+      _mm256_extracti128_si256 (s, 1));
+
+  t = _mm_add_epi32 (t, _mm_shuffle_epi32 (t, _MM_SHUFFLE (1, 0, 3, 2)));
+  t = _mm_add_epi32 (t, _mm_shuffle_epi32 (t, _MM_SHUFFLE (2, 3, 0, 1)));
+  return _mm_cvtsi128_si32 (t);
+}
+
+static inline gint64
+hsum_epi64 (__m256i s)
+{
+  __m128i t = _mm_add_epi64 (_mm256_castsi256_si128 (s),
+      _mm256_extracti128_si256 (s, 1));
+
+  t = _mm_add_epi64 (t, _mm_unpackhi_epi64 (t, t));
+  return _mm_cvtsi128_si64 (t);
+}
+
+static inline gfloat
+hsum_ps (__m256 s)
+{
+  __m128 t = _mm_add_ps (_mm256_castps256_ps128 (s),
+      _mm256_extractf128_ps (s, 1));
+
+  t = _mm_add_ps (t, _mm_movehl_ps (t, t));
+  t = _mm_add_ss (t, _mm_shuffle_ps (t, t, 0x55));
+  return _mm_cvtss_f32 (t);
+}
+
+static inline gdouble
+hsum_pd (__m256d s)
+{
+  __m128d t = _mm_add_pd (_mm256_castpd256_pd128 (s),
+      _mm256_extractf128_pd (s, 1));
+
+  t = _mm_add_sd (t, _mm_unpackhi_pd (t, t));
+  return _mm_cvtsd_f64 (t);
+}
+
+/* the 64 bits products of the even and the odd 32 bits samples, added */
+static inline __m256i
+madd_epi32 (__m256i a, __m256i b)
+{
+  return _mm256_add_epi64 (_mm256_mul_epi32 (a, b),
+      _mm256_mul_epi32 (_mm256_srli_epi64 (a, 32), _mm256_srli_epi64 (b,
+              32)));
+}
+
+#define LOAD_SI256(p) _mm256_loadu_si256 ((const __m256i *) (p))
+
+static inline void
+inner_product_gint16_full_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  __m256i sum = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 16)
+    sum = _mm256_add_epi32 (sum, _mm256_madd_epi16 (LOAD_SI256 (a + i),
+            LOAD_SI256 (b + i)));
+
+  *o = inner_product_gint16_result (hsum_epi32 (sum));
+}
+
+static inline void
+inner_product_gint16_linear_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  __m256i sum[2], t;
+  const gint16 *c[2] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 16) {
+    t = LOAD_SI256 (a + i);
+    sum[0] = _mm256_add_epi32 (sum[0], _mm256_madd_epi16 (t,
+            LOAD_SI256 (c[0] + i)));
+    sum[1] = _mm256_add_epi32 (sum[1], _mm256_madd_epi16 (t,
+            LOAD_SI256 (c[1] + i)));
+  }
+  *o = inner_product_gint16_linear_result (hsum_epi32 (sum[0]),
+      hsum_epi32 (sum[1]), icoeff);
+}
+
+static inline void
+inner_product_gint16_cubic_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i, j;
+  __m256i sum[4], t;
+  gint32 res[4];
+  const gint16 *c[4] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride),
+    (gint16 *) ((gint8 *) b + 2 * bstride),
+    (gint16 *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 16) {
+    t = LOAD_SI256 (a + i);
+    for (j = 0; j < 4; j++)
+      sum[j] = _mm256_add_epi32 (sum[j], _mm256_madd_epi16 (t,
+              LOAD_SI256 (c[j] + i)));
+  }
+  for (j = 0; j < 4; j++)
+    res[j] = hsum_epi32 (sum[j]);
+
+  *o = inner_product_gint16_cubic_result (res, icoeff);
+}
+
+static inline void
+inner_product_gint32_full_1_avx2 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  __m256i sum = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 8)
+    sum = _mm256_add_epi64 (sum, madd_epi32 (LOAD_SI256 (a + i),
+            LOAD_SI256 (b + i)));
+
+  *o = inner_product_gint32_result (hsum_epi64 (sum));
+}
+
+static inline void
+inner_product_gint32_linear_1_avx2 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  __m256i sum[2], t;
+  const gint32 *c[2] = { (gint32 *) ((gint8 *) b + 0 * bstride),
+    (gint32 *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 8) {
+    t = LOAD_SI256 (a + i);
+    sum[0] = _mm256_add_epi64 (sum[0], madd_epi32 (t, LOAD_SI256 (c[0] + i)));
+    sum[1] = _mm256_add_epi64 (sum[1], madd_epi32 (t, LOAD_SI256 (c[1] + i)));
+  }
+  *o = inner_product_gint32_linear_result (hsum_epi64 (sum[0]),
+      hsum_epi64 (sum[1]), icoeff);
+}
+
+static inline void
+inner_product_gint32_cubic_1_avx2 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i, j;
+  __m256i sum[4], t;
+  gint64 res[4];
+  const gint32 *c[4] = { (gint32 *) ((gint8 *) b + 0 * bstride),
+    (gint32 *) ((gint8 *) b + 1 * bstride),
+    (gint32 *) ((gint8 *) b + 2 * bstride),
+    (gint32 *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 8) {
+    t = LOAD_SI256 (a + i);
+    for (j = 0; j < 4; j++)
+      sum[j] = _mm256_add_epi64 (sum[j], madd_epi32 (t,
+              LOAD_SI256 (c[j] + i)));
+  }
+  for (j = 0; j < 4; j++)
+    res[j] = hsum_epi64 (sum[j]);
+
+  *o = inner_product_gint32_cubic_result (res, icoeff);
+}
+
+static inline void
+inner_product_gfloat_full_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m256 sum[2];
+
+  sum[0] = sum[1] = _mm256_setzero_ps ();
+
+  for (i = 0; i < len; i += 16) {
+    sum[0] = _mm256_fmadd_ps (_mm256_loadu_ps (a + i + 0),
+        _mm256_loadu_ps (b + i + 0), sum[0]);
+    sum[1] = _mm256_fmadd_ps (_mm256_loadu_ps (a + i + 8),
+        _mm256_loadu_ps (b + i + 8), sum[1]);
+  }
+  *o = hsum_ps (_mm256_add_ps (sum[0], sum[1]));
+}
+
+static inline void
+inner_product_gfloat_linear_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m256 sum[2], t;
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_ps ();
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    sum[0] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[1] + i), sum[1]);
+  }
+  sum[0] = _mm256_fmadd_ps (_mm256_sub_ps (sum[0], sum[1]),
+      _mm256_set1_ps (icoeff[0]), sum[1]);
+  *o = hsum_ps (sum[0]);
+}
+
+static inline void
+inner_product_gfloat_cubic_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i, j;
+  __m256 sum[4], t;
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride),
+    (gfloat *) ((gint8 *) b + 2 * bstride),
+    (gfloat *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_ps ();
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    for (j = 0; j < 4; j++)
+      sum[j] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[j] + i), sum[j]);
+  }
+  t = _mm256_mul_ps (sum[0], _mm256_set1_ps (icoeff[0]));
+  for (j = 1; j < 4; j++)
+    t = _mm256_fmadd_ps (sum[j], _mm256_set1_ps (icoeff[j]), t);
+
+  *o = hsum_ps (t);
+}
+
+static inline void
+inner_product_gdouble_full_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m256d sum[2];
+
+  sum[0] = sum[1] = _mm256_setzero_pd ();
+
+  for (i = 0; i < len; i += 8) {
+    sum[0] = _mm256_fmadd_pd (_mm256_loadu_pd (a + i + 0),
+        _mm256_loadu_pd (b + i + 0), sum[0]);
+    sum[1] = _mm256_fmadd_pd (_mm256_loadu_pd (a + i + 4),
+        _mm256_loadu_pd (b + i + 4), sum[1]);
+  }
+  *o = hsum_pd (_mm256_add_pd (sum[0], sum[1]));
+}
+
+static inline void
+inner_product_gdouble_linear_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m256d sum[2], t;
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_pd ();
+
+  for (i = 0; i < len; i += 4) {
+    t = _mm256_loadu_pd (a + i);
+    sum[0] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[1] + i), sum[1]);
+  }
+  sum[0] = _mm256_fmadd_pd (_mm256_sub_pd (sum[0], sum[1]),
+      _mm256_set1_pd (icoeff[0]), sum[1]);
+  *o = hsum_pd (sum[0]);
+}
+
+static inline void
+inner_product_gdouble_cubic_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i, j;
+  __m256d sum[4], t;
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride),
+    (gdouble *) ((gint8 *) b + 2 * bstride),
+    (gdouble *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_pd ();
+
+  for (i = 0; i < len; i += 4) {
+    t = _mm256_loadu_pd (a + i);
+    for (j = 0; j < 4; j++)
+      sum[j] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[j] + i), sum[j]);
+  }
+  t = _mm256_mul_pd (sum[0], _mm256_set1_pd (icoeff[0]));
+  for (j = 1; j < 4; j++)
+    t = _mm256_fmadd_pd (sum[j], _mm256_set1_pd (icoeff[j]), t);
+
+  *o = hsum_pd (t);
+}
+
+MAKE_RESAMPLE_FUNC (gint16, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint16, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint16, cubic, 1, avx2);
+
+MAKE_RESAMPLE_FUNC (gint32, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint32, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint32, cubic, 1, avx2);
+
+MAKE_RESAMPLE_FUNC (gfloat, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gfloat, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gfloat, cubic, 1, avx2);
+
+MAKE_RESAMPLE_FUNC (gdouble, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gdouble, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gdouble, cubic, 1, avx2);
+
+void
+interpolate_gint16_linear_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gint16 *o = op, *a = ap, *ic = icp;
+  __m256i ta, tb, t1, t2;
+  const __m256i zero = _mm256_setzero_si256 ();
+  const __m256i round = _mm256_set1_epi32 (1 << (PRECISION_S16 - 1));
+  const __m256i f = _mm256_set1_epi32 ((guint16) ic[0] |
+      ((guint32) (guint16) ic[1] << 16));
+  const gint16 *c[2] = { (gint16 *) ((gint8 *) a + 0 * astride),
+    (gint16 *) ((gint8 *) a + 1 * astride)
+  };
+
+  for (i = 0; i < len; i += 16) {
+    ta = LOAD_SI256 (c[0] + i);
+    tb = LOAD_SI256 (c[1] + i);
+
+    /* c[1] is weighted by (1 << PRECISION_S16) - ic[0], which is ic[1] + 1 */
+    t1 = _mm256_madd_epi16 (_mm256_unpacklo_epi16 (ta, tb), f);
+    t2 = _mm256_madd_epi16 (_mm256_unpackhi_epi16 (ta, tb), f);
+    t1 = _mm256_add_epi32 (t1,
+        _mm256_srai_epi32 (_mm256_unpacklo_epi16 (zero, tb), 16));
+    t2 = _mm256_add_epi32 (t2,
+        _mm256_srai_epi32 (_mm256_unpackhi_epi16 (zero, tb), 16));
+
+    t1 = _mm256_srai_epi32 (_mm256_add_epi32 (t1, round), PRECISION_S16);
+    t2 = _mm256_srai_epi32 (_mm256_add_epi32 (t2, round), PRECISION_S16);
+
+    _mm256_storeu_si256 ((__m256i *) (o + i), _mm256_packs_epi32 (t1, t2));
+  }
+}
+
+void
+interpolate_gint16_cubic_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gint16 *o = op, *a = ap, *ic = icp;
+  __m256i ta, tb, tl, th;
+  const __m256i round = _mm256_set1_epi32 (1 << (PRECISION_S16 - 1));
+  const __m256i f0 = _mm256_set1_epi32 ((guint16) ic[0] |
+      ((guint32) (guint16) ic[1] << 16));
+  const __m256i f1 = _mm256_set1_epi32 ((guint16) ic[2] |
+      ((guint32) (guint16) ic[3] << 16));
+  const gint16 *c[4] = { (gint16 *) ((gint8 *) a + 0 * astride),
+    (gint16 *) ((gint8 *) a + 1 * astride),
+    (gint16 *) ((gint8 *) a + 2 * astride),
+    (gint16 *) ((gint8 *) a + 3 * astride)
+  };
+
+  for (i = 0; i < len; i += 16) {
+    ta = LOAD_SI256 (c[0] + i);
+    tb = LOAD_SI256 (c[1] + i);
+    tl = _mm256_madd_epi16 (_mm256_unpacklo_epi16 (ta, tb), f0);
+    th = _mm256_madd_epi16 (_mm256_unpackhi_epi16 (ta, tb), f0);
+
+    ta = LOAD_SI256 (c[2] + i);
+    tb = LOAD_SI256 (c[3] + i);
+    tl = _mm256_add_epi32 (tl,
+        _mm256_madd_epi16 (_mm256_unpacklo_epi16 (ta, tb), f1));
+    th = _mm256_add_epi32 (th,
+        _mm256_madd_epi16 (_mm256_unpackhi_epi16 (ta, tb), f1));
+
+    tl = _mm256_srai_epi32 (_mm256_add_epi32 (tl, round), PRECISION_S16);
+    th = _mm256_srai_epi32 (_mm256_add_epi32 (th, round), PRECISION_S16);
+
+    _mm256_storeu_si256 ((__m256i *) (o + i), _mm256_packs_epi32 (tl, th));
+  }
+}
+
+/* the low 32 bits of the even and odd 64 bits results */
+static inline __m256i
+combine_epi64 (__m256i even, __m256i odd)
+{
+  return _mm256_blend_epi32 (even, _mm256_slli_epi64 (odd, 32), 0xaa);
+}
+
+void
+interpolate_gint32_linear_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gint32 *o = op, *a = ap, *ic = icp;
+  __m256i ta, tb, te, to;
+  const __m256i one = _mm256_set1_epi32 (1);
+  const __m256i round = _mm256_set1_epi64x ((gint64) 1 << (PRECISION_S32 - 1));
+  const __m256i f0 = _mm256_set1_epi32 (ic[0]);
+  const __m256i f1 = _mm256_set1_epi32 (ic[1]);
+  const gint32 *c[2] = { (gint32 *) ((gint8 *) a + 0 * astride),
+    (gint32 *) ((gint8 *) a + 1 * astride)
+  };
+
+  for (i = 0; i < len; i += 8) {
+    ta = LOAD_SI256 (c[0] + i);
+    tb = LOAD_SI256 (c[1] + i);
+
+    /* c[1] is weighted by (1 << PRECISION_S32) - ic[0], which is ic[1] + 1,
+     * the result fits in 32 bits so a logical shift is enough */
+    te = _mm256_add_epi64 (_mm256_mul_epi32 (ta, f0),
+        _mm256_mul_epi32 (tb, f1));
+    te = _mm256_add_epi64 (te, _mm256_mul_epi32 (tb, one));
+    te = _mm256_srli_epi64 (_mm256_add_epi64 (te, round), PRECISION_S32);
+
+    ta = _mm256_srli_epi64 (ta, 32);
+    tb = _mm256_srli_epi64 (tb, 32);
+    to = _mm256_add_epi64 (_mm256_mul_epi32 (ta, f0),
+        _mm256_mul_epi32 (tb, f1));
+    to = _mm256_add_epi64 (to, _mm256_mul_epi32 (tb, one));
+    to = _mm256_srli_epi64 (_mm256_add_epi64 (to, round), PRECISION_S32);
+
+    _mm256_storeu_si256 ((__m256i *) (o + i), combine_epi64 (te, to));
+  }
+}
+
+/* clamps to the range that gives a 32 bits result after the shift, which
+ * can then be done with a logical shift */
+static inline __m256i
+clamp_epi64 (__m256i x)
+{
+  const __m256i min = _mm256_set1_epi64x (-((gint64) 1 << 62));
+  const __m256i max = _mm256_set1_epi64x (((gint64) 1 << 62) - 1);
+
+  x = _mm256_blendv_epi8 (x, max, _mm256_cmpgt_epi64 (x, max));
+  x = _mm256_blendv_epi8 (x, min, _mm256_cmpgt_epi64 (min, x));
+  return x;
+}
+
+void
+interpolate_gint32_cubic_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i, j;
+  gint32 *o = op, *a = ap, *ic = icp;
+  __m256i t, te, to, f[4];
+  const __m256i round = _mm256_set1_epi64x ((gint64) 1 << (PRECISION_S32 - 1));
+  const gint32 *c[4] = { (gint32 *) ((gint8 *) a + 0 * astride),
+    (gint32 *) ((gint8 *) a + 1 * astride),
+    (gint32 *) ((gint8 *) a + 2 * astride),
+    (gint32 *) ((gint8 *) a + 3 * astride)
+  };
+
+  for (j = 0; j < 4; j++)
+    f[j] = _mm256_set1_epi32 (ic[j]);
+
+  for (i = 0; i < len; i += 8) {
+    te = to = round;
+    for (j = 0; j < 4; j++) {
+      t = LOAD_SI256 (c[j] + i);
+      te = _mm256_add_epi64 (te, _mm256_mul_epi32 (t, f[j]));
+      to = _mm256_add_epi64 (to,
+          _mm256_mul_epi32 (_mm256_srli_epi64 (t, 32), f[j]));
+    }
+    te = _mm256_srli_epi64 (clamp_epi64 (te), PRECISION_S32);
+    to = _mm256_srli_epi64 (clamp_epi64 (to), PRECISION_S32);
+
+    _mm256_storeu_si256 ((__m256i *) (o + i), combine_epi64 (te, to));
+  }
+}
+
+void
+interpolate_gfloat_linear_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m256 t0, t1;
+  const __m256 f = _mm256_set1_ps (ic[0]);
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) a + 0 * astride),
+    (gfloat *) ((gint8 *) a + 1 * astride)
+  };
+
+  for (i = 0; i < len; i += 8) {
+    t0 = _mm256_loadu_ps (c[0] + i);
+    t1 = _mm256_loadu_ps (c[1] + i);
+    _mm256_storeu_ps (o + i, _mm256_fmadd_ps (_mm256_sub_ps (t0, t1), f, t1));
+  }
+}
+
+void
+interpolate_gfloat_cubic_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i, j;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m256 t, f[4];
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) a + 0 * astride),
+    (gfloat *) ((gint8 *) a + 1 * astride),
+    (gfloat *) ((gint8 *) a + 2 * astride),
+    (gfloat *) ((gint8 *) a + 3 * astride)
+  };
+
+  for (j = 0; j < 4; j++)
+    f[j] = _mm256_set1_ps (ic[j]);
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm256_mul_ps (_mm256_loadu_ps (c[0] + i), f[0]);
+    for (j = 1; j < 4; j++)
+      t = _mm256_fmadd_ps (_mm256_loadu_ps (c[j] + i), f[j], t);
+    _mm256_storeu_ps (o + i, t);
+  }
+}
+
+void
+interpolate_gdouble_linear_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gdouble *o = op, *a = ap, *ic = icp;
+  __m256d t0, t1;
+  const __m256d f = _mm256_set1_pd (ic[0]);
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) a + 0 * astride),
+    (gdouble *) ((gint8 *) a + 1 * astride)
+  };
+
+  for (i = 0; i < len; i += 4) {
+    t0 = _mm256_loadu_pd (c[0] + i);
+    t1 = _mm256_loadu_pd (c[1] + i);
+    _mm256_storeu_pd (o + i, _mm256_fmadd_pd (_mm256_sub_pd (t0, t1), f, t1));
+  }
+}
+
+void
+interpolate_gdouble_cubic_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i, j;
+  gdouble *o = op, *a = ap, *ic = icp;
+  __m256d t, f[4];
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) a + 0 * astride),
+    (gdouble *) ((gint8 *) a + 1 * astride),
+    (gdouble *) ((gint8 *) a + 2 * astride),
+    (gdouble *) ((gint8 *) a + 3 * astride)
+  };
+
+  for (j = 0; j < 4; j++)
+    f[j] = _mm256_set1_pd (ic[j]);
+
+  for (i = 0; i < len; i += 4) {
+    t = _mm256_mul_pd (_mm256_loadu_pd (c[0] + i), f[0]);
+    for (j = 1; j < 4; j++)
+      t = _mm256_fmadd_pd (_mm256_loadu_pd (c[j] + i), f[j], t);
+    _mm256_storeu_pd (o + i, t);
+  }
+}
+
+#endif
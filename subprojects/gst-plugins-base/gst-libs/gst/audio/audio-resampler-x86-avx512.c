@@ -0,0 +1,456 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "audio-resampler-x86-avx512.h"
+
+#if defined (__x86_64__) && defined (HAVE_IMMINTRIN_H) && \
+    defined (__AVX512F__) && defined (__AVX512BW__)
+
+#include <immintrin.h>
+
+/* The kernels handle 16 floats or 32 bits samples or 8 doubles per vector.
+ * The 16 bits samples are handled 32 at a time and the remaining ones 16
+ * at a time so that, like for the other types, no more than 15 samples are
+ * read past @len, which are the TAPS_OVERREAD zero taps. */
+
+#define LOAD_SI512(p) _mm512_loadu_si512 ((const void *) (p))
+#define LOAD_SI256(p) _mm256_loadu_si256 ((const __m256i *) (p))
+
+static inline gint32
+hsum_epi32_256 (__m256i s)
+{
+  __m128i t = _mm_add_epi32 (_mm256_castsi256_si128 (s),
+      _mm256_extracti128_si256 (s, 1));
+
+  t = _mm_add_epi32 (t, _mm_shuffle_epi32 (t, _MM_SHUFFLE (1, 0, 3, 2)));
+  t = _mm_add_epi32 (t, _mm_shuffle_epi32 (t, _MM_SHUFFLE (2, 3, 0, 1)));
+  return _mm_cvtsi128_si32 (t);
+}
+
+/* the 64 bits products of the even and the odd 32 bits samples, added */
+static inline __m512i
+madd_epi32 (__m512i a, __m512i b)
+{
+  return _mm512_add_epi64 (_mm512_mul_epi32 (a, b),
+      _mm512_mul_epi32 (_mm512_srli_epi64 (a, 32), _mm512_srli_epi64 (b,
+              32)));
+}
+
+/* the 8 sums of the 2 halves */
+static inline __m256i
+fold_epi32 (__m512i s)
+{
+  return _mm256_add_epi32 (_mm512_castsi512_si256 (s),
+      _mm512_extracti64x4_epi64 (s, 1));
+}
+
+static inline void
+inner_product_gint16_full_1_avx512 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m512i sum = _mm512_setzero_si512 ();
+  __m256i sum2;
+
+  for (; i + 32 <= len; i += 32)
+    sum = _mm512_add_epi32 (sum, _mm512_madd_epi16 (LOAD_SI512 (a + i),
+            LOAD_SI512 (b + i)));
+
+  sum2 = fold_epi32 (sum);
+  for (; i < len; i += 16)
+    sum2 = _mm256_add_epi32 (sum2, _mm256_madd_epi16 (LOAD_SI256 (a + i),
+            LOAD_SI256 (b + i)));
+
+  *o = inner_product_gint16_result (hsum_epi32_256 (sum2));
+}
+
+static inline void
+inner_product_gint16_linear_1_avx512 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m512i sum[2], t;
+  __m256i sum2[2], t2;
+  const gint16 *c[2] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm512_setzero_si512 ();
+
+  for (; i + 32 <= len; i += 32) {
+    t = LOAD_SI512 (a + i);
+    sum[0] = _mm512_add_epi32 (sum[0], _mm512_madd_epi16 (t,
+            LOAD_SI512 (c[0] + i)));
+    sum[1] = _mm512_add_epi32 (sum[1], _mm512_madd_epi16 (t,
+            LOAD_SI512 (c[1] + i)));
+  }
+  sum2[0] = fold_epi32 (sum[0]);
+  sum2[1] = fold_epi32 (sum[1]);
+  for (; i < len; i += 16) {
+    t2 = LOAD_SI256 (a + i);
+    sum2[0] = _mm256_add_epi32 (sum2[0], _mm256_madd_epi16 (t2,
+            LOAD_SI256 (c[0] + i)));
+    sum2[1] = _mm256_add_epi32 (sum2[1], _mm256_madd_epi16 (t2,
+            LOAD_SI256 (c[1] + i)));
+  }
+  *o = inner_product_gint16_linear_result (hsum_epi32_256 (sum2[0]),
+      hsum_epi32_256 (sum2[1]), icoeff);
+}
+
+static inline void
+inner_product_gint16_cubic_1_avx512 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i = 0, j;
+  __m512i sum[4], t;
+  __m256i sum2[4], t2;
+  gint32 res[4];
+  const gint16 *c[4] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride),
+    (gint16 *) ((gint8 *) b + 2 * bstride),
+    (gint16 *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm512_setzero_si512 ();
+
+  for (; i + 32 <= len; i += 32) {
+    t = LOAD_SI512 (a + i);
+    for (j = 0; j < 4; j++)
+      sum[j] = _mm512_add_epi32 (sum[j], _mm512_madd_epi16 (t,
+              LOAD_SI512 (c[j] + i)));
+  }
+  for (j = 0; j < 4; j++)
+    sum2[j] = fold_epi32 (sum[j]);
+  for (; i < len; i += 16) {
+    t2 = LOAD_SI256 (a + i);
+    for (j = 0; j < 4; j++)
+      sum2[j] = _mm256_add_epi32 (sum2[j], _mm256_madd_epi16 (t2,
+              LOAD_SI256 (c[j] + i)));
+  }
+  for (j = 0; j < 4; j++)
+    res[j] = hsum_epi32_256 (sum2[j]);
+
+  *o = inner_product_gint16_cubic_result (res, icoeff);
+}
+
+static inline void
+inner_product_gint32_full_1_avx512 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  __m512i sum = _mm512_setzero_si512 ();
+
+  for (i = 0; i < len; i += 16)
+    sum = _mm512_add_epi64 (sum, madd_epi32 (LOAD_SI512 (a + i),
+            LOAD_SI512 (b + i)));
+
+  *o = inner_product_gint32_result (_mm512_reduce_add_epi64 (sum));
+}
+
+static inline void
+inner_product_gint32_linear_1_avx512 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  __m512i sum[2], t;
+  const gint32 *c[2] = { (gint32 *) ((gint8 *) b + 0 * bstride),
+    (gint32 *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm512_setzero_si512 ();
+
+  for (i = 0; i < len; i += 16) {
+    t = LOAD_SI512 (a + i);
+    sum[0] = _mm512_add_epi64 (sum[0], madd_epi32 (t, LOAD_SI512 (c[0] + i)));
+    sum[1] = _mm512_add_epi64 (sum[1], madd_epi32 (t, LOAD_SI512 (c[1] + i)));
+  }
+  *o = inner_product_gint32_linear_result (_mm512_reduce_add_epi64 (sum[0]),
+      _mm512_reduce_add_epi64 (sum[1]), icoeff);
+}
+
+static inline void
+inner_product_gint32_cubic_1_avx512 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i, j;
+  __m512i sum[4], t;
+  gint64 res[4];
+  const gint32 *c[4] = { (gint32 *) ((gint8 *) b + 0 * bstride),
+    (gint32 *) ((gint8 *) b + 1 * bstride),
+    (gint32 *) ((gint8 *) b + 2 * bstride),
+    (gint32 *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm512_setzero_si512 ();
+
+  for (i = 0; i < len; i += 16) {
+    t = LOAD_SI512 (a + i);
+    for (j = 0; j < 4; j++)
+      sum[j] = _mm512_add_epi64 (sum[j], madd_epi32 (t,
+              LOAD_SI512 (c[j] + i)));
+  }
+  for (j = 0; j < 4; j++)
+    res[j] = _mm512_reduce_add_epi64 (sum[j]);
+
+  *o = inner_product_gint32_cubic_result (res, icoeff);
+}
+
+static inline void
+inner_product_gfloat_full_1_avx512 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m512 sum[2];
+
+  sum[0] = sum[1] = _mm512_setzero_ps ();
+
+  for (; i + 32 <= len; i += 32) {
+    sum[0] = _mm512_fmadd_ps (_mm512_loadu_ps (a + i + 0),
+        _mm512_loadu_ps (b + i + 0), sum[0]);
+    sum[1] = _mm512_fmadd_ps (_mm512_loadu_ps (a + i + 16),
+        _mm512_loadu_ps (b + i + 16), sum[1]);
+  }
+  for (; i < len; i += 16)
+    sum[0] = _mm512_fmadd_ps (_mm512_loadu_ps (a + i), _mm512_loadu_ps (b + i),
+        sum[0]);
+
+  *o = _mm512_reduce_add_ps (_mm512_add_ps (sum[0], sum[1]));
+}
+
+static inline void
+inner_product_gfloat_linear_1_avx512 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m512 sum[2], t;
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm512_setzero_ps ();
+
+  for (i = 0; i < len; i += 16) {
+    t = _mm512_loadu_ps (a + i);
+    sum[0] = _mm512_fmadd_ps (t, _mm512_loadu_ps (c[0] + i), sum[0]);
+    sum[1] = _mm512_fmadd_ps (t, _mm512_loadu_ps (c[1] + i), sum[1]);
+  }
+  sum[0] = _mm512_fmadd_ps (_mm512_sub_ps (sum[0], sum[1]),
+      _mm512_set1_ps (icoeff[0]), sum[1]);
+  *o = _mm512_reduce_add_ps (sum[0]);
+}
+
+static inline void
+inner_product_gfloat_cubic_1_avx512 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i, j;
+  __m512 sum[4], t;
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride),
+    (gfloat *) ((gint8 *) b + 2 * bstride),
+    (gfloat *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm512_setzero_ps ();
+
+  for (i = 0; i < len; i += 16) {
+    t = _mm512_loadu_ps (a + i);
+    for (j = 0; j < 4; j++)
+      sum[j] = _mm512_fmadd_ps (t, _mm512_loadu_ps (c[j] + i), sum[j]);
+  }
+  t = _mm512_mul_ps (sum[0], _mm512_set1_ps (icoeff[0]));
+  for (j = 1; j < 4; j++)
+    t = _mm512_fmadd_ps (sum[j], _mm512_set1_ps (icoeff[j]), t);
+
+  *o = _mm512_reduce_add_ps (t);
+}
+
+static inline void
+inner_product_gdouble_full_1_avx512 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m512d sum[2];
+
+  sum[0] = sum[1] = _mm512_setzero_pd ();
+
+  for (i = 0; i < len; i += 16) {
+    sum[0] = _mm512_fmadd_pd (_mm512_loadu_pd (a + i + 0),
+        _mm512_loadu_pd (b + i + 0), sum[0]);
+    sum[1] = _mm512_fmadd_pd (_mm512_loadu_pd (a + i + 8),
+        _mm512_loadu_pd (b + i + 8), sum[1]);
+  }
+  *o = _mm512_reduce_add_pd (_mm512_add_pd (sum[0], sum[1]));
+}
+
+static inline void
+inner_product_gdouble_linear_1_avx512 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m512d sum[2], t;
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm512_setzero_pd ();
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm512_loadu_pd (a + i);
+    sum[0] = _mm512_fmadd_pd (t, _mm512_loadu_pd (c[0] + i), sum[0]);
+    sum[1] = _mm512_fmadd_pd (t, _mm512_loadu_pd (c[1] + i), sum[1]);
+  }
+  sum[0] = _mm512_fmadd_pd (_mm512_sub_pd (sum[0], sum[1]),
+      _mm512_set1_pd (icoeff[0]), sum[1]);
+  *o = _mm512_reduce_add_pd (sum[0]);
+}
+
+static inline void
+inner_product_gdouble_cubic_1_avx512 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i, j;
+  __m512d sum[4], t;
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride),
+    (gdouble *) ((gint8 *) b + 2 * bstride),
+    (gdouble *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm512_setzero_pd ();
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm512_loadu_pd (a + i);
+    for (j = 0; j < 4; j++)
+      sum[j] = _mm512_fmadd_pd (t, _mm512_loadu_pd (c[j] + i), sum[j]);
+  }
+  t = _mm512_mul_pd (sum[0], _mm512_set1_pd (icoeff[0]));
+  for (j = 1; j < 4; j++)
+    t = _mm512_fmadd_pd (sum[j], _mm512_set1_pd (icoeff[j]), t);
+
+  *o = _mm512_reduce_add_pd (t);
+}
+
+MAKE_RESAMPLE_FUNC (gint16, full, 1, avx512);
+MAKE_RESAMPLE_FUNC (gint16, linear, 1, avx512);
+MAKE_RESAMPLE_FUNC (gint16, cubic, 1, avx512);
+
+MAKE_RESAMPLE_FUNC (gint32, full, 1, avx512);
+MAKE_RESAMPLE_FUNC (gint32, linear, 1, avx512);
+MAKE_RESAMPLE_FUNC (gint32, cubic, 1, avx512);
+
+MAKE_RESAMPLE_FUNC (gfloat, full, 1, avx512);
+MAKE_RESAMPLE_FUNC (gfloat, linear, 1, avx512);
+MAKE_RESAMPLE_FUNC (gfloat, cubic, 1, avx512);
+
+MAKE_RESAMPLE_FUNC (gdouble, full, 1, avx512);
+MAKE_RESAMPLE_FUNC (gdouble, linear, 1, avx512);
+MAKE_RESAMPLE_FUNC (gdouble, cubic, 1, avx512);
+
+void
+interpolate_gfloat_linear_avx512 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m512 t0, t1;
+  const __m512 f = _mm512_set1_ps (ic[0]);
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) a + 0 * astride),
+    (gfloat *) ((gint8 *) a + 1 * astride)
+  };
+
+  for (i = 0; i < len; i += 16) {
+    t0 = _mm512_loadu_ps (c[0] + i);
+    t1 = _mm512_loadu_ps (c[1] + i);
+    _mm512_storeu_ps (o + i, _mm512_fmadd_ps (_mm512_sub_ps (t0, t1), f, t1));
+  }
+}
+
+void
+interpolate_gfloat_cubic_avx512 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i, j;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m512 t, f[4];
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) a + 0 * astride),
+    (gfloat *) ((gint8 *) a + 1 * astride),
+    (gfloat *) ((gint8 *) a + 2 * astride),
+    (gfloat *) ((gint8 *) a + 3 * astride)
+  };
+
+  for (j = 0; j < 4; j++)
+    f[j] = _mm512_set1_ps (ic[j]);
+
+  for (i = 0; i < len; i += 16) {
+    t = _mm512_mul_ps (_mm512_loadu_ps (c[0] + i), f[0]);
+    for (j = 1; j < 4; j++)
+      t = _mm512_fmadd_ps (_mm512_loadu_ps (c[j] + i), f[j], t);
+    _mm512_storeu_ps (o + i, t);
+  }
+}
+
+void
+interpolate_gdouble_linear_avx512 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gdouble *o = op, *a = ap, *ic = icp;
+  __m512d t0, t1;
+  const __m512d f = _mm512_set1_pd (ic[0]);
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) a + 0 * astride),
+    (gdouble *) ((gint8 *) a + 1 * astride)
+  };
+
+  for (i = 0; i < len; i += 8) {
+    t0 = _mm512_loadu_pd (c[0] + i);
+    t1 = _mm512_loadu_pd (c[1] + i);
+    _mm512_storeu_pd (o + i, _mm512_fmadd_pd (_mm512_sub_pd (t0, t1), f, t1));
+  }
+}
+
+void
+interpolate_gdouble_cubic_avx512 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i, j;
+  gdouble *o = op, *a = ap, *ic = icp;
+  __m512d t, f[4];
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) a + 0 * astride),
+    (gdouble *) ((gint8 *) a + 1 * astride),
+    (gdouble *) ((gint8 *) a + 2 * astride),
+    (gdouble *) ((gint8 *) a + 3 * astride)
+  };
+
+  for (j = 0; j < 4; j++)
+    f[j] = _mm512_set1_pd (ic[j]);
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm512_mul_pd (_mm512_loadu_pd (c[0] + i), f[0]);
+    for (j = 1; j < 4; j++)
+      t = _mm512_fmadd_pd (_mm512_loadu_pd (c[j] + i), f[j], t);
+    _mm512_storeu_pd (o + i, t);
+  }
+}
+
+#endif
@@ -21,7 +21,10 @@
 #include "audio-resampler-x86-sse.h"
 #include "audio-resampler-x86-sse2.h"
 #include "audio-resampler-x86-sse41.h"
+#include "audio-resampler-x86-avx2.h"
+#include "audio-resampler-x86-avx512.h"
 
+#ifdef CHECK_X86
 static void
 audio_resampler_check_x86 (const gchar *option)
 {
@@ -69,3 +72,71 @@ audio_resampler_check_x86 (const gchar *option)
 #endif
   }
 }
+#endif
+
+/* Orc doesn't report AVX, these replace the SSE versions when the CPU
+ * supports them */
+static void
+audio_resampler_check_x86_avx (void)
+{
+#if defined (HAVE_IMMINTRIN_H) && HAVE_AVX2
+  if (__builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("fma")) {
+    GST_DEBUG ("enable AVX2 optimisations");
+    resample_gint16_full_1 = resample_gint16_full_1_avx2;
+    resample_gint16_linear_1 = resample_gint16_linear_1_avx2;
+    resample_gint16_cubic_1 = resample_gint16_cubic_1_avx2;
+
+    resample_gint32_full_1 = resample_gint32_full_1_avx2;
+    resample_gint32_linear_1 = resample_gint32_linear_1_avx2;
+    resample_gint32_cubic_1 = resample_gint32_cubic_1_avx2;
+
+    resample_gfloat_full_1 = resample_gfloat_full_1_avx2;
+    resample_gfloat_linear_1 = resample_gfloat_linear_1_avx2;
+    resample_gfloat_cubic_1 = resample_gfloat_cubic_1_avx2;
+
+    resample_gdouble_full_1 = resample_gdouble_full_1_avx2;
+    resample_gdouble_linear_1 = resample_gdouble_linear_1_avx2;
+    resample_gdouble_cubic_1 = resample_gdouble_cubic_1_avx2;
+
+    interpolate_gint16_linear = interpolate_gint16_linear_avx2;
+    interpolate_gint16_cubic = interpolate_gint16_cubic_avx2;
+    interpolate_gint32_linear = interpolate_gint32_linear_avx2;
+    interpolate_gint32_cubic = interpolate_gint32_cubic_avx2;
+    interpolate_gfloat_linear = interpolate_gfloat_linear_avx2;
+    interpolate_gfloat_cubic = interpolate_gfloat_cubic_avx2;
+    interpolate_gdouble_linear = interpolate_gdouble_linear_avx2;
+    interpolate_gdouble_cubic = interpolate_gdouble_cubic_avx2;
+  }
+#else
+  GST_DEBUG ("AVX2 optimisations not enabled");
+#endif
+
+#if defined (HAVE_IMMINTRIN_H) && HAVE_AVX512
+  if (__builtin_cpu_supports ("avx512f")
+      && __builtin_cpu_supports ("avx512bw")) {
+    GST_DEBUG ("enable AVX-512 optimisations");
+    resample_gint16_full_1 = resample_gint16_full_1_avx512;
+    resample_gint16_linear_1 = resample_gint16_linear_1_avx512;
+    resample_gint16_cubic_1 = resample_gint16_cubic_1_avx512;
+
+    resample_gint32_full_1 = resample_gint32_full_1_avx512;
+    resample_gint32_linear_1 = resample_gint32_linear_1_avx512;
+    resample_gint32_cubic_1 = resample_gint32_cubic_1_avx512;
+
+    resample_gfloat_full_1 = resample_gfloat_full_1_avx512;
+    resample_gfloat_linear_1 = resample_gfloat_linear_1_avx512;
+    resample_gfloat_cubic_1 = resample_gfloat_cubic_1_avx512;
+
+    resample_gdouble_full_1 = resample_gdouble_full_1_avx512;
+    resample_gdouble_linear_1 = resample_gdouble_linear_1_avx512;
+    resample_gdouble_cubic_1 = resample_gdouble_cubic_1_avx512;
+
+    interpolate_gfloat_linear = interpolate_gfloat_linear_avx512;
+    interpolate_gfloat_cubic = interpolate_gfloat_cubic_avx512;
+    interpolate_gdouble_linear = interpolate_gdouble_linear_avx512;
+    interpolate_gdouble_cubic = interpolate_gdouble_cubic_avx512;
+  }
+#else
+  GST_DEBUG ("AVX-512 optimisations not enabled");
+#endif
+}
@@ -34,7 +34,7 @@
 #include "audio-resampler-macros.h"
 
 #define MEM_ALIGN(m,a) ((gint8 *)((guintptr)((gint8 *)(m) + ((a)-1)) & ~((a)-1)))
-#define ALIGN 16
+#define ALIGN 32
 #define TAPS_OVERREAD 16
 
 GST_DEBUG_CATEGORY_STATIC (audio_resampler_debug);
@@ -829,10 +829,15 @@ static ResampleFunc resample_funcs[] = {
 # endif
 # if defined (__i386__) || defined (__x86_64__)
 #  define CHECK_X86
-#  include "audio-resampler-x86.h"
 # endif
 #endif
 
+/* AVX is detected with the compiler builtins, it doesn't need orc */
+#if defined (__i386__) || defined (__x86_64__)
+# define CHECK_X86_AVX
+# include "audio-resampler-x86.h"
+#endif
+
 static void
 audio_resampler_init (void)
 {
@@ -874,11 +879,18 @@ audio_resampler_init (void)
         }
       }
     }
+#endif
+#ifdef CHECK_X86_AVX
+    audio_resampler_check_x86_avx ();
 #endif
     g_once_init_leave (&init_gonce, 1);
   }
 }
 
+/* the frames are deinterleaved in blocks of about DEINTERLEAVE_BLOCK_BYTES
+ * so that the input stays in the cache while all channels are copied */
+#define DEINTERLEAVE_BLOCK_BYTES (16 * 1024)
+
 #define MAKE_DEINTERLEAVE_FUNC(type)                                    \
 static void                                                             \
 deinterleave_ ##type (GstAudioResampler * resampler, gpointer sbuf[],   \
@@ -886,14 +898,23 @@ deinterleave_ ##type (GstAudioResampler * resampler, gpointer sbuf[],   \
 {                                                                       \
   gint i, c, channels = resampler->channels;                            \
   gsize samples_avail = resampler->samples_avail;                       \
-  for (c = 0; c < channels; c++) {                                      \
-    type *s = (type *) sbuf[c] + samples_avail;                         \
-    if (G_UNLIKELY (in == NULL)) {                                      \
-      for (i = 0; i < in_frames; i++)                                   \
-        s[i] = 0;                                                       \
-    } else {                                                            \
-      type *ip = (type *) in[0] + c;                                    \
-      for (i = 0; i < in_frames; i++, ip += channels)                   \
+  gsize f, n, block;                                                    \
+                                                                        \
+  if (G_UNLIKELY (in == NULL)) {                                        \
+    for (c = 0; c < channels; c++)                                      \
+      memset ((type *) sbuf[c] + samples_avail, 0,                      \
+          in_frames * sizeof (type));                                   \
+    return;                                                             \
+  }                                                                     \
+  block = MAX (16, DEINTERLEAVE_BLOCK_BYTES /                           \
+      (channels * sizeof (type)));                                      \
+                                                                        \
+  for (f = 0; f < in_frames; f += n) {                                  \
+    n = MIN (block, in_frames - f);                                     \
+    for (c = 0; c < channels; c++) {                                    \
+      type *s = (type *) sbuf[c] + samples_avail + f;                   \
+      type *ip = (type *) in[0] + f * channels + c;                     \
+      for (i = 0; i < n; i++, ip += channels)                           \
         s[i] = *ip;                                                     \
     }                                                                   \
   }                                                                     \
@@ -1439,7 +1460,9 @@ get_sample_bufs (GstAudioResampler * resampler, gsize need)
 
     bytes = GST_ROUND_UP_N (need * resampler->bps * resampler->inc, ALIGN);
 
-    samples = g_malloc0 (blocks * bytes + ALIGN - 1);
+    /* the inner products read up to TAPS_OVERREAD samples past the end */
+    samples = g_malloc0 (blocks * bytes + ALIGN - 1 +
+        TAPS_OVERREAD * resampler->bps * resampler->inc);
     ptr = MEM_ALIGN (samples, ALIGN);
 
     /* if we had some data, move history */
@@ -103,6 +103,11 @@ struct _GstAudioAggregatorPadPrivate
                                    aggregator to see if we need to update our
                                    cached values. */
 
+  GstBuffer *prepared_buffer;   /* the converted version of prepared_input,
+                                   done before mixing by
+                                   gst_audio_aggregator_prepare_pad() */
+  GstBuffer *prepared_input;
+
   guint position, size;         /* position in the input buffer and size of the
                                    input buffer in number of samples */
 
@@ -143,6 +148,8 @@ gst_audio_aggregator_pad_finalize (GObject * object)
   GstAudioAggregatorPad *pad = (GstAudioAggregatorPad *) object;
 
   gst_buffer_replace (&pad->priv->buffer, NULL);
+  gst_buffer_replace (&pad->priv->prepared_buffer, NULL);
+  gst_buffer_replace (&pad->priv->prepared_input, NULL);
 
   G_OBJECT_CLASS (gst_audio_aggregator_pad_parent_class)->finalize (object);
 }
@@ -242,6 +249,8 @@ gst_audio_aggregator_pad_flush_pad (GstAggregatorPad * aggpad,
   pad->priv->output_offset = pad->priv->next_offset = -1;
   pad->priv->discont_time = GST_CLOCK_TIME_NONE;
   gst_buffer_replace (&pad->priv->buffer, NULL);
+  gst_buffer_replace (&pad->priv->prepared_buffer, NULL);
+  gst_buffer_replace (&pad->priv->prepared_input, NULL);
   gst_audio_aggregator_pad_reset_qos (pad);
   GST_OBJECT_UNLOCK (aggpad);
 
@@ -1095,6 +1104,8 @@ gst_audio_aggregator_sink_setcaps (GstAudioAggregatorPad * aaggpad,
         GST_AUDIO_AGGREGATOR_PAD_GET_CLASS (aaggpad);
     GST_OBJECT_LOCK (aaggpad);
     aaggpad->info = info;
+    gst_buffer_replace (&aaggpad->priv->prepared_buffer, NULL);
+    gst_buffer_replace (&aaggpad->priv->prepared_input, NULL);
     if (klass->update_conversion_info)
       klass->update_conversion_info (aaggpad);
     GST_OBJECT_UNLOCK (aaggpad);
@@ -1216,6 +1227,9 @@ gst_audio_aggregator_update_converters (GstAudioAggregator * aagg,
     if (klass->update_conversion_info)
       klass->update_conversion_info (aaggpad);
 
+    gst_buffer_replace (&aaggpad->priv->prepared_buffer, NULL);
+    gst_buffer_replace (&aaggpad->priv->prepared_input, NULL);
+
     /* If we currently were mixing a buffer, we need to convert it to the new
      * format */
     if (aaggpad->priv->buffer) {
@@ -2188,6 +2202,50 @@ sync_pad_values (GstElement * aagg, GstPad * pad, gpointer user_data)
   return TRUE;
 }
 
+/* Converts the next input buffer of @pad, unless it is already mixing one.
+ * This is called from gst_aggregator_prepare_sink_pads() with the audio
+ * aggregator lock held by the aggregating thread */
+static gboolean
+gst_audio_aggregator_prepare_pad (GstElement * element, GstPad * pad,
+    gpointer user_data)
+{
+  GstAudioAggregator *aagg = GST_AUDIO_AGGREGATOR (element);
+  GstAudioAggregatorPad *aaggpad = GST_AUDIO_AGGREGATOR_PAD (pad);
+  GstAggregatorPad *aggpad = GST_AGGREGATOR_PAD (pad);
+  GstAudioAggregatorPad *srcpad =
+      GST_AUDIO_AGGREGATOR_PAD (GST_AGGREGATOR (element)->srcpad);
+  GstBuffer *input_buffer;
+
+  if (!GST_AUDIO_AGGREGATOR_PAD_GET_CLASS (pad)->convert_buffer)
+    return TRUE;
+
+  if (gst_aggregator_pad_is_inactive (aggpad))
+    return TRUE;
+
+  input_buffer = gst_aggregator_pad_peek_buffer (aggpad);
+  if (!input_buffer)
+    return TRUE;
+
+  GST_OBJECT_LOCK (pad);
+  if (!aaggpad->priv->buffer && aaggpad->priv->prepared_input != input_buffer
+      && GST_AUDIO_INFO_IS_VALID (&aaggpad->info)
+      && GST_AUDIO_INFO_IS_VALID (&srcpad->info)) {
+    gst_buffer_replace (&aaggpad->priv->prepared_input, NULL);
+    gst_buffer_replace (&aaggpad->priv->prepared_buffer, NULL);
+
+    aaggpad->priv->prepared_buffer =
+        gst_audio_aggregator_convert_buffer (aagg, pad, &aaggpad->info,
+        &srcpad->info, input_buffer);
+    if (aaggpad->priv->prepared_buffer)
+      aaggpad->priv->prepared_input = gst_buffer_ref (input_buffer);
+  }
+  GST_OBJECT_UNLOCK (pad);
+
+  gst_buffer_unref (input_buffer);
+
+  return TRUE;
+}
+
 static GstFlowReturn
 gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
 {
@@ -2237,6 +2295,12 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
   aagg = GST_AUDIO_AGGREGATOR (agg);
 
   GST_AUDIO_AGGREGATOR_LOCK (aagg);
+
+  /* Convert the new input buffers before mixing them, on multiple threads
+   * if the aggregator is configured for that */
+  gst_aggregator_prepare_sink_pads (agg, gst_audio_aggregator_prepare_pad,
+      NULL);
+
   GST_OBJECT_LOCK (agg);
 
   if (aagg->priv->samples_per_buffer == 0) {
@@ -2381,7 +2445,11 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
 
     /* New buffer? */
     if (!pad->priv->buffer) {
-      if (GST_AUDIO_AGGREGATOR_PAD_GET_CLASS (pad)->convert_buffer) {
+      if (pad->priv->prepared_buffer
+          && pad->priv->prepared_input == input_buffer) {
+        pad->priv->buffer = g_steal_pointer (&pad->priv->prepared_buffer);
+        gst_buffer_replace (&pad->priv->prepared_input, NULL);
+      } else if (GST_AUDIO_AGGREGATOR_PAD_GET_CLASS (pad)->convert_buffer) {
         pad->priv->buffer =
             gst_audio_aggregator_convert_buffer
             (aagg, GST_PAD (pad), &pad->info, &srcpad->info, input_buffer);
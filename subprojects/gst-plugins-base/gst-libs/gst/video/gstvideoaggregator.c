@@ -2147,11 +2147,12 @@ gst_video_aggregator_do_aggregate (GstVideoAggregator * vagg,
   gst_aggregator_selected_samples (agg, GST_BUFFER_PTS (*outbuf),
       GST_BUFFER_DTS (*outbuf), GST_BUFFER_DURATION (*outbuf), NULL);
 
-  /* Convert all the frames the subclass has before aggregating */
+  /* Convert all the frames the subclass has before aggregating. Starting is
+   * cheap and may look at the other pads, finishing does the actual work of
+   * the pads that can't convert asynchronously and can run in parallel */
   gst_element_foreach_sink_pad (GST_ELEMENT_CAST (vagg), prepare_frames_start,
       NULL);
-  gst_element_foreach_sink_pad (GST_ELEMENT_CAST (vagg), prepare_frames_finish,
-      NULL);
+  gst_aggregator_prepare_sink_pads (agg, prepare_frames_finish, NULL);
 
   ret = vagg_klass->aggregate_frames (vagg, *outbuf);
 
@@ -77,7 +77,9 @@ struct _GstVideoAggregatorPad
  *                          have changed.
  * @prepare_frame: Prepare the frame from the pad buffer and sets it to prepared_frame.
  *      Implementations should always return TRUE.  Returning FALSE will cease
- *      iteration over subsequent pads.
+ *      iteration over subsequent pads, unless the pads are prepared in parallel
+ *      (see #GstAggregator:prepare-threads). In that case this is called from
+ *      other threads and concurrently for the other pads.
  * @clean_frame:   clean the frame previously prepared in prepare_frame
  *
  * Since: 1.16
@@ -101,7 +103,8 @@ struct _GstVideoAggregatorPad
  * @videoaggregator: the parent #GstVideoAggregator
  * @prepared_frame: the #GstVideoFrame to prepare into
  *
- * Finish preparing @prepared_frame.
+ * Finish preparing @prepared_frame. Like #GstVideoAggregatorPadClass.prepare_frame
+ * this is called from other threads when the pads are prepared in parallel.
  *
  * If overriden, `prepare_frame_start` must also be overriden.
  *
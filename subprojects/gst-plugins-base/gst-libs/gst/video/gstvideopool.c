@@ -115,7 +115,8 @@ static const gchar **
 video_buffer_pool_get_options (GstBufferPool * pool)
 {
   static const gchar *options[] = { GST_BUFFER_POOL_OPTION_VIDEO_META,
-    GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT, NULL
+    GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT,
+    GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES, NULL
   };
   return options;
 }
@@ -160,6 +161,18 @@ video_buffer_pool_set_config (GstBufferPool * pool, GstStructure * config)
   if ((priv->allocator = allocator))
     gst_object_ref (allocator);
 
+  if (gst_buffer_pool_config_has_option (config,
+          GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES) && (allocator == NULL
+          || g_strcmp0 (allocator->mem_type, GST_ALLOCATOR_SYSMEM) == 0)) {
+    GstAllocator *huge_pages = gst_allocator_find (GST_ALLOCATOR_HUGE_PAGES);
+
+    if (huge_pages) {
+      GST_DEBUG_OBJECT (pool, "allocating from huge pages");
+      gst_clear_object (&priv->allocator);
+      priv->allocator = huge_pages;
+    }
+  }
+
   /* enable metadata based on config of the pool */
   priv->add_videometa =
       gst_buffer_pool_config_has_option (config,
@@ -45,6 +45,18 @@ G_BEGIN_DECLS
  */
 #define GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT "GstBufferPoolOptionVideoAlignment"
 
+/**
+ * GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES:
+ *
+ * A bufferpool option to allocate the frames from huge pages. When this option
+ * is enabled and no other allocator than the system memory allocator was
+ * configured, the #GST_ALLOCATOR_HUGE_PAGES allocator is used if it is
+ * available on the platform.
+ *
+ * Since: 1.26
+ */
+#define GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES "GstBufferPoolOptionVideoHugePages"
+
 /* setting a bufferpool config */
 
 GST_VIDEO_API
@@ -0,0 +1,265 @@
+/* GStreamer
+ *
+ * video-converter-kernels.h: line kernels of the video converter fastpaths
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef VIDEO_CONVERTER_KERNELS_H
+#define VIDEO_CONVERTER_KERNELS_H
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/* The C versions here are the reference, the vectorized versions must give
+ * the same results. They handle the pixels that don't fill a whole vector.
+ *
+ * The YUV to RGB kernels do the same computation as
+ * video_orc_convert_I420_BGRA(), with the 5 coefficients of its
+ * parameters: Y, V to R, U to B, U to G and V to G. */
+
+/* @uv has @n pairs */
+typedef void (*VideoKernelDeinterleave) (guint8 * u, guint8 * v,
+    const guint8 * uv, gint n);
+typedef void (*VideoKernelInterleave) (guint8 * uv, const guint8 * u,
+    const guint8 * v, gint n);
+/* keeps the 8 most significant bits of the little endian samples */
+typedef void (*VideoKernelNarrow) (guint8 * d, const guint8 * s, gint n);
+/* 4 bytes per pixel, B G R A or, with @swap_rb, R G B A */
+typedef void (*VideoKernelI420ToRGB32) (guint8 * d, const guint8 * y,
+    const guint8 * u, const guint8 * v, const gint16 * coef, gint width,
+    gboolean swap_rb);
+typedef void (*VideoKernelNV12ToRGB32) (guint8 * d, const guint8 * y,
+    const guint8 * uv, const gint16 * coef, gint width, gboolean swap_rb);
+/* 10 bits samples in native endianness */
+typedef void (*VideoKernelUnpackV210) (guint16 * y, guint16 * u, guint16 * v,
+    const guint8 * s, gint width);
+typedef void (*VideoKernelPackV210) (guint8 * d, const guint16 * y,
+    const guint16 * u, const guint16 * v, gint width);
+
+typedef struct
+{
+  VideoKernelDeinterleave deinterleave;
+  VideoKernelInterleave interleave;
+  VideoKernelNarrow narrow;
+  VideoKernelI420ToRGB32 I420_to_RGB32;
+  VideoKernelNV12ToRGB32 NV12_to_RGB32;
+  VideoKernelUnpackV210 unpack_v210;
+  VideoKernelPackV210 pack_v210;
+} VideoConverterKernels;
+
+static inline void
+video_kernel_deinterleave_c (guint8 * u, guint8 * v, const guint8 * uv,
+    gint n)
+{
+  gint i;
+
+  for (i = 0; i < n; i++) {
+    u[i] = uv[2 * i];
+    v[i] = uv[2 * i + 1];
+  }
+}
+
+static inline void
+video_kernel_interleave_c (guint8 * uv, const guint8 * u, const guint8 * v,
+    gint n)
+{
+  gint i;
+
+  for (i = 0; i < n; i++) {
+    uv[2 * i] = u[i];
+    uv[2 * i + 1] = v[i];
+  }
+}
+
+static inline void
+video_kernel_narrow_c (guint8 * d, const guint8 * s, gint n)
+{
+  gint i;
+
+  for (i = 0; i < n; i++)
+    d[i] = s[2 * i + 1];
+}
+
+/* splatbw of the sample minus 128 */
+#define VIDEO_KERNEL_SPLAT(x) ((gint16) ((((x) ^ 0x80) << 8) | ((x) ^ 0x80)))
+#define VIDEO_KERNEL_MULHS(a,b) ((gint16) (((gint32) (a) * (b)) >> 16))
+#define VIDEO_KERNEL_CLAMP(x) ((guint8) (CLAMP ((x), -128, 127) + 128))
+
+static inline void
+video_kernel_yuv_to_rgb32_pixel (guint8 * d, guint8 y, guint8 u, guint8 v,
+    const gint16 * coef, gboolean swap_rb)
+{
+  gint16 wy, wu, wv, r, g, b;
+
+  wy = VIDEO_KERNEL_MULHS (VIDEO_KERNEL_SPLAT (y), coef[0]);
+  wu = VIDEO_KERNEL_SPLAT (u);
+  wv = VIDEO_KERNEL_SPLAT (v);
+
+  r = (gint16) (wy + VIDEO_KERNEL_MULHS (wv, coef[1]));
+  b = (gint16) (wy + VIDEO_KERNEL_MULHS (wu, coef[2]));
+  g = (gint16) (wy + VIDEO_KERNEL_MULHS (wu, coef[3]));
+  g = (gint16) (g + VIDEO_KERNEL_MULHS (wv, coef[4]));
+
+  d[swap_rb ? 2 : 0] = VIDEO_KERNEL_CLAMP (b);
+  d[1] = VIDEO_KERNEL_CLAMP (g);
+  d[swap_rb ? 0 : 2] = VIDEO_KERNEL_CLAMP (r);
+  d[3] = 0xff;
+}
+
+/* @x is the first pixel to convert, it is even */
+static inline void
+video_kernel_I420_to_RGB32_c (guint8 * d, const guint8 * y, const guint8 * u,
+    const guint8 * v, const gint16 * coef, gint x, gint width,
+    gboolean swap_rb)
+{
+  for (; x < width; x++)
+    video_kernel_yuv_to_rgb32_pixel (d + 4 * x, y[x], u[x >> 1], v[x >> 1],
+        coef, swap_rb);
+}
+
+static inline void
+video_kernel_NV12_to_RGB32_c (guint8 * d, const guint8 * y, const guint8 * uv,
+    const gint16 * coef, gint x, gint width, gboolean swap_rb)
+{
+  for (; x < width; x++)
+    video_kernel_yuv_to_rgb32_pixel (d + 4 * x, y[x], uv[2 * (x >> 1)],
+        uv[2 * (x >> 1) + 1], coef, swap_rb);
+}
+
+/* v210 packs 6 pixels in 4 little endian words of 3 samples:
+ * U0 Y0 V0, Y1 U2 Y2, V2 Y3 U4, Y4 V4 Y5 */
+
+/* @x is the first pixel to unpack, it is a multiple of 6 */
+static inline void
+video_kernel_unpack_v210_c (guint16 * y, guint16 * u, guint16 * v,
+    const guint8 * s, gint x, gint width)
+{
+  for (; x < width; x += 6) {
+    const guint8 *p = s + (x / 6) * 16;
+    guint32 a0, a1, a2, a3;
+    guint16 py[6], pu[3], pv[3];
+    gint j;
+
+    a0 = GST_READ_UINT32_LE (p);
+    a1 = GST_READ_UINT32_LE (p + 4);
+    a2 = GST_READ_UINT32_LE (p + 8);
+    a3 = GST_READ_UINT32_LE (p + 12);
+
+    pu[0] = a0 & 0x3ff;
+    py[0] = (a0 >> 10) & 0x3ff;
+    pv[0] = (a0 >> 20) & 0x3ff;
+    py[1] = a1 & 0x3ff;
+    pu[1] = (a1 >> 10) & 0x3ff;
+    py[2] = (a1 >> 20) & 0x3ff;
+    pv[1] = a2 & 0x3ff;
+    py[3] = (a2 >> 10) & 0x3ff;
+    pu[2] = (a2 >> 20) & 0x3ff;
+    py[4] = a3 & 0x3ff;
+    pv[2] = (a3 >> 10) & 0x3ff;
+    py[5] = (a3 >> 20) & 0x3ff;
+
+    for (j = 0; j < 6 && x + j < width; j++) {
+      y[x + j] = py[j];
+      if ((j & 1) == 0) {
+        u[(x + j) / 2] = pu[j / 2];
+        v[(x + j) / 2] = pv[j / 2];
+      }
+    }
+  }
+}
+
+/* @x is the first pixel to pack, it is a multiple of 6. The last group is
+ * completed by repeating the last pixels */
+static inline void
+video_kernel_pack_v210_c (guint8 * d, const guint16 * y, const guint16 * u,
+    const guint16 * v, gint x, gint width)
+{
+  for (; x < width; x += 6) {
+    guint8 *p = d + (x / 6) * 16;
+    guint32 py[6], pu[3], pv[3];
+    gint j;
+
+    for (j = 0; j < 6; j++) {
+      gint c = MIN (x + j, width - 1);
+
+      py[j] = y[c] & 0x3ff;
+      if ((j & 1) == 0) {
+        pu[j / 2] = u[c / 2] & 0x3ff;
+        pv[j / 2] = v[c / 2] & 0x3ff;
+      }
+    }
+
+    GST_WRITE_UINT32_LE (p, pu[0] | (py[0] << 10) | (pv[0] << 20));
+    GST_WRITE_UINT32_LE (p + 4, py[1] | (pu[1] << 10) | (py[2] << 20));
+    GST_WRITE_UINT32_LE (p + 8, pv[1] | (py[3] << 10) | (pu[2] << 20));
+    GST_WRITE_UINT32_LE (p + 12, py[4] | (pv[2] << 10) | (py[5] << 20));
+  }
+}
+
+/* the vectorized versions, only built when the compiler supports them */
+
+G_GNUC_INTERNAL
+void video_kernel_deinterleave_avx2 (guint8 * u, guint8 * v,
+    const guint8 * uv, gint n);
+G_GNUC_INTERNAL
+void video_kernel_interleave_avx2 (guint8 * uv, const guint8 * u,
+    const guint8 * v, gint n);
+G_GNUC_INTERNAL
+void video_kernel_narrow_avx2 (guint8 * d, const guint8 * s, gint n);
+G_GNUC_INTERNAL
+void video_kernel_I420_to_RGB32_avx2 (guint8 * d, const guint8 * y,
+    const guint8 * u, const guint8 * v, const gint16 * coef, gint width,
+    gboolean swap_rb);
+G_GNUC_INTERNAL
+void video_kernel_NV12_to_RGB32_avx2 (guint8 * d, const guint8 * y,
+    const guint8 * uv, const gint16 * coef, gint width, gboolean swap_rb);
+G_GNUC_INTERNAL
+void video_kernel_unpack_v210_avx2 (guint16 * y, guint16 * u, guint16 * v,
+    const guint8 * s, gint width);
+G_GNUC_INTERNAL
+void video_kernel_pack_v210_avx2 (guint8 * d, const guint16 * y,
+    const guint16 * u, const guint16 * v, gint width);
+
+G_GNUC_INTERNAL
+void video_kernel_deinterleave_avx512 (guint8 * u, guint8 * v,
+    const guint8 * uv, gint n);
+G_GNUC_INTERNAL
+void video_kernel_interleave_avx512 (guint8 * uv, const guint8 * u,
+    const guint8 * v, gint n);
+G_GNUC_INTERNAL
+void video_kernel_narrow_avx512 (guint8 * d, const guint8 * s, gint n);
+
+G_GNUC_INTERNAL
+void video_kernel_deinterleave_neon (guint8 * u, guint8 * v,
+    const guint8 * uv, gint n);
+G_GNUC_INTERNAL
+void video_kernel_interleave_neon (guint8 * uv, const guint8 * u,
+    const guint8 * v, gint n);
+G_GNUC_INTERNAL
+void video_kernel_narrow_neon (guint8 * d, const guint8 * s, gint n);
+G_GNUC_INTERNAL
+void video_kernel_I420_to_RGB32_neon (guint8 * d, const guint8 * y,
+    const guint8 * u, const guint8 * v, const gint16 * coef, gint width,
+    gboolean swap_rb);
+G_GNUC_INTERNAL
+void video_kernel_NV12_to_RGB32_neon (guint8 * d, const guint8 * y,
+    const guint8 * uv, const gint16 * coef, gint width, gboolean swap_rb);
+
+G_END_DECLS
+
+#endif /* VIDEO_CONVERTER_KERNELS_H */
@@ -0,0 +1,173 @@
+/* GStreamer
+ *
+ * video-converter-neon.c: NEON line kernels of the video converter
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "video-converter-kernels.h"
+
+#if defined (__aarch64__) && defined (__ARM_NEON)
+
+#include <arm_neon.h>
+
+void
+video_kernel_deinterleave_neon (guint8 * u, guint8 * v, const guint8 * uv,
+    gint n)
+{
+  gint i;
+
+  for (i = 0; i + 16 <= n; i += 16) {
+    uint8x16x2_t s = vld2q_u8 (uv + 2 * i);
+
+    vst1q_u8 (u + i, s.val[0]);
+    vst1q_u8 (v + i, s.val[1]);
+  }
+  video_kernel_deinterleave_c (u + i, v + i, uv + 2 * i, n - i);
+}
+
+void
+video_kernel_interleave_neon (guint8 * uv, const guint8 * u, const guint8 * v,
+    gint n)
+{
+  gint i;
+
+  for (i = 0; i + 16 <= n; i += 16) {
+    uint8x16x2_t s;
+
+    s.val[0] = vld1q_u8 (u + i);
+    s.val[1] = vld1q_u8 (v + i);
+    vst2q_u8 (uv + 2 * i, s);
+  }
+  video_kernel_interleave_c (uv + 2 * i, u + i, v + i, n - i);
+}
+
+void
+video_kernel_narrow_neon (guint8 * d, const guint8 * s, gint n)
+{
+  gint i;
+
+  for (i = 0; i + 16 <= n; i += 16)
+    vst1q_u8 (d + i, vld2q_u8 (s + 2 * i).val[1]);
+
+  video_kernel_narrow_c (d + i, s + 2 * i, n - i);
+}
+
+/* VIDEO_KERNEL_SPLAT() words */
+static inline int16x8_t
+splat_u8 (uint8x8_t x)
+{
+  uint16x8_t w = vmovl_u8 (veor_u8 (x, vdup_n_u8 (0x80)));
+
+  return vreinterpretq_s16_u16 (vorrq_u16 (w, vshlq_n_u16 (w, 8)));
+}
+
+/* VIDEO_KERNEL_MULHS(), the doubling vqdmulh is not the same */
+static inline int16x8_t
+mulhs_s16 (int16x8_t a, int16x8_t b)
+{
+  return vcombine_s16 (vshrn_n_s32 (vmull_s16 (vget_low_s16 (a),
+              vget_low_s16 (b)), 16), vshrn_n_s32 (vmull_high_s16 (a, b), 16));
+}
+
+static inline uint8x16_t
+clamp_s16 (int16x8_t lo, int16x8_t hi)
+{
+  int8x16_t p = vqmovn_high_s16 (vqmovn_s16 (lo), hi);
+
+  return veorq_u8 (vreinterpretq_u8_s8 (p), vdupq_n_u8 (0x80));
+}
+
+/* 16 pixels from 16 Y and 8 U and V samples */
+static inline void
+yuv_to_rgb32_neon (guint8 * d, const guint8 * y, uint8x8_t u, uint8x8_t v,
+    const int16x8_t coef[5], gboolean swap_rb)
+{
+  int16x8_t wu, wv, cr, cb, cg, wy_lo, wy_hi;
+  uint8x16_t ys, r, b;
+  uint8x16x4_t px;
+
+  /* the chroma terms are computed once for both pixels that use them */
+  wu = splat_u8 (u);
+  wv = splat_u8 (v);
+  cr = mulhs_s16 (wv, coef[1]);
+  cb = mulhs_s16 (wu, coef[2]);
+  cg = vaddq_s16 (mulhs_s16 (wu, coef[3]), mulhs_s16 (wv, coef[4]));
+
+  ys = vld1q_u8 (y);
+  wy_lo = mulhs_s16 (splat_u8 (vget_low_u8 (ys)), coef[0]);
+  wy_hi = mulhs_s16 (splat_u8 (vget_high_u8 (ys)), coef[0]);
+
+  r = clamp_s16 (vaddq_s16 (wy_lo, vzip1q_s16 (cr, cr)),
+      vaddq_s16 (wy_hi, vzip2q_s16 (cr, cr)));
+  b = clamp_s16 (vaddq_s16 (wy_lo, vzip1q_s16 (cb, cb)),
+      vaddq_s16 (wy_hi, vzip2q_s16 (cb, cb)));
+
+  px.val[0] = swap_rb ? r : b;
+  px.val[1] = clamp_s16 (vaddq_s16 (wy_lo, vzip1q_s16 (cg, cg)),
+      vaddq_s16 (wy_hi, vzip2q_s16 (cg, cg)));
+  px.val[2] = swap_rb ? b : r;
+  px.val[3] = vdupq_n_u8 (0xff);
+
+  vst4q_u8 (d, px);
+}
+
+#define LOAD_COEF(c,coef)               \
+G_STMT_START {                          \
+  gint _i;                              \
+  for (_i = 0; _i < 5; _i++)            \
+    c[_i] = vdupq_n_s16 (coef[_i]);     \
+} G_STMT_END
+
+void
+video_kernel_I420_to_RGB32_neon (guint8 * d, const guint8 * y,
+    const guint8 * u, const guint8 * v, const gint16 * coef, gint width,
+    gboolean swap_rb)
+{
+  int16x8_t c[5];
+  gint x;
+
+  LOAD_COEF (c, coef);
+
+  for (x = 0; x + 16 <= width; x += 16) {
+    yuv_to_rgb32_neon (d + 4 * x, y + x, vld1_u8 (u + x / 2),
+        vld1_u8 (v + x / 2), c, swap_rb);
+  }
+  video_kernel_I420_to_RGB32_c (d, y, u, v, coef, x, width, swap_rb);
+}
+
+void
+video_kernel_NV12_to_RGB32_neon (guint8 * d, const guint8 * y,
+    const guint8 * uv, const gint16 * coef, gint width, gboolean swap_rb)
+{
+  int16x8_t c[5];
+  gint x;
+
+  LOAD_COEF (c, coef);
+
+  for (x = 0; x + 16 <= width; x += 16) {
+    uint8x8x2_t s = vld2_u8 (uv + x);
+
+    yuv_to_rgb32_neon (d + 4 * x, y + x, s.val[0], s.val[1], c, swap_rb);
+  }
+  video_kernel_NV12_to_RGB32_c (d, y, uv, coef, x, width, swap_rb);
+}
+
+#endif
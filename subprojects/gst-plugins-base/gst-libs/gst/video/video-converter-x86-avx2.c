@@ -0,0 +1,353 @@
+/* GStreamer
+ *
+ * video-converter-x86-avx2.c: AVX2 line kernels of the video converter
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "video-converter-kernels.h"
+
+#if defined (__x86_64__) && defined (HAVE_IMMINTRIN_H) && defined (__AVX2__)
+
+#include <immintrin.h>
+
+/* u0 v0 u1 v1 ... to u0 u1 ... v0 v1 ... in each 128 bits lane */
+#define SHUFFLE_DEINTERLEAVE \
+  _mm256_setr_epi8 (0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15, \
+      0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15)
+
+void
+video_kernel_deinterleave_avx2 (guint8 * u, guint8 * v, const guint8 * uv,
+    gint n)
+{
+  const __m256i shuf = SHUFFLE_DEINTERLEAVE;
+  gint i;
+
+  for (i = 0; i + 32 <= n; i += 32) {
+    __m256i a, b;
+
+    a = _mm256_loadu_si256 ((const __m256i *) (uv + 2 * i));
+    b = _mm256_loadu_si256 ((const __m256i *) (uv + 2 * i + 32));
+    /* [u0-15 | v0-15] and [u16-31 | v16-31] */
+    a = _mm256_permute4x64_epi64 (_mm256_shuffle_epi8 (a, shuf),
+        _MM_SHUFFLE (3, 1, 2, 0));
+    b = _mm256_permute4x64_epi64 (_mm256_shuffle_epi8 (b, shuf),
+        _MM_SHUFFLE (3, 1, 2, 0));
+
+    _mm256_storeu_si256 ((__m256i *) (u + i),
+        _mm256_permute2x128_si256 (a, b, 0x20));
+    _mm256_storeu_si256 ((__m256i *) (v + i),
+        _mm256_permute2x128_si256 (a, b, 0x31));
+  }
+  video_kernel_deinterleave_c (u + i, v + i, uv + 2 * i, n - i);
+}
+
+void
+video_kernel_interleave_avx2 (guint8 * uv, const guint8 * u, const guint8 * v,
+    gint n)
+{
+  gint i;
+
+  for (i = 0; i + 32 <= n; i += 32) {
+    __m256i a, b, lo, hi;
+
+    a = _mm256_loadu_si256 ((const __m256i *) (u + i));
+    b = _mm256_loadu_si256 ((const __m256i *) (v + i));
+    /* [0-7 | 16-23] and [8-15 | 24-31] */
+    lo = _mm256_unpacklo_epi8 (a, b);
+    hi = _mm256_unpackhi_epi8 (a, b);
+
+    _mm256_storeu_si256 ((__m256i *) (uv + 2 * i),
+        _mm256_permute2x128_si256 (lo, hi, 0x20));
+    _mm256_storeu_si256 ((__m256i *) (uv + 2 * i + 32),
+        _mm256_permute2x128_si256 (lo, hi, 0x31));
+  }
+  video_kernel_interleave_c (uv + 2 * i, u + i, v + i, n - i);
+}
+
+void
+video_kernel_narrow_avx2 (guint8 * d, const guint8 * s, gint n)
+{
+  gint i;
+
+  for (i = 0; i + 32 <= n; i += 32) {
+    __m256i a, b;
+
+    a = _mm256_srli_epi16 (_mm256_loadu_si256 ((const __m256i *) (s + 2 * i)),
+        8);
+    b = _mm256_srli_epi16 (_mm256_loadu_si256 ((const __m256i *) (s + 2 * i +
+                32)), 8);
+    a = _mm256_permute4x64_epi64 (_mm256_packus_epi16 (a, b),
+        _MM_SHUFFLE (3, 1, 2, 0));
+
+    _mm256_storeu_si256 ((__m256i *) (d + i), a);
+  }
+  video_kernel_narrow_c (d + i, s + 2 * i, n - i);
+}
+
+/* 16 samples, in order, to VIDEO_KERNEL_SPLAT() words */
+static inline __m256i
+splat_epi8 (__m128i x)
+{
+  __m256i w;
+
+  w = _mm256_cvtepu8_epi16 (_mm_xor_si128 (x, _mm_set1_epi8 ((gchar) 0x80)));
+
+  return _mm256_or_si256 (w, _mm256_slli_epi16 (w, 8));
+}
+
+/* 32 words, in the lane order of packs, to the bytes in order */
+static inline __m256i
+clamp_epi16 (__m256i lo, __m256i hi)
+{
+  __m256i p;
+
+  p = _mm256_permute4x64_epi64 (_mm256_packs_epi16 (lo, hi),
+      _MM_SHUFFLE (3, 1, 2, 0));
+
+  return _mm256_xor_si256 (p, _mm256_set1_epi8 ((gchar) 0x80));
+}
+
+/* 32 pixels from 32 Y and 16 U and V samples */
+static inline void
+yuv_to_rgb32_avx2 (guint8 * d, const guint8 * y, __m128i u, __m128i v,
+    const __m256i coef[5], gboolean swap_rb)
+{
+  __m256i wu, wv, cr, cb, cg, t;
+  __m256i cr_lo, cr_hi, cb_lo, cb_hi, cg_lo, cg_hi;
+  __m256i wy_lo, wy_hi, r, g, b, a;
+  __m256i bg_lo, bg_hi, ra_lo, ra_hi, p0, p1, p2, p3;
+  __m128i ys;
+
+  /* the chroma terms are computed once for both pixels that use them */
+  wu = splat_epi8 (u);
+  wv = splat_epi8 (v);
+  cr = _mm256_mulhi_epi16 (wv, coef[1]);
+  cb = _mm256_mulhi_epi16 (wu, coef[2]);
+  cg = _mm256_add_epi16 (_mm256_mulhi_epi16 (wu, coef[3]),
+      _mm256_mulhi_epi16 (wv, coef[4]));
+
+  /* [0-3 8-11 | 4-7 12-15] so that unpacking repeats them in order */
+  cr = _mm256_permute4x64_epi64 (cr, _MM_SHUFFLE (3, 1, 2, 0));
+  cb = _mm256_permute4x64_epi64 (cb, _MM_SHUFFLE (3, 1, 2, 0));
+  cg = _mm256_permute4x64_epi64 (cg, _MM_SHUFFLE (3, 1, 2, 0));
+  cr_lo = _mm256_unpacklo_epi16 (cr, cr);
+  cr_hi = _mm256_unpackhi_epi16 (cr, cr);
+  cb_lo = _mm256_unpacklo_epi16 (cb, cb);
+  cb_hi = _mm256_unpackhi_epi16 (cb, cb);
+  cg_lo = _mm256_unpacklo_epi16 (cg, cg);
+  cg_hi = _mm256_unpackhi_epi16 (cg, cg);
+
+  ys = _mm_loadu_si128 ((const __m128i *) y);
+  wy_lo = _mm256_mulhi_epi16 (splat_epi8 (ys), coef[0]);
+  ys = _mm_loadu_si128 ((const __m128i *) (y + 16));
+  wy_hi = _mm256_mulhi_epi16 (splat_epi8 (ys), coef[0]);
+
+  r = clamp_epi16 (_mm256_add_epi16 (wy_lo, cr_lo),
+      _mm256_add_epi16 (wy_hi, cr_hi));
+  g = clamp_epi16 (_mm256_add_epi16 (wy_lo, cg_lo),
+      _mm256_add_epi16 (wy_hi, cg_hi));
+  b = clamp_epi16 (_mm256_add_epi16 (wy_lo, cb_lo),
+      _mm256_add_epi16 (wy_hi, cb_hi));
+  a = _mm256_set1_epi8 ((gchar) 0xff);
+
+  if (swap_rb) {
+    t = r;
+    r = b;
+    b = t;
+  }
+
+  bg_lo = _mm256_unpacklo_epi8 (b, g);
+  bg_hi = _mm256_unpackhi_epi8 (b, g);
+  ra_lo = _mm256_unpacklo_epi8 (r, a);
+  ra_hi = _mm256_unpackhi_epi8 (r, a);
+  /* pixels [0-3 | 16-19], [4-7 | 20-23], [8-11 | 24-27], [12-15 | 28-31] */
+  p0 = _mm256_unpacklo_epi16 (bg_lo, ra_lo);
+  p1 = _mm256_unpackhi_epi16 (bg_lo, ra_lo);
+  p2 = _mm256_unpacklo_epi16 (bg_hi, ra_hi);
+  p3 = _mm256_unpackhi_epi16 (bg_hi, ra_hi);
+
+  _mm256_storeu_si256 ((__m256i *) d, _mm256_permute2x128_si256 (p0, p1,
+          0x20));
+  _mm256_storeu_si256 ((__m256i *) (d + 32), _mm256_permute2x128_si256 (p2,
+          p3, 0x20));
+  _mm256_storeu_si256 ((__m256i *) (d + 64), _mm256_permute2x128_si256 (p0,
+          p1, 0x31));
+  _mm256_storeu_si256 ((__m256i *) (d + 96), _mm256_permute2x128_si256 (p2,
+          p3, 0x31));
+}
+
+#define LOAD_COEF(c,coef)               \
+G_STMT_START {                          \
+  gint _i;                              \
+  for (_i = 0; _i < 5; _i++)            \
+    c[_i] = _mm256_set1_epi16 (coef[_i]); \
+} G_STMT_END
+
+void
+video_kernel_I420_to_RGB32_avx2 (guint8 * d, const guint8 * y,
+    const guint8 * u, const guint8 * v, const gint16 * coef, gint width,
+    gboolean swap_rb)
+{
+  __m256i c[5];
+  gint x;
+
+  LOAD_COEF (c, coef);
+
+  for (x = 0; x + 32 <= width; x += 32) {
+    yuv_to_rgb32_avx2 (d + 4 * x, y + x,
+        _mm_loadu_si128 ((const __m128i *) (u + x / 2)),
+        _mm_loadu_si128 ((const __m128i *) (v + x / 2)), c, swap_rb);
+  }
+  video_kernel_I420_to_RGB32_c (d, y, u, v, coef, x, width, swap_rb);
+}
+
+void
+video_kernel_NV12_to_RGB32_avx2 (guint8 * d, const guint8 * y,
+    const guint8 * uv, const gint16 * coef, gint width, gboolean swap_rb)
+{
+  const __m256i shuf = SHUFFLE_DEINTERLEAVE;
+  __m256i c[5];
+  gint x;
+
+  LOAD_COEF (c, coef);
+
+  for (x = 0; x + 32 <= width; x += 32) {
+    __m256i s;
+
+    s = _mm256_loadu_si256 ((const __m256i *) (uv + x));
+    s = _mm256_permute4x64_epi64 (_mm256_shuffle_epi8 (s, shuf),
+        _MM_SHUFFLE (3, 1, 2, 0));
+
+    yuv_to_rgb32_avx2 (d + 4 * x, y + x, _mm256_castsi256_si128 (s),
+        _mm256_extracti128_si256 (s, 1), c, swap_rb);
+  }
+  video_kernel_NV12_to_RGB32_c (d, y, uv, coef, x, width, swap_rb);
+}
+
+/* The v210 kernels do one 16 bytes group of 6 pixels in each 128 bits
+ * lane. The samples are moved to 16 bits words with a shuffle and aligned
+ * with a multiplication, which is a per word left shift, before a right
+ * shift of 4. */
+
+void
+video_kernel_unpack_v210_avx2 (guint16 * y, guint16 * u, guint16 * v,
+    const guint8 * s, gint width)
+{
+  const __m256i shuf_y = _mm256_setr_epi8 (1, 2, 4, 5, 6, 7, 9, 10, 12, 13,
+      14, 15, -1, -1, -1, -1, 1, 2, 4, 5, 6, 7, 9, 10, 12, 13, 14, 15, -1, -1,
+      -1, -1);
+  const __m256i mul_y = _mm256_setr_epi16 (4, 16, 1, 4, 16, 1, 0, 0,
+      4, 16, 1, 4, 16, 1, 0, 0);
+  const __m256i shuf_uv = _mm256_setr_epi8 (0, 1, 5, 6, 10, 11, 2, 3, 8, 9,
+      13, 14, -1, -1, -1, -1, 0, 1, 5, 6, 10, 11, 2, 3, 8, 9, 13, 14, -1, -1,
+      -1, -1);
+  const __m256i mul_uv = _mm256_setr_epi16 (16, 4, 1, 1, 16, 4, 0, 0,
+      16, 4, 1, 1, 16, 4, 0, 0);
+  const __m256i mask = _mm256_set1_epi16 (0x3ff);
+  gint x;
+
+  /* the stores of the second group go 2 pixels past it */
+  for (x = 0; x + 14 <= width; x += 12) {
+    __m256i p, wy, wuv, wv;
+
+    p = _mm256_loadu_si256 ((const __m256i *) (s + (x / 6) * 16));
+
+    wy = _mm256_mullo_epi16 (_mm256_shuffle_epi8 (p, shuf_y), mul_y);
+    wy = _mm256_and_si256 (_mm256_srli_epi16 (wy, 4), mask);
+    /* U0 U1 U2 V0 V1 V2 in each lane */
+    wuv = _mm256_mullo_epi16 (_mm256_shuffle_epi8 (p, shuf_uv), mul_uv);
+    wuv = _mm256_and_si256 (_mm256_srli_epi16 (wuv, 4), mask);
+    wv = _mm256_srli_si256 (wuv, 6);
+
+    _mm_storeu_si128 ((__m128i *) (y + x), _mm256_castsi256_si128 (wy));
+    _mm_storeu_si128 ((__m128i *) (y + x + 6),
+        _mm256_extracti128_si256 (wy, 1));
+    _mm_storel_epi64 ((__m128i *) (u + x / 2), _mm256_castsi256_si128 (wuv));
+    _mm_storel_epi64 ((__m128i *) (u + x / 2 + 3),
+        _mm256_extracti128_si256 (wuv, 1));
+    _mm_storel_epi64 ((__m128i *) (v + x / 2), _mm256_castsi256_si128 (wv));
+    _mm_storel_epi64 ((__m128i *) (v + x / 2 + 3),
+        _mm256_extracti128_si256 (wv, 1));
+  }
+  video_kernel_unpack_v210_c (y, u, v, s, x, width);
+}
+
+void
+video_kernel_pack_v210_avx2 (guint8 * d, const guint16 * y,
+    const guint16 * u, const guint16 * v, gint width)
+{
+  /* the 32 bits words are a | b << 10 | c << 20 with
+   * a = U0 Y1 V1 Y4, b = Y0 U1 Y3 V2 and c = V0 Y2 U2 Y5 */
+  const __m256i shuf_ay = _mm256_setr_epi8 (-1, -1, -1, -1, 2, 3, -1, -1,
+      -1, -1, -1, -1, 8, 9, -1, -1, -1, -1, -1, -1, 2, 3, -1, -1, -1, -1, -1,
+      -1, 8, 9, -1, -1);
+  const __m256i shuf_auv = _mm256_setr_epi8 (0, 1, -1, -1, -1, -1, -1, -1,
+      10, 11, -1, -1, -1, -1, -1, -1, 0, 1, -1, -1, -1, -1, -1, -1, 10, 11, -1,
+      -1, -1, -1, -1, -1);
+  const __m256i shuf_by = _mm256_setr_epi8 (0, 1, -1, -1, -1, -1, -1, -1,
+      6, 7, -1, -1, -1, -1, -1, -1, 0, 1, -1, -1, -1, -1, -1, -1, 6, 7, -1, -1,
+      -1, -1, -1, -1);
+  const __m256i shuf_buv = _mm256_setr_epi8 (-1, -1, -1, -1, 2, 3, -1, -1,
+      -1, -1, -1, -1, 12, 13, -1, -1, -1, -1, -1, -1, 2, 3, -1, -1, -1, -1, -1,
+      -1, 12, 13, -1, -1);
+  const __m256i shuf_cy = _mm256_setr_epi8 (-1, -1, -1, -1, 4, 5, -1, -1,
+      -1, -1, -1, -1, 10, 11, -1, -1, -1, -1, -1, -1, 4, 5, -1, -1, -1, -1, -1,
+      -1, 10, 11, -1, -1);
+  const __m256i shuf_cuv = _mm256_setr_epi8 (8, 9, -1, -1, -1, -1, -1, -1,
+      4, 5, -1, -1, -1, -1, -1, -1, 8, 9, -1, -1, -1, -1, -1, -1, 4, 5, -1, -1,
+      -1, -1, -1, -1);
+  const __m256i mask = _mm256_set1_epi32 (0x3ff);
+  gint x;
+
+  /* the loads of the second group go 2 pixels past it */
+  for (x = 0; x + 14 <= width; x += 12) {
+    __m256i wy, wuv, a, b, c;
+    __m128i uv0, uv1;
+
+    wy = _mm256_castsi128_si256 (_mm_loadu_si128 ((const __m128i *) (y + x)));
+    wy = _mm256_inserti128_si256 (wy,
+        _mm_loadu_si128 ((const __m128i *) (y + x + 6)), 1);
+    /* U0 U1 U2 x V0 V1 V2 x in each lane */
+    uv0 = _mm_unpacklo_epi64 (_mm_loadl_epi64 ((const __m128i *) (u + x / 2)),
+        _mm_loadl_epi64 ((const __m128i *) (v + x / 2)));
+    uv1 = _mm_unpacklo_epi64 (_mm_loadl_epi64 ((const __m128i *) (u + x / 2 +
+                3)), _mm_loadl_epi64 ((const __m128i *) (v + x / 2 + 3)));
+    wuv = _mm256_inserti128_si256 (_mm256_castsi128_si256 (uv0), uv1, 1);
+
+    a = _mm256_or_si256 (_mm256_shuffle_epi8 (wy, shuf_ay),
+        _mm256_shuffle_epi8 (wuv, shuf_auv));
+    b = _mm256_or_si256 (_mm256_shuffle_epi8 (wy, shuf_by),
+        _mm256_shuffle_epi8 (wuv, shuf_buv));
+    c = _mm256_or_si256 (_mm256_shuffle_epi8 (wy, shuf_cy),
+        _mm256_shuffle_epi8 (wuv, shuf_cuv));
+
+    a = _mm256_and_si256 (a, mask);
+    a = _mm256_or_si256 (a, _mm256_slli_epi32 (_mm256_and_si256 (b, mask),
+            10));
+    a = _mm256_or_si256 (a, _mm256_slli_epi32 (_mm256_and_si256 (c, mask),
+            20));
+
+    _mm256_storeu_si256 ((__m256i *) (d + (x / 6) * 16), a);
+  }
+  video_kernel_pack_v210_c (d, y, u, v, x, width);
+}
+
+#endif
@@ -0,0 +1,103 @@
+/* GStreamer
+ *
+ * video-converter-x86-avx512.c: AVX-512 line kernels of the video converter
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "video-converter-kernels.h"
+
+#if defined (__x86_64__) && defined (HAVE_IMMINTRIN_H) && \
+    defined (__AVX512F__) && defined (__AVX512BW__)
+
+#include <immintrin.h>
+
+/* Only the kernels that are bound by the memory bandwidth are here, they
+ * handle 64 bytes per instruction. */
+
+void
+video_kernel_deinterleave_avx512 (guint8 * u, guint8 * v, const guint8 * uv,
+    gint n)
+{
+  const __m512i shuf = _mm512_broadcast_i32x4 (_mm_setr_epi8 (0, 2, 4, 6, 8,
+          10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15));
+  const __m512i perm = _mm512_setr_epi64 (0, 2, 4, 6, 1, 3, 5, 7);
+  gint i;
+
+  for (i = 0; i + 64 <= n; i += 64) {
+    __m512i a, b;
+
+    a = _mm512_loadu_si512 ((const void *) (uv + 2 * i));
+    b = _mm512_loadu_si512 ((const void *) (uv + 2 * i + 64));
+    /* [u0-31 | v0-31] and [u32-63 | v32-63] */
+    a = _mm512_permutexvar_epi64 (perm, _mm512_shuffle_epi8 (a, shuf));
+    b = _mm512_permutexvar_epi64 (perm, _mm512_shuffle_epi8 (b, shuf));
+
+    _mm512_storeu_si512 ((void *) (u + i), _mm512_shuffle_i64x2 (a, b, 0x44));
+    _mm512_storeu_si512 ((void *) (v + i), _mm512_shuffle_i64x2 (a, b, 0xee));
+  }
+  video_kernel_deinterleave_c (u + i, v + i, uv + 2 * i, n - i);
+}
+
+void
+video_kernel_interleave_avx512 (guint8 * uv, const guint8 * u,
+    const guint8 * v, gint n)
+{
+  const __m512i perm_lo = _mm512_setr_epi64 (0, 1, 8, 9, 2, 3, 10, 11);
+  const __m512i perm_hi = _mm512_setr_epi64 (4, 5, 12, 13, 6, 7, 14, 15);
+  gint i;
+
+  for (i = 0; i + 64 <= n; i += 64) {
+    __m512i a, b, lo, hi;
+
+    a = _mm512_loadu_si512 ((const void *) (u + i));
+    b = _mm512_loadu_si512 ((const void *) (v + i));
+    /* [0-7 | 16-23 | 32-39 | 48-55] and [8-15 | 24-31 | 40-47 | 56-63] */
+    lo = _mm512_unpacklo_epi8 (a, b);
+    hi = _mm512_unpackhi_epi8 (a, b);
+
+    _mm512_storeu_si512 ((void *) (uv + 2 * i),
+        _mm512_permutex2var_epi64 (lo, perm_lo, hi));
+    _mm512_storeu_si512 ((void *) (uv + 2 * i + 64),
+        _mm512_permutex2var_epi64 (lo, perm_hi, hi));
+  }
+  video_kernel_interleave_c (uv + 2 * i, u + i, v + i, n - i);
+}
+
+void
+video_kernel_narrow_avx512 (guint8 * d, const guint8 * s, gint n)
+{
+  const __m512i perm = _mm512_setr_epi64 (0, 2, 4, 6, 1, 3, 5, 7);
+  gint i;
+
+  for (i = 0; i + 64 <= n; i += 64) {
+    __m512i a, b;
+
+    a = _mm512_srli_epi16 (_mm512_loadu_si512 ((const void *) (s + 2 * i)), 8);
+    b = _mm512_srli_epi16 (_mm512_loadu_si512 ((const void *) (s + 2 * i +
+                64)), 8);
+    a = _mm512_permutexvar_epi64 (perm, _mm512_packus_epi16 (a, b));
+
+    _mm512_storeu_si512 ((void *) (d + i), a);
+  }
+  video_kernel_narrow_c (d + i, s + 2 * i, n - i);
+}
+
+#endif
@@ -37,6 +37,7 @@
 #include <gst/base/base.h>
 
 #include "video-orc.h"
+#include "video-converter-kernels.h"
 
 /**
  * SECTION:videoconverter
@@ -125,17 +126,24 @@ struct _GstParallelizedWorkItem
 {
   GstParallelizedTaskRunner *self;
   GstParallelizedTaskFunc func;
-  gpointer user_data;
+  gpointer *task_data;
+  gint n_tasks;
+
+  /* the workers take the tasks in order until there are none left */
+  gint next_task;
+  /* the number of workers using the work item, for async tasks */
+  gint refcount;
 };
 
 struct _GstParallelizedTaskRunner
 {
   GstTaskPool *pool;
-  gboolean own_pool;
+  /* the maximum number of tasks that run in parallel */
   guint n_threads;
+  /* the number of tasks the work is split in */
+  guint n_tasks;
 
   GstVecDeque *tasks;
-  GstVecDeque *work_items;
 
   GMutex lock;
 
@@ -143,21 +151,25 @@ struct _GstParallelizedTaskRunner
 };
 
 static void
-gst_parallelized_task_thread_func (gpointer data)
+gst_parallelized_work_item_run (GstParallelizedWorkItem * work_item)
 {
-  GstParallelizedTaskRunner *runner = data;
-  GstParallelizedWorkItem *work_item;
+  gint i;
 
-  g_mutex_lock (&runner->lock);
-  work_item = gst_vec_deque_pop_head (runner->work_items);
-  g_mutex_unlock (&runner->lock);
+  while ((i = g_atomic_int_add (&work_item->next_task, 1)) <
+      work_item->n_tasks)
+    work_item->func (work_item->task_data[i]);
+}
 
-  g_assert (work_item != NULL);
-  g_assert (work_item->func != NULL);
+static void
+gst_parallelized_task_thread_func (gpointer data)
+{
+  GstParallelizedWorkItem *work_item = data;
 
+  g_assert (work_item->func != NULL);
 
-  work_item->func (work_item->user_data);
-  if (runner->async_tasks)
+  gst_parallelized_work_item_run (work_item);
+  if (work_item->self->async_tasks
+      && g_atomic_int_dec_and_test (&work_item->refcount))
     g_free (work_item);
 }
 
@@ -183,18 +195,15 @@ gst_parallelized_task_runner_free (GstParallelizedTaskRunner * self)
 {
   gst_parallelized_task_runner_join (self);
 
-  gst_vec_deque_free (self->work_items);
   gst_vec_deque_free (self->tasks);
-  if (self->own_pool)
-    gst_task_pool_cleanup (self->pool);
-  gst_object_unref (self->pool);
+  gst_clear_object (&self->pool);
   g_mutex_clear (&self->lock);
   g_free (self);
 }
 
 static GstParallelizedTaskRunner *
-gst_parallelized_task_runner_new (guint n_threads, GstTaskPool * pool,
-    gboolean async_tasks)
+gst_parallelized_task_runner_new (guint n_threads, guint n_tasks,
+    GstTaskPool * pool, gboolean async_tasks)
 {
   GstParallelizedTaskRunner *self;
 
@@ -205,26 +214,21 @@ gst_parallelized_task_runner_new (guint n_threads, GstTaskPool * pool,
 
   if (pool) {
     self->pool = g_object_ref (pool);
-    self->own_pool = FALSE;
 
-    /* No reason to split up the work between more threads than the
-     * pool can spawn */
+    /* No reason to run more tasks in parallel than the pool can spawn
+     * threads */
     if (GST_IS_SHARED_TASK_POOL (pool))
       n_threads =
           MIN (n_threads,
           gst_shared_task_pool_get_max_threads (GST_SHARED_TASK_POOL (pool)));
-  } else {
-    self->pool = gst_shared_task_pool_new ();
-    self->own_pool = TRUE;
-    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (self->pool),
-        n_threads);
-    gst_task_pool_prepare (self->pool, NULL);
+  } else if (n_threads > 1 || async_tasks) {
+    self->pool = gst_object_ref (gst_work_stealing_task_pool_get_default ());
   }
 
-  self->tasks = gst_vec_deque_new (n_threads);
-  self->work_items = gst_vec_deque_new (n_threads);
+  self->n_threads = MAX (MIN (n_threads, n_tasks), 1);
+  self->n_tasks = MAX (n_tasks, 1);
 
-  self->n_threads = n_threads;
+  self->tasks = gst_vec_deque_new (self->n_threads);
 
   g_mutex_init (&self->lock);
 
@@ -240,36 +244,40 @@ gst_parallelized_task_runner_finish (GstParallelizedTaskRunner * self)
   gst_parallelized_task_runner_join (self);
 }
 
+/* Runs @func on all the n_tasks elements of @task_data, with up to n_threads
+ * of them in parallel */
 static void
 gst_parallelized_task_runner_run (GstParallelizedTaskRunner * self,
     GstParallelizedTaskFunc func, gpointer * task_data)
 {
-  guint n_threads = self->n_threads;
+  GstParallelizedWorkItem *work_item;
+  guint n_workers = self->n_threads;
 
-  if (n_threads > 1 || self->async_tasks) {
-    guint i = 0;
-    g_mutex_lock (&self->lock);
-    if (!self->async_tasks) {
-      /* if not async, perform one of the functions in the current thread */
-      i = 1;
-    }
-    for (; i < n_threads; i++) {
-      gpointer task;
-      GstParallelizedWorkItem *work_item;
+  if (!self->async_tasks) {
+    /* if not async, the current thread is one of the workers */
+    n_workers--;
+    work_item = g_newa (GstParallelizedWorkItem, 1);
+  } else {
+    work_item = g_new (GstParallelizedWorkItem, 1);
+  }
 
-      if (!self->async_tasks)
-        work_item = g_newa (GstParallelizedWorkItem, 1);
-      else
-        work_item = g_new0 (GstParallelizedWorkItem, 1);
+  work_item->self = self;
+  work_item->func = func;
+  work_item->task_data = task_data;
+  work_item->n_tasks = self->n_tasks;
+  work_item->next_task = 0;
+  work_item->refcount = n_workers;
 
-      work_item->self = self;
-      work_item->func = func;
-      work_item->user_data = task_data[i];
-      gst_vec_deque_push_tail (self->work_items, work_item);
+  if (n_workers > 0) {
+    guint i;
+
+    g_mutex_lock (&self->lock);
+    for (i = 0; i < n_workers; i++) {
+      gpointer task;
 
       task =
           gst_task_pool_push (self->pool, gst_parallelized_task_thread_func,
-          self, NULL);
+          work_item, NULL);
 
       /* The return value of push() is unfortunately nullable, and we can't deal with that */
       g_assert (task != NULL);
@@ -279,7 +287,7 @@ gst_parallelized_task_runner_run (GstParallelizedTaskRunner * self,
   }
 
   if (!self->async_tasks) {
-    func (task_data[0]);
+    gst_parallelized_work_item_run (work_item);
 
     gst_parallelized_task_runner_finish (self);
   }
@@ -2124,7 +2132,7 @@ setup_allocators (GstVideoConverter * convert)
   width = MAX (convert->in_maxwidth, convert->out_maxwidth);
   width += convert->out_x;
 
-  for (i = 0; i < convert->conversion_runner->n_threads; i++) {
+  for (i = 0; i < convert->conversion_runner->n_tasks; i++) {
     /* start with using dest lines if we can directly write into it */
     if (convert->identity_pack) {
       alloc_line = get_dest_line;
@@ -2396,6 +2404,32 @@ gst_video_converter_init_from_config (GstVideoConverter * convert)
   }
 }
 
+/* The work is split in tiles of whole lines. A tile is big enough to make
+ * the scheduling cost negligible and small frames are not split needlessly.
+ * Big frames get a few tiles per thread, so the threads that finish early
+ * take over the remaining tiles. */
+#define TILE_MIN_PIXELS (256 * 1024)
+#define TILE_MIN_LINES 16
+#define TILES_PER_THREAD 2
+
+static guint
+video_converter_n_tiles (GstVideoConverter * convert, guint n_threads)
+{
+  guint64 width, height, n_tiles;
+
+  if (n_threads <= 1)
+    return 1;
+
+  width = MAX (convert->in_width, convert->out_width);
+  height = MAX (convert->in_height, convert->out_height);
+
+  n_tiles = (width * height) / TILE_MIN_PIXELS;
+  n_tiles = MIN (n_tiles, height / TILE_MIN_LINES);
+  n_tiles = MIN (n_tiles, n_threads * TILES_PER_THREAD);
+
+  return MAX (n_tiles, 1);
+}
+
 /**
  * gst_video_converter_new_with_pool: (skip)
  * @in_info: a #GstVideoInfo
@@ -2408,6 +2442,8 @@ gst_video_converter_init_from_config (GstVideoConverter * convert)
  *
  * The optional @pool can be used to spawn threads, this is useful when
  * creating new converters rapidly, for example when updating cropping.
+ * Without @pool, the threads come from the pool that is shared by the whole
+ * process, see gst_work_stealing_task_pool_get_default().
  *
  * Returns (nullable): a #GstVideoConverter or %NULL if conversion is not possible.
  *
@@ -2419,7 +2455,7 @@ gst_video_converter_new_with_pool (const GstVideoInfo * in_info,
 {
   GstVideoConverter *convert;
   GstLineCache *prev;
-  gint n_threads, i;
+  gint n_threads, n_tasks, i;
   gboolean async_tasks;
 
   g_return_val_if_fail (in_info != NULL, NULL);
@@ -2450,15 +2486,11 @@ gst_video_converter_new_with_pool (const GstVideoInfo * in_info,
   n_threads = get_opt_uint (convert, GST_VIDEO_CONVERTER_OPT_THREADS, 1);
   if (n_threads == 0 || n_threads > g_get_num_processors ())
     n_threads = g_get_num_processors ();
-  /* Magic number of 200 lines */
-  if (MAX (convert->out_height, convert->in_height) / n_threads < 200)
-    n_threads = (MAX (convert->out_height, convert->in_height) + 199) / 200;
-  if (n_threads < 1)
-    n_threads = 1;
+  n_tasks = video_converter_n_tiles (convert, n_threads);
 
   async_tasks = GET_OPT_ASYNC_TASKS (convert);
   convert->conversion_runner =
-      gst_parallelized_task_runner_new (n_threads, pool, async_tasks);
+      gst_parallelized_task_runner_new (n_threads, n_tasks, pool, async_tasks);
 
   if (video_converter_lookup_fastpath (convert))
     goto done;
@@ -2471,29 +2503,29 @@ gst_video_converter_new_with_pool (const GstVideoInfo * in_info,
 
   convert->convert = video_converter_generic;
 
-  convert->upsample_p = g_new0 (GstVideoChromaResample *, n_threads);
-  convert->upsample_i = g_new0 (GstVideoChromaResample *, n_threads);
-  convert->downsample_p = g_new0 (GstVideoChromaResample *, n_threads);
-  convert->downsample_i = g_new0 (GstVideoChromaResample *, n_threads);
-  convert->v_scaler_p = g_new0 (GstVideoScaler *, n_threads);
-  convert->v_scaler_i = g_new0 (GstVideoScaler *, n_threads);
-  convert->h_scaler = g_new0 (GstVideoScaler *, n_threads);
-  convert->unpack_lines = g_new0 (GstLineCache *, n_threads);
-  convert->pack_lines = g_new0 (GstLineCache *, n_threads);
-  convert->upsample_lines = g_new0 (GstLineCache *, n_threads);
-  convert->to_RGB_lines = g_new0 (GstLineCache *, n_threads);
-  convert->hscale_lines = g_new0 (GstLineCache *, n_threads);
-  convert->vscale_lines = g_new0 (GstLineCache *, n_threads);
-  convert->convert_lines = g_new0 (GstLineCache *, n_threads);
-  convert->alpha_lines = g_new0 (GstLineCache *, n_threads);
-  convert->to_YUV_lines = g_new0 (GstLineCache *, n_threads);
-  convert->downsample_lines = g_new0 (GstLineCache *, n_threads);
-  convert->dither_lines = g_new0 (GstLineCache *, n_threads);
-  convert->dither = g_new0 (GstVideoDither *, n_threads);
+  convert->upsample_p = g_new0 (GstVideoChromaResample *, n_tasks);
+  convert->upsample_i = g_new0 (GstVideoChromaResample *, n_tasks);
+  convert->downsample_p = g_new0 (GstVideoChromaResample *, n_tasks);
+  convert->downsample_i = g_new0 (GstVideoChromaResample *, n_tasks);
+  convert->v_scaler_p = g_new0 (GstVideoScaler *, n_tasks);
+  convert->v_scaler_i = g_new0 (GstVideoScaler *, n_tasks);
+  convert->h_scaler = g_new0 (GstVideoScaler *, n_tasks);
+  convert->unpack_lines = g_new0 (GstLineCache *, n_tasks);
+  convert->pack_lines = g_new0 (GstLineCache *, n_tasks);
+  convert->upsample_lines = g_new0 (GstLineCache *, n_tasks);
+  convert->to_RGB_lines = g_new0 (GstLineCache *, n_tasks);
+  convert->hscale_lines = g_new0 (GstLineCache *, n_tasks);
+  convert->vscale_lines = g_new0 (GstLineCache *, n_tasks);
+  convert->convert_lines = g_new0 (GstLineCache *, n_tasks);
+  convert->alpha_lines = g_new0 (GstLineCache *, n_tasks);
+  convert->to_YUV_lines = g_new0 (GstLineCache *, n_tasks);
+  convert->downsample_lines = g_new0 (GstLineCache *, n_tasks);
+  convert->dither_lines = g_new0 (GstLineCache *, n_tasks);
+  convert->dither = g_new0 (GstVideoDither *, n_tasks);
 
   if (convert->in_width > 0 && convert->out_width > 0 && convert->in_height > 0
       && convert->out_height > 0) {
-    for (i = 0; i < n_threads; i++) {
+    for (i = 0; i < n_tasks; i++) {
       convert->current_format = GST_VIDEO_INFO_FORMAT (in_info);
       convert->current_width = convert->in_width;
       convert->current_height = convert->in_height;
@@ -2590,7 +2622,7 @@ gst_video_converter_free (GstVideoConverter * convert)
 
   g_return_if_fail (convert != NULL);
 
-  for (i = 0; i < convert->conversion_runner->n_threads; i++) {
+  for (i = 0; i < convert->conversion_runner->n_tasks; i++) {
     if (convert->upsample_p && convert->upsample_p[i])
       gst_video_chroma_resample_free (convert->upsample_p[i]);
     if (convert->upsample_i && convert->upsample_i[i])
@@ -2652,7 +2684,7 @@ gst_video_converter_free (GstVideoConverter * convert)
   g_free (convert->gamma_enc.gamma_table);
 
   if (convert->tmpline) {
-    for (i = 0; i < convert->conversion_runner->n_threads; i++)
+    for (i = 0; i < convert->conversion_runner->n_tasks; i++)
       g_free (convert->tmpline[i]);
     g_free (convert->tmpline);
   }
@@ -2663,7 +2695,7 @@ gst_video_converter_free (GstVideoConverter * convert)
     gst_structure_free (convert->config);
 
   for (i = 0; i < 4; i++) {
-    for (j = 0; j < convert->conversion_runner->n_threads; j++) {
+    for (j = 0; j < convert->conversion_runner->n_tasks; j++) {
       if (convert->fv_scaler[i].scaler)
         gst_video_scaler_free (convert->fv_scaler[i].scaler[j]);
       if (convert->fh_scaler[i].scaler)
@@ -3321,7 +3353,7 @@ video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
       PACK_FRAME (dest, convert->borderline, i, out_maxwidth);
   }
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (ConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3362,6 +3394,117 @@ video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
 static void convert_fill_border (GstVideoConverter * convert,
     GstVideoFrame * dest);
 
+/* Line kernels of the fast paths. The vectorized versions are selected
+ * once, at runtime, depending on the instructions the CPU supports. */
+
+static void
+kernel_I420_to_RGB32_orc (guint8 * d, const guint8 * y, const guint8 * u,
+    const guint8 * v, const gint16 * coef, gint width, gboolean swap_rb)
+{
+  if (swap_rb) {
+    video_kernel_I420_to_RGB32_c (d, y, u, v, coef, 0, width, swap_rb);
+    return;
+  }
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+  video_orc_convert_I420_BGRA (d, y, u, v, coef[0], coef[1], coef[2],
+      coef[3], coef[4], width);
+#else
+  video_orc_convert_I420_ARGB (d, y, u, v, coef[0], coef[1], coef[2],
+      coef[3], coef[4], width);
+#endif
+}
+
+#define KERNEL_CHUNK 256
+
+static void
+kernel_NV12_to_RGB32_orc (guint8 * d, const guint8 * y, const guint8 * uv,
+    const gint16 * coef, gint width, gboolean swap_rb)
+{
+  guint8 u[KERNEL_CHUNK / 2], v[KERNEL_CHUNK / 2];
+  gint x, n;
+
+  for (x = 0; x < width; x += KERNEL_CHUNK) {
+    n = MIN (width - x, KERNEL_CHUNK);
+    video_kernel_deinterleave_c (u, v, uv + x, (n + 1) / 2);
+    kernel_I420_to_RGB32_orc (d + 4 * x, y + x, u, v, coef, n, swap_rb);
+  }
+}
+
+static void
+kernel_unpack_v210_c (guint16 * y, guint16 * u, guint16 * v,
+    const guint8 * s, gint width)
+{
+  video_kernel_unpack_v210_c (y, u, v, s, 0, width);
+}
+
+static void
+kernel_pack_v210_c (guint8 * d, const guint16 * y, const guint16 * u,
+    const guint16 * v, gint width)
+{
+  video_kernel_pack_v210_c (d, y, u, v, 0, width);
+}
+
+static const VideoConverterKernels *
+video_converter_get_kernels (void)
+{
+  static VideoConverterKernels kernels;
+  static gsize kernels_gonce = 0;
+
+  if (g_once_init_enter (&kernels_gonce)) {
+    kernels.deinterleave = video_kernel_deinterleave_c;
+    kernels.interleave = video_kernel_interleave_c;
+    kernels.narrow = video_kernel_narrow_c;
+    kernels.I420_to_RGB32 = kernel_I420_to_RGB32_orc;
+    kernels.NV12_to_RGB32 = kernel_NV12_to_RGB32_orc;
+    kernels.unpack_v210 = kernel_unpack_v210_c;
+    kernels.pack_v210 = kernel_pack_v210_c;
+
+#if defined (HAVE_NEON)
+    GST_DEBUG ("enable NEON kernels");
+    kernels.deinterleave = video_kernel_deinterleave_neon;
+    kernels.interleave = video_kernel_interleave_neon;
+    kernels.narrow = video_kernel_narrow_neon;
+    kernels.I420_to_RGB32 = video_kernel_I420_to_RGB32_neon;
+    kernels.NV12_to_RGB32 = video_kernel_NV12_to_RGB32_neon;
+#endif
+#if defined (HAVE_AVX2)
+    if (__builtin_cpu_supports ("avx2")) {
+      GST_DEBUG ("enable AVX2 kernels");
+      kernels.deinterleave = video_kernel_deinterleave_avx2;
+      kernels.interleave = video_kernel_interleave_avx2;
+      kernels.narrow = video_kernel_narrow_avx2;
+      kernels.I420_to_RGB32 = video_kernel_I420_to_RGB32_avx2;
+      kernels.NV12_to_RGB32 = video_kernel_NV12_to_RGB32_avx2;
+      kernels.unpack_v210 = video_kernel_unpack_v210_avx2;
+      kernels.pack_v210 = video_kernel_pack_v210_avx2;
+    }
+#endif
+#if defined (HAVE_AVX512)
+    if (__builtin_cpu_supports ("avx512f")
+        && __builtin_cpu_supports ("avx512bw")) {
+      GST_DEBUG ("enable AVX-512 kernels");
+      kernels.deinterleave = video_kernel_deinterleave_avx512;
+      kernels.interleave = video_kernel_interleave_avx512;
+      kernels.narrow = video_kernel_narrow_avx512;
+    }
+#endif
+
+    g_once_init_leave (&kernels_gonce, 1);
+  }
+
+  return &kernels;
+}
+
+/* the coefficients of video_orc_convert_I420_BGRA() */
+#define KERNEL_COEF(coef,data)          \
+G_STMT_START {                          \
+  coef[0] = (data)->im[0][0];           \
+  coef[1] = (data)->im[0][2];           \
+  coef[2] = (data)->im[2][1];           \
+  coef[3] = (data)->im[1][1];           \
+  coef[4] = (data)->im[1][2];           \
+} G_STMT_END
+
 /* Fast paths */
 
 #define GET_LINE_OFFSETS(interlaced,line,l1,l2) \
@@ -3432,7 +3575,7 @@ convert_I420_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3509,7 +3652,7 @@ convert_I420_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3588,7 +3731,7 @@ convert_I420_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
     h2 = GST_ROUND_DOWN_2 (height);
 
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3743,7 +3886,7 @@ convert_I420_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3826,7 +3969,7 @@ convert_YUY2_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3990,7 +4133,7 @@ convert_v210_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4030,6 +4173,176 @@ convert_v210_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
   }
 }
 
+/* The line kernels of these don't depend on the interlacing, a line of
+ * a plane is converted to the same line of the other plane. Lines are given
+ * in pairs to the tasks so that each chroma line of 4:2:0 is only converted
+ * once, with its first luma line. */
+static void
+convert_plane_lines (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest, GstParallelizedTaskFunc func)
+{
+  int i;
+  gint width = convert->in_width;
+  gint height = convert->in_height;
+  FConvertTask *tasks;
+  FConvertTask **tasks_p;
+  gint n_threads;
+  gint lines_per_thread;
+
+  n_threads = convert->conversion_runner->n_tasks;
+  tasks = convert->tasks[0] =
+      g_renew (FConvertTask, convert->tasks[0], n_threads);
+  tasks_p = convert->tasks_p[0] =
+      g_renew (FConvertTask *, convert->tasks_p[0], n_threads);
+
+  lines_per_thread = GST_ROUND_UP_2 ((height + n_threads - 1) / n_threads);
+
+  for (i = 0; i < n_threads; i++) {
+    tasks[i].src = src;
+    tasks[i].dest = dest;
+
+    tasks[i].width = width;
+
+    tasks[i].height_0 = i * lines_per_thread;
+    tasks[i].height_1 = tasks[i].height_0 + lines_per_thread;
+    tasks[i].height_1 = MIN (height, tasks[i].height_1);
+
+    tasks_p[i] = &tasks[i];
+  }
+
+  gst_parallelized_task_runner_run (convert->conversion_runner, func,
+      (gpointer) tasks_p);
+}
+
+static void
+convert_NV12_I420_task (FConvertTask * task)
+{
+  const VideoConverterKernels *kernels = video_converter_get_kernels ();
+  gint i;
+
+  for (i = task->height_0; i < task->height_1; i++) {
+    memcpy (FRAME_GET_Y_LINE (task->dest, i), FRAME_GET_Y_LINE (task->src, i),
+        task->width);
+
+    if (i & 1)
+      continue;
+
+    kernels->deinterleave (FRAME_GET_U_LINE (task->dest, i >> 1),
+        FRAME_GET_V_LINE (task->dest, i >> 1),
+        FRAME_GET_PLANE_LINE (task->src, 1, i >> 1), (task->width + 1) / 2);
+  }
+}
+
+static void
+convert_NV12_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_plane_lines (convert, src, dest,
+      (GstParallelizedTaskFunc) convert_NV12_I420_task);
+}
+
+static void
+convert_I420_NV12_task (FConvertTask * task)
+{
+  const VideoConverterKernels *kernels = video_converter_get_kernels ();
+  gint i;
+
+  for (i = task->height_0; i < task->height_1; i++) {
+    memcpy (FRAME_GET_Y_LINE (task->dest, i), FRAME_GET_Y_LINE (task->src, i),
+        task->width);
+
+    if (i & 1)
+      continue;
+
+    kernels->interleave (FRAME_GET_PLANE_LINE (task->dest, 1, i >> 1),
+        FRAME_GET_U_LINE (task->src, i >> 1),
+        FRAME_GET_V_LINE (task->src, i >> 1), (task->width + 1) / 2);
+  }
+}
+
+static void
+convert_I420_NV12 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_plane_lines (convert, src, dest,
+      (GstParallelizedTaskFunc) convert_I420_NV12_task);
+}
+
+/* like the other 10 to 8 bits fast paths, this keeps the 8 most significant
+ * bits */
+static void
+convert_P010_NV12_task (FConvertTask * task)
+{
+  const VideoConverterKernels *kernels = video_converter_get_kernels ();
+  gint i;
+
+  for (i = task->height_0; i < task->height_1; i++) {
+    kernels->narrow (FRAME_GET_PLANE_LINE (task->dest, 0, i),
+        FRAME_GET_PLANE_LINE (task->src, 0, i), task->width);
+
+    if (i & 1)
+      continue;
+
+    kernels->narrow (FRAME_GET_PLANE_LINE (task->dest, 1, i >> 1),
+        FRAME_GET_PLANE_LINE (task->src, 1, i >> 1),
+        GST_ROUND_UP_2 (task->width));
+  }
+}
+
+static void
+convert_P010_NV12 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_plane_lines (convert, src, dest,
+      (GstParallelizedTaskFunc) convert_P010_NV12_task);
+}
+
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+static void
+convert_v210_I422_10LE_task (FConvertTask * task)
+{
+  const VideoConverterKernels *kernels = video_converter_get_kernels ();
+  gint i;
+
+  for (i = task->height_0; i < task->height_1; i++) {
+    kernels->unpack_v210 ((guint16 *) FRAME_GET_Y_LINE (task->dest, i),
+        (guint16 *) FRAME_GET_U_LINE (task->dest, i),
+        (guint16 *) FRAME_GET_V_LINE (task->dest, i),
+        FRAME_GET_LINE (task->src, i), task->width);
+  }
+}
+
+static void
+convert_v210_I422_10LE (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  convert_plane_lines (convert, src, dest,
+      (GstParallelizedTaskFunc) convert_v210_I422_10LE_task);
+}
+
+static void
+convert_I422_10LE_v210_task (FConvertTask * task)
+{
+  const VideoConverterKernels *kernels = video_converter_get_kernels ();
+  gint i;
+
+  for (i = task->height_0; i < task->height_1; i++) {
+    kernels->pack_v210 (FRAME_GET_LINE (task->dest, i),
+        (const guint16 *) FRAME_GET_Y_LINE (task->src, i),
+        (const guint16 *) FRAME_GET_U_LINE (task->src, i),
+        (const guint16 *) FRAME_GET_V_LINE (task->src, i), task->width);
+  }
+}
+
+static void
+convert_I422_10LE_v210 (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  convert_plane_lines (convert, src, dest,
+      (GstParallelizedTaskFunc) convert_I422_10LE_v210_task);
+}
+#endif
+
 typedef struct
 {
   const guint8 *s, *s2, *su, *sv;
@@ -4067,7 +4380,7 @@ convert_YUY2_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4174,7 +4487,7 @@ convert_YUY2_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4233,7 +4546,7 @@ convert_YUY2_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x >> 1;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4298,7 +4611,7 @@ convert_YUY2_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4422,7 +4735,7 @@ convert_v210_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x >> 1;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4497,7 +4810,7 @@ convert_UYVY_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4557,7 +4870,7 @@ convert_UYVY_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4664,7 +4977,7 @@ convert_UYVY_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4717,7 +5030,7 @@ convert_UYVY_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4830,7 +5143,7 @@ convert_v210_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4943,7 +5256,7 @@ convert_v210_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5002,7 +5315,7 @@ convert_UYVY_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x >> 1;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5067,7 +5380,7 @@ convert_UYVY_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5123,7 +5436,7 @@ convert_UYVY_GRAY8 (GstVideoConverter * convert, const GstVideoFrame * src,
   s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
   d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5192,7 +5505,7 @@ convert_AYUV_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
 
   /* only for even width/height */
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5252,7 +5565,7 @@ convert_AYUV_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
   /* only for even width */
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5306,7 +5619,7 @@ convert_AYUV_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
   /* only for even width */
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5366,7 +5679,7 @@ convert_AYUV_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   dv += convert->out_x >> 1;
 
   /* only works for even width */
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5429,7 +5742,7 @@ convert_AYUV_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5492,7 +5805,7 @@ convert_Y42B_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5556,7 +5869,7 @@ convert_Y42B_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5623,7 +5936,7 @@ convert_Y42B_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   d += convert->out_x * 4;
 
   /* only for even width */
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5741,7 +6054,7 @@ convert_Y42B_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
   sv = FRAME_GET_V_LINE (src, convert->in_y);
   sv += convert->in_x >> 1;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5805,7 +6118,7 @@ convert_Y444_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5869,7 +6182,7 @@ convert_Y444_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5935,7 +6248,7 @@ convert_Y444_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += convert->out_x * 4;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5997,7 +6310,7 @@ convert_AYUV_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6054,7 +6367,7 @@ convert_AYUV_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6111,7 +6424,7 @@ convert_AYUV_ABGR (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6168,7 +6481,7 @@ convert_AYUV_RGBA (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6201,8 +6514,12 @@ convert_AYUV_RGBA (GstVideoConverter * convert, const GstVideoFrame * src,
 static void
 convert_I420_BGRA_task (FConvertTask * task)
 {
+  const VideoConverterKernels *kernels = video_converter_get_kernels ();
+  gint16 coef[5];
   gint i;
 
+  KERNEL_COEF (coef, task->data);
+
   for (i = task->height_0; i < task->height_1; i++) {
     guint8 *sy, *su, *sv, *d;
 
@@ -6215,17 +6532,7 @@ convert_I420_BGRA_task (FConvertTask * task)
     sv = FRAME_GET_V_LINE (task->src, (i + task->in_y) >> 1);
     sv += (task->in_x >> 1);
 
-#if G_BYTE_ORDER == G_LITTLE_ENDIAN
-    video_orc_convert_I420_BGRA (d, sy, su, sv,
-        task->data->im[0][0], task->data->im[0][2],
-        task->data->im[2][1], task->data->im[1][1], task->data->im[1][2],
-        task->width);
-#else
-    video_orc_convert_I420_ARGB (d, sy, su, sv,
-        task->data->im[0][0], task->data->im[0][2],
-        task->data->im[2][1], task->data->im[1][1], task->data->im[1][2],
-        task->width);
-#endif
+    kernels->I420_to_RGB32 (d, sy, su, sv, coef, task->width, FALSE);
   }
 }
 
@@ -6242,7 +6549,7 @@ convert_I420_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
   gint n_threads;
   gint lines_per_thread;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6318,7 +6625,7 @@ convert_I420_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
   gint n_threads;
   gint lines_per_thread;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6356,6 +6663,36 @@ convert_I420_pack_ARGB_task (FConvertTask * task)
   gint i;
   gpointer d[GST_VIDEO_MAX_PLANES];
 
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+  const VideoConverterKernels *kernels = video_converter_get_kernels ();
+
+  /* RGBA is BGRA with red and blue swapped, the vectorized kernels do that
+   * directly. Without them, orc and the pack function are faster. */
+  if (kernels->I420_to_RGB32 != kernel_I420_to_RGB32_orc &&
+      (GST_VIDEO_FRAME_FORMAT (task->dest) == GST_VIDEO_FORMAT_RGBA ||
+          GST_VIDEO_FRAME_FORMAT (task->dest) == GST_VIDEO_FORMAT_RGBx)) {
+    gint16 coef[5];
+
+    KERNEL_COEF (coef, task->data);
+
+    for (i = task->height_0; i < task->height_1; i++) {
+      guint8 *sy, *su, *sv, *dp;
+
+      dp = FRAME_GET_LINE (task->dest, i + task->out_y);
+      dp += (task->out_x * 4);
+      sy = FRAME_GET_Y_LINE (task->src, i + task->in_y);
+      sy += task->in_x;
+      su = FRAME_GET_U_LINE (task->src, (i + task->in_y) >> 1);
+      su += (task->in_x >> 1);
+      sv = FRAME_GET_V_LINE (task->src, (i + task->in_y) >> 1);
+      sv += (task->in_x >> 1);
+
+      kernels->I420_to_RGB32 (dp, sy, su, sv, coef, task->width, TRUE);
+    }
+    return;
+  }
+#endif
+
   d[0] = FRAME_GET_LINE (task->dest, 0);
   d[0] =
       (guint8 *) d[0] +
@@ -6404,7 +6741,7 @@ convert_I420_pack_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
   gint n_threads;
   gint lines_per_thread;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6438,6 +6775,79 @@ convert_I420_pack_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
   convert_fill_border (convert, dest);
 }
 
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+static void
+convert_NV12_RGB32_task (FConvertTask * task)
+{
+  const VideoConverterKernels *kernels = video_converter_get_kernels ();
+  GstVideoFormat format = GST_VIDEO_FRAME_FORMAT (task->dest);
+  gboolean swap_rb = format == GST_VIDEO_FORMAT_RGBA
+      || format == GST_VIDEO_FORMAT_RGBx;
+  gint16 coef[5];
+  gint i;
+
+  KERNEL_COEF (coef, task->data);
+
+  for (i = task->height_0; i < task->height_1; i++) {
+    guint8 *sy, *suv, *d;
+
+    d = FRAME_GET_LINE (task->dest, i + task->out_y);
+    d += (task->out_x * 4);
+    sy = FRAME_GET_Y_LINE (task->src, i + task->in_y);
+    sy += task->in_x;
+    suv = FRAME_GET_PLANE_LINE (task->src, 1, (i + task->in_y) >> 1);
+    suv += (task->in_x >> 1) * 2;
+
+    kernels->NV12_to_RGB32 (d, sy, suv, coef, task->width, swap_rb);
+  }
+}
+
+static void
+convert_NV12_RGB32 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  int i;
+  gint width = convert->in_width;
+  gint height = convert->in_height;
+  MatrixData *data = &convert->convert_matrix;
+  FConvertTask *tasks;
+  FConvertTask **tasks_p;
+  gint n_threads;
+  gint lines_per_thread;
+
+  n_threads = convert->conversion_runner->n_tasks;
+  tasks = convert->tasks[0] =
+      g_renew (FConvertTask, convert->tasks[0], n_threads);
+  tasks_p = convert->tasks_p[0] =
+      g_renew (FConvertTask *, convert->tasks_p[0], n_threads);
+
+  lines_per_thread = (height + n_threads - 1) / n_threads;
+
+  for (i = 0; i < n_threads; i++) {
+    tasks[i].src = src;
+    tasks[i].dest = dest;
+
+    tasks[i].width = width;
+    tasks[i].data = data;
+    tasks[i].in_x = convert->in_x;
+    tasks[i].in_y = convert->in_y;
+    tasks[i].out_x = convert->out_x;
+    tasks[i].out_y = convert->out_y;
+
+    tasks[i].height_0 = i * lines_per_thread;
+    tasks[i].height_1 = tasks[i].height_0 + lines_per_thread;
+    tasks[i].height_1 = MIN (height, tasks[i].height_1);
+
+    tasks_p[i] = &tasks[i];
+  }
+
+  gst_parallelized_task_runner_run (convert->conversion_runner,
+      (GstParallelizedTaskFunc) convert_NV12_RGB32_task, (gpointer) tasks_p);
+
+  convert_fill_border (convert, dest);
+}
+#endif
+
 static void
 convert_A420_pack_ARGB_task (FConvertTask * task)
 {
@@ -6495,7 +6905,7 @@ convert_A420_pack_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
   gint n_threads;
   gint lines_per_thread;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6575,7 +6985,7 @@ convert_A420_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
   gint n_threads;
   gint lines_per_thread;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6785,7 +7195,7 @@ convert_plane_fill (GstVideoConverter * convert,
   d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane]);
   d += convert->fout_x[plane];
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -6833,7 +7243,7 @@ convert_plane_h_double (GstVideoConverter * convert,
   d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane]);
   d += convert->fout_x[plane];
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -6884,7 +7294,7 @@ convert_plane_h_halve (GstVideoConverter * convert,
   d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane]);
   d += convert->fout_x[plane];
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -6937,7 +7347,7 @@ convert_plane_v_double (GstVideoConverter * convert,
   d2 += convert->fout_x[plane];
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -6996,7 +7406,7 @@ convert_plane_v_halve (GstVideoConverter * convert,
   ss = FRAME_GET_PLANE_STRIDE (src, splane);
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -7051,7 +7461,7 @@ convert_plane_hv_double (GstVideoConverter * convert,
   ss = FRAME_GET_PLANE_STRIDE (src, splane);
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -7109,7 +7519,7 @@ convert_plane_hv_halve (GstVideoConverter * convert,
   ss = FRAME_GET_PLANE_STRIDE (src, splane);
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -7183,7 +7593,7 @@ convert_plane_hv (GstVideoConverter * convert,
   sstride = FRAME_GET_PLANE_STRIDE (src, splane);
   dstride = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->conversion_runner->n_tasks;
   tasks = convert->tasks[plane] =
       g_renew (FScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -7420,7 +7830,7 @@ setup_scale (GstVideoConverter * convert)
   const GstVideoFormatInfo *in_finfo, *out_finfo;
   GstVideoFormat in_format, out_format;
   gboolean interlaced;
-  guint n_threads = convert->conversion_runner->n_threads;
+  guint n_threads = convert->conversion_runner->n_tasks;
 
   in_info = &convert->in_info;
   out_info = &convert->out_info;
@@ -7743,6 +8153,10 @@ static const VideoTransform transforms[] = {
       FALSE, FALSE, TRUE, FALSE, 0, 0, convert_I420_AYUV},
   {GST_VIDEO_FORMAT_YV12, GST_VIDEO_FORMAT_v210, TRUE, FALSE, TRUE, FALSE,
       FALSE, FALSE, FALSE, FALSE, 0, 0, convert_I420_v210},
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+  {GST_VIDEO_FORMAT_I422_10LE, GST_VIDEO_FORMAT_v210, TRUE, FALSE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, FALSE, 0, 0, convert_I422_10LE_v210},
+#endif
 
   {GST_VIDEO_FORMAT_Y42B, GST_VIDEO_FORMAT_YUY2, TRUE, FALSE, TRUE, TRUE,
       TRUE, FALSE, FALSE, FALSE, 0, 0, convert_Y42B_YUY2},
@@ -7827,6 +8241,10 @@ static const VideoTransform transforms[] = {
       FALSE, FALSE, FALSE, FALSE, 0, 0, convert_v210_I420},
   {GST_VIDEO_FORMAT_v210, GST_VIDEO_FORMAT_Y42B, TRUE, FALSE, TRUE, FALSE,
       FALSE, FALSE, FALSE, FALSE, 0, 0, convert_v210_Y42B},
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+  {GST_VIDEO_FORMAT_v210, GST_VIDEO_FORMAT_I422_10LE, TRUE, FALSE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, FALSE, 0, 0, convert_v210_I422_10LE},
+#endif
 
   /* planar -> planar */
   {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_I420, TRUE, FALSE, FALSE, TRUE,
@@ -8001,6 +8419,9 @@ static const VideoTransform transforms[] = {
       TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
 
   /* sempiplanar -> semiplanar */
+  {GST_VIDEO_FORMAT_P010_10LE, GST_VIDEO_FORMAT_NV12, TRUE, FALSE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, FALSE, 0, 0, convert_P010_NV12},
+
   {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_NV12, TRUE, FALSE, FALSE, TRUE,
       TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
   {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_NV16, TRUE, FALSE, FALSE, TRUE,
@@ -8028,6 +8449,16 @@ static const VideoTransform transforms[] = {
   {GST_VIDEO_FORMAT_NV24, GST_VIDEO_FORMAT_NV24, TRUE, FALSE, FALSE, TRUE,
       TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
 
+  /* semiplanar <-> planar */
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_I420, TRUE, FALSE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_I420},
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_YV12, TRUE, FALSE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_I420},
+  {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_NV12, TRUE, FALSE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_I420_NV12},
+  {GST_VIDEO_FORMAT_YV12, GST_VIDEO_FORMAT_NV12, TRUE, FALSE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_I420_NV12},
+
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
   {GST_VIDEO_FORMAT_AYUV, GST_VIDEO_FORMAT_ARGB, TRUE, TRUE, TRUE, TRUE, TRUE,
       TRUE, FALSE, FALSE, 0, 0, convert_AYUV_ARGB},
@@ -8056,6 +8487,17 @@ static const VideoTransform transforms[] = {
   {GST_VIDEO_FORMAT_YV12, GST_VIDEO_FORMAT_BGRx, FALSE, TRUE, TRUE, TRUE,
       TRUE, FALSE, FALSE, FALSE, 0, 0, convert_I420_BGRA},
 
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_BGRA, FALSE, TRUE, TRUE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_RGB32},
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_BGRx, FALSE, TRUE, TRUE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_RGB32},
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_RGBA, FALSE, TRUE, TRUE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_RGB32},
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_RGBx, FALSE, TRUE, TRUE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_RGB32},
+#endif
+
   {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_ARGB, FALSE, TRUE, TRUE, TRUE,
       TRUE, FALSE, FALSE, FALSE, 0, 0, convert_I420_ARGB},
   {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_xRGB, FALSE, TRUE, TRUE, TRUE,
@@ -8280,8 +8722,8 @@ video_converter_lookup_fastpath (GstVideoConverter * convert)
       convert->convert = transforms[i].convert;
 
       convert->tmpline =
-          g_new (guint16 *, convert->conversion_runner->n_threads);
-      for (j = 0; j < convert->conversion_runner->n_threads; j++)
+          g_new (guint16 *, convert->conversion_runner->n_tasks);
+      for (j = 0; j < convert->conversion_runner->n_tasks; j++)
         convert->tmpline[j] = g_malloc0 (sizeof (guint16) * (width + 8) * 4);
 
       if (!transforms[i].keeps_size)
@@ -269,7 +269,8 @@ typedef enum {
  * GST_VIDEO_CONVERTER_OPT_THREADS:
  *
  * #G_TYPE_UINT, maximum number of threads to use. Default 1, 0 for the number
- * of cores.
+ * of cores. The frames are split in tiles of lines that the threads process,
+ * small frames may use fewer threads.
  */
 #define GST_VIDEO_CONVERTER_OPT_THREADS   "GstVideoConverter.threads"
 
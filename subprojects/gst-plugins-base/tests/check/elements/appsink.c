@@ -1173,6 +1173,215 @@ GST_START_TEST (test_query_allocation_signals)
 
 GST_END_TEST;
 
+GST_START_TEST (test_try_pull_samples)
+{
+  GstElement *sink;
+  GstSegment segment;
+  GstBufferList *list;
+  GstSample *s;
+  gint i;
+
+  sink = setup_appsink ();
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  for (i = 0; i < 5; i++)
+    fail_unless (gst_pad_push (mysrcpad, gst_buffer_new_and_alloc (i + 1)) ==
+        GST_FLOW_OK);
+
+  /* at most 3 of the 5 queued buffers */
+  s = gst_app_sink_try_pull_samples (GST_APP_SINK (sink), 3, 0);
+  fail_unless (s != NULL);
+  fail_unless (gst_sample_get_buffer (s) == NULL);
+  list = gst_sample_get_buffer_list (s);
+  fail_unless_equals_int (gst_buffer_list_length (list), 3);
+  for (i = 0; i < 3; i++)
+    fail_unless_equals_int (gst_buffer_get_size (gst_buffer_list_get (list,
+                i)), i + 1);
+  gst_sample_unref (s);
+
+  /* all the remaining ones */
+  g_signal_emit_by_name (sink, "try-pull-samples", 0, (GstClockTime) 0, &s);
+  fail_unless (s != NULL);
+  list = gst_sample_get_buffer_list (s);
+  fail_unless_equals_int (gst_buffer_list_length (list), 2);
+  fail_unless_equals_int (gst_buffer_get_size (gst_buffer_list_get (list, 0)),
+      4);
+  gst_sample_unref (s);
+
+  s = gst_app_sink_try_pull_samples (GST_APP_SINK (sink), 0, 0);
+  fail_unless (s == NULL);
+
+  /* a segment change ends the list */
+  fail_unless (gst_pad_push (mysrcpad, gst_buffer_new_and_alloc (1)) ==
+      GST_FLOW_OK);
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  segment.start = 2 * GST_SECOND;
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+  fail_unless (gst_pad_push (mysrcpad, gst_buffer_new_and_alloc (2)) ==
+      GST_FLOW_OK);
+
+  s = gst_app_sink_try_pull_samples (GST_APP_SINK (sink), 0, 0);
+  fail_unless (s != NULL);
+  fail_unless_equals_int (gst_buffer_list_length (gst_sample_get_buffer_list
+          (s)), 1);
+  fail_if (gst_segment_is_equal (&segment, gst_sample_get_segment (s)));
+  gst_sample_unref (s);
+
+  s = gst_app_sink_try_pull_samples (GST_APP_SINK (sink), 0, 0);
+  fail_unless (s != NULL);
+  list = gst_sample_get_buffer_list (s);
+  fail_unless_equals_int (gst_buffer_list_length (list), 1);
+  fail_unless_equals_int (gst_buffer_get_size (gst_buffer_list_get (list, 0)),
+      2);
+  fail_unless (gst_segment_is_equal (&segment, gst_sample_get_segment (s)));
+  gst_sample_unref (s);
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_appsink (sink);
+}
+
+GST_END_TEST;
+
+static guint
+count_proposed_pools (GstPad * sinkpad, GstCaps * caps)
+{
+  GstQuery *query;
+  guint n_pools;
+
+  query = gst_query_new_allocation (caps, TRUE);
+  gst_pad_query (sinkpad, query);
+  n_pools = gst_query_get_n_allocation_pools (query);
+  gst_query_unref (query);
+
+  return n_pools;
+}
+
+/* Verifies that the pool lent by the application is proposed upstream, only
+ * when it is configured for the caps of the query */
+GST_START_TEST (test_query_allocation_pool)
+{
+  GstElement *sink;
+  GstBufferPool *pool, *proposed;
+  GstStructure *config;
+  GstCaps *caps, *other_caps;
+  GstQuery *query;
+  GstPad *sinkpad;
+  guint size, min, max;
+
+  sink = setup_appsink ();
+  sinkpad = gst_element_get_static_pad (sink, "sink");
+  fail_unless (sinkpad);
+
+  caps = gst_caps_new_empty_simple ("application/x-gst-check");
+  other_caps = gst_caps_new_simple ("application/x-gst-check",
+      "width", G_TYPE_INT, 2, NULL);
+
+  /* not configured yet, it has no size */
+  pool = gst_buffer_pool_new ();
+  g_object_set (sink, "buffer-pool", pool, NULL);
+  proposed = gst_app_sink_get_buffer_pool (GST_APP_SINK (sink));
+  fail_unless (proposed == pool);
+  gst_object_unref (proposed);
+  fail_unless_equals_int (count_proposed_pools (sinkpad, caps), 0);
+
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, caps, 64, 2, 0);
+  fail_unless (gst_buffer_pool_set_config (pool, config));
+
+  /* configured for other caps */
+  fail_unless_equals_int (count_proposed_pools (sinkpad, other_caps), 0);
+  fail_unless_equals_int (count_proposed_pools (sinkpad, NULL), 0);
+
+  query = gst_query_new_allocation (caps, TRUE);
+  fail_unless (gst_pad_query (sinkpad, query));
+
+  fail_unless_equals_int (gst_query_get_n_allocation_pools (query), 1);
+  gst_query_parse_nth_allocation_pool (query, 0, &proposed, &size, &min, &max);
+  fail_unless (proposed == pool);
+  fail_unless_equals_int (size, 64);
+  fail_unless_equals_int (min, 2);
+  fail_unless_equals_int (max, 0);
+  gst_object_unref (proposed);
+  gst_query_unref (query);
+
+  gst_app_sink_set_buffer_pool (GST_APP_SINK (sink), NULL);
+  fail_unless_equals_int (count_proposed_pools (sinkpad, caps), 0);
+
+  gst_caps_unref (caps);
+  gst_caps_unref (other_caps);
+  gst_object_unref (sinkpad);
+  gst_object_unref (pool);
+  cleanup_appsink (sink);
+}
+
+GST_END_TEST;
+
+#define POOL_BATCH 4
+#define POOL_BUFFERS (3 * POOL_BATCH)
+
+static gpointer
+push_pool_buffers (gpointer data)
+{
+  GstBufferPool *pool = data;
+  GstBuffer *buffer;
+  gint i;
+
+  for (i = 0; i < POOL_BUFFERS; i++) {
+    fail_unless_equals_int (gst_buffer_pool_acquire_buffer (pool, &buffer,
+            NULL), GST_FLOW_OK);
+    fail_unless_equals_int (gst_pad_push (mysrcpad, buffer), GST_FLOW_OK);
+  }
+
+  return NULL;
+}
+
+/* The pulled samples hold the only references to the buffers, so a pool with
+ * as many buffers as a batch is enough to pull several batches */
+GST_START_TEST (test_try_pull_samples_pool)
+{
+  GstElement *sink;
+  GstBufferPool *pool;
+  GstStructure *config;
+  GThread *thread;
+  GstSample *s;
+  guint n, pulled = 0;
+
+  sink = setup_appsink ();
+  /* the last sample would keep one buffer */
+  g_object_set (sink, "enable-last-sample", FALSE, NULL);
+
+  pool = gst_buffer_pool_new ();
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, NULL, 64, 0, POOL_BATCH);
+  fail_unless (gst_buffer_pool_set_config (pool, config));
+  fail_unless (gst_buffer_pool_set_active (pool, TRUE));
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  thread = g_thread_new ("push-pool-buffers", push_pool_buffers, pool);
+
+  while (pulled < POOL_BUFFERS) {
+    s = gst_app_sink_try_pull_samples (GST_APP_SINK (sink), POOL_BATCH,
+        5 * GST_SECOND);
+    fail_unless (s != NULL, "nothing to pull after %u buffers", pulled);
+    n = gst_buffer_list_length (gst_sample_get_buffer_list (s));
+    fail_unless (n > 0 && n <= POOL_BATCH);
+    pulled += n;
+    gst_sample_unref (s);
+  }
+  fail_unless_equals_int (pulled, POOL_BUFFERS);
+
+  g_thread_join (thread);
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  fail_unless (gst_buffer_pool_set_active (pool, FALSE));
+  gst_object_unref (pool);
+  cleanup_appsink (sink);
+}
+
+GST_END_TEST;
+
 struct TestBufferingLimitsParams
 {
   guint64 max_time;
@@ -1270,6 +1479,9 @@ appsink_suite (void)
   tcase_add_test (tc_chain, test_caps_before_flush_race_condition);
   tcase_add_test (tc_chain, test_query_allocation_callback);
   tcase_add_test (tc_chain, test_query_allocation_signals);
+  tcase_add_test (tc_chain, test_try_pull_samples);
+  tcase_add_test (tc_chain, test_query_allocation_pool);
+  tcase_add_test (tc_chain, test_try_pull_samples_pool);
   tcase_add_loop_test (tc_chain, test_buffering_limits, 0,
       G_N_ELEMENTS (test_buffering_limit_params) * 2);
 
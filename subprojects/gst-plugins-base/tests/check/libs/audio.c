@@ -1678,6 +1678,222 @@ GST_START_TEST (test_audio_meta_serialize_65_chans)
 
 GST_END_TEST;
 
+#define MIX_CHANNELS 64
+#define MIX_FRAMES 4096
+
+/* the index of a sample in a buffer of MIX_CHANNELS channels */
+static gsize
+mix_sample_index (GstAudioLayout layout, gint channel, gint frame,
+    gint n_frames)
+{
+  if (layout == GST_AUDIO_LAYOUT_INTERLEAVED)
+    return frame * MIX_CHANNELS + channel;
+  return channel * n_frames + frame;
+}
+
+/* the S32 result of mixing channel @c with the next one, as the integer
+ * mixer computes it */
+static gint32
+mix_reference (const gint32 * in, GstAudioLayout layout, gint c, gint f,
+    gint n_frames)
+{
+  gint64 a = in[mix_sample_index (layout, c, f, n_frames)];
+  gint64 b = in[mix_sample_index (layout, (c + 1) % MIX_CHANNELS, f,
+          n_frames)];
+
+  /* 0.5 and 0.25 with 10 bits of precision */
+  return CLAMP ((a * 512 + b * 256 + 512) >> 10, G_MININT32, G_MAXINT32);
+}
+
+static GstAudioConverter *
+make_mix_converter (GstAudioLayout in_layout, GstAudioFormat out_format,
+    GstAudioLayout out_layout, guint threads, gboolean route)
+{
+  GstAudioInfo in_info, out_info;
+  GstStructure *config;
+  GValue matrix = G_VALUE_INIT;
+  gint i, j;
+
+  gst_audio_info_set_format (&in_info, GST_AUDIO_FORMAT_S32, 48000,
+      MIX_CHANNELS, NULL);
+  in_info.layout = in_layout;
+  gst_audio_info_set_format (&out_info, out_format, 48000, MIX_CHANNELS,
+      NULL);
+  out_info.layout = out_layout;
+
+  /* either reverse the channels or mix each channel with the next one */
+  g_value_init (&matrix, GST_TYPE_ARRAY);
+  for (j = 0; j < MIX_CHANNELS; j++) {
+    GValue row = G_VALUE_INIT;
+
+    g_value_init (&row, GST_TYPE_ARRAY);
+    for (i = 0; i < MIX_CHANNELS; i++) {
+      GValue v = G_VALUE_INIT;
+
+      g_value_init (&v, G_TYPE_FLOAT);
+      if (route)
+        g_value_set_float (&v, i == MIX_CHANNELS - 1 - j ? 1.0 : 0.0);
+      else if (i == j)
+        g_value_set_float (&v, 0.5);
+      else if (i == (j + 1) % MIX_CHANNELS)
+        g_value_set_float (&v, 0.25);
+      else
+        g_value_set_float (&v, 0.0);
+      gst_value_array_append_value (&row, &v);
+      g_value_unset (&v);
+    }
+    gst_value_array_append_value (&matrix, &row);
+    g_value_unset (&row);
+  }
+
+  /* no dither, so that the quantized samples are known */
+  config = gst_structure_new ("GstAudioConverter",
+      GST_AUDIO_CONVERTER_OPT_THREADS, G_TYPE_UINT, threads,
+      GST_AUDIO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_AUDIO_DITHER_METHOD,
+      GST_AUDIO_DITHER_NONE,
+      GST_AUDIO_CONVERTER_OPT_NOISE_SHAPING_METHOD,
+      GST_TYPE_AUDIO_NOISE_SHAPING_METHOD, GST_AUDIO_NOISE_SHAPING_NONE,
+      NULL);
+  gst_structure_set_value (config, GST_AUDIO_CONVERTER_OPT_MIX_MATRIX,
+      &matrix);
+  g_value_unset (&matrix);
+
+  return gst_audio_converter_new (0, &in_info, &out_info, config);
+}
+
+static void
+mix_samples (GstAudioLayout in_layout, GstAudioLayout out_layout,
+    guint threads, gboolean route, const gint32 * in_data, gint32 * out_data)
+{
+  GstAudioConverter *convert;
+  gpointer in[MIX_CHANNELS], out[MIX_CHANNELS];
+  gint i;
+
+  for (i = 0; i < MIX_CHANNELS; i++) {
+    in[i] = (gpointer) (in_data + i * MIX_FRAMES);
+    out[i] = out_data + i * MIX_FRAMES;
+  }
+
+  convert = make_mix_converter (in_layout, GST_AUDIO_FORMAT_S32, out_layout,
+      threads, route);
+  fail_unless (convert != NULL);
+  fail_if (gst_audio_converter_is_passthrough (convert));
+  fail_unless (gst_audio_converter_samples (convert, 0, in, MIX_FRAMES, out,
+          MIX_FRAMES));
+  gst_audio_converter_free (convert);
+}
+
+GST_START_TEST (test_audio_converter_mix_threads)
+{
+  GstAudioLayout layouts[] = { GST_AUDIO_LAYOUT_INTERLEAVED,
+    GST_AUDIO_LAYOUT_NON_INTERLEAVED
+  };
+  gsize n_samples = MIX_CHANNELS * MIX_FRAMES;
+  gint32 *in, *out, *out_threads;
+  gint i, j, k, c, f;
+  gboolean route;
+
+  in = g_new (gint32, n_samples);
+  out = g_new (gint32, n_samples);
+  out_threads = g_new (gint32, n_samples);
+
+  for (k = 0; k < n_samples; k++)
+    in[k] = (k * 2654435761u) >> 1;
+
+  for (route = FALSE; route <= TRUE; route++) {
+    for (i = 0; i < G_N_ELEMENTS (layouts); i++) {
+      for (j = 0; j < G_N_ELEMENTS (layouts); j++) {
+        mix_samples (layouts[i], layouts[j], 1, route, in, out);
+        mix_samples (layouts[i], layouts[j], 4, route, in, out_threads);
+
+        fail_unless (memcmp (out, out_threads, n_samples * 4) == 0,
+            "threads changed the result, route %d, layouts %d %d", route, i,
+            j);
+
+        for (c = 0; c < MIX_CHANNELS; c++) {
+          for (f = 0; f < MIX_FRAMES; f++) {
+            gint32 expected;
+
+            if (route)
+              expected = in[mix_sample_index (layouts[i],
+                      MIX_CHANNELS - 1 - c, f, MIX_FRAMES)];
+            else
+              expected = mix_reference (in, layouts[i], c, f, MIX_FRAMES);
+
+            fail_unless_equals_int (out[mix_sample_index (layouts[j], c, f,
+                        MIX_FRAMES)], expected);
+          }
+        }
+      }
+    }
+  }
+
+  g_free (in);
+  g_free (out);
+  g_free (out_threads);
+}
+
+GST_END_TEST;
+
+/* an odd number of frames, so that the planes of the temporary buffers are
+ * not contiguous */
+#define QUANTIZE_FRAMES 1001
+
+/* without resampler the mixer also changes the layout, the quantization after
+ * it must use the new layout */
+GST_START_TEST (test_audio_converter_mix_quantize)
+{
+  GstAudioLayout layouts[] = { GST_AUDIO_LAYOUT_INTERLEAVED,
+    GST_AUDIO_LAYOUT_NON_INTERLEAVED
+  };
+  gsize n_samples = MIX_CHANNELS * QUANTIZE_FRAMES;
+  gpointer in[MIX_CHANNELS], out[MIX_CHANNELS];
+  GstAudioConverter *convert;
+  gint32 *in_data;
+  gint16 *out_data;
+  gint i, j, c, f;
+
+  in_data = g_new (gint32, n_samples);
+  out_data = g_new (gint16, n_samples);
+
+  for (i = 0; i < n_samples; i++)
+    in_data[i] = (i * 2654435761u) >> 1;
+
+  for (c = 0; c < MIX_CHANNELS; c++) {
+    in[c] = in_data + c * QUANTIZE_FRAMES;
+    out[c] = out_data + c * QUANTIZE_FRAMES;
+  }
+
+  for (i = 0; i < G_N_ELEMENTS (layouts); i++) {
+    for (j = 0; j < G_N_ELEMENTS (layouts); j++) {
+      convert = make_mix_converter (layouts[i], GST_AUDIO_FORMAT_S16,
+          layouts[j], 1, FALSE);
+      fail_unless (convert != NULL);
+      memset (out_data, 0, n_samples * sizeof (gint16));
+      fail_unless (gst_audio_converter_samples (convert, 0, in,
+              QUANTIZE_FRAMES, out, QUANTIZE_FRAMES));
+      gst_audio_converter_free (convert);
+
+      for (c = 0; c < MIX_CHANNELS; c++) {
+        for (f = 0; f < QUANTIZE_FRAMES; f++) {
+          gint64 v = mix_reference (in_data, layouts[i], c, f,
+              QUANTIZE_FRAMES);
+          /* rounded to the upper 16 bits */
+          gint16 expected = CLAMP (v + 32768, G_MININT32, G_MAXINT32) >> 16;
+
+          fail_unless_equals_int (out_data[mix_sample_index (layouts[j], c, f,
+                      QUANTIZE_FRAMES)], expected);
+        }
+      }
+    }
+  }
+
+  g_free (in_data);
+  g_free (out_data);
+}
+
+GST_END_TEST;
+
 static Suite *
 audio_suite (void)
 {
@@ -1718,6 +1934,8 @@ audio_suite (void)
   tcase_add_test (tc_chain, test_audio_make_raw_caps);
   tcase_add_test (tc_chain, test_audio_meta_serialize);
   tcase_add_test (tc_chain, test_audio_meta_serialize_65_chans);
+  tcase_add_test (tc_chain, test_audio_converter_mix_threads);
+  tcase_add_test (tc_chain, test_audio_converter_mix_quantize);
 
   return s;
 }
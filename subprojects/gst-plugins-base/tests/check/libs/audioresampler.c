@@ -0,0 +1,284 @@
+/* GStreamer
+ *
+ * unit tests for the vectorized audio resampler kernels
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* the kernel tables are private to the resampler, use our own copy of it so
+ * that we can switch between the C and the vectorized kernels */
+#include "../../../gst-libs/gst/audio/audio-resampler.c"
+#undef GST_CAT_DEFAULT
+
+#include <gst/check/gstcheck.h>
+
+#define IN_RATE 44100
+#define OUT_RATE 48000
+#define CHANNELS 2
+#define IN_FRAMES 4099
+
+/* the integer kernels round like the C versions, the float kernels sum in
+ * another order and use FMA */
+#define TOLERANCE_S16 1.0
+#define TOLERANCE_S32 1.0
+#define TOLERANCE_F32 1e-5
+#define TOLERANCE_F64 1e-12
+
+static ResampleFunc c_resample_funcs[G_N_ELEMENTS (resample_funcs)];
+static InterpolateFunc c_interpolate_funcs[G_N_ELEMENTS (interpolate_funcs)];
+
+static void
+use_c_kernels (void)
+{
+  memcpy (resample_funcs, c_resample_funcs, sizeof (resample_funcs));
+  memcpy (interpolate_funcs, c_interpolate_funcs, sizeof (interpolate_funcs));
+}
+
+#define USE_KERNELS(arch) G_STMT_START {                                \
+  use_c_kernels ();                                                     \
+  resample_gint16_full_1 = resample_gint16_full_1_ ##arch;              \
+  resample_gint16_linear_1 = resample_gint16_linear_1_ ##arch;          \
+  resample_gint16_cubic_1 = resample_gint16_cubic_1_ ##arch;            \
+  resample_gint32_full_1 = resample_gint32_full_1_ ##arch;              \
+  resample_gint32_linear_1 = resample_gint32_linear_1_ ##arch;          \
+  resample_gint32_cubic_1 = resample_gint32_cubic_1_ ##arch;            \
+  resample_gfloat_full_1 = resample_gfloat_full_1_ ##arch;              \
+  resample_gfloat_linear_1 = resample_gfloat_linear_1_ ##arch;          \
+  resample_gfloat_cubic_1 = resample_gfloat_cubic_1_ ##arch;            \
+  resample_gdouble_full_1 = resample_gdouble_full_1_ ##arch;            \
+  resample_gdouble_linear_1 = resample_gdouble_linear_1_ ##arch;        \
+  resample_gdouble_cubic_1 = resample_gdouble_cubic_1_ ##arch;          \
+  interpolate_gint16_linear = interpolate_gint16_linear_ ##arch;        \
+  interpolate_gint16_cubic = interpolate_gint16_cubic_ ##arch;          \
+  interpolate_gint32_linear = interpolate_gint32_linear_ ##arch;        \
+  interpolate_gint32_cubic = interpolate_gint32_cubic_ ##arch;          \
+  interpolate_gfloat_linear = interpolate_gfloat_linear_ ##arch;        \
+  interpolate_gfloat_cubic = interpolate_gfloat_cubic_ ##arch;          \
+  interpolate_gdouble_linear = interpolate_gdouble_linear_ ##arch;      \
+  interpolate_gdouble_cubic = interpolate_gdouble_cubic_ ##arch;        \
+} G_STMT_END
+
+static gdouble
+get_sample (GstAudioFormat format, gconstpointer data, gsize i)
+{
+  switch (format) {
+    case GST_AUDIO_FORMAT_S16:
+      return ((const gint16 *) data)[i];
+    case GST_AUDIO_FORMAT_S32:
+      return ((const gint32 *) data)[i];
+    case GST_AUDIO_FORMAT_F32:
+      return ((const gfloat *) data)[i];
+    case GST_AUDIO_FORMAT_F64:
+      return ((const gdouble *) data)[i];
+    default:
+      g_assert_not_reached ();
+      return 0.0;
+  }
+}
+
+static gpointer
+make_input (GstAudioFormat format, gsize samples)
+{
+  GRand *rand = g_rand_new_with_seed (0x4a75);
+  gpointer data;
+  gsize i;
+
+  data = g_malloc (samples * 8);
+  for (i = 0; i < samples; i++) {
+    /* half of the full scale, so that the taps don't make it clip */
+    gdouble v = g_rand_double_range (rand, -0.5, 0.5);
+
+    switch (format) {
+      case GST_AUDIO_FORMAT_S16:
+        ((gint16 *) data)[i] = v * G_MAXINT16;
+        break;
+      case GST_AUDIO_FORMAT_S32:
+        ((gint32 *) data)[i] = v * G_MAXINT32;
+        break;
+      case GST_AUDIO_FORMAT_F32:
+        ((gfloat *) data)[i] = v;
+        break;
+      case GST_AUDIO_FORMAT_F64:
+        ((gdouble *) data)[i] = v;
+        break;
+      default:
+        g_assert_not_reached ();
+        break;
+    }
+  }
+  g_rand_free (rand);
+
+  return data;
+}
+
+static gpointer
+run_resampler (GstAudioFormat format, GstStructure * options, gpointer in,
+    gsize * out_frames)
+{
+  GstAudioResampler *resampler;
+  gpointer out;
+
+  resampler = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      GST_AUDIO_RESAMPLER_FLAG_NONE, format, CHANNELS, IN_RATE, OUT_RATE,
+      options);
+  fail_unless (resampler != NULL);
+
+  *out_frames = gst_audio_resampler_get_out_frames (resampler, IN_FRAMES);
+  out = g_malloc0 (*out_frames * CHANNELS * 8);
+  gst_audio_resampler_resample (resampler, &in, IN_FRAMES, &out, *out_frames);
+  gst_audio_resampler_free (resampler);
+
+  return out;
+}
+
+static void
+compare_kernels (const gchar * name, GstAudioFormat format,
+    GstAudioResamplerFilterMode mode,
+    GstAudioResamplerFilterInterpolation interpolation, gdouble tolerance,
+    void (*use_kernels) (void))
+{
+  GstStructure *options;
+  gpointer in, ref, out;
+  gsize ref_frames, out_frames, i;
+
+  options = gst_structure_new_empty ("GstAudioResampler.options");
+  gst_audio_resampler_options_set_quality (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      GST_AUDIO_RESAMPLER_QUALITY_DEFAULT, IN_RATE, OUT_RATE, options);
+  gst_structure_set (options,
+      GST_AUDIO_RESAMPLER_OPT_FILTER_MODE,
+      GST_TYPE_AUDIO_RESAMPLER_FILTER_MODE, mode,
+      GST_AUDIO_RESAMPLER_OPT_FILTER_INTERPOLATION,
+      GST_TYPE_AUDIO_RESAMPLER_FILTER_INTERPOLATION, interpolation, NULL);
+
+  in = make_input (format, IN_FRAMES * CHANNELS);
+
+  use_c_kernels ();
+  ref = run_resampler (format, options, in, &ref_frames);
+  use_kernels ();
+  out = run_resampler (format, options, in, &out_frames);
+
+  fail_unless_equals_int (out_frames, ref_frames);
+  for (i = 0; i < out_frames * CHANNELS; i++) {
+    gdouble r = get_sample (format, ref, i);
+    gdouble o = get_sample (format, out, i);
+
+    fail_unless (fabs (o - r) <= tolerance,
+        "%s %s, mode %d, interpolation %d: sample %" G_GSIZE_FORMAT
+        " is %g instead of %g", name, gst_audio_format_to_string (format),
+        mode, interpolation, i, o, r);
+  }
+
+  g_free (in);
+  g_free (ref);
+  g_free (out);
+  gst_structure_free (options);
+}
+
+static void
+check_kernels (const gchar * name, void (*use_kernels) (void))
+{
+  static const struct
+  {
+    GstAudioFormat format;
+    gdouble tolerance;
+  } formats[] = {
+    {GST_AUDIO_FORMAT_S16, TOLERANCE_S16},
+    {GST_AUDIO_FORMAT_S32, TOLERANCE_S32},
+    {GST_AUDIO_FORMAT_F32, TOLERANCE_F32},
+    {GST_AUDIO_FORMAT_F64, TOLERANCE_F64},
+  };
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    compare_kernels (name, formats[i].format,
+        GST_AUDIO_RESAMPLER_FILTER_MODE_FULL,
+        GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE, formats[i].tolerance,
+        use_kernels);
+    compare_kernels (name, formats[i].format,
+        GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED,
+        GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_LINEAR,
+        formats[i].tolerance, use_kernels);
+    compare_kernels (name, formats[i].format,
+        GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED,
+        GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC,
+        formats[i].tolerance, use_kernels);
+  }
+}
+
+#if defined (CHECK_X86_AVX) && defined (HAVE_IMMINTRIN_H) && HAVE_AVX2
+static void
+use_avx2_kernels (void)
+{
+  USE_KERNELS (avx2);
+}
+#endif
+
+#if defined (CHECK_X86_AVX) && defined (HAVE_IMMINTRIN_H) && HAVE_AVX512
+static void
+use_avx512_kernels (void)
+{
+  USE_KERNELS (avx512);
+}
+#endif
+
+/* the vectorized kernels give the output of the C kernels for all sample
+ * formats and filter modes */
+GST_START_TEST (test_resampler_kernels)
+{
+  gboolean checked = FALSE;
+
+  /* selects the kernels for the CPU, we replace them afterwards */
+  audio_resampler_init ();
+
+#if defined (CHECK_X86_AVX) && defined (HAVE_IMMINTRIN_H) && HAVE_AVX2
+  if (__builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("fma")) {
+    check_kernels ("AVX2", use_avx2_kernels);
+    checked = TRUE;
+  }
+#endif
+#if defined (CHECK_X86_AVX) && defined (HAVE_IMMINTRIN_H) && HAVE_AVX512
+  if (__builtin_cpu_supports ("avx512f")
+      && __builtin_cpu_supports ("avx512bw")) {
+    check_kernels ("AVX-512", use_avx512_kernels);
+    checked = TRUE;
+  }
+#endif
+
+  if (!checked)
+    GST_INFO ("no vectorized kernels for this CPU");
+
+  use_c_kernels ();
+}
+
+GST_END_TEST;
+
+static Suite *
+audioresampler_suite (void)
+{
+  Suite *s = suite_create ("audio resampler kernels");
+  TCase *tc_chain = tcase_create ("general");
+
+  /* the tables still hold the C kernels here */
+  memcpy (c_resample_funcs, resample_funcs, sizeof (resample_funcs));
+  memcpy (c_interpolate_funcs, interpolate_funcs, sizeof (interpolate_funcs));
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_resampler_kernels);
+
+  return s;
+}
+
+GST_CHECK_MAIN (audioresampler);
@@ -34,6 +34,7 @@
 #include <gst/video/video.h>
 #include <gst/video/gstvideometa.h>
 #include <gst/video/video-overlay-composition.h>
+#include <gst/video/video-converter-kernels.h>
 #include <string.h>
 
 /* These are from the current/old videotestsrc; we check our new public API
@@ -2854,7 +2855,7 @@ GST_START_TEST (test_video_convert_multithreading)
   GstVideoInfo ininfo, outinfo;
   GstVideoFrame inframe, outframe, refframe;
   GstBuffer *inbuffer, *outbuffer, *refbuffer;
-  GstVideoConverter *convert;
+  GstVideoConverter *convert, *convert2;
   GstMapInfo info;
   GstTaskPool *pool;
 
@@ -2898,6 +2899,31 @@ GST_START_TEST (test_video_convert_multithreading)
   gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
   gst_video_frame_map (&refframe, &outinfo, refbuffer, GST_MAP_WRITE);
 
+  /* Multithreaded conversion with more tiles than threads, while another
+   * converter shares the same pool */
+  convert = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, 2, NULL)
+      );
+  convert2 = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, 4, NULL)
+      );
+  gst_video_converter_frame (convert2, &inframe, &outframe);
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_converter_free (convert);
+  gst_video_converter_free (convert2);
+
+  gst_video_frame_unmap (&outframe);
+  gst_video_frame_unmap (&refframe);
+
+  gst_buffer_map (outbuffer, &info, GST_MAP_READ);
+  fail_unless (gst_buffer_memcmp (refbuffer, 0, info.data, info.size) == 0);
+  gst_buffer_unmap (outbuffer, &info);
+
+  gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+  gst_video_frame_map (&refframe, &outinfo, refbuffer, GST_MAP_WRITE);
+
   /* Multi-threaded conversion, user-provided pool */
   pool = gst_shared_task_pool_new ();
   gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (pool), 4);
@@ -2927,6 +2953,376 @@ GST_START_TEST (test_video_convert_multithreading)
 
 GST_END_TEST;
 
+static void
+video_convert_roundtrip (GstVideoFormat format, GstVideoFormat tmp_format,
+    gint width, gint height)
+{
+  GstVideoInfo info, tmpinfo;
+  GstVideoFrame inframe, tmpframe, outframe;
+  GstBuffer *inbuffer, *tmpbuffer, *outbuffer;
+  GstVideoConverter *convert;
+  gint i, j, k;
+
+  fail_unless (gst_video_info_set_format (&info, format, width, height));
+  fail_unless (gst_video_info_set_format (&tmpinfo, tmp_format, width,
+          height));
+
+  inbuffer = gst_buffer_new_and_alloc (info.size);
+  gst_buffer_memset (inbuffer, 0, 0, -1);
+  tmpbuffer = gst_buffer_new_and_alloc (tmpinfo.size);
+  outbuffer = gst_buffer_new_and_alloc (info.size);
+  gst_buffer_memset (outbuffer, 0, 0, -1);
+
+  /* random samples, of the depth of the format */
+  gst_video_frame_map (&inframe, &info, inbuffer, GST_MAP_WRITE);
+  for (k = 0; k < GST_VIDEO_FRAME_N_COMPONENTS (&inframe); k++) {
+    gint depth = GST_VIDEO_FRAME_COMP_DEPTH (&inframe, k);
+    gint w = GST_VIDEO_FRAME_COMP_WIDTH (&inframe, k);
+    gint h = GST_VIDEO_FRAME_COMP_HEIGHT (&inframe, k);
+    gint pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (&inframe, k);
+
+    for (i = 0; i < h; i++) {
+      guint8 *line = GST_VIDEO_FRAME_COMP_DATA (&inframe, k) +
+          i * GST_VIDEO_FRAME_COMP_STRIDE (&inframe, k);
+
+      for (j = 0; j < w; j++) {
+        if (depth == 8)
+          line[j * pstride] = g_random_int_range (0, 256);
+        else
+          GST_WRITE_UINT16_LE (line + j * pstride,
+              g_random_int_range (0, 1 << depth));
+      }
+    }
+  }
+  gst_video_frame_unmap (&inframe);
+
+  gst_video_frame_map (&inframe, &info, inbuffer, GST_MAP_READ);
+  gst_video_frame_map (&tmpframe, &tmpinfo, tmpbuffer, GST_MAP_READWRITE);
+  gst_video_frame_map (&outframe, &info, outbuffer, GST_MAP_WRITE);
+
+  convert = gst_video_converter_new (&info, &tmpinfo, NULL);
+  gst_video_converter_frame (convert, &inframe, &tmpframe);
+  gst_video_converter_free (convert);
+
+  convert = gst_video_converter_new (&tmpinfo, &info, NULL);
+  gst_video_converter_frame (convert, &tmpframe, &outframe);
+  gst_video_converter_free (convert);
+
+  for (k = 0; k < GST_VIDEO_FRAME_N_PLANES (&inframe); k++) {
+    gint h = GST_VIDEO_FRAME_COMP_HEIGHT (&inframe, k);
+    gint size = GST_VIDEO_FRAME_COMP_WIDTH (&inframe, k) *
+        GST_VIDEO_FRAME_COMP_PSTRIDE (&inframe, k);
+
+    for (i = 0; i < h; i++) {
+      fail_unless (memcmp ((guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&inframe,
+                  k) + i * GST_VIDEO_FRAME_PLANE_STRIDE (&inframe, k),
+              (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&outframe,
+                  k) + i * GST_VIDEO_FRAME_PLANE_STRIDE (&outframe, k),
+              size) == 0, "%s -> %s -> %s differs in plane %d line %d",
+          gst_video_format_to_string (format),
+          gst_video_format_to_string (tmp_format),
+          gst_video_format_to_string (format), k, i);
+    }
+  }
+
+  gst_video_frame_unmap (&inframe);
+  gst_video_frame_unmap (&tmpframe);
+  gst_video_frame_unmap (&outframe);
+  gst_buffer_unref (inbuffer);
+  gst_buffer_unref (tmpbuffer);
+  gst_buffer_unref (outbuffer);
+}
+
+/* the fast paths between these formats don't lose anything, at widths that
+ * also use the tails of the vectorized kernels */
+GST_START_TEST (test_video_convert_lossless_fastpaths)
+{
+  video_convert_roundtrip (GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_NV12, 1283,
+      27);
+  video_convert_roundtrip (GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_I420, 1283,
+      27);
+  video_convert_roundtrip (GST_VIDEO_FORMAT_I422_10LE, GST_VIDEO_FORMAT_v210,
+      1283, 27);
+  video_convert_roundtrip (GST_VIDEO_FORMAT_I422_10LE, GST_VIDEO_FORMAT_v210,
+      1290, 27);
+}
+
+GST_END_TEST;
+
+static void
+fill_random (guint8 * data, gsize size)
+{
+  gsize i;
+
+  for (i = 0; i < size; i++)
+    data[i] = g_random_int_range (0, 256);
+}
+
+#if defined (HAVE_AVX2) || defined (HAVE_AVX512) || defined (HAVE_NEON)
+#define HAVE_VECTORIZED_KERNELS 1
+
+/* widths around the vector sizes of all kernels */
+static const gint kernel_widths[] = {
+  1, 2, 3, 5, 6, 7, 11, 12, 13, 15, 16, 17, 23, 31, 32, 33, 47, 48, 49, 63,
+  64, 65, 95, 127, 128, 129, 191, 255, 256, 257, 511, 1283
+};
+
+#define KERNEL_MAX_WIDTH 1290
+
+static void
+fill_random_10bit (guint16 * data, gsize n)
+{
+  gsize i;
+
+  for (i = 0; i < n; i++)
+    data[i] = g_random_int_range (0, 1024);
+}
+
+/* the output buffers are compared as a whole, so that writes past the end
+ * of the line are caught as well */
+#define KERNEL_OUT_SIZE (KERNEL_MAX_WIDTH * 4 + 64)
+
+#define check_kernel_output(isa,kernel,width,ref,out)                   \
+  fail_unless (memcmp (ref, out, KERNEL_OUT_SIZE) == 0,                 \
+      "%s %s differs from the C version at width %d", isa, kernel, width)
+
+static void
+check_video_kernels (const gchar * isa, const VideoConverterKernels * kernels)
+{
+  /* coefficients of the BT.601 and BT.709 matrices, and ones that saturate */
+  static const gint16 coefs[][5] = {
+    {9539, 13075, 16525, -3209, -6660},
+    {9539, 14686, 17304, -1747, -4366},
+    {32767, 32767, 32767, -32768, -32768},
+  };
+  guint8 *in0, *in1, *in2, *ref, *out;
+  guint16 *y, *u, *v, *ref16, *out16;
+  gint i, j, width, n;
+
+  in0 = g_malloc (KERNEL_OUT_SIZE);
+  in1 = g_malloc (KERNEL_OUT_SIZE);
+  in2 = g_malloc (KERNEL_OUT_SIZE);
+  ref = g_malloc (KERNEL_OUT_SIZE);
+  out = g_malloc (KERNEL_OUT_SIZE);
+  y = g_new (guint16, KERNEL_MAX_WIDTH);
+  u = g_new (guint16, KERNEL_MAX_WIDTH);
+  v = g_new (guint16, KERNEL_MAX_WIDTH);
+  ref16 = g_malloc (KERNEL_OUT_SIZE);
+  out16 = g_malloc (KERNEL_OUT_SIZE);
+
+  for (i = 0; i < G_N_ELEMENTS (kernel_widths); i++) {
+    width = kernel_widths[i];
+    n = (width + 1) / 2;
+
+    fill_random (in0, KERNEL_OUT_SIZE);
+    fill_random (in1, KERNEL_OUT_SIZE);
+    fill_random (in2, KERNEL_OUT_SIZE);
+
+    if (kernels->deinterleave) {
+      memset (ref, 0xcd, KERNEL_OUT_SIZE);
+      memset (out, 0xcd, KERNEL_OUT_SIZE);
+      video_kernel_deinterleave_c (ref, ref + KERNEL_OUT_SIZE / 2, in0, n);
+      kernels->deinterleave (out, out + KERNEL_OUT_SIZE / 2, in0, n);
+      check_kernel_output (isa, "deinterleave", width, ref, out);
+    }
+
+    if (kernels->interleave) {
+      memset (ref, 0xcd, KERNEL_OUT_SIZE);
+      memset (out, 0xcd, KERNEL_OUT_SIZE);
+      video_kernel_interleave_c (ref, in0, in1, n);
+      kernels->interleave (out, in0, in1, n);
+      check_kernel_output (isa, "interleave", width, ref, out);
+    }
+
+    /* the samples of P010 lines */
+    if (kernels->narrow) {
+      memset (ref, 0xcd, KERNEL_OUT_SIZE);
+      memset (out, 0xcd, KERNEL_OUT_SIZE);
+      video_kernel_narrow_c (ref, in0, width);
+      kernels->narrow (out, in0, width);
+      check_kernel_output (isa, "narrow", width, ref, out);
+    }
+
+    for (j = 0; j < G_N_ELEMENTS (coefs); j++) {
+      gboolean swap_rb = j & 1;
+
+      if (kernels->I420_to_RGB32) {
+        memset (ref, 0xcd, KERNEL_OUT_SIZE);
+        memset (out, 0xcd, KERNEL_OUT_SIZE);
+        video_kernel_I420_to_RGB32_c (ref, in0, in1, in2, coefs[j], 0, width,
+            swap_rb);
+        kernels->I420_to_RGB32 (out, in0, in1, in2, coefs[j], width, swap_rb);
+        check_kernel_output (isa, "I420_to_RGB32", width, ref, out);
+      }
+
+      if (kernels->NV12_to_RGB32) {
+        memset (ref, 0xcd, KERNEL_OUT_SIZE);
+        memset (out, 0xcd, KERNEL_OUT_SIZE);
+        video_kernel_NV12_to_RGB32_c (ref, in0, in1, coefs[j], 0, width,
+            swap_rb);
+        kernels->NV12_to_RGB32 (out, in0, in1, coefs[j], width, swap_rb);
+        check_kernel_output (isa, "NV12_to_RGB32", width, ref, out);
+      }
+    }
+
+    if (kernels->unpack_v210) {
+      memset (ref16, 0xcd, KERNEL_OUT_SIZE);
+      memset (out16, 0xcd, KERNEL_OUT_SIZE);
+      video_kernel_unpack_v210_c (ref16, ref16 + KERNEL_MAX_WIDTH,
+          ref16 + KERNEL_MAX_WIDTH + KERNEL_MAX_WIDTH / 2, in0, 0, width);
+      kernels->unpack_v210 (out16, out16 + KERNEL_MAX_WIDTH,
+          out16 + KERNEL_MAX_WIDTH + KERNEL_MAX_WIDTH / 2, in0, width);
+      check_kernel_output (isa, "unpack_v210", width, ref16, out16);
+    }
+
+    if (kernels->pack_v210) {
+      fill_random_10bit (y, KERNEL_MAX_WIDTH);
+      fill_random_10bit (u, KERNEL_MAX_WIDTH);
+      fill_random_10bit (v, KERNEL_MAX_WIDTH);
+      memset (ref, 0xcd, KERNEL_OUT_SIZE);
+      memset (out, 0xcd, KERNEL_OUT_SIZE);
+      video_kernel_pack_v210_c (ref, y, u, v, 0, width);
+      kernels->pack_v210 (out, y, u, v, width);
+      check_kernel_output (isa, "pack_v210", width, ref, out);
+    }
+  }
+
+  g_free (in0);
+  g_free (in1);
+  g_free (in2);
+  g_free (ref);
+  g_free (out);
+  g_free (y);
+  g_free (u);
+  g_free (v);
+  g_free (ref16);
+  g_free (out16);
+}
+#endif
+
+/* the vectorized kernels give exactly the results of the C reference
+ * versions, also for the pixels at the end of a line that don't fill a whole
+ * vector */
+GST_START_TEST (test_video_convert_kernels)
+{
+#ifdef HAVE_VECTORIZED_KERNELS
+  VideoConverterKernels kernels;
+#endif
+  gboolean checked = FALSE;
+
+#if defined (HAVE_AVX2)
+  if (__builtin_cpu_supports ("avx2")) {
+    memset (&kernels, 0, sizeof (kernels));
+    kernels.deinterleave = video_kernel_deinterleave_avx2;
+    kernels.interleave = video_kernel_interleave_avx2;
+    kernels.narrow = video_kernel_narrow_avx2;
+    kernels.I420_to_RGB32 = video_kernel_I420_to_RGB32_avx2;
+    kernels.NV12_to_RGB32 = video_kernel_NV12_to_RGB32_avx2;
+    kernels.unpack_v210 = video_kernel_unpack_v210_avx2;
+    kernels.pack_v210 = video_kernel_pack_v210_avx2;
+    check_video_kernels ("AVX2", &kernels);
+    checked = TRUE;
+  }
+#endif
+#if defined (HAVE_AVX512)
+  if (__builtin_cpu_supports ("avx512f")
+      && __builtin_cpu_supports ("avx512bw")) {
+    memset (&kernels, 0, sizeof (kernels));
+    kernels.deinterleave = video_kernel_deinterleave_avx512;
+    kernels.interleave = video_kernel_interleave_avx512;
+    kernels.narrow = video_kernel_narrow_avx512;
+    check_video_kernels ("AVX-512", &kernels);
+    checked = TRUE;
+  }
+#endif
+#if defined (HAVE_NEON)
+  memset (&kernels, 0, sizeof (kernels));
+  kernels.deinterleave = video_kernel_deinterleave_neon;
+  kernels.interleave = video_kernel_interleave_neon;
+  kernels.narrow = video_kernel_narrow_neon;
+  kernels.I420_to_RGB32 = video_kernel_I420_to_RGB32_neon;
+  kernels.NV12_to_RGB32 = video_kernel_NV12_to_RGB32_neon;
+  check_video_kernels ("NEON", &kernels);
+  checked = TRUE;
+#endif
+
+  if (!checked)
+    GST_INFO ("no vectorized kernels for this CPU");
+}
+
+GST_END_TEST;
+
+/* the P010_10LE to NV12 fast path keeps the 8 most significant bits, compare
+ * a whole converted frame with the C kernel on each line */
+static void
+video_convert_compare_P010_NV12 (gint width, gint height)
+{
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame inframe, outframe;
+  GstBuffer *inbuffer, *outbuffer;
+  GstVideoConverter *convert;
+  guint8 *ref;
+  gint i, k;
+
+  fail_unless (gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_P010_10LE,
+          width, height));
+  fail_unless (gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_NV12,
+          width, height));
+  /* the same matrix, so that the fast path is used */
+  outinfo.colorimetry = ininfo.colorimetry;
+
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+  gst_buffer_memset (outbuffer, 0, 0, -1);
+
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READWRITE);
+  for (k = 0; k < GST_VIDEO_FRAME_N_PLANES (&inframe); k++) {
+    for (i = 0; i < GST_VIDEO_FRAME_COMP_HEIGHT (&inframe, k); i++) {
+      fill_random ((guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&inframe, k) +
+          i * GST_VIDEO_FRAME_PLANE_STRIDE (&inframe, k),
+          GST_VIDEO_FRAME_PLANE_STRIDE (&inframe, k));
+    }
+  }
+  gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+
+  convert = gst_video_converter_new (&ininfo, &outinfo, NULL);
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_converter_free (convert);
+
+  ref = g_malloc (GST_VIDEO_FRAME_PLANE_STRIDE (&outframe, 0));
+  for (k = 0; k < GST_VIDEO_FRAME_N_PLANES (&outframe); k++) {
+    /* the samples of the line, two per pixel for the chroma plane */
+    gint n = k == 0 ? width : 2 * GST_VIDEO_FRAME_COMP_WIDTH (&outframe, 1);
+
+    for (i = 0; i < GST_VIDEO_FRAME_COMP_HEIGHT (&outframe, k); i++) {
+      video_kernel_narrow_c (ref,
+          (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&inframe, k) +
+          i * GST_VIDEO_FRAME_PLANE_STRIDE (&inframe, k), n);
+      fail_unless (memcmp (ref,
+              (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&outframe, k) +
+              i * GST_VIDEO_FRAME_PLANE_STRIDE (&outframe, k), n) == 0,
+          "P010_10LE -> NV12 %dx%d differs in plane %d line %d", width,
+          height, k, i);
+    }
+  }
+  g_free (ref);
+
+  gst_video_frame_unmap (&inframe);
+  gst_video_frame_unmap (&outframe);
+  gst_buffer_unref (inbuffer);
+  gst_buffer_unref (outbuffer);
+}
+
+GST_START_TEST (test_video_convert_P010_NV12)
+{
+  video_convert_compare_P010_NV12 (1283, 27);
+  video_convert_compare_P010_NV12 (17, 9);
+  video_convert_compare_P010_NV12 (1, 1);
+  video_convert_compare_P010_NV12 (640, 480);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_video_transfer)
 {
   gint i, j;
@@ -4351,6 +4747,9 @@ video_suite (void)
   tcase_add_test (tc_chain, test_video_size_convert);
   tcase_add_test (tc_chain, test_video_convert);
   tcase_add_test (tc_chain, test_video_convert_multithreading);
+  tcase_add_test (tc_chain, test_video_convert_lossless_fastpaths);
+  tcase_add_test (tc_chain, test_video_convert_kernels);
+  tcase_add_test (tc_chain, test_video_convert_P010_NV12);
   tcase_add_test (tc_chain, test_video_transfer);
   tcase_add_test (tc_chain, test_overlay_blend);
   tcase_add_test (tc_chain, test_video_center_rect);
@@ -0,0 +1,214 @@
+/* GStreamer appsrc ! appsink round trip benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Measures the cost per buffer of moving small buffers from the application
+ * through appsrc ! appsink and back to the application: pushing and pulling
+ * the buffers one by one, with newly allocated buffers or with buffers of a
+ * pool of the application, and pushing buffer lists and pulling them in
+ * batches. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <gst/gst.h>
+#include <gst/app/app.h>
+
+#define DEFAULT_NUM_BUFFERS 1000000
+#define DEFAULT_BUFFER_SIZE 64
+#define DEFAULT_BATCH 64
+#define MAX_QUEUED_BUFFERS 4096
+
+typedef struct
+{
+  GstAppSrc *src;
+  GstBufferPool *pool;
+  guint num_buffers;
+  guint size;
+  guint batch;
+} Producer;
+
+static GstBuffer *
+get_buffer (Producer * p)
+{
+  GstBuffer *buf = NULL;
+
+  if (p->pool == NULL)
+    return gst_buffer_new_allocate (NULL, p->size, NULL);
+
+  if (gst_buffer_pool_acquire_buffer (p->pool, &buf, NULL) != GST_FLOW_OK)
+    return NULL;
+
+  return buf;
+}
+
+static gpointer
+produce (gpointer data)
+{
+  Producer *p = data;
+  guint i, j;
+
+  for (i = 0; i < p->num_buffers; i += p->batch) {
+    guint n = MIN (p->batch, p->num_buffers - i);
+    GstFlowReturn ret;
+
+    if (p->batch == 1) {
+      ret = gst_app_src_push_buffer (p->src, get_buffer (p));
+    } else {
+      GstBufferList *list = gst_buffer_list_new_sized (n);
+
+      for (j = 0; j < n; j++)
+        gst_buffer_list_add (list, get_buffer (p));
+      ret = gst_app_src_push_buffer_list (p->src, list);
+    }
+    if (ret != GST_FLOW_OK)
+      break;
+  }
+  gst_app_src_end_of_stream (p->src);
+
+  return NULL;
+}
+
+static guint
+consume (GstAppSink * sink, guint batch)
+{
+  GstSample *sample;
+  guint count = 0;
+
+  while (TRUE) {
+    if (batch == 1) {
+      sample = gst_app_sink_pull_sample (sink);
+      if (sample == NULL)
+        break;
+      count++;
+    } else {
+      sample = gst_app_sink_try_pull_samples (sink, batch, GST_CLOCK_TIME_NONE);
+      if (sample == NULL)
+        break;
+      count += gst_buffer_list_length (gst_sample_get_buffer_list (sample));
+    }
+    /* the buffers go back to the pool here */
+    gst_sample_unref (sample);
+  }
+
+  return count;
+}
+
+static void
+do_benchmark (const gchar * name, guint num_buffers, guint size, guint batch,
+    gboolean use_pool)
+{
+  GstElement *pipeline, *src, *sink;
+  Producer p = { NULL, };
+  GThread *thread;
+  GTimer *timer;
+  gdouble elapsed;
+  guint count;
+
+  pipeline = gst_pipeline_new (NULL);
+  src = gst_element_factory_make ("appsrc", NULL);
+  sink = gst_element_factory_make ("appsink", NULL);
+
+  g_object_set (src, "block", TRUE, "max-bytes", (guint64) 0,
+      "max-buffers", (guint64) MAX_QUEUED_BUFFERS, NULL);
+  g_object_set (sink, "sync", FALSE, "max-buffers", MAX_QUEUED_BUFFERS,
+      "buffer-list", batch > 1, NULL);
+
+  gst_bin_add_many (GST_BIN (pipeline), src, sink, NULL);
+  gst_element_link_many (src, sink, NULL);
+
+  p.src = GST_APP_SRC (src);
+  p.num_buffers = num_buffers;
+  p.size = size;
+  p.batch = batch;
+
+  if (use_pool) {
+    GstStructure *config;
+
+    p.pool = gst_buffer_pool_new ();
+    config = gst_buffer_pool_get_config (p.pool);
+    gst_buffer_pool_config_set_params (config, NULL, size, 0, 0);
+    gst_buffer_pool_set_config (p.pool, config);
+    gst_buffer_pool_set_active (p.pool, TRUE);
+  }
+
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+
+  timer = g_timer_new ();
+  thread = g_thread_new ("producer", produce, &p);
+  count = consume (GST_APP_SINK (sink), batch);
+  g_thread_join (thread);
+  elapsed = g_timer_elapsed (timer, NULL);
+  g_timer_destroy (timer);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  if (p.pool) {
+    gst_buffer_pool_set_active (p.pool, FALSE);
+    gst_object_unref (p.pool);
+  }
+
+  gst_println ("%8.1f ns/buffer %8.2f Mbuffers/sec  %s (%u buffers of %u "
+      "bytes)", elapsed * 1e9 / MAX (count, 1), count / elapsed / 1e6, name,
+      count, size);
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *err = NULL;
+  gint num_buffers = DEFAULT_NUM_BUFFERS;
+  gint size = DEFAULT_BUFFER_SIZE;
+  gint batch = DEFAULT_BATCH;
+  GOptionContext *ctx;
+  GOptionEntry options[] = {
+    {"num-buffers", 'n', 0, G_OPTION_ARG_INT, &num_buffers,
+        "Number of buffers for each run", NULL},
+    {"size", 's', 0, G_OPTION_ARG_INT, &size, "Size of the buffers", NULL},
+    {"batch", 'b', 0, G_OPTION_ARG_INT, &batch,
+        "Number of buffers per pushed list and pulled sample", NULL},
+    {NULL}
+  };
+
+  ctx = g_option_context_new ("");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_option_context_free (ctx);
+    g_clear_error (&err);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  if (num_buffers < 1 || size < 0 || batch < 2) {
+    g_print ("Invalid number of buffers, size or batch\n");
+    return 1;
+  }
+
+  do_benchmark ("push and pull one by one, allocated buffers", num_buffers,
+      size, 1, FALSE);
+  do_benchmark ("push and pull one by one, pooled buffers", num_buffers,
+      size, 1, TRUE);
+  do_benchmark ("push lists and pull batches, allocated buffers", num_buffers,
+      size, batch, FALSE);
+  do_benchmark ("push lists and pull batches, pooled buffers", num_buffers,
+      size, batch, TRUE);
+
+  return 0;
+}
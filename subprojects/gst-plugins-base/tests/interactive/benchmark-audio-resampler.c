@@ -0,0 +1,319 @@
+/* GStreamer audio resampler benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+
+#include <gst/gst.h>
+#include <gst/audio/audio.h>
+
+#define DEFAULT_CHANNELS 2
+#define DEFAULT_FORMAT "F32LE"
+#define DEFAULT_DURATION 1.0
+
+#define BLOCK_FRAMES 1024
+#define SINE_FREQ 997.0
+#define SINE_AMPLITUDE 0.5
+
+static const gint rates[][2] = {
+  {44100, 48000},
+  {48000, 44100},
+  {48000, 16000},
+};
+
+static const struct
+{
+  GstAudioResamplerMethod method;
+  const gchar *name;
+  gboolean has_quality;
+} methods[] = {
+  {GST_AUDIO_RESAMPLER_METHOD_NEAREST, "nearest", FALSE},
+  {GST_AUDIO_RESAMPLER_METHOD_LINEAR, "linear", FALSE},
+  {GST_AUDIO_RESAMPLER_METHOD_CUBIC, "cubic", FALSE},
+  {GST_AUDIO_RESAMPLER_METHOD_BLACKMAN_NUTTALL, "blackman-nuttall", TRUE},
+  {GST_AUDIO_RESAMPLER_METHOD_KAISER, "kaiser", TRUE},
+};
+
+static const guint qualities[] = {
+  GST_AUDIO_RESAMPLER_QUALITY_MIN,
+  GST_AUDIO_RESAMPLER_QUALITY_DEFAULT,
+  GST_AUDIO_RESAMPLER_QUALITY_MAX,
+};
+
+static void
+write_sine (const GstAudioFormatInfo * finfo, gpointer data, gint channels,
+    gsize offset, gsize frames, gint rate)
+{
+  gsize i;
+  gint c;
+
+  for (i = 0; i < frames; i++) {
+    gdouble v = SINE_AMPLITUDE * sin (2.0 * G_PI * SINE_FREQ * (offset + i) /
+        rate);
+
+    for (c = 0; c < channels; c++) {
+      gsize idx = i * channels + c;
+
+      switch (GST_AUDIO_FORMAT_INFO_FORMAT (finfo)) {
+        case GST_AUDIO_FORMAT_S16:
+          ((gint16 *) data)[idx] = v * G_MAXINT16;
+          break;
+        case GST_AUDIO_FORMAT_S32:
+          ((gint32 *) data)[idx] = v * G_MAXINT32;
+          break;
+        case GST_AUDIO_FORMAT_F32:
+          ((gfloat *) data)[idx] = v;
+          break;
+        case GST_AUDIO_FORMAT_F64:
+          ((gdouble *) data)[idx] = v;
+          break;
+        default:
+          g_assert_not_reached ();
+      }
+    }
+  }
+}
+
+static gdouble
+read_sample (const GstAudioFormatInfo * finfo, gconstpointer data, gsize idx)
+{
+  switch (GST_AUDIO_FORMAT_INFO_FORMAT (finfo)) {
+    case GST_AUDIO_FORMAT_S16:
+      return ((const gint16 *) data)[idx] / (gdouble) G_MAXINT16;
+    case GST_AUDIO_FORMAT_S32:
+      return ((const gint32 *) data)[idx] / (gdouble) G_MAXINT32;
+    case GST_AUDIO_FORMAT_F32:
+      return ((const gfloat *) data)[idx];
+    case GST_AUDIO_FORMAT_F64:
+      return ((const gdouble *) data)[idx];
+    default:
+      g_assert_not_reached ();
+  }
+  return 0.0;
+}
+
+/* Resamples one second of a sine and returns the ratio in dB of the sine to
+ * everything else in the first channel of the output. The sine is found with
+ * a least squares fit so that the latency doesn't matter. */
+static gdouble
+measure_snr (GstAudioResampler * resampler, const GstAudioFormatInfo * finfo,
+    gint channels, gint in_rate, gint out_rate)
+{
+  gint bpf = GST_AUDIO_FORMAT_INFO_WIDTH (finfo) / 8 * channels;
+  gsize in_total = in_rate, in_done = 0, out_done = 0, out_alloc, skip, i;
+  gpointer in_data, out_data;
+  gdouble w, ss = 0, sc = 0, cc = 0, ys = 0, yc = 0, yy = 0, a, b, det;
+  gdouble signal, noise;
+
+  gst_audio_resampler_reset (resampler);
+
+  out_alloc = gst_audio_resampler_get_out_frames (resampler, in_total) +
+      BLOCK_FRAMES;
+  in_data = g_malloc (BLOCK_FRAMES * bpf);
+  out_data = g_malloc (out_alloc * bpf);
+
+  while (in_done < in_total) {
+    gsize in_frames = MIN (BLOCK_FRAMES, in_total - in_done), out_frames;
+    gpointer in[1], out[1];
+
+    write_sine (finfo, in_data, channels, in_done, in_frames, in_rate);
+    out_frames = gst_audio_resampler_get_out_frames (resampler, in_frames);
+
+    in[0] = in_data;
+    out[0] = (guint8 *) out_data + out_done * bpf;
+    gst_audio_resampler_resample (resampler, in, in_frames, out, out_frames);
+
+    in_done += in_frames;
+    out_done += out_frames;
+  }
+
+  /* skip the start, where the filter is not filled yet */
+  skip = 2 * gst_audio_resampler_get_max_latency (resampler) + 64;
+  w = 2.0 * G_PI * SINE_FREQ / out_rate;
+
+  for (i = skip; i < out_done; i++) {
+    gdouble y = read_sample (finfo, out_data, i * channels);
+    gdouble s = sin (w * i), c = cos (w * i);
+
+    ss += s * s;
+    sc += s * c;
+    cc += c * c;
+    ys += y * s;
+    yc += y * c;
+    yy += y * y;
+  }
+  g_free (in_data);
+  g_free (out_data);
+
+  det = ss * cc - sc * sc;
+  if (out_done <= skip || det == 0.0)
+    return 0.0;
+
+  a = (ys * cc - yc * sc) / det;
+  b = (yc * ss - ys * sc) / det;
+  signal = a * ys + b * yc;
+  noise = MAX (yy - signal, 1e-30);
+
+  return 10.0 * log10 (signal / noise);
+}
+
+static void
+do_benchmark (GstAudioResamplerMethod method, const gchar * method_name,
+    guint quality, const GstAudioFormatInfo * finfo, gint channels,
+    gint in_rate, gint out_rate, gdouble max_duration)
+{
+  GstAudioResampler *resampler;
+  GstStructure *options;
+  gint bpf = GST_AUDIO_FORMAT_INFO_WIDTH (finfo) / 8 * channels;
+  gsize out_max, in_frames = 0;
+  gpointer in[1], out[1];
+  gdouble elapsed, snr;
+  GTimer *timer;
+
+  options = gst_structure_new_empty ("GstAudioResampler.options");
+  gst_audio_resampler_options_set_quality (method, quality, in_rate, out_rate,
+      options);
+
+  resampler = gst_audio_resampler_new (method, GST_AUDIO_RESAMPLER_FLAG_NONE,
+      GST_AUDIO_FORMAT_INFO_FORMAT (finfo), channels, in_rate, out_rate,
+      options);
+  gst_structure_free (options);
+
+  snr = measure_snr (resampler, finfo, channels, in_rate, out_rate);
+
+  gst_audio_resampler_reset (resampler);
+  out_max = gst_audio_resampler_get_out_frames (resampler, BLOCK_FRAMES) + 1;
+  in[0] = g_malloc (BLOCK_FRAMES * bpf);
+  out[0] = g_malloc (out_max * bpf);
+  write_sine (finfo, in[0], channels, 0, BLOCK_FRAMES, in_rate);
+
+  timer = g_timer_new ();
+  while (TRUE) {
+    gsize out_frames;
+
+    out_frames = gst_audio_resampler_get_out_frames (resampler, BLOCK_FRAMES);
+    gst_audio_resampler_resample (resampler, in, BLOCK_FRAMES, out,
+        out_frames);
+    in_frames += BLOCK_FRAMES;
+
+    elapsed = g_timer_elapsed (timer, NULL);
+    if (elapsed >= max_duration)
+      break;
+  }
+  g_timer_destroy (timer);
+
+  gst_println ("%9.2f Msamples/sec %6.1f dB SNR  %s quality %u, %s %d -> %d "
+      "Hz, %d channels", in_frames * channels / elapsed / 1e6, snr,
+      method_name, quality, GST_AUDIO_FORMAT_INFO_NAME (finfo), in_rate,
+      out_rate, channels);
+
+  g_free (in[0]);
+  g_free (out[0]);
+  gst_audio_resampler_free (resampler);
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *err = NULL;
+  gint channels = DEFAULT_CHANNELS;
+  gint in_rate = 0, out_rate = 0;
+  gint quality = -1;
+  gdouble max_dur = DEFAULT_DURATION;
+  gchar *format = NULL;
+  gchar *method = NULL;
+  const GstAudioFormatInfo *finfo;
+  GOptionContext *ctx;
+  GOptionEntry options[] = {
+    {"channels", 'c', 0, G_OPTION_ARG_INT, &channels, "Number of channels",
+        NULL},
+    {"format", 'f', 0, G_OPTION_ARG_STRING, &format,
+        "Sample format: S16LE, S32LE, F32LE or F64LE (default "
+          DEFAULT_FORMAT ")", NULL},
+    {"method", 'm', 0, G_OPTION_ARG_STRING, &method,
+        "Only this resampler method", NULL},
+    {"quality", 'q', 0, G_OPTION_ARG_INT, &quality,
+        "Only this quality for the sinc methods", NULL},
+    {"in-rate", 'i', 0, G_OPTION_ARG_INT, &in_rate, "Input rate", NULL},
+    {"out-rate", 'o', 0, G_OPTION_ARG_INT, &out_rate, "Output rate", NULL},
+    {"duration", 'd', 0, G_OPTION_ARG_DOUBLE, &max_dur,
+        "Benchmark duration for each run (in seconds)", NULL},
+    {NULL}
+  };
+  guint r, m, q;
+
+  ctx = g_option_context_new ("");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_option_context_free (ctx);
+    g_clear_error (&err);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  finfo =
+      gst_audio_format_get_info (gst_audio_format_from_string (format ? format
+          : DEFAULT_FORMAT));
+  switch (GST_AUDIO_FORMAT_INFO_FORMAT (finfo)) {
+    case GST_AUDIO_FORMAT_S16:
+    case GST_AUDIO_FORMAT_S32:
+    case GST_AUDIO_FORMAT_F32:
+    case GST_AUDIO_FORMAT_F64:
+      break;
+    default:
+      g_print ("Unsupported format %s\n", format);
+      return 1;
+  }
+  if (channels < 1) {
+    g_print ("Invalid number of channels %d\n", channels);
+    return 1;
+  }
+
+  for (r = 0; r < G_N_ELEMENTS (rates); r++) {
+    gint irate = in_rate > 0 ? in_rate : rates[r][0];
+    gint orate = out_rate > 0 ? out_rate : rates[r][1];
+
+    for (m = 0; m < G_N_ELEMENTS (methods); m++) {
+      if (method != NULL && !g_str_equal (method, methods[m].name))
+        continue;
+
+      for (q = 0; q < G_N_ELEMENTS (qualities); q++) {
+        guint qual = quality >= 0 ? quality : qualities[q];
+
+        do_benchmark (methods[m].method, methods[m].name, qual, finfo,
+            channels, irate, orate, max_dur);
+
+        if (!methods[m].has_quality || quality >= 0)
+          break;
+      }
+    }
+    /* a single rate pair was given */
+    if (in_rate > 0 || out_rate > 0)
+      break;
+  }
+
+  g_free (format);
+  g_free (method);
+
+  return 0;
+}
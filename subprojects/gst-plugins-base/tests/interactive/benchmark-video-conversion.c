@@ -30,6 +30,19 @@
 
 #define DEFAULT_DURATION 2.0
 
+/* the format pairs with vectorized fast paths */
+static const gchar *fastpaths[][2] = {
+  {"NV12", "I420"},
+  {"I420", "NV12"},
+  {"I420", "BGRx"},
+  {"I420", "RGBA"},
+  {"NV12", "BGRx"},
+  {"NV12", "RGBA"},
+  {"P010_10LE", "NV12"},
+  {"v210", "I422_10LE"},
+  {"I422_10LE", "v210"},
+};
+
 static gint
 get_num_formats (void)
 {
@@ -108,8 +121,9 @@ do_benchmark_conversions (guint width, guint height, const gchar * in_format,
 
       convert_sec = count / elapsed;
 
-      gst_println ("%8.1f conversions/sec %s -> %s @ %ux%u, %d/%.5f",
-          convert_sec, infmt_str, outfmt_str, width, height, count, elapsed);
+      gst_println ("%8.1f conversions/sec %8.1f Mpixels/sec %s -> %s @ %ux%u, "
+          "%d/%.5f", convert_sec, convert_sec * width * height / 1e6,
+          infmt_str, outfmt_str, width, height, count, elapsed);
 
       gst_video_converter_free (convert);
 
@@ -132,6 +146,7 @@ main (int argc, char **argv)
   gdouble max_dur = DEFAULT_DURATION;
   gchar *from_fmt = NULL;
   gchar *to_fmt = NULL;
+  gboolean fast = FALSE;
   GOptionContext *ctx;
   GOptionEntry options[] = {
     {"width", 'w', 0, G_OPTION_ARG_INT, &width, "Width", NULL},
@@ -141,6 +156,8 @@ main (int argc, char **argv)
     {"to-format", 't', 0, G_OPTION_ARG_STRING, &to_fmt, "To Format", NULL},
     {"duration", 'd', 0, G_OPTION_ARG_DOUBLE, &max_dur,
         "Benchmark duration for each run (in seconds)", NULL},
+    {"fastpaths", 0, 0, G_OPTION_ARG_NONE, &fast,
+        "Only the format pairs with vectorized fast paths", NULL},
     {NULL}
   };
 
@@ -155,6 +172,14 @@ main (int argc, char **argv)
   }
   g_option_context_free (ctx);
 
-  do_benchmark_conversions (width, height, from_fmt, to_fmt, max_dur);
+  if (fast) {
+    gint i;
+
+    for (i = 0; i < G_N_ELEMENTS (fastpaths); i++)
+      do_benchmark_conversions (width, height, fastpaths[i][0],
+          fastpaths[i][1], max_dur);
+  } else {
+    do_benchmark_conversions (width, height, from_fmt, to_fmt, max_dur);
+  }
   return 0;
 }
@@ -113,6 +113,7 @@
 #include <sys/socket.h>
 #endif
 
+#include <errno.h>
 #include <string.h>
 #include "gstudpelements.h"
 #include "gstudpsrc.h"
@@ -572,6 +573,9 @@ static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
 #define UDP_DEFAULT_RETRIEVE_SENDER_ADDRESS TRUE
 #define UDP_DEFAULT_MTU                (1492)
 #define UDP_DEFAULT_MULTICAST_SOURCE   NULL
+#define UDP_DEFAULT_BATCH_SIZE         1
+/* recvmmsg() doesn't take more than UIO_MAXIOV messages at once */
+#define UDP_MAX_BATCH_SIZE             1024
 
 enum
 {
@@ -596,6 +600,7 @@ enum
   PROP_MTU,
   PROP_SOCKET_TIMESTAMP,
   PROP_MULTICAST_SOURCE,
+  PROP_BATCH_SIZE,
 };
 
 static void gst_udpsrc_uri_handler_init (gpointer g_iface, gpointer iface_data);
@@ -605,6 +610,11 @@ static gboolean gst_udpsrc_close (GstUDPSrc * src);
 static gboolean gst_udpsrc_unlock (GstBaseSrc * bsrc);
 static gboolean gst_udpsrc_unlock_stop (GstBaseSrc * bsrc);
 static GstFlowReturn gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf);
+#ifdef HAVE_RECVMMSG
+static GstFlowReturn gst_udpsrc_create (GstBaseSrc * bsrc, guint64 offset,
+    guint length, GstBuffer ** buf);
+#endif
+static void gst_udpsrc_clear_batch (GstUDPSrc * udpsrc);
 
 static void gst_udpsrc_finalize (GObject * object);
 
@@ -798,6 +808,29 @@ gst_udpsrc_class_init (GstUDPSrcClass * klass)
           UDP_DEFAULT_MULTICAST_SOURCE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstUDPSrc:batch-size:
+   *
+   * Maximum number of packets to read from the socket with a single system
+   * call. When bigger than 1, all packets read at once are pushed downstream
+   * together in a #GstBufferList, which considerably reduces the per-packet
+   * overhead at high packet rates.
+   *
+   * Packets of a batch that carry no socket timestamp share the same capture
+   * timestamp. Every packet of a batch reserves room for the largest possible
+   * UDP packet in case it exceeds #GstUDPSrc:mtu.
+   *
+   * Only supported on systems providing recvmmsg(), elsewhere packets are
+   * always read one by one.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_BATCH_SIZE,
+      g_param_spec_uint ("batch-size", "Batch size",
+          "Maximum number of packets to read with a single system call and "
+          "push downstream as a buffer list", 1, UDP_MAX_BATCH_SIZE,
+          UDP_DEFAULT_BATCH_SIZE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class, &src_template);
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -812,6 +845,9 @@ gst_udpsrc_class_init (GstUDPSrcClass * klass)
   gstbasesrc_class->unlock_stop = gst_udpsrc_unlock_stop;
   gstbasesrc_class->get_caps = gst_udpsrc_getcaps;
   gstbasesrc_class->decide_allocation = gst_udpsrc_decide_allocation;
+#ifdef HAVE_RECVMMSG
+  gstbasesrc_class->create = gst_udpsrc_create;
+#endif
 
   gstpushsrc_class->fill = gst_udpsrc_fill;
 
@@ -840,6 +876,7 @@ gst_udpsrc_init (GstUDPSrc * udpsrc)
   udpsrc->loop = UDP_DEFAULT_LOOP;
   udpsrc->retrieve_sender_address = UDP_DEFAULT_RETRIEVE_SENDER_ADDRESS;
   udpsrc->mtu = UDP_DEFAULT_MTU;
+  udpsrc->batch_size = UDP_DEFAULT_BATCH_SIZE;
   udpsrc->source_list =
       g_ptr_array_new_with_free_func ((GDestroyNotify) g_free);
 
@@ -884,6 +921,8 @@ gst_udpsrc_finalize (GObject * object)
     gst_memory_unref (udpsrc->extra_mem);
   udpsrc->extra_mem = NULL;
 
+  gst_udpsrc_clear_batch (udpsrc);
+
   g_ptr_array_unref (udpsrc->source_list);
   g_free (udpsrc->multicast_source);
 
@@ -936,81 +975,60 @@ gst_udpsrc_free_cancellable (GstUDPSrc * src)
   src->cancellable = NULL;
 }
 
-static GstFlowReturn
-gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf)
+/* optimization: use messages only in multicast mode and
+ * if we can't let the kernel do the filtering for us */
+static gboolean
+gst_udpsrc_needs_control_messages (GstUDPSrc * udpsrc)
 {
-  GstUDPSrc *udpsrc;
-  GSocketAddress *saddr = NULL;
-  GSocketAddress **p_saddr;
-  gint flags = G_SOCKET_MSG_NONE;
-  gboolean try_again;
-  GError *err = NULL;
-  gssize res;
-  gsize offset;
-  GSocketControlMessage **msgs = NULL;
-  GSocketControlMessage ***p_msgs;
-  gint n_msgs = 0, i;
-  GstMapInfo info;
-  GstMapInfo extra_info;
-  GInputVector ivec[2];
+  gboolean needed;
 
-  udpsrc = GST_UDPSRC_CAST (psrc);
-
-  /* optimization: use messages only in multicast mode and
-   * if we can't let the kernel do the filtering for us */
-  p_msgs =
-      (g_inet_address_get_is_multicast (g_inet_socket_address_get_address
-          (udpsrc->addr))) ? &msgs : NULL;
+  needed =
+      g_inet_address_get_is_multicast (g_inet_socket_address_get_address
+      (udpsrc->addr));
 #ifdef IP_MULTICAST_ALL
   if (g_inet_address_get_family (g_inet_socket_address_get_address
           (udpsrc->addr)) == G_SOCKET_FAMILY_IPV4)
-    p_msgs = NULL;
+    needed = FALSE;
 #endif
 #ifdef SO_TIMESTAMPNS
   if (udpsrc->socket_timestamp_mode == GST_SOCKET_TIMESTAMP_MODE_REALTIME)
-    p_msgs = &msgs;
+    needed = TRUE;
 #endif
 
-  /* Retrieve sender address unless we've been configured not to do so */
-  p_saddr = (udpsrc->retrieve_sender_address) ? &saddr : NULL;
+  return needed;
+}
 
-  if (!gst_buffer_map (outbuf, &info, GST_MAP_READWRITE))
-    goto buffer_map_error;
+/* Prepare memory in case the data size exceeds mtu */
+static GstMemory *
+gst_udpsrc_alloc_extra_mem (GstUDPSrc * udpsrc)
+{
+  GstBufferPool *pool;
+  GstStructure *config;
+  GstAllocator *allocator = NULL;
+  GstAllocationParams params;
+  GstMemory *mem;
 
-  ivec[0].buffer = info.data;
-  ivec[0].size = info.size;
+  pool = gst_base_src_get_buffer_pool (GST_BASE_SRC_CAST (udpsrc));
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_get_allocator (config, &allocator, &params);
 
-  /* Prepare memory in case the data size exceeds mtu */
-  if (udpsrc->extra_mem == NULL) {
-    GstBufferPool *pool;
-    GstStructure *config;
-    GstAllocator *allocator = NULL;
-    GstAllocationParams params;
-
-    pool = gst_base_src_get_buffer_pool (GST_BASE_SRC_CAST (psrc));
-    config = gst_buffer_pool_get_config (pool);
-    gst_buffer_pool_config_get_allocator (config, &allocator, &params);
-
-    udpsrc->extra_mem =
-        gst_allocator_alloc (allocator, MAX_IPV4_UDP_PACKET_SIZE, &params);
-
-    gst_object_unref (pool);
-    gst_structure_free (config);
-    if (allocator)
-      gst_object_unref (allocator);
-  }
+  mem = gst_allocator_alloc (allocator, MAX_IPV4_UDP_PACKET_SIZE, &params);
 
-  if (!gst_memory_map (udpsrc->extra_mem, &extra_info, GST_MAP_READWRITE))
-    goto memory_map_error;
+  gst_object_unref (pool);
+  gst_structure_free (config);
+  if (allocator)
+    gst_object_unref (allocator);
 
-  ivec[1].buffer = extra_info.data;
-  ivec[1].size = extra_info.size;
+  return mem;
+}
 
-retry:
-  if (saddr != NULL) {
-    g_object_unref (saddr);
-    saddr = NULL;
-  }
+/* Waits until the socket becomes readable, posting a timeout message every
+ * time the configured timeout expires */
+static GstFlowReturn
+gst_udpsrc_wait_readable (GstUDPSrc * udpsrc)
+{
+  GError *err = NULL;
+  gboolean try_again;
 
   do {
     gint64 timeout;
@@ -1044,122 +1062,207 @@ retry:
     }
   } while (G_UNLIKELY (try_again));
 
-  res =
-      g_socket_receive_message (udpsrc->used_socket, p_saddr, ivec, 2,
-      p_msgs, &n_msgs, &flags, udpsrc->cancellable, &err);
+  return GST_FLOW_OK;
 
-  if (G_UNLIKELY (res < 0)) {
-    /* G_IO_ERROR_HOST_UNREACHABLE for a UDP socket means that a packet sent
-     * with udpsink generated a "port unreachable" ICMP response. We ignore
-     * that and try again.
-     * On Windows we get G_IO_ERROR_CONNECTION_CLOSED instead */
-    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_HOST_UNREACHABLE) ||
-        g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CONNECTION_CLOSED)) {
-      g_clear_error (&err);
-      goto retry;
-    }
-    goto receive_error;
+  /* ERRORS */
+select_error:
+  {
+    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+        ("select error: %s", err->message));
+    g_clear_error (&err);
+    return GST_FLOW_ERROR;
   }
+stopped:
+  {
+    GST_DEBUG ("stop called");
+    g_clear_error (&err);
+    return GST_FLOW_FLUSHING;
+  }
+}
 
-  /* Retry if multicast and the destination address is not ours. We don't want
-   * to receive arbitrary packets */
-  if (p_msgs) {
-    GInetAddress *iaddr = g_inet_socket_address_get_address (udpsrc->addr);
-    gboolean skip_packet = FALSE;
-    gsize iaddr_size = g_inet_address_get_native_size (iaddr);
-    const guint8 *iaddr_bytes = g_inet_address_to_bytes (iaddr);
+/* Inspects the control messages received along with a packet. Sets the DTS
+ * of @outbuf if a socket timestamp was received and returns %TRUE if the
+ * packet was sent to a different multicast group and must be dropped */
+static gboolean
+gst_udpsrc_process_control_messages (GstUDPSrc * udpsrc, GstBuffer * outbuf,
+    GSocketControlMessage ** msgs, gint n_msgs)
+{
+  GInetAddress *iaddr = g_inet_socket_address_get_address (udpsrc->addr);
+  gboolean skip_packet = FALSE;
+  gsize iaddr_size = g_inet_address_get_native_size (iaddr);
+  const guint8 *iaddr_bytes = g_inet_address_to_bytes (iaddr);
+  gint i;
 
-    for (i = 0; i < n_msgs && !skip_packet; i++) {
+  for (i = 0; i < n_msgs && !skip_packet; i++) {
 #ifdef IP_PKTINFO
-      if (GST_IS_IP_PKTINFO_MESSAGE (msgs[i])) {
-        GstIPPktinfoMessage *msg = GST_IP_PKTINFO_MESSAGE (msgs[i]);
+    if (GST_IS_IP_PKTINFO_MESSAGE (msgs[i])) {
+      GstIPPktinfoMessage *msg = GST_IP_PKTINFO_MESSAGE (msgs[i]);
 
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
 #endif
 #ifdef IPV6_PKTINFO
-      if (GST_IS_IPV6_PKTINFO_MESSAGE (msgs[i])) {
-        GstIPV6PktinfoMessage *msg = GST_IPV6_PKTINFO_MESSAGE (msgs[i]);
+    if (GST_IS_IPV6_PKTINFO_MESSAGE (msgs[i])) {
+      GstIPV6PktinfoMessage *msg = GST_IPV6_PKTINFO_MESSAGE (msgs[i]);
 
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
 #endif
 #ifdef IP_RECVDSTADDR
-      if (GST_IS_IP_RECVDSTADDR_MESSAGE (msgs[i])) {
-        GstIPRecvdstaddrMessage *msg = GST_IP_RECVDSTADDR_MESSAGE (msgs[i]);
+    if (GST_IS_IP_RECVDSTADDR_MESSAGE (msgs[i])) {
+      GstIPRecvdstaddrMessage *msg = GST_IP_RECVDSTADDR_MESSAGE (msgs[i]);
 
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
 #endif
 #ifdef SO_TIMESTAMPNS
-      if (GST_IS_SOCKET_TIMESTAMP_MESSAGE (msgs[i])) {
-        GstSocketTimestampMessage *msg = GST_SOCKET_TIMESTAMP_MESSAGE (msgs[i]);
-        GstClock *clock;
-        GstClockTime socket_ts;
-
-        socket_ts = GST_TIMESPEC_TO_TIME (msg->socket_ts);
-        GST_TRACE_OBJECT (udpsrc,
-            "Got SCM_TIMESTAMPNS %" GST_TIME_FORMAT " in msg",
-            GST_TIME_ARGS (socket_ts));
-
-        clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
-        if (clock != NULL) {
-          gint64 adjust_dts, cur_sys_time, delta;
-          GstClockTime base_time, cur_gst_clk_time, running_time;
-
+    if (GST_IS_SOCKET_TIMESTAMP_MESSAGE (msgs[i])) {
+      GstSocketTimestampMessage *msg = GST_SOCKET_TIMESTAMP_MESSAGE (msgs[i]);
+      GstClock *clock;
+      GstClockTime socket_ts;
+
+      socket_ts = GST_TIMESPEC_TO_TIME (msg->socket_ts);
+      GST_TRACE_OBJECT (udpsrc,
+          "Got SCM_TIMESTAMPNS %" GST_TIME_FORMAT " in msg",
+          GST_TIME_ARGS (socket_ts));
+
+      clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
+      if (clock != NULL) {
+        gint64 adjust_dts, cur_sys_time, delta;
+        GstClockTime base_time, cur_gst_clk_time, running_time;
+
+        /*
+         * We use g_get_real_time as the time reference for SCM timestamps
+         * is always CLOCK_REALTIME.
+         */
+        cur_sys_time = g_get_real_time () * GST_USECOND;
+        cur_gst_clk_time = gst_clock_get_time (clock);
+
+        delta = (gint64) cur_sys_time - (gint64) socket_ts;
+        if (delta < 0) {
           /*
-           * We use g_get_real_time as the time reference for SCM timestamps
-           * is always CLOCK_REALTIME.
+           * The current system time will always be greater than the SCM
+           * timestamp as the packet would have been timestamped at least
+           * some clock cycles before. If it is not, then the system time
+           * was adjusted. Since we cannot rely on the delta calculation in
+           * such a case, set the DTS to current pipeline clock when this
+           * happens.
            */
-          cur_sys_time = g_get_real_time () * GST_USECOND;
-          cur_gst_clk_time = gst_clock_get_time (clock);
-
-          delta = (gint64) cur_sys_time - (gint64) socket_ts;
-          if (delta < 0) {
-            /*
-             * The current system time will always be greater than the SCM
-             * timestamp as the packet would have been timestamped at least
-             * some clock cycles before. If it is not, then the system time
-             * was adjusted. Since we cannot rely on the delta calculation in
-             * such a case, set the DTS to current pipeline clock when this
-             * happens.
-             */
+          GST_LOG_OBJECT (udpsrc,
+              "Current system time is behind SCM timestamp, setting DTS to pipeline clock");
+          GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
+        } else {
+          base_time = gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
+          running_time = cur_gst_clk_time - base_time;
+          adjust_dts = (gint64) running_time - delta;
+          /*
+           * If the system time was adjusted much further ahead, we might
+           * end up with delta > cur_gst_clk_time. Set the DTS to current
+           * pipeline clock for this scenario as well.
+           */
+          if (adjust_dts < 0) {
             GST_LOG_OBJECT (udpsrc,
-                "Current system time is behind SCM timestamp, setting DTS to pipeline clock");
+                "Current system time much ahead in time, setting DTS to pipeline clock");
             GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
           } else {
-            base_time = gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
-            running_time = cur_gst_clk_time - base_time;
-            adjust_dts = (gint64) running_time - delta;
-            /*
-             * If the system time was adjusted much further ahead, we might
-             * end up with delta > cur_gst_clk_time. Set the DTS to current
-             * pipeline clock for this scenario as well.
-             */
-            if (adjust_dts < 0) {
-              GST_LOG_OBJECT (udpsrc,
-                  "Current system time much ahead in time, setting DTS to pipeline clock");
-              GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
-            } else {
-              GST_BUFFER_DTS (outbuf) = adjust_dts;
-              GST_LOG_OBJECT (udpsrc, "Setting DTS to %" GST_TIME_FORMAT,
-                  GST_TIME_ARGS (GST_BUFFER_DTS (outbuf)));
-            }
+            GST_BUFFER_DTS (outbuf) = adjust_dts;
+            GST_LOG_OBJECT (udpsrc, "Setting DTS to %" GST_TIME_FORMAT,
+                GST_TIME_ARGS (GST_BUFFER_DTS (outbuf)));
           }
-          g_object_unref (clock);
-        } else {
-          GST_ERROR_OBJECT (udpsrc,
-              "Failed to get element clock, not setting DTS");
         }
+        g_object_unref (clock);
+      } else {
+        GST_ERROR_OBJECT (udpsrc,
+            "Failed to get element clock, not setting DTS");
       }
+    }
 #endif
+  }
+
+  return skip_packet;
+}
+
+static GstFlowReturn
+gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf)
+{
+  GstUDPSrc *udpsrc;
+  GSocketAddress *saddr = NULL;
+  GSocketAddress **p_saddr;
+  gint flags = G_SOCKET_MSG_NONE;
+  GstFlowReturn ret;
+  GError *err = NULL;
+  gssize res;
+  gsize offset;
+  GSocketControlMessage **msgs = NULL;
+  GSocketControlMessage ***p_msgs;
+  gint n_msgs = 0, i;
+  GstMapInfo info;
+  GstMapInfo extra_info;
+  GInputVector ivec[2];
+
+  udpsrc = GST_UDPSRC_CAST (psrc);
+
+  p_msgs = gst_udpsrc_needs_control_messages (udpsrc) ? &msgs : NULL;
+
+  /* Retrieve sender address unless we've been configured not to do so */
+  p_saddr = (udpsrc->retrieve_sender_address) ? &saddr : NULL;
+
+  if (!gst_buffer_map (outbuf, &info, GST_MAP_READWRITE))
+    goto buffer_map_error;
+
+  ivec[0].buffer = info.data;
+  ivec[0].size = info.size;
+
+  /* Prepare memory in case the data size exceeds mtu */
+  if (udpsrc->extra_mem == NULL)
+    udpsrc->extra_mem = gst_udpsrc_alloc_extra_mem (udpsrc);
+
+  if (!gst_memory_map (udpsrc->extra_mem, &extra_info, GST_MAP_READWRITE))
+    goto memory_map_error;
+
+  ivec[1].buffer = extra_info.data;
+  ivec[1].size = extra_info.size;
+
+retry:
+  if (saddr != NULL) {
+    g_object_unref (saddr);
+    saddr = NULL;
+  }
+
+  ret = gst_udpsrc_wait_readable (udpsrc);
+  if (G_UNLIKELY (ret != GST_FLOW_OK))
+    goto wait_failed;
+
+  res =
+      g_socket_receive_message (udpsrc->used_socket, p_saddr, ivec, 2,
+      p_msgs, &n_msgs, &flags, udpsrc->cancellable, &err);
+
+  if (G_UNLIKELY (res < 0)) {
+    /* G_IO_ERROR_HOST_UNREACHABLE for a UDP socket means that a packet sent
+     * with udpsink generated a "port unreachable" ICMP response. We ignore
+     * that and try again.
+     * On Windows we get G_IO_ERROR_CONNECTION_CLOSED instead */
+    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_HOST_UNREACHABLE) ||
+        g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CONNECTION_CLOSED)) {
+      g_clear_error (&err);
+      goto retry;
     }
+    goto receive_error;
+  }
+
+  /* Retry if multicast and the destination address is not ours. We don't want
+   * to receive arbitrary packets */
+  if (p_msgs) {
+    gboolean skip_packet;
+
+    skip_packet =
+        gst_udpsrc_process_control_messages (udpsrc, outbuf, msgs, n_msgs);
 
     for (i = 0; i < n_msgs; i++) {
       g_object_unref (msgs[i]);
@@ -1216,22 +1319,11 @@ memory_map_error:
         ("Failed to map memory"));
     return GST_FLOW_ERROR;
   }
-select_error:
-  {
-    gst_buffer_unmap (outbuf, &info);
-    gst_memory_unmap (udpsrc->extra_mem, &extra_info);
-    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
-        ("select error: %s", err->message));
-    g_clear_error (&err);
-    return GST_FLOW_ERROR;
-  }
-stopped:
+wait_failed:
   {
     gst_buffer_unmap (outbuf, &info);
     gst_memory_unmap (udpsrc->extra_mem, &extra_info);
-    GST_DEBUG ("stop called");
-    g_clear_error (&err);
-    return GST_FLOW_FLUSHING;
+    return ret;
   }
 receive_error:
   {
@@ -1258,6 +1350,350 @@ skip_error:
   }
 }
 
+#ifdef HAVE_RECVMMSG
+/* Room for the destination address and timestamp control messages of one
+ * packet */
+#define UDP_BATCH_CONTROL_SIZE 256
+#define UDP_BATCH_MAX_CONTROL_MESSAGES 8
+
+struct _GstUDPSrcBatch
+{
+  guint size;
+
+  struct mmsghdr *hdrs;
+  /* two vectors per packet: the pool buffer and the extra memory */
+  struct iovec *iovs;
+  struct sockaddr_storage *addrs;
+  guint8 *control;
+
+  GstBuffer **buffers;
+  GstMapInfo *maps;
+  GstMemory **extra_mem;
+  GstMapInfo *extra_maps;
+};
+
+static GstUDPSrcBatch *
+gst_udpsrc_batch_new (guint size)
+{
+  GstUDPSrcBatch *batch;
+
+  batch = g_new0 (GstUDPSrcBatch, 1);
+  batch->size = size;
+  batch->hdrs = g_new0 (struct mmsghdr, size);
+  batch->iovs = g_new0 (struct iovec, 2 * size);
+  batch->addrs = g_new0 (struct sockaddr_storage, size);
+  batch->control = g_malloc0 (size * UDP_BATCH_CONTROL_SIZE);
+  batch->buffers = g_new0 (GstBuffer *, size);
+  batch->maps = g_new0 (GstMapInfo, size);
+  batch->extra_mem = g_new0 (GstMemory *, size);
+  batch->extra_maps = g_new0 (GstMapInfo, size);
+
+  return batch;
+}
+
+static void
+gst_udpsrc_batch_free (GstUDPSrcBatch * batch)
+{
+  guint i;
+
+  for (i = 0; i < batch->size; i++) {
+    if (batch->buffers[i])
+      gst_buffer_unref (batch->buffers[i]);
+    if (batch->extra_mem[i])
+      gst_memory_unref (batch->extra_mem[i]);
+  }
+
+  g_free (batch->hdrs);
+  g_free (batch->iovs);
+  g_free (batch->addrs);
+  g_free (batch->control);
+  g_free (batch->buffers);
+  g_free (batch->maps);
+  g_free (batch->extra_mem);
+  g_free (batch->extra_maps);
+  g_free (batch);
+}
+
+static void
+gst_udpsrc_batch_unmap (GstUDPSrcBatch * batch, guint n)
+{
+  guint i;
+
+  for (i = 0; i < n; i++) {
+    gst_buffer_unmap (batch->buffers[i], &batch->maps[i]);
+    gst_memory_unmap (batch->extra_mem[i], &batch->extra_maps[i]);
+  }
+}
+
+static gboolean
+gst_udpsrc_batch_map (GstUDPSrcBatch * batch)
+{
+  guint i;
+
+  for (i = 0; i < batch->size; i++) {
+    if (!gst_buffer_map (batch->buffers[i], &batch->maps[i],
+            GST_MAP_READWRITE))
+      goto map_failed;
+
+    if (!gst_memory_map (batch->extra_mem[i], &batch->extra_maps[i],
+            GST_MAP_READWRITE)) {
+      gst_buffer_unmap (batch->buffers[i], &batch->maps[i]);
+      goto map_failed;
+    }
+
+    batch->iovs[2 * i].iov_base = batch->maps[i].data;
+    batch->iovs[2 * i].iov_len = batch->maps[i].size;
+    batch->iovs[2 * i + 1].iov_base = batch->extra_maps[i].data;
+    batch->iovs[2 * i + 1].iov_len = batch->extra_maps[i].size;
+  }
+
+  return TRUE;
+
+map_failed:
+  {
+    gst_udpsrc_batch_unmap (batch, i);
+    return FALSE;
+  }
+}
+
+static GstClockTime
+gst_udpsrc_get_running_time (GstUDPSrc * udpsrc)
+{
+  GstClock *clock;
+  GstClockTime now;
+
+  clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
+  if (clock == NULL)
+    return GST_CLOCK_TIME_NONE;
+
+  now = gst_clock_get_time (clock);
+  g_object_unref (clock);
+
+  return now - gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
+}
+
+/* Reads up to batch-size packets with a single recvmmsg() call and submits
+ * them as one buffer list. GstBaseSrc only timestamps the first buffer of a
+ * list, so the capture time is set on every packet here. */
+static GstFlowReturn
+gst_udpsrc_create_batch (GstUDPSrc * udpsrc)
+{
+  GstUDPSrcBatch *batch;
+  GstBufferPool *pool;
+  GstBufferList *list;
+  GstClockTime capture_time;
+  GstFlowReturn ret;
+  gboolean want_msgs, want_saddr;
+  gsize offset;
+  gint fd, n_received, errsv, i;
+  guint j;
+
+  if (udpsrc->batch && udpsrc->batch->size != udpsrc->batch_size)
+    gst_udpsrc_clear_batch (udpsrc);
+  if (udpsrc->batch == NULL)
+    udpsrc->batch = gst_udpsrc_batch_new (udpsrc->batch_size);
+  batch = udpsrc->batch;
+
+  want_msgs = gst_udpsrc_needs_control_messages (udpsrc);
+  want_saddr = udpsrc->retrieve_sender_address;
+  offset = udpsrc->skip_first_bytes;
+  fd = g_socket_get_fd (udpsrc->used_socket);
+
+  /* Buffers of packets that were not received or were dropped stay in the
+   * batch for the next call */
+  pool = gst_base_src_get_buffer_pool (GST_BASE_SRC_CAST (udpsrc));
+  for (j = 0; j < batch->size; j++) {
+    if (batch->buffers[j] == NULL) {
+      ret = gst_buffer_pool_acquire_buffer (pool, &batch->buffers[j], NULL);
+      if (G_UNLIKELY (ret != GST_FLOW_OK)) {
+        gst_object_unref (pool);
+        return ret;
+      }
+    }
+    if (batch->extra_mem[j] == NULL)
+      batch->extra_mem[j] = gst_udpsrc_alloc_extra_mem (udpsrc);
+  }
+  gst_object_unref (pool);
+
+  list = gst_buffer_list_new_sized (batch->size);
+
+retry:
+  ret = gst_udpsrc_wait_readable (udpsrc);
+  if (G_UNLIKELY (ret != GST_FLOW_OK))
+    goto wait_failed;
+
+  if (!gst_udpsrc_batch_map (batch))
+    goto map_error;
+
+  for (j = 0; j < batch->size; j++) {
+    struct msghdr *hdr = &batch->hdrs[j].msg_hdr;
+
+    hdr->msg_name = want_saddr ? &batch->addrs[j] : NULL;
+    hdr->msg_namelen = want_saddr ? sizeof (struct sockaddr_storage) : 0;
+    hdr->msg_iov = &batch->iovs[2 * j];
+    hdr->msg_iovlen = 2;
+    hdr->msg_control =
+        want_msgs ? batch->control + j * UDP_BATCH_CONTROL_SIZE : NULL;
+    hdr->msg_controllen = want_msgs ? UDP_BATCH_CONTROL_SIZE : 0;
+    hdr->msg_flags = 0;
+    batch->hdrs[j].msg_len = 0;
+  }
+
+  /* the socket was reported readable, so this returns at least one packet
+   * unless it was consumed by somebody else in the meantime */
+  do {
+    n_received = recvmmsg (fd, batch->hdrs, batch->size, MSG_DONTWAIT, NULL);
+    errsv = errno;
+  } while (G_UNLIKELY (n_received < 0 && errsv == EINTR));
+
+  gst_udpsrc_batch_unmap (batch, batch->size);
+
+  if (G_UNLIKELY (n_received < 0)) {
+    /* ECONNREFUSED is the "port unreachable" ICMP response case that
+     * gst_udpsrc_fill() ignores too */
+    if (errsv == EAGAIN || errsv == EWOULDBLOCK || errsv == ECONNREFUSED)
+      goto retry;
+    goto receive_error;
+  }
+
+  if (gst_base_src_get_do_timestamp (GST_BASE_SRC_CAST (udpsrc)))
+    capture_time = gst_udpsrc_get_running_time (udpsrc);
+  else
+    capture_time = GST_CLOCK_TIME_NONE;
+
+  for (i = 0; i < n_received; i++) {
+    GstBuffer *outbuf = batch->buffers[i];
+    struct msghdr *hdr = &batch->hdrs[i].msg_hdr;
+    gsize res = batch->hdrs[i].msg_len;
+
+    GST_BUFFER_DTS (outbuf) = capture_time;
+
+    if (want_msgs) {
+      GSocketControlMessage *msgs[UDP_BATCH_MAX_CONTROL_MESSAGES];
+      struct cmsghdr *cmsg;
+      gboolean skip_packet;
+      gint n_msgs = 0, k;
+
+      for (cmsg = CMSG_FIRSTHDR (hdr); cmsg; cmsg = CMSG_NXTHDR (hdr, cmsg)) {
+        GSocketControlMessage *msg;
+
+        if (n_msgs == G_N_ELEMENTS (msgs))
+          break;
+
+        msg = g_socket_control_message_deserialize (cmsg->cmsg_level,
+            cmsg->cmsg_type,
+            cmsg->cmsg_len - ((guint8 *) CMSG_DATA (cmsg) - (guint8 *) cmsg),
+            CMSG_DATA (cmsg));
+        if (msg != NULL)
+          msgs[n_msgs++] = msg;
+      }
+
+      skip_packet =
+          gst_udpsrc_process_control_messages (udpsrc, outbuf, msgs, n_msgs);
+
+      for (k = 0; k < n_msgs; k++)
+        g_object_unref (msgs[k]);
+
+      if (skip_packet) {
+        GST_DEBUG_OBJECT (udpsrc,
+            "Dropping packet for a different multicast address");
+        continue;
+      }
+    }
+
+    GST_BUFFER_PTS (outbuf) = GST_BUFFER_DTS (outbuf);
+
+    if (res > udpsrc->mtu) {
+      gst_buffer_append_memory (outbuf, batch->extra_mem[i]);
+      batch->extra_mem[i] = NULL;
+    }
+
+    if (G_UNLIKELY (offset > 0 && res < offset))
+      goto skip_error;
+
+    gst_buffer_resize (outbuf, offset, res - offset);
+
+    /* use buffer metadata so receivers can also track the address */
+    if (want_saddr && hdr->msg_namelen > 0) {
+      GSocketAddress *saddr;
+
+      saddr = g_socket_address_new_from_native (hdr->msg_name,
+          hdr->msg_namelen);
+      if (saddr) {
+        gst_buffer_add_net_address_meta (outbuf, saddr);
+        g_object_unref (saddr);
+      }
+    }
+
+    gst_buffer_list_add (list, outbuf);
+    batch->buffers[i] = NULL;
+  }
+
+  if (gst_buffer_list_length (list) == 0)
+    goto retry;
+
+  GST_LOG_OBJECT (udpsrc, "read %u packets in one batch",
+      gst_buffer_list_length (list));
+
+  gst_base_src_submit_buffer_list (GST_BASE_SRC_CAST (udpsrc), list);
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+wait_failed:
+  {
+    gst_buffer_list_unref (list);
+    return ret;
+  }
+map_error:
+  {
+    gst_buffer_list_unref (list);
+    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+        ("Failed to map memory"));
+    return GST_FLOW_ERROR;
+  }
+receive_error:
+  {
+    gst_buffer_list_unref (list);
+    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+        ("receive error %d: %s", errsv, g_strerror (errsv)));
+    return GST_FLOW_ERROR;
+  }
+skip_error:
+  {
+    gst_buffer_list_unref (list);
+    gst_clear_buffer (&batch->buffers[i]);
+    GST_ELEMENT_ERROR (udpsrc, STREAM, DECODE, (NULL),
+        ("UDP buffer to small to skip header"));
+    return GST_FLOW_ERROR;
+  }
+}
+
+static GstFlowReturn
+gst_udpsrc_create (GstBaseSrc * bsrc, guint64 offset, guint length,
+    GstBuffer ** buf)
+{
+  GstUDPSrc *udpsrc = GST_UDPSRC_CAST (bsrc);
+
+  /* a buffer provided by the caller can only take a single packet */
+  if (udpsrc->batch_size > 1 && *buf == NULL)
+    return gst_udpsrc_create_batch (udpsrc);
+
+  return GST_BASE_SRC_CLASS (parent_class)->create (bsrc, offset, length, buf);
+}
+#endif
+
+static void
+gst_udpsrc_clear_batch (GstUDPSrc * udpsrc)
+{
+#ifdef HAVE_RECVMMSG
+  if (udpsrc->batch) {
+    gst_udpsrc_batch_free (udpsrc->batch);
+    udpsrc->batch = NULL;
+  }
+#endif
+}
+
 static gboolean
 gst_udpsrc_set_uri (GstUDPSrc * src, const gchar * uri, GError ** error)
 {
@@ -1441,6 +1877,9 @@ gst_udpsrc_set_property (GObject * object, guint prop_id, const GValue * value,
       }
       GST_OBJECT_UNLOCK (udpsrc);
       break;
+    case PROP_BATCH_SIZE:
+      udpsrc->batch_size = g_value_get_uint (value);
+      break;
     default:
       break;
   }
@@ -1512,6 +1951,9 @@ gst_udpsrc_get_property (GObject * object, guint prop_id, GValue * value,
       g_value_set_string (value, udpsrc->multicast_source);
       GST_OBJECT_UNLOCK (udpsrc);
       break;
+    case PROP_BATCH_SIZE:
+      g_value_set_uint (value, udpsrc->batch_size);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2085,6 +2527,9 @@ gst_udpsrc_change_state (GstElement * element, GstStateChange transition)
     goto failure;
 
   switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      gst_udpsrc_clear_batch (src);
+      break;
     case GST_STATE_CHANGE_READY_TO_NULL:
       gst_udpsrc_close (src);
       break;
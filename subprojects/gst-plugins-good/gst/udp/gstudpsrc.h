@@ -43,6 +43,7 @@ G_BEGIN_DECLS
 
 typedef struct _GstUDPSrc GstUDPSrc;
 typedef struct _GstUDPSrcClass GstUDPSrcClass;
+typedef struct _GstUDPSrcBatch GstUDPSrcBatch;
 
 
 /**
@@ -98,6 +99,10 @@ struct _GstUDPSrc {
   /* Extra memory for buffers with a size superior to max_packet_size */
   GstMemory *extra_mem;
 
+  /* Packets read per recvmmsg() call and their buffers */
+  guint batch_size;
+  GstUDPSrcBatch *batch;
+
   gchar     *uri;
   GPtrArray *source_list;
 };
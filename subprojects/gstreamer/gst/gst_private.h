@@ -148,6 +148,12 @@ G_GNUC_INTERNAL  void  _priv_gst_meta_cleanup (void);
 /* called from gst_task_cleanup_all(). */
 G_GNUC_INTERNAL  void  _priv_gst_element_cleanup (void);
 
+/* used by GstTask to run cooperatively on a GstWorkStealingTaskPool */
+G_GNUC_INTERNAL
+gboolean _priv_gst_work_stealing_task_pool_yield (GstTaskPool * pool,
+                                                  GstTaskPoolFunction func,
+                                                  gpointer user_data);
+
 /* Private registry functions */
 G_GNUC_INTERNAL
 gboolean _priv_gst_registry_remove_cache_plugins (GstRegistry *registry);
@@ -415,11 +421,16 @@ struct _GstTypeFindFactory {
 
   GstTypeFindFunction           function;
   gchar **                      extensions;
-  GstCaps *                     caps;
+  GstCaps *                     caps;                   /* ATOMIC */
 
   gpointer                      user_data;
   GDestroyNotify                user_data_notify;
 
+  /* caps string in the registry cache kept alive by @cache, parsed on first
+   * use */
+  const gchar *                 caps_string;
+  GBytes *                      cache;
+
   gpointer _gst_reserved[GST_PADDING];
 };
 
@@ -456,7 +467,7 @@ struct _GstElementFactory {
 
   GType                 type;                   /* unique GType of element or 0 if not loaded */
 
-  gpointer              metadata;
+  gpointer              metadata;               /* ATOMIC */
 
   GList *               staticpadtemplates;     /* GstStaticPadTemplate list */
   guint                 numpadtemplates;
@@ -467,6 +478,12 @@ struct _GstElementFactory {
 
   GList *               interfaces;             /* interface type names this element implements */
 
+  /* metadata, klass and pad template caps strings in the registry cache,
+   * kept alive by @cache. The metadata structure is only parsed on first use */
+  const gchar *         metadata_string;
+  const gchar *         klass;
+  GBytes *              cache;
+
   /*< private >*/
   gpointer _gst_reserved[GST_PADDING];
 };
@@ -49,6 +49,23 @@
 #include "glib-compat-private.h"
 #include "gstmemory.h"
 
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
+#if defined(HAVE_SYS_MMAN_H) && defined(MAP_ANONYMOUS)
+#define HAVE_HUGE_PAGES 1
+#include <errno.h>
+#endif
+
+#if defined(HAVE_HUGE_PAGES) && defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#if defined(SYS_getcpu) && defined(SYS_mbind)
+#define HAVE_NUMA_BIND 1
+#endif
+#endif
+
 GST_DEBUG_CATEGORY_STATIC (gst_allocator_debug);
 #define GST_CAT_DEFAULT gst_allocator_debug
 
@@ -590,6 +607,454 @@ gst_allocator_sysmem_init (GstAllocatorSysmem * allocator)
   alloc->mem_is_span = (GstMemoryIsSpanFunction) _sysmem_is_span;
 }
 
+#ifdef HAVE_HUGE_PAGES
+/* huge page memory implementation */
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+/* allocations up to 1 MiB are subdivided from shared huge pages, in blocks
+ * of a power of two size */
+#define SLAB_MIN_SHIFT 16
+#define SLAB_MAX_SHIFT 20
+#define SLAB_N_CLASSES (SLAB_MAX_SHIFT - SLAB_MIN_SHIFT + 1)
+/* below this, a huge page does not make a difference */
+#define HUGE_PAGES_MIN_SIZE (32 * 1024)
+
+#define DEFAULT_NUMA_LOCAL FALSE
+
+enum
+{
+  PROP_0,
+  PROP_NUMA_LOCAL
+};
+
+typedef struct
+{
+  guint8 *data;
+  guint shift;
+  gint node;
+  /* number of blocks in use */
+  guint n_used;
+  /* the blocks that were never used, from here on */
+  guint8 *unused;
+  /* blocks that were freed, linked through their first bytes */
+  gpointer free_list;
+  /* our link in the queue of slabs with free blocks, or NULL when full */
+  GList *link;
+} HugePageSlab;
+
+typedef struct
+{
+  GstMemorySystem mem;
+
+  /* the block that contains the data */
+  guint8 *block;
+  gsize block_size;
+  /* the slab it was taken from, NULL for dedicated pages */
+  HugePageSlab *slab;
+} GstMemoryHugePages;
+
+typedef struct
+{
+  GstAllocator parent;
+
+  gboolean numa_local;
+
+  GMutex lock;
+  /* slabs with free blocks, for each block size */
+  GQueue slabs[SLAB_N_CLASSES];
+} GstAllocatorHugePages;
+
+typedef struct
+{
+  GstAllocatorClass parent_class;
+} GstAllocatorHugePagesClass;
+
+static GType gst_allocator_huge_pages_get_type (void);
+G_DEFINE_TYPE (GstAllocatorHugePages, gst_allocator_huge_pages,
+    GST_TYPE_ALLOCATOR);
+
+#ifdef HAVE_NUMA_BIND
+/* from <numaif.h>, which is part of libnuma */
+#define HUGE_PAGES_MPOL_PREFERRED 1
+
+static gint
+huge_pages_current_node (void)
+{
+  unsigned int cpu, node;
+
+  if (syscall (SYS_getcpu, &cpu, &node, NULL) != 0)
+    return -1;
+
+  return node;
+}
+
+static void
+huge_pages_bind (gpointer data, gsize size, gint node)
+{
+  unsigned long nodemask[4] = { 0, };
+  const guint bits = 8 * sizeof (unsigned long);
+
+  if (node < 0 || (guint) node >= G_N_ELEMENTS (nodemask) * bits)
+    return;
+
+  nodemask[node / bits] = 1UL << (node % bits);
+
+  /* the pages are only allocated when touched, after this */
+  if (syscall (SYS_mbind, data, size, HUGE_PAGES_MPOL_PREFERRED, nodemask,
+          G_N_ELEMENTS (nodemask) * bits + 1, 0) != 0)
+    GST_CAT_DEBUG (GST_CAT_MEMORY, "could not bind %p to node %d: %s", data,
+        node, g_strerror (errno));
+}
+#else
+#define huge_pages_current_node() (-1)
+#define huge_pages_bind(data,size,node) G_STMT_START { } G_STMT_END
+#endif
+
+#ifdef MAP_HUGETLB
+/* without a size, MAP_HUGETLB uses the default huge page size of the system,
+ * which is not necessarily HUGE_PAGE_SIZE */
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+
+/* set when mapping reserved huge pages failed once, usually because none
+ * are reserved, so that not every slab tries again */
+static gint hugetlb_unavailable;
+#endif
+
+/* map @size bytes, a multiple of HUGE_PAGE_SIZE, preferably on @node */
+static guint8 *
+huge_pages_map (gsize size, gint node)
+{
+  guint8 *data = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+  /* reserved huge pages, see /proc/sys/vm/nr_hugepages */
+  if (!g_atomic_int_get (&hugetlb_unavailable)) {
+    data = mmap (NULL, size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+    if (data == MAP_FAILED) {
+      GST_CAT_INFO (GST_CAT_MEMORY, "no reserved huge pages (%s), using "
+          "transparent huge pages from now on", g_strerror (errno));
+      g_atomic_int_set (&hugetlb_unavailable, TRUE);
+    }
+  }
+#endif
+
+  if (data == MAP_FAILED) {
+    gsize head, mapped;
+    guint8 *area;
+
+    /* transparent huge pages need a range that is aligned to them, map more
+     * and trim the excess */
+    mapped = size + HUGE_PAGE_SIZE;
+    area = mmap (NULL, mapped, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (area == MAP_FAILED)
+      goto map_failed;
+
+    head = (HUGE_PAGE_SIZE - ((guintptr) area & (HUGE_PAGE_SIZE - 1)))
+        & (HUGE_PAGE_SIZE - 1);
+    if (head)
+      munmap (area, head);
+    munmap (area + head + size, mapped - head - size);
+    data = area + head;
+
+#ifdef MADV_HUGEPAGE
+    madvise (data, size, MADV_HUGEPAGE);
+#endif
+  }
+
+  if (node >= 0)
+    huge_pages_bind (data, size, node);
+
+  GST_CAT_DEBUG (GST_CAT_MEMORY, "mapped %" G_GSIZE_FORMAT " bytes at %p",
+      size, data);
+
+  return data;
+
+  /* ERRORS */
+map_failed:
+  {
+    GST_CAT_WARNING (GST_CAT_MEMORY, "failed to map %" G_GSIZE_FORMAT
+        " bytes: %s", size, g_strerror (errno));
+    return NULL;
+  }
+}
+
+static void
+huge_pages_unmap (guint8 * data, gsize size)
+{
+  GST_CAT_DEBUG (GST_CAT_MEMORY, "unmapping %" G_GSIZE_FORMAT " bytes at %p",
+      size, data);
+  munmap (data, size);
+}
+
+/* called with the lock */
+static guint8 *
+huge_pages_slab_alloc (GstAllocatorHugePages * allocator, guint shift,
+    gint node, HugePageSlab ** slab_out)
+{
+  GQueue *slabs = &allocator->slabs[shift - SLAB_MIN_SHIFT];
+  HugePageSlab *slab = NULL;
+  guint8 *block;
+  GList *l;
+
+  for (l = slabs->head; l; l = l->next) {
+    HugePageSlab *s = l->data;
+
+    if (node < 0 || s->node == node) {
+      slab = s;
+      break;
+    }
+  }
+
+  if (slab == NULL) {
+    guint8 *data;
+
+    if (!(data = huge_pages_map (HUGE_PAGE_SIZE, node)))
+      return NULL;
+
+    slab = g_new0 (HugePageSlab, 1);
+    slab->data = data;
+    slab->shift = shift;
+    slab->node = node;
+    slab->unused = data;
+    g_queue_push_head (slabs, slab);
+    slab->link = slabs->head;
+  }
+
+  if ((block = slab->free_list)) {
+    slab->free_list = *(gpointer *) block;
+  } else {
+    block = slab->unused;
+    slab->unused += (gsize) 1 << shift;
+  }
+  slab->n_used++;
+
+  /* full, take it out of the queue */
+  if (slab->free_list == NULL && slab->unused == slab->data + HUGE_PAGE_SIZE) {
+    g_queue_delete_link (slabs, slab->link);
+    slab->link = NULL;
+  }
+
+  *slab_out = slab;
+
+  return block;
+}
+
+/* called with the lock */
+static void
+huge_pages_slab_free (GstAllocatorHugePages * allocator, HugePageSlab * slab,
+    guint8 * block)
+{
+  GQueue *slabs = &allocator->slabs[slab->shift - SLAB_MIN_SHIFT];
+
+  *(gpointer *) block = slab->free_list;
+  slab->free_list = block;
+  slab->n_used--;
+
+  if (slab->link == NULL) {
+    g_queue_push_head (slabs, slab);
+    slab->link = slabs->head;
+  }
+
+  /* keep one empty slab around to avoid mapping and unmapping all the time */
+  if (slab->n_used == 0 && slabs->length > 1) {
+    g_queue_delete_link (slabs, slab->link);
+    huge_pages_unmap (slab->data, HUGE_PAGE_SIZE);
+    g_free (slab);
+  }
+}
+
+static GstMemory *
+huge_pages_alloc (GstAllocator * allocator, gsize size,
+    GstAllocationParams * params)
+{
+  GstAllocatorHugePages *self = (GstAllocatorHugePages *) allocator;
+  GstMemoryHugePages *mem;
+  gsize maxsize, align, aoffset, padding;
+  guint8 *data;
+  gint node;
+
+  align = params->align | gst_memory_alignment;
+  /* allocate more to compensate for alignment */
+  maxsize = size + params->prefix + params->padding + align;
+
+  /* this memory belongs to the system allocator */
+  if (maxsize < HUGE_PAGES_MIN_SIZE)
+    return default_alloc (allocator, size, params);
+
+  node = g_atomic_int_get (&self->numa_local) ? huge_pages_current_node () :
+      -1;
+
+  mem = g_new (GstMemoryHugePages, 1);
+  if (maxsize <= ((gsize) 1 << SLAB_MAX_SHIFT)) {
+    guint shift = MAX (g_bit_storage (maxsize - 1), SLAB_MIN_SHIFT);
+
+    g_mutex_lock (&self->lock);
+    mem->block = huge_pages_slab_alloc (self, shift, node, &mem->slab);
+    g_mutex_unlock (&self->lock);
+    mem->block_size = (gsize) 1 << shift;
+  } else {
+    mem->block_size = (maxsize + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    mem->block = huge_pages_map (mem->block_size, node);
+    mem->slab = NULL;
+  }
+
+  if (mem->block == NULL) {
+    g_free (mem);
+    return NULL;
+  }
+
+  data = mem->block;
+  maxsize = mem->block_size;
+
+  /* do alignment */
+  if ((aoffset = ((guintptr) data & align))) {
+    aoffset = (align + 1) - aoffset;
+    data += aoffset;
+    maxsize -= aoffset;
+  }
+
+  /* recycled blocks are not zeroed */
+  if (params->prefix && (params->flags & GST_MEMORY_FLAG_ZERO_PREFIXED))
+    memset (data, 0, params->prefix);
+
+  padding = maxsize - (params->prefix + size);
+  if (padding && (params->flags & GST_MEMORY_FLAG_ZERO_PADDED))
+    memset (data + params->prefix + size, 0, padding);
+
+  gst_memory_init (GST_MEMORY_CAST (mem), params->flags, allocator, NULL,
+      maxsize, align, params->prefix, size);
+
+  mem->mem.data = data;
+  mem->mem.user_data = NULL;
+  mem->mem.notify = NULL;
+
+  return GST_MEMORY_CAST (mem);
+}
+
+static void
+huge_pages_free (GstAllocator * allocator, GstMemory * memory)
+{
+  GstAllocatorHugePages *self = (GstAllocatorHugePages *) allocator;
+  GstMemoryHugePages *mem = (GstMemoryHugePages *) memory;
+
+  if (mem->slab) {
+    g_mutex_lock (&self->lock);
+    huge_pages_slab_free (self, mem->slab, mem->block);
+    g_mutex_unlock (&self->lock);
+  } else {
+    huge_pages_unmap (mem->block, mem->block_size);
+  }
+
+#ifdef USE_POISONING
+  memset (mem, 0xff, sizeof (GstMemoryHugePages));
+#endif
+
+  g_free (mem);
+}
+
+static void
+gst_allocator_huge_pages_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstAllocatorHugePages *self = (GstAllocatorHugePages *) object;
+
+  switch (prop_id) {
+    case PROP_NUMA_LOCAL:
+      g_atomic_int_set (&self->numa_local, g_value_get_boolean (value));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_allocator_huge_pages_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstAllocatorHugePages *self = (GstAllocatorHugePages *) object;
+
+  switch (prop_id) {
+    case PROP_NUMA_LOCAL:
+      g_value_set_boolean (value, g_atomic_int_get (&self->numa_local));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_allocator_huge_pages_finalize (GObject * obj)
+{
+  GstAllocatorHugePages *self = (GstAllocatorHugePages *) obj;
+  guint i;
+
+  /* all memory keeps a ref to us, so the slabs are all empty now */
+  for (i = 0; i < SLAB_N_CLASSES; i++) {
+    HugePageSlab *slab;
+
+    while ((slab = g_queue_pop_head (&self->slabs[i]))) {
+      huge_pages_unmap (slab->data, HUGE_PAGE_SIZE);
+      g_free (slab);
+    }
+  }
+  g_mutex_clear (&self->lock);
+
+  ((GObjectClass *) gst_allocator_huge_pages_parent_class)->finalize (obj);
+}
+
+static void
+gst_allocator_huge_pages_class_init (GstAllocatorHugePagesClass * klass)
+{
+  GObjectClass *gobject_class;
+  GstAllocatorClass *allocator_class;
+
+  gobject_class = (GObjectClass *) klass;
+  allocator_class = (GstAllocatorClass *) klass;
+
+  gobject_class->set_property = gst_allocator_huge_pages_set_property;
+  gobject_class->get_property = gst_allocator_huge_pages_get_property;
+  gobject_class->finalize = gst_allocator_huge_pages_finalize;
+
+  g_object_class_install_property (gobject_class, PROP_NUMA_LOCAL,
+      g_param_spec_boolean ("numa-local", "NUMA local",
+          "Allocate new pages on the NUMA node of the allocating thread",
+          DEFAULT_NUMA_LOCAL, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  allocator_class->alloc = huge_pages_alloc;
+  allocator_class->free = huge_pages_free;
+}
+
+static void
+gst_allocator_huge_pages_init (GstAllocatorHugePages * allocator)
+{
+  GstAllocator *alloc = GST_ALLOCATOR_CAST (allocator);
+  guint i;
+
+  GST_CAT_DEBUG (GST_CAT_MEMORY, "init allocator %p", allocator);
+
+  allocator->numa_local = DEFAULT_NUMA_LOCAL;
+  g_mutex_init (&allocator->lock);
+  for (i = 0; i < SLAB_N_CLASSES; i++)
+    g_queue_init (&allocator->slabs[i]);
+
+  /* this is system memory, only allocated differently */
+  alloc->mem_type = GST_ALLOCATOR_SYSMEM;
+  alloc->mem_map = (GstMemoryMapFunction) _sysmem_map;
+  alloc->mem_unmap = (GstMemoryUnmapFunction) _sysmem_unmap;
+  alloc->mem_copy = (GstMemoryCopyFunction) _sysmem_copy;
+  alloc->mem_share = (GstMemoryShareFunction) _sysmem_share;
+  alloc->mem_is_span = (GstMemoryIsSpanFunction) _sysmem_is_span;
+}
+#endif /* HAVE_HUGE_PAGES */
+
 void
 _priv_gst_allocator_initialize (void)
 {
@@ -615,6 +1080,16 @@ _priv_gst_allocator_initialize (void)
       gst_object_ref (_sysmem_allocator));
 
   _default_allocator = gst_object_ref (_sysmem_allocator);
+
+#ifdef HAVE_HUGE_PAGES
+  {
+    GstAllocator *huge_pages;
+
+    huge_pages = g_object_new (gst_allocator_huge_pages_get_type (), NULL);
+    gst_object_ref_sink (huge_pages);
+    gst_allocator_register (GST_ALLOCATOR_HUGE_PAGES, huge_pages);
+  }
+#endif
 }
 
 void
@@ -62,6 +62,25 @@ GST_API gsize gst_memory_alignment;
  */
 #define GST_ALLOCATOR_SYSMEM   "SystemMemory"
 
+/**
+ * GST_ALLOCATOR_HUGE_PAGES:
+ *
+ * The allocator name for the huge page system memory allocator. It is only
+ * registered on platforms that support it and can be retrieved with
+ * gst_allocator_find().
+ *
+ * The memory it allocates is system memory backed by 2 MiB pages, either
+ * reserved huge pages or transparent huge pages, which reduces TLB misses
+ * when processing large buffers such as raw video frames. Smaller
+ * allocations are subdivided from shared huge pages.
+ *
+ * When its "numa-local" property is %TRUE, new pages are preferably
+ * allocated on the NUMA node of the thread that does the allocation.
+ *
+ * Since: 1.26
+ */
+#define GST_ALLOCATOR_HUGE_PAGES   "HugePageMemory"
+
 /**
  * GstAllocationParams:
  * @flags: flags to control allocation
@@ -141,6 +141,7 @@
 
 #include "gstutils.h"
 #include "gstchildproxy.h"
+#include "gsttaskpool.h"
 
 GST_DEBUG_CATEGORY_STATIC (bin_debug);
 #define GST_CAT_DEFAULT bin_debug
@@ -172,6 +173,10 @@ struct _GstBinPrivate
   gboolean posted_eos;
   gboolean posted_playing;
   GstElementFlags suppressed_flags;
+
+  /* protected by the object lock */
+  guint state_change_threads;
+  GstTaskPool *state_change_pool;
 };
 
 typedef struct
@@ -246,12 +251,14 @@ enum
 
 #define DEFAULT_ASYNC_HANDLING	FALSE
 #define DEFAULT_MESSAGE_FORWARD	FALSE
+#define DEFAULT_STATE_CHANGE_THREADS	1
 
 enum
 {
   PROP_0,
   PROP_ASYNC_HANDLING,
   PROP_MESSAGE_FORWARD,
+  PROP_STATE_CHANGE_THREADS,
   PROP_LAST
 };
 
@@ -445,6 +452,29 @@ gst_bin_class_init (GstBinClass * klass)
           "Forwards all children messages",
           DEFAULT_MESSAGE_FORWARD, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstBin:state-change-threads:
+   *
+   * Maximum number of threads used to change the state of the children. The
+   * children are still changed from the sinks to the sources, but those that
+   * don't depend on each other, like the sources of many independent
+   * branches, are changed concurrently. This helps when many children block
+   * in their state change, e.g. to open a device or a socket. With 1 all the
+   * children are changed in turn from the thread changing the state of the
+   * bin, 0 uses as many threads as there are processors.
+   *
+   * Children must then not expect their state to be changed from the thread
+   * that called gst_element_set_state() on the bin.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_STATE_CHANGE_THREADS,
+      g_param_spec_uint ("state-change-threads", "State change threads",
+          "Maximum number of threads used to change the state of the "
+          "children (0 = number of processors, 1 = calling thread)",
+          0, G_MAXUINT, DEFAULT_STATE_CHANGE_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gobject_class->dispose = gst_bin_dispose;
 
   gst_element_class_set_static_metadata (gstelement_class, "Generic bin",
@@ -504,6 +534,7 @@ gst_bin_init (GstBin * bin)
   bin->priv->asynchandling = DEFAULT_ASYNC_HANDLING;
   bin->priv->structure_cookie = 0;
   bin->priv->message_forward = DEFAULT_MESSAGE_FORWARD;
+  bin->priv->state_change_threads = DEFAULT_STATE_CHANGE_THREADS;
 }
 
 static void
@@ -513,6 +544,7 @@ gst_bin_dispose (GObject * object)
   GstBus **child_bus_p = &bin->child_bus;
   GstClock **provided_clock_p = &bin->provided_clock;
   GstElement **clock_provider_p = &bin->clock_provider;
+  GstTaskPool *pool;
 
   GST_CAT_DEBUG_OBJECT (GST_CAT_REFCOUNTING, object, "%p dispose", object);
 
@@ -521,8 +553,15 @@ gst_bin_dispose (GObject * object)
   gst_object_replace ((GstObject **) provided_clock_p, NULL);
   gst_object_replace ((GstObject **) clock_provider_p, NULL);
   bin_remove_messages (bin, NULL, GST_MESSAGE_ANY);
+  pool = bin->priv->state_change_pool;
+  bin->priv->state_change_pool = NULL;
   GST_OBJECT_UNLOCK (object);
 
+  if (pool) {
+    gst_task_pool_cleanup (pool);
+    gst_object_unref (pool);
+  }
+
   while (bin->children) {
     gst_bin_remove (bin, GST_ELEMENT_CAST (bin->children->data));
   }
@@ -548,6 +587,16 @@ gst_bin_new (const gchar * name)
   return gst_element_factory_make ("bin", name);
 }
 
+/* with the object lock */
+static guint
+gst_bin_n_state_change_threads_unlocked (GstBin * bin)
+{
+  if (bin->priv->state_change_threads == 0)
+    return g_get_num_processors ();
+
+  return bin->priv->state_change_threads;
+}
+
 static void
 gst_bin_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
@@ -567,6 +616,15 @@ gst_bin_set_property (GObject * object, guint prop_id,
       gstbin->priv->message_forward = g_value_get_boolean (value);
       GST_OBJECT_UNLOCK (gstbin);
       break;
+    case PROP_STATE_CHANGE_THREADS:
+      GST_OBJECT_LOCK (gstbin);
+      gstbin->priv->state_change_threads = g_value_get_uint (value);
+      if (gstbin->priv->state_change_pool)
+        gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL
+            (gstbin->priv->state_change_pool),
+            gst_bin_n_state_change_threads_unlocked (gstbin));
+      GST_OBJECT_UNLOCK (gstbin);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -592,6 +650,11 @@ gst_bin_get_property (GObject * object, guint prop_id,
       g_value_set_boolean (value, gstbin->priv->message_forward);
       GST_OBJECT_UNLOCK (gstbin);
       break;
+    case PROP_STATE_CHANGE_THREADS:
+      GST_OBJECT_LOCK (gstbin);
+      g_value_set_uint (value, gstbin->priv->state_change_threads);
+      GST_OBJECT_UNLOCK (gstbin);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2414,6 +2477,52 @@ gst_bin_sort_iterator_new (GstBin * bin)
   return (GstIterator *) result;
 }
 
+/* Gets the next children of the sorted iterator @it whose state can be changed
+ * concurrently into @children. These are the elements that were queued
+ * together, as all their downstream peers have been handled. Without
+ * @parallel, only one child is returned. The children are only valid until
+ * the next call, the return value is the one of the last
+ * gst_iterator_next(). */
+static GstIteratorResult
+gst_bin_sort_iterator_next_level (GstIterator * it, gboolean parallel,
+    GPtrArray * children)
+{
+  GstBinSortIterator *bit = (GstBinSortIterator *) it;
+  GValue data = G_VALUE_INIT;
+  GstIteratorResult res;
+  gpointer *level = NULL;
+  guint n_level = 0;
+  GList *l;
+
+  /* the queue is only modified by the iterator functions, which are called
+   * from this thread */
+  if (parallel && bit->queue.length > 1) {
+    level = g_new (gpointer, bit->queue.length);
+    for (l = bit->queue.head; l; l = l->next)
+      level[n_level++] = l->data;
+  }
+
+  while (TRUE) {
+    res = gst_iterator_next (it, &data);
+    if (res != GST_ITERATOR_OK)
+      break;
+
+    g_ptr_array_add (children, g_value_dup_object (&data));
+    g_value_reset (&data);
+
+    /* handling an element queues its upstream peers and removes the elements
+     * from the queue that turned out not to be sinks, stop at the first one
+     * that wasn't queued together with the others */
+    if (children->len >= n_level ||
+        g_queue_peek_head (&bit->queue) != level[children->len])
+      break;
+  }
+  g_value_unset (&data);
+  g_free (level);
+
+  return res;
+}
+
 /**
  * gst_bin_iterate_sorted:
  * @bin: a #GstBin
@@ -2817,6 +2926,134 @@ reset_state (const GValue * data, gpointer user_data)
         gst_element_state_get_name (state));
 }
 
+typedef struct
+{
+  GstBin *bin;
+  GstElement *child;
+  GstClockTime base_time;
+  GstClockTime start_time;
+  GstState current;
+  GstState next;
+  GstStateChangeReturn ret;
+} BinChildStateChange;
+
+static void
+bin_child_change_state (BinChildStateChange * change)
+{
+  change->ret = gst_bin_element_set_state (change->bin, change->child,
+      change->base_time, change->start_time, change->current, change->next);
+}
+
+/* Changes the state of @children, concurrently on @pool if there is one, and
+ * returns the results once all the children are done. */
+static BinChildStateChange *
+gst_bin_children_set_state (GstBin * bin, GstTaskPool * pool,
+    GPtrArray * children, GstClockTime base_time, GstClockTime start_time,
+    GstState current, GstState next)
+{
+  BinChildStateChange *changes;
+  gpointer *ids;
+  guint i;
+
+  changes = g_new (BinChildStateChange, children->len);
+  for (i = 0; i < children->len; i++) {
+    changes[i].bin = bin;
+    changes[i].child = g_ptr_array_index (children, i);
+    changes[i].base_time = base_time;
+    changes[i].start_time = start_time;
+    changes[i].current = current;
+    changes[i].next = next;
+  }
+
+  if (pool == NULL || children->len == 1) {
+    for (i = 0; i < children->len; i++)
+      bin_child_change_state (&changes[i]);
+    return changes;
+  }
+
+  GST_CAT_DEBUG_OBJECT (GST_CAT_STATES, bin,
+      "changing the state of %u children in parallel", children->len);
+
+  /* the first child is changed by this thread while the others are on the
+   * pool */
+  ids = g_new0 (gpointer, children->len);
+  for (i = 1; i < children->len; i++) {
+    ids[i] = gst_task_pool_push (pool,
+        (GstTaskPoolFunction) bin_child_change_state, &changes[i], NULL);
+    if (!ids[i])
+      bin_child_change_state (&changes[i]);
+  }
+  bin_child_change_state (&changes[0]);
+  for (i = 1; i < children->len; i++)
+    gst_task_pool_join (pool, ids[i]);
+  g_free (ids);
+
+  return changes;
+}
+
+/* returns FALSE when the bin has to undo its state change */
+static gboolean
+gst_bin_child_state_changed (GstBin * bin, BinChildStateChange * change,
+    gboolean * have_async, gboolean * have_no_preroll)
+{
+  GstElement *child = change->child;
+  GstState next = change->next;
+
+  switch (change->ret) {
+    case GST_STATE_CHANGE_SUCCESS:
+      GST_CAT_INFO_OBJECT (GST_CAT_STATES, bin,
+          "child '%s' changed state to %d(%s) successfully",
+          GST_ELEMENT_NAME (child), next, gst_element_state_get_name (next));
+      break;
+    case GST_STATE_CHANGE_ASYNC:
+    {
+      GST_CAT_INFO_OBJECT (GST_CAT_STATES, bin,
+          "child '%s' is changing state asynchronously to %s",
+          GST_ELEMENT_NAME (child), gst_element_state_get_name (next));
+      *have_async = TRUE;
+      break;
+    }
+    case GST_STATE_CHANGE_FAILURE:{
+      GstObject *parent;
+
+      GST_CAT_INFO_OBJECT (GST_CAT_STATES, bin,
+          "child '%s' failed to go to state %d(%s)",
+          GST_ELEMENT_NAME (child), next, gst_element_state_get_name (next));
+
+      /* Only fail if the child is still inside
+       * this bin. It might've been removed already
+       * because of the error by the bin subclass
+       * to ignore the error.  */
+      parent = gst_object_get_parent (GST_OBJECT_CAST (child));
+      if (parent == GST_OBJECT_CAST (bin)) {
+        /* element is still in bin, really error now */
+        gst_object_unref (parent);
+        return FALSE;
+      }
+      /* child removed from bin, let the resync code redo the state
+       * change */
+      GST_CAT_INFO_OBJECT (GST_CAT_STATES, bin,
+          "child '%s' was removed from the bin", GST_ELEMENT_NAME (child));
+
+      if (parent)
+        gst_object_unref (parent);
+
+      break;
+    }
+    case GST_STATE_CHANGE_NO_PREROLL:
+      GST_CAT_INFO_OBJECT (GST_CAT_STATES, bin,
+          "child '%s' changed state to %d(%s) successfully without preroll",
+          GST_ELEMENT_NAME (child), next, gst_element_state_get_name (next));
+      *have_no_preroll = TRUE;
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+
+  return TRUE;
+}
+
 static GstStateChangeReturn
 gst_bin_change_state_func (GstElement * element, GstStateChange transition)
 {
@@ -2827,8 +3064,12 @@ gst_bin_change_state_func (GstElement * element, GstStateChange transition)
   gboolean have_no_preroll;
   GstClockTime base_time, start_time;
   GstIterator *it;
+  GstIteratorResult res;
+  GstTaskPool *pool = NULL;
+  GPtrArray *children;
+  BinChildStateChange *changes;
   gboolean done;
-  GValue data = { 0, };
+  guint i;
 
   /* we don't need to take the STATE_LOCK, it is already taken */
   current = (GstState) GST_STATE_TRANSITION_CURRENT (transition);
@@ -2903,8 +3144,20 @@ gst_bin_change_state_func (GstElement * element, GstStateChange transition)
    * don't want them to interfere with this state change */
   GST_OBJECT_LOCK (bin);
   bin->polling = TRUE;
+  if (gst_bin_n_state_change_threads_unlocked (bin) > 1) {
+    if (!bin->priv->state_change_pool) {
+      bin->priv->state_change_pool = gst_shared_task_pool_new ();
+      gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL
+          (bin->priv->state_change_pool),
+          gst_bin_n_state_change_threads_unlocked (bin));
+      gst_task_pool_prepare (bin->priv->state_change_pool, NULL);
+    }
+    pool = gst_object_ref (bin->priv->state_change_pool);
+  }
   GST_OBJECT_UNLOCK (bin);
 
+  children = g_ptr_array_new_with_free_func ((GDestroyNotify) gst_object_unref);
+
   /* iterate in state change order */
   it = gst_bin_iterate_sorted (bin);
 
@@ -2923,75 +3176,31 @@ restart:
 
   done = FALSE;
   while (!done) {
-    switch (gst_iterator_next (it, &data)) {
-      case GST_ITERATOR_OK:
-      {
-        GstElement *child;
-
-        child = g_value_get_object (&data);
-
-        /* set state and base_time now */
-        ret = gst_bin_element_set_state (bin, child, base_time, start_time,
-            current, next);
-
-        switch (ret) {
-          case GST_STATE_CHANGE_SUCCESS:
-            GST_CAT_INFO_OBJECT (GST_CAT_STATES, element,
-                "child '%s' changed state to %d(%s) successfully",
-                GST_ELEMENT_NAME (child), next,
-                gst_element_state_get_name (next));
-            break;
-          case GST_STATE_CHANGE_ASYNC:
-          {
-            GST_CAT_INFO_OBJECT (GST_CAT_STATES, element,
-                "child '%s' is changing state asynchronously to %s",
-                GST_ELEMENT_NAME (child), gst_element_state_get_name (next));
-            have_async = TRUE;
-            break;
-          }
-          case GST_STATE_CHANGE_FAILURE:{
-            GstObject *parent;
-
-            GST_CAT_INFO_OBJECT (GST_CAT_STATES, element,
-                "child '%s' failed to go to state %d(%s)",
-                GST_ELEMENT_NAME (child),
-                next, gst_element_state_get_name (next));
-
-            /* Only fail if the child is still inside
-             * this bin. It might've been removed already
-             * because of the error by the bin subclass
-             * to ignore the error.  */
-            parent = gst_object_get_parent (GST_OBJECT_CAST (child));
-            if (parent == GST_OBJECT_CAST (element)) {
-              /* element is still in bin, really error now */
-              gst_object_unref (parent);
-              goto undo;
-            }
-            /* child removed from bin, let the resync code redo the state
-             * change */
-            GST_CAT_INFO_OBJECT (GST_CAT_STATES, element,
-                "child '%s' was removed from the bin",
-                GST_ELEMENT_NAME (child));
+    res = gst_bin_sort_iterator_next_level (it, pool != NULL, children);
+
+    if (children->len > 0) {
+      gboolean failed = FALSE;
+
+      /* set state and base_time now */
+      changes = gst_bin_children_set_state (bin, pool, children, base_time,
+          start_time, current, next);
+      for (i = 0; i < children->len; i++) {
+        if (!gst_bin_child_state_changed (bin, &changes[i], &have_async,
+                &have_no_preroll))
+          failed = TRUE;
+      }
+      g_free (changes);
+      g_ptr_array_set_size (children, 0);
 
-            if (parent)
-              gst_object_unref (parent);
+      if (failed) {
+        ret = GST_STATE_CHANGE_FAILURE;
+        goto undo;
+      }
+    }
 
-            break;
-          }
-          case GST_STATE_CHANGE_NO_PREROLL:
-            GST_CAT_INFO_OBJECT (GST_CAT_STATES, element,
-                "child '%s' changed state to %d(%s) successfully without preroll",
-                GST_ELEMENT_NAME (child), next,
-                gst_element_state_get_name (next));
-            have_no_preroll = TRUE;
-            break;
-          default:
-            g_assert_not_reached ();
-            break;
-        }
-        g_value_reset (&data);
+    switch (res) {
+      case GST_ITERATOR_OK:
         break;
-      }
       case GST_ITERATOR_RESYNC:
         GST_CAT_DEBUG_OBJECT (GST_CAT_STATES, element, "iterator doing resync");
         gst_iterator_resync (it);
@@ -3021,8 +3230,10 @@ restart:
   }
 
 done:
-  g_value_unset (&data);
+  g_ptr_array_unref (children);
   gst_iterator_free (it);
+  if (pool)
+    gst_object_unref (pool);
 
   GST_OBJECT_LOCK (bin);
   bin->polling = FALSE;
@@ -64,36 +64,37 @@
 #include "gst_private.h"
 #include "glib-compat-private.h"
 
-#include <errno.h>
-#ifdef HAVE_UNISTD_H
-#  include <unistd.h>
-#endif
-#include <sys/types.h>
-
 #include "gstatomicqueue.h"
-#include "gstpoll.h"
 #include "gstinfo.h"
 #include "gstquark.h"
 #include "gstvalue.h"
 
 #include "gstbufferpool.h"
 
-#ifdef G_OS_WIN32
-#  ifndef EWOULDBLOCK
-#  define EWOULDBLOCK EAGAIN    /* This is just to placate gcc */
-#  endif
-#endif /* G_OS_WIN32 */
-
 GST_DEBUG_CATEGORY_STATIC (gst_buffer_pool_debug);
 #define GST_CAT_DEFAULT gst_buffer_pool_debug
 
 #define GST_BUFFER_POOL_LOCK(pool)   (g_rec_mutex_lock(&pool->priv->rec_lock))
 #define GST_BUFFER_POOL_UNLOCK(pool) (g_rec_mutex_unlock(&pool->priv->rec_lock))
 
+/* number of slots for recently released buffers */
+#define CACHE_SLOTS 16
+
 struct _GstBufferPoolPrivate
 {
   GstAtomicQueue *queue;
-  GstPoll *poll;
+
+  /* free buffers indexed by a hash of the thread that released them, so that
+   * a thread acquiring right after releasing gets back a cache-hot buffer
+   * without going through the queue */
+  GstBuffer *cache[CACHE_SLOTS];        /* ATOMIC */
+
+  /* waiting for a free buffer. The mutex is only taken when the pool is
+   * exhausted and somebody actually has to wait */
+  GMutex wait_lock;
+  GCond wait_cond;
+  gint waiters;                 /* ATOMIC */
+  gint release_seqnum;          /* ATOMIC, bumped on release and flush */
 
   GRecMutex rec_lock;
 
@@ -158,8 +159,9 @@ gst_buffer_pool_init (GstBufferPool * pool)
   priv = pool->priv = gst_buffer_pool_get_instance_private (pool);
 
   g_rec_mutex_init (&priv->rec_lock);
+  g_mutex_init (&priv->wait_lock);
+  g_cond_init (&priv->wait_cond);
 
-  priv->poll = gst_poll_new_timer ();
   priv->queue = gst_atomic_queue_new (16);
   pool->flushing = 1;
   priv->active = FALSE;
@@ -171,10 +173,6 @@ gst_buffer_pool_init (GstBufferPool * pool)
   gst_allocation_params_init (&priv->params);
   gst_buffer_pool_config_set_allocator (priv->config, priv->allocator,
       &priv->params);
-  /* 1 control write for flushing - the flush token */
-  gst_poll_write_control (priv->poll);
-  /* 1 control write for marking that we are not waiting for poll - the wait token */
-  gst_poll_write_control (priv->poll);
 
   GST_DEBUG_OBJECT (pool, "created");
 }
@@ -208,9 +206,10 @@ gst_buffer_pool_finalize (GObject * object)
   GST_DEBUG_OBJECT (pool, "%p finalize", pool);
 
   gst_atomic_queue_unref (priv->queue);
-  gst_poll_free (priv->poll);
   gst_structure_free (priv->config);
   g_rec_mutex_clear (&priv->rec_lock);
+  g_mutex_clear (&priv->wait_lock);
+  g_cond_clear (&priv->wait_cond);
 
   G_OBJECT_CLASS (gst_buffer_pool_parent_class)->finalize (object);
 }
@@ -262,6 +261,62 @@ mark_meta_pooled (GstBuffer * buffer, GstMeta ** meta, gpointer user_data)
   return TRUE;
 }
 
+static inline guint
+cache_slot_for_thread (void)
+{
+  return (GPOINTER_TO_SIZE (g_thread_self ()) >> 4) % CACHE_SLOTS;
+}
+
+static inline GstBuffer *
+take_cached_buffer (GstBufferPoolPrivate * priv, guint slot)
+{
+  GstBuffer *buffer;
+
+  buffer = g_atomic_pointer_get (&priv->cache[slot]);
+  if (buffer
+      && g_atomic_pointer_compare_and_exchange (&priv->cache[slot], buffer,
+          NULL))
+    return buffer;
+
+  return NULL;
+}
+
+/* takes a free buffer, preferring the one last released by this thread */
+static GstBuffer *
+pop_free_buffer (GstBufferPoolPrivate * priv)
+{
+  GstBuffer *buffer;
+  guint slot, i;
+
+  slot = cache_slot_for_thread ();
+  if ((buffer = take_cached_buffer (priv, slot)))
+    return buffer;
+
+  if ((buffer = gst_atomic_queue_pop (priv->queue)))
+    return buffer;
+
+  for (i = 1; i < CACHE_SLOTS; i++) {
+    if ((buffer = take_cached_buffer (priv, (slot + i) % CACHE_SLOTS)))
+      return buffer;
+  }
+
+  return NULL;
+}
+
+/* called after a buffer was released or freed and when flushing. Only goes
+ * through the mutex when a thread waits for a buffer */
+static void
+wake_waiters (GstBufferPoolPrivate * priv)
+{
+  g_atomic_int_inc (&priv->release_seqnum);
+
+  if (g_atomic_int_get (&priv->waiters) > 0) {
+    g_mutex_lock (&priv->wait_lock);
+    g_cond_broadcast (&priv->wait_cond);
+    g_mutex_unlock (&priv->wait_lock);
+  }
+}
+
 static GstFlowReturn
 do_alloc_buffer (GstBufferPool * pool, GstBuffer ** buffer,
     GstBufferPoolAcquireParams * params)
@@ -407,20 +462,9 @@ default_stop (GstBufferPool * pool)
   GstBuffer *buffer;
 
   /* clear the pool */
-  while ((buffer = gst_atomic_queue_pop (priv->queue))) {
-    while (!gst_poll_read_control (priv->poll)) {
-      if (errno == EWOULDBLOCK) {
-        /* We put the buffer into the queue but did not finish writing control
-         * yet, let's wait a bit and retry */
-        g_thread_yield ();
-        continue;
-      } else {
-        /* Critical error but GstPoll already complained */
-        break;
-      }
-    }
+  while ((buffer = pop_free_buffer (priv)))
     do_free_buffer (pool, buffer);
-  }
+
   return priv->cur_buffers == 0;
 }
 
@@ -459,8 +503,8 @@ do_set_flushing (GstBufferPool * pool, gboolean flushing)
 
   if (flushing) {
     g_atomic_int_set (&pool->flushing, 1);
-    /* Write the flush token to wake up any waiters */
-    gst_poll_write_control (priv->poll);
+    /* wake up any waiters */
+    wake_waiters (priv);
 
     if (pclass->flush_start)
       pclass->flush_start (pool);
@@ -468,19 +512,6 @@ do_set_flushing (GstBufferPool * pool, gboolean flushing)
     if (pclass->flush_stop)
       pclass->flush_stop (pool);
 
-    while (!gst_poll_read_control (priv->poll)) {
-      if (errno == EWOULDBLOCK) {
-        /* This should not really happen unless flushing and unflushing
-         * happens on different threads. Let's wait a bit to get back flush
-         * token from the thread that was setting it to flushing */
-        g_thread_yield ();
-        continue;
-      } else {
-        /* Critical error but GstPoll already complained */
-        break;
-      }
-    }
-
     g_atomic_int_set (&pool->flushing, 0);
   }
 }
@@ -1113,23 +1144,16 @@ default_acquire_buffer (GstBufferPool * pool, GstBuffer ** buffer,
   GstBufferPoolPrivate *priv = pool->priv;
 
   while (TRUE) {
+    gint seqnum;
+
     if (G_UNLIKELY (GST_BUFFER_POOL_IS_FLUSHING (pool)))
       goto flushing;
 
-    /* try to get a buffer from the queue */
-    *buffer = gst_atomic_queue_pop (priv->queue);
+    seqnum = g_atomic_int_get (&priv->release_seqnum);
+
+    /* try to get a free buffer */
+    *buffer = pop_free_buffer (priv);
     if (G_LIKELY (*buffer)) {
-      while (!gst_poll_read_control (priv->poll)) {
-        if (errno == EWOULDBLOCK) {
-          /* We put the buffer into the queue but did not finish writing control
-           * yet, let's wait a bit and retry */
-          g_thread_yield ();
-          continue;
-        } else {
-          /* Critical error but GstPoll already complained */
-          break;
-        }
-      }
       result = GST_FLOW_OK;
       GST_LOG_OBJECT (pool, "acquired buffer %p", *buffer);
       break;
@@ -1152,35 +1176,17 @@ default_acquire_buffer (GstBufferPool * pool, GstBuffer ** buffer,
       break;
     }
 
-    /* now we release the control socket, we wait for a buffer release or
-     * flushing */
-    if (!gst_poll_read_control (pool->priv->poll)) {
-      if (errno == EWOULDBLOCK) {
-        /* This means that we have two threads trying to allocate buffers
-         * already, and the other one already got the wait token. This
-         * means that we only have to wait for the poll now and not write the
-         * token afterwards: we will be woken up once the other thread is
-         * woken up and that one will write the wait token it removed */
-        GST_LOG_OBJECT (pool, "waiting for free buffers or flushing");
-        gst_poll_wait (priv->poll, GST_CLOCK_TIME_NONE);
-      } else {
-        /* This is a critical error, GstPoll already gave a warning */
-        result = GST_FLOW_ERROR;
-        break;
-      }
-    } else {
-      /* We're the first thread waiting, we got the wait token and have to
-       * write it again later
-       * OR
-       * We're a second thread and just consumed the flush token and block all
-       * other threads, in which case we must not wait and give it back
-       * immediately */
-      if (!GST_BUFFER_POOL_IS_FLUSHING (pool)) {
-        GST_LOG_OBJECT (pool, "waiting for free buffers or flushing");
-        gst_poll_wait (priv->poll, GST_CLOCK_TIME_NONE);
-      }
-      gst_poll_write_control (pool->priv->poll);
-    }
+    /* wait for a buffer release or flushing. A release after we looked at
+     * the pool bumped the seqnum, and it sees us as waiter and takes the lock
+     * to signal us after we checked the seqnum */
+    GST_LOG_OBJECT (pool, "waiting for free buffers or flushing");
+    g_mutex_lock (&priv->wait_lock);
+    g_atomic_int_inc (&priv->waiters);
+    while (g_atomic_int_get (&priv->release_seqnum) == seqnum
+        && !GST_BUFFER_POOL_IS_FLUSHING (pool))
+      g_cond_wait (&priv->wait_cond, &priv->wait_lock);
+    g_atomic_int_add (&priv->waiters, -1);
+    g_mutex_unlock (&priv->wait_lock);
   }
 
   return result;
@@ -1314,6 +1320,8 @@ gst_buffer_pool_acquire_buffer (GstBufferPool * pool, GstBuffer ** buffer,
 static void
 default_release_buffer (GstBufferPool * pool, GstBuffer * buffer)
 {
+  GstBufferPoolPrivate *priv = pool->priv;
+
   GST_LOG_OBJECT (pool, "released buffer %p %d", buffer,
       GST_MINI_OBJECT_FLAGS (buffer));
 
@@ -1330,9 +1338,11 @@ default_release_buffer (GstBufferPool * pool, GstBuffer * buffer)
   if (G_UNLIKELY (!gst_buffer_is_all_memory_writable (buffer)))
     goto not_writable;
 
-  /* keep it around in our queue */
-  gst_atomic_queue_push (pool->priv->queue, buffer);
-  gst_poll_write_control (pool->priv->poll);
+  /* keep it around, in the slot of this thread if that is free */
+  if (!g_atomic_pointer_compare_and_exchange (&priv->cache
+          [cache_slot_for_thread ()], NULL, buffer))
+    gst_atomic_queue_push (priv->queue, buffer);
+  wake_waiters (priv);
 
   return;
 
@@ -1358,7 +1368,7 @@ not_writable:
 discard:
   {
     do_free_buffer (pool, buffer);
-    gst_poll_write_control (pool->priv->poll);
+    wake_waiters (priv);
     return;
   }
 }
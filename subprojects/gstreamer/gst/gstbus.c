@@ -97,12 +97,15 @@ enum
 };
 
 #define DEFAULT_ENABLE_ASYNC (TRUE)
+#define DEFAULT_COALESCE_WAKEUPS (FALSE)
 #define WARN_QUEUE_SIZE 1024
 
 enum
 {
   PROP_0,
-  PROP_ENABLE_ASYNC
+  PROP_ENABLE_ASYNC,
+  PROP_COALESCE_WAKEUPS,
+  PROP_STATS
 };
 
 static void gst_bus_dispose (GObject * object);
@@ -153,6 +156,16 @@ struct _GstBusPrivate
   gboolean enable_async;
   GstPoll *poll;
   GPollFD pollfd;
+
+  /* with coalescing, only the first message posted after the queue was
+   * drained raises the wakeup */
+  gboolean coalesce_wakeups;
+  gint wakeup_pending;          /* ATOMIC */
+
+  /* statistics, ATOMIC */
+  gsize posted;
+  gsize dropped;
+  gsize coalesced;
 };
 
 #define gst_bus_parent_class parent_class
@@ -168,6 +181,28 @@ gst_bus_set_property (GObject * object,
     case PROP_ENABLE_ASYNC:
       bus->priv->enable_async = g_value_get_boolean (value);
       break;
+    case PROP_COALESCE_WAKEUPS:
+      bus->priv->coalesce_wakeups = g_value_get_boolean (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_bus_get_property (GObject * object,
+    guint prop_id, GValue * value, GParamSpec * pspec)
+{
+  GstBus *bus = GST_BUS_CAST (object);
+
+  switch (prop_id) {
+    case PROP_COALESCE_WAKEUPS:
+      g_value_set_boolean (value, bus->priv->coalesce_wakeups);
+      break;
+    case PROP_STATS:
+      g_value_take_boxed (value, gst_bus_get_stats (bus));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -182,6 +217,8 @@ gst_bus_constructed (GObject * object)
   if (bus->priv->enable_async) {
     bus->priv->poll = gst_poll_new_timer ();
     gst_poll_get_read_gpollfd (bus->priv->poll, &bus->priv->pollfd);
+  } else {
+    bus->priv->coalesce_wakeups = FALSE;
   }
 
   G_OBJECT_CLASS (gst_bus_parent_class)->constructed (object);
@@ -195,6 +232,7 @@ gst_bus_class_init (GstBusClass * klass)
   gobject_class->dispose = gst_bus_dispose;
   gobject_class->finalize = gst_bus_finalize;
   gobject_class->set_property = gst_bus_set_property;
+  gobject_class->get_property = gst_bus_get_property;
   gobject_class->constructed = gst_bus_constructed;
 
   /**
@@ -213,6 +251,39 @@ gst_bus_class_init (GstBusClass * klass)
           DEFAULT_ENABLE_ASYNC,
           G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstBus:coalesce-wakeups:
+   *
+   * Wake up the reader of the bus only once for all messages that are posted
+   * before it gets around to handle them, instead of once per message. Bus
+   * watches then dispatch all messages queued at that point in a single main
+   * loop iteration, and gst_bus_pop_many() can take them in one call.
+   *
+   * This reduces the wakeup and dispatch overhead of pipelines posting many
+   * element, QoS or tracer messages. To use it for a pipeline, create the bus
+   * with this property set and pass it to gst_element_set_bus().
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_COALESCE_WAKEUPS,
+      g_param_spec_boolean ("coalesce-wakeups", "Coalesce Wakeups",
+          "Wake up the reader only once for all messages posted before it "
+          "handles them", DEFAULT_COALESCE_WAKEUPS,
+          G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstBus:stats:
+   *
+   * Various #GstBus statistics, see gst_bus_get_stats() for the fields.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Bus Statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstBus::sync-message:
    * @self: the object which received the signal
@@ -316,6 +387,67 @@ gst_bus_new (void)
   return result;
 }
 
+/* Called after a message was pushed on the queue. Without coalescing every
+ * queued message holds a wakeup of its own. */
+static void
+gst_bus_raise_wakeup (GstBus * bus)
+{
+  GstBusPrivate *priv = bus->priv;
+
+  if (!priv->coalesce_wakeups) {
+    gst_poll_write_control (priv->poll);
+  } else if (g_atomic_int_compare_and_exchange (&priv->wakeup_pending, 0, 1)) {
+    gst_poll_write_control (priv->poll);
+  } else {
+    g_atomic_pointer_add (&priv->coalesced, 1);
+  }
+}
+
+/* Called with the queue lock after trying to pop a message. With coalescing
+ * the single pending wakeup is only released once the queue is drained. */
+static void
+gst_bus_release_wakeup (GstBus * bus, gboolean popped)
+{
+  GstBusPrivate *priv = bus->priv;
+
+  if (priv->poll == NULL)
+    return;
+
+  if (!priv->coalesce_wakeups) {
+    if (!popped)
+      return;
+  } else if (gst_atomic_queue_length (priv->queue) > 0
+      || !g_atomic_int_get (&priv->wakeup_pending)) {
+    return;
+  }
+
+  while (!gst_poll_read_control (priv->poll)) {
+    if (errno == EWOULDBLOCK) {
+      /* Retry, this can happen if pushing to the queue has finished,
+       * popping here succeeded but writing control did not finish
+       * before we got to this line. */
+      /* Give other threads the chance to do something */
+      g_thread_yield ();
+      continue;
+    } else {
+      /* This is a real error and means that either the bus is in an
+       * inconsistent state, or the GstPoll is invalid. GstPoll already
+       * prints a critical warning about this, no need to do that again
+       * ourselves */
+      break;
+    }
+  }
+
+  if (priv->coalesce_wakeups) {
+    g_atomic_int_set (&priv->wakeup_pending, 0);
+
+    /* messages pushed while the wakeup was still pending didn't raise one */
+    if (gst_atomic_queue_length (priv->queue) > 0
+        && g_atomic_int_compare_and_exchange (&priv->wakeup_pending, 0, 1))
+      gst_poll_write_control (priv->poll);
+  }
+}
+
 /**
  * gst_bus_post:
  * @bus: a #GstBus to post on
@@ -343,6 +475,8 @@ gst_bus_post (GstBus * bus, GstMessage * message)
   g_assert (!GST_MINI_OBJECT_FLAG_IS_SET (message,
           GST_MESSAGE_FLAG_ASYNC_DELIVERY));
 
+  g_atomic_pointer_add (&bus->priv->posted, 1);
+
   GST_OBJECT_LOCK (bus);
   /* check if the bus is flushing */
   if (GST_OBJECT_FLAG_IS_SET (bus, GST_BUS_FLUSHING))
@@ -379,6 +513,7 @@ gst_bus_post (GstBus * bus, GstMessage * message)
     case GST_BUS_DROP:
       /* drop the message */
       GST_DEBUG_OBJECT (bus, "[msg %p] dropped", message);
+      g_atomic_pointer_add (&bus->priv->dropped, 1);
       break;
     case GST_BUS_PASS:{
       guint length = gst_atomic_queue_length (bus->priv->queue);
@@ -391,7 +526,7 @@ gst_bus_post (GstBus * bus, GstMessage * message)
       /* pass the message to the async queue, refcount passed in the queue */
       GST_DEBUG_OBJECT (bus, "[msg %p] pushing on async queue", message);
       gst_atomic_queue_push (bus->priv->queue, message);
-      gst_poll_write_control (bus->priv->poll);
+      gst_bus_raise_wakeup (bus);
       GST_DEBUG_OBJECT (bus, "[msg %p] pushed on async queue", message);
 
       break;
@@ -416,7 +551,7 @@ gst_bus_post (GstBus * bus, GstMessage * message)
       g_mutex_lock (lock);
 
       gst_atomic_queue_push (bus->priv->queue, message);
-      gst_poll_write_control (bus->priv->poll);
+      gst_bus_raise_wakeup (bus);
 
       /* now block till the message is freed */
       g_cond_wait (cond, lock);
@@ -447,6 +582,7 @@ is_flushing:
     GST_DEBUG_OBJECT (bus, "bus is flushing");
     GST_OBJECT_UNLOCK (bus);
     gst_message_unref (message);
+    g_atomic_pointer_add (&bus->priv->dropped, 1);
 
     return FALSE;
   }
@@ -499,8 +635,10 @@ gst_bus_set_flushing (GstBus * bus, gboolean flushing)
 
     GST_DEBUG_OBJECT (bus, "set bus flushing");
 
-    while ((message = gst_bus_pop (bus)))
+    while ((message = gst_bus_pop (bus))) {
       message_list = g_list_prepend (message_list, message);
+      g_atomic_pointer_add (&bus->priv->dropped, 1);
+    }
   } else {
     GST_DEBUG_OBJECT (bus, "unset bus flushing");
     GST_OBJECT_FLAG_UNSET (bus, GST_BUS_FLUSHING);
@@ -551,24 +689,7 @@ gst_bus_timed_pop_filtered (GstBus * bus, GstClockTime timeout,
         gst_atomic_queue_length (bus->priv->queue));
 
     while ((message = gst_atomic_queue_pop (bus->priv->queue))) {
-      if (bus->priv->poll) {
-        while (!gst_poll_read_control (bus->priv->poll)) {
-          if (errno == EWOULDBLOCK) {
-            /* Retry, this can happen if pushing to the queue has finished,
-             * popping here succeeded but writing control did not finish
-             * before we got to this line. */
-            /* Give other threads the chance to do something */
-            g_thread_yield ();
-            continue;
-          } else {
-            /* This is a real error and means that either the bus is in an
-             * inconsistent state, or the GstPoll is invalid. GstPoll already
-             * prints a critical warning about this, no need to do that again
-             * ourselves */
-            break;
-          }
-        }
-      }
+      gst_bus_release_wakeup (bus, TRUE);
 
       GST_DEBUG_OBJECT (bus, "got message %p, %s from %s, type mask is %u",
           message, GST_MESSAGE_TYPE_NAME (message),
@@ -587,6 +708,7 @@ gst_bus_timed_pop_filtered (GstBus * bus, GstClockTime timeout,
       gst_message_unref (message);
       message = NULL;
     }
+    gst_bus_release_wakeup (bus, FALSE);
 
     /* no need to wait, exit loop */
     if (timeout == 0)
@@ -692,6 +814,117 @@ gst_bus_pop (GstBus * bus)
   return gst_bus_timed_pop_filtered (bus, 0, GST_MESSAGE_ANY);
 }
 
+/**
+ * gst_bus_timed_pop_many:
+ * @bus: a #GstBus to pop from
+ * @timeout: a timeout in nanoseconds, or %GST_CLOCK_TIME_NONE to wait forever
+ * @messages: (out caller-allocates) (array length=n_messages) (transfer full):
+ *     array to store the messages in
+ * @n_messages: the size of @messages
+ *
+ * Waits up to the specified timeout for a message on the bus, and then takes
+ * as many messages as are queued, up to @n_messages, in one go.
+ *
+ * Together with #GstBus:coalesce-wakeups this allows handling a burst of
+ * messages after a single wakeup.
+ *
+ * Returns: the number of messages stored in @messages, 0 if the bus was
+ *     empty until the timeout expired.
+ *
+ * Since: 1.26
+ */
+guint
+gst_bus_timed_pop_many (GstBus * bus, GstClockTime timeout,
+    GstMessage ** messages, guint n_messages)
+{
+  GstMessage *message;
+  guint n = 0;
+
+  g_return_val_if_fail (GST_IS_BUS (bus), 0);
+  g_return_val_if_fail (messages != NULL || n_messages == 0, 0);
+  g_return_val_if_fail (timeout == 0 || bus->priv->poll != NULL, 0);
+
+  if (n_messages == 0)
+    return 0;
+
+  message = gst_bus_timed_pop_filtered (bus, timeout, GST_MESSAGE_ANY);
+  if (message == NULL)
+    return 0;
+
+  messages[n++] = message;
+
+  g_mutex_lock (&bus->priv->queue_lock);
+  while (n < n_messages) {
+    message = gst_atomic_queue_pop (bus->priv->queue);
+    gst_bus_release_wakeup (bus, message != NULL);
+    if (message == NULL)
+      break;
+    messages[n++] = message;
+  }
+  g_mutex_unlock (&bus->priv->queue_lock);
+
+  GST_DEBUG_OBJECT (bus, "popped %u messages", n);
+
+  return n;
+}
+
+/**
+ * gst_bus_pop_many:
+ * @bus: a #GstBus to pop from
+ * @messages: (out caller-allocates) (array length=n_messages) (transfer full):
+ *     array to store the messages in
+ * @n_messages: the size of @messages
+ *
+ * Takes up to @n_messages messages from the bus in one go, without waiting.
+ *
+ * Returns: the number of messages stored in @messages, 0 if the bus is
+ *     empty.
+ *
+ * Since: 1.26
+ */
+guint
+gst_bus_pop_many (GstBus * bus, GstMessage ** messages, guint n_messages)
+{
+  g_return_val_if_fail (GST_IS_BUS (bus), 0);
+
+  return gst_bus_timed_pop_many (bus, 0, messages, n_messages);
+}
+
+/**
+ * gst_bus_get_stats:
+ * @bus: a #GstBus
+ *
+ * Returns various #GstBus statistics. This function returns a #GstStructure
+ * with name `application/x-gst-bus-stats` with the following fields:
+ *
+ * - "posted" G_TYPE_UINT64   Number of messages posted on the bus
+ * - "dropped" G_TYPE_UINT64   Number of posted messages that were not
+ *   queued for asynchronous delivery, or flushed out of the queue
+ * - "coalesced" G_TYPE_UINT64   Number of messages that didn't need a
+ *   wakeup of their own, see #GstBus:coalesce-wakeups
+ *
+ * Returns: (transfer full): pointer to #GstStructure
+ *
+ * Since: 1.26
+ */
+GstStructure *
+gst_bus_get_stats (GstBus * bus)
+{
+  GstBusPrivate *priv;
+
+  g_return_val_if_fail (GST_IS_BUS (bus), NULL);
+
+  priv = bus->priv;
+  return gst_structure_new ("application/x-gst-bus-stats",
+      "posted", G_TYPE_UINT64,
+      (guint64) GPOINTER_TO_SIZE (g_atomic_pointer_get (&priv->posted)),
+      "dropped", G_TYPE_UINT64,
+      (guint64) GPOINTER_TO_SIZE (g_atomic_pointer_get (&priv->dropped)),
+      "coalesced", G_TYPE_UINT64,
+      (guint64) GPOINTER_TO_SIZE (g_atomic_pointer_get (&priv->coalesced)),
+      NULL);
+}
+
 /**
  * gst_bus_peek:
  * @bus: a #GstBus
@@ -809,6 +1042,7 @@ gst_bus_source_dispatch (GSource * source, GSourceFunc callback,
   GstBusFunc handler = (GstBusFunc) callback;
   GstBusSource *bsource = (GstBusSource *) source;
   GstMessage *message;
+  guint n_messages;
   gboolean keep;
   GstBus *bus;
 
@@ -818,23 +1052,31 @@ gst_bus_source_dispatch (GSource * source, GSourceFunc callback,
 
   g_return_val_if_fail (GST_IS_BUS (bus), FALSE);
 
-  message = gst_bus_pop (bus);
+  /* with coalesced wakeups, handle all messages that are queued now in this
+   * dispatch cycle. Messages posted from the handler wait for the next one */
+  n_messages = 1;
+  if (bus->priv->coalesce_wakeups)
+    n_messages = MAX (gst_atomic_queue_length (bus->priv->queue), 1);
+
+  do {
+    message = gst_bus_pop (bus);
 
-  /* The message queue might be empty if some other thread or callback set
-   * the bus to flushing between check/prepare and dispatch */
-  if (G_UNLIKELY (message == NULL))
-    return TRUE;
+    /* The message queue might be empty if some other thread or callback set
+     * the bus to flushing between check/prepare and dispatch */
+    if (G_UNLIKELY (message == NULL))
+      return TRUE;
 
-  if (!handler)
-    goto no_handler;
+    if (!handler)
+      goto no_handler;
 
-  GST_DEBUG_OBJECT (bus, "source %p calling dispatch with %" GST_PTR_FORMAT,
-      source, message);
+    GST_DEBUG_OBJECT (bus, "source %p calling dispatch with %" GST_PTR_FORMAT,
+        source, message);
 
-  keep = handler (bus, message, user_data);
-  gst_message_unref (message);
+    keep = handler (bus, message, user_data);
+    gst_message_unref (message);
 
-  GST_DEBUG_OBJECT (bus, "source %p handler returns %d", source, keep);
+    GST_DEBUG_OBJECT (bus, "source %p handler returns %d", source, keep);
+  } while (keep && --n_messages > 0 && !g_source_is_destroyed (source));
 
   return keep;
 
@@ -182,9 +182,19 @@ GstMessage *            gst_bus_timed_pop               (GstBus * bus, GstClockT
 GST_API
 GstMessage *            gst_bus_timed_pop_filtered      (GstBus * bus, GstClockTime timeout, GstMessageType types);
 
+GST_API
+guint                   gst_bus_pop_many                (GstBus * bus, GstMessage ** messages,
+                                                         guint n_messages);
+GST_API
+guint                   gst_bus_timed_pop_many          (GstBus * bus, GstClockTime timeout,
+                                                         GstMessage ** messages, guint n_messages);
+
 GST_API
 void                    gst_bus_set_flushing            (GstBus * bus, gboolean flushing);
 
+GST_API
+GstStructure *          gst_bus_get_stats               (GstBus * bus);
+
 /* synchronous dispatching */
 
 GST_API
@@ -136,9 +136,148 @@ GstCaps *_gst_caps_none;
 
 GST_DEFINE_MINI_OBJECT_TYPE (GstCaps, gst_caps);
 
+/* Optional process-wide cache of intersection and subset results, enabled by
+ * setting GST_CAPS_CACHE_SIZE to the number of results to keep.
+ *
+ * Only caps that are not writable are cached. The cache keeps a reference to
+ * them so they can't become writable again and their pointers stay unique,
+ * which makes the pointers usable as the key. */
+typedef enum
+{
+  CAPS_CACHE_INTERSECT_ZIG_ZAG,
+  CAPS_CACHE_INTERSECT_FIRST,
+  CAPS_CACHE_IS_SUBSET,
+  CAPS_CACHE_CAN_INTERSECT,
+} GstCapsCacheOp;
+
+static const gchar *caps_cache_op_names[] = {
+  "intersect-zig-zag", "intersect-first", "is-subset", "can-intersect"
+};
+
+typedef struct
+{
+  GstCapsCacheOp op;
+  GstCaps *caps1;
+  GstCaps *caps2;
+
+  /* for intersections */
+  GstCaps *result;
+  /* for the other operations */
+  gboolean res;
+
+  /* in caps_cache_lru, most recently used first */
+  GList link;
+} GstCapsCacheEntry;
+
+static GMutex caps_cache_lock;
+static GHashTable *caps_cache;
+static GQueue caps_cache_lru = G_QUEUE_INIT;
+static guint caps_cache_size;
+
+#define CAPS_CACHE_ENABLED (caps_cache_size > 0)
+#define CAPS_ARE_CACHEABLE(caps1, caps2) \
+  (CAPS_CACHE_ENABLED && !IS_WRITABLE (caps1) && !IS_WRITABLE (caps2))
+
+static guint
+caps_cache_entry_hash (gconstpointer key)
+{
+  const GstCapsCacheEntry *entry = key;
+
+  return (g_direct_hash (entry->caps1) * 31 + g_direct_hash (entry->caps2))
+      ^ entry->op;
+}
+
+static gboolean
+caps_cache_entry_equal (gconstpointer a, gconstpointer b)
+{
+  const GstCapsCacheEntry *entry1 = a, *entry2 = b;
+
+  return entry1->op == entry2->op && entry1->caps1 == entry2->caps1
+      && entry1->caps2 == entry2->caps2;
+}
+
+static void
+caps_cache_entry_free (GstCapsCacheEntry * entry)
+{
+  gst_caps_unref (entry->caps1);
+  gst_caps_unref (entry->caps2);
+  if (entry->result)
+    gst_caps_unref (entry->result);
+  g_free (entry);
+}
+
+/* Returns %TRUE if the result of @op was cached. For intersections @result is
+ * set to a new reference to the cached caps */
+static gboolean
+caps_cache_lookup (GstCapsCacheOp op, const GstCaps * caps1,
+    const GstCaps * caps2, GstCaps ** result, gboolean * res)
+{
+  GstCapsCacheEntry key, *entry;
+  gboolean hit = FALSE;
+
+  key.op = op;
+  key.caps1 = (GstCaps *) caps1;
+  key.caps2 = (GstCaps *) caps2;
+
+  g_mutex_lock (&caps_cache_lock);
+  entry = g_hash_table_lookup (caps_cache, &key);
+  if (entry) {
+    g_queue_unlink (&caps_cache_lru, &entry->link);
+    g_queue_push_head_link (&caps_cache_lru, &entry->link);
+    if (entry->result)
+      *result = gst_caps_ref (entry->result);
+    else
+      *res = entry->res;
+    hit = TRUE;
+  }
+  g_mutex_unlock (&caps_cache_lock);
+
+  GST_TRACER_CAPS_CACHE_LOOKUP (caps1, caps2, caps_cache_op_names[op], hit);
+
+  return hit;
+}
+
+static void
+caps_cache_insert (GstCapsCacheOp op, const GstCaps * caps1,
+    const GstCaps * caps2, GstCaps * result, gboolean res)
+{
+  GstCapsCacheEntry *entry, *evicted = NULL;
+  GList *link;
+
+  entry = g_new0 (GstCapsCacheEntry, 1);
+  entry->op = op;
+  entry->caps1 = gst_caps_ref ((GstCaps *) caps1);
+  entry->caps2 = gst_caps_ref ((GstCaps *) caps2);
+  /* shared with the caller, who has to make it writable to modify it */
+  entry->result = result ? gst_caps_ref (result) : NULL;
+  entry->res = res;
+  entry->link.data = entry;
+
+  g_mutex_lock (&caps_cache_lock);
+  if (g_hash_table_contains (caps_cache, entry)) {
+    /* another thread was faster */
+    evicted = entry;
+  } else {
+    g_hash_table_add (caps_cache, entry);
+    g_queue_push_head_link (&caps_cache_lru, &entry->link);
+
+    if (caps_cache_lru.length > caps_cache_size) {
+      link = g_queue_pop_tail_link (&caps_cache_lru);
+      evicted = link->data;
+      g_hash_table_remove (caps_cache, evicted);
+    }
+  }
+  g_mutex_unlock (&caps_cache_lock);
+
+  if (evicted)
+    caps_cache_entry_free (evicted);
+}
+
 void
 _priv_gst_caps_initialize (void)
 {
+  const gchar *env;
+
   _gst_caps_type = gst_caps_get_type ();
 
   _gst_caps_any = gst_caps_new_any ();
@@ -146,11 +285,31 @@ _priv_gst_caps_initialize (void)
 
   g_value_register_transform_func (_gst_caps_type,
       G_TYPE_STRING, gst_caps_transform_to_string);
+
+  env = g_getenv ("GST_CAPS_CACHE_SIZE");
+  if (env != NULL) {
+    caps_cache_size = (guint) g_ascii_strtoull (env, NULL, 10);
+    if (caps_cache_size > 0)
+      caps_cache = g_hash_table_new (caps_cache_entry_hash,
+          caps_cache_entry_equal);
+  }
 }
 
 void
 _priv_gst_caps_cleanup (void)
 {
+  GstCapsCacheEntry *entry;
+
+  if (caps_cache) {
+    while ((entry = g_queue_peek_head (&caps_cache_lru))) {
+      g_queue_unlink (&caps_cache_lru, &entry->link);
+      caps_cache_entry_free (entry);
+    }
+    g_hash_table_unref (caps_cache);
+    caps_cache = NULL;
+    caps_cache_size = 0;
+  }
+
   gst_caps_unref (_gst_caps_any);
   _gst_caps_any = NULL;
   gst_caps_unref (_gst_caps_none);
@@ -1309,31 +1468,15 @@ gst_caps_is_always_compatible (const GstCaps * caps1, const GstCaps * caps2)
   return gst_caps_is_subset (caps1, caps2);
 }
 
-/**
- * gst_caps_is_subset:
- * @subset: a #GstCaps
- * @superset: a potentially greater #GstCaps
- *
- * Checks if all caps represented by @subset are also represented by @superset.
- *
- * Returns: %TRUE if @subset is a subset of @superset
- */
-gboolean
-gst_caps_is_subset (const GstCaps * subset, const GstCaps * superset)
+static gboolean
+gst_caps_is_subset_uncached (const GstCaps * subset,
+    const GstCaps * superset)
 {
   GstStructure *s1, *s2;
   GstCapsFeatures *f1, *f2;
   gboolean ret = TRUE;
   gint i, j;
 
-  g_return_val_if_fail (subset != NULL, FALSE);
-  g_return_val_if_fail (superset != NULL, FALSE);
-
-  if (CAPS_IS_EMPTY (subset) || CAPS_IS_ANY (superset))
-    return TRUE;
-  if (CAPS_IS_ANY (subset) || CAPS_IS_EMPTY (superset))
-    return FALSE;
-
   for (i = GST_CAPS_LEN (subset) - 1; i >= 0; i--) {
     s1 = gst_caps_get_structure_unchecked (subset, i);
     f1 = gst_caps_get_features_unchecked (subset, i);
@@ -1365,6 +1508,39 @@ gst_caps_is_subset (const GstCaps * subset, const GstCaps * superset)
   return ret;
 }
 
+/**
+ * gst_caps_is_subset:
+ * @subset: a #GstCaps
+ * @superset: a potentially greater #GstCaps
+ *
+ * Checks if all caps represented by @subset are also represented by @superset.
+ *
+ * Returns: %TRUE if @subset is a subset of @superset
+ */
+gboolean
+gst_caps_is_subset (const GstCaps * subset, const GstCaps * superset)
+{
+  gboolean ret;
+
+  g_return_val_if_fail (subset != NULL, FALSE);
+  g_return_val_if_fail (superset != NULL, FALSE);
+
+  if (CAPS_IS_EMPTY (subset) || CAPS_IS_ANY (superset))
+    return TRUE;
+  if (CAPS_IS_ANY (subset) || CAPS_IS_EMPTY (superset))
+    return FALSE;
+
+  if (CAPS_ARE_CACHEABLE (subset, superset)) {
+    if (caps_cache_lookup (CAPS_CACHE_IS_SUBSET, subset, superset, NULL, &ret))
+      return ret;
+    ret = gst_caps_is_subset_uncached (subset, superset);
+    caps_cache_insert (CAPS_CACHE_IS_SUBSET, subset, superset, NULL, ret);
+    return ret;
+  }
+
+  return gst_caps_is_subset_uncached (subset, superset);
+}
+
 /**
  * gst_caps_is_subset_structure:
  * @caps: a #GstCaps
@@ -1525,18 +1701,8 @@ gst_caps_is_strictly_equal (const GstCaps * caps1, const GstCaps * caps2)
 
 /* intersect operation */
 
-/**
- * gst_caps_can_intersect:
- * @caps1: a #GstCaps to intersect
- * @caps2: a #GstCaps to intersect
- *
- * Tries intersecting @caps1 and @caps2 and reports whether the result would not
- * be empty
- *
- * Returns: %TRUE if intersection would be not empty
- */
-gboolean
-gst_caps_can_intersect (const GstCaps * caps1, const GstCaps * caps2)
+static gboolean
+gst_caps_can_intersect_uncached (const GstCaps * caps1, const GstCaps * caps2)
 {
   guint64 i;                    /* index can be up to 2 * G_MAX_UINT */
   guint j, k, len1, len2;
@@ -1545,21 +1711,6 @@ gst_caps_can_intersect (const GstCaps * caps1, const GstCaps * caps2)
   GstCapsFeatures *features1;
   GstCapsFeatures *features2;
 
-  g_return_val_if_fail (GST_IS_CAPS (caps1), FALSE);
-  g_return_val_if_fail (GST_IS_CAPS (caps2), FALSE);
-
-  /* caps are exactly the same pointers */
-  if (G_UNLIKELY (caps1 == caps2))
-    return TRUE;
-
-  /* empty caps on either side, return empty */
-  if (G_UNLIKELY (CAPS_IS_EMPTY (caps1) || CAPS_IS_EMPTY (caps2)))
-    return FALSE;
-
-  /* one of the caps is any */
-  if (G_UNLIKELY (CAPS_IS_ANY (caps1) || CAPS_IS_ANY (caps2)))
-    return TRUE;
-
   /* run zigzag on top line then right line, this preserves the caps order
    * much better than a simple loop.
    *
@@ -1611,6 +1762,47 @@ gst_caps_can_intersect (const GstCaps * caps1, const GstCaps * caps2)
   return FALSE;
 }
 
+/**
+ * gst_caps_can_intersect:
+ * @caps1: a #GstCaps to intersect
+ * @caps2: a #GstCaps to intersect
+ *
+ * Tries intersecting @caps1 and @caps2 and reports whether the result would not
+ * be empty
+ *
+ * Returns: %TRUE if intersection would be not empty
+ */
+gboolean
+gst_caps_can_intersect (const GstCaps * caps1, const GstCaps * caps2)
+{
+  gboolean res;
+
+  g_return_val_if_fail (GST_IS_CAPS (caps1), FALSE);
+  g_return_val_if_fail (GST_IS_CAPS (caps2), FALSE);
+
+  /* caps are exactly the same pointers */
+  if (G_UNLIKELY (caps1 == caps2))
+    return TRUE;
+
+  /* empty caps on either side, return empty */
+  if (G_UNLIKELY (CAPS_IS_EMPTY (caps1) || CAPS_IS_EMPTY (caps2)))
+    return FALSE;
+
+  /* one of the caps is any */
+  if (G_UNLIKELY (CAPS_IS_ANY (caps1) || CAPS_IS_ANY (caps2)))
+    return TRUE;
+
+  if (CAPS_ARE_CACHEABLE (caps1, caps2)) {
+    if (caps_cache_lookup (CAPS_CACHE_CAN_INTERSECT, caps1, caps2, NULL, &res))
+      return res;
+    res = gst_caps_can_intersect_uncached (caps1, caps2);
+    caps_cache_insert (CAPS_CACHE_CAN_INTERSECT, caps1, caps2, NULL, res);
+    return res;
+  }
+
+  return gst_caps_can_intersect_uncached (caps1, caps2);
+}
+
 static GstCaps *
 gst_caps_intersect_zig_zag (GstCaps * caps1, GstCaps * caps2)
 {
@@ -1755,6 +1947,10 @@ GstCaps *
 gst_caps_intersect_full (GstCaps * caps1, GstCaps * caps2,
     GstCapsIntersectMode mode)
 {
+  GstCapsCacheOp op;
+  GstCaps *res;
+  gboolean cacheable;
+
   g_return_val_if_fail (GST_IS_CAPS (caps1), NULL);
   g_return_val_if_fail (GST_IS_CAPS (caps2), NULL);
 
@@ -1774,15 +1970,27 @@ gst_caps_intersect_full (GstCaps * caps1, GstCaps * caps2,
   if (G_UNLIKELY (CAPS_IS_ANY (caps2)))
     return gst_caps_ref (caps1);
 
-  switch (mode) {
-    case GST_CAPS_INTERSECT_FIRST:
-      return gst_caps_intersect_first (caps1, caps2);
-    default:
+  if (mode == GST_CAPS_INTERSECT_FIRST) {
+    op = CAPS_CACHE_INTERSECT_FIRST;
+  } else {
+    if (mode != GST_CAPS_INTERSECT_ZIG_ZAG)
       g_warning ("Unknown caps intersect mode: %d", mode);
-      /* fallthrough */
-    case GST_CAPS_INTERSECT_ZIG_ZAG:
-      return gst_caps_intersect_zig_zag (caps1, caps2);
+    op = CAPS_CACHE_INTERSECT_ZIG_ZAG;
   }
+
+  cacheable = CAPS_ARE_CACHEABLE (caps1, caps2);
+  if (cacheable && caps_cache_lookup (op, caps1, caps2, &res, NULL))
+    return res;
+
+  if (op == CAPS_CACHE_INTERSECT_FIRST)
+    res = gst_caps_intersect_first (caps1, caps2);
+  else
+    res = gst_caps_intersect_zig_zag (caps1, caps2);
+
+  if (cacheable)
+    caps_cache_insert (op, caps1, caps2, res, FALSE);
+
+  return res;
 }
 
 /**
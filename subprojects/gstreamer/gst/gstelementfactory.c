@@ -155,6 +155,8 @@ gst_element_factory_cleanup (GstElementFactory * factory)
     gst_structure_free ((GstStructure *) factory->metadata);
     factory->metadata = NULL;
   }
+  factory->metadata_string = NULL;
+  factory->klass = NULL;
   if (factory->type) {
     factory->type = G_TYPE_INVALID;
   }
@@ -176,6 +178,12 @@ gst_element_factory_cleanup (GstElementFactory * factory)
 
   g_list_free (factory->interfaces);
   factory->interfaces = NULL;
+
+  /* after the pad templates, their caps can point into the cache */
+  if (factory->cache) {
+    g_bytes_unref (factory->cache);
+    factory->cache = NULL;
+  }
 }
 
 #define CHECK_METADATA_FIELD(klass, name, key)                                 \
@@ -857,6 +865,34 @@ gst_element_factory_get_element_type (GstElementFactory * factory)
   return factory->type;
 }
 
+/* factories loaded from the registry cache only parse their metadata when
+ * it is first needed */
+static GstStructure *
+gst_element_factory_ensure_metadata (GstElementFactory * factory)
+{
+  GstStructure *metadata;
+
+  metadata = g_atomic_pointer_get (&factory->metadata);
+  if (G_LIKELY (metadata != NULL) || factory->metadata_string == NULL)
+    return metadata;
+
+  metadata = gst_structure_from_string (factory->metadata_string, NULL);
+  if (G_UNLIKELY (metadata == NULL)) {
+    GST_ERROR_OBJECT (factory, "Error when trying to deserialize structure "
+        "for metadata '%s'", factory->metadata_string);
+    return NULL;
+  }
+
+  if (!g_atomic_pointer_compare_and_exchange (&factory->metadata, NULL,
+          metadata)) {
+    /* somebody else was faster */
+    gst_structure_free (metadata);
+    metadata = g_atomic_pointer_get (&factory->metadata);
+  }
+
+  return metadata;
+}
+
 /**
  * gst_element_factory_get_metadata:
  * @factory: a #GstElementFactory
@@ -871,9 +907,22 @@ const gchar *
 gst_element_factory_get_metadata (GstElementFactory * factory,
     const gchar * key)
 {
+  GstStructure *metadata;
+
   g_return_val_if_fail (GST_IS_ELEMENT_FACTORY (factory), NULL);
 
-  return gst_structure_get_string ((GstStructure *) factory->metadata, key);
+  /* the klass is also stored on its own in the registry cache, which is
+   * enough for filtering factories by klass */
+  if (factory->klass && *factory->klass
+      && g_atomic_pointer_get (&factory->metadata) == NULL
+      && strcmp (key, GST_ELEMENT_METADATA_KLASS) == 0)
+    return factory->klass;
+
+  metadata = gst_element_factory_ensure_metadata (factory);
+  if (metadata == NULL)
+    return NULL;
+
+  return gst_structure_get_string (metadata, key);
 }
 
 /**
@@ -895,7 +944,7 @@ gst_element_factory_get_metadata_keys (GstElementFactory * factory)
 
   g_return_val_if_fail (GST_IS_ELEMENT_FACTORY (factory), NULL);
 
-  metadata = (GstStructure *) factory->metadata;
+  metadata = gst_element_factory_ensure_metadata (factory);
   if (metadata == NULL)
     return NULL;
 
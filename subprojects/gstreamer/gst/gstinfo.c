@@ -97,6 +97,7 @@
 #include <stdio.h>              /* fprintf */
 #include <glib/gstdio.h>
 #include <errno.h>
+#include <stddef.h>             /* ptrdiff_t */
 #include <string.h>             /* G_VA_COPY */
 
 #include "gst_private.h"
@@ -106,6 +107,7 @@
 #include "gstvalue.h"
 #include "gstvecdeque.h"
 #include "gstcapsfeatures.h"
+#include "gsterror.h"
 
 #endif /* GST_DISABLE_GST_DEBUG */
 
@@ -350,6 +352,12 @@ static GSList *__log_functions = NULL;
 /* whether to add the default log function in gst_init() */
 static gboolean add_default_log_func = TRUE;
 
+/* per thread, when enabled with GST_DEBUG_BINARY_LOGGER */
+#define DEFAULT_BINARY_LOGGER_SIZE (1024 * 1024)
+/* from GST_DEBUG_BINARY_LOGGER_FILE, the binary logs are written to it in
+ * gst_deinit() */
+static gchar *binary_logger_file = NULL;
+
 #define PRETTY_TAGS_DEFAULT  TRUE
 static gboolean pretty_tags = PRETTY_TAGS_DEFAULT;
 
@@ -391,7 +399,18 @@ _priv_gst_debug_init (void)
   const gchar *env;
   FILE *log_file;
 
-  if (add_default_log_func) {
+  env = g_getenv ("GST_DEBUG_BINARY_LOGGER");
+  if (add_default_log_func && env != NULL && *env != '\0') {
+    guint64 size = g_ascii_strtoull (env, NULL, 10);
+
+    /* replaces the default log function */
+    gst_debug_add_binary_logger (size > 0 ? MIN (size, G_MAXUINT) :
+        DEFAULT_BINARY_LOGGER_SIZE);
+
+    env = g_getenv ("GST_DEBUG_BINARY_LOGGER_FILE");
+    if (env != NULL && *env != '\0')
+      binary_logger_file = _priv_gst_debug_file_name (env);
+  } else if (add_default_log_func) {
     env = g_getenv ("GST_DEBUG_FILE");
     if (env != NULL && *env != '\0') {
       if (strcmp (env, "-") == 0) {
@@ -703,6 +722,7 @@ gst_debug_log_literal_full (GstDebugCategory * category, GstDebugLevel level,
   g_return_if_fail (message_string != NULL);
 
   message.message = (gchar *) message_string;
+  message.format = NULL;
   message.object = object;
   message.object_id = (gchar *) id;
   message.free_object_id = FALSE;
@@ -2570,6 +2590,17 @@ _priv_gst_debug_cleanup (void)
 
   clear_level_names ();
 
+  if (binary_logger_file) {
+    GError *err = NULL;
+
+    if (!gst_debug_binary_logger_dump (binary_logger_file, &err)) {
+      g_printerr ("Could not write binary logs: %s\n", err->message);
+      g_clear_error (&err);
+    }
+    g_free (binary_logger_file);
+    binary_logger_file = NULL;
+  }
+
   g_mutex_lock (&__log_func_mutex);
   while (__log_functions) {
     LogFuncEntry *log_func_entry = __log_functions->data;
@@ -3796,6 +3827,844 @@ gst_debug_remove_ring_buffer_logger (void)
   gst_debug_remove_log_function (gst_ring_buffer_logger_log);
 }
 
+/* The binary logger does not format messages. Each thread appends records
+ * with the ids of the category, file, function and format strings and the raw
+ * arguments to a ring buffer of its own, without taking any lock. The strings
+ * are copied into a table once, the first time a thread logs them, so format
+ * strings are expected to be static like the ones of the GST_DEBUG() macros.
+ * Only string arguments are copied and the %p extensions like GST_PTR_FORMAT
+ * are formatted when logging, as they might not be valid anymore later.
+ *
+ * gst_debug_binary_logger_dump() writes the records to a file that
+ * gst-debug-decode-1.0 formats offline. Everything is in host byte order:
+ *
+ *  - "GSTBLOG" magic with terminator, guint32 version, guint32 0x01020304
+ *    byte order mark and guint32 process id
+ *  - guint32 number of strings, then for each string, in id order starting
+ *    from 1, guint32 length and the bytes without terminator
+ *  - guint32 number of threads, then for each thread guint64 thread id,
+ *    guint64 size of its records and the records, oldest first
+ *
+ * Records are a GstBinaryLogRecord followed by the object id and n_args
+ * GstBinaryLogArg with their value, all padded to 8 bytes. Keep in sync with
+ * tools/gst-debug-decode.c */
+#define BINARY_LOG_MAGIC "GSTBLOG"
+#define BINARY_LOG_VERSION 1
+#define BINARY_LOG_BYTE_ORDER 0x01020304
+#define BINARY_LOG_MAX_ARGS 32
+#define BINARY_LOG_STRING_CACHE_SIZE 256
+#define BINARY_LOG_ALIGN(s) (((s) + 7) & ~((gsize) 7))
+
+typedef enum
+{
+  BINARY_LOG_ARG_INT,           /* 64 bits, sign extended if signed */
+  BINARY_LOG_ARG_DOUBLE,
+  BINARY_LOG_ARG_STRING,
+  BINARY_LOG_ARG_NULL_STRING,
+} GstBinaryLogArgType;
+
+/* the message is stored formatted as the only argument */
+#define BINARY_LOG_RECORD_PREFORMATTED (1 << 0)
+
+typedef struct
+{
+  /* size of the whole record, 0 marks the unused end of the ring */
+  guint32 size;
+  guint8 level;
+  guint8 flags;
+  guint16 n_args;
+  guint64 ts;
+  guint32 category;
+  guint32 file;
+  guint32 function;
+  guint32 format;
+  gint32 line;
+  guint32 id_len;
+} GstBinaryLogRecord;
+
+typedef struct
+{
+  guint32 type;
+  guint32 len;
+} GstBinaryLogArg;
+
+typedef struct
+{
+  GstBinaryLogArgType type;
+  union
+  {
+    guint64 i;
+    gdouble d;
+    const gchar *s;
+  } v;
+  gsize len;
+  gchar *free_s;
+} GstBinaryLogValue;
+
+typedef enum
+{
+  BINARY_LOG_MOD_NONE,
+  BINARY_LOG_MOD_HH,
+  BINARY_LOG_MOD_H,
+  BINARY_LOG_MOD_L,
+  BINARY_LOG_MOD_LL,
+  BINARY_LOG_MOD_J,
+  BINARY_LOG_MOD_Z,
+  BINARY_LOG_MOD_T,
+  BINARY_LOG_MOD_LONG_DOUBLE,
+} GstBinaryLogModifier;
+
+typedef struct
+{
+  /* odd while the owning thread writes */
+  gint seqnum;
+  gboolean in_use;
+  guint64 thread;
+
+  /* positions in bytes written since the start, read is the oldest record */
+  guint64 read;
+  guint64 write;
+  gsize size;
+  guint8 *data;
+
+  struct
+  {
+    const gchar *str;
+    guint32 id;
+  } string_cache[BINARY_LOG_STRING_CACHE_SIZE];
+} GstBinaryLogRing;
+
+typedef struct
+{
+  guint generation;
+  gsize ring_size;
+  GPtrArray *rings;
+  /* string pointer -> id, and id -> copy of the string */
+  GHashTable *string_ids;
+  GPtrArray *strings;
+} GstBinaryLogger;
+
+typedef struct
+{
+  guint generation;
+  GstBinaryLogRing *ring;
+} GstBinaryLogThread;
+
+G_LOCK_DEFINE_STATIC (binary_logger);
+static GstBinaryLogger *binary_logger = NULL;
+static guint binary_logger_generation = 0;
+
+static void
+gst_binary_log_thread_free (GstBinaryLogThread * thread)
+{
+  G_LOCK (binary_logger);
+  /* let another thread reuse the ring */
+  if (binary_logger && binary_logger->generation == thread->generation)
+    thread->ring->in_use = FALSE;
+  G_UNLOCK (binary_logger);
+
+  g_free (thread);
+}
+
+static GPrivate binary_log_thread =
+G_PRIVATE_INIT ((GDestroyNotify) gst_binary_log_thread_free);
+
+static GstBinaryLogRing *
+gst_binary_logger_get_ring (GstBinaryLogger * logger)
+{
+  GstBinaryLogThread *thread = g_private_get (&binary_log_thread);
+  GstBinaryLogRing *ring = NULL;
+  guint i;
+
+  /* the ring of a previous logger was freed with it */
+  if (G_LIKELY (thread && thread->generation == logger->generation))
+    return thread->ring;
+
+  if (!thread) {
+    thread = g_new0 (GstBinaryLogThread, 1);
+    g_private_set (&binary_log_thread, thread);
+  }
+
+  G_LOCK (binary_logger);
+  for (i = 0; i < logger->rings->len; i++) {
+    GstBinaryLogRing *r = g_ptr_array_index (logger->rings, i);
+
+    if (!r->in_use) {
+      ring = r;
+      break;
+    }
+  }
+  if (ring) {
+    ring->read = ring->write = 0;
+    memset (ring->string_cache, 0, sizeof (ring->string_cache));
+  } else {
+    ring = g_new0 (GstBinaryLogRing, 1);
+    ring->size = logger->ring_size;
+    ring->data = g_malloc (ring->size);
+    g_ptr_array_add (logger->rings, ring);
+  }
+  ring->in_use = TRUE;
+  ring->thread = (guint64) (guintptr) g_thread_self ();
+  G_UNLOCK (binary_logger);
+
+  thread->generation = logger->generation;
+  thread->ring = ring;
+
+  return ring;
+}
+
+static guint32
+gst_binary_logger_get_string_id (GstBinaryLogger * logger,
+    GstBinaryLogRing * ring, const gchar * str)
+{
+  guintptr hash = (guintptr) str;
+  guint idx;
+  guint32 id;
+
+  hash ^= hash >> 8;
+  idx = hash % BINARY_LOG_STRING_CACHE_SIZE;
+  if (G_LIKELY (ring->string_cache[idx].str == str))
+    return ring->string_cache[idx].id;
+
+  G_LOCK (binary_logger);
+  id = GPOINTER_TO_UINT (g_hash_table_lookup (logger->string_ids, str));
+  if (id == 0) {
+    id = logger->strings->len;
+    g_ptr_array_add (logger->strings, g_strdup (str));
+    g_hash_table_insert (logger->string_ids, (gpointer) str,
+        GUINT_TO_POINTER (id));
+  }
+  G_UNLOCK (binary_logger);
+
+  ring->string_cache[idx].str = str;
+  ring->string_cache[idx].id = id;
+
+  return id;
+}
+
+static guint64
+gst_binary_logger_read_int (va_list * args, GstBinaryLogModifier mod,
+    gboolean is_signed)
+{
+  if (is_signed) {
+    switch (mod) {
+      case BINARY_LOG_MOD_HH:
+        return (gint64) (gint8) va_arg (*args, gint);
+      case BINARY_LOG_MOD_H:
+        return (gint64) (gint16) va_arg (*args, gint);
+      case BINARY_LOG_MOD_L:
+        return (gint64) va_arg (*args, glong);
+      case BINARY_LOG_MOD_LL:
+      case BINARY_LOG_MOD_J:
+        return (gint64) va_arg (*args, long long);
+      case BINARY_LOG_MOD_Z:
+        return (gint64) va_arg (*args, gssize);
+      case BINARY_LOG_MOD_T:
+        return (gint64) va_arg (*args, ptrdiff_t);
+      default:
+        return (gint64) va_arg (*args, gint);
+    }
+  }
+
+  switch (mod) {
+    case BINARY_LOG_MOD_HH:
+      return (guint8) va_arg (*args, guint);
+    case BINARY_LOG_MOD_H:
+      return (guint16) va_arg (*args, guint);
+    case BINARY_LOG_MOD_L:
+      return va_arg (*args, gulong);
+    case BINARY_LOG_MOD_LL:
+    case BINARY_LOG_MOD_J:
+      return va_arg (*args, unsigned long long);
+    case BINARY_LOG_MOD_Z:
+      return va_arg (*args, gsize);
+    case BINARY_LOG_MOD_T:
+      return (guint64) va_arg (*args, ptrdiff_t);
+    default:
+      return va_arg (*args, guint);
+  }
+}
+
+/* Fetches the arguments of @format. Returns %FALSE if the format uses features
+ * the decoder can't replay, like positional arguments or %n */
+static gboolean
+gst_binary_logger_collect_args (const gchar * format, va_list * args,
+    GstBinaryLogValue * values, guint * n_values)
+{
+  const gchar *p = format;
+  GstBinaryLogModifier mod;
+  GstBinaryLogValue *value;
+  gboolean is_precision;
+  gint precision;
+  gpointer ptr;
+  gchar conv;
+
+  *n_values = 0;
+
+  while ((p = strchr (p, '%'))) {
+    p++;
+    if (*p == '%') {
+      p++;
+      continue;
+    }
+
+    while (*p && strchr ("-+ #0'", *p))
+      p++;
+
+    /* width and precision, which might be arguments too. The precision limits
+     * how much of a string is read, which doesn't need to be terminated */
+    precision = -1;
+    do {
+      is_precision = *p == '.';
+      if (is_precision)
+        p++;
+      if (*p == '*') {
+        if (*n_values == BINARY_LOG_MAX_ARGS)
+          return FALSE;
+        value = &values[(*n_values)++];
+        value->free_s = NULL;
+        value->type = BINARY_LOG_ARG_INT;
+        value->v.i = gst_binary_logger_read_int (args, BINARY_LOG_MOD_NONE,
+            TRUE);
+        /* a negative precision is taken as if it was omitted */
+        if (is_precision)
+          precision = MAX ((gint) value->v.i, -1);
+        p++;
+      } else {
+        if (is_precision)
+          precision = 0;
+        while (g_ascii_isdigit (*p)) {
+          if (is_precision && precision < G_MAXINT / 10)
+            precision = precision * 10 + (*p - '0');
+          p++;
+        }
+        if (*p == '$')
+          return FALSE;
+      }
+    } while (*p == '.');
+
+    mod = BINARY_LOG_MOD_NONE;
+    switch (*p) {
+      case 'h':
+        mod = p[1] == 'h' ? BINARY_LOG_MOD_HH : BINARY_LOG_MOD_H;
+        p += mod == BINARY_LOG_MOD_HH ? 2 : 1;
+        break;
+      case 'l':
+        mod = p[1] == 'l' ? BINARY_LOG_MOD_LL : BINARY_LOG_MOD_L;
+        p += mod == BINARY_LOG_MOD_LL ? 2 : 1;
+        break;
+      case 'q':
+        mod = BINARY_LOG_MOD_LL;
+        p++;
+        break;
+      case 'L':
+        mod = BINARY_LOG_MOD_LONG_DOUBLE;
+        p++;
+        break;
+      case 'j':
+        mod = BINARY_LOG_MOD_J;
+        p++;
+        break;
+      case 'z':
+        mod = BINARY_LOG_MOD_Z;
+        p++;
+        break;
+      case 't':
+        mod = BINARY_LOG_MOD_T;
+        p++;
+        break;
+      case 'I':
+        /* G_GINT64_MODIFIER on Windows */
+        if (p[1] == '6' && p[2] == '4') {
+          mod = BINARY_LOG_MOD_LL;
+          p += 3;
+        }
+        break;
+      default:
+        break;
+    }
+
+    if (*n_values == BINARY_LOG_MAX_ARGS)
+      return FALSE;
+    value = &values[*n_values];
+    value->free_s = NULL;
+
+    conv = *p++;
+    switch (conv) {
+      case 'd':
+      case 'i':
+        value->type = BINARY_LOG_ARG_INT;
+        value->v.i = gst_binary_logger_read_int (args, mod, TRUE);
+        break;
+      case 'o':
+      case 'u':
+      case 'x':
+      case 'X':
+        value->type = BINARY_LOG_ARG_INT;
+        value->v.i = gst_binary_logger_read_int (args, mod, FALSE);
+        break;
+      case 'c':
+        value->type = BINARY_LOG_ARG_INT;
+        value->v.i = va_arg (*args, gint);
+        break;
+      case 'e':
+      case 'E':
+      case 'f':
+      case 'F':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
+        value->type = BINARY_LOG_ARG_DOUBLE;
+        if (mod == BINARY_LOG_MOD_LONG_DOUBLE)
+          value->v.d = va_arg (*args, long double);
+        else
+          value->v.d = va_arg (*args, gdouble);
+        break;
+      case 's':
+        if (mod != BINARY_LOG_MOD_NONE)
+          return FALSE;
+        value->v.s = va_arg (*args, const gchar *);
+        if (value->v.s) {
+          const gchar *end;
+
+          value->type = BINARY_LOG_ARG_STRING;
+          if (precision >= 0) {
+            end = memchr (value->v.s, '\0', precision);
+            value->len = end ? end - value->v.s : precision;
+          } else {
+            value->len = strlen (value->v.s);
+          }
+        } else {
+          value->type = BINARY_LOG_ARG_NULL_STRING;
+        }
+        break;
+      case 'p':
+        ptr = va_arg (*args, gpointer);
+        if (p[0] == '\a' && p[1] != '\0') {
+          /* GST_PTR_FORMAT and friends */
+          value->free_s = gst_info_printf_pointer_extension_func (p - 1, ptr);
+          value->type = BINARY_LOG_ARG_STRING;
+          value->v.s = value->free_s;
+          value->len = strlen (value->free_s);
+          p += 2;
+        } else {
+          value->type = BINARY_LOG_ARG_INT;
+          value->v.i = (guint64) (guintptr) ptr;
+        }
+        break;
+      default:
+        return FALSE;
+    }
+    (*n_values)++;
+  }
+
+  return TRUE;
+}
+
+static gsize
+gst_binary_log_value_size (const GstBinaryLogValue * value)
+{
+  switch (value->type) {
+    case BINARY_LOG_ARG_INT:
+    case BINARY_LOG_ARG_DOUBLE:
+      return 8;
+    case BINARY_LOG_ARG_STRING:
+      return value->len;
+    default:
+      return 0;
+  }
+}
+
+/* Returns where to write a record of @len bytes, dropping the oldest records
+ * if needed. Must be called by the owning thread with an odd seqnum */
+static guint8 *
+gst_binary_log_ring_reserve (GstBinaryLogRing * ring, gsize len)
+{
+  gsize offset = ring->write % ring->size;
+  gsize skip = 0;
+
+  /* records are contiguous, leave the end of the buffer unused if needed */
+  if (ring->size - offset < len)
+    skip = ring->size - offset;
+
+  while (ring->write + skip + len - ring->read > ring->size) {
+    gsize read_offset = ring->read % ring->size;
+    guint32 size = *(guint32 *) (ring->data + read_offset);
+
+    ring->read += size ? size : ring->size - read_offset;
+  }
+
+  if (skip) {
+    *(guint32 *) (ring->data + offset) = 0;
+    ring->write += skip;
+    offset = 0;
+  }
+  ring->write += len;
+
+  return ring->data + offset;
+}
+
+static void
+gst_binary_logger_log (GstDebugCategory * category, GstDebugLevel level,
+    const gchar * file, const gchar * function, gint line, GObject * object,
+    GstDebugMessage * message, gpointer user_data)
+{
+  GstBinaryLogger *logger = user_data;
+  GstBinaryLogValue values[BINARY_LOG_MAX_ARGS];
+  GstBinaryLogRecord record;
+  GstBinaryLogArg arg;
+  GstBinaryLogRing *ring;
+  gboolean preformatted = TRUE;
+  const gchar *object_id;
+  guint n_values = 0, i;
+  gsize size, id_len, len;
+  guint8 *dest;
+  gchar c;
+
+  /* the arguments were consumed if another log function formatted them */
+  if (message->message == NULL && message->format != NULL) {
+    va_list args;
+
+    G_VA_COPY (args, message->arguments);
+    preformatted = !gst_binary_logger_collect_args (message->format, &args,
+        values, &n_values);
+    va_end (args);
+  }
+
+  if (preformatted) {
+    for (i = 0; i < n_values; i++)
+      g_free (values[i].free_s);
+
+    values[0].free_s = NULL;
+    values[0].v.s = gst_debug_message_get (message);
+    if (values[0].v.s) {
+      values[0].type = BINARY_LOG_ARG_STRING;
+      values[0].len = strlen (values[0].v.s);
+    } else {
+      values[0].type = BINARY_LOG_ARG_NULL_STRING;
+    }
+    n_values = 1;
+  }
+
+  object_id = gst_debug_message_get_id (message);
+  id_len = object_id ? strlen (object_id) : 0;
+
+  size = sizeof (GstBinaryLogRecord) + BINARY_LOG_ALIGN (id_len);
+  for (i = 0; i < n_values; i++)
+    size += sizeof (GstBinaryLogArg) +
+        BINARY_LOG_ALIGN (gst_binary_log_value_size (&values[i]));
+
+  /* would overwrite the whole ring */
+  if (size > logger->ring_size)
+    goto done;
+
+  c = file[0];
+  if (c == '.' || c == '/' || c == '\\' || (c != '\0' && file[1] == ':')) {
+    file = gst_path_basename (file);
+  }
+
+  ring = gst_binary_logger_get_ring (logger);
+
+  record.size = size;
+  record.level = level;
+  record.flags = preformatted ? BINARY_LOG_RECORD_PREFORMATTED : 0;
+  record.n_args = n_values;
+  record.ts = GST_CLOCK_DIFF (_priv_gst_start_time, gst_util_get_timestamp ());
+  record.category = gst_binary_logger_get_string_id (logger, ring,
+      category->name);
+  record.file = gst_binary_logger_get_string_id (logger, ring, file);
+  record.function = gst_binary_logger_get_string_id (logger, ring, function);
+  record.format = preformatted ? 0 :
+      gst_binary_logger_get_string_id (logger, ring, message->format);
+  record.line = line;
+  record.id_len = id_len;
+
+  g_atomic_int_inc (&ring->seqnum);
+
+  dest = gst_binary_log_ring_reserve (ring, size);
+  memcpy (dest, &record, sizeof (GstBinaryLogRecord));
+  dest += sizeof (GstBinaryLogRecord);
+  if (id_len)
+    memcpy (dest, object_id, id_len);
+  dest += BINARY_LOG_ALIGN (id_len);
+
+  for (i = 0; i < n_values; i++) {
+    len = gst_binary_log_value_size (&values[i]);
+    arg.type = values[i].type;
+    arg.len = len;
+    memcpy (dest, &arg, sizeof (GstBinaryLogArg));
+    dest += sizeof (GstBinaryLogArg);
+
+    if (values[i].type == BINARY_LOG_ARG_INT)
+      memcpy (dest, &values[i].v.i, 8);
+    else if (values[i].type == BINARY_LOG_ARG_DOUBLE)
+      memcpy (dest, &values[i].v.d, 8);
+    else if (len)
+      memcpy (dest, values[i].v.s, len);
+    dest += BINARY_LOG_ALIGN (len);
+  }
+
+  g_atomic_int_inc (&ring->seqnum);
+
+done:
+  for (i = 0; i < n_values; i++)
+    g_free (values[i].free_s);
+}
+
+/* Copies the consistent part of @ring. Returns %NULL if the owning thread
+ * keeps writing, or died while writing */
+static guint8 *
+gst_binary_log_ring_snapshot (GstBinaryLogRing * ring, guint64 * read,
+    guint64 * write)
+{
+  guint8 *copy = g_malloc (ring->size);
+  gint seqnum, tries;
+
+  for (tries = 0; tries < 100; tries++) {
+    seqnum = g_atomic_int_get (&ring->seqnum);
+    if (seqnum & 1) {
+      g_thread_yield ();
+      continue;
+    }
+
+    *read = ring->read;
+    *write = ring->write;
+    memcpy (copy, ring->data, ring->size);
+
+    if (g_atomic_int_get (&ring->seqnum) == seqnum)
+      return copy;
+  }
+
+  g_free (copy);
+  return NULL;
+}
+
+static gboolean
+gst_binary_logger_write (FILE * file, gconstpointer data, gsize size)
+{
+  return size == 0 || fwrite (data, size, 1, file) == 1;
+}
+
+static gboolean
+gst_binary_logger_write_ring (FILE * file, GstBinaryLogRing * ring)
+{
+  guint64 read, write, pos, records_size = 0;
+  gsize ring_size = ring->size;
+  gboolean ret = TRUE;
+  guint8 *copy;
+  guint32 size;
+
+  copy = gst_binary_log_ring_snapshot (ring, &read, &write);
+  if (!copy) {
+    read = write = 0;
+  }
+
+  for (pos = read; pos < write; pos += size ? size : ring_size - pos %
+      ring_size) {
+    size = *(guint32 *) (copy + pos % ring_size);
+    records_size += size;
+  }
+
+  ret &= gst_binary_logger_write (file, &ring->thread, sizeof (guint64));
+  ret &= gst_binary_logger_write (file, &records_size, sizeof (guint64));
+
+  for (pos = read; pos < write; pos += size ? size : ring_size - pos %
+      ring_size) {
+    size = *(guint32 *) (copy + pos % ring_size);
+    ret &= gst_binary_logger_write (file, copy + pos % ring_size, size);
+  }
+
+  g_free (copy);
+
+  return ret;
+}
+
+/**
+ * gst_debug_binary_logger_dump:
+ * @filename: (type filename): the file to write the logs to
+ * @error: return location for a #GError, or %NULL
+ *
+ * Writes the logs of all threads stored by the binary logger to @filename,
+ * which can then be formatted with the gst-debug-decode-1.0 tool. See
+ * gst_debug_add_binary_logger() for details.
+ *
+ * This can be called at any time, for example when the application detected
+ * a failure. The threads keep logging while the logs are written.
+ *
+ * Returns: %TRUE if the logs were written
+ *
+ * Since: 1.26
+ */
+gboolean
+gst_debug_binary_logger_dump (const gchar * filename, GError ** error)
+{
+  GstBinaryLogger *logger;
+  FILE *file;
+  gboolean ret = TRUE;
+  guint32 val;
+  guint i;
+
+  g_return_val_if_fail (filename != NULL, FALSE);
+  g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+  G_LOCK (binary_logger);
+
+  logger = binary_logger;
+  if (!logger)
+    goto no_logger;
+
+  file = g_fopen (filename, "wb");
+  if (!file)
+    goto open_failed;
+
+  ret &= gst_binary_logger_write (file, BINARY_LOG_MAGIC,
+      sizeof (BINARY_LOG_MAGIC));
+  val = BINARY_LOG_VERSION;
+  ret &= gst_binary_logger_write (file, &val, sizeof (guint32));
+  val = BINARY_LOG_BYTE_ORDER;
+  ret &= gst_binary_logger_write (file, &val, sizeof (guint32));
+  val = _gst_getpid ();
+  ret &= gst_binary_logger_write (file, &val, sizeof (guint32));
+
+  /* ids start at 1 */
+  val = logger->strings->len - 1;
+  ret &= gst_binary_logger_write (file, &val, sizeof (guint32));
+  for (i = 1; i < logger->strings->len; i++) {
+    const gchar *str = g_ptr_array_index (logger->strings, i);
+
+    val = strlen (str);
+    ret &= gst_binary_logger_write (file, &val, sizeof (guint32));
+    ret &= gst_binary_logger_write (file, str, val);
+  }
+
+  val = logger->rings->len;
+  ret &= gst_binary_logger_write (file, &val, sizeof (guint32));
+  for (i = 0; i < logger->rings->len; i++)
+    ret &= gst_binary_logger_write_ring (file,
+        g_ptr_array_index (logger->rings, i));
+
+  G_UNLOCK (binary_logger);
+
+  if (fclose (file) != 0)
+    ret = FALSE;
+  if (!ret)
+    goto write_failed;
+
+  return TRUE;
+
+  /* ERRORS */
+no_logger:
+  {
+    G_UNLOCK (binary_logger);
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_FAILED,
+        "No binary logger was added");
+    return FALSE;
+  }
+open_failed:
+  {
+    gint errsv = errno;
+
+    G_UNLOCK (binary_logger);
+    g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errsv),
+        "Could not open file \"%s\" for writing: %s", filename,
+        g_strerror (errsv));
+    return FALSE;
+  }
+write_failed:
+  {
+    g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_IO,
+        "Could not write logs to file \"%s\"", filename);
+    return FALSE;
+  }
+}
+
+static void
+gst_binary_log_ring_free (GstBinaryLogRing * ring)
+{
+  g_free (ring->data);
+  g_free (ring);
+}
+
+static void
+gst_binary_logger_free (GstBinaryLogger * logger)
+{
+  G_LOCK (binary_logger);
+  if (binary_logger == logger) {
+    g_ptr_array_unref (logger->rings);
+    g_hash_table_unref (logger->string_ids);
+    g_ptr_array_unref (logger->strings);
+
+    g_free (logger);
+    binary_logger = NULL;
+  }
+  G_UNLOCK (binary_logger);
+}
+
+/**
+ * gst_debug_add_binary_logger:
+ * @max_size_per_thread: Maximum size of log per thread in bytes
+ *
+ * Adds a debug logger that stores up to @max_size_per_thread bytes of logs per
+ * thread in memory, dropping the oldest messages when full.
+ *
+ * Unlike gst_debug_add_ring_buffer_logger(), messages are not formatted.
+ * Their format string and arguments are stored in a binary form, which makes
+ * logging much cheaper and doesn't serialize the logging threads. This allows
+ * keeping detailed logging enabled in production and only looking at the logs
+ * when something went wrong.
+ *
+ * The logs can be written to a file with gst_debug_binary_logger_dump() and
+ * formatted with the gst-debug-decode-1.0 tool. The logger can be removed
+ * again with gst_debug_remove_binary_logger(). Only one logger at a time is
+ * possible.
+ *
+ * Since: 1.26
+ */
+void
+gst_debug_add_binary_logger (guint max_size_per_thread)
+{
+  GstBinaryLogger *logger;
+
+  G_LOCK (binary_logger);
+
+  if (binary_logger) {
+    g_warn_if_reached ();
+    G_UNLOCK (binary_logger);
+    return;
+  }
+
+  logger = binary_logger = g_new0 (GstBinaryLogger, 1);
+
+  logger->generation = ++binary_logger_generation;
+  logger->ring_size = max_size_per_thread & ~((gsize) 7);
+  logger->rings =
+      g_ptr_array_new_with_free_func ((GDestroyNotify)
+      gst_binary_log_ring_free);
+  logger->string_ids = g_hash_table_new (g_direct_hash, g_direct_equal);
+  logger->strings = g_ptr_array_new_with_free_func (g_free);
+  /* id 0 is for messages without format */
+  g_ptr_array_add (logger->strings, NULL);
+
+  gst_debug_add_log_function (gst_binary_logger_log, logger,
+      (GDestroyNotify) gst_binary_logger_free);
+  G_UNLOCK (binary_logger);
+}
+
+/**
+ * gst_debug_remove_binary_logger:
+ *
+ * Removes any previously added binary logger with
+ * gst_debug_add_binary_logger().
+ *
+ * Since: 1.26
+ */
+void
+gst_debug_remove_binary_logger (void)
+{
+  gst_debug_remove_log_function (gst_binary_logger_log);
+}
+
 #else /* GST_DISABLE_GST_DEBUG */
 #ifndef GST_REMOVE_DISABLED
 
@@ -3816,5 +4685,21 @@ gst_debug_remove_ring_buffer_logger (void)
 {
 }
 
+gboolean
+gst_debug_binary_logger_dump (const gchar * filename, GError ** error)
+{
+  return FALSE;
+}
+
+void
+gst_debug_add_binary_logger (guint max_size_per_thread)
+{
+}
+
+void
+gst_debug_remove_binary_logger (void)
+{
+}
+
 #endif /* GST_REMOVE_DISABLED */
 #endif /* GST_DISABLE_GST_DEBUG */
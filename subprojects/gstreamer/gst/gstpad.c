@@ -138,9 +138,19 @@ struct _GstPadPrivate
   GArray *events;
   guint last_cookie;
 
+  /* threads pushing or pulling through the pad, modified atomically */
   gint using;
   guint probe_list_cookie;
 
+  /* set when buffers can be pushed without taking the object lock, see
+   * gst_pad_push_data_fast(). Modified atomically, only set with the object
+   * lock held. fast_peer is the peer to push to, it is not reffed and only
+   * valid while fast_path is set. stale_peers holds refs to former fast
+   * peers that threads in the fast path might still be using */
+  gint fast_path;
+  GstPad *fast_peer;
+  GSList *stale_peers;
+
   /* counter of how many idle probes are running directly from the add_probe
    * call. Used to block any data flowing in the pad while the idle callback
    * Doesn't finish its work */
@@ -160,6 +170,10 @@ typedef struct
 #define GST_PAD_IS_RUNNING_IDLE_PROBE(p) \
     (((GstPad *)(p))->priv->idle_running > 0)
 
+/* flags that make data go through the locked path */
+#define GST_PAD_SRC_SLOW_PATH_FLAGS \
+    (GST_PAD_FLAG_FLUSHING | GST_PAD_FLAG_EOS | GST_PAD_FLAG_PENDING_EVENTS)
+
 typedef struct
 {
   GstPad *pad;
@@ -692,6 +706,42 @@ apply_pad_offset (GstPad * pad, GstEvent * event, gboolean upstream)
   return event;
 }
 
+/* Checks without the object lock if data can flow over @pad without running
+ * probes or sending sticky events. This is racy, but not more than doing the
+ * checks with the lock and releasing it before calling the peer. */
+static inline gboolean
+gst_pad_is_steady (GstPad * pad, guint slow_flags)
+{
+#ifdef GST_ENABLE_EXTRA_CHECKS
+  if (G_UNLIKELY (pad->priv->last_cookie != pad->priv->events_cookie))
+    return FALSE;
+#endif
+
+  return !(g_atomic_int_get ((gint *) & GST_OBJECT_FLAGS (pad)) & slow_flags)
+      && GST_PAD_MODE (pad) == GST_PAD_MODE_PUSH
+      && g_atomic_int_get (&pad->num_probes) == 0;
+}
+
+/* should be called with the OBJECT_LOCK. Makes the next push take the locked
+ * path. The current fast peer is kept alive until the threads that might
+ * still be pushing to it are done, see gst_pad_fast_path_leave() */
+static void
+gst_pad_invalidate_fast_path (GstPad * pad)
+{
+  GstPad *peer;
+
+  /* pairs with the increment of using in gst_pad_push_data_fast() */
+  g_atomic_int_set (&pad->priv->fast_path, 0);
+
+  if ((peer = pad->priv->fast_peer) == NULL)
+    return;
+
+  g_atomic_pointer_set (&pad->priv->fast_peer, NULL);
+  if (g_atomic_int_get (&pad->priv->using) > 0)
+    pad->priv->stale_peers =
+        g_slist_prepend (pad->priv->stale_peers, gst_object_ref (peer));
+}
+
 /* should be called with the OBJECT_LOCK */
 static GstCaps *
 get_pad_caps (GstPad * pad)
@@ -711,6 +761,7 @@ gst_pad_dispose (GObject * object)
 {
   GstPad *pad = GST_PAD_CAST (object);
   GstPad *peer;
+  GSList *stale_peers;
 
   GST_CAT_DEBUG_OBJECT (GST_CAT_REFCOUNTING, pad, "%p dispose", pad);
 
@@ -732,8 +783,12 @@ gst_pad_dispose (GObject * object)
   GST_OBJECT_LOCK (pad);
   remove_events (pad);
   g_hook_list_clear (&pad->probes);
+  stale_peers = pad->priv->stale_peers;
+  pad->priv->stale_peers = NULL;
   GST_OBJECT_UNLOCK (pad);
 
+  g_slist_free_full (stale_peers, gst_object_unref);
+
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
 
@@ -1485,9 +1540,12 @@ gst_pad_add_probe (GstPad * pad, GstPadProbeType mask,
     GST_PAD_BLOCK_BROADCAST (pad);
   }
 
+  /* data has to go through the probes from now on */
+  gst_pad_invalidate_fast_path (pad);
+
   /* call the callback if we need to be called for idle callbacks */
   if ((mask & GST_PAD_PROBE_TYPE_IDLE) && (callback != NULL)) {
-    if (pad->priv->using > 0) {
+    if (g_atomic_int_get (&pad->priv->using) > 0) {
       /* the pad is in use, we can't signal the idle callback yet. Since we set the
        * flag above, the last thread to leave the push will do the callback. New
        * threads going into the push will block. */
@@ -2185,6 +2243,8 @@ no_src_parent:
   }
 no_sink_parent:
 
+  gst_pad_invalidate_fast_path (srcpad);
+
   /* first clear peers */
   GST_PAD_PEER (srcpad) = NULL;
   GST_PAD_PEER (sinkpad) = NULL;
@@ -4719,12 +4779,122 @@ gst_pad_chain_list (GstPad * pad, GstBufferList * list)
       GST_PAD_PROBE_TYPE_BUFFER_LIST | GST_PAD_PROBE_TYPE_PUSH, list);
 }
 
+/* Called by the threads leaving gst_pad_push_data_fast(). The last one
+ * does what the locked path does when it is done with the pad. */
+static GstFlowReturn
+gst_pad_fast_path_leave (GstPad * pad, GstFlowReturn ret)
+{
+  GSList *stale_peers = NULL;
+
+  if (G_LIKELY (!g_atomic_int_dec_and_test (&pad->priv->using)))
+    return ret;
+
+  /* nobody waited for us */
+  if (G_LIKELY (g_atomic_int_get (&pad->priv->fast_path)))
+    return ret;
+
+  GST_OBJECT_LOCK (pad);
+  if (g_atomic_int_get (&pad->priv->using) == 0) {
+    stale_peers = pad->priv->stale_peers;
+    pad->priv->stale_peers = NULL;
+    /* pad is not active anymore, trigger idle callbacks */
+    PROBE_NO_DATA (pad, GST_PAD_PROBE_TYPE_PUSH | GST_PAD_PROBE_TYPE_IDLE,
+        probe_stopped, ret);
+  }
+  GST_OBJECT_UNLOCK (pad);
+
+  g_slist_free_full (stale_peers, gst_object_unref);
+
+  return ret;
+
+probe_stopped:
+  {
+    if (ret == GST_FLOW_CUSTOM_SUCCESS || ret == GST_FLOW_CUSTOM_SUCCESS_1)
+      ret = GST_FLOW_OK;
+    pad->ABI.abi.last_flowret = ret;
+    GST_OBJECT_UNLOCK (pad);
+    g_slist_free_full (stale_peers, gst_object_unref);
+
+    return ret;
+  }
+}
+
+/* Pushes @data to the peer of @pad without taking the object lock when
+ * nothing needs to be checked since the last push. Returns %FALSE without
+ * consuming @data when the locked path has to be taken. */
+static inline gboolean
+gst_pad_push_data_fast (GstPad * pad, GstPadProbeType type, void *data,
+    GstFlowReturn * ret)
+{
+  GstPad *peer;
+
+  if (!g_atomic_int_get (&pad->priv->fast_path))
+    return FALSE;
+
+  /* announce ourselves before checking again, a concurrent
+   * gst_pad_invalidate_fast_path() then either makes us fall back to the
+   * locked path or keeps the peer alive until we leave */
+  g_atomic_int_inc (&pad->priv->using);
+
+  if (G_UNLIKELY (!g_atomic_int_get (&pad->priv->fast_path)
+          || (peer = g_atomic_pointer_get (&pad->priv->fast_peer)) == NULL
+          || !gst_pad_is_steady (pad, GST_PAD_SRC_SLOW_PATH_FLAGS))) {
+    gst_pad_fast_path_leave (pad, GST_FLOW_OK);
+    return FALSE;
+  }
+
+  *ret = gst_pad_chain_data_unchecked (peer, type, data);
+
+  /* last_flowret is protected by the object lock, only take it when the
+   * result changed */
+  if (G_UNLIKELY (*ret != g_atomic_int_get ((gint *) &
+              pad->ABI.abi.last_flowret))) {
+    GST_OBJECT_LOCK (pad);
+    pad->ABI.abi.last_flowret = *ret;
+    GST_OBJECT_UNLOCK (pad);
+  }
+
+  *ret = gst_pad_fast_path_leave (pad, *ret);
+
+  return TRUE;
+}
+
+/* should be called with the OBJECT_LOCK. Lets the next pushes to @peer go
+ * through gst_pad_push_data_fast() if nothing needs to be checked on @pad.
+ * Returns the stale peers to unref after releasing the lock. */
+static GSList *
+gst_pad_enable_fast_path (GstPad * pad, GstPad * peer)
+{
+  GSList *stale_peers = NULL;
+
+  if (!gst_pad_is_steady (pad, GST_PAD_SRC_SLOW_PATH_FLAGS))
+    return NULL;
+
+  if (pad->priv->stale_peers) {
+    /* threads in the fast path might still be using them */
+    if (g_atomic_int_get (&pad->priv->using) > 0)
+      return NULL;
+
+    stale_peers = pad->priv->stale_peers;
+    pad->priv->stale_peers = NULL;
+  }
+
+  g_atomic_pointer_set (&pad->priv->fast_peer, peer);
+  g_atomic_int_set (&pad->priv->fast_path, 1);
+
+  return stale_peers;
+}
+
 static GstFlowReturn
 gst_pad_push_data (GstPad * pad, GstPadProbeType type, void *data)
 {
   GstPad *peer;
   GstFlowReturn ret;
   gboolean handled = FALSE;
+  GSList *stale_peers = NULL;
+
+  if (G_LIKELY (gst_pad_push_data_fast (pad, type, data, &ret)))
+    return ret;
 
   GST_OBJECT_LOCK (pad);
   if (G_UNLIKELY (GST_PAD_IS_FLUSHING (pad)))
@@ -4773,11 +4943,16 @@ gst_pad_push_data (GstPad * pad, GstPadProbeType type, void *data)
   if (G_UNLIKELY ((peer = GST_PAD_PEER (pad)) == NULL))
     goto not_linked;
 
+  if (!g_atomic_int_get (&pad->priv->fast_path))
+    stale_peers = gst_pad_enable_fast_path (pad, peer);
+
   /* take ref to peer pad before releasing the lock */
   gst_object_ref (peer);
-  pad->priv->using++;
+  g_atomic_int_inc (&pad->priv->using);
   GST_OBJECT_UNLOCK (pad);
 
+  g_slist_free_full (stale_peers, gst_object_unref);
+
   ret = gst_pad_chain_data_unchecked (peer, type, data);
   data = NULL;
 
@@ -4785,8 +4960,7 @@ gst_pad_push_data (GstPad * pad, GstPadProbeType type, void *data)
 
   GST_OBJECT_LOCK (pad);
   pad->ABI.abi.last_flowret = ret;
-  pad->priv->using--;
-  if (pad->priv->using == 0) {
+  if (g_atomic_int_dec_and_test (&pad->priv->using)) {
     /* pad is not active anymore, trigger idle callbacks */
     PROBE_NO_DATA (pad, GST_PAD_PROBE_TYPE_PUSH | GST_PAD_PROBE_TYPE_IDLE,
         probe_stopped, ret);
@@ -5229,7 +5403,7 @@ gst_pad_pull_range (GstPad * pad, guint64 offset, guint size,
     goto not_linked;
 
   gst_object_ref (peer);
-  pad->priv->using++;
+  g_atomic_int_inc (&pad->priv->using);
   GST_OBJECT_UNLOCK (pad);
 
   ret = gst_pad_get_range_unchecked (peer, offset, size, &res_buf);
@@ -5237,9 +5411,8 @@ gst_pad_pull_range (GstPad * pad, guint64 offset, guint size,
   gst_object_unref (peer);
 
   GST_OBJECT_LOCK (pad);
-  pad->priv->using--;
   pad->ABI.abi.last_flowret = ret;
-  if (pad->priv->using == 0) {
+  if (g_atomic_int_dec_and_test (&pad->priv->using)) {
     /* pad is not active anymore, trigger idle callbacks */
     PROBE_NO_DATA (pad, GST_PAD_PROBE_TYPE_PULL | GST_PAD_PROBE_TYPE_IDLE,
         probe_stopped_unref, ret);
@@ -5605,7 +5778,7 @@ gst_pad_push_event_unchecked (GstPad * pad, GstEvent * event,
     goto not_linked;
 
   gst_object_ref (peerpad);
-  pad->priv->using++;
+  g_atomic_int_inc (&pad->priv->using);
   GST_OBJECT_UNLOCK (pad);
 
   GST_LOG_OBJECT (pad,
@@ -5623,8 +5796,7 @@ gst_pad_push_event_unchecked (GstPad * pad, GstEvent * event,
   gst_object_unref (peerpad);
 
   GST_OBJECT_LOCK (pad);
-  pad->priv->using--;
-  if (pad->priv->using == 0) {
+  if (g_atomic_int_dec_and_test (&pad->priv->using)) {
     /* pad is not active anymore, trigger idle callbacks */
     PROBE_NO_DATA (pad, GST_PAD_PROBE_TYPE_PUSH | GST_PAD_PROBE_TYPE_IDLE,
         idle_probe_stopped, ret);
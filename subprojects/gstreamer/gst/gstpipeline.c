@@ -106,7 +106,8 @@ enum
   PROP_0,
   PROP_DELAY,
   PROP_AUTO_FLUSH_BUS,
-  PROP_LATENCY
+  PROP_LATENCY,
+  PROP_TASK_POOL
 };
 
 struct _GstPipelinePrivate
@@ -123,6 +124,8 @@ struct _GstPipelinePrivate
 
   GstClockTime latency;
 
+  GstTaskPool *task_pool;
+
   /* seqnum of the most recent instant-rate-request, %GST_SEQNUM_INVALID if none */
   guint32 instant_rate_seqnum;
   gdouble active_instant_rate;
@@ -206,6 +209,24 @@ gst_pipeline_class_init (GstPipelineClass * klass)
           "Latency to configure on the pipeline", 0, G_MAXUINT64,
           DEFAULT_LATENCY, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstPipeline:task-pool:
+   *
+   * The #GstTaskPool to use for the streaming threads of the elements in the
+   * pipeline, or %NULL to use the default pool of #GstTask. Only tasks that
+   * are created after setting the pool use it, and the application has to
+   * call gst_task_pool_prepare() on it.
+   *
+   * With a #GstWorkStealingTaskPool all pad tasks of the pipeline share a
+   * fixed number of threads per CPU core.
+   *
+   * Since: 1.26
+   **/
+  g_object_class_install_property (gobject_class, PROP_TASK_POOL,
+      g_param_spec_object ("task-pool", "Task Pool",
+          "The task pool to use for the streaming threads of the pipeline",
+          GST_TYPE_TASK_POOL, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gobject_class->dispose = gst_pipeline_dispose;
 
   gst_element_class_set_static_metadata (gstelement_class, "Pipeline object",
@@ -262,6 +283,8 @@ gst_pipeline_dispose (GObject * object)
   /* clear and unref any fixed clock */
   gst_object_replace ((GstObject **) clock_p, NULL);
 
+  gst_object_replace ((GstObject **) & pipeline->priv->task_pool, NULL);
+
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
 
@@ -281,6 +304,12 @@ gst_pipeline_set_property (GObject * object, guint prop_id,
     case PROP_LATENCY:
       gst_pipeline_set_latency (pipeline, g_value_get_uint64 (value));
       break;
+    case PROP_TASK_POOL:
+      GST_OBJECT_LOCK (pipeline);
+      gst_object_replace ((GstObject **) & pipeline->priv->task_pool,
+          g_value_get_object (value));
+      GST_OBJECT_UNLOCK (pipeline);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -303,6 +332,11 @@ gst_pipeline_get_property (GObject * object, guint prop_id,
     case PROP_LATENCY:
       g_value_set_uint64 (value, gst_pipeline_get_latency (pipeline));
       break;
+    case PROP_TASK_POOL:
+      GST_OBJECT_LOCK (pipeline);
+      g_value_set_object (value, pipeline->priv->task_pool);
+      GST_OBJECT_UNLOCK (pipeline);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -664,6 +698,35 @@ gst_pipeline_handle_message (GstBin * bin, GstMessage * message)
     }
       break;
 
+    case GST_MESSAGE_STREAM_STATUS:
+    {
+      GstStreamStatusType type;
+      const GValue *val;
+      GstTaskPool *pool = NULL;
+
+      /* this message is posted synchronously from the thread that creates
+       * the task, before the task is started */
+      gst_message_parse_stream_status (message, &type, NULL);
+      if (type != GST_STREAM_STATUS_TYPE_CREATE)
+        break;
+
+      GST_OBJECT_LOCK (pipeline);
+      if (pipeline->priv->task_pool)
+        pool = gst_object_ref (pipeline->priv->task_pool);
+      GST_OBJECT_UNLOCK (pipeline);
+
+      if (pool) {
+        val = gst_message_get_stream_status_object (message);
+        if (val && G_VALUE_HOLDS_OBJECT (val)
+            && GST_IS_TASK (g_value_get_object (val))) {
+          GST_DEBUG_OBJECT (pipeline, "setting task pool %" GST_PTR_FORMAT
+              " on task %" GST_PTR_FORMAT, pool, g_value_get_object (val));
+          gst_task_set_pool (GST_TASK (g_value_get_object (val)), pool);
+        }
+        gst_object_unref (pool);
+      }
+      break;
+    }
     case GST_MESSAGE_INSTANT_RATE_REQUEST:{
       guint32 seqnum = gst_message_get_seqnum (message);
       gdouble rate_multiplier;
@@ -244,6 +244,7 @@ gst_registry_chunks_save_feature (GList ** list, GstPluginFeature * feature)
   if (GST_IS_ELEMENT_FACTORY (feature)) {
     GstRegistryChunkElementFactory *ef;
     GstElementFactory *factory = GST_ELEMENT_FACTORY (feature);
+    const gchar *klass;
 
     /* Initialize with zeroes because of struct padding and
      * valgrind complaining about copying uninitialized memory
@@ -297,9 +298,20 @@ gst_registry_chunks_save_feature (GList ** list, GstPluginFeature * feature)
       }
     }
 
-    /* pack element metadata strings */
-    gst_registry_chunks_save_string (list,
-        gst_structure_to_string (factory->metadata));
+    /* pack element metadata strings, the klass is stored separately so that
+     * it can be read without parsing the metadata */
+    if (factory->metadata) {
+      klass = gst_structure_get_string (factory->metadata,
+          GST_ELEMENT_METADATA_KLASS);
+      gst_registry_chunks_save_const_string (list, klass ? klass : "");
+      gst_registry_chunks_save_string (list,
+          gst_structure_to_string (factory->metadata));
+    } else {
+      gst_registry_chunks_save_const_string (list,
+          factory->klass ? factory->klass : "");
+      gst_registry_chunks_save_const_string (list,
+          factory->metadata_string ? factory->metadata_string : "");
+    }
   } else if (GST_IS_TYPE_FIND_FACTORY (feature)) {
     GstRegistryChunkTypeFindFactory *tff;
     GstTypeFindFactory *factory = GST_TYPE_FIND_FACTORY (feature);
@@ -332,6 +344,9 @@ gst_registry_chunks_save_feature (GList ** list, GstPluginFeature * feature)
       gst_caps_unref (fcaps);
 
       gst_registry_chunks_save_string (list, str);
+    } else if (factory->caps_string) {
+      /* not parsed since it was loaded, already simplified */
+      gst_registry_chunks_save_const_string (list, factory->caps_string);
     } else {
       gst_registry_chunks_save_const_string (list, "");
     }
@@ -522,7 +537,7 @@ fail:
  */
 static gboolean
 gst_registry_chunks_load_pad_template (GstElementFactory * factory, gchar ** in,
-    gchar * end)
+    gchar * end, GBytes * cache)
 {
   GstRegistryChunkPadTemplate *pt;
   GstStaticPadTemplate *template = NULL;
@@ -537,9 +552,13 @@ gst_registry_chunks_load_pad_template (GstElementFactory * factory, gchar ** in,
   template->direction = (GstPadDirection) pt->direction;
   template->static_caps.caps = NULL;
 
-  /* unpack pad template strings */
+  /* unpack pad template strings. The caps can point into the cache, which
+   * is kept alive by the factory */
   unpack_const_string (*in, template->name_template, end, fail);
-  unpack_const_string (*in, template->static_caps.string, end, fail);
+  if (cache)
+    unpack_string_nocopy (*in, template->static_caps.string, end, fail);
+  else
+    unpack_const_string (*in, template->static_caps.string, end, fail);
 
   __gst_element_factory_add_static_pad_template (factory, template);
   GST_DEBUG ("Added pad_template %s", template->name_template);
@@ -561,7 +580,7 @@ fail:
  */
 static gboolean
 gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
-    gchar * end, GstPlugin * plugin)
+    gchar * end, GstPlugin * plugin, GBytes * cache)
 {
   GstRegistryChunkPluginFeature *pf = NULL;
   GstPluginFeature *feature = NULL;
@@ -609,7 +628,7 @@ gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
     guint n;
     GstElementFactory *factory = GST_ELEMENT_FACTORY_CAST (feature);
     gchar *str;
-    const gchar *meta_data_str;
+    const gchar *meta_data_str, *klass_str;
 
     align (*in);
     GST_LOG ("Reading/casting for GstRegistryChunkElementFactory at address %p",
@@ -619,13 +638,21 @@ gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
 
     /* unpack element factory strings */
     unpack_string_nocopy (*in, meta_data_str, end, fail);
+    unpack_string_nocopy (*in, klass_str, end, fail);
     if (meta_data_str && *meta_data_str) {
-      factory->metadata = gst_structure_from_string (meta_data_str, NULL);
-      if (!factory->metadata) {
-        GST_ERROR
-            ("Error when trying to deserialize structure for metadata '%s'",
-            meta_data_str);
-        goto fail;
+      if (cache) {
+        /* the metadata is parsed when it is first needed */
+        factory->metadata_string = meta_data_str;
+        factory->klass = klass_str;
+        factory->cache = g_bytes_ref (cache);
+      } else {
+        factory->metadata = gst_structure_from_string (meta_data_str, NULL);
+        if (!factory->metadata) {
+          GST_ERROR
+              ("Error when trying to deserialize structure for metadata '%s'",
+              meta_data_str);
+          goto fail;
+        }
       }
     }
     n = ef->npadtemplates;
@@ -634,7 +661,7 @@ gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
     /* load pad templates */
     for (i = 0; i < n; i++) {
       if (G_UNLIKELY (!gst_registry_chunks_load_pad_template (factory, in,
-                  end))) {
+                  end, factory->cache))) {
         GST_ERROR ("Error while loading binary pad template");
         goto fail;
       }
@@ -674,12 +701,18 @@ gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
     unpack_element (*in, tff, GstRegistryChunkTypeFindFactory, end, fail);
     pf = (GstRegistryChunkPluginFeature *) tff;
 
-    /* load typefinder caps */
+    /* load typefinder caps, parsed when first needed if the string stays
+     * around */
     unpack_string_nocopy (*in, const_str, end, fail);
-    if (const_str != NULL && *const_str != '\0')
-      factory->caps = gst_caps_from_string (const_str);
-    else
-      factory->caps = NULL;
+    factory->caps = NULL;
+    if (const_str != NULL && *const_str != '\0') {
+      if (cache) {
+        factory->caps_string = const_str;
+        factory->cache = g_bytes_ref (cache);
+      } else {
+        factory->caps = gst_caps_from_string (const_str);
+      }
+    }
 
     /* load extensions */
     if (tff->nextensions) {
@@ -825,10 +858,14 @@ fail:
  * Make a new GstPlugin from current GstRegistryChunkPluginElement structure
  * and add it to the GstRegistry. Return an offset to the next
  * GstRegistryChunkPluginElement structure.
+ *
+ * If @cache is not %NULL it contains the data that is read and stays
+ * unmodified for as long as it is referenced. The features then keep a
+ * reference and only parse metadata and caps when they are first used.
  */
 gboolean
 _priv_gst_registry_chunks_load_plugin (GstRegistry * registry, gchar ** in,
-    gchar * end, GstPlugin ** out_plugin)
+    gchar * end, GstPlugin ** out_plugin, GBytes * cache)
 {
 #ifndef GST_DISABLE_GST_DEBUG
   gchar *start = *in;
@@ -901,7 +938,7 @@ _priv_gst_registry_chunks_load_plugin (GstRegistry * registry, gchar ** in,
   /* Load plugin features */
   for (i = 0; i < n; i++) {
     if (G_UNLIKELY (!gst_registry_chunks_load_feature (registry, in, end,
-                plugin))) {
+                plugin, cache))) {
       GST_ERROR ("Error while loading binary feature for plugin '%s'",
           GST_STR_NULL (plugin->desc.name));
       gst_registry_remove_plugin (registry, plugin);
@@ -86,6 +86,10 @@
 GST_DEBUG_CATEGORY_STATIC (task_debug);
 #define GST_CAT_DEFAULT (task_debug)
 
+/* how long a task runs on a worker of a GstWorkStealingTaskPool before it
+ * gives other tasks a chance to run */
+#define COOPERATIVE_TIME_SLICE (G_TIME_SPAN_MILLISECOND)
+
 #define SET_TASK_STATE(t,s) (g_atomic_int_set (&GST_TASK_STATE(t), (s)))
 #define GET_TASK_STATE(t)   ((GstTaskState) g_atomic_int_get (&GST_TASK_STATE(t)))
 
@@ -121,6 +125,12 @@ struct _GstTaskPrivate
   /* remember the pool and id that is currently running. */
   gpointer id;
   GstTaskPool *pool_id;
+
+  /* running in time slices on a GstWorkStealingTaskPool */
+  gboolean cooperative;
+  gboolean entered;
+  /* paused and not scheduled on the pool */
+  gboolean parked;
 };
 
 #ifdef _MSC_VER
@@ -213,6 +223,7 @@ gst_task_win32_set_thread_name (const gchar * name)
 static void gst_task_finalize (GObject * object);
 
 static void gst_task_func (GstTask * task);
+static void gst_task_func_cooperative (GstTask * task);
 
 static GMutex pool_lock;
 
@@ -435,6 +446,146 @@ no_lock:
   }
 }
 
+/* Like gst_task_func() but instead of looping until the task stops, the task
+ * function is called for one time slice, after which the task pushes itself
+ * to the back of the queue of its worker. A paused task returns and is
+ * pushed again by gst_task_set_state().
+ *
+ * The enter and leave callbacks are called once, on the worker that runs the
+ * first and the last slice. */
+static void
+gst_task_func_cooperative (GstTask * task)
+{
+  GRecMutex *lock;
+  GThread *tself;
+  GstTaskPrivate *priv;
+  gint64 deadline;
+
+  priv = task->priv;
+
+  tself = g_thread_self ();
+
+  GST_OBJECT_LOCK (task);
+  if (G_UNLIKELY (!priv->entered)) {
+    GST_DEBUG ("Entering task %p, thread %p", task, tself);
+
+    if (GET_TASK_STATE (task) == GST_TASK_STOPPED)
+      goto exit;
+    if (G_UNLIKELY (GST_TASK_GET_LOCK (task) == NULL))
+      goto no_lock;
+    priv->entered = TRUE;
+    task->thread = tself;
+    GST_OBJECT_UNLOCK (task);
+
+    if (priv->enter_func)
+      priv->enter_func (task, tself, priv->enter_user_data);
+
+    GST_OBJECT_LOCK (task);
+  }
+  lock = GST_TASK_GET_LOCK (task);
+  task->thread = tself;
+  GST_OBJECT_UNLOCK (task);
+
+  /* locking order is TASK_LOCK, LOCK */
+  g_rec_mutex_lock (lock);
+
+  deadline = g_get_monotonic_time () + COOPERATIVE_TIME_SLICE;
+  do {
+    GST_OBJECT_LOCK (task);
+    if (G_UNLIKELY (GET_TASK_STATE (task) == GST_TASK_PAUSED)) {
+      g_rec_mutex_unlock (lock);
+
+      GST_INFO_OBJECT (task, "Task going to paused");
+      priv->parked = TRUE;
+      task->thread = NULL;
+      GST_TASK_SIGNAL (task);
+      GST_OBJECT_UNLOCK (task);
+      return;
+    }
+    if (G_UNLIKELY (GET_TASK_STATE (task) == GST_TASK_STOPPED)) {
+      GST_OBJECT_UNLOCK (task);
+      goto done;
+    }
+    GST_OBJECT_UNLOCK (task);
+
+    task->func (task->user_data);
+  } while (g_get_monotonic_time () < deadline);
+
+  g_rec_mutex_unlock (lock);
+
+  GST_OBJECT_LOCK (task);
+  task->thread = NULL;
+  switch (GET_TASK_STATE (task)) {
+    case GST_TASK_STARTED:
+      if (G_LIKELY (_priv_gst_work_stealing_task_pool_yield (priv->pool_id,
+                  (GstTaskPoolFunction) gst_task_func_cooperative, task))) {
+        GST_OBJECT_UNLOCK (task);
+        return;
+      }
+      g_warning ("task pool of task %p was cleaned up, stopping task", task);
+      SET_TASK_STATE (task, GST_TASK_STOPPED);
+      break;
+    case GST_TASK_PAUSED:
+      GST_INFO_OBJECT (task, "Task going to paused");
+      priv->parked = TRUE;
+      GST_TASK_SIGNAL (task);
+      GST_OBJECT_UNLOCK (task);
+      return;
+    case GST_TASK_STOPPED:
+      break;
+  }
+  goto exit;
+
+done:
+  g_rec_mutex_unlock (lock);
+
+  GST_OBJECT_LOCK (task);
+  task->thread = NULL;
+
+exit:
+  if (priv->leave_func) {
+    GST_OBJECT_UNLOCK (task);
+    priv->leave_func (task, tself, priv->leave_user_data);
+    GST_OBJECT_LOCK (task);
+  }
+  priv->entered = FALSE;
+  task->running = FALSE;
+  GST_TASK_SIGNAL (task);
+  GST_OBJECT_UNLOCK (task);
+
+  GST_DEBUG ("Exit task %p, thread %p", task, tself);
+
+  gst_object_unref (task);
+  return;
+
+no_lock:
+  {
+    g_warning ("starting task without a lock");
+    goto exit;
+  }
+}
+
+/* schedule a parked task again after a state change.
+ * Must be called with the task LOCK. */
+static void
+unpark_task (GstTask * task)
+{
+  GstTaskPrivate *priv = task->priv;
+
+  priv->parked = FALSE;
+  if (!_priv_gst_work_stealing_task_pool_yield (priv->pool_id,
+          (GstTaskPoolFunction) gst_task_func_cooperative, task)) {
+    g_warning ("task pool of task %p was cleaned up, stopping task", task);
+    SET_TASK_STATE (task, GST_TASK_STOPPED);
+    /* the task lock was released when parking */
+    priv->entered = FALSE;
+    task->running = FALSE;
+    GST_TASK_SIGNAL (task);
+    /* drop the ref of the pool, the caller holds one */
+    gst_object_unref (task);
+  }
+}
+
 /**
  * gst_task_cleanup_all:
  *
@@ -723,9 +874,12 @@ start_task (GstTask * task)
   /* push on the thread pool, we remember the original pool because the user
    * could change it later on and then we join to the wrong pool. */
   priv->pool_id = gst_object_ref (priv->pool);
+  priv->cooperative = GST_IS_WORK_STEALING_TASK_POOL (priv->pool_id);
+  priv->parked = FALSE;
   priv->id =
-      gst_task_pool_push (priv->pool_id, (GstTaskPoolFunction) gst_task_func,
-      task, &error);
+      gst_task_pool_push (priv->pool_id,
+      priv->cooperative ? (GstTaskPoolFunction) gst_task_func_cooperative :
+      (GstTaskPoolFunction) gst_task_func, task, &error);
 
   if (error != NULL) {
     g_warning ("failed to create thread: %s", error->message);
@@ -761,7 +915,10 @@ gst_task_set_state_unlocked (GstTask * task, GstTaskState state)
         break;
       case GST_TASK_PAUSED:
         /* when we are paused, signal to go to the new state */
-        GST_TASK_SIGNAL (task);
+        if (task->priv->parked)
+          unpark_task (task);
+        else
+          GST_TASK_SIGNAL (task);
         break;
       case GST_TASK_STARTED:
         /* if we were started, we'll go to the new state after the next
@@ -933,7 +1090,10 @@ gst_task_join (GstTask * task)
     goto joining_self;
   SET_TASK_STATE (task, GST_TASK_STOPPED);
   /* signal the state change for when it was blocked in PAUSED. */
-  GST_TASK_SIGNAL (task);
+  if (priv->parked)
+    unpark_task (task);
+  else
+    GST_TASK_SIGNAL (task);
   /* we set the running flag when pushing the task on the thread pool.
    * This means that the task function might not be called when we try
    * to join it here. */
@@ -28,6 +28,10 @@
  * This object provides an abstraction for creating threads. The default
  * implementation uses a regular GThreadPool to start tasks.
  *
+ * #GstSharedTaskPool runs tasks on a limited number of threads and
+ * #GstWorkStealingTaskPool runs them on a fixed number of worker threads per
+ * CPU core.
+ *
  * Subclasses can be made to create custom threads.
  */
 
@@ -546,3 +550,606 @@ gst_shared_task_pool_new (void)
 
   return pool;
 }
+
+/* GstWorkStealingTaskPool:
+ *
+ * Every worker has a local queue. Work pushed from a worker goes to the tail
+ * of its own queue and is taken from there again, so it runs on the same
+ * core while its data is still in the cache. Idle workers steal from the
+ * head of the queues of the other workers before they go to sleep.
+ *
+ * Work that blocks keeps its worker busy. A monitor thread checks at a fixed
+ * interval whether work is queued while all workers are busy and none of
+ * them picked up new work since the last check, and starts an extra worker
+ * in that case. Extra workers have no queue and exit again after being idle
+ * for a while, so in the worst case the pool falls back to one thread per
+ * blocked task like the default pool. */
+
+#define DEFAULT_WORKERS_PER_CORE 1
+#define MONITOR_INTERVAL (10 * G_TIME_SPAN_MILLISECOND)
+#define EXTRA_WORKER_IDLE_TIMEOUT (G_TIME_SPAN_SECOND)
+
+typedef struct
+{
+  GstWorkStealingTaskPool *pool;
+  GThread *thread;
+
+  /* local queue of SharedTaskData, extra workers have none */
+  gboolean has_queue;
+  GMutex lock;
+  GQueue queue;
+
+  guint next_victim;
+} WorkStealingWorker;
+
+struct _GstWorkStealingTaskPoolPrivate
+{
+  /* with OBJECT_LOCK */
+  guint workers_per_core;
+
+  /* fixed between prepare and cleanup */
+  WorkStealingWorker *workers;
+  guint n_workers;
+  GThread *monitor;
+
+  gint running;                 /* ATOMIC, modified with lock */
+  gint pending;                 /* ATOMIC, items pushed and not taken yet */
+  gint n_idle;                  /* ATOMIC, modified with lock */
+  gint dispatched;              /* ATOMIC */
+  gint next_worker;             /* ATOMIC */
+  gint monitor_waiting;         /* ATOMIC, modified with lock */
+  gint pushing;                 /* ATOMIC, pushes that may still queue */
+
+  GMutex lock;
+  GCond idle_cond;
+  GCond monitor_cond;
+  GCond push_cond;
+  /* with lock */
+  gboolean stopping;
+  guint n_total;
+  GList *extra_workers;
+};
+
+#define GST_WORK_STEALING_TASK_POOL_CAST(pool) ((GstWorkStealingTaskPool*)(pool))
+
+static GPrivate current_worker;
+
+G_DEFINE_TYPE_WITH_PRIVATE (GstWorkStealingTaskPool,
+    gst_work_stealing_task_pool, GST_TYPE_TASK_POOL);
+
+static SharedTaskData *
+work_stealing_take (GstWorkStealingTaskPool * pool, WorkStealingWorker * self)
+{
+  GstWorkStealingTaskPoolPrivate *priv = pool->priv;
+  SharedTaskData *tdata = NULL;
+  guint i;
+
+  if (self->has_queue) {
+    g_mutex_lock (&self->lock);
+    tdata = g_queue_pop_tail (&self->queue);
+    g_mutex_unlock (&self->lock);
+  }
+
+  if (tdata == NULL && g_atomic_int_get (&priv->pending) > 0) {
+    for (i = 0; i < priv->n_workers && tdata == NULL; i++) {
+      WorkStealingWorker *victim;
+
+      victim = &priv->workers[self->next_victim++ % priv->n_workers];
+      if (victim == self)
+        continue;
+
+      g_mutex_lock (&victim->lock);
+      tdata = g_queue_pop_head (&victim->queue);
+      g_mutex_unlock (&victim->lock);
+    }
+  }
+
+  if (tdata)
+    g_atomic_int_add (&priv->pending, -1);
+
+  return tdata;
+}
+
+static gpointer
+work_stealing_worker_func (WorkStealingWorker * self)
+{
+  GstWorkStealingTaskPool *pool = self->pool;
+  GstWorkStealingTaskPoolPrivate *priv = pool->priv;
+  gboolean detach = FALSE;
+
+  g_private_set (&current_worker, self);
+
+  while (TRUE) {
+    SharedTaskData *tdata;
+    gboolean quit = FALSE;
+
+    if ((tdata = work_stealing_take (pool, self))) {
+      g_atomic_int_inc (&priv->dispatched);
+      shared_func (tdata, GST_TASK_POOL_CAST (pool));
+      continue;
+    }
+
+    g_mutex_lock (&priv->lock);
+    /* announce that we are idle before checking for work again, a
+     * concurrent push either sees us idle or we see its work */
+    g_atomic_int_inc (&priv->n_idle);
+    while (g_atomic_int_get (&priv->pending) == 0) {
+      if (priv->stopping) {
+        quit = TRUE;
+        break;
+      }
+      if (self->has_queue) {
+        g_cond_wait (&priv->idle_cond, &priv->lock);
+      } else if (!g_cond_wait_until (&priv->idle_cond, &priv->lock,
+              g_get_monotonic_time () + EXTRA_WORKER_IDLE_TIMEOUT)) {
+        if (g_atomic_int_get (&priv->pending) == 0
+            && g_atomic_int_get (&priv->running)) {
+          GST_DEBUG_OBJECT (pool, "extra worker %p idle, exiting", self);
+          priv->extra_workers = g_list_remove (priv->extra_workers, self);
+          priv->n_total--;
+          quit = detach = TRUE;
+        }
+        break;
+      }
+    }
+    g_atomic_int_add (&priv->n_idle, -1);
+    g_mutex_unlock (&priv->lock);
+
+    if (quit)
+      break;
+  }
+
+  g_private_set (&current_worker, NULL);
+
+  if (detach) {
+    g_thread_unref (self->thread);
+    g_free (self);
+  }
+
+  return NULL;
+}
+
+/* called with lock */
+static gboolean
+work_stealing_spawn_extra (GstWorkStealingTaskPool * pool)
+{
+  GstWorkStealingTaskPoolPrivate *priv = pool->priv;
+  WorkStealingWorker *worker;
+  GError *error = NULL;
+
+  worker = g_new0 (WorkStealingWorker, 1);
+  worker->pool = pool;
+  worker->has_queue = FALSE;
+
+  worker->thread = g_thread_try_new ("taskpool-extra",
+      (GThreadFunc) work_stealing_worker_func, worker, &error);
+  if (error) {
+    GST_WARNING_OBJECT (pool, "failed to start extra worker: %s",
+        error->message);
+    g_clear_error (&error);
+    g_free (worker);
+    return FALSE;
+  }
+
+  priv->extra_workers = g_list_prepend (priv->extra_workers, worker);
+  priv->n_total++;
+
+  GST_DEBUG_OBJECT (pool, "all %u workers blocked, started extra worker %p",
+      priv->n_total - 1, worker);
+
+  return TRUE;
+}
+
+static gpointer
+work_stealing_monitor_func (GstWorkStealingTaskPool * pool)
+{
+  GstWorkStealingTaskPoolPrivate *priv = pool->priv;
+  gint last_dispatched;
+
+  g_mutex_lock (&priv->lock);
+  last_dispatched = g_atomic_int_get (&priv->dispatched);
+  while (g_atomic_int_get (&priv->running)) {
+    gint dispatched;
+
+    if (g_atomic_int_get (&priv->n_idle) == priv->n_total
+        && g_atomic_int_get (&priv->pending) == 0) {
+      /* nothing runs, nothing can block. Sleep until the next push */
+      g_atomic_int_set (&priv->monitor_waiting, 1);
+      if (g_atomic_int_get (&priv->pending) == 0)
+        g_cond_wait (&priv->monitor_cond, &priv->lock);
+      g_atomic_int_set (&priv->monitor_waiting, 0);
+      last_dispatched = g_atomic_int_get (&priv->dispatched);
+      continue;
+    }
+
+    g_cond_wait_until (&priv->monitor_cond, &priv->lock,
+        g_get_monotonic_time () + MONITOR_INTERVAL);
+
+    dispatched = g_atomic_int_get (&priv->dispatched);
+    if (g_atomic_int_get (&priv->running)
+        && g_atomic_int_get (&priv->pending) > 0
+        && g_atomic_int_get (&priv->n_idle) == 0
+        && dispatched == last_dispatched)
+      work_stealing_spawn_extra (pool);
+    last_dispatched = dispatched;
+  }
+  g_mutex_unlock (&priv->lock);
+
+  return NULL;
+}
+
+static void
+work_stealing_push_done (GstWorkStealingTaskPoolPrivate * priv)
+{
+  if (g_atomic_int_dec_and_test (&priv->pushing)
+      && !g_atomic_int_get (&priv->running)) {
+    g_mutex_lock (&priv->lock);
+    g_cond_broadcast (&priv->push_cond);
+    g_mutex_unlock (&priv->lock);
+  }
+}
+
+static gboolean
+work_stealing_queue (GstWorkStealingTaskPool * pool, SharedTaskData * tdata,
+    gboolean yield)
+{
+  GstWorkStealingTaskPoolPrivate *priv = pool->priv;
+  WorkStealingWorker *worker;
+
+  /* announce the push before checking if we are running. Cleanup clears
+   * running before it waits for the announced pushes, so it either makes
+   * us fail here or waits until our work is queued and counted, and only
+   * then lets the workers exit and frees them */
+  g_atomic_int_inc (&priv->pushing);
+  if (G_UNLIKELY (!g_atomic_int_get (&priv->running))) {
+    work_stealing_push_done (priv);
+    return FALSE;
+  }
+
+  worker = g_private_get (&current_worker);
+  if (worker == NULL || worker->pool != pool || !worker->has_queue) {
+    guint idx;
+
+    idx = (guint) g_atomic_int_add (&priv->next_worker, 1) % priv->n_workers;
+    worker = &priv->workers[idx];
+  }
+
+  /* count before queueing so that no worker goes to sleep or exits while
+   * the item is on its way to the queue */
+  g_atomic_int_inc (&priv->pending);
+
+  g_mutex_lock (&worker->lock);
+  /* the owner takes new work from the tail. Yielded work goes to the head,
+   * behind everything else and first in line for thieves */
+  if (yield)
+    g_queue_push_head (&worker->queue, tdata);
+  else
+    g_queue_push_tail (&worker->queue, tdata);
+  g_mutex_unlock (&worker->lock);
+
+  if (g_atomic_int_get (&priv->n_idle) > 0
+      || g_atomic_int_get (&priv->monitor_waiting)) {
+    g_mutex_lock (&priv->lock);
+    g_cond_signal (&priv->idle_cond);
+    g_cond_signal (&priv->monitor_cond);
+    g_mutex_unlock (&priv->lock);
+  }
+
+  work_stealing_push_done (priv);
+
+  return TRUE;
+}
+
+static SharedTaskData *
+work_stealing_task_data_new (GstTaskPoolFunction func, gpointer user_data)
+{
+  SharedTaskData *tdata;
+
+  tdata = g_new (SharedTaskData, 1);
+  tdata->done = FALSE;
+  tdata->func = func;
+  tdata->user_data = user_data;
+  g_atomic_int_set (&tdata->refcount, 1);
+  g_cond_init (&tdata->done_cond);
+  g_mutex_init (&tdata->done_lock);
+
+  return tdata;
+}
+
+static gpointer
+work_stealing_push (GstTaskPool * pool, GstTaskPoolFunction func,
+    gpointer user_data, GError ** error)
+{
+  GstWorkStealingTaskPool *ws_pool = GST_WORK_STEALING_TASK_POOL_CAST (pool);
+  SharedTaskData *ret;
+
+  ret = work_stealing_task_data_new (func, user_data);
+
+  if (!work_stealing_queue (ws_pool, shared_task_data_ref (ret), FALSE)) {
+    /* drop both refs */
+    shared_task_data_unref (ret);
+    shared_task_data_unref (ret);
+    g_set_error_literal (error, GST_CORE_ERROR, GST_CORE_ERROR_FAILED,
+        "No thread pool");
+    return NULL;
+  }
+
+  return ret;
+}
+
+/* Used by GstTask to give its worker back to the pool after a time slice.
+ * Returns %FALSE if the pool was cleaned up. */
+gboolean
+_priv_gst_work_stealing_task_pool_yield (GstTaskPool * pool,
+    GstTaskPoolFunction func, gpointer user_data)
+{
+  GstWorkStealingTaskPool *ws_pool = GST_WORK_STEALING_TASK_POOL_CAST (pool);
+  SharedTaskData *tdata;
+
+  tdata = work_stealing_task_data_new (func, user_data);
+  if (!work_stealing_queue (ws_pool, tdata, TRUE)) {
+    shared_task_data_unref (tdata);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+static void
+work_stealing_cleanup (GstTaskPool * pool)
+{
+  GstWorkStealingTaskPoolPrivate *priv =
+      GST_WORK_STEALING_TASK_POOL_CAST (pool)->priv;
+  GList *extra_workers, *l;
+  guint i;
+
+  g_mutex_lock (&priv->lock);
+  if (!g_atomic_int_get (&priv->running)) {
+    g_mutex_unlock (&priv->lock);
+    return;
+  }
+  g_atomic_int_set (&priv->running, 0);
+  while (g_atomic_int_get (&priv->pushing) > 0)
+    g_cond_wait (&priv->push_cond, &priv->lock);
+  priv->stopping = TRUE;
+  g_cond_broadcast (&priv->idle_cond);
+  g_cond_signal (&priv->monitor_cond);
+  extra_workers = priv->extra_workers;
+  priv->extra_workers = NULL;
+  g_mutex_unlock (&priv->lock);
+
+  /* workers only exit once all queued work is done */
+  if (priv->monitor)
+    g_thread_join (priv->monitor);
+  priv->monitor = NULL;
+
+  for (i = 0; i < priv->n_workers; i++) {
+    WorkStealingWorker *worker = &priv->workers[i];
+
+    if (worker->thread)
+      g_thread_join (worker->thread);
+    g_mutex_clear (&worker->lock);
+  }
+  for (l = extra_workers; l; l = l->next) {
+    WorkStealingWorker *worker = l->data;
+
+    g_thread_join (worker->thread);
+    g_free (worker);
+  }
+  g_list_free (extra_workers);
+
+  g_free (priv->workers);
+  priv->workers = NULL;
+  priv->n_workers = 0;
+  priv->n_total = 0;
+}
+
+static void
+work_stealing_prepare (GstTaskPool * pool, GError ** error)
+{
+  GstWorkStealingTaskPool *ws_pool = GST_WORK_STEALING_TASK_POOL_CAST (pool);
+  GstWorkStealingTaskPoolPrivate *priv = ws_pool->priv;
+  guint i, n_workers;
+
+  if (g_atomic_int_get (&priv->running))
+    return;
+
+  GST_OBJECT_LOCK (pool);
+  n_workers = g_get_num_processors () * priv->workers_per_core;
+  GST_OBJECT_UNLOCK (pool);
+  n_workers = MAX (n_workers, 1);
+
+  priv->workers = g_new0 (WorkStealingWorker, n_workers);
+  for (i = 0; i < n_workers; i++) {
+    WorkStealingWorker *worker = &priv->workers[i];
+
+    worker->pool = ws_pool;
+    worker->has_queue = TRUE;
+    worker->next_victim = i + 1;
+    g_mutex_init (&worker->lock);
+    g_queue_init (&worker->queue);
+  }
+  priv->n_workers = priv->n_total = n_workers;
+  priv->stopping = FALSE;
+  g_atomic_int_set (&priv->running, 1);
+
+  GST_DEBUG_OBJECT (pool, "starting %u workers", n_workers);
+
+  for (i = 0; i < n_workers; i++) {
+    WorkStealingWorker *worker = &priv->workers[i];
+
+    worker->thread = g_thread_try_new ("taskpool-worker",
+        (GThreadFunc) work_stealing_worker_func, worker, error);
+    if (worker->thread == NULL)
+      goto failed;
+  }
+
+  priv->monitor = g_thread_try_new ("taskpool-mon",
+      (GThreadFunc) work_stealing_monitor_func, ws_pool, error);
+  if (priv->monitor == NULL)
+    goto failed;
+
+  return;
+
+failed:
+  {
+    GST_WARNING_OBJECT (pool, "failed to start threads");
+    work_stealing_cleanup (pool);
+    return;
+  }
+}
+
+static void
+gst_work_stealing_task_pool_finalize (GObject * object)
+{
+  GstWorkStealingTaskPoolPrivate *priv =
+      GST_WORK_STEALING_TASK_POOL_CAST (object)->priv;
+
+  work_stealing_cleanup (GST_TASK_POOL_CAST (object));
+
+  g_mutex_clear (&priv->lock);
+  g_cond_clear (&priv->idle_cond);
+  g_cond_clear (&priv->monitor_cond);
+  g_cond_clear (&priv->push_cond);
+
+  G_OBJECT_CLASS (gst_work_stealing_task_pool_parent_class)->finalize (object);
+}
+
+static void
+gst_work_stealing_task_pool_class_init (GstWorkStealingTaskPoolClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstTaskPoolClass *taskpoolclass = GST_TASK_POOL_CLASS (klass);
+
+  gobject_class->finalize = gst_work_stealing_task_pool_finalize;
+
+  taskpoolclass->prepare = work_stealing_prepare;
+  taskpoolclass->cleanup = work_stealing_cleanup;
+  taskpoolclass->push = work_stealing_push;
+  taskpoolclass->join = shared_join;
+  taskpoolclass->dispose_handle = shared_dispose_handle;
+}
+
+static void
+gst_work_stealing_task_pool_init (GstWorkStealingTaskPool * pool)
+{
+  GstWorkStealingTaskPoolPrivate *priv;
+
+  priv = pool->priv = gst_work_stealing_task_pool_get_instance_private (pool);
+  priv->workers_per_core = DEFAULT_WORKERS_PER_CORE;
+  g_mutex_init (&priv->lock);
+  g_cond_init (&priv->idle_cond);
+  g_cond_init (&priv->monitor_cond);
+  g_cond_init (&priv->push_cond);
+}
+
+/**
+ * gst_work_stealing_task_pool_set_workers_per_core:
+ * @pool: a #GstWorkStealingTaskPool
+ * @workers_per_core: number of worker threads per CPU core
+ *
+ * Configure how many worker threads @pool starts per CPU core. This only
+ * takes effect on the next gst_task_pool_prepare().
+ *
+ * Since: 1.26
+ */
+void
+gst_work_stealing_task_pool_set_workers_per_core (GstWorkStealingTaskPool *
+    pool, guint workers_per_core)
+{
+  g_return_if_fail (GST_IS_WORK_STEALING_TASK_POOL (pool));
+  g_return_if_fail (workers_per_core > 0);
+
+  GST_OBJECT_LOCK (pool);
+  pool->priv->workers_per_core = workers_per_core;
+  GST_OBJECT_UNLOCK (pool);
+}
+
+/**
+ * gst_work_stealing_task_pool_get_workers_per_core:
+ * @pool: a #GstWorkStealingTaskPool
+ *
+ * Returns: the number of worker threads per CPU core @pool is configured
+ * to start
+ *
+ * Since: 1.26
+ */
+guint
+gst_work_stealing_task_pool_get_workers_per_core (GstWorkStealingTaskPool *
+    pool)
+{
+  guint ret;
+
+  g_return_val_if_fail (GST_IS_WORK_STEALING_TASK_POOL (pool), 0);
+
+  GST_OBJECT_LOCK (pool);
+  ret = pool->priv->workers_per_core;
+  GST_OBJECT_UNLOCK (pool);
+
+  return ret;
+}
+
+/**
+ * gst_work_stealing_task_pool_new:
+ *
+ * Create a new work-stealing task pool. The pool runs the pushed functions
+ * on a fixed number of worker threads per CPU core, see
+ * gst_work_stealing_task_pool_set_workers_per_core().
+ *
+ * A #GstTask using this pool does not get a thread of its own. Instead it
+ * runs its function for a short time slice and then gives the worker back
+ * to the pool, and it does not use a worker at all while it is paused. The
+ * pool starts extra workers when all workers are blocked, so it can be used
+ * for inter-dependent pad tasks, but it only saves threads for tasks whose
+ * function does not block for long.
+ *
+ * Returns: (transfer full): a new #GstWorkStealingTaskPool.
+ * gst_object_unref() after usage.
+ *
+ * Since: 1.26
+ */
+GstTaskPool *
+gst_work_stealing_task_pool_new (void)
+{
+  GstTaskPool *pool;
+
+  pool = g_object_new (GST_TYPE_WORK_STEALING_TASK_POOL, NULL);
+
+  /* clear floating flag */
+  gst_object_ref_sink (pool);
+
+  return pool;
+}
+
+/**
+ * gst_work_stealing_task_pool_get_default:
+ *
+ * Get the work-stealing task pool that is shared by the whole process.
+ * Libraries that split their work over threads can push their functions to
+ * this pool when the application does not give them one, so that they all
+ * share the same workers instead of each starting threads of their own.
+ *
+ * The pool is prepared already and must not be cleaned up. It starts extra
+ * workers when all of its workers are blocked, so the functions pushed to it
+ * should not block for long.
+ *
+ * Returns: (transfer none): the shared #GstWorkStealingTaskPool.
+ *
+ * Since: 1.26
+ */
+GstTaskPool *
+gst_work_stealing_task_pool_get_default (void)
+{
+  static GstTaskPool *default_pool = NULL;
+
+  if (g_once_init_enter (&default_pool)) {
+    GstTaskPool *pool = gst_work_stealing_task_pool_new ();
+
+    gst_task_pool_prepare (pool, NULL);
+    GST_OBJECT_FLAG_SET (pool, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+
+    g_once_init_leave (&default_pool, pool);
+  }
+
+  return default_pool;
+}
@@ -84,6 +84,7 @@ typedef enum /*< skip >*/
   GST_TRACER_QUARK_HOOK_PAD_CHAIN_POST,
   GST_TRACER_QUARK_HOOK_PAD_CHAIN_LIST_PRE,
   GST_TRACER_QUARK_HOOK_PAD_CHAIN_LIST_POST,
+  GST_TRACER_QUARK_HOOK_CAPS_CACHE_LOOKUP,
   GST_TRACER_QUARK_MAX
 } GstTracerQuarkId;
 
@@ -839,6 +840,41 @@ typedef void (*GstTracerHookPadChainListPost) (GObject *self, GstClockTime ts,
     GstTracerHookPadChainListPost, (GST_TRACER_ARGS, pad, res)); \
 }G_STMT_END
 
+/**
+ * GstTracerHookCapsCacheLookup:
+ * @self: the tracer instance
+ * @ts: the current timestamp
+ * @caps1: the first #GstCaps of the operation
+ * @caps2: the second #GstCaps of the operation
+ * @operation: the name of the cached operation, "intersect-zig-zag",
+ *     "intersect-first", "is-subset" or "can-intersect"
+ * @hit: whether the result was found in the cache
+ *
+ * Hook called when the caps cache enabled with `GST_CAPS_CACHE_SIZE` is
+ * looked up, named "caps-cache-lookup".
+ *
+ * Since: 1.26
+ */
+typedef void (*GstTracerHookCapsCacheLookup) (GObject *self, GstClockTime ts,
+    const GstCaps *caps1, const GstCaps *caps2, const gchar *operation,
+    gboolean hit);
+
+/**
+ * GST_TRACER_CAPS_CACHE_LOOKUP:
+ * @caps1: a #GstCaps
+ * @caps2: a #GstCaps
+ * @operation: the name of the operation
+ * @hit: a #gboolean
+ *
+ * Dispatches the "caps-cache-lookup" hook.
+ *
+ * Since: 1.26
+ */
+#define GST_TRACER_CAPS_CACHE_LOOKUP(caps1, caps2, operation, hit) G_STMT_START{ \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_CAPS_CACHE_LOOKUP), \
+    GstTracerHookCapsCacheLookup, (GST_TRACER_ARGS, caps1, caps2, operation, hit)); \
+}G_STMT_END
+
 #else /* !GST_DISABLE_GST_TRACER_HOOKS */
 
 static inline void
@@ -892,6 +928,7 @@ _priv_gst_tracing_deinit (void)
 #define GST_TRACER_PAD_CHAIN_POST(pad, res)
 #define GST_TRACER_PAD_CHAIN_LIST_PRE(pad, list)
 #define GST_TRACER_PAD_CHAIN_LIST_POST(pad, res)
+#define GST_TRACER_CAPS_CACHE_LOOKUP(caps1, caps2, operation, hit)
 
 #endif /* GST_DISABLE_GST_TRACER_HOOKS */
 
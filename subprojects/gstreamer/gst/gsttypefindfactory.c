@@ -120,6 +120,11 @@ gst_type_find_factory_dispose (GObject * object)
     gst_caps_unref (factory->caps);
     factory->caps = NULL;
   }
+  factory->caps_string = NULL;
+  if (factory->cache) {
+    g_bytes_unref (factory->cache);
+    factory->cache = NULL;
+  }
   if (factory->extensions) {
     g_strfreev (factory->extensions);
     factory->extensions = NULL;
@@ -164,9 +169,23 @@ gst_type_find_factory_get_list (void)
 GstCaps *
 gst_type_find_factory_get_caps (GstTypeFindFactory * factory)
 {
+  GstCaps *caps;
+
   g_return_val_if_fail (GST_IS_TYPE_FIND_FACTORY (factory), NULL);
 
-  return factory->caps;
+  caps = g_atomic_pointer_get (&factory->caps);
+  if (caps == NULL && factory->caps_string) {
+    /* loaded from the registry cache, parse on first use */
+    caps = gst_caps_from_string (factory->caps_string);
+    if (caps != NULL
+        && !g_atomic_pointer_compare_and_exchange (&factory->caps, NULL,
+            caps)) {
+      gst_caps_unref (caps);
+      caps = g_atomic_pointer_get (&factory->caps);
+    }
+  }
+
+  return caps;
 }
 
 /**
@@ -169,6 +169,39 @@ struct _GstValueList
 #define VALUE_LIST_GET_VALUE(v, index) ((const GValue *) &(VALUE_LIST_ARRAY(v)->fields[index]))
 #define VALUE_LIST_IS_USING_DYNAMIC_ARRAY(array) ((array)->fields != &(array)->arr[0])
 
+/* Same as G_VALUE_INTERNED_STRING, which only exists since GLib 2.66. Strings
+ * with this flag are interned and can be shared between values */
+#ifndef G_VALUE_INTERNED_STRING
+#define G_VALUE_INTERNED_STRING (1 << 28)
+#endif
+
+/* Unquoted strings in caps and structure strings that are at most this long
+ * are shared with an already interned string when parsed */
+#define INTERNED_STRING_MAX_LEN 32
+
+/* Common string values of caps fields. They are interned on initialization,
+ * parsing only reuses strings that are already interned so that parsed caps
+ * can't grow the table of interned strings */
+static const gchar *const interned_caps_strings[] = {
+  /* raw video formats */
+  "I420", "YV12", "NV12", "NV21", "NV16", "NV24", "Y42B", "Y444", "YUY2",
+  "UYVY", "YVYU", "AYUV", "VUYA", "RGBx", "BGRx", "xRGB", "xBGR", "RGBA",
+  "BGRA", "ARGB", "ABGR", "RGB", "BGR", "RGB16", "GRAY8", "GRAY16_LE",
+  "I420_10LE", "I422_10LE", "Y444_10LE", "P010_10LE", "P016_LE", "v210",
+  "A420", "GBR", "GBRA", "RGBP", "BGRP",
+  /* raw audio formats and layouts */
+  "S8", "U8", "S16LE", "S16BE", "U16LE", "S24LE", "S24_32LE", "S32LE",
+  "S32BE", "F32LE", "F32BE", "F64LE", "F64BE", "interleaved",
+  "non-interleaved",
+  /* video info fields */
+  "progressive", "mixed", "alternate", "mpeg2", "jpeg",
+  "dv", "bt601", "bt709", "bt2020", "bt2100-pq", "bt2100-hlg", "sRGB",
+  "top-field-first", "bottom-field-first", "one-field",
+  /* encoded stream fields */
+  "byte-stream", "avc", "avc3", "hvc1", "hev1", "au", "nal", "frame",
+  "raw", "adts", "adif", "loas", "obu-stream", "tu",
+};
+
 static GArray *gst_value_table;
 static GHashTable *gst_value_hash;
 static GstValueTable *gst_value_tables_fundamental[FUNDAMENTAL_TYPE_ID_MAX + 1];
@@ -2754,6 +2787,31 @@ ok:
   return ret;
 }
 
+/* Short strings that are not quoted are mostly format names and similar
+ * identifiers from a small vocabulary. When they are already interned, like
+ * the interned_caps_strings and field names, share the interned string so
+ * that copying them doesn't need to allocate. New strings are never interned
+ * here, the caps strings can come from the application. */
+static void
+_priv_gst_value_intern_string (GValue * value)
+{
+  const gchar *str = g_value_get_string (value);
+  GQuark quark;
+
+  if (str == NULL || (value->data[1].v_uint & G_VALUE_NOCOPY_CONTENTS))
+    return;
+
+  if (strlen (str) > INTERNED_STRING_MAX_LEN)
+    return;
+
+  quark = g_quark_try_string (str);
+  if (quark == 0)
+    return;
+
+  g_value_set_static_string (value, g_quark_to_string (quark));
+  value->data[1].v_uint |= G_VALUE_INTERNED_STRING;
+}
+
 gboolean
 _priv_gst_value_parse_value (gchar * str,
     gchar ** after, GValue * value, GType default_type, GParamSpec * pspec)
@@ -2874,6 +2932,8 @@ _priv_gst_value_parse_value (gchar * str,
       if (G_UNLIKELY (!ret))
         g_value_unset (value);
     }
+    if (ret && G_VALUE_TYPE (value) == G_TYPE_STRING && *value_s != '"')
+      _priv_gst_value_intern_string (value);
     g_free (value_s);
   }
 
@@ -3810,6 +3870,10 @@ gst_value_deserialize_float (GValue * dest, const gchar * s)
 static gint
 gst_value_compare_string (const GValue * value1, const GValue * value2)
 {
+  /* same or both interned strings */
+  if (value1->data[0].v_pointer == value2->data[0].v_pointer)
+    return GST_VALUE_EQUAL;
+
   if (G_UNLIKELY (!value1->data[0].v_pointer || !value2->data[0].v_pointer)) {
     /* if only one is NULL, no match - otherwise both NULL == EQUAL */
     if (value1->data[0].v_pointer != value2->data[0].v_pointer)
@@ -6621,6 +6685,33 @@ gst_value_register (const GstValueTable * table)
   gst_value_hash_add_type (table->type, table);
 }
 
+/* Values of these types are stored completely inside the GValue and don't
+ * own any memory, so copying them doesn't need to go through the value table */
+static inline gboolean
+gst_value_is_inline (GType type, const GValue * value)
+{
+  switch (G_TYPE_FUNDAMENTAL (type)) {
+    case G_TYPE_CHAR:
+    case G_TYPE_UCHAR:
+    case G_TYPE_BOOLEAN:
+    case G_TYPE_INT:
+    case G_TYPE_UINT:
+    case G_TYPE_LONG:
+    case G_TYPE_ULONG:
+    case G_TYPE_INT64:
+    case G_TYPE_UINT64:
+    case G_TYPE_ENUM:
+    case G_TYPE_FLAGS:
+    case G_TYPE_FLOAT:
+    case G_TYPE_DOUBLE:
+      return TRUE;
+    case G_TYPE_STRING:
+      return (value->data[1].v_uint & G_VALUE_INTERNED_STRING) != 0;
+    default:
+      return type == GST_TYPE_FRACTION || type == GST_TYPE_INT_RANGE;
+  }
+}
+
 /**
  * gst_value_init_and_copy:
  * @dest: (out caller-allocates): the target value
@@ -6638,6 +6729,11 @@ gst_value_init_and_copy (GValue * dest, const GValue * src)
   g_return_if_fail (dest != NULL);
 
   type = G_VALUE_TYPE (src);
+  if (gst_value_is_inline (type, src)) {
+    *dest = *src;
+    return;
+  }
+
   /* We need to shortcut GstValueList/GstValueArray copying because:
    * * g_value_init would end up allocating something
    * * which g_value_copy would then free and re-alloc.
@@ -8302,6 +8398,11 @@ static const gint GST_VALUE_SUBTRACT_TABLE_DEFAULT_SIZE = 16;
 void
 _priv_gst_value_initialize (void)
 {
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (interned_caps_strings); i++)
+    g_intern_static_string (interned_caps_strings[i]);
+
   gst_value_table =
       g_array_sized_new (FALSE, FALSE, sizeof (GstValueTable),
       GST_VALUE_TABLE_DEFAULT_SIZE);
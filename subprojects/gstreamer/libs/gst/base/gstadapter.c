@@ -128,6 +128,7 @@
 #include "gstadapter.h"
 #include <string.h>
 #include <gst/base/gstqueuearray.h>
+#include "gstbytescan-private.h"
 
 /* default size for the assembled data buffer */
 #define DEFAULT_SIZE 4096
@@ -1626,6 +1627,80 @@ gst_adapter_prev_dts_at_offset (GstAdapter * adapter, gsize offset,
   return dts;
 }
 
+/* Scans the @size bytes at @data, which follow the @scanned bytes that were
+ * scanned before them and whose last 3 bytes are in @state. Returns the
+ * position of the match counted from the start of the scan, with the matching
+ * value in @state, or -1 when there was none. */
+static gssize
+gst_adapter_scan_chunk (const guint8 * data, gsize size, guint32 mask,
+    guint32 pattern, guint32 * state, gsize * scanned)
+{
+  gsize i, n;
+  gssize pos;
+
+  /* matches that start in the previous chunks */
+  n = MIN (size, 3);
+  for (i = 0; i < n; i++) {
+    *state = ((*state << 8) | data[i]);
+    if (G_UNLIKELY ((*state & mask) == pattern) && *scanned + i >= 3)
+      return *scanned + i - 3;
+  }
+
+  /* matches that are completely in this chunk */
+  pos = _gst_byte_scan_masked_uint32 (data, size, mask, pattern);
+  if (pos != -1) {
+    *state = GST_READ_UINT32_BE (data + pos);
+    return *scanned + pos;
+  }
+
+  /* keep the last bytes for the next chunk */
+  for (i = size > 6 ? size - 3 : n; i < size; i++)
+    *state = ((*state << 8) | data[i]);
+  *scanned += size;
+
+  return -1;
+}
+
+/* Scans @len bytes of @buf from @skip on, one memory at a time so that
+ * buffers with multiple memories don't get merged. Returns %TRUE when the
+ * scan is done, with the position of the match or -1 in @pos. */
+static gboolean
+gst_adapter_scan_buffer (GstBuffer * buf, gsize skip, gsize len,
+    guint32 mask, guint32 pattern, guint32 * state, gsize * scanned,
+    gssize * pos)
+{
+  guint i, n;
+
+  n = gst_buffer_n_memory (buf);
+  for (i = 0; i < n && len > 0; i++) {
+    GstMemory *mem = gst_buffer_peek_memory (buf, i);
+    GstMapInfo info;
+    gsize chunk;
+
+    if (skip >= mem->size) {
+      skip -= mem->size;
+      continue;
+    }
+
+    if (!gst_memory_map (mem, &info, GST_MAP_READ)) {
+      *pos = -1;
+      return TRUE;
+    }
+    chunk = MIN (info.size - skip, len);
+    *pos = gst_adapter_scan_chunk (info.data + skip, chunk, mask, pattern,
+        state, scanned);
+    gst_memory_unmap (mem, &info);
+
+    if (*pos != -1)
+      return TRUE;
+
+    len -= chunk;
+    skip = 0;
+  }
+
+  return FALSE;
+}
+
 /**
  * gst_adapter_masked_scan_uint32_peek:
  * @adapter: a #GstAdapter
@@ -1653,11 +1728,10 @@ gssize
 gst_adapter_masked_scan_uint32_peek (GstAdapter * adapter, guint32 mask,
     guint32 pattern, gsize offset, gsize size, guint32 * value)
 {
-  gsize skip, bsize, i;
+  gsize skip, bsize, len, scanned;
   guint32 state;
-  GstMapInfo info;
-  guint8 *bdata;
   GstBuffer *buf;
+  gssize pos;
   guint idx;
 
   g_return_val_if_fail (size > 0, -1);
@@ -1689,53 +1763,34 @@ gst_adapter_masked_scan_uint32_peek (GstAdapter * adapter, guint32 mask,
     buf = gst_vec_deque_peek_nth (adapter->bufqueue, idx++);
     bsize = gst_buffer_get_size (buf);
   }
-  /* get the data now */
-  if (!gst_buffer_map (buf, &info, GST_MAP_READ))
-    return -1;
-
-  bdata = (guint8 *) info.data + skip;
-  bsize = info.size - skip;
-  skip = 0;
 
   /* set the state to something that does not match */
   state = ~pattern;
+  scanned = 0;
 
   /* now find data */
   do {
-    bsize = MIN (bsize, size);
-    for (i = 0; i < bsize; i++) {
-      state = ((state << 8) | bdata[i]);
-      if (G_UNLIKELY ((state & mask) == pattern)) {
-        /* we have a match but we need to have skipped at
-         * least 4 bytes to fill the state. */
-        if (G_LIKELY (skip + i >= 3)) {
-          if (G_LIKELY (value))
-            *value = state;
-          gst_buffer_unmap (buf, &info);
-          return offset + skip + i - 3;
-        }
-      }
+    len = MIN (bsize - skip, size);
+    if (gst_adapter_scan_buffer (buf, skip, len, mask, pattern, &state,
+            &scanned, &pos)) {
+      if (pos == -1)
+        return -1;
+      if (G_LIKELY (value))
+        *value = state;
+      return offset + pos;
     }
-    size -= bsize;
+    size -= len;
     if (size == 0)
       break;
 
     /* nothing found yet, go to next buffer */
-    skip += bsize;
-    adapter->scan_offset += info.size;
+    skip = 0;
+    adapter->scan_offset += bsize;
     adapter->scan_entry_idx = idx;
-    gst_buffer_unmap (buf, &info);
     buf = gst_vec_deque_peek_nth (adapter->bufqueue, idx++);
-
-    if (!gst_buffer_map (buf, &info, GST_MAP_READ))
-      return -1;
-
-    bsize = info.size;
-    bdata = info.data;
+    bsize = gst_buffer_get_size (buf);
   } while (TRUE);
 
-  gst_buffer_unmap (buf, &info);
-
   /* nothing found */
   return -1;
 }
@@ -1791,3 +1846,37 @@ gst_adapter_masked_scan_uint32 (GstAdapter * adapter, guint32 mask,
   return gst_adapter_masked_scan_uint32_peek (adapter, mask, pattern, offset,
       size, NULL);
 }
+
+/**
+ * gst_adapter_find_start_code:
+ * @adapter: a #GstAdapter
+ * @offset: offset into the adapter data from which to start scanning
+ * @size: number of bytes to scan from offset
+ * @value: (out) (optional): pointer to uint32 to return the start code
+ *
+ * Scan for the first 0x00 0x00 0x01 start code prefix, as used by MPEG-1/2/4
+ * video, H.264 and H.265 streams, in the adapter data starting from offset
+ * @offset. If a start code is found, it is returned together with the byte
+ * following the prefix through @value, otherwise @value is left untouched.
+ *
+ * The data is scanned in place, also when a start code straddles the memories
+ * of the queued buffers, so no data is merged or copied.
+ *
+ * This is equivalent to calling gst_adapter_masked_scan_uint32_peek() with
+ * 0xffffff00 as mask and 0x00000100 as pattern.
+ *
+ * It is an error to call this function without making sure that there is
+ * enough data (offset+size bytes) in the adapter.
+ *
+ * Returns: offset of the first start code, or -1 if none was found.
+ *
+ * Since: 1.26
+ */
+gssize
+gst_adapter_find_start_code (GstAdapter * adapter, gsize offset, gsize size,
+    guint32 * value)
+{
+  return gst_adapter_masked_scan_uint32_peek (adapter,
+      GST_BYTE_SCAN_START_CODE_MASK, GST_BYTE_SCAN_START_CODE_PATTERN, offset,
+      size, value);
+}
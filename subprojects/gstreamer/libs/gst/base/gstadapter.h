@@ -142,6 +142,10 @@ GST_BASE_API
 gssize                  gst_adapter_masked_scan_uint32_peek  (GstAdapter * adapter, guint32 mask,
                                                          guint32 pattern, gsize offset, gsize size, guint32 * value);
 
+GST_BASE_API
+gssize                  gst_adapter_find_start_code     (GstAdapter * adapter, gsize offset,
+                                                         gsize size, guint32 * value);
+
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstAdapter, gst_object_unref)
 
 G_END_DECLS
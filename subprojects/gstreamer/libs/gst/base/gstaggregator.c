@@ -421,6 +421,10 @@ struct _GstAggregatorPrivate
   gboolean emit_signals;
   gboolean ignore_inactive_pads;
   gboolean force_live;          /* Construct only, doesn't need any locking */
+
+  /* protected by the object lock */
+  guint prepare_threads;
+  GstTaskPool *prepare_pool;
 };
 
 /* With SRC_LOCK */
@@ -449,6 +453,7 @@ typedef struct
 #define DEFAULT_START_TIME           (-1)
 #define DEFAULT_EMIT_SIGNALS         FALSE
 #define DEFAULT_FORCE_LIVE           FALSE
+#define DEFAULT_PREPARE_THREADS      1
 
 enum
 {
@@ -458,6 +463,7 @@ enum
   PROP_START_TIME_SELECTION,
   PROP_START_TIME,
   PROP_EMIT_SIGNALS,
+  PROP_PREPARE_THREADS,
   PROP_LAST
 };
 
@@ -2827,6 +2833,11 @@ gst_aggregator_finalize (GObject * object)
   g_mutex_clear (&self->priv->src_lock);
   g_cond_clear (&self->priv->src_cond);
 
+  if (self->priv->prepare_pool) {
+    gst_task_pool_cleanup (self->priv->prepare_pool);
+    gst_object_unref (self->priv->prepare_pool);
+  }
+
   G_OBJECT_CLASS (aggregator_parent_class)->finalize (object);
 }
 
@@ -2905,6 +2916,16 @@ gst_aggregator_get_latency_property (GstAggregator * agg)
   return res;
 }
 
+/* with the object lock */
+static guint
+gst_aggregator_n_prepare_threads_unlocked (GstAggregator * self)
+{
+  if (self->priv->prepare_threads == 0)
+    return g_get_num_processors ();
+
+  return self->priv->prepare_threads;
+}
+
 static void
 gst_aggregator_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
@@ -2929,6 +2950,15 @@ gst_aggregator_set_property (GObject * object, guint prop_id,
     case PROP_EMIT_SIGNALS:
       agg->priv->emit_signals = g_value_get_boolean (value);
       break;
+    case PROP_PREPARE_THREADS:
+      GST_OBJECT_LOCK (agg);
+      agg->priv->prepare_threads = g_value_get_uint (value);
+      if (agg->priv->prepare_pool)
+        gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL
+            (agg->priv->prepare_pool),
+            gst_aggregator_n_prepare_threads_unlocked (agg));
+      GST_OBJECT_UNLOCK (agg);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2959,6 +2989,11 @@ gst_aggregator_get_property (GObject * object, guint prop_id,
     case PROP_EMIT_SIGNALS:
       g_value_set_boolean (value, agg->priv->emit_signals);
       break;
+    case PROP_PREPARE_THREADS:
+      GST_OBJECT_LOCK (agg);
+      g_value_set_uint (value, agg->priv->prepare_threads);
+      GST_OBJECT_UNLOCK (agg);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3065,6 +3100,24 @@ gst_aggregator_class_init (GstAggregatorClass * klass)
           "Send signals", DEFAULT_EMIT_SIGNALS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAggregator:prepare-threads:
+   *
+   * Maximum number of threads on which the data of the sink pads is prepared
+   * before it is aggregated, for subclasses that prepare their pads with
+   * gst_aggregator_prepare_sink_pads(). With 1 all the pads are prepared in
+   * turn from the aggregating thread, 0 uses as many threads as there are
+   * processors.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_PREPARE_THREADS,
+      g_param_spec_uint ("prepare-threads", "Prepare threads",
+          "Maximum number of threads used to prepare the sink pads before "
+          "aggregating (0 = number of processors, 1 = aggregating thread)",
+          0, G_MAXUINT, DEFAULT_PREPARE_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstAggregator::samples-selected:
    * @aggregator: The #GstAggregator that emitted the signal
@@ -3147,6 +3200,7 @@ gst_aggregator_init (GstAggregator * self, GstAggregatorClass * klass)
   self->priv->start_time_selection = DEFAULT_START_TIME_SELECTION;
   self->priv->start_time = DEFAULT_START_TIME;
   self->priv->force_live = DEFAULT_FORCE_LIVE;
+  self->priv->prepare_threads = DEFAULT_PREPARE_THREADS;
 
   g_mutex_init (&self->priv->src_lock);
   g_cond_init (&self->priv->src_cond);
@@ -4162,3 +4216,122 @@ gst_aggregator_set_force_live (GstAggregator * self, gboolean force_live)
 {
   self->priv->force_live = force_live;
 }
+
+typedef struct
+{
+  GstAggregator *self;
+  GstPad *pad;
+  GstElementForeachPadFunc func;
+  gpointer user_data;
+  gboolean ret;
+} PrepareData;
+
+static void
+gst_aggregator_prepare_pad (PrepareData * data)
+{
+  data->ret = data->func (GST_ELEMENT_CAST (data->self), data->pad,
+      data->user_data);
+}
+
+/**
+ * gst_aggregator_prepare_sink_pads:
+ * @self: a #GstAggregator
+ * @func: (scope call): function to call for each sink pad
+ * @user_data: (closure): user data passed to @func
+ *
+ * Calls @func for each of the sink pads of @self, for subclasses to prepare
+ * the data of their pads, like converting, scaling or resampling it, before
+ * they aggregate it. Depending on #GstAggregator:prepare-threads, the pads
+ * are prepared one after the other from the calling thread or concurrently
+ * on a pool of threads. Either way this only returns once @func returned for
+ * all the pads, so aggregating the prepared data afterwards in the order of
+ * the pads gives the same output in both cases.
+ *
+ * As with gst_element_foreach_sink_pad(), the pads that come after one for
+ * which @func returned %FALSE are not prepared when this is done from the
+ * calling thread. On the pool all the pads are prepared. As it can be called
+ * from other threads, @func must only touch the state of the pad it is called
+ * for and must not take locks that the caller of this function holds.
+ *
+ * Returns: %FALSE if @func returned %FALSE for one of the pads, %TRUE
+ * otherwise
+ *
+ * Since: 1.26
+ */
+gboolean
+gst_aggregator_prepare_sink_pads (GstAggregator * self,
+    GstElementForeachPadFunc func, gpointer user_data)
+{
+  GstTaskPool *pool = NULL;
+  PrepareData *data;
+  gpointer *ids = NULL;
+  gboolean ret = TRUE;
+  guint i, n_pads;
+  GList *l;
+
+  g_return_val_if_fail (GST_IS_AGGREGATOR (self), FALSE);
+  g_return_val_if_fail (func != NULL, FALSE);
+
+  GST_OBJECT_LOCK (self);
+  n_pads = GST_ELEMENT_CAST (self)->numsinkpads;
+  if (n_pads == 0) {
+    GST_OBJECT_UNLOCK (self);
+    return TRUE;
+  }
+
+  data = g_new (PrepareData, n_pads);
+  for (i = 0, l = GST_ELEMENT_CAST (self)->sinkpads; l; i++, l = l->next) {
+    data[i].self = self;
+    data[i].pad = gst_object_ref (l->data);
+    data[i].func = func;
+    data[i].user_data = user_data;
+    data[i].ret = TRUE;
+  }
+
+  if (n_pads > 1 && gst_aggregator_n_prepare_threads_unlocked (self) > 1) {
+    if (!self->priv->prepare_pool) {
+      self->priv->prepare_pool = gst_shared_task_pool_new ();
+      gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL
+          (self->priv->prepare_pool),
+          gst_aggregator_n_prepare_threads_unlocked (self));
+      gst_task_pool_prepare (self->priv->prepare_pool, NULL);
+    }
+    pool = gst_object_ref (self->priv->prepare_pool);
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  if (pool) {
+    GST_LOG_OBJECT (self, "Preparing %u pads in parallel", n_pads);
+
+    /* the first pad is prepared by this thread while the others are on the
+     * pool */
+    ids = g_new0 (gpointer, n_pads);
+    for (i = 1; i < n_pads; i++) {
+      ids[i] = gst_task_pool_push (pool,
+          (GstTaskPoolFunction) gst_aggregator_prepare_pad, &data[i], NULL);
+      if (!ids[i])
+        gst_aggregator_prepare_pad (&data[i]);
+    }
+    gst_aggregator_prepare_pad (&data[0]);
+    for (i = 1; i < n_pads; i++)
+      gst_task_pool_join (pool, ids[i]);
+
+    g_free (ids);
+    gst_object_unref (pool);
+  } else {
+    for (i = 0; i < n_pads; i++) {
+      gst_aggregator_prepare_pad (&data[i]);
+      if (!data[i].ret)
+        break;
+    }
+  }
+
+  for (i = 0; i < n_pads; i++) {
+    if (!data[i].ret)
+      ret = FALSE;
+    gst_object_unref (data[i].pad);
+  }
+  g_free (data);
+
+  return ret;
+}
@@ -2055,6 +2055,30 @@ handle_stepping (GstBaseSink * sink, GstSegment * segment,
   return step_end;
 }
 
+/* Gets the start and stop times of @buffer. Returns %TRUE if the subclass
+ * wants to synchronise on it. If it doesn't, the times are still filled in
+ * for tracking the position. */
+static gboolean
+gst_base_sink_get_buffer_times (GstBaseSink * basesink, GstBuffer * buffer,
+    GstClockTime * start, GstClockTime * stop)
+{
+  GstBaseSinkClass *bclass = GST_BASE_SINK_GET_CLASS (basesink);
+
+  *start = *stop = GST_CLOCK_TIME_NONE;
+
+  /* just get the times to see if we need syncing, if the retuned start is -1
+   * we don't sync. */
+  if (bclass->get_times)
+    bclass->get_times (basesink, buffer, start, stop);
+
+  if (GST_CLOCK_TIME_IS_VALID (*start))
+    return TRUE;
+
+  gst_base_sink_default_get_times (basesink, buffer, start, stop);
+
+  return FALSE;
+}
+
 /* with STREAM_LOCK, PREROLL_LOCK
  *
  * Returns %TRUE if the object needs synchronisation and takes therefore
@@ -2070,7 +2094,6 @@ gst_base_sink_get_sync_times (GstBaseSink * basesink, GstMiniObject * obj,
     gboolean * do_sync, gboolean * stepped, GstStepInfo * step,
     gboolean * step_end)
 {
-  GstBaseSinkClass *bclass;
   GstClockTime start, stop;     /* raw start/stop timestamps */
   guint64 cstart, cstop;        /* clipped raw timestamps */
   guint64 rstart, rstop, rnext; /* clipped timestamps converted to running time */
@@ -2083,8 +2106,6 @@ gst_base_sink_get_sync_times (GstBaseSink * basesink, GstMiniObject * obj,
   priv = basesink->priv;
   segment = &basesink->segment;
 
-  bclass = GST_BASE_SINK_GET_CLASS (basesink);
-
 again:
   /* start with nothing */
   start = stop = GST_CLOCK_TIME_NONE;
@@ -2143,23 +2164,32 @@ again:
         /* other events do not need syncing */
         return FALSE;
     }
+  } else if (GST_IS_BUFFER_LIST (obj)) {
+    GstBufferList *list = GST_BUFFER_LIST_CAST (obj);
+    guint len = gst_buffer_list_length (list);
+
+    /* a list is synchronised once, from the start of its first buffer to the
+     * end of its last buffer */
+    *do_sync = gst_base_sink_get_buffer_times (basesink,
+        gst_buffer_list_get (list, 0), &start, &stop);
+
+    if (len > 1) {
+      GstClockTime lstart, lstop;
+
+      gst_base_sink_get_buffer_times (basesink,
+          gst_buffer_list_get (list, len - 1), &lstart, &lstop);
+      if (!GST_CLOCK_TIME_IS_VALID (lstop))
+        lstop = lstart;
+
+      if (GST_CLOCK_TIME_IS_VALID (start) && GST_CLOCK_TIME_IS_VALID (lstop)
+          && lstop >= start && (!GST_CLOCK_TIME_IS_VALID (stop)
+              || lstop > stop))
+        stop = lstop;
+    }
   } else {
     /* else do buffer sync code */
-    GstBuffer *buffer = GST_BUFFER_CAST (obj);
-
-    /* just get the times to see if we need syncing, if the retuned start is -1
-     * we don't sync. */
-    if (bclass->get_times)
-      bclass->get_times (basesink, buffer, &start, &stop);
-
-    if (!GST_CLOCK_TIME_IS_VALID (start)) {
-      /* we don't need to sync but we still want to get the timestamps for
-       * tracking the position */
-      gst_base_sink_default_get_times (basesink, buffer, &start, &stop);
-      *do_sync = FALSE;
-    } else {
-      *do_sync = TRUE;
-    }
+    *do_sync = gst_base_sink_get_buffer_times (basesink, GST_BUFFER_CAST (obj),
+        &start, &stop);
   }
 
   GST_DEBUG_OBJECT (basesink, "got times start: %" GST_TIME_FORMAT
@@ -3114,8 +3144,8 @@ gst_base_sink_is_too_late (GstBaseSink * basesink, GstMiniObject * obj,
   if (max_lateness == -1)
     goto no_drop;
 
-  /* only check for buffers */
-  if (G_UNLIKELY (!GST_IS_BUFFER (obj)))
+  /* only check for buffers and buffer lists */
+  if (G_UNLIKELY (!GST_IS_BUFFER (obj) && !GST_IS_BUFFER_LIST (obj)))
     goto not_buffer;
 
   /* can't do check if we don't have a timestamp */
@@ -3771,6 +3801,7 @@ gst_base_sink_chain_unlocked (GstBaseSink * basesink, GstPad * pad,
   GstClockTime start = GST_CLOCK_TIME_NONE, end = GST_CLOCK_TIME_NONE;
   GstSegment *segment;
   GstBuffer *sync_buf;
+  guint n_buffers = 1;
   gboolean late, step_end, prepared = FALSE;
 
   if (G_UNLIKELY (basesink->flushing))
@@ -3782,7 +3813,8 @@ gst_base_sink_chain_unlocked (GstBaseSink * basesink, GstPad * pad,
   if (is_list) {
     GstBufferList *buffer_list = GST_BUFFER_LIST_CAST (obj);
 
-    if (gst_buffer_list_length (buffer_list) == 0)
+    n_buffers = gst_buffer_list_length (buffer_list);
+    if (n_buffers == 0)
       goto empty_list;
 
     sync_buf = gst_buffer_list_get (buffer_list, 0);
@@ -3919,8 +3951,8 @@ again:
   step_end = FALSE;
 
   /* synchronize this object, non syncable objects return OK
-   * immediately. */
-  ret = gst_base_sink_do_sync (basesink, GST_MINI_OBJECT_CAST (sync_buf),
+   * immediately. Buffer lists are synchronized as a whole. */
+  ret = gst_base_sink_do_sync (basesink, GST_MINI_OBJECT_CAST (obj),
       &late, &step_end);
   if (G_UNLIKELY (ret != GST_FLOW_OK))
     goto sync_failed;
@@ -3979,7 +4011,7 @@ again:
   if (G_UNLIKELY (basesink->flushing))
     goto flushing;
 
-  priv->rendered++;
+  priv->rendered += n_buffers;
 
 done:
   if (step_end) {
@@ -4036,7 +4068,7 @@ sync_failed:
   }
 dropped:
   {
-    priv->dropped++;
+    priv->dropped += n_buffers;
     GST_DEBUG_OBJECT (basesink, "buffer late, dropping");
 
     if (g_atomic_int_get (&priv->qos_enabled)) {
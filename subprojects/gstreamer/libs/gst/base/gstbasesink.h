@@ -156,7 +156,8 @@ struct _GstBaseSink {
  * @render: Called when a buffer should be presented or output, at the
  *     correct moment if the #GstBaseSink has been set to sync to the clock.
  * @render_list: Same as @render but used with buffer lists instead of
- *     buffers.
+ *     buffers. The list is synchronised once, from the start time of its
+ *     first buffer to the end time of its last buffer.
  *
  * Subclasses can override any of the available virtual methods or not, as
  * needed. At the minimum, the @render method should be overridden to
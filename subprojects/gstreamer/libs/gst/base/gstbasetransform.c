@@ -200,6 +200,8 @@ struct _GstBaseTransformPrivate
   GstAllocator *allocator;
   GstAllocationParams params;
   GstQuery *query;
+  /* don't block on an empty pool, while holding buffers of a list */
+  gboolean acquire_dontwait;
 };
 
 
@@ -278,6 +280,8 @@ static GstFlowReturn gst_base_transform_getrange (GstPad * pad,
     GstObject * parent, guint64 offset, guint length, GstBuffer ** buffer);
 static GstFlowReturn gst_base_transform_chain (GstPad * pad, GstObject * parent,
     GstBuffer * buffer);
+static GstFlowReturn gst_base_transform_chain_list (GstPad * pad,
+    GstObject * parent, GstBufferList * list);
 static GstCaps *gst_base_transform_default_transform_caps (GstBaseTransform *
     trans, GstPadDirection direction, GstCaps * caps, GstCaps * filter);
 static GstCaps *gst_base_transform_default_fixate_caps (GstBaseTransform *
@@ -390,6 +394,11 @@ gst_base_transform_init (GstBaseTransform * trans,
       GST_DEBUG_FUNCPTR (gst_base_transform_sink_event));
   gst_pad_set_chain_function (trans->sinkpad,
       GST_DEBUG_FUNCPTR (gst_base_transform_chain));
+  /* without the list vmethods, the pad splits lists into buffers so that
+   * buffer probes and tracers see each of them */
+  if (bclass->transform_list || bclass->transform_list_ip)
+    gst_pad_set_chain_list_function (trans->sinkpad,
+        GST_DEBUG_FUNCPTR (gst_base_transform_chain_list));
   gst_pad_set_activatemode_function (trans->sinkpad,
       GST_DEBUG_FUNCPTR (gst_base_transform_sink_activate_mode));
   gst_pad_set_query_function (trans->sinkpad,
@@ -1664,7 +1673,14 @@ default_prepare_output_buffer (GstBaseTransform * trans,
       priv->pool_active = TRUE;
     }
     GST_DEBUG_OBJECT (trans, "using pool alloc");
-    ret = gst_buffer_pool_acquire_buffer (priv->pool, outbuf, NULL);
+    if (priv->acquire_dontwait) {
+      GstBufferPoolAcquireParams params = { 0, };
+
+      params.flags = GST_BUFFER_POOL_ACQUIRE_FLAG_DONTWAIT;
+      ret = gst_buffer_pool_acquire_buffer (priv->pool, outbuf, &params);
+    } else {
+      ret = gst_buffer_pool_acquire_buffer (priv->pool, outbuf, NULL);
+    }
     if (ret != GST_FLOW_OK)
       goto alloc_failed;
 
@@ -2309,46 +2325,18 @@ pull_error:
   }
 }
 
-/* The flow of the chain function is the reverse of the
- * getrange() function - we have data, feed it to the sub-class
- * and then iterate, pushing buffers it generates until it either
- * wants more data or returns an error */
+/* Pushes the buffers the sub-class generates from the submitted input until it
+ * either wants more data or returns an error. @position is the end position of
+ * the submitted input buffer. */
 static GstFlowReturn
-gst_base_transform_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+gst_base_transform_push_output (GstBaseTransform * trans,
+    GstClockTime position)
 {
-  GstBaseTransform *trans = GST_BASE_TRANSFORM_CAST (parent);
   GstBaseTransformClass *klass = GST_BASE_TRANSFORM_GET_CLASS (trans);
   GstBaseTransformPrivate *priv = trans->priv;
   GstFlowReturn ret;
-  GstClockTime position = GST_CLOCK_TIME_NONE;
-  GstClockTime timestamp, duration;
   GstBuffer *outbuf = NULL;
 
-  timestamp = GST_BUFFER_TIMESTAMP (buffer);
-  duration = GST_BUFFER_DURATION (buffer);
-
-  /* calculate end position of the incoming buffer */
-  if (timestamp != GST_CLOCK_TIME_NONE) {
-    if (duration != GST_CLOCK_TIME_NONE)
-      position = timestamp + duration;
-    else
-      position = timestamp;
-  }
-
-  if (klass->before_transform)
-    klass->before_transform (trans, buffer);
-
-  /* Set discont flag so we can mark the outgoing buffer */
-  if (GST_BUFFER_IS_DISCONT (buffer)) {
-    GST_DEBUG_OBJECT (trans, "got DISCONT buffer %p", buffer);
-    priv->discont = TRUE;
-  }
-
-  /* Takes ownership of input buffer */
-  ret = klass->submit_input_buffer (trans, priv->discont, buffer);
-  if (ret != GST_FLOW_OK)
-    goto done;
-
   do {
     outbuf = NULL;
 
@@ -2396,6 +2384,58 @@ gst_base_transform_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
     }
   } while (ret == GST_FLOW_OK && outbuf != NULL);
 
+  return ret;
+}
+
+static GstClockTime
+gst_base_transform_buffer_end (GstBuffer * buffer)
+{
+  GstClockTime timestamp, duration;
+
+  timestamp = GST_BUFFER_TIMESTAMP (buffer);
+  duration = GST_BUFFER_DURATION (buffer);
+
+  if (timestamp == GST_CLOCK_TIME_NONE)
+    return GST_CLOCK_TIME_NONE;
+
+  if (duration != GST_CLOCK_TIME_NONE)
+    return timestamp + duration;
+
+  return timestamp;
+}
+
+/* The flow of the chain function is the reverse of the
+ * getrange() function - we have data, feed it to the sub-class
+ * and then iterate, pushing buffers it generates until it either
+ * wants more data or returns an error */
+static GstFlowReturn
+gst_base_transform_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  GstBaseTransform *trans = GST_BASE_TRANSFORM_CAST (parent);
+  GstBaseTransformClass *klass = GST_BASE_TRANSFORM_GET_CLASS (trans);
+  GstBaseTransformPrivate *priv = trans->priv;
+  GstFlowReturn ret;
+  GstClockTime position;
+
+  /* calculate end position of the incoming buffer */
+  position = gst_base_transform_buffer_end (buffer);
+
+  if (klass->before_transform)
+    klass->before_transform (trans, buffer);
+
+  /* Set discont flag so we can mark the outgoing buffer */
+  if (GST_BUFFER_IS_DISCONT (buffer)) {
+    GST_DEBUG_OBJECT (trans, "got DISCONT buffer %p", buffer);
+    priv->discont = TRUE;
+  }
+
+  /* Takes ownership of input buffer */
+  ret = klass->submit_input_buffer (trans, priv->discont, buffer);
+  if (ret != GST_FLOW_OK)
+    goto done;
+
+  ret = gst_base_transform_push_output (trans, position);
+
 done:
   /* convert internal flow to OK and mark discont for the next buffer. */
   if (ret == GST_BASE_TRANSFORM_FLOW_DROPPED) {
@@ -2407,6 +2447,312 @@ done:
   return ret;
 }
 
+/* Whether buffer lists can be transformed as a whole. This needs the default
+ * input and output handling and a list vmethod for the current mode */
+static gboolean
+gst_base_transform_can_transform_list (GstBaseTransform * trans)
+{
+  GstBaseTransformClass *klass = GST_BASE_TRANSFORM_GET_CLASS (trans);
+  GstBaseTransformPrivate *priv = trans->priv;
+
+  if (klass->submit_input_buffer != default_submit_input_buffer
+      || klass->generate_output != default_generate_output
+      || klass->prepare_output_buffer == NULL)
+    return FALSE;
+
+  if (priv->passthrough)
+    return !(klass->transform_ip_on_passthrough && klass->transform_ip)
+        || klass->transform_list_ip != NULL;
+
+  if (klass->transform_ip != NULL && priv->always_in_place)
+    return klass->transform_list_ip != NULL;
+
+  return klass->transform_list != NULL;
+}
+
+typedef struct
+{
+  GstBaseTransform *trans;
+
+  /* the mode the list is transformed in */
+  gboolean passthrough;
+  gboolean always_in_place;
+
+  GstBufferList *inlist;
+  GstBufferList *outlist;
+  GstClockTime position;
+
+  /* the input buffer at which the mode changed, it is queued */
+  gboolean mode_changed;
+  GstClockTime mode_changed_position;
+
+  GstFlowReturn ret;
+} TransformListData;
+
+static GstFlowReturn gst_base_transform_flush_list (GstBaseTransform * trans,
+    TransformListData * data);
+
+/* Takes @buffer out of the list, submits it and adds the output buffer it
+ * will be transformed into to the output list */
+static gboolean
+gst_base_transform_queue_list_buffer (GstBuffer ** buffer, guint idx,
+    gpointer user_data)
+{
+  TransformListData *data = user_data;
+  GstBaseTransform *trans = data->trans;
+  GstBaseTransformClass *klass = GST_BASE_TRANSFORM_GET_CLASS (trans);
+  GstBaseTransformPrivate *priv = trans->priv;
+  GstBuffer *inbuf, *outbuf = NULL;
+  GstClockTime position;
+
+  inbuf = *buffer;
+  *buffer = NULL;
+
+  position = gst_base_transform_buffer_end (inbuf);
+
+  if (klass->before_transform)
+    klass->before_transform (trans, inbuf);
+
+  if (GST_BUFFER_IS_DISCONT (inbuf)) {
+    GST_DEBUG_OBJECT (trans, "got DISCONT buffer %p", inbuf);
+    priv->discont = TRUE;
+  }
+
+  data->ret = klass->submit_input_buffer (trans, priv->discont, inbuf);
+  if (data->ret == GST_BASE_TRANSFORM_FLOW_DROPPED) {
+    GST_DEBUG_OBJECT (trans, "dropped a buffer, marking DISCONT");
+    priv->discont = TRUE;
+    data->ret = GST_FLOW_OK;
+    return TRUE;
+  }
+  if (data->ret != GST_FLOW_OK)
+    return FALSE;
+
+  /* submitting can renegotiate, the buffers after this one are then handled
+   * one by one */
+  if (G_UNLIKELY (priv->passthrough != data->passthrough
+          || priv->always_in_place != data->always_in_place)) {
+    GST_DEBUG_OBJECT (trans, "mode changed at buffer %u of the list", idx);
+    data->mode_changed = TRUE;
+    data->mode_changed_position = position;
+    return FALSE;
+  }
+
+  /* take back the queued buffer like default_generate_output() */
+  inbuf = trans->queued_buf;
+  trans->queued_buf = NULL;
+  if (inbuf == NULL)
+    return TRUE;
+
+  /* the output buffers of the list only go back to a pool after the list was
+   * pushed. When the pool has no more buffers, push what was queued so far
+   * instead of waiting for ones that are never released */
+  priv->acquire_dontwait = gst_buffer_list_length (data->outlist) > 0;
+  data->ret = klass->prepare_output_buffer (trans, inbuf, &outbuf);
+  if (data->ret == GST_FLOW_EOS && priv->acquire_dontwait) {
+    priv->acquire_dontwait = FALSE;
+    GST_DEBUG_OBJECT (trans, "output pool is empty, pushing %u buffers",
+        gst_buffer_list_length (data->outlist));
+    data->ret = gst_base_transform_flush_list (trans, data);
+    if (data->ret != GST_FLOW_OK) {
+      gst_buffer_unref (inbuf);
+      return FALSE;
+    }
+    data->ret = klass->prepare_output_buffer (trans, inbuf, &outbuf);
+  }
+  priv->acquire_dontwait = FALSE;
+  if (data->ret != GST_FLOW_OK || outbuf == NULL) {
+    GST_WARNING_OBJECT (trans, "could not get buffer from pool: %s",
+        gst_flow_get_name (data->ret));
+    gst_buffer_unref (inbuf);
+    if (data->ret == GST_FLOW_OK)
+      data->ret = GST_FLOW_ERROR;
+    return FALSE;
+  }
+
+  /* apply DISCONT flag if the buffer is not yet marked as such */
+  if (priv->discont) {
+    GST_DEBUG_OBJECT (trans, "we have a pending DISCONT");
+    if (!GST_BUFFER_IS_DISCONT (outbuf)) {
+      GST_DEBUG_OBJECT (trans, "marking DISCONT on output buffer");
+      if (outbuf == inbuf) {
+        outbuf = inbuf = gst_buffer_make_writable (outbuf);
+      } else {
+        outbuf = gst_buffer_make_writable (outbuf);
+      }
+      GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_DISCONT);
+    }
+    priv->discont = FALSE;
+  }
+
+  if (data->inlist) {
+    gst_buffer_list_add (data->inlist, inbuf);
+    if (outbuf == inbuf)
+      gst_buffer_ref (outbuf);
+  } else if (outbuf != inbuf) {
+    gst_buffer_unref (inbuf);
+  }
+  gst_buffer_list_add (data->outlist, outbuf);
+
+  if (position != GST_CLOCK_TIME_NONE)
+    data->position = position;
+
+  return TRUE;
+}
+
+/* Transforms the buffers queued by gst_base_transform_queue_list_buffer() and
+ * pushes them as one list */
+static GstFlowReturn
+gst_base_transform_push_list (GstBaseTransform * trans,
+    TransformListData * data)
+{
+  GstBaseTransformClass *klass = GST_BASE_TRANSFORM_GET_CLASS (trans);
+  GstBaseTransformPrivate *priv = trans->priv;
+  GstBufferList *outlist = data->outlist;
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint len;
+
+  data->outlist = NULL;
+  len = gst_buffer_list_length (outlist);
+  if (len == 0) {
+    gst_buffer_list_unref (outlist);
+    return GST_FLOW_OK;
+  }
+
+  if (data->passthrough) {
+    if (klass->transform_ip_on_passthrough && klass->transform_ip) {
+      GST_DEBUG_OBJECT (trans, "doing passthrough transform_list_ip");
+      ret = klass->transform_list_ip (trans, outlist);
+    } else {
+      GST_DEBUG_OBJECT (trans, "element is in passthrough");
+    }
+  } else if (klass->transform_ip != NULL && data->always_in_place) {
+    GST_DEBUG_OBJECT (trans, "doing inplace list transform");
+    ret = klass->transform_list_ip (trans, outlist);
+  } else {
+    GST_DEBUG_OBJECT (trans, "doing non-inplace list transform");
+    ret = klass->transform_list (trans, data->inlist, outlist);
+  }
+
+  if (ret != GST_FLOW_OK) {
+    GST_DEBUG_OBJECT (trans, "we got return %s", gst_flow_get_name (ret));
+    gst_buffer_list_unref (outlist);
+    return ret;
+  }
+
+  if (trans->segment.format == GST_FORMAT_TIME) {
+    GstClockTime position_out;
+
+    /* Remember last stop position */
+    if (data->position != GST_CLOCK_TIME_NONE)
+      trans->segment.position = data->position;
+
+    position_out =
+        gst_base_transform_buffer_end (gst_buffer_list_get (outlist, len - 1));
+    if (position_out == GST_CLOCK_TIME_NONE)
+      position_out = data->position;
+    if (position_out != GST_CLOCK_TIME_NONE)
+      priv->position_out = position_out;
+  }
+  priv->processed += len;
+
+  return gst_pad_push_list (trans->srcpad, outlist);
+}
+
+/* Pushes the buffers queued so far and starts new lists for the rest of the
+ * input list */
+static GstFlowReturn
+gst_base_transform_flush_list (GstBaseTransform * trans,
+    TransformListData * data)
+{
+  guint len = gst_buffer_list_length (data->outlist);
+  GstFlowReturn ret;
+
+  ret = gst_base_transform_push_list (trans, data);
+
+  data->outlist = gst_buffer_list_new_sized (len);
+  if (data->inlist) {
+    gst_buffer_list_unref (data->inlist);
+    data->inlist = gst_buffer_list_new_sized (len);
+  }
+  data->position = GST_CLOCK_TIME_NONE;
+
+  return ret;
+}
+
+/* Buffer lists are transformed with one call of the list vmethods and pushed
+ * downstream as one list again. When that isn't possible the buffers go
+ * through the chain function one by one */
+static GstFlowReturn
+gst_base_transform_chain_list (GstPad * pad, GstObject * parent,
+    GstBufferList * list)
+{
+  GstBaseTransform *trans = GST_BASE_TRANSFORM_CAST (parent);
+  GstBaseTransformPrivate *priv = trans->priv;
+  TransformListData data = { NULL, };
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint i, len;
+
+  len = gst_buffer_list_length (list);
+
+  if (!gst_base_transform_can_transform_list (trans))
+    goto chain_buffers;
+
+  data.trans = trans;
+  data.passthrough = priv->passthrough;
+  data.always_in_place = priv->always_in_place;
+  data.outlist = gst_buffer_list_new_sized (len);
+  if (!data.passthrough && !(GST_BASE_TRANSFORM_GET_CLASS (trans)->transform_ip
+          && data.always_in_place))
+    data.inlist = gst_buffer_list_new_sized (len);
+  data.position = GST_CLOCK_TIME_NONE;
+  data.ret = GST_FLOW_OK;
+
+  /* the buffers are taken out of the list while they are queued, what is left
+   * afterwards was not handled yet */
+  list = gst_buffer_list_make_writable (list);
+  gst_buffer_list_foreach (list, gst_base_transform_queue_list_buffer, &data);
+
+  ret = data.ret;
+  if (ret == GST_FLOW_OK)
+    ret = gst_base_transform_push_list (trans, &data);
+
+  if (data.outlist)
+    gst_buffer_list_unref (data.outlist);
+  if (data.inlist)
+    gst_buffer_list_unref (data.inlist);
+
+  if (ret != GST_FLOW_OK)
+    goto done;
+
+  if (data.mode_changed) {
+    ret = gst_base_transform_push_output (trans, data.mode_changed_position);
+    if (ret == GST_BASE_TRANSFORM_FLOW_DROPPED) {
+      priv->discont = TRUE;
+      ret = GST_FLOW_OK;
+    }
+    if (ret != GST_FLOW_OK)
+      goto done;
+  }
+
+  len = gst_buffer_list_length (list);
+
+chain_buffers:
+  /* through the pad like the default chain list function, for the buffer
+   * probes and tracers */
+  GST_LOG_OBJECT (trans, "chaining %u buffers of the list one by one", len);
+  for (i = 0; i < len; i++) {
+    ret = gst_pad_chain (pad, gst_buffer_ref (gst_buffer_list_get (list, i)));
+    if (ret != GST_FLOW_OK)
+      break;
+  }
+
+done:
+  gst_buffer_list_unref (list);
+
+  return ret;
+}
+
 static void
 gst_base_transform_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
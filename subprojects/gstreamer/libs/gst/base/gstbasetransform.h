@@ -209,6 +209,18 @@ struct _GstBaseTransform {
  *                   do 1-to-1 transformations of input to output buffers can either
  *                   return GST_BASE_TRANSFORM_FLOW_DROPPED or simply not generate
  *                   an output buffer until they are ready to do so. (Since: 1.6)
+ * @transform_list: Optional. Transforms the buffers of @inlist into the buffers
+ *                  at the same positions of @outlist in one call. When set,
+ *                  buffer lists are kept together in non-inplace mode instead
+ *                  of being split into buffers, and buffer probes on the sink
+ *                  pad only see the lists. Only used with the default
+ *                  @submit_input_buffer and @generate_output. (Since: 1.26)
+ * @transform_list_ip: Optional. Transforms all the buffers of the list
+ *                  in-place in one call. When set, buffer lists are kept
+ *                  together in in-place mode, and in passthrough mode when
+ *                  @transform_ip_on_passthrough is used. Only used with the
+ *                  default @submit_input_buffer and @generate_output.
+ *                  (Since: 1.26)
  *
  * Subclasses can override any of the available virtual methods or not, as
  * needed. At minimum either @transform or @transform_ip need to be overridden.
@@ -309,8 +321,28 @@ struct _GstBaseTransformClass {
    */
   GstFlowReturn (*generate_output) (GstBaseTransform *trans, GstBuffer **outbuf);
 
+  /**
+   * GstBaseTransformClass::transform_list:
+   * @inlist: (transfer none): the input buffers
+   * @outlist: (transfer none): the output buffers, one for each input buffer
+   *
+   * Since: 1.26
+   */
+  GstFlowReturn (*transform_list)    (GstBaseTransform *trans,
+                                      GstBufferList *inlist,
+                                      GstBufferList *outlist);
+
+  /**
+   * GstBaseTransformClass::transform_list_ip:
+   * @list: (transfer none): the buffers to transform
+   *
+   * Since: 1.26
+   */
+  GstFlowReturn (*transform_list_ip) (GstBaseTransform *trans,
+                                      GstBufferList *list);
+
   /*< private >*/
-  gpointer       _gst_reserved[GST_PADDING_LARGE - 2];
+  gpointer       _gst_reserved[GST_PADDING_LARGE - 4];
 };
 
 GST_BASE_API
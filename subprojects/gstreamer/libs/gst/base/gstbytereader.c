@@ -25,6 +25,7 @@
 
 #define GST_BYTE_READER_DISABLE_INLINES
 #include "gstbytereader.h"
+#include "gstbytescan-private.h"
 
 #include "gst/glib-compat-private.h"
 #include <string.h>
@@ -862,36 +863,12 @@ gst_byte_reader_dup_data (GstByteReader * reader, guint size, guint8 ** val)
   return _gst_byte_reader_dup_data_inline (reader, size, val);
 }
 
-/* Special optimized scan for mask 0xffffff00 and pattern 0x00000100 */
-static inline gint
-_scan_for_start_code (const guint8 * data, guint size)
-{
-  guint8 *pdata = (guint8 *) data;
-  guint8 *pend = (guint8 *) (data + size - 4);
-
-  while (pdata <= pend) {
-    if (pdata[2] > 1) {
-      pdata += 3;
-    } else if (pdata[1]) {
-      pdata += 2;
-    } else if (pdata[0] || pdata[2] != 1) {
-      pdata++;
-    } else {
-      return (pdata - data);
-    }
-  }
-
-  /* nothing found */
-  return -1;
-}
-
 static inline guint
 _masked_scan_uint32_peek (const GstByteReader * reader,
     guint32 mask, guint32 pattern, guint offset, guint size, guint32 * value)
 {
   const guint8 *data;
-  guint32 state;
-  guint i;
+  gssize ret;
 
   g_return_val_if_fail (size > 0, -1);
   g_return_val_if_fail ((guint64) offset + size <= reader->size - reader->byte,
@@ -903,42 +880,16 @@ _masked_scan_uint32_peek (const GstByteReader * reader,
 
   data = reader->data + reader->byte + offset;
 
-  /* Handle special case found in MPEG and H264 */
-  if ((pattern == 0x00000100) && (mask == 0xffffff00)) {
-    gint ret = _scan_for_start_code (data, size);
-
-    if (ret == -1)
-      return ret;
-
-    if (value != NULL)
-      *value = (1 << 8) | data[ret + 3];
-
-    return ret + offset;
-  }
+  ret = _gst_byte_scan_masked_uint32 (data, size, mask, pattern);
+  if (ret == -1)
+    return -1;
 
-  /* set the state to something that does not match */
-  state = ~pattern;
-
-  /* now find data */
-  for (i = 0; i < size; i++) {
-    /* throw away one byte and move in the next byte */
-    state = ((state << 8) | data[i]);
-    if (G_UNLIKELY ((state & mask) == pattern)) {
-      /* we have a match but we need to have skipped at
-       * least 4 bytes to fill the state. */
-      if (G_LIKELY (i >= 3)) {
-        if (value)
-          *value = state;
-        return offset + i - 3;
-      }
-    }
-  }
+  if (value)
+    *value = GST_READ_UINT32_BE (data + ret);
 
-  /* nothing found */
-  return -1;
+  return offset + ret;
 }
 
-
 /**
  * gst_byte_reader_masked_scan_uint32:
  * @reader: a #GstByteReader
@@ -0,0 +1,39 @@
+/* GStreamer
+ *
+ * gstbytescan-private.h: pattern scanning shared by GstByteReader and
+ * GstAdapter
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_BYTE_SCAN_PRIVATE_H__
+#define __GST_BYTE_SCAN_PRIVATE_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* mask and pattern of MPEG, H.264 and H.265 start codes */
+#define GST_BYTE_SCAN_START_CODE_MASK    0xffffff00
+#define GST_BYTE_SCAN_START_CODE_PATTERN 0x00000100
+
+G_GNUC_INTERNAL
+gssize _gst_byte_scan_masked_uint32 (const guint8 * data, gsize size,
+                                     guint32 mask, guint32 pattern);
+
+G_END_DECLS
+
+#endif /* __GST_BYTE_SCAN_PRIVATE_H__ */
@@ -0,0 +1,250 @@
+/* GStreamer
+ *
+ * gstbytescan.c: pattern scanning shared by GstByteReader and GstAdapter
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <gst/gst.h>
+
+#include "gstbytescan-private.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HAVE_SCAN_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/* AVX2 is selected at runtime, this needs the target attribute */
+#if defined(HAVE_SCAN_SSE2) && (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#define HAVE_SCAN_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define HAVE_SCAN_NEON 1
+#include <arm_neon.h>
+#endif
+
+/* Start code search, for positions from @start on. Skips 3 bytes at once
+ * when the third byte can't be the 0x01 of a start code. */
+static gssize
+scan_start_code_scalar (const guint8 * data, gsize size, gsize start)
+{
+  const guint8 *pdata = data + start;
+  const guint8 *pend = data + size - 4;
+
+  while (pdata <= pend) {
+    if (pdata[2] > 1) {
+      pdata += 3;
+    } else if (pdata[1]) {
+      pdata += 2;
+    } else if (pdata[0] || pdata[2] != 1) {
+      pdata++;
+    } else {
+      return (pdata - data);
+    }
+  }
+
+  /* nothing found */
+  return -1;
+}
+
+/* The vector versions compare the bytes at positions i, i + 1 and i + 2
+ * for all the lanes at once. A position is only a candidate if the 4th byte
+ * of the pattern is available, so lane i needs i + 3 < size. */
+
+#ifdef HAVE_SCAN_SSE2
+static gssize
+scan_start_code_sse2 (const guint8 * data, gsize size)
+{
+  const __m128i zero = _mm_setzero_si128 ();
+  const __m128i one = _mm_set1_epi8 (1);
+  gsize i = 0;
+
+  while (i + 16 + 3 <= size) {
+    __m128i b0 = _mm_loadu_si128 ((const __m128i *) (data + i));
+    __m128i b1 = _mm_loadu_si128 ((const __m128i *) (data + i + 1));
+    __m128i b2 = _mm_loadu_si128 ((const __m128i *) (data + i + 2));
+    __m128i m;
+    gint bits;
+
+    m = _mm_and_si128 (_mm_cmpeq_epi8 (b2, one),
+        _mm_cmpeq_epi8 (_mm_or_si128 (b0, b1), zero));
+    bits = _mm_movemask_epi8 (m);
+    if (G_UNLIKELY (bits))
+      return i + g_bit_nth_lsf (bits, -1);
+
+    i += 16;
+  }
+
+  return scan_start_code_scalar (data, size, i);
+}
+#endif
+
+#ifdef HAVE_SCAN_AVX2
+__attribute__ ((target ("avx2")))
+static gssize
+scan_start_code_avx2 (const guint8 * data, gsize size)
+{
+  const __m256i zero = _mm256_setzero_si256 ();
+  const __m256i one = _mm256_set1_epi8 (1);
+  gsize i = 0;
+
+  while (i + 32 + 3 <= size) {
+    __m256i b0 = _mm256_loadu_si256 ((const __m256i *) (data + i));
+    __m256i b1 = _mm256_loadu_si256 ((const __m256i *) (data + i + 1));
+    __m256i b2 = _mm256_loadu_si256 ((const __m256i *) (data + i + 2));
+    __m256i m;
+    guint32 bits;
+
+    m = _mm256_and_si256 (_mm256_cmpeq_epi8 (b2, one),
+        _mm256_cmpeq_epi8 (_mm256_or_si256 (b0, b1), zero));
+    bits = (guint32) _mm256_movemask_epi8 (m);
+    if (G_UNLIKELY (bits))
+      return i + g_bit_nth_lsf (bits, -1);
+
+    i += 32;
+  }
+
+  return scan_start_code_scalar (data, size, i);
+}
+#endif
+
+#ifdef HAVE_SCAN_NEON
+static gssize
+scan_start_code_neon (const guint8 * data, gsize size)
+{
+  const uint8x16_t zero = vdupq_n_u8 (0);
+  const uint8x16_t one = vdupq_n_u8 (1);
+  gsize i = 0;
+
+  while (i + 16 + 3 <= size) {
+    uint8x16_t b0 = vld1q_u8 (data + i);
+    uint8x16_t b1 = vld1q_u8 (data + i + 1);
+    uint8x16_t b2 = vld1q_u8 (data + i + 2);
+    uint8x16_t m;
+
+    m = vandq_u8 (vceqq_u8 (b2, one), vceqq_u8 (vorrq_u8 (b0, b1), zero));
+    if (G_UNLIKELY (vmaxvq_u8 (m)))
+      break;
+
+    i += 16;
+  }
+
+  return scan_start_code_scalar (data, size, i);
+}
+#endif
+
+static gssize
+scan_start_code (const guint8 * data, gsize size)
+{
+#ifdef HAVE_SCAN_AVX2
+  static gint have_avx2 = -1;
+
+  if (G_UNLIKELY (have_avx2 == -1))
+    have_avx2 = __builtin_cpu_supports ("avx2") ? 1 : 0;
+  if (have_avx2)
+    return scan_start_code_avx2 (data, size);
+#endif
+#if defined(HAVE_SCAN_SSE2)
+  return scan_start_code_sse2 (data, size);
+#elif defined(HAVE_SCAN_NEON)
+  return scan_start_code_neon (data, size);
+#else
+  return scan_start_code_scalar (data, size, 0);
+#endif
+}
+
+/* Search for the byte at @idx of the pattern, which is not masked, with
+ * memchr() and only compare the whole pattern where it was found. This is
+ * what finds sync bytes like the 0x47 of MPEG-TS or the 0xff of MPEG audio
+ * quickly. */
+static gssize
+scan_sync_byte (const guint8 * data, gsize size, guint32 mask,
+    guint32 pattern, guint idx)
+{
+  const guint8 sync = (pattern >> (24 - 8 * idx)) & 0xff;
+  const guint8 *p = data + idx;
+  const guint8 *last = data + size - 4 + idx;
+
+  while (p <= last && (p = memchr (p, sync, last - p + 1))) {
+    const guint8 *candidate = p - idx;
+
+    if ((GST_READ_UINT32_BE (candidate) & mask) == pattern)
+      return candidate - data;
+    p++;
+  }
+
+  /* nothing found */
+  return -1;
+}
+
+static gssize
+scan_masked_scalar (const guint8 * data, gsize size, guint32 mask,
+    guint32 pattern)
+{
+  guint32 state;
+  gsize i;
+
+  /* set the state to something that does not match */
+  state = ~pattern;
+
+  /* now find data */
+  for (i = 0; i < size; i++) {
+    /* throw away one byte and move in the next byte */
+    state = ((state << 8) | data[i]);
+    if (G_UNLIKELY ((state & mask) == pattern)) {
+      /* we have a match but we need to have skipped at
+       * least 4 bytes to fill the state. */
+      if (G_LIKELY (i >= 3))
+        return i - 3;
+    }
+  }
+
+  /* nothing found */
+  return -1;
+}
+
+/* Returns the first position p in @data at which the 4 bytes starting at p,
+ * read as a big endian integer and masked with @mask, equal @pattern. All 4
+ * bytes must be within @size. */
+gssize
+_gst_byte_scan_masked_uint32 (const guint8 * data, gsize size, guint32 mask,
+    guint32 pattern)
+{
+  guint i;
+
+  if (size < 4)
+    return -1;
+
+  if (mask == GST_BYTE_SCAN_START_CODE_MASK
+      && pattern == GST_BYTE_SCAN_START_CODE_PATTERN)
+    return scan_start_code (data, size);
+
+  for (i = 0; i < 4; i++) {
+    if (((mask >> (24 - 8 * i)) & 0xff) == 0xff)
+      return scan_sync_byte (data, size, mask, pattern, i);
+  }
+
+  return scan_masked_scalar (data, size, mask, pattern);
+}
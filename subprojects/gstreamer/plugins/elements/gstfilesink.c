@@ -32,6 +32,12 @@
  * gst-launch-1.0 v4l2src num-buffers=1 ! jpegenc ! filesink location=capture1.jpeg
  * ]| Capture one frame from a v4l2 camera and save as jpeg image.
  *
+ * On Linux the #GstFileSink:io-uring property makes filesink queue its
+ * writes to the kernel asynchronously instead of blocking the streaming
+ * thread until every write returned. Buffers are then released once the
+ * kernel has completed writing them, and write errors are reported on the
+ * next buffer or when the file is synced, seeked in or closed.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -135,6 +141,10 @@ GST_DEBUG_CATEGORY_STATIC (gst_file_sink_debug);
 #define DEFAULT_O_SYNC		FALSE
 #define DEFAULT_MAX_TRANSIENT_ERROR_TIMEOUT	0
 #define DEFAULT_FILE_MODE      GST_FILE_SINK_FILE_MODE_TRUNC
+#define DEFAULT_IO_URING	FALSE
+
+/* maximum number of writes in flight with io_uring */
+#define IO_URING_DEPTH		64
 
 enum
 {
@@ -146,6 +156,7 @@ enum
   PROP_O_SYNC,
   PROP_MAX_TRANSIENT_ERROR_TIMEOUT,
   PROP_FILE_MODE,
+  PROP_IO_URING,
   PROP_LAST
 };
 
@@ -219,6 +230,7 @@ static void gst_file_sink_uri_handler_init (gpointer g_iface,
     gpointer iface_data);
 
 static GstFlowReturn gst_file_sink_flush_buffer (GstFileSink * filesink);
+static GstFlowReturn gst_file_sink_drain (GstFileSink * filesink);
 
 #define _do_init \
   G_IMPLEMENT_INTERFACE (GST_TYPE_URI_HANDLER, gst_file_sink_uri_handler_init); \
@@ -292,6 +304,21 @@ gst_file_sink_class_init (GstFileSinkClass * klass)
           G_MAXINT, DEFAULT_MAX_TRANSIENT_ERROR_TIMEOUT,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstFileSink:io-uring
+   *
+   * Write asynchronously using io_uring. Falls back to blocking writes if
+   * io_uring is not available, the file is not seekable or is opened in
+   * append mode.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_IO_URING,
+      g_param_spec_boolean ("io-uring", "io_uring",
+          "Write asynchronously using io_uring if available", DEFAULT_IO_URING,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   gst_element_class_set_static_metadata (gstelement_class,
       "File Sink",
       "Sink/File", "Write stream to a file",
@@ -328,6 +355,7 @@ gst_file_sink_init (GstFileSink * filesink)
   filesink->buffer_size = DEFAULT_BUFFER_SIZE;
   filesink->append = FALSE;
   filesink->file_mode = DEFAULT_FILE_MODE;
+  filesink->io_uring = DEFAULT_IO_URING;
 
   gst_base_sink_set_sync (GST_BASE_SINK (filesink), FALSE);
 }
@@ -408,6 +436,9 @@ gst_file_sink_set_property (GObject * object, guint prop_id,
     case PROP_MAX_TRANSIENT_ERROR_TIMEOUT:
       sink->max_transient_error_timeout = g_value_get_int (value);
       break;
+    case PROP_IO_URING:
+      sink->io_uring = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -442,6 +473,9 @@ gst_file_sink_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_MAX_TRANSIENT_ERROR_TIMEOUT:
       g_value_set_int (value, sink->max_transient_error_timeout);
       break;
+    case PROP_IO_URING:
+      g_value_set_boolean (value, sink->io_uring);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -490,8 +524,24 @@ gst_file_sink_open_file (GstFileSink * sink)
     sink->current_buffer_size = 0;
   }
 
-  GST_DEBUG_OBJECT (sink, "opened file %s, seekable %d",
-      sink->filename, sink->seekable);
+  if (sink->io_uring) {
+#ifdef HAVE_IO_URING
+    /* we write at explicit offsets, which doesn't work for pipes and
+     * doesn't mix with O_APPEND */
+    if (!sink->seekable || sink->append
+        || sink->file_mode == GST_FILE_SINK_FILE_MODE_APPEND) {
+      GST_WARNING_OBJECT (sink, "can't use io_uring for non-seekable files "
+          "or in append mode");
+    } else {
+      sink->uring = gst_io_uring_new (GST_OBJECT_CAST (sink), IO_URING_DEPTH);
+    }
+#else
+    GST_WARNING_OBJECT (sink, "io_uring support not compiled in");
+#endif
+  }
+
+  GST_DEBUG_OBJECT (sink, "opened file %s, seekable %d, io_uring %d",
+      sink->filename, sink->seekable, sink->uring != NULL);
 
   return TRUE;
 
@@ -519,6 +569,14 @@ gst_file_sink_close_file (GstFileSink * sink)
       GST_ELEMENT_ERROR (sink, RESOURCE, CLOSE,
           (_("Error closing file \"%s\"."), sink->filename), NULL);
 
+    gst_file_sink_drain (sink);
+#ifdef HAVE_IO_URING
+    if (sink->uring) {
+      gst_io_uring_free (sink->uring);
+      sink->uring = NULL;
+    }
+#endif
+
     if (fclose (sink->file) != 0)
       GST_ELEMENT_ERROR (sink, RESOURCE, CLOSE,
           (_("Error closing file \"%s\"."), sink->filename), GST_ERROR_SYSTEM);
@@ -610,6 +668,9 @@ gst_file_sink_do_seek (GstFileSink * filesink, guint64 new_offset)
   if (gst_file_sink_flush_buffer (filesink) != GST_FLOW_OK)
     goto flush_buffer_failed;
 
+  if (gst_file_sink_drain (filesink) != GST_FLOW_OK)
+    goto flush_buffer_failed;
+
 #ifdef HAVE_FSEEKO
   if (fseeko (filesink->file, (off_t) new_offset, SEEK_SET) != 0)
     goto seek_failed;
@@ -695,6 +756,8 @@ gst_file_sink_event (GstBaseSink * sink, GstEvent * event)
     case GST_EVENT_EOS:
       if (gst_file_sink_flush_buffer (filesink) != GST_FLOW_OK)
         goto flush_buffer_failed;
+      if (gst_file_sink_drain (filesink) != GST_FLOW_OK)
+        goto flush_buffer_failed;
       break;
     default:
       break;
@@ -752,6 +815,80 @@ gst_file_sink_get_current_offset (GstFileSink * filesink, guint64 * p_pos)
   return (ret != (off_t) - 1);
 }
 
+#ifdef HAVE_IO_URING
+static GstFlowReturn
+gst_file_sink_uring_error (GstFileSink * sink, gint err)
+{
+  switch (-err) {
+    case ENOSPC:
+      GST_ELEMENT_ERROR (sink, RESOURCE, NO_SPACE_LEFT, (NULL), (NULL));
+      break;
+    default:
+      GST_ELEMENT_ERROR (sink, RESOURCE, WRITE,
+          (_("Error while writing to file \"%s\"."), sink->filename),
+          ("%s", g_strerror (-err)));
+      break;
+  }
+  return GST_FLOW_ERROR;
+}
+
+/* queue a write of @buffer at the current position, it is only started on
+ * the next gst_file_sink_uring_submit() */
+static GstFlowReturn
+gst_file_sink_uring_queue (GstFileSink * sink, GstBuffer * buffer)
+{
+  gsize size;
+  gint ret;
+
+  size = gst_buffer_get_size (buffer);
+  if (size == 0)
+    return GST_FLOW_OK;
+
+  GST_LOG_OBJECT (sink, "queueing %" G_GSIZE_FORMAT " bytes at position %"
+      G_GUINT64_FORMAT, size, sink->current_pos);
+
+  ret = gst_io_uring_queue_write (sink->uring, fileno (sink->file), buffer,
+      sink->current_pos);
+  if (ret < 0)
+    return gst_file_sink_uring_error (sink, ret);
+
+  sink->current_pos += size;
+
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+gst_file_sink_uring_submit (GstFileSink * sink)
+{
+  gint ret;
+
+  ret = gst_io_uring_submit (sink->uring);
+  if (ret < 0)
+    return gst_file_sink_uring_error (sink, ret);
+
+  return GST_FLOW_OK;
+}
+#endif
+
+/* wait for all pending asynchronous writes */
+static GstFlowReturn
+gst_file_sink_drain (GstFileSink * filesink)
+{
+#ifdef HAVE_IO_URING
+  if (filesink->uring) {
+    gint ret;
+
+    GST_DEBUG_OBJECT (filesink, "waiting for pending writes");
+
+    ret = gst_io_uring_drain (filesink->uring);
+    if (ret < 0)
+      return gst_file_sink_uring_error (filesink, ret);
+  }
+#endif
+
+  return GST_FLOW_OK;
+}
+
 static GstFlowReturn
 gst_file_sink_render_list_internal (GstFileSink * sink,
     GstBufferList * buffer_list)
@@ -768,6 +905,23 @@ gst_file_sink_render_list_internal (GstFileSink * sink,
       "writing %u buffers at position %" G_GUINT64_FORMAT, num_buffers,
       sink->current_pos);
 
+#ifdef HAVE_IO_URING
+  if (sink->uring) {
+    guint i;
+
+    flow = GST_FLOW_OK;
+    for (i = 0; i < num_buffers && flow == GST_FLOW_OK; i++)
+      flow = gst_file_sink_uring_queue (sink,
+          gst_buffer_list_get (buffer_list, i));
+
+    /* submit the whole list with a single system call */
+    if (flow == GST_FLOW_OK)
+      flow = gst_file_sink_uring_submit (sink);
+
+    return flow;
+  }
+#endif
+
   for (;;) {
     guint64 bytes_written = 0;
 
@@ -808,6 +962,28 @@ gst_file_sink_flush_buffer (GstFileSink * filesink)
   if (filesink->buffer && filesink->current_buffer_size) {
     guint64 skip = 0;
 
+#ifdef HAVE_IO_URING
+    if (filesink->uring) {
+      GstBuffer *buffer;
+
+      /* hand our memory over to the pending write and continue with a new
+       * one instead of waiting for the write to finish */
+      buffer = gst_buffer_new_wrapped_full (0, filesink->buffer,
+          filesink->allocated_buffer_size, 0, filesink->current_buffer_size,
+          filesink->buffer, g_free);
+      filesink->buffer = g_malloc (filesink->allocated_buffer_size);
+
+      flow_ret = gst_file_sink_uring_queue (filesink, buffer);
+      gst_buffer_unref (buffer);
+      if (flow_ret == GST_FLOW_OK)
+        flow_ret = gst_file_sink_uring_submit (filesink);
+
+      filesink->current_buffer_size = 0;
+
+      return flow_ret;
+    }
+#endif
+
     for (;;) {
       guint64 bytes_written = 0;
 
@@ -876,6 +1052,15 @@ render_buffer (GstFileSink * filesink, GstBuffer * buffer)
   guint64 bytes_written = 0;
   guint64 skip = 0;
 
+#ifdef HAVE_IO_URING
+  if (filesink->uring) {
+    flow = gst_file_sink_uring_queue (filesink, buffer);
+    if (flow == GST_FLOW_OK)
+      flow = gst_file_sink_uring_submit (filesink);
+    return flow;
+  }
+#endif
+
   for (;;) {
     flow =
         gst_writev_buffer (GST_OBJECT_CAST (filesink),
@@ -968,6 +1153,9 @@ gst_file_sink_render_list (GstBaseSink * bsink, GstBufferList * buffer_list)
     }
   }
 
+  if (flow == GST_FLOW_OK && sync_after)
+    flow = gst_file_sink_drain (sink);
+
   if (flow == GST_FLOW_OK && sync_after) {
     do {
       fsync_ret = fsync (fileno (sink->file));
@@ -1052,6 +1240,9 @@ gst_file_sink_render (GstBaseSink * sink, GstBuffer * buffer)
     flow = GST_FLOW_OK;
   }
 
+  if (flow == GST_FLOW_OK && sync_after)
+    flow = gst_file_sink_drain (filesink);
+
   if (flow == GST_FLOW_OK && sync_after) {
     do {
       fsync_ret = fsync (fileno (filesink->file));
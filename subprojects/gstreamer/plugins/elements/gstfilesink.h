@@ -29,6 +29,8 @@
 #include <gst/gst.h>
 #include <gst/base/gstbasesink.h>
 
+#include "gstiouring.h"
+
 G_BEGIN_DECLS
 #define GST_TYPE_FILE_SINK \
   (gst_file_sink_get_type())
@@ -113,6 +115,10 @@ struct _GstFileSink {
   gint max_transient_error_timeout;
 
   gboolean flushing;
+
+  /* io_uring backend, NULL when using blocking writes */
+  gboolean io_uring;
+  GstIOUring *uring;
 };
 
 struct _GstFileSinkClass {
@@ -31,12 +31,36 @@
  * gst-launch-1.0 filesrc location=song.ogg ! decodebin ! audioconvert ! audioresample ! autoaudiosink
  * ]| Play song.ogg audio file which must be in the current working directory.
  *
+ * By default every buffer is filled by copying data out of the file with
+ * read(). For large regular files the #GstFileSrc:read-mode property can be
+ * used to avoid that copy: in `mmap` mode the file is mapped into memory and
+ * output buffers are read-only views of the mapping which can be shared
+ * downstream (e.g. through a tee) without copying, while `direct` mode reads
+ * with aligned direct I/O that does not pollute the page cache. On Linux the
+ * `io-uring` mode reads asynchronously and always keeps a read of the next
+ * block in flight, so that the disk is busy while downstream processes the
+ * current buffer. A larger #GstBaseSrc:blocksize is usually desirable with
+ * all of these modes.
+ *
+ * Note that in `mmap` mode truncating the file while it is being read may
+ * cause the process to be killed with SIGBUS.
+ *
+ * ## Example launch line
+ * |[
+ * gst-launch-1.0 filesrc location=movie.mov read-mode=mmap blocksize=1048576 ! qtdemux ! fakesink
+ * ]| Read a large file without copying its contents.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
 #  include "config.h"
 #endif
 
+/* for O_DIRECT */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1
+#endif
+
 #include <gst/gst.h>
 #include <glib/gstdio.h>
 #include "gstfilesrc.h"
@@ -68,6 +92,10 @@
 #  include <unistd.h>
 #endif
 
+#ifdef HAVE_MADVISE
+#  include <sys/mman.h>
+#endif
+
 #define struct_stat struct stat
 
 #ifdef __BIONIC__               /* Android */
@@ -113,13 +141,48 @@ enum
 };
 
 #define DEFAULT_BLOCKSIZE       4*1024
+#define DEFAULT_READ_MODE       GST_FILE_SRC_READ_MODE_READ
+
+/* offsets, sizes and memory need to be aligned to the logical block size of
+ * the device for direct I/O, 4096 covers all common devices */
+#define DIRECT_IO_ALIGN         4096
+
+/* we have at most the current read and the read-ahead in flight */
+#define IO_URING_DEPTH          4
 
 enum
 {
   PROP_0,
-  PROP_LOCATION
+  PROP_LOCATION,
+  PROP_READ_MODE
 };
 
+#define GST_TYPE_FILE_SRC_READ_MODE (gst_file_src_read_mode_get_type())
+static GType
+gst_file_src_read_mode_get_type (void)
+{
+  static GType read_mode_type = 0;
+
+  if (g_once_init_enter (&read_mode_type)) {
+    static const GEnumValue read_mode[] = {
+      {GST_FILE_SRC_READ_MODE_READ, "Copy data with read()", "read"},
+      {GST_FILE_SRC_READ_MODE_MMAP, "Zero-copy read-only memory mapping",
+          "mmap"},
+      {GST_FILE_SRC_READ_MODE_DIRECT, "Aligned direct I/O bypassing the "
+            "page cache", "direct"},
+      {GST_FILE_SRC_READ_MODE_IO_URING, "Asynchronous io_uring reads with "
+            "read-ahead", "io-uring"},
+      {0, NULL, NULL}
+    };
+
+    GType new_read_mode_type =
+        g_enum_register_static ("GstFileSrcReadMode", read_mode);
+
+    g_once_init_leave (&read_mode_type, new_read_mode_type);
+  }
+  return read_mode_type;
+}
+
 static void gst_file_src_finalize (GObject * object);
 
 static void gst_file_src_set_property (GObject * object, guint prop_id,
@@ -134,6 +197,8 @@ static gboolean gst_file_src_is_seekable (GstBaseSrc * src);
 static gboolean gst_file_src_get_size (GstBaseSrc * src, guint64 * size);
 static GstFlowReturn gst_file_src_fill (GstBaseSrc * src, guint64 offset,
     guint length, GstBuffer * buf);
+static GstFlowReturn gst_file_src_create (GstBaseSrc * src, guint64 offset,
+    guint length, GstBuffer ** buf);
 
 static void gst_file_src_uri_handler_init (gpointer g_iface,
     gpointer iface_data);
@@ -166,6 +231,22 @@ gst_file_src_class_init (GstFileSrcClass * klass)
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
           GST_PARAM_MUTABLE_READY));
 
+  /**
+   * GstFileSrc:read-mode:
+   *
+   * How data is read from the file. The `mmap` and `direct` modes are only
+   * used for seekable regular files, filesrc falls back to `read` for
+   * anything else or when the mode is not supported by the platform or
+   * file system.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_READ_MODE,
+      g_param_spec_enum ("read-mode", "Read Mode",
+          "How data is read from the file", GST_TYPE_FILE_SRC_READ_MODE,
+          DEFAULT_READ_MODE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   gobject_class->finalize = gst_file_src_finalize;
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -180,11 +261,14 @@ gst_file_src_class_init (GstFileSrcClass * klass)
   gstbasesrc_class->is_seekable = GST_DEBUG_FUNCPTR (gst_file_src_is_seekable);
   gstbasesrc_class->get_size = GST_DEBUG_FUNCPTR (gst_file_src_get_size);
   gstbasesrc_class->fill = GST_DEBUG_FUNCPTR (gst_file_src_fill);
+  gstbasesrc_class->create = GST_DEBUG_FUNCPTR (gst_file_src_create);
 
   if (sizeof (off_t) < 8) {
     GST_LOG ("No large file support, sizeof (off_t) = %" G_GSIZE_FORMAT "!",
         sizeof (off_t));
   }
+
+  gst_type_mark_as_plugin_api (GST_TYPE_FILE_SRC_READ_MODE, 0);
 }
 
 static void
@@ -196,6 +280,13 @@ gst_file_src_init (GstFileSrc * src)
 
   src->is_regular = FALSE;
 
+  src->read_mode = DEFAULT_READ_MODE;
+  src->active_read_mode = GST_FILE_SRC_READ_MODE_READ;
+  src->mapped_mem = NULL;
+  src->mapped_size = 0;
+  src->uring = NULL;
+  src->prefetch = NULL;
+
   gst_base_src_set_blocksize (GST_BASE_SRC (src), DEFAULT_BLOCKSIZE);
 }
 
@@ -273,6 +364,9 @@ gst_file_src_set_property (GObject * object, guint prop_id,
     case PROP_LOCATION:
       gst_file_src_set_location (src, g_value_get_string (value), NULL);
       break;
+    case PROP_READ_MODE:
+      src->read_mode = g_value_get_enum (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -293,6 +387,9 @@ gst_file_src_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_LOCATION:
       g_value_set_string (value, src->filename);
       break;
+    case PROP_READ_MODE:
+      g_value_set_enum (value, src->read_mode);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -398,6 +495,395 @@ buffer_write_fail:
   }
 }
 
+/* (re)map the whole file. Buffers handed out earlier keep a reference to
+ * the previous mapping, so this is safe to do while streaming */
+static gboolean
+gst_file_src_map_file (GstFileSrc * src)
+{
+  GMappedFile *mapped;
+  GError *err = NULL;
+  gsize size;
+
+  mapped = g_mapped_file_new_from_fd (src->fd, FALSE, &err);
+  if (mapped == NULL)
+    goto map_failed;
+
+  if (src->mapped_mem)
+    gst_memory_unref (src->mapped_mem);
+  src->mapped_mem = NULL;
+
+  size = g_mapped_file_get_length (mapped);
+  src->mapped_size = size;
+
+  /* empty files have no contents, we will just return EOS */
+  if (size == 0) {
+    g_mapped_file_unref (mapped);
+    return TRUE;
+  }
+#ifdef HAVE_MADVISE
+  /* we're mostly reading sequentially, let the kernel read ahead more
+   * aggressively and drop pages behind us */
+  madvise (g_mapped_file_get_contents (mapped), size, MADV_SEQUENTIAL);
+#endif
+
+  GST_DEBUG_OBJECT (src, "mapped %" G_GSIZE_FORMAT " bytes", size);
+
+  src->mapped_mem = gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY,
+      g_mapped_file_get_contents (mapped), size, 0, size, mapped,
+      (GDestroyNotify) g_mapped_file_unref);
+
+  return TRUE;
+
+  /* ERROR */
+map_failed:
+  {
+    GST_WARNING_OBJECT (src, "could not map file: %s", err->message);
+    g_clear_error (&err);
+    return FALSE;
+  }
+}
+
+static GstFlowReturn
+gst_file_src_create_mmap (GstFileSrc * src, guint64 offset, guint length,
+    GstBuffer ** buffer)
+{
+  GstBuffer *buf;
+
+  if (G_UNLIKELY (offset + length > src->mapped_size)) {
+    guint64 size;
+
+    /* the file might have grown since we mapped it */
+    if (gst_file_src_get_size (GST_BASE_SRC_CAST (src), &size)
+        && size > src->mapped_size) {
+      GST_DEBUG_OBJECT (src, "file grew to %" G_GUINT64_FORMAT ", remapping",
+          size);
+      if (!gst_file_src_map_file (src))
+        goto remap_failed;
+    }
+  }
+
+  buf = gst_buffer_new ();
+
+  if (length > 0) {
+    if (G_UNLIKELY (offset >= src->mapped_size))
+      goto eos;
+
+    length = MIN (length, src->mapped_size - offset);
+
+    GST_LOG_OBJECT (src, "Sharing %u bytes at offset 0x%" G_GINT64_MODIFIER
+        "x", length, offset);
+    gst_buffer_append_memory (buf,
+        gst_memory_share (src->mapped_mem, offset, length));
+  }
+
+  GST_BUFFER_OFFSET (buf) = offset;
+  GST_BUFFER_OFFSET_END (buf) = offset + length;
+
+  *buffer = buf;
+
+  return GST_FLOW_OK;
+
+  /* ERROR */
+remap_failed:
+  {
+    GST_ELEMENT_ERROR (src, RESOURCE, READ, (NULL),
+        ("Could not map file \"%s\"", src->filename));
+    return GST_FLOW_ERROR;
+  }
+eos:
+  {
+    GST_DEBUG ("EOS");
+    gst_buffer_unref (buf);
+    return GST_FLOW_EOS;
+  }
+}
+
+#ifdef G_OS_WIN32
+static gboolean
+gst_file_src_enable_direct_io (GstFileSrc * src)
+{
+  GST_WARNING_OBJECT (src, "direct I/O is not supported on this platform");
+  return FALSE;
+}
+#else
+static gboolean
+gst_file_src_enable_direct_io (GstFileSrc * src)
+{
+#if defined (O_DIRECT)
+  int flags;
+
+  flags = fcntl (src->fd, F_GETFL);
+  if (flags < 0 || fcntl (src->fd, F_SETFL, flags | O_DIRECT) < 0)
+    goto failed;
+#elif defined (F_NOCACHE)
+  if (fcntl (src->fd, F_NOCACHE, 1) < 0)
+    goto failed;
+#else
+  GST_WARNING_OBJECT (src, "direct I/O is not supported on this platform");
+  return FALSE;
+#endif
+
+  return TRUE;
+
+#if defined (O_DIRECT) || defined (F_NOCACHE)
+failed:
+  {
+    GST_WARNING_OBJECT (src, "could not enable direct I/O: %s",
+        g_strerror (errno));
+    return FALSE;
+  }
+#endif
+}
+
+static GstFlowReturn
+gst_file_src_create_direct (GstFileSrc * src, guint64 offset, guint length,
+    GstBuffer ** buffer)
+{
+  GstAllocationParams params;
+  GstMemory *mem;
+  GstMapInfo info;
+  guint64 aligned_offset;
+  gsize head, aligned_length, bytes_read;
+  gssize ret;
+
+  /* read the aligned range covering the request into aligned memory and only
+   * expose the requested part of it, this way we don't need to copy */
+  aligned_offset = offset & ~((guint64) DIRECT_IO_ALIGN - 1);
+  head = offset - aligned_offset;
+  aligned_length = GST_ROUND_UP_N (head + length, DIRECT_IO_ALIGN);
+
+  gst_allocation_params_init (&params);
+  params.align = DIRECT_IO_ALIGN - 1;
+
+  mem = gst_allocator_alloc (NULL, aligned_length, &params);
+  if (!gst_memory_map (mem, &info, GST_MAP_WRITE))
+    goto buffer_write_fail;
+
+  bytes_read = 0;
+  while (bytes_read < aligned_length) {
+    GST_LOG_OBJECT (src, "Reading %" G_GSIZE_FORMAT " bytes at offset 0x%"
+        G_GINT64_MODIFIER "x", aligned_length - bytes_read,
+        aligned_offset + bytes_read);
+    errno = 0;
+    ret = pread (src->fd, info.data + bytes_read, aligned_length - bytes_read,
+        aligned_offset + bytes_read);
+    if (G_UNLIKELY (ret < 0)) {
+      if (errno == EAGAIN || errno == EINTR)
+        continue;
+      goto could_not_read;
+    }
+
+    if (ret == 0)
+      break;
+
+    bytes_read += ret;
+
+    /* a short read that isn't a multiple of the block size means we hit the
+     * end of the file, and we couldn't continue from an unaligned offset */
+    if (ret % DIRECT_IO_ALIGN != 0)
+      break;
+  }
+
+  gst_memory_unmap (mem, &info);
+
+  if (G_UNLIKELY (bytes_read <= head && length > 0))
+    goto eos;
+
+  length = MIN (length, bytes_read - MIN (bytes_read, head));
+  gst_memory_resize (mem, head, length);
+
+  *buffer = gst_buffer_new ();
+  gst_buffer_append_memory (*buffer, mem);
+
+  GST_BUFFER_OFFSET (*buffer) = offset;
+  GST_BUFFER_OFFSET_END (*buffer) = offset + length;
+
+  return GST_FLOW_OK;
+
+  /* ERROR */
+buffer_write_fail:
+  {
+    GST_ELEMENT_ERROR (src, RESOURCE, WRITE, (NULL), ("Can't write to buffer"));
+    gst_memory_unref (mem);
+    return GST_FLOW_ERROR;
+  }
+could_not_read:
+  {
+    GST_ELEMENT_ERROR (src, RESOURCE, READ, (NULL), GST_ERROR_SYSTEM);
+    gst_memory_unmap (mem, &info);
+    gst_memory_unref (mem);
+    return GST_FLOW_ERROR;
+  }
+eos:
+  {
+    GST_DEBUG ("EOS");
+    gst_memory_unref (mem);
+    return GST_FLOW_EOS;
+  }
+}
+#endif /* G_OS_WIN32 */
+
+#ifdef HAVE_IO_URING
+static void
+gst_file_src_uring_drop_prefetch (GstFileSrc * src)
+{
+  GstBuffer *buf;
+  gssize res;
+
+  if (src->prefetch == NULL)
+    return;
+
+  GST_DEBUG_OBJECT (src, "dropping read-ahead at offset %" G_GUINT64_FORMAT,
+      src->prefetch_offset);
+
+  buf = gst_io_uring_op_finish (src->uring, src->prefetch, &res);
+  gst_clear_buffer (&buf);
+  src->prefetch = NULL;
+}
+
+static GstIOUringOp *
+gst_file_src_uring_queue (GstFileSrc * src, guint64 offset, guint length)
+{
+  GstBaseSrc *basesrc = GST_BASE_SRC_CAST (src);
+  GstBuffer *buf = NULL;
+
+  /* allocate like GstBaseSrc would, respecting the negotiated pool */
+  if (GST_BASE_SRC_GET_CLASS (basesrc)->alloc (basesrc, offset, length,
+          &buf) != GST_FLOW_OK)
+    return NULL;
+
+  return gst_io_uring_queue_read (src->uring, src->fd, buf, offset);
+}
+
+static GstFlowReturn
+gst_file_src_create_uring (GstFileSrc * src, guint64 offset, guint length,
+    GstBuffer ** buffer)
+{
+  GstIOUringOp *op;
+  GstBuffer *buf;
+  gssize res;
+
+  /* the read-ahead is only useful for sequential reads of the same size */
+  if (src->prefetch && (src->prefetch_offset != offset
+          || src->prefetch_length != length))
+    gst_file_src_uring_drop_prefetch (src);
+
+  op = src->prefetch;
+  src->prefetch = NULL;
+  if (op == NULL) {
+    op = gst_file_src_uring_queue (src, offset, length);
+    if (op == NULL)
+      goto queue_failed;
+  }
+
+  /* queue the next block before waiting so that it is read while downstream
+   * handles this one. Both go to the kernel with one submission. */
+  src->prefetch = gst_file_src_uring_queue (src, offset + length, length);
+  src->prefetch_offset = offset + length;
+  src->prefetch_length = length;
+
+  buf = gst_io_uring_op_finish (src->uring, op, &res);
+  if (G_UNLIKELY (res < 0))
+    goto could_not_read;
+
+  if (G_UNLIKELY (res == 0 && length > 0))
+    goto eos;
+
+  GST_LOG_OBJECT (src, "Read %" G_GSSIZE_FORMAT " bytes at offset 0x%"
+      G_GINT64_MODIFIER "x", res, offset);
+
+  GST_BUFFER_OFFSET (buf) = offset;
+  GST_BUFFER_OFFSET_END (buf) = offset + res;
+
+  *buffer = buf;
+
+  return GST_FLOW_OK;
+
+  /* ERROR */
+queue_failed:
+  {
+    GST_ELEMENT_ERROR (src, RESOURCE, READ, (NULL),
+        ("Could not queue read of %u bytes", length));
+    return GST_FLOW_ERROR;
+  }
+could_not_read:
+  {
+    GST_ELEMENT_ERROR (src, RESOURCE, READ, (NULL), ("%s",
+            g_strerror (-res)));
+    gst_clear_buffer (&buf);
+    return GST_FLOW_ERROR;
+  }
+eos:
+  {
+    GST_DEBUG ("EOS");
+    gst_buffer_unref (buf);
+    gst_file_src_uring_drop_prefetch (src);
+    return GST_FLOW_EOS;
+  }
+}
+#endif /* HAVE_IO_URING */
+
+static GstFlowReturn
+gst_file_src_create (GstBaseSrc * basesrc, guint64 offset, guint length,
+    GstBuffer ** buffer)
+{
+  GstFileSrc *src = GST_FILE_SRC_CAST (basesrc);
+  GstBuffer *buf = NULL;
+  GstFlowReturn ret;
+  GstMapInfo info;
+  gsize size;
+
+  switch (src->active_read_mode) {
+    case GST_FILE_SRC_READ_MODE_MMAP:
+      ret = gst_file_src_create_mmap (src, offset, length, &buf);
+      break;
+#ifndef G_OS_WIN32
+    case GST_FILE_SRC_READ_MODE_DIRECT:
+      ret = gst_file_src_create_direct (src, offset, length, &buf);
+      break;
+#endif
+#ifdef HAVE_IO_URING
+    case GST_FILE_SRC_READ_MODE_IO_URING:
+      ret = gst_file_src_create_uring (src, offset, length, &buf);
+      break;
+#endif
+    default:
+      return GST_BASE_SRC_CLASS (parent_class)->create (basesrc, offset,
+          length, buffer);
+  }
+
+  if (ret != GST_FLOW_OK)
+    return ret;
+
+  if (*buffer == NULL) {
+    *buffer = buf;
+    return GST_FLOW_OK;
+  }
+
+  /* we were asked to fill a buffer provided by the caller */
+  if (!gst_buffer_map (*buffer, &info, GST_MAP_WRITE))
+    goto buffer_write_fail;
+
+  size = gst_buffer_extract (buf, 0, info.data, info.size);
+  gst_buffer_unmap (*buffer, &info);
+  gst_buffer_resize (*buffer, 0, size);
+
+  GST_BUFFER_OFFSET (*buffer) = offset;
+  GST_BUFFER_OFFSET_END (*buffer) = offset + size;
+
+  gst_buffer_unref (buf);
+
+  return GST_FLOW_OK;
+
+  /* ERROR */
+buffer_write_fail:
+  {
+    GST_ELEMENT_ERROR (src, RESOURCE, WRITE, (NULL), ("Can't write to buffer"));
+    gst_buffer_unref (buf);
+    return GST_FLOW_ERROR;
+  }
+}
+
 static gboolean
 gst_file_src_is_seekable (GstBaseSrc * basesrc)
 {
@@ -569,6 +1055,28 @@ gst_file_src_start (GstBaseSrc * basesrc)
 
   gst_base_src_set_dynamic_size (basesrc, src->seekable);
 
+  src->active_read_mode = GST_FILE_SRC_READ_MODE_READ;
+  if (src->read_mode != GST_FILE_SRC_READ_MODE_READ) {
+    if (!src->seekable) {
+      GST_WARNING_OBJECT (src, "not a seekable regular file, using read mode");
+    } else if (src->read_mode == GST_FILE_SRC_READ_MODE_MMAP) {
+      if (gst_file_src_map_file (src))
+        src->active_read_mode = GST_FILE_SRC_READ_MODE_MMAP;
+    } else if (src->read_mode == GST_FILE_SRC_READ_MODE_DIRECT) {
+      if (gst_file_src_enable_direct_io (src))
+        src->active_read_mode = GST_FILE_SRC_READ_MODE_DIRECT;
+    } else if (src->read_mode == GST_FILE_SRC_READ_MODE_IO_URING) {
+#ifdef HAVE_IO_URING
+      src->uring = gst_io_uring_new (GST_OBJECT_CAST (src), IO_URING_DEPTH);
+      if (src->uring)
+        src->active_read_mode = GST_FILE_SRC_READ_MODE_IO_URING;
+#else
+      GST_WARNING_OBJECT (src, "io_uring support not compiled in");
+#endif
+    }
+    GST_INFO_OBJECT (src, "using read mode %d", src->active_read_mode);
+  }
+
   return TRUE;
 
   /* ERROR */
@@ -632,6 +1140,14 @@ gst_file_src_stop (GstBaseSrc * basesrc)
 {
   GstFileSrc *src = GST_FILE_SRC (basesrc);
 
+#ifdef HAVE_IO_URING
+  if (src->uring) {
+    gst_file_src_uring_drop_prefetch (src);
+    gst_io_uring_free (src->uring);
+    src->uring = NULL;
+  }
+#endif
+
   /* close the file */
   g_close (src->fd, NULL);
 
@@ -639,6 +1155,12 @@ gst_file_src_stop (GstBaseSrc * basesrc)
   src->fd = 0;
   src->is_regular = FALSE;
 
+  if (src->mapped_mem)
+    gst_memory_unref (src->mapped_mem);
+  src->mapped_mem = NULL;
+  src->mapped_size = 0;
+  src->active_read_mode = GST_FILE_SRC_READ_MODE_READ;
+
   return TRUE;
 }
 
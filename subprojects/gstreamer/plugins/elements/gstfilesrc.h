@@ -29,6 +29,8 @@
 #include <gst/gst.h>
 #include <gst/base/gstbasesrc.h>
 
+#include "gstiouring.h"
+
 G_BEGIN_DECLS
 
 #define GST_TYPE_FILE_SRC \
@@ -46,6 +48,28 @@ G_BEGIN_DECLS
 typedef struct _GstFileSrc GstFileSrc;
 typedef struct _GstFileSrcClass GstFileSrcClass;
 
+/**
+ * GstFileSrcReadMode:
+ * @GST_FILE_SRC_READ_MODE_READ: Copy data into newly allocated buffers with
+ *   read()
+ * @GST_FILE_SRC_READ_MODE_MMAP: Map the file and output read-only buffers
+ *   pointing into the mapping
+ * @GST_FILE_SRC_READ_MODE_DIRECT: Bypass the page cache with aligned direct
+ *   I/O reads
+ * @GST_FILE_SRC_READ_MODE_IO_URING: Read asynchronously with io_uring and
+ *   prefetch the next block
+ *
+ * How filesrc gets the data out of the file.
+ *
+ * Since: 1.26
+ */
+typedef enum {
+  GST_FILE_SRC_READ_MODE_READ   = 0,
+  GST_FILE_SRC_READ_MODE_MMAP   = 1,
+  GST_FILE_SRC_READ_MODE_DIRECT = 2,
+  GST_FILE_SRC_READ_MODE_IO_URING = 3,
+} GstFileSrcReadMode;
+
 /**
  * GstFileSrc:
  *
@@ -63,6 +87,18 @@ struct _GstFileSrc {
   gboolean seekable;                    /* whether the file is seekable */
   gboolean is_regular;                  /* whether it's a (symlink to a)
                                            regular file */
+
+  GstFileSrcReadMode read_mode;         /* configured read mode */
+  GstFileSrcReadMode active_read_mode;  /* read mode in use after start */
+
+  GstMemory *mapped_mem;                /* read-only memory wrapping the
+                                           file mapping in mmap mode */
+  guint64 mapped_size;                  /* size of the current mapping */
+
+  GstIOUring *uring;                    /* io_uring mode */
+  GstIOUringOp *prefetch;               /* pending read-ahead */
+  guint64 prefetch_offset;
+  guint prefetch_length;
 };
 
 struct _GstFileSrcClass {
@@ -0,0 +1,472 @@
+/* GStreamer
+ * gstiouring.c: io_uring helper for the file elements
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Small wrapper around liburing used by filesink and filesrc.
+ *
+ * Operations are always done on complete buffers at an explicit file offset.
+ * The buffer is kept mapped and referenced until the kernel completed the
+ * operation. Writes are fire-and-forget: they are released as soon as they
+ * complete and the first error is reported by the next call into the ring.
+ * Reads return a handle that the caller has to finish to get the buffer
+ * back. Short transfers are completed with blocking calls, which only
+ * happens in corner cases such as a full disk or a signal. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstiouring.h"
+
+#ifdef HAVE_IO_URING
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <liburing.h>
+
+GST_DEBUG_CATEGORY_STATIC (gst_io_uring_debug);
+#define GST_CAT_DEFAULT gst_io_uring_debug
+
+/* the maximum number of memories in a buffer, see
+ * gst_buffer_get_max_memory() */
+#define MAX_VECS 16
+
+struct _GstIOUringOp
+{
+  GstBuffer *buffer;
+  GstMapInfo maps[MAX_VECS];
+  struct iovec iov[MAX_VECS];
+  guint n_vecs;
+
+  gint fd;
+  guint64 offset;
+  gsize size;
+  gboolean is_read;
+
+  gboolean done;
+  gboolean detached;
+  gssize result;
+};
+
+struct _GstIOUring
+{
+  GstObject *owner;
+  struct io_uring ring;
+  guint depth;
+
+  /* prepared but not submitted yet */
+  guint n_queued;
+  /* prepared or submitted but not completed yet */
+  guint n_in_flight;
+
+  /* first failed write as -errno, reported once */
+  gint error;
+};
+
+GstIOUring *
+gst_io_uring_new (GstObject * owner, guint depth)
+{
+  static gsize cat_gonce = 0;
+  GstIOUring *ring;
+  gint ret;
+
+  if (g_once_init_enter (&cat_gonce)) {
+    GST_DEBUG_CATEGORY_INIT (gst_io_uring_debug, "iouring", 0,
+        "io_uring helper for the file elements");
+    g_once_init_leave (&cat_gonce, 1);
+  }
+
+  ring = g_new0 (GstIOUring, 1);
+
+  ret = io_uring_queue_init (depth, &ring->ring, 0);
+  if (ret < 0) {
+    GST_WARNING_OBJECT (owner, "io_uring not available: %s", g_strerror (-ret));
+    g_free (ring);
+    return NULL;
+  }
+
+  ring->owner = owner;
+  ring->depth = depth;
+
+  GST_DEBUG_OBJECT (owner, "created io_uring with %u entries", depth);
+
+  return ring;
+}
+
+static void
+gst_io_uring_op_unmap (GstIOUringOp * op)
+{
+  guint i;
+
+  for (i = 0; i < op->n_vecs; i++)
+    gst_memory_unmap (op->maps[i].memory, &op->maps[i]);
+  op->n_vecs = 0;
+}
+
+static gboolean
+gst_io_uring_op_map (GstIOUringOp * op, GstMapFlags flags)
+{
+  guint i, n_mem;
+
+  n_mem = gst_buffer_n_memory (op->buffer);
+  g_return_val_if_fail (n_mem <= MAX_VECS, FALSE);
+
+  op->n_vecs = 0;
+  op->size = 0;
+  for (i = 0; i < n_mem; i++) {
+    GstMemory *mem = gst_buffer_peek_memory (op->buffer, i);
+    GstMapInfo *map = &op->maps[op->n_vecs];
+
+    if (!gst_memory_map (mem, map, flags)) {
+      gst_io_uring_op_unmap (op);
+      return FALSE;
+    }
+
+    op->iov[op->n_vecs].iov_base = map->data;
+    op->iov[op->n_vecs].iov_len = map->size;
+    op->size += map->size;
+    op->n_vecs++;
+  }
+
+  return TRUE;
+}
+
+static void
+gst_io_uring_op_free (GstIOUringOp * op)
+{
+  gst_io_uring_op_unmap (op);
+  gst_buffer_unref (op->buffer);
+  g_free (op);
+}
+
+static GstIOUringOp *
+gst_io_uring_op_new (gint fd, GstBuffer * buffer, guint64 offset,
+    gboolean is_read)
+{
+  GstIOUringOp *op;
+
+  op = g_new0 (GstIOUringOp, 1);
+  op->buffer = buffer;
+  op->fd = fd;
+  op->offset = offset;
+  op->is_read = is_read;
+
+  if (!gst_io_uring_op_map (op, is_read ? GST_MAP_WRITE : GST_MAP_READ)) {
+    gst_buffer_unref (buffer);
+    g_free (op);
+    return NULL;
+  }
+
+  return op;
+}
+
+/* finish a partial transfer with blocking calls, returns the total number of
+ * bytes transferred or -errno */
+static gssize
+gst_io_uring_op_complete_sync (GstIOUringOp * op, gssize done)
+{
+  gsize skip = done;
+  guint i;
+
+  for (i = 0; i < op->n_vecs; i++) {
+    guint8 *data = op->iov[i].iov_base;
+    gsize len = op->iov[i].iov_len;
+
+    if (skip >= len) {
+      skip -= len;
+      continue;
+    }
+    data += skip;
+    len -= skip;
+    skip = 0;
+
+    while (len > 0) {
+      gssize ret;
+
+      if (op->is_read)
+        ret = pread (op->fd, data, len, op->offset + done);
+      else
+        ret = pwrite (op->fd, data, len, op->offset + done);
+
+      if (ret < 0) {
+        if (errno == EINTR || errno == EAGAIN)
+          continue;
+        return -errno;
+      }
+      if (ret == 0)
+        return op->is_read ? done : -EIO;
+
+      data += ret;
+      len -= ret;
+      done += ret;
+    }
+  }
+
+  return done;
+}
+
+static void
+gst_io_uring_complete (GstIOUring * ring, GstIOUringOp * op, gint res)
+{
+  gssize result = res;
+
+  ring->n_in_flight--;
+
+  if (result >= 0 && (gsize) result < op->size && !op->detached) {
+    GST_DEBUG_OBJECT (ring->owner, "short %s of %" G_GSSIZE_FORMAT " of %"
+        G_GSIZE_FORMAT " bytes", op->is_read ? "read" : "write", result,
+        op->size);
+    /* reads returning 0 are at EOF, nothing left to do then */
+    if (!op->is_read || result > 0)
+      result = gst_io_uring_op_complete_sync (op, result);
+  }
+
+  if (result < 0) {
+    GST_WARNING_OBJECT (ring->owner, "%s at offset %" G_GUINT64_FORMAT
+        " failed: %s", op->is_read ? "read" : "write", op->offset,
+        g_strerror (-result));
+  }
+
+  if (op->is_read && !op->detached) {
+    op->result = result;
+    op->done = TRUE;
+    return;
+  }
+
+  if (!op->is_read && result < 0 && ring->error == 0)
+    ring->error = result;
+
+  gst_io_uring_op_free (op);
+}
+
+/* handle all pending completions, waiting for at least one if @wait is TRUE.
+ * Returns 0 or -errno */
+static gint
+gst_io_uring_reap (GstIOUring * ring, gboolean wait)
+{
+  struct io_uring_cqe *cqe;
+  gint ret;
+
+  if (wait) {
+    do {
+      ret = io_uring_wait_cqe (&ring->ring, &cqe);
+    } while (ret == -EINTR);
+  } else {
+    ret = io_uring_peek_cqe (&ring->ring, &cqe);
+  }
+
+  while (ret == 0) {
+    GstIOUringOp *op = io_uring_cqe_get_data (cqe);
+    gint res = cqe->res;
+
+    io_uring_cqe_seen (&ring->ring, cqe);
+    gst_io_uring_complete (ring, op, res);
+
+    ret = io_uring_peek_cqe (&ring->ring, &cqe);
+  }
+
+  /* nothing left to peek */
+  if (ret == -EAGAIN)
+    return 0;
+
+  GST_ERROR_OBJECT (ring->owner, "failed to get completion: %s",
+      g_strerror (-ret));
+
+  return ret;
+}
+
+gint
+gst_io_uring_submit (GstIOUring * ring)
+{
+  gint ret;
+
+  if (ring->n_queued == 0)
+    return 0;
+
+  do {
+    ret = io_uring_submit (&ring->ring);
+  } while (ret == -EINTR);
+
+  if (ret < 0) {
+    GST_ERROR_OBJECT (ring->owner, "failed to submit: %s", g_strerror (-ret));
+    return ret;
+  }
+
+  GST_LOG_OBJECT (ring->owner, "submitted %d of %u operations", ret,
+      ring->n_queued);
+  ring->n_queued -= MIN ((guint) ret, ring->n_queued);
+
+  return ret;
+}
+
+static gint
+gst_io_uring_get_sqe (GstIOUring * ring, struct io_uring_sqe **sqe)
+{
+  gint ret;
+
+  /* never have more operations in flight than the ring can hold, this also
+   * makes sure the completion queue can't overflow */
+  while (ring->n_in_flight >= ring->depth) {
+    if ((ret = gst_io_uring_submit (ring)) < 0)
+      return ret;
+    if ((ret = gst_io_uring_reap (ring, TRUE)) < 0)
+      return ret;
+  }
+
+  *sqe = io_uring_get_sqe (&ring->ring);
+  if (*sqe == NULL) {
+    if ((ret = gst_io_uring_submit (ring)) < 0)
+      return ret;
+    *sqe = io_uring_get_sqe (&ring->ring);
+  }
+
+  return *sqe ? 0 : -EBUSY;
+}
+
+/* Queue writing @buffer at @offset. This takes a reference to @buffer. The
+ * write is only started after the next gst_io_uring_submit(). Returns 0 or
+ * the -errno of an earlier write that failed. */
+gint
+gst_io_uring_queue_write (GstIOUring * ring, gint fd, GstBuffer * buffer,
+    guint64 offset)
+{
+  struct io_uring_sqe *sqe;
+  GstIOUringOp *op;
+  gint ret;
+
+  /* pick up completions so that errors are reported as early as possible */
+  if ((ret = gst_io_uring_reap (ring, FALSE)) < 0)
+    return ret;
+
+  if (ring->error) {
+    ret = ring->error;
+    ring->error = 0;
+    return ret;
+  }
+
+  op = gst_io_uring_op_new (fd, gst_buffer_ref (buffer), offset, FALSE);
+  if (op == NULL)
+    return -EINVAL;
+
+  if ((ret = gst_io_uring_get_sqe (ring, &sqe)) < 0) {
+    gst_io_uring_op_free (op);
+    return ret;
+  }
+
+  GST_LOG_OBJECT (ring->owner, "queue write of %" G_GSIZE_FORMAT " bytes at "
+      "offset %" G_GUINT64_FORMAT, op->size, offset);
+
+  io_uring_prep_writev (sqe, fd, op->iov, op->n_vecs, offset);
+  io_uring_sqe_set_data (sqe, op);
+  ring->n_queued++;
+  ring->n_in_flight++;
+
+  return 0;
+}
+
+/* Queue reading into @buffer from @offset, taking ownership of @buffer. The
+ * read is only started after the next gst_io_uring_submit() and the buffer
+ * can be retrieved with gst_io_uring_op_finish(). */
+GstIOUringOp *
+gst_io_uring_queue_read (GstIOUring * ring, gint fd, GstBuffer * buffer,
+    guint64 offset)
+{
+  struct io_uring_sqe *sqe;
+  GstIOUringOp *op;
+
+  op = gst_io_uring_op_new (fd, buffer, offset, TRUE);
+  if (op == NULL)
+    return NULL;
+
+  if (gst_io_uring_get_sqe (ring, &sqe) < 0) {
+    gst_io_uring_op_free (op);
+    return NULL;
+  }
+
+  GST_LOG_OBJECT (ring->owner, "queue read of %" G_GSIZE_FORMAT " bytes at "
+      "offset %" G_GUINT64_FORMAT, op->size, offset);
+
+  io_uring_prep_readv (sqe, fd, op->iov, op->n_vecs, offset);
+  io_uring_sqe_set_data (sqe, op);
+  ring->n_queued++;
+  ring->n_in_flight++;
+
+  return op;
+}
+
+/* Wait for the read @op to complete and return its buffer, resized to the
+ * amount of data that was read. @result is set to the number of bytes read
+ * or -errno. */
+GstBuffer *
+gst_io_uring_op_finish (GstIOUring * ring, GstIOUringOp * op, gssize * result)
+{
+  GstBuffer *buffer;
+  gint ret;
+
+  ret = gst_io_uring_submit (ring);
+  while (ret >= 0 && !op->done)
+    ret = gst_io_uring_reap (ring, TRUE);
+
+  if (!op->done) {
+    /* the kernel still owns the memory, let the completion free it */
+    op->detached = TRUE;
+    *result = ret;
+    return NULL;
+  }
+
+  gst_io_uring_op_unmap (op);
+  buffer = op->buffer;
+  *result = op->result;
+  g_free (op);
+
+  if (*result >= 0 && (gsize) * result < gst_buffer_get_size (buffer))
+    gst_buffer_resize (buffer, 0, *result);
+
+  return buffer;
+}
+
+/* Wait for all operations to complete. Returns 0 or the -errno of the first
+ * write that failed. */
+gint
+gst_io_uring_drain (GstIOUring * ring)
+{
+  gint ret;
+
+  ret = gst_io_uring_submit (ring);
+  while (ret >= 0 && ring->n_in_flight > 0)
+    ret = gst_io_uring_reap (ring, TRUE);
+
+  if (ret >= 0 && ring->error) {
+    ret = ring->error;
+    ring->error = 0;
+  }
+
+  return MIN (ret, 0);
+}
+
+/* All reads have to be finished before freeing the ring */
+void
+gst_io_uring_free (GstIOUring * ring)
+{
+  gst_io_uring_drain (ring);
+  io_uring_queue_exit (&ring->ring);
+  g_free (ring);
+}
+
+#endif /* HAVE_IO_URING */
@@ -0,0 +1,63 @@
+/* GStreamer
+ * gstiouring.h: io_uring helper for the file elements
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_IO_URING_H__
+#define __GST_IO_URING_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GstIOUring GstIOUring;
+typedef struct _GstIOUringOp GstIOUringOp;
+
+/* All functions below are only implemented when HAVE_IO_URING is defined,
+ * gst_io_uring_new() returns NULL when the kernel doesn't support io_uring
+ * and callers are expected to fall back to blocking I/O in that case. */
+
+G_GNUC_INTERNAL
+GstIOUring *    gst_io_uring_new            (GstObject * owner, guint depth);
+
+G_GNUC_INTERNAL
+void            gst_io_uring_free           (GstIOUring * ring);
+
+G_GNUC_INTERNAL
+gint            gst_io_uring_queue_write    (GstIOUring * ring, gint fd,
+                                             GstBuffer * buffer,
+                                             guint64 offset);
+
+G_GNUC_INTERNAL
+GstIOUringOp *  gst_io_uring_queue_read     (GstIOUring * ring, gint fd,
+                                             GstBuffer * buffer,
+                                             guint64 offset);
+
+G_GNUC_INTERNAL
+GstBuffer *     gst_io_uring_op_finish      (GstIOUring * ring,
+                                             GstIOUringOp * op,
+                                             gssize * result);
+
+G_GNUC_INTERNAL
+gint            gst_io_uring_submit         (GstIOUring * ring);
+
+G_GNUC_INTERNAL
+gint            gst_io_uring_drain          (GstIOUring * ring);
+
+G_END_DECLS
+
+#endif /* __GST_IO_URING_H__ */
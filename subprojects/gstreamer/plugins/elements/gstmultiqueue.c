@@ -74,6 +74,13 @@
  * of buffers will dynamically grow depending on the fill level of
  * other queues.
  *
+ * If #GstMultiQueue:temp-template is set to a value such as
+ * /tmp/gstreamer-XXXXXX, the data of the buffers each stream queues beyond
+ * #GstMultiQueue:spill-threshold bytes is written to files created from that
+ * template and mapped back when the buffers are pushed out. Together with
+ * raised queue limits this allows queueing long durations of several streams
+ * without keeping them in memory.
+ *
  * The #GstMultiQueue::underrun signal is emitted when all of the queues
  * are empty. The #GstMultiQueue::overrun signal is emitted when one of the
  * queues is filled.
@@ -96,11 +103,40 @@
 
 #include <gst/gst.h>
 #include <gst/glib-compat-private.h>
+#include <glib/gstdio.h>
 #include <stdio.h>
+#include <errno.h>
+
+#ifdef G_OS_WIN32
+#include <io.h>                 /* close */
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
 
 #include "gstmultiqueue.h"
 #include "gstcoreelementselements.h"
 
+/* A file the buffers of a single queue are written to once it holds more
+ * than spill-threshold bytes in memory. Buffers are appended until the file
+ * reaches SPILL_SEGMENT_SIZE or until one of them is popped. The file is then
+ * mapped and popped buffers wrap the mapping, so their data is only read back
+ * from disk when it is accessed. The file is removed once all the buffers in
+ * it were popped and released. */
+typedef struct _GstMultiQueueSpill GstMultiQueueSpill;
+
+struct _GstMultiQueueSpill
+{
+  gint refcount;
+
+  gchar *location;
+  FILE *file;
+  guint64 size;
+
+  /* contents of the file, once nothing is appended anymore */
+  GBytes *mapped;
+};
+
 /* GstSingleQueue:
  * @sinkpad: associated sink #GstPad
  * @srcpad: associated source #GstPad
@@ -185,6 +221,12 @@ struct _GstSingleQueue
   /* For interleave calculation */
   GThread *thread;              /* Streaming thread of SingleQueue */
   GstClockTime interleave;      /* Calculated interleve within the thread */
+
+  /* Spilling to disk */
+  guint64 spill_threshold;
+  GMutex spill_lock;            /* protects the following */
+  guint64 resident_bytes;       /* bytes of queued buffers kept in memory */
+  GstMultiQueueSpill *spill_write;      /* file buffers are spilled to */
 };
 
 /* Extension of GstDataQueueItem structure for our usage */
@@ -201,6 +243,10 @@ struct _GstMultiQueueItem
   guint32 posid;
 
   gboolean is_query;
+
+  /* set if the memory of the buffer was written to a spill file */
+  GstMultiQueueSpill *spill;
+  guint64 spill_offset;
 };
 
 static GstSingleQueue *gst_single_queue_new (GstMultiQueue * mqueue, guint id);
@@ -269,6 +315,10 @@ enum
 
 #define DEFAULT_MINIMUM_INTERLEAVE (250 * GST_MSECOND)
 
+#define DEFAULT_TEMP_TEMPLATE NULL
+#define DEFAULT_SPILL_THRESHOLD (2 * 1024 * 1024)
+#define SPILL_SEGMENT_SIZE (64 * 1024 * 1024)
+
 enum
 {
   PROP_0,
@@ -288,6 +338,8 @@ enum
   PROP_UNLINKED_CACHE_TIME,
   PROP_MINIMUM_INTERLEAVE,
   PROP_STATS,
+  PROP_TEMP_TEMPLATE,
+  PROP_SPILL_THRESHOLD,
   PROP_LAST
 };
 
@@ -840,6 +892,42 @@ gst_multi_queue_class_init (GstMultiQueueClass * klass)
           "Multiqueue Statistics",
           GST_TYPE_STRUCTURE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstMultiQueue:temp-template:
+   *
+   * File template for the files queued buffers are spilled to, should
+   * contain a directory and XXXXXX. Every stream uses its own files. When
+   * set, the memory of buffers queued beyond #GstMultiQueue:spill-threshold
+   * bytes in a stream is written to disk and only mapped back when the
+   * buffers are pushed downstream. Events and queries always stay in
+   * memory.
+   *
+   * The queue limits still apply, they should be raised accordingly to
+   * buffer more data than fits in memory.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_TEMP_TEMPLATE,
+      g_param_spec_string ("temp-template", "Temporary File Template",
+          "File template to spill queued buffers to, should contain directory "
+          "and XXXXXX. (NULL == disabled)", DEFAULT_TEMP_TEMPLATE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstMultiQueue:spill-threshold:
+   *
+   * Number of bytes of buffers each stream keeps in memory before spilling
+   * the following ones to #GstMultiQueue:temp-template files.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_SPILL_THRESHOLD,
+      g_param_spec_uint64 ("spill-threshold", "Spill threshold (bytes)",
+          "Bytes of queued buffers kept in memory per stream before spilling "
+          "to temp-template files", 0, G_MAXUINT64, DEFAULT_SPILL_THRESHOLD,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
   gobject_class->finalize = gst_multi_queue_finalize;
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -883,6 +971,9 @@ gst_multi_queue_init (GstMultiQueue * mqueue)
   mqueue->min_interleave_time = DEFAULT_MINIMUM_INTERLEAVE;
   mqueue->unlinked_cache_time = DEFAULT_UNLINKED_CACHE_TIME;
 
+  mqueue->temp_template = g_strdup (DEFAULT_TEMP_TEMPLATE);
+  mqueue->spill_threshold = DEFAULT_SPILL_THRESHOLD;
+
   mqueue->counter = 1;
   mqueue->highid = -1;
   mqueue->high_time = GST_CLOCK_STIME_NONE;
@@ -902,6 +993,7 @@ gst_multi_queue_finalize (GObject * object)
   mqueue->queues_cookie++;
 
   /* free/unref instance data */
+  g_free (mqueue->temp_template);
   g_mutex_clear (&mqueue->qlock);
   g_mutex_clear (&mqueue->reconf_lock);
   g_mutex_clear (&mqueue->buffering_post_lock);
@@ -920,6 +1012,31 @@ gst_multi_queue_finalize (GObject * object)
     };								\
 } G_STMT_END
 
+static void
+gst_multi_queue_set_temp_template (GstMultiQueue * mq, const gchar * template)
+{
+  GstState state;
+
+  /* the element must be stopped in order to do this */
+  GST_OBJECT_LOCK (mq);
+  state = GST_STATE (mq);
+  if (state != GST_STATE_READY && state != GST_STATE_NULL)
+    goto wrong_state;
+  GST_OBJECT_UNLOCK (mq);
+
+  g_free (mq->temp_template);
+  mq->temp_template = g_strdup (template);
+
+  return;
+
+/* ERROR */
+wrong_state:
+  {
+    GST_WARNING_OBJECT (mq, "setting temp-template property in wrong state");
+    GST_OBJECT_UNLOCK (mq);
+  }
+}
+
 static void
 gst_multi_queue_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
@@ -1031,6 +1148,21 @@ gst_multi_queue_set_property (GObject * object, guint prop_id,
         calculate_interleave (mq, NULL);
       GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
       break;
+    case PROP_TEMP_TEMPLATE:
+      gst_multi_queue_set_temp_template (mq, g_value_get_string (value));
+      break;
+    case PROP_SPILL_THRESHOLD:{
+      GList *tmp;
+
+      GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+      mq->spill_threshold = g_value_get_uint64 (value);
+      for (tmp = mq->queues; tmp; tmp = g_list_next (tmp)) {
+        GstSingleQueue *q = (GstSingleQueue *) tmp->data;
+        q->spill_threshold = mq->spill_threshold;
+      }
+      GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1134,6 +1266,12 @@ gst_multi_queue_get_property (GObject * object, guint prop_id,
     case PROP_STATS:
       g_value_take_boxed (value, gst_multi_queue_get_stats (mq));
       break;
+    case PROP_TEMP_TEMPLATE:
+      g_value_set_string (value, mq->temp_template);
+      break;
+    case PROP_SPILL_THRESHOLD:
+      g_value_set_uint64 (value, mq->spill_threshold);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2100,6 +2238,256 @@ gst_single_queue_push_one (GstMultiQueue * mq, GstSingleQueue * sq,
   /* ERRORS */
 }
 
+static GstMultiQueueSpill *
+gst_multi_queue_spill_new (GstMultiQueue * mq, GstSingleQueue * sq)
+{
+  GstMultiQueueSpill *spill;
+  gchar *name;
+  FILE *file;
+  gint fd;
+
+  /* make copy of the template, we don't want to change this */
+  name = g_strdup (mq->temp_template);
+  fd = g_mkstemp (name);
+  if (fd == -1)
+    goto mkstemp_failed;
+
+  file = fdopen (fd, "wb+");
+  if (file == NULL)
+    goto open_failed;
+
+#ifndef G_OS_WIN32
+  /* nobody else needs the file, don't leave it behind if we crash */
+  g_unlink (name);
+#endif
+
+  spill = g_new0 (GstMultiQueueSpill, 1);
+  spill->refcount = 1;
+  spill->location = name;
+  spill->file = file;
+
+  GST_DEBUG_ID (sq->debug_id, "spilling buffers to %s", name);
+
+  return spill;
+
+  /* ERRORS */
+mkstemp_failed:
+  {
+    GST_WARNING_ID (sq->debug_id, "could not create spill file \"%s\": %s",
+        mq->temp_template, g_strerror (errno));
+    g_free (name);
+    return NULL;
+  }
+open_failed:
+  {
+    GST_WARNING_ID (sq->debug_id, "could not open spill file \"%s\": %s",
+        name, g_strerror (errno));
+    close (fd);
+    g_unlink (name);
+    g_free (name);
+    return NULL;
+  }
+}
+
+static GstMultiQueueSpill *
+gst_multi_queue_spill_ref (GstMultiQueueSpill * spill)
+{
+  g_atomic_int_inc (&spill->refcount);
+
+  return spill;
+}
+
+static void
+gst_multi_queue_spill_unref (GstMultiQueueSpill * spill)
+{
+  if (!g_atomic_int_dec_and_test (&spill->refcount))
+    return;
+
+  /* buffers still using the mapping keep it alive */
+  if (spill->mapped)
+    g_bytes_unref (spill->mapped);
+  fclose (spill->file);
+#ifdef G_OS_WIN32
+  g_unlink (spill->location);
+#endif
+  g_free (spill->location);
+  g_free (spill);
+}
+
+/* called with the spill lock. Makes the contents of @spill available to
+ * popped buffers, nothing can be appended to it afterwards */
+static gboolean
+gst_multi_queue_spill_seal (GstSingleQueue * sq, GstMultiQueueSpill * spill)
+{
+  GMappedFile *mapped;
+  GError *err = NULL;
+  gpointer data;
+
+  if (spill == sq->spill_write) {
+    sq->spill_write = NULL;
+    gst_multi_queue_spill_unref (spill);
+  }
+
+  /* every buffer was flushed to the file when it was spilled */
+  mapped = g_mapped_file_new_from_fd (fileno (spill->file), FALSE, &err);
+  if (mapped == NULL)
+    goto map_failed;
+
+  spill->mapped = g_mapped_file_get_bytes (mapped);
+  g_mapped_file_unref (mapped);
+
+  return TRUE;
+
+  /* ERRORS */
+map_failed:
+  {
+    GST_WARNING_ID (sq->debug_id, "could not map %s, reading it: %s",
+        spill->location, err->message);
+    g_clear_error (&err);
+
+    data = g_malloc (spill->size);
+    rewind (spill->file);
+    if (fread (data, spill->size, 1, spill->file) != 1) {
+      g_free (data);
+      goto read_failed;
+    }
+    spill->mapped = g_bytes_new_take (data, spill->size);
+    return TRUE;
+  }
+read_failed:
+  {
+    GST_ERROR_ID (sq->debug_id, "could not read back %s: %s",
+        spill->location, g_strerror (errno));
+    return FALSE;
+  }
+}
+
+/* Writes the memory of the buffer in @item to the spill file of @sq once
+ * the queue holds more than spill-threshold bytes in memory. Only called
+ * from the streaming thread of the sink pad. */
+static void
+gst_single_queue_spill_item (GstMultiQueue * mq, GstSingleQueue * sq,
+    GstMultiQueueItem * item)
+{
+  GstBuffer *buffer = GST_BUFFER_CAST (item->object);
+  GstMultiQueueSpill *spill;
+  GstBuffer *shell;
+  GstMapInfo map;
+
+  g_mutex_lock (&sq->spill_lock);
+
+  if (mq->temp_template == NULL || item->size == 0
+      || sq->resident_bytes + item->size <= sq->spill_threshold)
+    goto keep;
+
+  if (sq->spill_write && sq->spill_write->size >= SPILL_SEGMENT_SIZE) {
+    gst_multi_queue_spill_unref (sq->spill_write);
+    sq->spill_write = NULL;
+  }
+  if (sq->spill_write == NULL
+      && (sq->spill_write = gst_multi_queue_spill_new (mq, sq)) == NULL)
+    goto keep;
+  spill = sq->spill_write;
+
+  if (!gst_buffer_map (buffer, &map, GST_MAP_READ))
+    goto keep;
+  /* flush right away, a full disk must not only show up when the buffer is
+   * read back and the data is gone */
+  if (fwrite (map.data, map.size, 1, spill->file) != 1
+      || fflush (spill->file) != 0) {
+    gst_buffer_unmap (buffer, &map);
+    goto write_failed;
+  }
+  gst_buffer_unmap (buffer, &map);
+
+  /* keep everything but the memory */
+  shell = gst_buffer_new ();
+  gst_buffer_copy_into (shell, buffer, GST_BUFFER_COPY_METADATA, 0, -1);
+  gst_buffer_unref (buffer);
+
+  item->object = GST_MINI_OBJECT_CAST (shell);
+  item->spill = gst_multi_queue_spill_ref (spill);
+  item->spill_offset = spill->size;
+  spill->size += item->size;
+
+  g_mutex_unlock (&sq->spill_lock);
+  return;
+
+  /* ERRORS */
+write_failed:
+  {
+    GST_WARNING_ID (sq->debug_id, "could not write to %s, keeping the buffer "
+        "in memory: %s", spill->location, g_strerror (errno));
+    /* don't append after a partial write, the next buffer uses a new file */
+    gst_multi_queue_spill_unref (spill);
+    sq->spill_write = NULL;
+    /* fallthrough */
+  }
+keep:
+  {
+    sq->resident_bytes += item->size;
+    g_mutex_unlock (&sq->spill_lock);
+  }
+}
+
+/* Removes a buffer kept in memory from the spill-threshold accounting */
+static void
+gst_single_queue_forget_item (GstSingleQueue * sq, GstMultiQueueItem * item)
+{
+  if (item->spill || item->is_query || !GST_IS_BUFFER (item->object))
+    return;
+
+  g_mutex_lock (&sq->spill_lock);
+  /* might have been reset by a flush in the meantime */
+  sq->resident_bytes -= MIN (sq->resident_bytes, item->size);
+  g_mutex_unlock (&sq->spill_lock);
+}
+
+/* Gives the buffer in @item its memory back if it was spilled. The data is
+ * only read from the file when the buffer is mapped. Returns %FALSE and posts
+ * an error if the spill file could not be read back. */
+static gboolean
+gst_single_queue_unspill_item (GstMultiQueue * mq, GstSingleQueue * sq,
+    GstMultiQueueItem * item)
+{
+  GstMultiQueueSpill *spill = item->spill;
+  GstBuffer *buffer;
+  GBytes *bytes = NULL;
+
+  if (spill == NULL) {
+    gst_single_queue_forget_item (sq, item);
+    return TRUE;
+  }
+
+  g_mutex_lock (&sq->spill_lock);
+  if (spill->mapped || gst_multi_queue_spill_seal (sq, spill))
+    bytes = g_bytes_new_from_bytes (spill->mapped, item->spill_offset,
+        item->size);
+  g_mutex_unlock (&sq->spill_lock);
+
+  if (bytes == NULL)
+    goto read_failed;
+
+  buffer = GST_BUFFER_CAST (item->object);
+  gst_buffer_append_memory (buffer,
+      gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY,
+          (gpointer) g_bytes_get_data (bytes, NULL), item->size, 0,
+          item->size, bytes, (GDestroyNotify) g_bytes_unref));
+
+  item->spill = NULL;
+  gst_multi_queue_spill_unref (spill);
+
+  return TRUE;
+
+  /* ERRORS */
+read_failed:
+  {
+    GST_ELEMENT_ERROR (mq, RESOURCE, READ, (NULL),
+        ("Could not read back the buffers spilled to %s", spill->location));
+    return FALSE;
+  }
+}
+
 static GstMiniObject *
 gst_multi_queue_item_steal_object (GstMultiQueueItem * item)
 {
@@ -2116,6 +2504,8 @@ gst_multi_queue_item_destroy (GstMultiQueueItem * item)
 {
   if (!item->is_query && item->object)
     gst_mini_object_unref (item->object);
+  if (item->spill)
+    gst_multi_queue_spill_unref (item->spill);
   g_free (item);
 }
 
@@ -2130,6 +2520,7 @@ gst_multi_queue_buffer_item_new (GstMiniObject * object, guint32 curid)
   item->destroy = (GDestroyNotify) gst_multi_queue_item_destroy;
   item->posid = curid;
   item->is_query = GST_IS_QUERY (object);
+  item->spill = NULL;
 
   item->size = gst_buffer_get_size (GST_BUFFER_CAST (object));
   item->duration = GST_BUFFER_DURATION (object);
@@ -2149,6 +2540,7 @@ gst_multi_queue_mo_item_new (GstMiniObject * object, guint32 curid)
   item->destroy = (GDestroyNotify) gst_multi_queue_item_destroy;
   item->posid = curid;
   item->is_query = GST_IS_QUERY (object);
+  item->spill = NULL;
 
   item->size = 0;
   item->duration = 0;
@@ -2200,6 +2592,14 @@ next:
 
   is_query = item->is_query;
 
+  if (!gst_single_queue_unspill_item (mq, sq, item)) {
+    gst_multi_queue_item_destroy (item);
+    GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+    sq->srcresult = GST_FLOW_ERROR;
+    GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+    goto out_flushing;
+  }
+
   /* steal the object and destroy the item */
   object = gst_multi_queue_item_steal_object (item);
   gst_multi_queue_item_destroy (item);
@@ -2516,6 +2916,7 @@ gst_multi_queue_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
       GST_TIME_ARGS (GST_BUFFER_DTS (buffer)), GST_TIME_ARGS (duration));
 
   item = gst_multi_queue_buffer_item_new (GST_MINI_OBJECT_CAST (buffer), curid);
+  gst_single_queue_spill_item (mq, sq, item);
 
   /* Update interleave before pushing data into queue */
   if (mq->use_interleave) {
@@ -2556,8 +2957,10 @@ flushing:
   {
     GST_LOG_ID (sq->debug_id, "exit because task paused, reason: %s",
         gst_flow_get_name (sq->srcresult));
-    if (item)
+    if (item) {
+      gst_single_queue_forget_item (sq, item);
       gst_multi_queue_item_destroy (item);
+    }
     goto done;
   }
 was_eos:
@@ -3449,6 +3852,14 @@ gst_single_queue_flush_queue (GstSingleQueue * sq, gboolean full)
   if (was_flushing)
     gst_data_queue_set_flushing (sq->queue, TRUE);
 
+  g_mutex_lock (&sq->spill_lock);
+  sq->resident_bytes = 0;
+  if (sq->spill_write) {
+    gst_multi_queue_spill_unref (sq->spill_write);
+    sq->spill_write = NULL;
+  }
+  g_mutex_unlock (&sq->spill_lock);
+
   if (mq) {
     GST_MULTI_QUEUE_MUTEX_LOCK (mq);
     update_buffering (mq, sq);
@@ -3465,6 +3876,9 @@ gst_single_queue_unref (GstSingleQueue * sq)
     /* DRAIN QUEUE */
     gst_data_queue_flush (sq->queue);
     g_object_unref (sq->queue);
+    if (sq->spill_write)
+      gst_multi_queue_spill_unref (sq->spill_write);
+    g_mutex_clear (&sq->spill_lock);
     g_cond_clear (&sq->turn);
     g_cond_clear (&sq->query_handled);
     g_weak_ref_clear (&sq->sinkpad);
@@ -3541,6 +3955,8 @@ gst_single_queue_new (GstMultiQueue * mqueue, guint id)
   sq->extra_size.bytes = mqueue->extra_size.bytes;
   sq->extra_size.time = mqueue->extra_size.time;
 
+  sq->spill_threshold = mqueue->spill_threshold;
+
   GST_DEBUG_OBJECT (mqueue, "Creating GstSingleQueue id:%d", sq->id);
 
   g_weak_ref_init (&sq->mqueue, mqueue);
@@ -3562,6 +3978,7 @@ gst_single_queue_new (GstMultiQueue * mqueue, guint id)
   sq->next_time = GST_CLOCK_STIME_NONE;
   sq->last_time = GST_CLOCK_STIME_NONE;
   g_cond_init (&sq->turn);
+  g_mutex_init (&sq->spill_lock);
   g_cond_init (&sq->query_handled);
 
   sq->sinktime = GST_CLOCK_STIME_NONE;
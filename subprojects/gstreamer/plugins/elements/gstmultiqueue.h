@@ -90,6 +90,9 @@ struct _GstMultiQueue {
   gboolean interleave_incomplete; /* TRUE if not all streams were active */
 
   GstClockTime unlinked_cache_time;
+
+  gchar *temp_template;
+  guint64 spill_threshold;
 };
 
 struct _GstMultiQueueClass {
@@ -50,6 +50,22 @@
  * The temp-location property will be used to notify the application of the
  * allocated filename.
  *
+ * With #GstQueue2:ring-buffer-max-size set, the most recent data is kept in a
+ * ring buffer, in memory or in the temp file. When downstream pulls data, any
+ * byte range that is still in the ring buffer can be read again without
+ * seeking upstream, also while upstream keeps writing at another offset. This
+ * allows timeshifting and readers that jump between offsets, for example to
+ * read an index, within the limits of the ring buffer.
+ *
+ * When the ring buffer or a temp file is used, additional source pads can be
+ * requested from the "src_%u" template. Each of them is a pull mode only reader
+ * with its own read position on the same buffered data. These readers never
+ * make upstream seek and never hold back upstream, which is driven by the
+ * "src" pad alone: a reader waits for data that upstream is about to write.
+ * When it asks for data that was already overwritten in the ring buffer or
+ * that is not in any buffered range, only that reader gets a
+ * %GST_FLOW_ERROR and a warning is posted, the other pads keep streaming.
+ *
  * If the #GstQueue2:use-buffering property is set to TRUE, and any writable
  * property is modified, #GstQueue2 will attempt to post a buffering message
  * if the changes to the properties also cause the buffering percentage to be
@@ -95,6 +111,11 @@ static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_ALWAYS,
     GST_STATIC_CAPS_ANY);
 
+static GstStaticPadTemplate readertemplate = GST_STATIC_PAD_TEMPLATE ("src_%u",
+    GST_PAD_SRC,
+    GST_PAD_REQUEST,
+    GST_STATIC_CAPS_ANY);
+
 GST_DEBUG_CATEGORY_STATIC (queue_debug);
 #define GST_CAT_DEFAULT (queue_debug)
 GST_DEBUG_CATEGORY_STATIC (queue_dataflow);
@@ -259,6 +280,10 @@ static GParamSpec *obj_props[PROP_LAST] = { NULL, };
     STATUS (q, q->sinkpad, "signal ADD");                               \
     g_cond_signal (&q->item_add);                                        \
   }                                                                     \
+  if (q->waiting_readers) {                                             \
+    STATUS (q, q->sinkpad, "signal ADD to readers");                    \
+    g_cond_broadcast (&q->reader_add);                                   \
+  }                                                                     \
 } G_STMT_END
 
 #define SET_PERCENT(q, perc) G_STMT_START {                              \
@@ -307,6 +332,20 @@ static gboolean gst_queue2_handle_query (GstElement * element,
 static GstFlowReturn gst_queue2_get_range (GstPad * pad, GstObject * parent,
     guint64 offset, guint length, GstBuffer ** buffer);
 
+static GstFlowReturn gst_queue2_reader_get_range (GstPad * pad,
+    GstObject * parent, guint64 offset, guint length, GstBuffer ** buffer);
+static gboolean gst_queue2_reader_activate_mode (GstPad * pad,
+    GstObject * parent, GstPadMode mode, gboolean active);
+static gboolean gst_queue2_handle_reader_query (GstPad * pad,
+    GstObject * parent, GstQuery * query);
+static gboolean gst_queue2_handle_reader_event (GstPad * pad,
+    GstObject * parent, GstEvent * event);
+static GstPad *gst_queue2_request_new_pad (GstElement * element,
+    GstPadTemplate * templ, const gchar * name, const GstCaps * caps);
+static void gst_queue2_release_pad (GstElement * element, GstPad * pad);
+static GstIterator *gst_queue2_iterate_internal_links (GstPad * pad,
+    GstObject * parent);
+
 static gboolean gst_queue2_src_activate_mode (GstPad * pad, GstObject * parent,
     GstPadMode mode, gboolean active);
 static gboolean gst_queue2_sink_activate_mode (GstPad * pad, GstObject * parent,
@@ -477,6 +516,8 @@ gst_queue2_class_init (GstQueue2Class * klass)
 
   gst_element_class_add_static_pad_template (gstelement_class, &srctemplate);
   gst_element_class_add_static_pad_template (gstelement_class, &sinktemplate);
+  gst_element_class_add_static_pad_template (gstelement_class,
+      &readertemplate);
 
   gst_element_class_set_static_metadata (gstelement_class, "Queue 2",
       "Generic",
@@ -486,6 +527,9 @@ gst_queue2_class_init (GstQueue2Class * klass)
 
   gstelement_class->change_state = GST_DEBUG_FUNCPTR (gst_queue2_change_state);
   gstelement_class->query = GST_DEBUG_FUNCPTR (gst_queue2_handle_query);
+  gstelement_class->request_new_pad =
+      GST_DEBUG_FUNCPTR (gst_queue2_request_new_pad);
+  gstelement_class->release_pad = GST_DEBUG_FUNCPTR (gst_queue2_release_pad);
 }
 
 static void
@@ -503,6 +547,8 @@ gst_queue2_init (GstQueue2 * queue)
       GST_DEBUG_FUNCPTR (gst_queue2_handle_sink_event));
   gst_pad_set_query_function (queue->sinkpad,
       GST_DEBUG_FUNCPTR (gst_queue2_handle_sink_query));
+  gst_pad_set_iterate_internal_links_function (queue->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_queue2_iterate_internal_links));
   GST_PAD_SET_PROXY_CAPS (queue->sinkpad);
   gst_element_add_pad (GST_ELEMENT (queue), queue->sinkpad);
 
@@ -516,6 +562,8 @@ gst_queue2_init (GstQueue2 * queue)
       GST_DEBUG_FUNCPTR (gst_queue2_handle_src_event));
   gst_pad_set_query_function (queue->srcpad,
       GST_DEBUG_FUNCPTR (gst_queue2_handle_src_query));
+  gst_pad_set_iterate_internal_links_function (queue->srcpad,
+      GST_DEBUG_FUNCPTR (gst_queue2_iterate_internal_links));
   GST_PAD_SET_PROXY_CAPS (queue->srcpad);
   gst_element_add_pad (GST_ELEMENT (queue), queue->srcpad);
 
@@ -550,6 +598,8 @@ gst_queue2_init (GstQueue2 * queue)
   g_cond_init (&queue->item_add);
   queue->waiting_del = FALSE;
   g_cond_init (&queue->item_del);
+  queue->waiting_readers = 0;
+  g_cond_init (&queue->reader_add);
   queue->queue = gst_vec_deque_new_for_struct (sizeof (GstQueue2Item), 32);
 
   g_cond_init (&queue->query_handled);
@@ -567,6 +617,9 @@ gst_queue2_init (GstQueue2 * queue)
   queue->ring_buffer = NULL;
   queue->ring_buffer_max_size = DEFAULT_RING_BUFFER_MAX_SIZE;
 
+  queue->range_index = g_ptr_array_new ();
+  queue->range_index_valid = FALSE;
+
   queue->use_bitrate_query = DEFAULT_USE_BITRATE_QUERY;
 
   GST_DEBUG_OBJECT (queue,
@@ -593,9 +646,12 @@ gst_queue2_finalize (GObject * object)
   g_mutex_clear (&queue->buffering_post_lock);
   g_cond_clear (&queue->item_add);
   g_cond_clear (&queue->item_del);
+  g_cond_clear (&queue->reader_add);
+  g_list_free_full (queue->readers, g_free);
   g_cond_clear (&queue->query_handled);
   g_timer_destroy (queue->in_timer);
   g_timer_destroy (queue->out_timer);
+  g_ptr_array_unref (queue->range_index);
 
   /* temp_file path cleanup  */
   g_free (queue->temp_template);
@@ -635,6 +691,23 @@ clean_ranges (GstQueue2 * queue)
   }
   queue->ranges = NULL;
   queue->current = NULL;
+  queue->range_index_valid = FALSE;
+}
+
+/* the ranges are kept sorted by offset and don't overlap, except for the
+ * current range which can grow into the next ones with a ring buffer */
+static void
+update_range_index (GstQueue2 * queue)
+{
+  GstQueue2Range *walk;
+
+  if (queue->range_index_valid)
+    return;
+
+  g_ptr_array_set_size (queue->range_index, 0);
+  for (walk = queue->ranges; walk; walk = walk->next)
+    g_ptr_array_add (queue->range_index, walk);
+  queue->range_index_valid = TRUE;
 }
 
 /* find a range that contains @offset or NULL when nothing does */
@@ -643,13 +716,32 @@ find_range (GstQueue2 * queue, guint64 offset)
 {
   GstQueue2Range *range = NULL;
   GstQueue2Range *walk;
+  guint lo, hi;
 
   /* first do a quick check for the current range */
-  for (walk = queue->ranges; walk; walk = walk->next) {
-    if (offset >= walk->offset && offset <= walk->writing_pos) {
+  walk = queue->current;
+  if (walk && offset >= walk->offset && offset <= walk->writing_pos) {
+    range = walk;
+  } else {
+    /* find the last range starting at or before @offset */
+    update_range_index (queue);
+
+    lo = 0;
+    hi = queue->range_index->len;
+    while (lo < hi) {
+      guint mid = lo + (hi - lo) / 2;
+
+      walk = g_ptr_array_index (queue->range_index, mid);
+      if (walk->offset <= offset)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    if (lo > 0) {
+      walk = g_ptr_array_index (queue->range_index, lo - 1);
       /* we can reuse an existing range */
-      range = walk;
-      break;
+      if (offset <= walk->writing_pos)
+        range = walk;
     }
   }
   if (range) {
@@ -726,6 +818,7 @@ add_range (GstQueue2 * queue, guint64 offset, gboolean update_existing)
       prev->next = range;
     else
       queue->ranges = range;
+    queue->range_index_valid = FALSE;
   }
   debug_ranges (queue);
 
@@ -1576,6 +1669,7 @@ gst_queue2_create_read (GstQueue2 * queue, guint64 offset, guint length,
   guint64 rb_size;
   guint64 max_size;
   guint64 rpos;
+  GstQueue2Range *range;
   GstFlowReturn ret = GST_FLOW_OK;
 
   /* allocate the output buffer of the requested size */
@@ -1597,8 +1691,19 @@ gst_queue2_create_read (GstQueue2 * queue, guint64 offset, guint length,
 
   remaining = length;
   while (remaining > 0) {
-    /* configure how much/whether to read */
-    if (!gst_queue2_have_data (queue, rpos, remaining)) {
+    /* with a ring buffer, data that is still available in another range is
+     * read from there without making it the range upstream writes to. Readers
+     * at different offsets then don't make upstream seek back and forth */
+    range = NULL;
+    if (QUEUE_IS_USING_RING_BUFFER (queue))
+      range = find_range (queue, rpos);
+    if (range && range != queue->current
+        && rpos + remaining <= range->writing_pos) {
+      GST_DEBUG_OBJECT (queue, "reading from range %" G_GUINT64_FORMAT "-%"
+          G_GUINT64_FORMAT " without switching", range->offset,
+          range->writing_pos);
+      read_length = remaining;
+    } else if (!gst_queue2_have_data (queue, rpos, remaining)) {
       read_length = 0;
 
       if (QUEUE_IS_USING_RING_BUFFER (queue)) {
@@ -1636,6 +1741,8 @@ gst_queue2_create_read (GstQueue2 * queue, guint64 offset, guint length,
         }
       }
 
+      range = queue->current;
+
       if (read_length == 0) {
         if (QUEUE_IS_USING_RING_BUFFER (queue)) {
           GST_DEBUG_OBJECT (queue,
@@ -1655,16 +1762,15 @@ gst_queue2_create_read (GstQueue2 * queue, guint64 offset, guint length,
     } else {
       /* we have the requested data so read it */
       read_length = remaining;
+      range = queue->current;
     }
 
     /* set range reading_pos to actual reading position for this read */
-    queue->current->reading_pos = rpos;
+    range->reading_pos = rpos;
 
     /* configure how much and from where to read */
     if (QUEUE_IS_USING_RING_BUFFER (queue)) {
-      file_offset =
-          (queue->current->rb_offset + (rpos -
-              queue->current->offset)) % rb_size;
+      file_offset = (range->rb_offset + (rpos - range->offset)) % rb_size;
       if (file_offset + read_length > rb_size) {
         block_length = rb_size - file_offset;
       } else {
@@ -1694,8 +1800,10 @@ gst_queue2_create_read (GstQueue2 * queue, guint64 offset, guint length,
       block_length = read_length;
       remaining -= read_return;
 
-      rpos = (queue->current->reading_pos += read_return);
-      update_cur_pos (queue, queue->current, queue->current->reading_pos);
+      rpos = (range->reading_pos += read_return);
+      /* only the current range limits how much upstream can write */
+      if (range == queue->current)
+        update_cur_pos (queue, range, range->reading_pos);
     }
     GST_QUEUE2_SIGNAL_DEL (queue);
     GST_DEBUG_OBJECT (queue, "%u bytes left to read", remaining);
@@ -2128,6 +2236,7 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
             queue->ranges = range;
           g_free (range_to_destroy);
           range_to_destroy = NULL;
+          queue->range_index_valid = FALSE;
         }
       }
     } else {
@@ -2177,6 +2286,7 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
             do_seek = TRUE;
           }
           g_free (next);
+          queue->range_index_valid = FALSE;
         }
         goto update_and_signal;
       }
@@ -3639,6 +3749,362 @@ out_unexpected:
   }
 }
 
+/* a pull mode reader on a "src_%u" request pad */
+typedef struct
+{
+  GstPad *pad;
+  guint64 reading_pos;
+  gboolean flushing;
+} GstQueue2Reader;
+
+/* readers read whatever is buffered at the offset they ask for without
+ * touching the ranges, so they never seek upstream and never block upstream
+ * from overwriting data in the ring buffer */
+static GstFlowReturn
+gst_queue2_reader_get_range (GstPad * pad, GstObject * parent, guint64 offset,
+    guint length, GstBuffer ** buffer)
+{
+  GstQueue2 *queue;
+  GstQueue2Reader *reader;
+  GstQueue2Range *range, *current;
+  GstBuffer *buf;
+  GstMapInfo info;
+  guint8 *data;
+  guint64 start, rb_size, file_offset;
+  guint block_length, read_length;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  queue = GST_QUEUE2_CAST (parent);
+  reader = gst_pad_get_element_private (pad);
+
+  length = (length == -1) ? DEFAULT_BUFFER_SIZE : length;
+  GST_QUEUE2_MUTEX_LOCK (queue);
+  offset = (offset == -1) ? reader->reading_pos : offset;
+
+  GST_DEBUG_OBJECT (pad,
+      "Getting range: offset %" G_GUINT64_FORMAT ", length %u", offset, length);
+
+  if (G_UNLIKELY (offset + length > queue->upstream_size)) {
+    gst_queue2_update_upstream_size (queue);
+    if (queue->upstream_size > 0) {
+      if (offset >= queue->upstream_size)
+        goto out_eos;
+      if (offset + length > queue->upstream_size) {
+        length = queue->upstream_size - offset;
+        GST_DEBUG_OBJECT (pad, "adjusting length downto %d", length);
+      }
+    }
+  }
+
+  rb_size = queue->ring_buffer_max_size;
+  while (TRUE) {
+    if (reader->flushing || queue->current == NULL)
+      goto out_flushing;
+
+    current = queue->current;
+    if ((range = find_range (queue, offset))) {
+      /* the ring buffer only holds the last rb_size bytes of a range */
+      start = range->offset;
+      if (QUEUE_IS_USING_RING_BUFFER (queue) && range->writing_pos > rb_size)
+        start = MAX (start, range->writing_pos - rb_size);
+
+      if (offset < start)
+        goto out_overwritten;
+
+      if (offset + length <= range->writing_pos)
+        break;
+    }
+
+    /* upstream is writing towards the requested data, it only gets there when
+     * the "src" pad keeps reading, wait for it */
+    if (offset >= current->offset
+        && offset <= current->writing_pos + QUEUE_MAX_BYTES (queue)) {
+      if (queue->is_eos) {
+        if (range != current || offset >= current->writing_pos)
+          goto out_eos;
+        length = current->writing_pos - offset;
+        GST_DEBUG_OBJECT (pad, "EOS hit, reading the %u bytes we have", length);
+        break;
+      }
+
+      GST_DEBUG_OBJECT (pad, "waiting for data at %" G_GUINT64_FORMAT
+          ", writing at %" G_GUINT64_FORMAT, offset, current->writing_pos);
+      queue->waiting_readers++;
+      g_cond_wait (&queue->reader_add, &queue->qlock);
+      queue->waiting_readers--;
+      continue;
+    }
+    goto out_unavailable;
+  }
+
+  if (*buffer == NULL)
+    buf = gst_buffer_new_allocate (NULL, length, NULL);
+  else
+    buf = *buffer;
+
+  if (!gst_buffer_map (buf, &info, GST_MAP_WRITE))
+    goto buffer_write_fail;
+  data = info.data;
+
+  if (QUEUE_IS_USING_RING_BUFFER (queue))
+    file_offset = (range->rb_offset + (offset - range->offset)) % rb_size;
+  else
+    file_offset = offset;
+
+  read_length = length;
+  while (read_length > 0) {
+    gint64 read_return;
+
+    if (QUEUE_IS_USING_RING_BUFFER (queue)
+        && file_offset + read_length > rb_size)
+      block_length = rb_size - file_offset;
+    else
+      block_length = read_length;
+
+    ret = gst_queue2_read_data_at_offset (queue, file_offset, block_length,
+        data, &read_return);
+    if (ret != GST_FLOW_OK)
+      break;
+
+    file_offset += read_return;
+    if (QUEUE_IS_USING_RING_BUFFER (queue))
+      file_offset %= rb_size;
+
+    data += read_return;
+    read_length -= read_return;
+  }
+  gst_buffer_unmap (buf, &info);
+
+  if (ret != GST_FLOW_OK)
+    goto read_error;
+
+  gst_buffer_resize (buf, 0, length);
+  GST_BUFFER_OFFSET (buf) = offset;
+  GST_BUFFER_OFFSET_END (buf) = offset + length;
+  reader->reading_pos = offset + length;
+  GST_QUEUE2_MUTEX_UNLOCK (queue);
+
+  *buffer = buf;
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+out_flushing:
+  {
+    GST_DEBUG_OBJECT (pad, "we are flushing");
+    GST_QUEUE2_MUTEX_UNLOCK (queue);
+    return GST_FLOW_FLUSHING;
+  }
+out_eos:
+  {
+    GST_DEBUG_OBJECT (pad, "read beyond end of stream");
+    GST_QUEUE2_MUTEX_UNLOCK (queue);
+    return GST_FLOW_EOS;
+  }
+out_overwritten:
+  {
+    GST_QUEUE2_MUTEX_UNLOCK (queue);
+    GST_ELEMENT_WARNING (queue, RESOURCE, READ, (NULL),
+        ("%s: data at offset %" G_GUINT64_FORMAT " was overwritten in the "
+            "ring buffer", GST_PAD_NAME (pad), offset));
+    return GST_FLOW_ERROR;
+  }
+out_unavailable:
+  {
+    GST_QUEUE2_MUTEX_UNLOCK (queue);
+    GST_ELEMENT_WARNING (queue, RESOURCE, READ, (NULL),
+        ("%s: data at offset %" G_GUINT64_FORMAT " is not buffered",
+            GST_PAD_NAME (pad), offset));
+    return GST_FLOW_ERROR;
+  }
+buffer_write_fail:
+  {
+    GST_QUEUE2_MUTEX_UNLOCK (queue);
+    GST_ELEMENT_ERROR (queue, RESOURCE, WRITE, (NULL),
+        ("Can't write to buffer"));
+    if (*buffer == NULL)
+      gst_buffer_unref (buf);
+    return GST_FLOW_ERROR;
+  }
+read_error:
+  {
+    GST_DEBUG_OBJECT (pad, "we have a read error");
+    GST_QUEUE2_MUTEX_UNLOCK (queue);
+    if (*buffer == NULL)
+      gst_buffer_unref (buf);
+    return ret;
+  }
+}
+
+/* readers only produce data in pull mode, push mode activation is accepted
+ * so that the pad can be activated with the element but it never pushes */
+static gboolean
+gst_queue2_reader_activate_mode (GstPad * pad, GstObject * parent,
+    GstPadMode mode, gboolean active)
+{
+  GstQueue2 *queue;
+  GstQueue2Reader *reader;
+  gboolean result = TRUE;
+
+  queue = GST_QUEUE2 (parent);
+  reader = gst_pad_get_element_private (pad);
+
+  GST_QUEUE2_MUTEX_LOCK (queue);
+  switch (mode) {
+    case GST_PAD_MODE_PULL:
+      if (active && QUEUE_IS_USING_QUEUE (queue)) {
+        GST_DEBUG_OBJECT (pad, "no ring buffer or temp file, cannot activate "
+            "pull mode");
+        result = FALSE;
+        break;
+      }
+      GST_DEBUG_OBJECT (pad, "%s pull mode",
+          active ? "activating" : "deactivating");
+      reader->flushing = !active;
+      reader->reading_pos = 0;
+      if (!active && queue->waiting_readers)
+        g_cond_broadcast (&queue->reader_add);
+      break;
+    case GST_PAD_MODE_PUSH:
+      break;
+    default:
+      GST_LOG_OBJECT (pad, "unknown activation mode %d", mode);
+      result = FALSE;
+      break;
+  }
+  GST_QUEUE2_MUTEX_UNLOCK (queue);
+
+  return result;
+}
+
+static gboolean
+gst_queue2_handle_reader_query (GstPad * pad, GstObject * parent,
+    GstQuery * query)
+{
+  GstQueue2 *queue;
+
+  queue = GST_QUEUE2 (parent);
+
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_SCHEDULING:
+    {
+      if (QUEUE_IS_USING_QUEUE (queue))
+        return FALSE;
+
+      gst_query_set_scheduling (query, GST_SCHEDULING_FLAG_SEEKABLE, 1, -1, 0);
+      gst_query_add_scheduling_mode (query, GST_PAD_MODE_PULL);
+      return TRUE;
+    }
+    default:
+      /* everything else is answered by upstream, like for the "src" pad */
+      return gst_pad_peer_query (queue->sinkpad, query);
+  }
+}
+
+static gboolean
+gst_queue2_handle_reader_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  /* upstream is controlled by the "src" pad only */
+  GST_DEBUG_OBJECT (pad, "dropping %" GST_PTR_FORMAT, event);
+  gst_event_unref (event);
+
+  return FALSE;
+}
+
+static GstPad *
+gst_queue2_request_new_pad (GstElement * element, GstPadTemplate * templ,
+    const gchar * name, const GstCaps * caps)
+{
+  GstQueue2 *queue;
+  GstQueue2Reader *reader;
+  GstPad *pad;
+  gchar *padname;
+
+  queue = GST_QUEUE2 (element);
+
+  GST_OBJECT_LOCK (queue);
+  if (name)
+    padname = g_strdup (name);
+  else
+    padname = g_strdup_printf ("src_%u", queue->reader_count++);
+  GST_OBJECT_UNLOCK (queue);
+
+  pad = gst_pad_new_from_template (templ, padname);
+  g_free (padname);
+
+  gst_pad_set_activatemode_function (pad,
+      GST_DEBUG_FUNCPTR (gst_queue2_reader_activate_mode));
+  gst_pad_set_getrange_function (pad,
+      GST_DEBUG_FUNCPTR (gst_queue2_reader_get_range));
+  gst_pad_set_query_function (pad,
+      GST_DEBUG_FUNCPTR (gst_queue2_handle_reader_query));
+  gst_pad_set_event_function (pad,
+      GST_DEBUG_FUNCPTR (gst_queue2_handle_reader_event));
+
+  reader = g_new0 (GstQueue2Reader, 1);
+  reader->pad = pad;
+  reader->flushing = TRUE;
+  gst_pad_set_element_private (pad, reader);
+
+  GST_QUEUE2_MUTEX_LOCK (queue);
+  queue->readers = g_list_prepend (queue->readers, reader);
+  GST_QUEUE2_MUTEX_UNLOCK (queue);
+
+  if (!gst_element_add_pad (element, pad)) {
+    GST_QUEUE2_MUTEX_LOCK (queue);
+    queue->readers = g_list_remove (queue->readers, reader);
+    GST_QUEUE2_MUTEX_UNLOCK (queue);
+    g_free (reader);
+    return NULL;
+  }
+
+  return pad;
+}
+
+static void
+gst_queue2_release_pad (GstElement * element, GstPad * pad)
+{
+  GstQueue2 *queue;
+  GstQueue2Reader *reader;
+
+  queue = GST_QUEUE2 (element);
+
+  /* unblocks and waits for a reader in getrange */
+  gst_pad_set_active (pad, FALSE);
+
+  GST_QUEUE2_MUTEX_LOCK (queue);
+  reader = gst_pad_get_element_private (pad);
+  queue->readers = g_list_remove (queue->readers, reader);
+  gst_pad_set_element_private (pad, NULL);
+  GST_QUEUE2_MUTEX_UNLOCK (queue);
+  g_free (reader);
+
+  gst_element_remove_pad (element, pad);
+}
+
+/* only link the always pads, the readers are not part of the data flow from
+ * sink to src */
+static GstIterator *
+gst_queue2_iterate_internal_links (GstPad * pad, GstObject * parent)
+{
+  GstQueue2 *queue;
+  GstIterator *it;
+  GValue val = G_VALUE_INIT;
+
+  queue = GST_QUEUE2 (parent);
+
+  g_value_init (&val, GST_TYPE_PAD);
+  if (pad == queue->sinkpad)
+    g_value_set_object (&val, queue->srcpad);
+  else
+    g_value_set_object (&val, queue->sinkpad);
+  it = gst_iterator_new_single (GST_TYPE_PAD, &val);
+  g_value_unset (&val);
+
+  return it;
+}
+
 /* sink currently only operates in push mode */
 static gboolean
 gst_queue2_sink_activate_mode (GstPad * pad, GstObject * parent,
@@ -145,6 +145,12 @@ struct _GstQueue2
   gboolean waiting_del;
   GCond item_del;              /* signals space now available for writing */
 
+  /* request source pads reading from the ring buffer in pull mode */
+  GList *readers;
+  guint reader_count;
+  guint waiting_readers;
+  GCond reader_add;            /* signals data now available for readers */
+
   /* temp location stuff */
   gchar *temp_template;
   gboolean temp_location_set;
@@ -154,6 +160,10 @@ struct _GstQueue2
   /* list of downloaded areas and the current area */
   GstQueue2Range *ranges;
   GstQueue2Range *current;
+  /* the ranges sorted by offset, for binary searches. Rebuilt when ranges
+   * were added or removed */
+  GPtrArray *range_index;
+  gboolean range_index_valid;
   /* we need this to send the first new segment event of the stream
    * because we can't save it on the file */
   gboolean segment_event_received;
@@ -0,0 +1,137 @@
+/* GStreamer
+ *
+ * gstcapscache.c: tracer reporting the efficiency of the caps cache
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+/**
+ * SECTION:tracer-capscache
+ * @short_description: log caps cache hits and misses
+ *
+ * A tracing module that counts the hits and misses of the caps cache enabled
+ * with `GST_CAPS_CACHE_SIZE`, per cached operation. The totals are logged when
+ * the tracer is destroyed, which usually happens in gst_deinit().
+ *
+ * ```
+ * $ GST_CAPS_CACHE_SIZE=1024 GST_TRACERS=capscache GST_DEBUG=GST_TRACER:7 \
+ *     gst-launch-1.0 uridecodebin3 uri=file:///path/to/file ! fakesink
+ * ...
+ * caps-cache, operation=(string)intersect-zig-zag, hits=(guint64)3512, misses=(guint64)417;
+ * caps-cache, operation=(string)is-subset, hits=(guint64)208, misses=(guint64)96;
+ * ```
+ *
+ * Since: 1.26
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "gstcapscache.h"
+
+G_DEFINE_TYPE (GstCapsCacheTracer, gst_caps_cache_tracer, GST_TYPE_TRACER);
+
+static GstTracerRecord *tr_caps_cache;
+
+typedef struct
+{
+  guint64 hits;
+  guint64 misses;
+} CapsCacheStats;
+
+static void
+do_caps_cache_lookup (GstCapsCacheTracer * self, GstClockTime ts,
+    const GstCaps * caps1, const GstCaps * caps2, const gchar * operation,
+    gboolean hit)
+{
+  CapsCacheStats *stats;
+
+  g_mutex_lock (&self->lock);
+  /* operation names are static strings */
+  stats = g_hash_table_lookup (self->stats, operation);
+  if (!stats) {
+    stats = g_new0 (CapsCacheStats, 1);
+    g_hash_table_insert (self->stats, (gpointer) operation, stats);
+  }
+  if (hit)
+    stats->hits++;
+  else
+    stats->misses++;
+  g_mutex_unlock (&self->lock);
+}
+
+static void
+gst_caps_cache_tracer_finalize (GObject * obj)
+{
+  GstCapsCacheTracer *self = GST_CAPS_CACHE_TRACER (obj);
+  GHashTableIter iter;
+  const gchar *operation;
+  CapsCacheStats *stats;
+
+  g_hash_table_iter_init (&iter, self->stats);
+  while (g_hash_table_iter_next (&iter, (gpointer *) & operation,
+          (gpointer *) & stats)) {
+    gst_tracer_record_log (tr_caps_cache, operation, stats->hits,
+        stats->misses);
+  }
+
+  g_hash_table_unref (self->stats);
+  g_mutex_clear (&self->lock);
+
+  G_OBJECT_CLASS (gst_caps_cache_tracer_parent_class)->finalize (obj);
+}
+
+static void
+gst_caps_cache_tracer_class_init (GstCapsCacheTracerClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->finalize = gst_caps_cache_tracer_finalize;
+
+  /* announce trace formats */
+  /* *INDENT-OFF* */
+  tr_caps_cache = gst_tracer_record_new ("caps-cache.class",
+      "operation", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "description", G_TYPE_STRING, "name of the cached caps operation",
+          NULL),
+      "hits", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "lookups that found a cached result",
+          "flags", GST_TYPE_TRACER_VALUE_FLAGS, GST_TRACER_VALUE_FLAGS_AGGREGATED,
+          NULL),
+      "misses", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "lookups that had to compute the result",
+          "flags", GST_TYPE_TRACER_VALUE_FLAGS, GST_TRACER_VALUE_FLAGS_AGGREGATED,
+          NULL),
+      NULL);
+  /* *INDENT-ON* */
+
+  GST_OBJECT_FLAG_SET (tr_caps_cache, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+}
+
+static void
+gst_caps_cache_tracer_init (GstCapsCacheTracer * self)
+{
+  GstTracer *tracer = GST_TRACER (self);
+
+  g_mutex_init (&self->lock);
+  self->stats = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, g_free);
+
+  gst_tracing_register_hook (tracer, "caps-cache-lookup",
+      G_CALLBACK (do_caps_cache_lookup));
+}
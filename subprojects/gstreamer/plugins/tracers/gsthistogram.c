@@ -0,0 +1,105 @@
+/* GStreamer
+ *
+ * gsthistogram.c: log-linear histograms shared by the tracers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "gsthistogram.h"
+
+#include <string.h>
+
+/* the largest value that is counted in bucket @idx */
+static guint64
+histogram_bucket_max (guint idx)
+{
+  guint shift;
+
+  if (idx < HIST_SUB_BUCKETS)
+    return idx;
+
+  shift = idx / HIST_SUB_BUCKETS - 1;
+  return (((guint64) (HIST_SUB_BUCKETS + idx % HIST_SUB_BUCKETS)) << shift) +
+      ((G_GUINT64_CONSTANT (1) << shift) - 1);
+}
+
+void
+gst_tracer_histogram_init (GstTracerHistogram * hist)
+{
+  memset (hist, 0, sizeof (GstTracerHistogram));
+  hist->min = G_MAXUINT64;
+}
+
+void
+gst_tracer_histogram_merge (GstTracerHistogram * dest,
+    const GstTracerHistogram * src)
+{
+  guint i;
+
+  dest->count += src->count;
+  dest->sum += src->sum;
+  dest->min = MIN (dest->min, src->min);
+  dest->max = MAX (dest->max, src->max);
+  for (i = 0; i < HIST_N_BUCKETS; i++)
+    dest->buckets[i] += src->buckets[i];
+}
+
+guint64
+gst_tracer_histogram_percentile (const GstTracerHistogram * hist,
+    gdouble percentile)
+{
+  guint64 target, seen = 0;
+  guint i;
+
+  if (hist->count == 0)
+    return 0;
+
+  target = (guint64) (percentile / 100.0 * hist->count + 0.5);
+  target = CLAMP (target, 1, hist->count);
+
+  for (i = 0; i < HIST_N_BUCKETS; i++) {
+    seen += hist->buckets[i];
+    if (seen >= target)
+      return CLAMP (histogram_bucket_max (i), hist->min, hist->max);
+  }
+
+  return hist->max;
+}
+
+/* sets @field of @s to a structure with a summary of @hist */
+void
+gst_tracer_histogram_set_field (GstStructure * s, const gchar * field,
+    const GstTracerHistogram * hist)
+{
+  GValue v = G_VALUE_INIT;
+
+  g_value_init (&v, GST_TYPE_STRUCTURE);
+  g_value_take_boxed (&v, gst_structure_new ("histogram",
+          "count", G_TYPE_UINT64, hist->count,
+          "sum", G_TYPE_UINT64, hist->sum,
+          "min", G_TYPE_UINT64, hist->count ? hist->min : 0,
+          "max", G_TYPE_UINT64, hist->max,
+          "p50", G_TYPE_UINT64, gst_tracer_histogram_percentile (hist, 50.0),
+          "p90", G_TYPE_UINT64, gst_tracer_histogram_percentile (hist, 90.0),
+          "p99", G_TYPE_UINT64, gst_tracer_histogram_percentile (hist, 99.0),
+          "p999", G_TYPE_UINT64, gst_tracer_histogram_percentile (hist, 99.9),
+          NULL));
+  gst_structure_take_value (s, field, &v);
+}
@@ -0,0 +1,98 @@
+/* GStreamer
+ *
+ * gsthistogram.h: log-linear histograms shared by the tracers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_TRACER_HISTOGRAM_H__
+#define __GST_TRACER_HISTOGRAM_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/* histograms with HIST_SUB_BUCKETS buckets per power of two, which gives a
+ * relative error of 1 / HIST_SUB_BUCKETS. Values above HIST_MAX_VALUE (about
+ * 3 days in ns) are counted as HIST_MAX_VALUE */
+#define HIST_SUB_BITS 3
+#define HIST_SUB_BUCKETS (1 << HIST_SUB_BITS)
+#define HIST_MAX_BITS 48
+#define HIST_MAX_VALUE ((G_GUINT64_CONSTANT (1) << HIST_MAX_BITS) - 1)
+#define HIST_N_BUCKETS ((HIST_MAX_BITS - HIST_SUB_BITS + 1) * HIST_SUB_BUCKETS)
+
+typedef struct
+{
+  guint64 count;
+  guint64 sum;
+  guint64 min;
+  guint64 max;
+  guint32 buckets[HIST_N_BUCKETS];
+} GstTracerHistogram;
+
+static inline guint
+gst_tracer_histogram_bucket (guint64 value)
+{
+  guint e, shift;
+
+  if (value < HIST_SUB_BUCKETS)
+    return value;
+  if (value > HIST_MAX_VALUE)
+    value = HIST_MAX_VALUE;
+
+  /* index of the most significant bit */
+  if (value >> 32)
+    e = 32 + g_bit_storage ((gulong) (value >> 32)) - 1;
+  else
+    e = g_bit_storage ((gulong) value) - 1;
+
+  shift = e - HIST_SUB_BITS;
+  return (shift + 1) * HIST_SUB_BUCKETS +
+      ((value >> shift) & (HIST_SUB_BUCKETS - 1));
+}
+
+/* this is called from the data path, so it's inline */
+static inline void
+gst_tracer_histogram_add (GstTracerHistogram * hist, guint64 value)
+{
+  hist->count++;
+  hist->sum += value;
+  if (value < hist->min)
+    hist->min = value;
+  if (value > hist->max)
+    hist->max = value;
+  hist->buckets[gst_tracer_histogram_bucket (value)]++;
+}
+
+G_GNUC_INTERNAL
+void           gst_tracer_histogram_init         (GstTracerHistogram * hist);
+
+G_GNUC_INTERNAL
+void           gst_tracer_histogram_merge        (GstTracerHistogram * dest,
+                                                  const GstTracerHistogram * src);
+
+G_GNUC_INTERNAL
+guint64        gst_tracer_histogram_percentile   (const GstTracerHistogram * hist,
+                                                  gdouble percentile);
+
+G_GNUC_INTERNAL
+void           gst_tracer_histogram_set_field    (GstStructure * s,
+                                                  const gchar * field,
+                                                  const GstTracerHistogram * hist);
+
+G_END_DECLS
+
+#endif /* __GST_TRACER_HISTOGRAM_H__ */
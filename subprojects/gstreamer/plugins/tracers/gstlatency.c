@@ -31,6 +31,23 @@
  * ```
  * GST_TRACERS="latency(flags=pipeline+element+reported)" GST_DEBUG=GST_TRACER:7 ./...
  * ```
+ *
+ * With the `sample-interval` parameter set to N, the tracer instead follows
+ * one in N buffers pushed by each source, and doesn't log anything. For each
+ * element the sampled buffers pass, it measures the time they were queued
+ * (e.g. in a queue), the time the element needed to process them and the time
+ * the element was blocked pushing them downstream, and for sinks the time
+ * since the source. These are kept in histograms covering the last one to two
+ * `window`s (in seconds, 10 by default, 0 keeps everything), which can be
+ * retrieved with the #GstLatencyTracer::get-stats action signal, for example
+ * to find the element that adds the most to the 99th percentile of the
+ * latency. Only data flow in push mode is followed. Samples whose buffer
+ * doesn't make it to a sink, e.g. because an element drops it, are given up
+ * after `sample-timeout` milliseconds (5000 by default).
+ *
+ * ```
+ * GST_TRACERS="latency(sample-interval=100,window=30,name=latency)" ./...
+ * ```
  */
 /* TODO(ensonic): if there are two sources feeding into a mixer/muxer and later
  * we fan-out with tee and have two sinks, each sink would get all two events,
@@ -45,6 +62,7 @@
 #endif
 
 #include "gstlatency.h"
+#include "gsthistogram.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_latency_debug);
 #define GST_CAT_DEFAULT gst_latency_debug
@@ -64,11 +82,22 @@ static GQuark latency_probe_element;
 static GQuark latency_probe_element_id;
 static GQuark latency_probe_ts;
 static GQuark drop_sub_latency_quark;
+static GQuark latency_sample_id;
+static GQuark latency_record_quark;
+static GQuark latency_pad_quark;
 
 static GstTracerRecord *tr_latency;
 static GstTracerRecord *tr_element_latency;
 static GstTracerRecord *tr_element_reported_latency;
 
+enum
+{
+  SIGNAL_GET_STATS,
+  LAST_SIGNAL
+};
+
+static guint gst_latency_tracer_signals[LAST_SIGNAL] = { 0 };
+
 /* The private stack for each thread */
 static GPrivate latency_query_stack =
 G_PRIVATE_INIT (latency_query_stack_destroy);
@@ -542,19 +571,507 @@ do_query_post (GstLatencyTracer * tracer, GstClockTime ts, GstPad * pad,
   }
 }
 
+/* sampled mode */
+
+/* samples an element has seen but not passed on yet, older ones are dropped
+ * when there are more, e.g. for elements that don't forward the sample
+ * events */
+#define MAX_PENDING_SAMPLES 16
+
+typedef enum
+{
+  SAMPLE_EVENT_IN,
+  SAMPLE_BUFFER_IN,
+  SAMPLE_BUFFER_OUT,
+} LatencySampleState;
+
+typedef struct
+{
+  LatencySampleState state;
+  /* when the sample was taken at the source */
+  GstClockTime src_ts;
+  /* when the sample event entered the element */
+  GstClockTime created;
+  GstClockTime buffer_in;
+  GstClockTime event_out;
+  GstClockTime buffer_out;
+  /* the thread and pad that moved the buffer last */
+  GThread *thread;
+  GstPad *pad;
+} LatencySample;
+
+typedef struct
+{
+  GstTracerHistogram queueing;
+  GstTracerHistogram processing;
+  GstTracerHistogram downstream;
+  GstTracerHistogram latency;
+} LatencyHistograms;
+
+/* owned by the tracer, all fields are protected by the tracer lock */
+typedef struct
+{
+  gchar *id;
+  gchar *name;
+  gboolean sink;
+  GQueue samples;
+  GstClockTime window_start;
+  LatencyHistograms *current;
+  LatencyHistograms *previous;
+} LatencyElementRecord;
+
+typedef struct
+{
+  gboolean source;
+  guint count;
+} LatencyPadData;
+
+static void
+latency_histograms_init (LatencyHistograms * hists)
+{
+  gst_tracer_histogram_init (&hists->queueing);
+  gst_tracer_histogram_init (&hists->processing);
+  gst_tracer_histogram_init (&hists->downstream);
+  gst_tracer_histogram_init (&hists->latency);
+}
+
+static void
+latency_histograms_merge (LatencyHistograms * dest,
+    const LatencyHistograms * src)
+{
+  gst_tracer_histogram_merge (&dest->queueing, &src->queueing);
+  gst_tracer_histogram_merge (&dest->processing, &src->processing);
+  gst_tracer_histogram_merge (&dest->downstream, &src->downstream);
+  gst_tracer_histogram_merge (&dest->latency, &src->latency);
+}
+
+static void
+latency_element_record_free (LatencyElementRecord * record)
+{
+  g_queue_clear_full (&record->samples, g_free);
+  g_free (record->current);
+  g_free (record->previous);
+  g_free (record->name);
+  g_free (record->id);
+  g_free (record);
+}
+
+/* the tracer lock must be held */
+static LatencyElementRecord *
+get_element_record (GstLatencyTracer * self, GstElement * element)
+{
+  LatencyElementRecord *record;
+
+  record = g_object_get_qdata ((GObject *) element, latency_record_quark);
+  if (!record) {
+    record = g_new0 (LatencyElementRecord, 1);
+    record->id = g_strdup_printf ("%p", element);
+    record->name = gst_element_get_name (element);
+    record->sink = GST_OBJECT_FLAG_IS_SET (element, GST_ELEMENT_FLAG_SINK);
+    g_queue_init (&record->samples);
+    record->current = g_new (LatencyHistograms, 1);
+    record->previous = g_new (LatencyHistograms, 1);
+    latency_histograms_init (record->current);
+    latency_histograms_init (record->previous);
+
+    g_ptr_array_add (self->records, record);
+    g_object_set_qdata ((GObject *) element, latency_record_quark, record);
+  }
+  return record;
+}
+
+/* the tracer lock must be held */
+static void
+rotate_window (GstLatencyTracer * self, LatencyElementRecord * record,
+    GstClockTime ts)
+{
+  LatencyHistograms *tmp;
+
+  self->last_ts = MAX (self->last_ts, ts);
+
+  if (self->window == 0 || ts < record->window_start + self->window)
+    return;
+
+  tmp = record->previous;
+  record->previous = record->current;
+  record->current = tmp;
+  latency_histograms_init (record->current);
+
+  /* nothing was measured during the last window */
+  if (ts >= record->window_start + 2 * self->window)
+    latency_histograms_init (record->previous);
+
+  record->window_start = ts;
+}
+
+/* the tracer lock must be held */
+static LatencySample *
+push_sample (GstLatencyTracer * self, LatencyElementRecord * record,
+    GstClockTime src_ts, GstClockTime ts)
+{
+  LatencySample *sample;
+
+  if (record->samples.length == MAX_PENDING_SAMPLES) {
+    GST_DEBUG ("%s: dropping the oldest sample", record->name);
+    g_free (g_queue_pop_head (&record->samples));
+  } else {
+    g_atomic_int_inc (&self->in_flight);
+  }
+
+  sample = g_new0 (LatencySample, 1);
+  sample->state = SAMPLE_EVENT_IN;
+  sample->src_ts = src_ts;
+  sample->created = ts;
+  sample->buffer_in = GST_CLOCK_TIME_NONE;
+  sample->event_out = GST_CLOCK_TIME_NONE;
+  sample->buffer_out = GST_CLOCK_TIME_NONE;
+  g_queue_push_tail (&record->samples, sample);
+
+  return sample;
+}
+
+/* the tracer lock must be held */
+static void
+finish_sample (GstLatencyTracer * self, LatencyElementRecord * record,
+    GstClockTime ts)
+{
+  LatencySample *sample = g_queue_pop_head (&record->samples);
+  LatencyHistograms *hists;
+
+  rotate_window (self, record, ts);
+  hists = record->current;
+
+  /* sources only have the time spent downstream */
+  if (GST_CLOCK_TIME_IS_VALID (sample->buffer_in)) {
+    GstClockTime out, dequeued;
+
+    out = GST_CLOCK_TIME_IS_VALID (sample->buffer_out) ?
+        sample->buffer_out : ts;
+
+    /* elements that queue data send the sample event after the data that
+     * was queued before the sampled buffer, so until then the buffer was
+     * waiting. For other elements the event left before the buffer came. */
+    dequeued = sample->buffer_in;
+    if (GST_CLOCK_TIME_IS_VALID (sample->event_out))
+      dequeued = CLAMP (sample->event_out, sample->buffer_in, out);
+
+    gst_tracer_histogram_add (&hists->queueing, dequeued - sample->buffer_in);
+    gst_tracer_histogram_add (&hists->processing, out - dequeued);
+  }
+  if (GST_CLOCK_TIME_IS_VALID (sample->buffer_out))
+    gst_tracer_histogram_add (&hists->downstream, ts - sample->buffer_out);
+
+  g_free (sample);
+  g_atomic_int_add (&self->in_flight, -1);
+}
+
+/* drops the samples that didn't finish within the timeout, their buffer was
+ * dropped or didn't make it to a sink otherwise. Checked every half timeout
+ * so that pushes don't take the slow path forever for them.
+ * The tracer lock must be held */
+static void
+expire_samples (GstLatencyTracer * self, GstClockTime ts)
+{
+  guint i;
+
+  if (ts < self->next_expiry)
+    return;
+  self->next_expiry = ts + self->sample_timeout / 2;
+
+  for (i = 0; i < self->records->len; i++) {
+    LatencyElementRecord *record = g_ptr_array_index (self->records, i);
+    LatencySample *sample;
+
+    /* samples are queued in the order they were created */
+    while ((sample = g_queue_peek_head (&record->samples)) &&
+        sample->created + self->sample_timeout <= ts) {
+      GST_DEBUG ("%s: expiring sample from %" GST_TIME_FORMAT, record->name,
+          GST_TIME_ARGS (sample->src_ts));
+      g_free (g_queue_pop_head (&record->samples));
+      g_atomic_int_add (&self->in_flight, -1);
+    }
+  }
+}
+
+static void
+send_latency_sample (GstLatencyTracer * self, GstPad * pad, guint64 ts)
+{
+  GstElement *parent = get_real_pad_parent (pad);
+  LatencySample *sample;
+
+  if (!parent)
+    return;
+
+  g_mutex_lock (&self->lock);
+  sample = push_sample (self, get_element_record (self, parent), ts, ts);
+  /* the sampled buffer is the one being pushed */
+  sample->state = SAMPLE_BUFFER_IN;
+  g_mutex_unlock (&self->lock);
+
+  GST_DEBUG ("%s_%s: Sending latency sample event", GST_DEBUG_PAD_NAME (pad));
+  gst_pad_push_event (pad, gst_event_new_custom (GST_EVENT_CUSTOM_DOWNSTREAM,
+          gst_structure_new_id (latency_sample_id,
+              latency_probe_ts, G_TYPE_UINT64, ts, NULL)));
+
+  gst_object_unref (parent);
+}
+
+static LatencyPadData *
+latency_pad_data_new (GstPad * pad)
+{
+  LatencyPadData *data = g_new0 (LatencyPadData, 1);
+  GstElement *parent = get_real_pad_parent (pad);
+
+  if (parent) {
+    data->source = GST_PAD_IS_SRC (pad) && !GST_IS_BIN (parent) &&
+        GST_OBJECT_FLAG_IS_SET (parent, GST_ELEMENT_FLAG_SOURCE);
+    gst_object_unref (parent);
+  }
+  g_object_set_qdata_full ((GObject *) pad, latency_pad_quark, data, g_free);
+
+  return data;
+}
+
+static void
+sample_buffer_pre (GstLatencyTracer * self, GstPad * pad, guint64 ts)
+{
+  GstElement *parent = get_real_pad_parent (pad);
+  GstPad *peer_pad = gst_pad_get_peer (pad);
+  GstElement *peer_parent = get_real_pad_parent (peer_pad);
+  LatencyElementRecord *record;
+  LatencySample *sample;
+
+  g_mutex_lock (&self->lock);
+
+  expire_samples (self, ts);
+
+  /* the sampled buffer leaves @parent after the sample event did */
+  if (parent &&
+      (record = g_object_get_qdata ((GObject *) parent, latency_record_quark))) {
+    sample = g_queue_peek_head (&record->samples);
+    if (sample && sample->state == SAMPLE_BUFFER_IN &&
+        GST_CLOCK_TIME_IS_VALID (sample->event_out)) {
+      sample->state = SAMPLE_BUFFER_OUT;
+      sample->buffer_out = ts;
+      sample->thread = g_thread_self ();
+      sample->pad = pad;
+    }
+  }
+
+  /* the first buffer after the sample event enters @peer_parent */
+  if (peer_parent &&
+      (record = g_object_get_qdata ((GObject *) peer_parent,
+              latency_record_quark))) {
+    sample = g_queue_peek_tail (&record->samples);
+    if (sample && sample->state == SAMPLE_EVENT_IN) {
+      sample->state = SAMPLE_BUFFER_IN;
+      sample->buffer_in = ts;
+      sample->thread = g_thread_self ();
+      sample->pad = peer_pad;
+
+      if (record->sink) {
+        rotate_window (self, record, ts);
+        gst_tracer_histogram_add (&record->current->latency,
+            ts - sample->src_ts);
+      }
+    }
+  }
+
+  g_mutex_unlock (&self->lock);
+
+  if (peer_pad)
+    gst_object_unref (peer_pad);
+  if (peer_parent)
+    gst_object_unref (peer_parent);
+  if (parent)
+    gst_object_unref (parent);
+}
+
+static void
+do_sample_push_pre (GstTracer * tracer, guint64 ts, GstPad * pad)
+{
+  GstLatencyTracer *self = (GstLatencyTracer *) tracer;
+  LatencyPadData *data = g_object_get_qdata ((GObject *) pad,
+      latency_pad_quark);
+
+  if (G_UNLIKELY (data == NULL))
+    data = latency_pad_data_new (pad);
+
+  if (data->source && ++data->count == self->sample_interval) {
+    data->count = 0;
+    send_latency_sample (self, pad, ts);
+  }
+
+  /* nothing to do unless samples are on their way */
+  if (g_atomic_int_get (&self->in_flight) > 0)
+    sample_buffer_pre (self, pad, ts);
+}
+
+static void
+do_sample_push_post (GstTracer * tracer, guint64 ts, GstPad * pad)
+{
+  GstLatencyTracer *self = (GstLatencyTracer *) tracer;
+  GstElement *parent, *peer_parent;
+  GstPad *peer_pad;
+  LatencyElementRecord *record;
+  LatencySample *sample;
+
+  if (g_atomic_int_get (&self->in_flight) == 0)
+    return;
+
+  parent = get_real_pad_parent (pad);
+  peer_pad = gst_pad_get_peer (pad);
+  peer_parent = get_real_pad_parent (peer_pad);
+
+  g_mutex_lock (&self->lock);
+
+  /* a sink is done with the sampled buffer */
+  if (peer_parent &&
+      (record = g_object_get_qdata ((GObject *) peer_parent,
+              latency_record_quark)) && record->sink) {
+    sample = g_queue_peek_head (&record->samples);
+    if (sample && sample->state == SAMPLE_BUFFER_IN &&
+        sample->pad == peer_pad && sample->thread == g_thread_self ())
+      finish_sample (self, record, ts);
+  }
+
+  /* the push of the sampled buffer returned */
+  if (parent &&
+      (record = g_object_get_qdata ((GObject *) parent, latency_record_quark))) {
+    sample = g_queue_peek_head (&record->samples);
+    if (sample && sample->state == SAMPLE_BUFFER_OUT &&
+        sample->pad == pad && sample->thread == g_thread_self ())
+      finish_sample (self, record, ts);
+  }
+
+  g_mutex_unlock (&self->lock);
+
+  if (peer_pad)
+    gst_object_unref (peer_pad);
+  if (peer_parent)
+    gst_object_unref (peer_parent);
+  if (parent)
+    gst_object_unref (parent);
+}
+
+static void
+do_sample_push_event_pre (GstTracer * tracer, guint64 ts, GstPad * pad,
+    GstEvent * ev)
+{
+  GstLatencyTracer *self = (GstLatencyTracer *) tracer;
+  const GstStructure *data;
+  GstElement *parent, *peer_parent;
+  GstPad *peer_pad;
+  LatencyElementRecord *record;
+  guint64 src_ts;
+
+  if (GST_EVENT_TYPE (ev) != GST_EVENT_CUSTOM_DOWNSTREAM)
+    return;
+
+  data = gst_event_get_structure (ev);
+  if (gst_structure_get_name_id (data) != latency_sample_id ||
+      !gst_structure_id_get (data, latency_probe_ts, G_TYPE_UINT64, &src_ts,
+          NULL))
+    return;
+
+  parent = get_real_pad_parent (pad);
+  peer_pad = gst_pad_get_peer (pad);
+  peer_parent = get_real_pad_parent (peer_pad);
+
+  g_mutex_lock (&self->lock);
+
+  /* the sample event leaves @parent, after the oldest sample */
+  if (parent &&
+      (record = g_object_get_qdata ((GObject *) parent, latency_record_quark))) {
+    GList *l;
+
+    for (l = record->samples.head; l; l = l->next) {
+      LatencySample *sample = l->data;
+
+      if (!GST_CLOCK_TIME_IS_VALID (sample->event_out)) {
+        sample->event_out = ts;
+        break;
+      }
+    }
+  }
+
+  /* and enters @peer_parent, bins are only passed through */
+  if (peer_parent && !GST_IS_BIN (peer_parent))
+    push_sample (self, get_element_record (self, peer_parent), src_ts, ts);
+
+  g_mutex_unlock (&self->lock);
+
+  if (peer_pad)
+    gst_object_unref (peer_pad);
+  if (peer_parent)
+    gst_object_unref (peer_parent);
+  if (parent)
+    gst_object_unref (parent);
+}
+
 /* tracer class */
 
+static GstStructure *
+gst_latency_tracer_get_stats (GstLatencyTracer * self)
+{
+  GstStructure *s, *element;
+  GValue elements = G_VALUE_INIT, v = G_VALUE_INIT;
+  LatencyHistograms *hists;
+  GstClockTime ts;
+  guint i;
+
+  g_value_init (&elements, GST_TYPE_ARRAY);
+  hists = g_new (LatencyHistograms, 1);
+
+  g_mutex_lock (&self->lock);
+  ts = self->last_ts;
+  for (i = 0; i < self->records->len; i++) {
+    LatencyElementRecord *record = g_ptr_array_index (self->records, i);
+
+    rotate_window (self, record, ts);
+    *hists = *record->current;
+    latency_histograms_merge (hists, record->previous);
+
+    element = gst_structure_new ("element",
+        "element-id", G_TYPE_STRING, record->id,
+        "element", G_TYPE_STRING, record->name, NULL);
+    gst_tracer_histogram_set_field (element, "queueing", &hists->queueing);
+    gst_tracer_histogram_set_field (element, "processing", &hists->processing);
+    gst_tracer_histogram_set_field (element, "downstream", &hists->downstream);
+    if (record->sink)
+      gst_tracer_histogram_set_field (element, "latency", &hists->latency);
+
+    g_value_init (&v, GST_TYPE_STRUCTURE);
+    g_value_take_boxed (&v, element);
+    gst_value_array_append_and_take_value (&elements, &v);
+  }
+  g_mutex_unlock (&self->lock);
+
+  g_free (hists);
+
+  s = gst_structure_new ("latency",
+      "ts", G_TYPE_UINT64, ts,
+      "sample-interval", G_TYPE_UINT, self->sample_interval,
+      "window", G_TYPE_UINT64, self->window,
+      "pending-samples", G_TYPE_UINT,
+      (guint) g_atomic_int_get (&self->in_flight), NULL);
+  gst_structure_take_value (s, "elements", &elements);
+
+  return s;
+}
+
 static void
 gst_latency_tracer_constructed (GObject * object)
 {
   GstLatencyTracer *self = GST_LATENCY_TRACER (object);
+  GstTracer *tracer = GST_TRACER (self);
   gchar *params, *tmp;
   GstStructure *params_struct = NULL;
 
   g_object_get (self, "params", &params, NULL);
 
   if (!params)
-    return;
+    goto done;
 
   tmp = g_strdup_printf ("latency,%s", params);
   params_struct = gst_structure_from_string (tmp, NULL);
@@ -562,6 +1079,8 @@ gst_latency_tracer_constructed (GObject * object)
 
   if (params_struct) {
     const gchar *name, *flags;
+    gint value;
+
     /* Set the name if assigned */
     name = gst_structure_get_string (params_struct, "name");
     if (name)
@@ -589,10 +1108,83 @@ gst_latency_tracer_constructed (GObject * object)
 
       g_strfreev (split);
     }
+
+    if (gst_structure_get_int (params_struct, "sample-interval", &value)) {
+      if (value > 0)
+        self->sample_interval = value;
+      else
+        GST_WARNING ("Invalid latency tracer sample-interval %d", value);
+    }
+
+    if (gst_structure_get_int (params_struct, "window", &value)) {
+      if (value >= 0)
+        self->window = value * GST_SECOND;
+      else
+        GST_WARNING ("Invalid latency tracer window %d", value);
+    }
+
+    if (gst_structure_get_int (params_struct, "sample-timeout", &value)) {
+      if (value > 0)
+        self->sample_timeout = value * GST_MSECOND;
+      else
+        GST_WARNING ("Invalid latency tracer sample-timeout %d", value);
+    }
+
     gst_structure_free (params_struct);
   }
 
   g_free (params);
+
+done:
+  if (self->sample_interval > 0) {
+    GST_INFO_OBJECT (self, "sampling one in %u buffers", self->sample_interval);
+
+    gst_tracing_register_hook (tracer, "pad-push-pre",
+        G_CALLBACK (do_sample_push_pre));
+    gst_tracing_register_hook (tracer, "pad-push-list-pre",
+        G_CALLBACK (do_sample_push_pre));
+    gst_tracing_register_hook (tracer, "pad-push-post",
+        G_CALLBACK (do_sample_push_post));
+    gst_tracing_register_hook (tracer, "pad-push-list-post",
+        G_CALLBACK (do_sample_push_post));
+    gst_tracing_register_hook (tracer, "pad-push-event-pre",
+        G_CALLBACK (do_sample_push_event_pre));
+  } else {
+    /* in push mode, pre/post will be called before/after the peer chain
+     * function has been called. For this reaosn, we only use -pre to avoid
+     * accounting for the processing time of the peer element (the sink) */
+    gst_tracing_register_hook (tracer, "pad-push-pre",
+        G_CALLBACK (do_push_buffer_pre));
+    gst_tracing_register_hook (tracer, "pad-push-list-pre",
+        G_CALLBACK (do_push_buffer_pre));
+
+    /* while in pull mode, pre/post will happen before and after the upstream
+     * pull_range call is made, so it already only account for the upstream
+     * processing time. As a side effect, in pull mode, we can measure the
+     * source processing latency, while in push mode, we can't */
+    gst_tracing_register_hook (tracer, "pad-pull-range-pre",
+        G_CALLBACK (do_pull_range_pre));
+    gst_tracing_register_hook (tracer, "pad-pull-range-post",
+        G_CALLBACK (do_pull_range_post));
+
+    gst_tracing_register_hook (tracer, "pad-push-event-pre",
+        G_CALLBACK (do_push_event_pre));
+  }
+
+  /* Add pad query post hook to get the reported per-element latency */
+  gst_tracing_register_hook (tracer, "pad-query-post",
+      G_CALLBACK (do_query_post));
+}
+
+static void
+gst_latency_tracer_finalize (GObject * object)
+{
+  GstLatencyTracer *self = GST_LATENCY_TRACER (object);
+
+  g_ptr_array_unref (self->records);
+  g_mutex_clear (&self->lock);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
 static void
@@ -601,6 +1193,33 @@ gst_latency_tracer_class_init (GstLatencyTracerClass * klass)
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
 
   gobject_class->constructed = gst_latency_tracer_constructed;
+  gobject_class->finalize = gst_latency_tracer_finalize;
+
+  /**
+   * GstLatencyTracer::get-stats:
+   * @latencytracer: the latency tracer object to emit this signal on
+   *
+   * Returns the latencies measured with the `sample-interval` parameter. The
+   * `elements` field is an array of structures with the `element-id` and
+   * `element` name of each element sampled buffers went through, and the
+   * `queueing`, `processing` and `downstream` histograms, in nanoseconds.
+   * For sinks, the `latency` histogram has the time since the buffers left
+   * the source. The histograms have the `count`, `sum`, `min` and `max` of
+   * the values and the `p50`, `p90`, `p99` and `p999` percentiles, which are
+   * accurate to about 12%. `pending-samples` is the number of samples that
+   * are still on their way through the pipeline.
+   *
+   * Returns: (transfer full): a #GstStructure with the latencies
+   *
+   * Since: 1.26
+   */
+  gst_latency_tracer_signals[SIGNAL_GET_STATS] =
+      g_signal_new ("get-stats", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_STRUCT_OFFSET (GstLatencyTracerClass, get_stats), NULL, NULL, NULL,
+      GST_TYPE_STRUCTURE, 0, G_TYPE_NONE);
+
+  klass->get_stats = gst_latency_tracer_get_stats;
 
   latency_probe_id = g_quark_from_static_string ("latency_probe.id");
   sub_latency_probe_id = g_quark_from_static_string ("sub_latency_probe.id");
@@ -611,6 +1230,9 @@ gst_latency_tracer_class_init (GstLatencyTracerClass * klass)
   latency_probe_ts = g_quark_from_static_string ("latency_probe.ts");
   drop_sub_latency_quark =
       g_quark_from_static_string ("drop_sub_latency.quark");
+  latency_sample_id = g_quark_from_static_string ("latency_sample.id");
+  latency_record_quark = g_quark_from_static_string ("latency_record.quark");
+  latency_pad_quark = g_quark_from_static_string ("latency_pad.quark");
 
   /* announce trace formats */
   /* *INDENT-OFF* */
@@ -737,32 +1359,13 @@ gst_latency_tracer_class_init (GstLatencyTracerClass * klass)
 static void
 gst_latency_tracer_init (GstLatencyTracer * self)
 {
-  GstTracer *tracer = GST_TRACER (self);
-
   /* only trace pipeline latency by default */
   self->flags = GST_LATENCY_TRACER_FLAG_PIPELINE;
 
-  /* in push mode, pre/post will be called before/after the peer chain
-   * function has been called. For this reaosn, we only use -pre to avoid
-   * accounting for the processing time of the peer element (the sink) */
-  gst_tracing_register_hook (tracer, "pad-push-pre",
-      G_CALLBACK (do_push_buffer_pre));
-  gst_tracing_register_hook (tracer, "pad-push-list-pre",
-      G_CALLBACK (do_push_buffer_pre));
-
-  /* while in pull mode, pre/post will happen before and after the upstream
-   * pull_range call is made, so it already only account for the upstream
-   * processing time. As a side effect, in pull mode, we can measure the
-   * source processing latency, while in push mode, we can't */
-  gst_tracing_register_hook (tracer, "pad-pull-range-pre",
-      G_CALLBACK (do_pull_range_pre));
-  gst_tracing_register_hook (tracer, "pad-pull-range-post",
-      G_CALLBACK (do_pull_range_post));
-
-  gst_tracing_register_hook (tracer, "pad-push-event-pre",
-      G_CALLBACK (do_push_event_pre));
-
-  /* Add pad query post hook to get the reported per-element latency */
-  gst_tracing_register_hook (tracer, "pad-query-post",
-      G_CALLBACK (do_query_post));
+  self->window = 10 * GST_SECOND;
+  self->sample_timeout = 5 * GST_SECOND;
+  g_mutex_init (&self->lock);
+  self->records =
+      g_ptr_array_new_with_free_func ((GDestroyNotify)
+      latency_element_record_free);
 }
@@ -59,12 +59,23 @@ struct _GstLatencyTracer {
 
   /*< private >*/
   GstLatencyTracerFlags flags;
+
+  /* sampled mode */
+  guint sample_interval;
+  GstClockTime window;
+  GMutex lock;
+  gint in_flight;
+  GstClockTime sample_timeout;
+  GstClockTime next_expiry;
+  GstClockTime last_ts;
+  GPtrArray *records;
 };
 
 struct _GstLatencyTracerClass {
   GstTracerClass parent_class;
 
-  /* signals */
+  /* actions */
+  GstStructure * (*get_stats) (GstLatencyTracer *tracer);
 };
 
 G_GNUC_INTERNAL GType gst_latency_tracer_get_type (void);
@@ -23,6 +23,25 @@
  * @short_description: log event stats
  *
  * A tracing module that builds usage statistic for elements and pads.
+ *
+ * By default every buffer, event, message and query is logged as a
+ * #GstTracerRecord, which is meant to be post-processed with gst-stats.
+ *
+ * With the `aggregate` parameter the tracer doesn't log anything and instead
+ * keeps statistics in memory, for each pad that pushes or pulls data: the
+ * number of buffers and bytes, and histograms of the time between buffers and
+ * of the time spent in the push or pull. Each streaming thread updates its own
+ * slot of these, so the data path neither allocates nor takes locks once a
+ * thread has seen a pad. Slots are reused when threads exit, only threads
+ * beyond the first seven running at the same time share a locked slot. Use
+ * the #GstStatsTracer::get-stats action signal to get a snapshot, for example
+ * periodically to export them:
+ *
+ * ```
+ * GST_TRACERS='stats(aggregate=true,name=stats)'
+ * ```
+ *
+ * The tracer can be found with gst_tracing_get_active_tracers().
  */
 
 #ifdef HAVE_CONFIG_H
@@ -30,8 +49,10 @@
 #endif
 
 #include "gststats.h"
+#include "gsthistogram.h"
 
 #include <stdio.h>
+#include <string.h>
 
 GST_DEBUG_CATEGORY_STATIC (gst_stats_debug);
 #define GST_CAT_DEFAULT gst_stats_debug
@@ -55,6 +76,67 @@ static GstTracerRecord *tr_event;
 static GstTracerRecord *tr_message;
 static GstTracerRecord *tr_query;
 
+enum
+{
+  SIGNAL_GET_STATS,
+  LAST_SIGNAL
+};
+
+static guint gst_stats_tracer_signals[LAST_SIGNAL] = { 0 };
+
+static GstStructure *gst_stats_tracer_get_stats (GstStatsTracer * self);
+
+/* up to STATS_N_SLOTS - 1 threads that stream data at the same time get a
+ * slot of their own, all other threads share the last slot. The slot of a
+ * thread is given to the next new thread when it exits */
+#define STATS_N_SLOTS 8
+#define STATS_SHARED_SLOT (STATS_N_SLOTS - 1)
+
+typedef struct
+{
+  guint64 buffers;
+  guint64 bytes;
+  GstClockTime last_arrival;
+  GstTracerHistogram inter_arrival;
+  GstTracerHistogram processing;
+} GstStatsPadSlot;
+
+typedef struct
+{
+  guint index;
+  guint parent_ix;
+  gchar *name;
+  GstPadDirection direction;
+  GstStatsPadSlot *slots[STATS_N_SLOTS];
+} GstStatsPadRecord;
+
+typedef struct
+{
+  guint index;
+  guint parent_ix;
+  gchar *name;
+  gchar *type_name;
+} GstStatsElementRecord;
+
+static void release_thread_slot (gpointer data);
+
+/* bitmask of the slots owned by a thread, the shared slot is never owned */
+static guint used_slots;
+static GPrivate thread_slot = G_PRIVATE_INIT (release_thread_slot);
+G_LOCK_DEFINE_STATIC (_shared_slot);
+
+/* a push or pull in progress in a thread, they are kept per thread because
+ * the threads of the shared slot would overwrite each other's start times */
+typedef struct
+{
+  gconstpointer pad_stats;
+  GstClockTime ts;
+} GstStatsPending;
+
+/* GArray of GstStatsPending, the innermost push or pull last */
+static GPrivate thread_pending =
+G_PRIVATE_INIT ((GDestroyNotify) g_array_unref);
+
 typedef struct
 {
   /* we can't rely on the address to be unique over time */
@@ -63,6 +145,8 @@ typedef struct
   GstClockTime last_ts;
   /* hierarchy */
   guint parent_ix;
+  /* in aggregation mode, owned by the tracer */
+  GstStatsPadRecord *record;
 } GstPadStats;
 
 typedef struct
@@ -75,8 +159,164 @@ typedef struct
   GstClockTime treal;
   /* hierarchy */
   guint parent_ix;
+  /* in aggregation mode, owned by the tracer */
+  GstStatsElementRecord *record;
 } GstElementStats;
 
+/* aggregation helpers */
+
+static guint
+claim_thread_slot (void)
+{
+  guint used, ix;
+
+  do {
+    used = g_atomic_int_get (&used_slots);
+    for (ix = 0; ix < STATS_SHARED_SLOT; ix++) {
+      if (!(used & (1u << ix)))
+        break;
+    }
+    if (ix == STATS_SHARED_SLOT)
+      return STATS_SHARED_SLOT;
+  } while (!g_atomic_int_compare_and_exchange (&used_slots, used,
+          used | (1u << ix)));
+
+  return ix;
+}
+
+/* called when a thread exits, the per pad data in the slot stays and is added
+ * to by the next thread that gets the slot */
+static void
+release_thread_slot (gpointer data)
+{
+  guint ix = GPOINTER_TO_UINT (data) - 1;
+
+  if (ix != STATS_SHARED_SLOT)
+    g_atomic_int_and (&used_slots, ~(1u << ix));
+}
+
+static inline guint
+get_thread_slot (void)
+{
+  guint slot = GPOINTER_TO_UINT (g_private_get (&thread_slot));
+
+  if (G_UNLIKELY (slot == 0)) {
+    slot = claim_thread_slot () + 1;
+    g_private_set (&thread_slot, GUINT_TO_POINTER (slot));
+  }
+  return slot - 1;
+}
+
+/* the shared slot must be locked */
+static inline GstStatsPadSlot *
+get_pad_slot (GstStatsPadRecord * record, guint ix)
+{
+  GstStatsPadSlot *slot;
+
+  slot = g_atomic_pointer_get (&record->slots[ix]);
+  if (G_UNLIKELY (slot == NULL)) {
+    /* first data of this thread on this pad */
+    slot = g_new (GstStatsPadSlot, 1);
+    slot->buffers = slot->bytes = 0;
+    slot->last_arrival = GST_CLOCK_TIME_NONE;
+    gst_tracer_histogram_init (&slot->inter_arrival);
+    gst_tracer_histogram_init (&slot->processing);
+    g_atomic_pointer_set (&record->slots[ix], slot);
+  }
+  return slot;
+}
+
+static void
+aggregate_data (GstPadStats * stats, guint64 ts, guint n_buffers, gsize size)
+{
+  guint ix = get_thread_slot ();
+  GstStatsPadSlot *slot;
+
+  if (G_UNLIKELY (ix == STATS_SHARED_SLOT))
+    G_LOCK (_shared_slot);
+
+  slot = get_pad_slot (stats->record, ix);
+  slot->buffers += n_buffers;
+  slot->bytes += size;
+  if (GST_CLOCK_TIME_IS_VALID (slot->last_arrival) && ts >= slot->last_arrival)
+    gst_tracer_histogram_add (&slot->inter_arrival, ts - slot->last_arrival);
+  slot->last_arrival = ts;
+
+  if (G_UNLIKELY (ix == STATS_SHARED_SLOT))
+    G_UNLOCK (_shared_slot);
+}
+
+static void
+aggregate_start (GstPadStats * stats, guint64 ts)
+{
+  GArray *pending = g_private_get (&thread_pending);
+  GstStatsPending start = { stats, ts };
+
+  if (G_UNLIKELY (pending == NULL)) {
+    pending = g_array_sized_new (FALSE, FALSE, sizeof (GstStatsPending), 8);
+    g_private_set (&thread_pending, pending);
+  }
+  g_array_append_val (pending, start);
+}
+
+static void
+aggregate_end (GstPadStats * stats, guint64 ts)
+{
+  GArray *pending = g_private_get (&thread_pending);
+  GstClockTime start_ts = GST_CLOCK_TIME_NONE;
+  GstStatsPadSlot *slot;
+  guint i, ix;
+
+  if (G_UNLIKELY (pending == NULL))
+    return;
+
+  /* pushes and pulls on other pads can be nested in this one, and those that
+   * missed their end are dropped with them */
+  for (i = pending->len; i > 0; i--) {
+    GstStatsPending *start = &g_array_index (pending, GstStatsPending, i - 1);
+
+    if (start->pad_stats == stats) {
+      start_ts = start->ts;
+      g_array_set_size (pending, i - 1);
+      break;
+    }
+  }
+  if (!GST_CLOCK_TIME_IS_VALID (start_ts) || ts < start_ts)
+    return;
+
+  ix = get_thread_slot ();
+  if (G_UNLIKELY (ix == STATS_SHARED_SLOT))
+    G_LOCK (_shared_slot);
+
+  slot = get_pad_slot (stats->record, ix);
+  gst_tracer_histogram_add (&slot->processing, ts - start_ts);
+
+  if (G_UNLIKELY (ix == STATS_SHARED_SLOT))
+    G_UNLOCK (_shared_slot);
+}
+
+static void
+free_element_record (gpointer data)
+{
+  GstStatsElementRecord *record = data;
+
+  g_free (record->name);
+  g_free (record->type_name);
+  g_free (record);
+}
+
+static void
+free_pad_record (gpointer data)
+{
+  GstStatsPadRecord *record = data;
+  guint i;
+
+  for (i = 0; i < STATS_N_SLOTS; i++)
+    g_free (record->slots[i]);
+  g_free (record->name);
+  g_free (record);
+}
+
 /* data helper */
 
 static GstElementStats no_elem_stats = { 0, };
@@ -88,13 +328,27 @@ fill_element_stats (GstStatsTracer * self, GstElement * element)
 
   stats->index = self->num_elements++;
   stats->parent_ix = G_MAXUINT;
+
+  if (self->aggregate) {
+    GstStatsElementRecord *record = g_new0 (GstStatsElementRecord, 1);
+
+    record->index = stats->index;
+    record->parent_ix = G_MAXUINT;
+    record->name = g_strdup (GST_OBJECT_NAME (element));
+    record->type_name = g_strdup (G_OBJECT_TYPE_NAME (element));
+    g_ptr_array_add (self->element_records, record);
+    stats->record = record;
+  }
   return stats;
 }
 
 static void
-log_new_element_stats (GstElementStats * stats, GstElement * element,
-    GstClockTime elapsed)
+log_new_element_stats (GstStatsTracer * self, GstElementStats * stats,
+    GstElement * element, GstClockTime elapsed)
 {
+  if (self->aggregate)
+    return;
+
   gst_tracer_record_log (tr_new_element, (guint64) (guintptr) g_thread_self (),
       elapsed, stats->index, stats->parent_ix, GST_OBJECT_NAME (element),
       G_OBJECT_TYPE_NAME (element), GST_IS_BIN (element));
@@ -140,10 +394,12 @@ get_element_stats (GstStatsTracer * self, GstElement * element)
     if (parent) {
       GstElementStats *parent_stats = get_element_stats (self, parent);
       stats->parent_ix = parent_stats->index;
+      if (stats->record)
+        stats->record->parent_ix = stats->parent_ix;
     }
   }
   if (G_UNLIKELY (is_new)) {
-    log_new_element_stats (stats, element, GST_CLOCK_TIME_NONE);
+    log_new_element_stats (self, stats, element, GST_CLOCK_TIME_NONE);
   }
   return stats;
 }
@@ -191,12 +447,26 @@ fill_pad_stats (GstStatsTracer * self, GstPad * pad)
   stats->index = self->num_pads++;
   stats->parent_ix = G_MAXUINT;
 
+  if (self->aggregate) {
+    GstStatsPadRecord *record = g_new0 (GstStatsPadRecord, 1);
+
+    record->index = stats->index;
+    record->parent_ix = G_MAXUINT;
+    record->name = g_strdup (GST_OBJECT_NAME (pad));
+    record->direction = GST_PAD_DIRECTION (pad);
+    g_ptr_array_add (self->pad_records, record);
+    stats->record = record;
+  }
+
   return stats;
 }
 
 static void
-log_new_pad_stats (GstPadStats * stats, GstPad * pad)
+log_new_pad_stats (GstStatsTracer * self, GstPadStats * stats, GstPad * pad)
 {
+  if (self->aggregate)
+    return;
+
   gst_tracer_record_log (tr_new_pad, (guint64) (guintptr) g_thread_self (),
       stats->index, stats->parent_ix, GST_OBJECT_NAME (pad),
       G_OBJECT_TYPE_NAME (pad), GST_IS_GHOST_PAD (pad),
@@ -234,10 +504,12 @@ get_pad_stats (GstStatsTracer * self, GstPad * pad)
       GstElementStats *elem_stats = get_element_stats (self, elem);
 
       stats->parent_ix = elem_stats->index;
+      if (stats->record)
+        stats->record->parent_ix = stats->parent_ix;
     }
   }
   if (G_UNLIKELY (is_new)) {
-    log_new_pad_stats (stats, pad);
+    log_new_pad_stats (self, stats, pad);
   }
   return stats;
 }
@@ -273,6 +545,9 @@ do_query_stats (GstStatsTracer * self, GstPad * this_pad,
   GstElement *that_elem = get_real_pad_parent (that_pad);
   GstElementStats *that_elem_stats = get_element_stats (self, that_elem);
 
+  if (self->aggregate)
+    return;
+
   gst_tracer_record_log (tr_query, (guint64) (guintptr) g_thread_self (),
       elapsed, this_pad_stats->index, this_elem_stats->index,
       that_pad_stats->index, that_elem_stats->index, GST_QUERY_TYPE_NAME (qry),
@@ -361,8 +636,17 @@ do_push_buffer_pre (GstStatsTracer * self, guint64 ts, GstPad * this_pad,
     GstBuffer * buffer)
 {
   GstPadStats *this_pad_stats = get_pad_stats (self, this_pad);
-  GstPad *that_pad = GST_PAD_PEER (this_pad);
-  GstPadStats *that_pad_stats = get_pad_stats (self, that_pad);
+  GstPad *that_pad;
+  GstPadStats *that_pad_stats;
+
+  if (self->aggregate) {
+    aggregate_data (this_pad_stats, ts, 1, gst_buffer_get_size (buffer));
+    aggregate_start (this_pad_stats, ts);
+    return;
+  }
+
+  that_pad = GST_PAD_PEER (this_pad);
+  that_pad_stats = get_pad_stats (self, that_pad);
 
   do_buffer_stats (self, this_pad, this_pad_stats, that_pad, that_pad_stats,
       buffer, ts);
@@ -374,6 +658,9 @@ do_push_buffer_post (GstStatsTracer * self, guint64 ts, GstPad * pad,
 {
   GstPadStats *stats = get_pad_stats (self, pad);
 
+  if (self->aggregate)
+    aggregate_end (stats, ts);
+
   do_element_stats (self, pad, stats->last_ts, ts);
 }
 
@@ -402,11 +689,21 @@ do_push_buffer_list_pre (GstStatsTracer * self, guint64 ts, GstPad * this_pad,
     GstBufferList * list)
 {
   GstPadStats *this_pad_stats = get_pad_stats (self, this_pad);
-  GstPad *that_pad = GST_PAD_PEER (this_pad);
-  GstPadStats *that_pad_stats = get_pad_stats (self, that_pad);
-  DoPushBufferListArgs args = { self, this_pad, this_pad_stats, that_pad,
-    that_pad_stats, ts
-  };
+  DoPushBufferListArgs args;
+
+  if (self->aggregate) {
+    aggregate_data (this_pad_stats, ts, gst_buffer_list_length (list),
+        gst_buffer_list_calculate_size (list));
+    aggregate_start (this_pad_stats, ts);
+    return;
+  }
+
+  args.self = self;
+  args.this_pad = this_pad;
+  args.this_pad_stats = this_pad_stats;
+  args.that_pad = GST_PAD_PEER (this_pad);
+  args.that_pad_stats = get_pad_stats (self, args.that_pad);
+  args.ts = ts;
 
   gst_buffer_list_foreach (list, do_push_buffer_list_item, &args);
 }
@@ -417,6 +714,9 @@ do_push_buffer_list_post (GstStatsTracer * self, guint64 ts, GstPad * pad,
 {
   GstPadStats *stats = get_pad_stats (self, pad);
 
+  if (self->aggregate)
+    aggregate_end (stats, ts);
+
   do_element_stats (self, pad, stats->last_ts, ts);
 }
 
@@ -425,6 +725,9 @@ do_pull_range_pre (GstStatsTracer * self, guint64 ts, GstPad * pad)
 {
   GstPadStats *stats = get_pad_stats (self, pad);
   stats->last_ts = ts;
+
+  if (self->aggregate)
+    aggregate_start (stats, ts);
 }
 
 static void
@@ -433,8 +736,19 @@ do_pull_range_post (GstStatsTracer * self, guint64 ts, GstPad * this_pad,
 {
   GstPadStats *this_pad_stats = get_pad_stats (self, this_pad);
   guint64 last_ts = this_pad_stats->last_ts;
-  GstPad *that_pad = GST_PAD_PEER (this_pad);
-  GstPadStats *that_pad_stats = get_pad_stats (self, that_pad);
+  GstPad *that_pad;
+  GstPadStats *that_pad_stats;
+
+  if (self->aggregate) {
+    if (buffer != NULL)
+      aggregate_data (this_pad_stats, ts, 1, gst_buffer_get_size (buffer));
+    aggregate_end (this_pad_stats, ts);
+    do_element_stats (self, this_pad, last_ts, ts);
+    return;
+  }
+
+  that_pad = GST_PAD_PEER (this_pad);
+  that_pad_stats = get_pad_stats (self, that_pad);
 
   if (buffer != NULL) {
     do_buffer_stats (self, this_pad, this_pad_stats, that_pad, that_pad_stats,
@@ -452,6 +766,9 @@ do_push_event_pre (GstStatsTracer * self, guint64 ts, GstPad * pad,
   GstPadStats *pad_stats = get_pad_stats (self, pad);
 
   elem_stats->last_ts = ts;
+  if (self->aggregate)
+    return;
+
   gst_tracer_record_log (tr_event, (guint64) (guintptr) g_thread_self (), ts,
       pad_stats->index, elem_stats->index, GST_EVENT_TYPE_NAME (ev));
 }
@@ -461,11 +778,16 @@ do_post_message_pre (GstStatsTracer * self, guint64 ts, GstElement * elem,
     GstMessage * msg)
 {
   GstElementStats *stats = get_element_stats (self, elem);
-  const GstStructure *msg_s = gst_message_get_structure (msg);
-  GstStructure *s =
-      msg_s ? (GstStructure *) msg_s : gst_structure_new_empty ("dummy");
+  const GstStructure *msg_s;
+  GstStructure *s;
 
   stats->last_ts = ts;
+  if (self->aggregate)
+    return;
+
+  msg_s = gst_message_get_structure (msg);
+  s = msg_s ? (GstStructure *) msg_s : gst_structure_new_empty ("dummy");
+
   /* FIXME: work out whether using NULL instead of a dummy struct would work */
   gst_tracer_record_log (tr_message, (guint64) (guintptr) g_thread_self (), ts,
       stats->index, GST_MESSAGE_TYPE_NAME (msg), s);
@@ -478,8 +800,10 @@ do_element_new (GstStatsTracer * self, guint64 ts, GstElement * elem)
 {
   GstElementStats *stats;
 
+  G_LOCK (_elem_stats);
   stats = create_element_stats (self, elem);
-  log_new_element_stats (stats, elem, ts);
+  G_UNLOCK (_elem_stats);
+  log_new_element_stats (self, stats, elem, ts);
 }
 
 static void
@@ -489,6 +813,9 @@ do_element_query_pre (GstStatsTracer * self, guint64 ts, GstElement * elem,
   GstElementStats *stats = get_element_stats (self, elem);
 
   stats->last_ts = ts;
+  if (self->aggregate)
+    return;
+
   gst_tracer_record_log (tr_element_query,
       (guint64) (guintptr) g_thread_self (), ts, stats->index,
       GST_QUERY_TYPE_NAME (qry));
@@ -543,15 +870,140 @@ gst_stats_tracer_constructed (GObject * object)
   name = gst_structure_get_string (params_struct, "name");
   if (name)
     gst_object_set_name (GST_OBJECT (self), name);
+  gst_structure_get_boolean (params_struct, "aggregate", &self->aggregate);
   gst_structure_free (params_struct);
 }
 
+static void
+gst_stats_tracer_finalize (GObject * object)
+{
+  GstStatsTracer *self = GST_STATS_TRACER (object);
+
+  g_ptr_array_unref (self->element_records);
+  g_ptr_array_unref (self->pad_records);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static GstStructure *
+gst_stats_tracer_get_stats (GstStatsTracer * self)
+{
+  GstStructure *s, *pad;
+  GValue elements = G_VALUE_INIT, pads = G_VALUE_INIT;
+  GValue v = G_VALUE_INIT;
+  GstTracerHistogram *inter_arrival, *processing;
+  guint i, j;
+
+  g_value_init (&elements, GST_TYPE_ARRAY);
+  g_value_init (&pads, GST_TYPE_ARRAY);
+
+  G_LOCK (_elem_stats);
+  for (i = 0; i < self->element_records->len; i++) {
+    GstStatsElementRecord *record =
+        g_ptr_array_index (self->element_records, i);
+
+    g_value_init (&v, GST_TYPE_STRUCTURE);
+    g_value_take_boxed (&v, gst_structure_new ("element",
+            "ix", G_TYPE_UINT, record->index,
+            "parent-ix", G_TYPE_UINT, record->parent_ix,
+            "name", G_TYPE_STRING, record->name,
+            "type", G_TYPE_STRING, record->type_name, NULL));
+    gst_value_array_append_and_take_value (&elements, &v);
+  }
+  G_UNLOCK (_elem_stats);
+
+  inter_arrival = g_new (GstTracerHistogram, 1);
+  processing = g_new (GstTracerHistogram, 1);
+
+  G_LOCK (_pad_stats);
+  for (i = 0; i < self->pad_records->len; i++) {
+    GstStatsPadRecord *record = g_ptr_array_index (self->pad_records, i);
+    guint64 buffers = 0, bytes = 0;
+
+    gst_tracer_histogram_init (inter_arrival);
+    gst_tracer_histogram_init (processing);
+
+    /* the slots are updated without locking, the snapshot is consistent
+     * enough for statistics */
+    for (j = 0; j < STATS_N_SLOTS; j++) {
+      GstStatsPadSlot *slot = g_atomic_pointer_get (&record->slots[j]);
+
+      if (slot == NULL)
+        continue;
+
+      if (j == STATS_SHARED_SLOT)
+        G_LOCK (_shared_slot);
+      buffers += slot->buffers;
+      bytes += slot->bytes;
+      gst_tracer_histogram_merge (inter_arrival, &slot->inter_arrival);
+      gst_tracer_histogram_merge (processing, &slot->processing);
+      if (j == STATS_SHARED_SLOT)
+        G_UNLOCK (_shared_slot);
+    }
+
+    pad = gst_structure_new ("pad",
+        "ix", G_TYPE_UINT, record->index,
+        "parent-ix", G_TYPE_UINT, record->parent_ix,
+        "name", G_TYPE_STRING, record->name,
+        "direction", GST_TYPE_PAD_DIRECTION, record->direction,
+        "buffers", G_TYPE_UINT64, buffers,
+        "bytes", G_TYPE_UINT64, bytes, NULL);
+    gst_tracer_histogram_set_field (pad, "inter-arrival", inter_arrival);
+    gst_tracer_histogram_set_field (pad, "processing-time", processing);
+
+    g_value_init (&v, GST_TYPE_STRUCTURE);
+    g_value_take_boxed (&v, pad);
+    gst_value_array_append_and_take_value (&pads, &v);
+  }
+  G_UNLOCK (_pad_stats);
+
+  g_free (inter_arrival);
+  g_free (processing);
+
+  s = gst_structure_new ("stats", "ts", G_TYPE_UINT64,
+      gst_util_get_timestamp (), NULL);
+  gst_structure_take_value (s, "elements", &elements);
+  gst_structure_take_value (s, "pads", &pads);
+
+  return s;
+}
+
 static void
 gst_stats_tracer_class_init (GstStatsTracerClass * klass)
 {
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
 
   gobject_class->constructed = gst_stats_tracer_constructed;
+  gobject_class->finalize = gst_stats_tracer_finalize;
+
+  /**
+   * GstStatsTracer::get-stats:
+   * @statstracer: the stats tracer object to emit this signal on
+   *
+   * Returns a snapshot of the statistics collected with the `aggregate`
+   * parameter. The `elements` and `pads` fields are arrays of structures
+   * with the index, the index of the parent and the name of each element and
+   * pad seen so far.
+   *
+   * The pad structures also contain the number of `buffers` and `bytes`
+   * pushed or pulled through the pad, and the `inter-arrival` and
+   * `processing-time` histograms, in nanoseconds. These have the `count`,
+   * `sum`, `min` and `max` of the values and the `p50`, `p90`, `p99` and
+   * `p999` percentiles, which are accurate to about 12%.
+   *
+   * The values count since the tracer was created, the difference between
+   * two snapshots gives the values for the time in between.
+   *
+   * Returns: (transfer full): a #GstStructure with the statistics
+   *
+   * Since: 1.26
+   */
+  gst_stats_tracer_signals[SIGNAL_GET_STATS] =
+      g_signal_new ("get-stats", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION, G_STRUCT_OFFSET (GstStatsTracerClass,
+          get_stats), NULL, NULL, NULL, GST_TYPE_STRUCTURE, 0, G_TYPE_NONE);
+
+  klass->get_stats = gst_stats_tracer_get_stats;
 
   /* announce trace formats */
   /* *INDENT-OFF* */
@@ -789,6 +1241,9 @@ gst_stats_tracer_init (GstStatsTracer * self)
 {
   GstTracer *tracer = GST_TRACER (self);
 
+  self->element_records = g_ptr_array_new_with_free_func (free_element_record);
+  self->pad_records = g_ptr_array_new_with_free_func (free_pad_record);
+
   gst_tracing_register_hook (tracer, "pad-push-pre",
       G_CALLBACK (do_push_buffer_pre));
   gst_tracing_register_hook (tracer, "pad-push-post",
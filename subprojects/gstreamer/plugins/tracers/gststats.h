@@ -52,12 +52,18 @@ struct _GstStatsTracer {
 
   /*< private >*/
   guint num_elements, num_pads;
+
+  /* aggregation mode, records owned by the tracer */
+  gboolean aggregate;
+  GPtrArray *element_records;
+  GPtrArray *pad_records;
 };
 
 struct _GstStatsTracerClass {
   GstTracerClass parent_class;
 
   /* signals */
+  GstStructure * (*get_stats) (GstStatsTracer *tracer);
 };
 
 G_GNUC_INTERNAL GType gst_stats_tracer_get_type (void);
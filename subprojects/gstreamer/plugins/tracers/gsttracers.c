@@ -30,6 +30,7 @@
 #include "gststats.h"
 #include "gstleaks.h"
 #include "gstfactories.h"
+#include "gstcapscache.h"
 
 static gboolean
 plugin_init (GstPlugin * plugin)
@@ -51,6 +52,9 @@ plugin_init (GstPlugin * plugin)
   if (!gst_tracer_register (plugin, "factories",
           gst_factories_tracer_get_type ()))
     return FALSE;
+  if (!gst_tracer_register (plugin, "capscache",
+          gst_caps_cache_tracer_get_type ()))
+    return FALSE;
   return TRUE;
 }
 
@@ -0,0 +1,187 @@
+/* GStreamer
+ *
+ * capsintersect.c: benchmark for the caps operations done during negotiation
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Reports time and number of heap allocations per caps operation, for caps
+ * similar to the ones a raw video decoder and a compositor with many sink
+ * pads negotiate with. Allocations are only counted with glibc. */
+
+#include <stdlib.h>
+#include <gst/gst.h>
+
+#define NUM_ITERATIONS 20000
+
+#if defined(__GLIBC__)
+#define COUNT_ALLOCATIONS 1
+
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t nmemb, size_t size);
+extern void *__libc_realloc (void *ptr, size_t size);
+
+static volatile gint n_allocs;
+
+void *
+malloc (size_t size)
+{
+  g_atomic_int_inc (&n_allocs);
+  return __libc_malloc (size);
+}
+
+void *
+calloc (size_t nmemb, size_t size)
+{
+  g_atomic_int_inc (&n_allocs);
+  return __libc_calloc (nmemb, size);
+}
+
+void *
+realloc (void *ptr, size_t size)
+{
+  g_atomic_int_inc (&n_allocs);
+  return __libc_realloc (ptr, size);
+}
+#endif
+
+#define VIDEO_FORMATS "{ AYUV64, ARGB64, GBRA_12LE, GBRA_12BE, Y412_LE, " \
+    "Y412_BE, A444_10LE, GBRA_10LE, A444_10BE, GBRA_10BE, A422_10LE, " \
+    "A422_10BE, A420_10LE, A420_10BE, RGB10A2_LE, BGR10A2_LE, Y410, GBRA, " \
+    "ABGR, VUYA, BGRA, AYUV, ARGB, RGBA, A420, AV12, Y444_16LE, Y444_16BE, " \
+    "v216, P016_LE, P016_BE, Y444_12LE, GBR_12LE, Y444_12BE, GBR_12BE, " \
+    "I422_12LE, I422_12BE, Y212_LE, Y212_BE, I420_12LE, I420_12BE, " \
+    "P012_LE, P012_BE, Y444_10LE, GBR_10LE, Y444_10BE, GBR_10BE, r210, " \
+    "I422_10LE, I422_10BE, NV16_10LE32, Y210, v210, UYVP, I420_10LE, " \
+    "I420_10BE, P010_10LE, NV12_10LE32, NV12_10LE40, P010_10BE, Y444, " \
+    "RGBP, GBR, BGRP, NV24, xBGR, BGRx, xRGB, RGBx, BGR, IYU2, v308, RGB, " \
+    "Y42B, NV61, NV16, VYUY, UYVY, YVYU, YUY2, I420, YV12, NV21, NV12, " \
+    "NV12_64Z32, NV12_4L4, NV12_32L32, Y41B, IYU1, YVU9, YUV9, RGB16, " \
+    "BGR16, RGB15, BGR15, RGB8P, GRAY16_LE, GRAY16_BE, GRAY10_LE32, GRAY8 }"
+
+/* what a compositor sink pad accepts */
+#define COMPOSITOR_CAPS \
+    "video/x-raw, format=(string)" VIDEO_FORMATS ", " \
+    "width=(int)[ 1, 2147483647 ], height=(int)[ 1, 2147483647 ], " \
+    "framerate=(fraction)[ 0/1, 2147483647/1 ]; " \
+    "video/x-raw(ANY), format=(string)" VIDEO_FORMATS ", " \
+    "width=(int)[ 1, 2147483647 ], height=(int)[ 1, 2147483647 ], " \
+    "framerate=(fraction)[ 0/1, 2147483647/1 ]"
+
+/* what a decoder proposes downstream */
+#define DECODER_CAPS \
+    "video/x-raw, format=(string){ NV12, I420, P010_10LE }, " \
+    "width=(int)1920, height=(int)1080, interlace-mode=(string)progressive, " \
+    "pixel-aspect-ratio=(fraction)1/1, chroma-site=(string)mpeg2, " \
+    "colorimetry=(string)bt709, framerate=(fraction)30/1"
+
+static gint
+get_allocs (void)
+{
+#ifdef COUNT_ALLOCATIONS
+  return g_atomic_int_get (&n_allocs);
+#else
+  return 0;
+#endif
+}
+
+static void
+report (const gchar * name, GstClockTime start, gint allocs)
+{
+  GstClockTime elapsed = gst_util_get_timestamp () - start;
+  gint n = get_allocs () - allocs;
+
+  g_print ("%-24s %10.1f ns/op %10.2f allocs/op\n", name,
+      (gdouble) elapsed / NUM_ITERATIONS, (gdouble) n / NUM_ITERATIONS);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  GstCaps *compositor, *decoder, *decoder_copy, *filter, *res;
+  GstClockTime start;
+  gint allocs, i;
+
+  gst_init (&argc, &argv);
+
+  compositor = gst_caps_from_string (COMPOSITOR_CAPS);
+  decoder = gst_caps_from_string (DECODER_CAPS);
+  decoder_copy = gst_caps_copy (decoder);
+  filter = gst_caps_from_string ("video/x-raw, format=(string)NV12");
+
+#ifndef COUNT_ALLOCATIONS
+  g_print ("allocations are not counted on this platform\n");
+#endif
+
+  allocs = get_allocs ();
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_ITERATIONS; i++) {
+    res = gst_caps_copy (compositor);
+    gst_caps_unref (res);
+  }
+  report ("copy", start, allocs);
+
+  allocs = get_allocs ();
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_ITERATIONS; i++) {
+    res = gst_caps_copy (compositor);
+    gst_caps_set_simple (res, "width", G_TYPE_INT, 1280, NULL);
+    gst_caps_unref (res);
+  }
+  report ("copy and modify", start, allocs);
+
+  allocs = get_allocs ();
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_ITERATIONS; i++) {
+    res = gst_caps_intersect (decoder, compositor);
+    gst_caps_unref (res);
+  }
+  report ("intersect", start, allocs);
+
+  allocs = get_allocs ();
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_ITERATIONS; i++) {
+    res = gst_caps_intersect_full (compositor, filter,
+        GST_CAPS_INTERSECT_FIRST);
+    gst_caps_unref (res);
+  }
+  report ("intersect with filter", start, allocs);
+
+  allocs = get_allocs ();
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_ITERATIONS; i++) {
+    res = gst_caps_copy (compositor);
+    if (!gst_caps_is_subset (res, compositor))
+      g_assert_not_reached ();
+    gst_caps_unref (res);
+  }
+  report ("copy and is_subset", start, allocs);
+
+  allocs = get_allocs ();
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_ITERATIONS; i++) {
+    if (!gst_caps_is_equal (decoder, decoder_copy))
+      g_assert_not_reached ();
+  }
+  report ("is_equal", start, allocs);
+
+  gst_caps_unref (filter);
+  gst_caps_unref (decoder_copy);
+  gst_caps_unref (decoder);
+  gst_caps_unref (compositor);
+
+  return 0;
+}
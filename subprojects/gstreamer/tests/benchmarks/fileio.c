@@ -0,0 +1,203 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Compares the blocking and asynchronous I/O paths of filesink and filesrc.
+ *
+ * For every configuration the sustained throughput is reported together with
+ * the distribution of the time between two buffers on the streaming thread,
+ * which is the time upstream is blocked by the file element. */
+
+#include <stdlib.h>
+#include <glib/gstdio.h>
+#include <gst/gst.h>
+
+#define BUFFER_COUNT (4096)
+#define BUFFER_SIZE (256 * 1024)
+
+typedef struct
+{
+  GstClockTime last;
+  GArray *intervals;
+} Timings;
+
+static GstPadProbeReturn
+buffer_probe (GstPad * pad, GstPadProbeInfo * info, Timings * timings)
+{
+  GstClockTime now = gst_util_get_timestamp ();
+
+  if (GST_CLOCK_TIME_IS_VALID (timings->last)) {
+    GstClockTime diff = now - timings->last;
+    g_array_append_val (timings->intervals, diff);
+  }
+  timings->last = now;
+
+  return GST_PAD_PROBE_OK;
+}
+
+static gint
+compare_times (gconstpointer a, gconstpointer b)
+{
+  GstClockTime ta = *(const GstClockTime *) a;
+  GstClockTime tb = *(const GstClockTime *) b;
+
+  return ta < tb ? -1 : (ta > tb ? 1 : 0);
+}
+
+static GstClockTime
+percentile (GArray * times, gdouble p)
+{
+  guint idx;
+
+  if (times->len == 0)
+    return 0;
+
+  idx = MIN (times->len - 1, (guint) (p * times->len));
+  return g_array_index (times, GstClockTime, idx);
+}
+
+static void
+run (const gchar * desc, GstElement * src, GstElement * sink, guint64 bytes)
+{
+  GstElement *pipeline;
+  GstMessage *msg;
+  GstBus *bus;
+  GstPad *pad;
+  GstClockTime start, end;
+  Timings timings;
+
+  timings.last = GST_CLOCK_TIME_NONE;
+  timings.intervals = g_array_new (FALSE, FALSE, sizeof (GstClockTime));
+
+  pipeline = gst_pipeline_new (NULL);
+  gst_bin_add_many (GST_BIN (pipeline), src, sink, NULL);
+  if (!gst_element_link (src, sink))
+    g_assert_not_reached ();
+
+  pad = gst_element_get_static_pad (src, "src");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+      (GstPadProbeCallback) buffer_probe, &timings, NULL);
+  gst_object_unref (pad);
+
+  bus = gst_element_get_bus (pipeline);
+
+  start = gst_util_get_timestamp ();
+  if (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE)
+    g_assert_not_reached ();
+  msg = gst_bus_poll (bus, GST_MESSAGE_EOS | GST_MESSAGE_ERROR, -1);
+  /* includes flushing out pending writes on EOS */
+  end = gst_util_get_timestamp ();
+
+  if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR) {
+    GError *err = NULL;
+
+    gst_message_parse_error (msg, &err, NULL);
+    g_print ("%-24s error: %s\n", desc, err->message);
+    g_clear_error (&err);
+  } else {
+    g_array_sort (timings.intervals, compare_times);
+
+    g_print ("%-24s %9.1f MB/s  p50 %8.1f us  p99 %8.1f us  "
+        "p99.9 %8.1f us  max %8.1f us\n", desc,
+        (gdouble) bytes / 1e6 / ((gdouble) (end - start) / GST_SECOND),
+        percentile (timings.intervals, 0.5) / 1000.0,
+        percentile (timings.intervals, 0.99) / 1000.0,
+        percentile (timings.intervals, 0.999) / 1000.0,
+        percentile (timings.intervals, 1.0) / 1000.0);
+  }
+  gst_message_unref (msg);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+  g_array_free (timings.intervals, TRUE);
+}
+
+static void
+run_write (const gchar * location, guint buffers, guint size,
+    gboolean io_uring)
+{
+  GstElement *src, *sink;
+
+  src = gst_element_factory_make ("fakesrc", NULL);
+  g_assert (src);
+  g_object_set (src, "num-buffers", buffers, "sizemax", size, NULL);
+  gst_util_set_object_arg (G_OBJECT (src), "sizetype", "fixed");
+
+  sink = gst_element_factory_make ("filesink", NULL);
+  g_assert (sink);
+  g_object_set (sink, "location", location, "io-uring", io_uring, NULL);
+  gst_util_set_object_arg (G_OBJECT (sink), "buffer-mode", "unbuffered");
+
+  run (io_uring ? "filesink io-uring" : "filesink", src, sink,
+      (guint64) buffers * size);
+}
+
+static void
+run_read (const gchar * location, guint buffers, guint size,
+    const gchar * read_mode)
+{
+  GstElement *src, *sink;
+  gchar *desc;
+
+  src = gst_element_factory_make ("filesrc", NULL);
+  g_assert (src);
+  g_object_set (src, "location", location, "blocksize", size, NULL);
+  gst_util_set_object_arg (G_OBJECT (src), "read-mode", read_mode);
+
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_assert (sink);
+  g_object_set (sink, "sync", FALSE, NULL);
+
+  desc = g_strdup_printf ("filesrc %s", read_mode);
+  run (desc, src, sink, (guint64) buffers * size);
+  g_free (desc);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  guint buffers = BUFFER_COUNT, size = BUFFER_SIZE;
+  gchar *location;
+
+  gst_init (&argc, &argv);
+
+  if (argc > 1)
+    buffers = atoi (argv[1]);
+  if (argc > 2)
+    size = atoi (argv[2]);
+  if (argc > 3)
+    location = g_strdup (argv[3]);
+  else
+    location = g_build_filename (g_get_tmp_dir (), "gst-fileio-bench", NULL);
+
+  g_print ("*** %u buffers of %u bytes to %s\n", buffers, size, location);
+
+  run_write (location, buffers, size, FALSE);
+  run_write (location, buffers, size, TRUE);
+
+  run_read (location, buffers, size, "read");
+  run_read (location, buffers, size, "mmap");
+  run_read (location, buffers, size, "direct");
+  run_read (location, buffers, size, "io-uring");
+
+  g_unlink (location);
+  g_free (location);
+
+  return 0;
+}
@@ -0,0 +1,156 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Measures acquire/release pairs per second on a single GstBufferPool shared
+ * by 1 to 32 threads.
+ *
+ * The pool is configured once with enough buffers for every thread and once
+ * with fewer buffers than threads, so that the second run also exercises the
+ * path where acquiring threads have to wait for a release. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gst/gst.h>
+
+#define BUFFER_SIZE (1400)
+#define MAX_THREADS (32)
+
+static volatile gint running;
+static volatile gint started;
+
+typedef struct
+{
+  GstBufferPool *pool;
+  guint64 pairs;
+} ThreadData;
+
+static gpointer
+run_test (gpointer user_data)
+{
+  ThreadData *data = user_data;
+  GstBuffer *buf;
+  guint64 pairs = 0;
+
+  g_atomic_int_inc (&started);
+  while (!g_atomic_int_get (&running))
+    g_thread_yield ();
+
+  while (g_atomic_int_get (&running)) {
+    if (gst_buffer_pool_acquire_buffer (data->pool, &buf,
+            NULL) != GST_FLOW_OK)
+      break;
+    gst_buffer_unref (buf);
+    pairs++;
+  }
+  data->pairs = pairs;
+
+  return NULL;
+}
+
+static GstBufferPool *
+create_pool (guint max_buffers)
+{
+  GstBufferPool *pool;
+  GstStructure *conf;
+
+  pool = gst_buffer_pool_new ();
+  conf = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (conf, NULL, BUFFER_SIZE, 0, max_buffers);
+  gst_buffer_pool_set_config (pool, conf);
+  gst_buffer_pool_set_active (pool, TRUE);
+
+  return pool;
+}
+
+static void
+run_threads (guint num_threads, guint max_buffers, gulong duration_ms)
+{
+  GThread *threads[MAX_THREADS];
+  ThreadData data[MAX_THREADS];
+  GstBufferPool *pool;
+  GstClockTime start, end;
+  guint64 total = 0;
+  gdouble secs;
+  guint t;
+
+  pool = create_pool (max_buffers);
+
+  g_atomic_int_set (&running, 0);
+  g_atomic_int_set (&started, 0);
+
+  for (t = 0; t < num_threads; t++) {
+    data[t].pool = pool;
+    data[t].pairs = 0;
+    threads[t] = g_thread_new ("poolstress", run_test, &data[t]);
+  }
+  while ((guint) g_atomic_int_get (&started) < num_threads)
+    g_thread_yield ();
+
+  start = gst_util_get_timestamp ();
+  g_atomic_int_set (&running, 1);
+  g_usleep (duration_ms * 1000);
+  g_atomic_int_set (&running, 0);
+
+  for (t = 0; t < num_threads; t++) {
+    g_thread_join (threads[t]);
+    total += data[t].pairs;
+  }
+  end = gst_util_get_timestamp ();
+
+  secs = (gdouble) GST_CLOCK_DIFF (start, end) / GST_SECOND;
+  g_print ("%7u %11u %15.0f %15.0f\n", num_threads, max_buffers,
+      total / secs, total / secs / num_threads);
+
+  gst_buffer_pool_set_active (pool, FALSE);
+  gst_object_unref (pool);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  gulong duration_ms = 1000;
+  guint num_threads;
+
+  gst_init (&argc, &argv);
+
+  if (argc > 2) {
+    g_print ("usage: %s [duration-ms]\n", argv[0]);
+    exit (-1);
+  }
+
+  if (argc == 2)
+    duration_ms = strtoul (argv[1], NULL, 10);
+
+  if (duration_ms == 0) {
+    g_print ("duration must be greater than 0\n");
+    exit (-2);
+  }
+
+  g_print ("%7s %11s %15s %15s\n", "threads", "max-buffers", "pairs/s",
+      "pairs/s/thread");
+
+  for (num_threads = 1; num_threads <= MAX_THREADS; num_threads *= 2) {
+    /* enough buffers, acquire never has to wait */
+    run_threads (num_threads, num_threads, duration_ms);
+    /* exhausted pool, half of the threads wait at any time */
+    if (num_threads > 1)
+      run_threads (num_threads, num_threads / 2, duration_ms);
+  }
+
+  return 0;
+}
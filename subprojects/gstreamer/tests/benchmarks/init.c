@@ -19,13 +19,117 @@
  * Boston, MA 02110-1301, USA.
  */
 
+/* Reports how long gst_init() takes and how much memory the process uses
+ * afterwards. Looking up a factory, listing factories by klass and
+ * querying typefinder caps is timed as well, as these can parse data from
+ * the registry cache that gst_init() did not parse.
+ *
+ * Run with an up-to-date registry, e.g. twice in a row, to measure loading
+ * the cache instead of rebuilding it. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
 
+#include <string.h>
 #include <gst/gst.h>
 
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+
+/* resident set size in kB, or -1 if unknown */
+static gint64
+get_rss (void)
+{
+#ifdef __linux__
+  gchar *status = NULL;
+  gint64 rss = -1;
+  gchar *line;
+
+  if (g_file_get_contents ("/proc/self/status", &status, NULL, NULL)) {
+    if ((line = strstr (status, "VmRSS:")))
+      rss = g_ascii_strtoll (line + strlen ("VmRSS:"), NULL, 10);
+    g_free (status);
+  }
+  return rss;
+#else
+  return -1;
+#endif
+}
+
+/* peak resident set size in kB, or -1 if unknown */
+static gint64
+get_max_rss (void)
+{
+#if defined(HAVE_GETRUSAGE) && defined(HAVE_SYS_RESOURCE_H)
+  struct rusage usage;
+
+  if (getrusage (RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+  }
+#endif
+  return -1;
+}
+
+static void
+print_step (const gchar * step, GstClockTime start)
+{
+  GstClockTime elapsed = gst_util_get_timestamp () - start;
+
+  g_print ("%-28s %10.3f ms  rss %8" G_GINT64_FORMAT " kB\n", step,
+      (gdouble) elapsed / GST_MSECOND, get_rss ());
+}
+
 gint
 main (gint argc, gchar * argv[])
 {
+  GstClockTime start;
+  GstElementFactory *factory;
+  GList *factories, *l;
+  guint n_caps = 0;
+  gint64 rss_before;
+
+  rss_before = get_rss ();
+
+  start = g_get_monotonic_time () * GST_USECOND;
   gst_init (&argc, &argv);
+  g_print ("%-28s %10.3f ms  rss %8" G_GINT64_FORMAT " kB (%" G_GINT64_FORMAT
+      " kB before)\n", "gst_init",
+      (gdouble) (g_get_monotonic_time () * GST_USECOND - start) / GST_MSECOND,
+      get_rss (), rss_before);
+
+  start = gst_util_get_timestamp ();
+  factory = gst_element_factory_find ("fakesrc");
+  if (factory) {
+    gst_element_factory_get_metadata (factory, GST_ELEMENT_METADATA_LONGNAME);
+    gst_object_unref (factory);
+  }
+  print_step ("find factory", start);
+
+  start = gst_util_get_timestamp ();
+  factories = gst_element_factory_list_get_elements
+      (GST_ELEMENT_FACTORY_TYPE_DECODER, GST_RANK_MARGINAL);
+  print_step ("list decoders by klass", start);
+  g_print ("  %u decoders\n", g_list_length (factories));
+  gst_plugin_feature_list_free (factories);
+
+  start = gst_util_get_timestamp ();
+  factories = gst_type_find_factory_get_list ();
+  for (l = factories; l; l = l->next) {
+    if (gst_type_find_factory_get_caps (l->data))
+      n_caps++;
+  }
+  print_step ("typefinder caps", start);
+  g_print ("  %u typefinders with caps\n", n_caps);
+  gst_plugin_feature_list_free (factories);
+
+  g_print ("%-28s %10s     max %8" G_GINT64_FORMAT " kB\n", "peak rss", "",
+      get_max_rss ());
 
   return 0;
 }
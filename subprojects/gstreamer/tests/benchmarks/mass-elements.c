@@ -24,6 +24,86 @@
 #define BUFFER_COUNT (1000)
 #define SRC_ELEMENT "fakesrc"
 #define SINK_ELEMENT "fakesink"
+#define BRANCH_COUNT (100)
+/* in microseconds */
+#define SETUP_TIME (10000)
+
+/* a source that takes SETUP_TIME to go to PAUSED, like one that opens a
+ * device or a socket */
+typedef GstElement BenchSlowSrc;
+typedef GstElementClass BenchSlowSrcClass;
+
+static GType bench_slow_src_get_type (void);
+G_DEFINE_TYPE (BenchSlowSrc, bench_slow_src, GST_TYPE_ELEMENT);
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC, GST_PAD_ALWAYS, GST_STATIC_CAPS_ANY);
+
+static GstStateChangeReturn
+bench_slow_src_change_state (GstElement * element, GstStateChange transition)
+{
+  if (transition == GST_STATE_CHANGE_READY_TO_PAUSED)
+    g_usleep (SETUP_TIME);
+
+  return GST_ELEMENT_CLASS (bench_slow_src_parent_class)->change_state
+      (element, transition);
+}
+
+static void
+bench_slow_src_class_init (BenchSlowSrcClass * klass)
+{
+  klass->change_state = bench_slow_src_change_state;
+
+  gst_element_class_add_static_pad_template (klass, &src_template);
+  gst_element_class_set_static_metadata (klass, "Slow source",
+      "Source", "Takes a while to start", "GStreamer");
+}
+
+static void
+bench_slow_src_init (BenchSlowSrc * src)
+{
+  gst_element_add_pad (src,
+      gst_pad_new_from_static_template (&src_template, "src"));
+  GST_OBJECT_FLAG_SET (src, GST_ELEMENT_FLAG_SOURCE);
+}
+
+/* times the state change to PAUSED of @branches independent slow sources,
+ * with @threads state change threads */
+static void
+run_branches (guint branches, guint threads)
+{
+  GstElement *pipeline, *src, *sink;
+  GstClockTime start, end;
+  guint i;
+
+  pipeline = gst_element_factory_make ("pipeline", NULL);
+  g_assert (pipeline);
+  g_object_set (pipeline, "state-change-threads", threads, NULL);
+  for (i = 0; i < branches; i++) {
+    src = g_object_new (bench_slow_src_get_type (), NULL);
+    sink = gst_element_factory_make ("fakesink", NULL);
+    g_assert (sink);
+    /* the sources don't produce data, so don't wait for a preroll */
+    g_object_set (sink, "async", FALSE, NULL);
+    gst_bin_add_many (GST_BIN (pipeline), src, sink, NULL);
+    if (!gst_element_link (src, sink))
+      g_assert_not_reached ();
+  }
+
+  start = gst_util_get_timestamp ();
+  if (gst_element_set_state (pipeline,
+          GST_STATE_PAUSED) == GST_STATE_CHANGE_FAILURE)
+    g_assert_not_reached ();
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - setting %u slow branches to paused with "
+      "%u state change threads\n", GST_TIME_ARGS (end - start), branches,
+      threads);
+
+  if (gst_element_set_state (pipeline,
+          GST_STATE_NULL) != GST_STATE_CHANGE_SUCCESS)
+    g_assert_not_reached ();
+  gst_object_unref (pipeline);
+}
 
 
 gint
@@ -32,6 +112,7 @@ main (gint argc, gchar * argv[])
   GstMessage *msg;
   GstElement *pipeline, *src, *sink, *current, *last;
   guint i, buffers = BUFFER_COUNT, identities = IDENTITY_COUNT;
+  guint branches = BRANCH_COUNT;
   GstClockTime start, end;
   const gchar *src_name = SRC_ELEMENT, *sink_name = SINK_ELEMENT;
 
@@ -45,6 +126,8 @@ main (gint argc, gchar * argv[])
     src_name = argv[3];
   if (argc > 4)
     sink_name = argv[4];
+  if (argc > 5)
+    branches = atoi (argv[5]);
 
   g_print
       ("*** benchmarking this pipeline: %s num-buffers=%u ! %u * identity ! %s\n",
@@ -114,5 +197,9 @@ main (gint argc, gchar * argv[])
   g_print ("%" GST_TIME_FORMAT " - unreffing pipeline\n",
       GST_TIME_ARGS (end - start));
 
+  /* 0 is as many threads as there are processors */
+  run_branches (branches, 1);
+  run_branches (branches, 0);
+
   return 0;
 }
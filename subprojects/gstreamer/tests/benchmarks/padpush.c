@@ -0,0 +1,153 @@
+/* GStreamer
+ *
+ * padpush.c: benchmark for pushing buffers over a linked pad pair
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Reports the time per gst_pad_push() and gst_pad_push_list() call between
+ * two pads whose chain function does nothing, once in the steady state and
+ * once with a probe installed on the source pad, which makes every push take
+ * the locked path. */
+
+#include <stdlib.h>
+#include <gst/gst.h>
+
+#define DEFAULT_ITERATIONS 1000000
+#define LIST_SIZE 16
+
+static GstFlowReturn
+chain_func (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  gst_buffer_unref (buffer);
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+chain_list_func (GstPad * pad, GstObject * parent, GstBufferList * list)
+{
+  gst_buffer_list_unref (list);
+  return GST_FLOW_OK;
+}
+
+static GstPadProbeReturn
+probe_func (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  return GST_PAD_PROBE_OK;
+}
+
+static void
+report (const gchar * name, GstClockTime start, guint iterations,
+    guint buffers_per_push)
+{
+  GstClockTime elapsed = gst_util_get_timestamp () - start;
+
+  g_print ("%-24s %10.1f ns/push %10.1f ns/buffer\n", name,
+      (gdouble) elapsed / iterations,
+      (gdouble) elapsed / iterations / buffers_per_push);
+}
+
+static void
+run (GstPad * src, const gchar * name, guint iterations)
+{
+  GstBuffer *buffer;
+  GstBufferList *list;
+  GstClockTime start;
+  gchar *list_name;
+  guint i;
+
+  buffer = gst_buffer_new_allocate (NULL, 160, NULL);
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < iterations; i++) {
+    if (gst_pad_push (src, gst_buffer_ref (buffer)) != GST_FLOW_OK)
+      g_assert_not_reached ();
+  }
+  report (name, start, iterations, 1);
+  gst_buffer_unref (buffer);
+
+  list = gst_buffer_list_new_sized (LIST_SIZE);
+  for (i = 0; i < LIST_SIZE; i++)
+    gst_buffer_list_add (list, gst_buffer_new_allocate (NULL, 160, NULL));
+  list_name = g_strdup_printf ("%s, lists", name);
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < iterations / LIST_SIZE; i++) {
+    if (gst_pad_push_list (src, gst_buffer_list_ref (list)) != GST_FLOW_OK)
+      g_assert_not_reached ();
+  }
+  report (list_name, start, iterations / LIST_SIZE, LIST_SIZE);
+  g_free (list_name);
+  gst_buffer_list_unref (list);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  GstElement *upstream, *downstream;
+  GstPad *src, *sink;
+  GstSegment segment;
+  guint iterations = DEFAULT_ITERATIONS;
+  gulong id;
+
+  gst_init (&argc, &argv);
+
+  if (argc > 2) {
+    g_print ("usage: %s [iterations]\n", argv[0]);
+    exit (-1);
+  }
+
+  if (argc == 2)
+    iterations = strtoul (argv[1], NULL, 10);
+
+  if (iterations < LIST_SIZE) {
+    g_print ("iterations must be at least %d\n", LIST_SIZE);
+    exit (-2);
+  }
+
+  /* the pads need a parent, like they would have in a pipeline */
+  upstream = gst_bin_new ("upstream");
+  downstream = gst_bin_new ("downstream");
+
+  src = gst_pad_new ("src", GST_PAD_SRC);
+  sink = gst_pad_new ("sink", GST_PAD_SINK);
+  gst_pad_set_chain_function (sink, chain_func);
+  gst_pad_set_chain_list_function (sink, chain_list_func);
+  gst_element_add_pad (upstream, src);
+  gst_element_add_pad (downstream, sink);
+
+  gst_pad_set_active (sink, TRUE);
+  gst_pad_set_active (src, TRUE);
+  gst_pad_link (src, sink);
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (src, gst_event_new_stream_start ("padpush"));
+  gst_pad_push_event (src, gst_event_new_caps (gst_caps_new_empty_simple
+          ("audio/x-raw")));
+  gst_pad_push_event (src, gst_event_new_segment (&segment));
+
+  run (src, "steady state", iterations);
+
+  id = gst_pad_add_probe (src, GST_PAD_PROBE_TYPE_BUFFER |
+      GST_PAD_PROBE_TYPE_BUFFER_LIST, probe_func, NULL, NULL);
+  run (src, "with probe", iterations);
+  gst_pad_remove_probe (src, id);
+
+  gst_pad_set_active (src, FALSE);
+  gst_pad_set_active (sink, FALSE);
+  gst_object_unref (upstream);
+  gst_object_unref (downstream);
+
+  return 0;
+}
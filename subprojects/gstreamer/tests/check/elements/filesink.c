@@ -219,7 +219,8 @@ create_temporary_file (void)
 
 /* TODO: we don't check that the data is actually written to the right
  * position after a seek */
-GST_START_TEST (test_seeking)
+static void
+check_seeking (gboolean io_uring)
 {
   GstElement *filesink;
   gchar *tmp_fn;
@@ -233,7 +234,7 @@ GST_START_TEST (test_seeking)
   sync_buffers = TRUE;
 
   GST_LOG ("using temp file '%s'", tmp_fn);
-  g_object_set (filesink, "location", tmp_fn, NULL);
+  g_object_set (filesink, "location", tmp_fn, "io-uring", io_uring, NULL);
 
   fail_unless_equals_int (gst_element_set_state (filesink, GST_STATE_PLAYING),
       GST_STATE_CHANGE_ASYNC);
@@ -328,6 +329,19 @@ GST_START_TEST (test_seeking)
   g_free (tmp_fn);
 }
 
+GST_START_TEST (test_seeking)
+{
+  check_seeking (FALSE);
+}
+
+GST_END_TEST;
+
+/* falls back to blocking writes if io_uring is not available */
+GST_START_TEST (test_seeking_io_uring)
+{
+  check_seeking (TRUE);
+}
+
 GST_END_TEST;
 
 GST_START_TEST (test_flush)
@@ -486,7 +500,7 @@ GST_START_TEST (test_uri_interface)
 GST_END_TEST;
 
 static void
-test_buffered_write (guint num_buf, guint num_mem_per_buf)
+test_buffered_write (guint num_buf, guint num_mem_per_buf, gboolean io_uring)
 {
   GstElement *filesink;
   guint i, j;
@@ -501,7 +515,7 @@ test_buffered_write (guint num_buf, guint num_mem_per_buf)
     return;
 
   filesink = setup_filesink ();
-  g_object_set (filesink, "location", tmp_fn, NULL);
+  g_object_set (filesink, "location", tmp_fn, "io-uring", io_uring, NULL);
 
   fail_unless_equals_int (gst_element_set_state (filesink, GST_STATE_PLAYING),
       GST_STATE_CHANGE_ASYNC);
@@ -545,7 +559,7 @@ test_buffered_write (guint num_buf, guint num_mem_per_buf)
 
 GST_START_TEST (test_buffered_write_17_1)
 {
-  test_buffered_write (17, 1);
+  test_buffered_write (17, 1, FALSE);
 }
 
 GST_END_TEST;
@@ -553,14 +567,22 @@ GST_END_TEST;
 
 GST_START_TEST (test_buffered_write_9_2)
 {
-  test_buffered_write (9, 2);
+  test_buffered_write (9, 2, FALSE);
 }
 
 GST_END_TEST;
 
 GST_START_TEST (test_buffered_write_6_3)
 {
-  test_buffered_write (6, 3);
+  test_buffered_write (6, 3, FALSE);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_buffered_write_io_uring)
+{
+  test_buffered_write (17, 1, TRUE);
+  test_buffered_write (6, 3, TRUE);
 }
 
 GST_END_TEST;
@@ -576,10 +598,12 @@ filesink_suite (void)
   tcase_add_test (tc_chain, test_coverage);
   tcase_add_test (tc_chain, test_uri_interface);
   tcase_add_test (tc_chain, test_seeking);
+  tcase_add_test (tc_chain, test_seeking_io_uring);
   tcase_add_test (tc_chain, test_flush);
   tcase_add_test (tc_chain, test_buffered_write_17_1);
   tcase_add_test (tc_chain, test_buffered_write_9_2);
   tcase_add_test (tc_chain, test_buffered_write_6_3);
+  tcase_add_test (tc_chain, test_buffered_write_io_uring);
 
   return s;
 }
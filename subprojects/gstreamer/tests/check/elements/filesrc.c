@@ -303,6 +303,139 @@ GST_START_TEST (test_pull)
 
 GST_END_TEST;
 
+static void
+check_pull_read_mode (const gchar * read_mode)
+{
+  GstElement *src;
+  GstPad *pad;
+  GstFlowReturn ret;
+  GstBuffer *buffer;
+  gchar *contents;
+  gsize length;
+  const gsize offsets[] = { 0, 1, 4095, 4096, 5000 };
+  gint i;
+
+  fail_unless (g_file_get_contents (TESTFILE, &contents, &length, NULL));
+  fail_unless (length > 5100);
+
+  src = setup_filesrc ();
+
+  g_object_set (G_OBJECT (src), "location", TESTFILE, NULL);
+  gst_util_set_object_arg (G_OBJECT (src), "read-mode", read_mode);
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_READY) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to ready");
+
+  pad = gst_element_get_static_pad (src, "src");
+  fail_unless (pad != NULL);
+  fail_unless (gst_pad_activate_mode (pad, GST_PAD_MODE_PULL, TRUE));
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  for (i = 0; i < G_N_ELEMENTS (offsets); i++) {
+    buffer = NULL;
+    ret = gst_pad_get_range (pad, offsets[i], 100, &buffer);
+    fail_unless (ret == GST_FLOW_OK);
+    fail_unless (buffer != NULL);
+    fail_unless_equals_int (gst_buffer_get_size (buffer), 100);
+    fail_unless (gst_buffer_memcmp (buffer, 0, contents + offsets[i],
+            100) == 0);
+    fail_unless_equals_uint64 (GST_BUFFER_OFFSET (buffer), offsets[i]);
+    gst_buffer_unref (buffer);
+  }
+
+  /* short read at the end of the file */
+  buffer = NULL;
+  ret = gst_pad_get_range (pad, length - 10, 100, &buffer);
+  fail_unless (ret == GST_FLOW_OK);
+  fail_unless_equals_int (gst_buffer_get_size (buffer), 10);
+  fail_unless (gst_buffer_memcmp (buffer, 0, contents + length - 10, 10) == 0);
+  gst_buffer_unref (buffer);
+
+  /* fill a buffer provided by the caller */
+  buffer = gst_buffer_new_allocate (NULL, 100, NULL);
+  ret = gst_pad_get_range (pad, 10, 100, &buffer);
+  fail_unless (ret == GST_FLOW_OK);
+  fail_unless_equals_int (gst_buffer_get_size (buffer), 100);
+  fail_unless (gst_buffer_memcmp (buffer, 0, contents + 10, 100) == 0);
+  gst_buffer_unref (buffer);
+
+  buffer = NULL;
+  ret = gst_pad_get_range (pad, length + 10, 10, &buffer);
+  fail_unless (ret == GST_FLOW_EOS);
+
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+
+  gst_object_unref (pad);
+  cleanup_filesrc (src);
+  g_free (contents);
+}
+
+GST_START_TEST (test_read_mode_mmap)
+{
+  check_pull_read_mode ("mmap");
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_read_mode_direct)
+{
+  /* falls back to read mode if the file system doesn't support it */
+  check_pull_read_mode ("direct");
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_read_mode_io_uring)
+{
+  /* falls back to read mode if io_uring is not available */
+  check_pull_read_mode ("io-uring");
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_read_mode_mmap_readonly)
+{
+  GstElement *src;
+  GstPad *pad;
+  GstBuffer *buffer = NULL;
+  gchar *contents;
+
+  fail_unless (g_file_get_contents (TESTFILE, &contents, NULL, NULL));
+
+  src = setup_filesrc ();
+
+  g_object_set (G_OBJECT (src), "location", TESTFILE, NULL);
+  gst_util_set_object_arg (G_OBJECT (src), "read-mode", "mmap");
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_READY) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to ready");
+
+  pad = gst_element_get_static_pad (src, "src");
+  fail_unless (gst_pad_activate_mode (pad, GST_PAD_MODE_PULL, TRUE));
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  fail_unless (gst_pad_get_range (pad, 0, 100, &buffer) == GST_FLOW_OK);
+  fail_unless_equals_int (gst_buffer_n_memory (buffer), 1);
+  fail_unless (GST_MEMORY_IS_READONLY (gst_buffer_peek_memory (buffer, 0)));
+
+  /* the mapping must stay valid after the element shut down */
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+  fail_unless (gst_buffer_memcmp (buffer, 0, contents, 100) == 0);
+  gst_buffer_unref (buffer);
+  g_free (contents);
+
+  gst_object_unref (pad);
+  cleanup_filesrc (src);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_coverage)
 {
   GstElement *src;
@@ -554,6 +687,10 @@ filesrc_suite (void)
   tcase_add_test (tc_chain, test_seeking);
   tcase_add_test (tc_chain, test_reverse);
   tcase_add_test (tc_chain, test_pull);
+  tcase_add_test (tc_chain, test_read_mode_mmap);
+  tcase_add_test (tc_chain, test_read_mode_direct);
+  tcase_add_test (tc_chain, test_read_mode_io_uring);
+  tcase_add_test (tc_chain, test_read_mode_mmap_readonly);
   tcase_add_test (tc_chain, test_coverage);
   tcase_add_test (tc_chain, test_uri_interface);
   tcase_add_test (tc_chain, test_uri_query);
@@ -0,0 +1,199 @@
+/* GStreamer
+ *
+ * Unit test for the sampled mode of the latency tracer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/check/gstcheck.h>
+
+#define NUM_BUFFERS 100
+#define SAMPLE_INTERVAL 10
+
+static GstTracer *
+get_tracer_by_name (const gchar * name)
+{
+  GList *tracers, *l;
+  GstTracer *tracer = NULL;
+
+  tracers = gst_tracing_get_active_tracers ();
+  for (l = tracers; l; l = l->next)
+    if (g_strcmp0 (GST_OBJECT_NAME (l->data), name) == 0)
+      tracer = gst_object_ref (l->data);
+
+  g_list_free_full (tracers, gst_object_unref);
+  return tracer;
+}
+
+static GstStructure *
+get_stats (void)
+{
+  GstTracer *tracer = get_tracer_by_name ("latency");
+  GstStructure *stats = NULL;
+
+  fail_unless (tracer);
+  g_signal_emit_by_name (tracer, "get-stats", &stats);
+  gst_object_unref (tracer);
+  fail_unless (stats);
+
+  return stats;
+}
+
+static guint64
+get_histogram_count (const GstStructure * stats, const gchar * element_name,
+    const gchar * histogram)
+{
+  const GValue *elements;
+  const GstStructure *s;
+  GstStructure *hist;
+  guint64 count;
+  guint i;
+
+  elements = gst_structure_get_value (stats, "elements");
+  for (i = 0; i < gst_value_array_get_size (elements); i++) {
+    s = gst_value_get_structure (gst_value_array_get_value (elements, i));
+    if (g_strcmp0 (gst_structure_get_string (s, "element"), element_name))
+      continue;
+
+    fail_unless (gst_structure_get (s, histogram, GST_TYPE_STRUCTURE, &hist,
+            NULL));
+    fail_unless (gst_structure_get_uint64 (hist, "count", &count));
+    gst_structure_free (hist);
+    return count;
+  }
+
+  fail ("no latencies for %s", element_name);
+  return 0;
+}
+
+static guint
+get_pending_samples (const GstStructure * stats)
+{
+  guint pending;
+
+  fail_unless (gst_structure_get_uint (stats, "pending-samples", &pending));
+  return pending;
+}
+
+static void
+run_pipeline (GstElement * pipe)
+{
+  GstMessage *m;
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+  m = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipe), -1, GST_MESSAGE_EOS);
+  gst_message_unref (m);
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+}
+
+GST_START_TEST (test_sampled_pipeline)
+{
+  GstElement *pipe;
+  GstStructure *stats;
+
+  pipe = gst_parse_launch ("fakesrc num-buffers=100 ! identity name=id1 ! "
+      "fakesink name=sink1", NULL);
+  fail_unless (pipe);
+  run_pipeline (pipe);
+
+  stats = get_stats ();
+  fail_unless_equals_uint64 (get_histogram_count (stats, "id1", "processing"),
+      NUM_BUFFERS / SAMPLE_INTERVAL);
+  fail_unless_equals_uint64 (get_histogram_count (stats, "sink1", "latency"),
+      NUM_BUFFERS / SAMPLE_INTERVAL);
+  fail_unless_equals_int (get_pending_samples (stats), 0);
+  gst_structure_free (stats);
+
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
+static GstPadProbeReturn
+drop_first_half (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  guint *count = user_data;
+
+  if (++(*count) <= NUM_BUFFERS / 2)
+    return GST_PAD_PROBE_DROP;
+  return GST_PAD_PROBE_OK;
+}
+
+/* the samples of dropped buffers never finish, they must expire so that the
+ * tracer doesn't keep following them */
+GST_START_TEST (test_sampled_dropped_buffers)
+{
+  GstElement *pipe, *drop;
+  GstStructure *stats;
+  GstPad *pad;
+  guint count = 0;
+
+  /* the pushes of the second half take longer than the sample timeout */
+  pipe = gst_parse_launch ("fakesrc num-buffers=100 ! identity sleep-time=5000 "
+      "! identity name=drop ! fakesink name=sink2", NULL);
+  fail_unless (pipe);
+
+  drop = gst_bin_get_by_name (GST_BIN (pipe), "drop");
+  pad = gst_element_get_static_pad (drop, "sink");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, drop_first_half, &count,
+      NULL);
+  gst_object_unref (pad);
+  gst_object_unref (drop);
+
+  run_pipeline (pipe);
+
+  stats = get_stats ();
+  fail_unless (get_histogram_count (stats, "sink2", "latency") > 0);
+  fail_unless_equals_int (get_pending_samples (stats), 0);
+  gst_structure_free (stats);
+
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
+static Suite *
+latencytracer_suite (void)
+{
+  Suite *s = suite_create ("latencytracer");
+  TCase *tc_chain = tcase_create ("sampled");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_sampled_pipeline);
+  tcase_add_test (tc_chain, test_sampled_dropped_buffers);
+
+  return s;
+}
+
+/* Replacement for GST_CHECK_MAIN (latencytracer); because we need to set the
+ * env before gst_init() is called */
+int
+main (int argc, char **argv)
+{
+  Suite *s;
+
+  g_setenv ("GST_TRACERS",
+      "latency(sample-interval=10,sample-timeout=20,name=latency)", TRUE);
+  gst_check_init (&argc, &argv);
+  s = latencytracer_suite ();
+  return gst_check_run_suite (s, "latencytracer", __FILE__);
+}
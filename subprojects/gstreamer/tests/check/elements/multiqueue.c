@@ -1735,6 +1735,109 @@ GST_START_TEST (test_time_level_before_output)
 
 GST_END_TEST;
 
+#define NUM_SPILLED_BUFFERS 20
+/* buffers that fit in the spill-threshold of the test. One more stays in
+ * memory if the first one was already popped when it arrives */
+#define NUM_RESIDENT_BUFFERS 2
+
+GST_START_TEST (test_spill_to_disk)
+{
+  GstElement *mq;
+  GstPad *sinkpad, *srcpad, *checkpad;
+  GstBuffer *buffer;
+  GstMemory *pushed[NUM_SPILLED_BUFFERS];
+  GstSegment segment;
+  GstCaps *caps;
+  gchar *template;
+  gulong probe_id;
+  GList *l;
+  guint i;
+
+  template = g_build_filename (g_get_tmp_dir (), "multiqueue-XXXXXX", NULL);
+  mq = gst_element_factory_make ("multiqueue", NULL);
+  g_object_set (mq, "max-size-buffers", 0, "max-size-bytes", 0,
+      "max-size-time", (guint64) 0, "temp-template", template,
+      "spill-threshold", (guint64) 1000, NULL);
+
+  sinkpad = gst_element_request_pad_simple (mq, "sink_%u");
+  srcpad = gst_element_get_static_pad (mq, "src_0");
+  checkpad = gst_pad_new ("sink", GST_PAD_SINK);
+  gst_pad_set_chain_function (checkpad, gst_check_chain_func);
+  gst_pad_set_active (checkpad, TRUE);
+  fail_unless (gst_pad_link (srcpad, checkpad) == GST_PAD_LINK_OK);
+
+  /* keep everything in the queue until all buffers were pushed */
+  probe_id = gst_pad_add_probe (srcpad, GST_PAD_PROBE_TYPE_BLOCK_DOWNSTREAM,
+      NULL, NULL, NULL);
+
+  fail_unless (gst_element_set_state (mq,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  gst_pad_send_event (sinkpad, gst_event_new_stream_start ("test"));
+  caps = gst_caps_new_empty_simple ("foo/x-bar");
+  gst_pad_send_event (sinkpad, gst_event_new_caps (caps));
+  gst_caps_unref (caps);
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_send_event (sinkpad, gst_event_new_segment (&segment));
+
+  /* the first buffers stay in memory, the others are spilled */
+  for (i = 0; i < NUM_SPILLED_BUFFERS; i++) {
+    buffer = gst_buffer_new_and_alloc (500);
+    gst_buffer_memset (buffer, 0, i, 500);
+    GST_BUFFER_PTS (buffer) = i * GST_SECOND;
+    GST_BUFFER_DURATION (buffer) = GST_SECOND;
+    pushed[i] = gst_buffer_get_memory (buffer, 0);
+    fail_unless_equals_int (gst_pad_chain (sinkpad, buffer), GST_FLOW_OK);
+  }
+
+  gst_pad_remove_probe (srcpad, probe_id);
+
+  g_mutex_lock (&check_mutex);
+  while (g_list_length (buffers) < NUM_SPILLED_BUFFERS)
+    g_cond_wait (&check_cond, &check_mutex);
+  g_mutex_unlock (&check_mutex);
+
+  for (l = buffers, i = 0; l; l = l->next, i++) {
+    GstMapInfo map;
+    guint j;
+
+    buffer = l->data;
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (buffer), i * GST_SECOND);
+    fail_unless_equals_uint64 (GST_BUFFER_DURATION (buffer), GST_SECOND);
+    fail_unless_equals_int (gst_buffer_n_memory (buffer), 1);
+
+    /* spilled buffers come back with the read-only memory of the file */
+    if (i < NUM_RESIDENT_BUFFERS) {
+      fail_unless (gst_buffer_peek_memory (buffer, 0) == pushed[i]);
+    } else if (i > NUM_RESIDENT_BUFFERS) {
+      fail_unless (gst_buffer_peek_memory (buffer, 0) != pushed[i]);
+      fail_unless (GST_MEMORY_IS_READONLY (gst_buffer_peek_memory (buffer,
+                  0)));
+    }
+    gst_memory_unref (pushed[i]);
+
+    fail_unless (gst_buffer_map (buffer, &map, GST_MAP_READ));
+    fail_unless_equals_int (map.size, 500);
+    for (j = 0; j < map.size; j++)
+      fail_unless_equals_int (map.data[j], i);
+    gst_buffer_unmap (buffer, &map);
+  }
+  gst_check_drop_buffers ();
+
+  fail_unless (gst_element_set_state (mq,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+
+  gst_element_release_request_pad (mq, sinkpad);
+  gst_object_unref (sinkpad);
+  gst_object_unref (srcpad);
+  gst_object_unref (checkpad);
+  gst_object_unref (mq);
+  g_free (template);
+}
+
+GST_END_TEST;
+
 static Suite *
 multiqueue_suite (void)
 {
@@ -1767,6 +1870,7 @@ multiqueue_suite (void)
 
   tcase_add_test (tc_chain, test_stream_status_messages);
   tcase_add_test (tc_chain, test_time_level_before_output);
+  tcase_add_test (tc_chain, test_spill_to_disk);
 
   return s;
 }
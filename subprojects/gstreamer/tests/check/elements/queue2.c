@@ -449,6 +449,260 @@ GST_START_TEST (test_filled_read)
 GST_END_TEST;
 
 
+static gint n_upstream_seeks;
+
+static gboolean
+count_seeks_event (GstPad * pad, GstObject * parent, GstEvent * event)
+{
+  if (GST_EVENT_TYPE (event) == GST_EVENT_SEEK)
+    g_atomic_int_inc (&n_upstream_seeks);
+  gst_event_unref (event);
+
+  return TRUE;
+}
+
+static void
+push_bytes_at (GstPad * sinkpad, guint64 offset, guint8 value, gsize size)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+
+  gst_pad_send_event (sinkpad, gst_event_new_flush_start ());
+  gst_pad_send_event (sinkpad, gst_event_new_flush_stop (FALSE));
+
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  segment.start = offset;
+  fail_unless (gst_pad_send_event (sinkpad, gst_event_new_segment (&segment)));
+
+  buffer = gst_buffer_new_and_alloc (size);
+  gst_buffer_memset (buffer, 0, value, size);
+  GST_BUFFER_OFFSET (buffer) = offset;
+  fail_unless (gst_pad_chain (sinkpad, buffer) == GST_FLOW_OK);
+}
+
+static void
+check_range_read (GstPad * srcpad, guint64 offset, guint8 value)
+{
+  GstBuffer *buffer = NULL;
+  GstMapInfo info;
+  gsize i;
+
+  fail_unless (gst_pad_get_range (srcpad, offset, 1024,
+          &buffer) == GST_FLOW_OK);
+  fail_unless (gst_buffer_map (buffer, &info, GST_MAP_READ));
+  fail_unless_equals_int (info.size, 1024);
+  for (i = 0; i < info.size; i++)
+    fail_unless_equals_int (info.data[i], value);
+  gst_buffer_unmap (buffer, &info);
+  gst_buffer_unref (buffer);
+}
+
+/* data of another range that is still in the ring buffer can be read
+ * without seeking upstream to that range */
+GST_START_TEST (test_ring_buffer_read_other_range)
+{
+  GstElement *queue2;
+  GstPad *sinkpad, *srcpad, *upstream;
+
+  queue2 = gst_element_factory_make ("queue2", NULL);
+  sinkpad = gst_element_get_static_pad (queue2, "sink");
+  srcpad = gst_element_get_static_pad (queue2, "src");
+
+  upstream = gst_pad_new ("src", GST_PAD_SRC);
+  gst_pad_set_event_function (upstream, count_seeks_event);
+  gst_pad_set_active (upstream, TRUE);
+  fail_unless_equals_int (gst_pad_link (upstream, sinkpad), GST_PAD_LINK_OK);
+
+  g_object_set (queue2, "ring-buffer-max-size", (guint64) 64 * 1024,
+      "use-buffering", FALSE,
+      "max-size-buffers", (guint) 0, "max-size-time", (guint64) 0,
+      "max-size-bytes", (guint) 64 * 1024, NULL);
+
+  gst_pad_activate_mode (srcpad, GST_PAD_MODE_PULL, TRUE);
+  gst_element_set_state (queue2, GST_STATE_PLAYING);
+
+  gst_pad_send_event (sinkpad, gst_event_new_stream_start ("test"));
+
+  /* two ranges, upstream now writes to the second one */
+  push_bytes_at (sinkpad, 0, 0xaa, 4 * 1024);
+  push_bytes_at (sinkpad, 100000, 0xbb, 4 * 1024);
+
+  n_upstream_seeks = 0;
+  check_range_read (srcpad, 1024, 0xaa);
+  check_range_read (srcpad, 100000, 0xbb);
+  check_range_read (srcpad, 2048, 0xaa);
+  fail_unless_equals_int (n_upstream_seeks, 0);
+
+  gst_element_set_state (queue2, GST_STATE_NULL);
+
+  gst_pad_set_active (upstream, FALSE);
+  gst_object_unref (upstream);
+  gst_object_unref (sinkpad);
+  gst_object_unref (srcpad);
+  gst_object_unref (queue2);
+}
+
+GST_END_TEST;
+
+static gpointer
+reader_thread (gpointer data)
+{
+  check_range_read (GST_PAD (data), 100000 + 4 * 1024, 0xcc);
+
+  return NULL;
+}
+
+/* request pads read the buffered data at their own offsets without seeking
+ * upstream, and wait for data upstream is about to write */
+GST_START_TEST (test_ring_buffer_concurrent_readers)
+{
+  GstElement *queue2;
+  GstPad *sinkpad, *srcpad, *reader1, *reader2, *upstream;
+  GstBuffer *buffer = NULL;
+  GThread *thread;
+
+  queue2 = gst_element_factory_make ("queue2", NULL);
+  sinkpad = gst_element_get_static_pad (queue2, "sink");
+  srcpad = gst_element_get_static_pad (queue2, "src");
+
+  upstream = gst_pad_new ("src", GST_PAD_SRC);
+  gst_pad_set_event_function (upstream, count_seeks_event);
+  gst_pad_set_active (upstream, TRUE);
+  fail_unless_equals_int (gst_pad_link (upstream, sinkpad), GST_PAD_LINK_OK);
+
+  g_object_set (queue2, "ring-buffer-max-size", (guint64) 64 * 1024,
+      "use-buffering", FALSE,
+      "max-size-buffers", (guint) 0, "max-size-time", (guint64) 0,
+      "max-size-bytes", (guint) 64 * 1024, NULL);
+
+  reader1 = gst_element_request_pad_simple (queue2, "src_%u");
+  reader2 = gst_element_request_pad_simple (queue2, "src_%u");
+  fail_unless (reader1 != NULL);
+  fail_unless (reader2 != NULL);
+
+  gst_pad_activate_mode (srcpad, GST_PAD_MODE_PULL, TRUE);
+  gst_element_set_state (queue2, GST_STATE_PLAYING);
+  fail_unless (gst_pad_activate_mode (reader1, GST_PAD_MODE_PULL, TRUE));
+  fail_unless (gst_pad_activate_mode (reader2, GST_PAD_MODE_PULL, TRUE));
+
+  gst_pad_send_event (sinkpad, gst_event_new_stream_start ("test"));
+
+  push_bytes_at (sinkpad, 0, 0xaa, 4 * 1024);
+  push_bytes_at (sinkpad, 100000, 0xbb, 4 * 1024);
+
+  n_upstream_seeks = 0;
+  check_range_read (reader1, 0, 0xaa);
+  check_range_read (reader2, 100000, 0xbb);
+  check_range_read (srcpad, 101024, 0xbb);
+  check_range_read (reader2, 2048, 0xaa);
+  check_range_read (reader1, 102048, 0xbb);
+  fail_unless_equals_int (n_upstream_seeks, 0);
+
+  /* nothing is buffered there and readers don't seek */
+  fail_unless_equals_int (gst_pad_get_range (reader1, 50000, 1024, &buffer),
+      GST_FLOW_ERROR);
+  fail_unless (buffer == NULL);
+  fail_unless_equals_int (n_upstream_seeks, 0);
+
+  /* a reader just ahead of upstream waits for the data */
+  thread = g_thread_new ("reader", reader_thread, reader2);
+  g_usleep (G_USEC_PER_SEC / 10);
+  buffer = gst_buffer_new_and_alloc (4 * 1024);
+  gst_buffer_memset (buffer, 0, 0xcc, 4 * 1024);
+  fail_unless (gst_pad_chain (sinkpad, buffer) == GST_FLOW_OK);
+  g_thread_join (thread);
+
+  gst_element_release_request_pad (queue2, reader1);
+  gst_object_unref (reader1);
+
+  gst_element_set_state (queue2, GST_STATE_NULL);
+
+  gst_element_release_request_pad (queue2, reader2);
+  gst_object_unref (reader2);
+
+  gst_pad_set_active (upstream, FALSE);
+  gst_object_unref (upstream);
+  gst_object_unref (sinkpad);
+  gst_object_unref (srcpad);
+  gst_object_unref (queue2);
+}
+
+GST_END_TEST;
+
+/* upstream only waits for the "src" pad, a slower reader gets an error for
+ * the data that was overwritten meanwhile but the other pads are not
+ * affected */
+GST_START_TEST (test_ring_buffer_reader_overrun)
+{
+  GstElement *queue2;
+  GstPad *sinkpad, *srcpad, *reader;
+  GstBuffer *buffer = NULL;
+  GstMessage *msg;
+  GstBus *bus;
+  guint64 offset;
+
+  queue2 = gst_element_factory_make ("queue2", NULL);
+  sinkpad = gst_element_get_static_pad (queue2, "sink");
+  srcpad = gst_element_get_static_pad (queue2, "src");
+
+  bus = gst_bus_new ();
+  gst_element_set_bus (queue2, bus);
+
+  g_object_set (queue2, "ring-buffer-max-size", (guint64) 8 * 1024,
+      "use-buffering", FALSE,
+      "max-size-buffers", (guint) 0, "max-size-time", (guint64) 0,
+      "max-size-bytes", (guint) 8 * 1024, NULL);
+
+  reader = gst_element_request_pad_simple (queue2, "src_%u");
+  fail_unless (reader != NULL);
+
+  gst_pad_activate_mode (srcpad, GST_PAD_MODE_PULL, TRUE);
+  gst_element_set_state (queue2, GST_STATE_PLAYING);
+  fail_unless (gst_pad_activate_mode (reader, GST_PAD_MODE_PULL, TRUE));
+
+  gst_pad_send_event (sinkpad, gst_event_new_stream_start ("test"));
+
+  push_bytes_at (sinkpad, 0, 0xaa, 4 * 1024);
+  check_range_read (reader, 0, 0xaa);
+  for (offset = 0; offset < 4 * 1024; offset += 1024)
+    check_range_read (srcpad, offset, 0xaa);
+
+  /* a ring buffer size further, the start of the stream is overwritten */
+  buffer = gst_buffer_new_and_alloc (8 * 1024);
+  gst_buffer_memset (buffer, 0, 0xbb, 8 * 1024);
+  fail_unless (gst_pad_chain (sinkpad, buffer) == GST_FLOW_OK);
+
+  buffer = NULL;
+  fail_unless_equals_int (gst_pad_get_range (reader, 1024, 1024, &buffer),
+      GST_FLOW_ERROR);
+  fail_unless (buffer == NULL);
+
+  msg = gst_bus_pop_filtered (bus, GST_MESSAGE_WARNING | GST_MESSAGE_ERROR);
+  fail_unless (msg != NULL);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_WARNING);
+  fail_unless (GST_MESSAGE_SRC (msg) == GST_OBJECT (queue2));
+  gst_message_unref (msg);
+  fail_unless (gst_bus_pop_filtered (bus, GST_MESSAGE_ERROR) == NULL);
+
+  /* the reader can go on with the data that is still there, and so does the
+   * "src" pad */
+  check_range_read (reader, 8 * 1024, 0xbb);
+  check_range_read (srcpad, 4 * 1024, 0xbb);
+
+  gst_element_set_state (queue2, GST_STATE_NULL);
+
+  gst_element_release_request_pad (queue2, reader);
+  gst_object_unref (reader);
+
+  gst_element_set_bus (queue2, NULL);
+  gst_object_unref (bus);
+  gst_object_unref (sinkpad);
+  gst_object_unref (srcpad);
+  gst_object_unref (queue2);
+}
+
+GST_END_TEST;
+
 static GstPadProbeReturn
 block_callback (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
 {
@@ -936,6 +1190,9 @@ queue2_suite (void)
   tcase_add_test (tc_chain, test_simple_shutdown_while_running_ringbuffer);
   tcase_add_test (tc_chain, test_watermark_and_fill_level);
   tcase_add_test (tc_chain, test_filled_read);
+  tcase_add_test (tc_chain, test_ring_buffer_read_other_range);
+  tcase_add_test (tc_chain, test_ring_buffer_concurrent_readers);
+  tcase_add_test (tc_chain, test_ring_buffer_reader_overrun);
   tcase_add_test (tc_chain, test_percent_overflow);
   tcase_add_test (tc_chain, test_small_ring_buffer);
   tcase_add_test (tc_chain, test_bitrate_query);
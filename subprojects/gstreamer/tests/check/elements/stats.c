@@ -0,0 +1,226 @@
+/* GStreamer
+ *
+ * Unit test for the aggregation mode of the stats tracer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/check/gstcheck.h>
+
+#define NUM_BUFFERS 20
+#define BUFFER_SIZE 100
+/* more than the tracer has slots for */
+#define NUM_THREADS 12
+
+static GstTracer *
+get_tracer_by_name (const gchar * name)
+{
+  GList *tracers, *l;
+  GstTracer *tracer = NULL;
+
+  tracers = gst_tracing_get_active_tracers ();
+  for (l = tracers; l; l = l->next)
+    if (g_strcmp0 (GST_OBJECT_NAME (l->data), name) == 0)
+      tracer = gst_object_ref (l->data);
+
+  g_list_free_full (tracers, gst_object_unref);
+  return tracer;
+}
+
+static GstStructure *
+get_stats (void)
+{
+  GstTracer *tracer = get_tracer_by_name ("stats");
+  GstStructure *stats = NULL;
+
+  fail_unless (tracer);
+  g_signal_emit_by_name (tracer, "get-stats", &stats);
+  gst_object_unref (tracer);
+  fail_unless (stats);
+
+  return stats;
+}
+
+/* the pad @pad_name of the element @element_name, or of no element when
+ * @element_name is %NULL */
+static const GstStructure *
+find_pad (const GstStructure * stats, const gchar * element_name,
+    const gchar * pad_name)
+{
+  const GValue *elements, *pads;
+  const GstStructure *s;
+  guint i, ix, parent_ix = G_MAXUINT;
+
+  if (element_name) {
+    elements = gst_structure_get_value (stats, "elements");
+    for (i = 0; i < gst_value_array_get_size (elements); i++) {
+      s = gst_value_get_structure (gst_value_array_get_value (elements, i));
+      if (g_strcmp0 (gst_structure_get_string (s, "name"), element_name) == 0)
+        fail_unless (gst_structure_get_uint (s, "ix", &parent_ix));
+    }
+    fail_if (parent_ix == G_MAXUINT);
+  }
+
+  pads = gst_structure_get_value (stats, "pads");
+  for (i = 0; i < gst_value_array_get_size (pads); i++) {
+    s = gst_value_get_structure (gst_value_array_get_value (pads, i));
+    fail_unless (gst_structure_get_uint (s, "parent-ix", &ix));
+    if (ix == parent_ix
+        && g_strcmp0 (gst_structure_get_string (s, "name"), pad_name) == 0)
+      return s;
+  }
+
+  return NULL;
+}
+
+static void
+check_pad_counts (const GstStructure * stats, const gchar * element_name,
+    const gchar * pad_name, guint64 n_buffers)
+{
+  const GstStructure *pad;
+  GstStructure *hist;
+  guint64 value;
+
+  pad = find_pad (stats, element_name, pad_name);
+  fail_unless (pad != NULL, "no stats for %s:%s", element_name, pad_name);
+
+  fail_unless (gst_structure_get_uint64 (pad, "buffers", &value));
+  fail_unless_equals_uint64 (value, n_buffers);
+  fail_unless (gst_structure_get_uint64 (pad, "bytes", &value));
+  fail_unless_equals_uint64 (value, n_buffers * BUFFER_SIZE);
+
+  /* every push was timed */
+  fail_unless (gst_structure_get (pad, "processing-time", GST_TYPE_STRUCTURE,
+          &hist, NULL));
+  fail_unless (gst_structure_get_uint64 (hist, "count", &value));
+  fail_unless_equals_uint64 (value, n_buffers);
+  gst_structure_free (hist);
+}
+
+GST_START_TEST (test_aggregate_pipeline)
+{
+  GstElement *pipe;
+  GstMessage *m;
+  GstStructure *stats;
+
+  pipe = gst_parse_launch ("fakesrc name=src num-buffers=20 sizetype=fixed "
+      "sizemax=100 ! queue name=q1 ! queue name=q2 ! fakesink name=sink", NULL);
+  fail_unless (pipe);
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+  m = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipe), -1, GST_MESSAGE_EOS);
+  gst_message_unref (m);
+
+  stats = get_stats ();
+  check_pad_counts (stats, "src", "src", NUM_BUFFERS);
+  check_pad_counts (stats, "q1", "src", NUM_BUFFERS);
+  check_pad_counts (stats, "q2", "src", NUM_BUFFERS);
+  gst_structure_free (stats);
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
+static GstFlowReturn
+drop_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  gst_buffer_unref (buffer);
+  return GST_FLOW_OK;
+}
+
+static gpointer
+push_thread (gpointer data)
+{
+  GstPad *srcpad = data;
+  guint i;
+
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    fail_unless_equals_int (gst_pad_push (srcpad,
+            gst_buffer_new_allocate (NULL, BUFFER_SIZE, NULL)), GST_FLOW_OK);
+  }
+
+  return NULL;
+}
+
+/* the counts stay right with more threads than slots, at the same time and
+ * one after the other */
+GST_START_TEST (test_aggregate_many_threads)
+{
+  GstPad *srcpad, *sinkpad;
+  GThread *threads[NUM_THREADS];
+  GstStructure *stats;
+  guint i;
+
+  srcpad = gst_pad_new ("threadsrc", GST_PAD_SRC);
+  sinkpad = gst_pad_new ("threadsink", GST_PAD_SINK);
+  gst_pad_set_chain_function (sinkpad, drop_chain);
+  fail_unless_equals_int (gst_pad_link (srcpad, sinkpad), GST_PAD_LINK_OK);
+  gst_pad_set_active (srcpad, TRUE);
+  gst_pad_set_active (sinkpad, TRUE);
+
+  for (i = 0; i < NUM_THREADS; i++)
+    threads[i] = g_thread_new ("pusher", push_thread, srcpad);
+  for (i = 0; i < NUM_THREADS; i++)
+    g_thread_join (threads[i]);
+
+  for (i = 0; i < NUM_THREADS; i++)
+    g_thread_join (g_thread_new ("pusher", push_thread, srcpad));
+
+  stats = get_stats ();
+  check_pad_counts (stats, NULL, "threadsrc", 2 * NUM_THREADS * NUM_BUFFERS);
+  gst_structure_free (stats);
+
+  gst_pad_set_active (srcpad, FALSE);
+  gst_pad_set_active (sinkpad, FALSE);
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+}
+
+GST_END_TEST;
+
+static Suite *
+statstracer_suite (void)
+{
+  Suite *s = suite_create ("statstracer");
+  TCase *tc_chain = tcase_create ("aggregate");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_aggregate_pipeline);
+  tcase_add_test (tc_chain, test_aggregate_many_threads);
+
+  return s;
+}
+
+/* Replacement for GST_CHECK_MAIN (statstracer); because we need to set the
+ * env before gst_init() is called */
+int
+main (int argc, char **argv)
+{
+  Suite *s;
+
+  g_setenv ("GST_TRACERS", "stats(aggregate=true,name=stats)", TRUE);
+  gst_check_init (&argc, &argv);
+  s = statstracer_suite ();
+  return gst_check_run_suite (s, "statstracer", __FILE__);
+}
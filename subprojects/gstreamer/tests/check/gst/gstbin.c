@@ -1251,6 +1251,89 @@ GST_START_TEST (test_children_state_change_order_two_sink)
 
 GST_END_TEST;
 
+static gint
+state_change_index (GPtrArray * order, GstElement * element)
+{
+  guint i;
+
+  for (i = 0; i < order->len; i++) {
+    if (g_ptr_array_index (order, i) == element)
+      return i;
+  }
+
+  fail ("no state change message from %s", GST_ELEMENT_NAME (element));
+  return -1;
+}
+
+GST_START_TEST (test_children_state_change_order_parallel)
+{
+  GstElement *src1, *identity, *sink1, *src2, *sink2, *pipeline;
+  GstStateChangeReturn ret;
+  GPtrArray *order;
+  GstMessage *msg;
+  GstBus *bus;
+
+  pipeline = gst_pipeline_new (NULL);
+  fail_unless (pipeline != NULL, "Could not create pipeline");
+  g_object_set (pipeline, "state-change-threads", 4, NULL);
+
+  bus = gst_element_get_bus (pipeline);
+  fail_unless (bus != NULL, "Pipeline has no bus?!");
+
+  src1 = gst_element_factory_make ("fakesrc", NULL);
+  identity = gst_element_factory_make ("identity", NULL);
+  sink1 = gst_element_factory_make ("fakesink", NULL);
+  src2 = gst_element_factory_make ("fakesrc", NULL);
+  sink2 = gst_element_factory_make ("fakesink", NULL);
+  fail_unless (src1 && identity && sink1 && src2 && sink2);
+
+  gst_bin_add_many (GST_BIN (pipeline), src1, identity, sink1, src2, sink2,
+      NULL);
+  fail_unless (gst_element_link_many (src1, identity, sink1, NULL));
+  fail_unless (gst_element_link (src2, sink2));
+
+  ret = gst_element_set_state (pipeline, GST_STATE_READY);
+  fail_if (ret != GST_STATE_CHANGE_SUCCESS, "State change to READY failed");
+
+  /* the branches are changed concurrently, but each element after the
+   * elements downstream of it */
+  order = g_ptr_array_new ();
+  do {
+    msg = gst_bus_poll (bus, GST_MESSAGE_STATE_CHANGED, GST_SECOND);
+    fail_if (msg == NULL, "No state change message within 1 second");
+    g_ptr_array_add (order, GST_MESSAGE_SRC (msg));
+    gst_message_unref (msg);
+  } while (g_ptr_array_index (order, order->len - 1) != pipeline);
+
+  fail_unless_equals_int (order->len, 6);
+  fail_unless (state_change_index (order, sink1) <
+      state_change_index (order, identity));
+  fail_unless (state_change_index (order, identity) <
+      state_change_index (order, src1));
+  fail_unless (state_change_index (order, sink2) <
+      state_change_index (order, src2));
+  g_ptr_array_unref (order);
+
+  ret = gst_element_set_state (pipeline, GST_STATE_PAUSED);
+  fail_if (ret == GST_STATE_CHANGE_FAILURE, "State change to PAUSED failed");
+  ret = gst_element_get_state (pipeline, NULL, NULL, GST_CLOCK_TIME_NONE);
+  fail_unless_equals_int (ret, GST_STATE_CHANGE_SUCCESS);
+
+  ret = gst_element_set_state (pipeline, GST_STATE_NULL);
+  fail_if (ret != GST_STATE_CHANGE_SUCCESS, "State change to NULL failed");
+
+  ASSERT_OBJECT_REFCOUNT (src1, "src1", 1);
+  ASSERT_OBJECT_REFCOUNT (identity, "identity", 1);
+  ASSERT_OBJECT_REFCOUNT (sink1, "sink1", 1);
+  ASSERT_OBJECT_REFCOUNT (src2, "src2", 1);
+  ASSERT_OBJECT_REFCOUNT (sink2, "sink2", 1);
+
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_iterate_sorted)
 {
   GstElement *src, *tee, *identity, *sink1, *sink2, *pipeline, *bin;
@@ -2005,6 +2088,7 @@ gst_bin_suite (void)
   tcase_add_test (tc_chain, test_children_state_change_order_flagged_sink);
   tcase_add_test (tc_chain, test_children_state_change_order_semi_sink);
   tcase_add_test (tc_chain, test_children_state_change_order_two_sink);
+  tcase_add_test (tc_chain, test_children_state_change_order_parallel);
   tcase_add_test (tc_chain, test_message_state_changed);
   tcase_add_test (tc_chain, test_message_state_changed_child);
   tcase_add_test (tc_chain, test_message_state_changed_children);
@@ -336,6 +336,109 @@ GST_START_TEST (test_no_deadlock_for_buffer_discard)
 
 GST_END_TEST;
 
+static gpointer
+acquire_buf (gpointer p)
+{
+  GstBufferPool *pool = p;
+  GstBuffer *buf = NULL;
+  GstFlowReturn ret;
+
+  ret = gst_buffer_pool_acquire_buffer (pool, &buf, NULL);
+  if (buf)
+    gst_buffer_unref (buf);
+
+  return GINT_TO_POINTER (ret);
+}
+
+GST_START_TEST (test_flushing_wakes_up_waiting_acquire)
+{
+  GstBufferPool *pool;
+  GstBuffer *buf;
+  GThread *thread;
+
+  pool = create_pool (10, 1, 1);
+  gst_buffer_pool_set_active (pool, TRUE);
+
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buf,
+          NULL) == GST_FLOW_OK);
+
+  /* the pool is exhausted, the thread blocks until we start flushing */
+  thread = g_thread_new (NULL, acquire_buf, pool);
+  g_usleep (G_USEC_PER_SEC / 100);
+  gst_buffer_pool_set_flushing (pool, TRUE);
+  fail_unless_equals_int (GPOINTER_TO_INT (g_thread_join (thread)),
+      GST_FLOW_FLUSHING);
+
+  gst_buffer_pool_set_flushing (pool, FALSE);
+  gst_buffer_unref (buf);
+
+  /* and the released buffer is handed to the next waiter */
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buf,
+          NULL) == GST_FLOW_OK);
+  thread = g_thread_new (NULL, acquire_buf, pool);
+  g_usleep (G_USEC_PER_SEC / 100);
+  gst_buffer_unref (buf);
+  fail_unless_equals_int (GPOINTER_TO_INT (g_thread_join (thread)),
+      GST_FLOW_OK);
+
+  gst_buffer_pool_set_active (pool, FALSE);
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
+#define N_STRESS_THREADS 8
+#define N_STRESS_ITERATIONS 10000
+#define N_STRESS_BUFFERS 3
+
+static gint stress_destroyed;
+
+static gpointer
+acquire_release_loop (gpointer p)
+{
+  GstBufferPool *pool = p;
+  GstBuffer *buf;
+  gint i;
+
+  for (i = 0; i < N_STRESS_ITERATIONS; i++) {
+    if (gst_buffer_pool_acquire_buffer (pool, &buf, NULL) != GST_FLOW_OK)
+      return GINT_TO_POINTER (FALSE);
+    if (!gst_mini_object_get_qdata (GST_MINI_OBJECT (buf),
+            g_quark_from_static_string ("TestTracker")))
+      buffer_track_destroy (buf, &stress_destroyed);
+    gst_buffer_unref (buf);
+  }
+
+  return GINT_TO_POINTER (TRUE);
+}
+
+GST_START_TEST (test_multithreaded_acquire_release)
+{
+  GThread *threads[N_STRESS_THREADS];
+  GstBufferPool *pool;
+  gint i;
+
+  /* fewer buffers than threads so that some threads always have to wait */
+  pool = create_pool (10, 0, N_STRESS_BUFFERS);
+  gst_buffer_pool_set_active (pool, TRUE);
+
+  stress_destroyed = 0;
+  for (i = 0; i < N_STRESS_THREADS; i++)
+    threads[i] = g_thread_new (NULL, acquire_release_loop, pool);
+  for (i = 0; i < N_STRESS_THREADS; i++)
+    fail_unless (GPOINTER_TO_INT (g_thread_join (threads[i])));
+
+  /* all buffers were recycled and only freed when deactivating */
+  fail_unless_equals_int (stress_destroyed, 0);
+  gst_buffer_pool_set_active (pool, FALSE);
+  fail_unless (stress_destroyed > 0);
+  fail_unless (stress_destroyed <= N_STRESS_BUFFERS);
+
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_parent_meta)
 {
   GstBufferPool *pool;
@@ -463,6 +566,8 @@ gst_buffer_pool_suite (void)
   tcase_add_test (tc_chain, test_pool_config_validate);
   tcase_add_test (tc_chain, test_flushing_pool_returns_flushing);
   tcase_add_test (tc_chain, test_no_deadlock_for_buffer_discard);
+  tcase_add_test (tc_chain, test_flushing_wakes_up_waiting_acquire);
+  tcase_add_test (tc_chain, test_multithreaded_acquire_release);
   tcase_add_test (tc_chain, test_parent_meta);
   tcase_add_test (tc_chain, test_make_writable_parent_meta);
 
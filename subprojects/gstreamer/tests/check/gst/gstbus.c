@@ -926,6 +926,113 @@ GST_START_TEST (test_single_gsource)
 
 GST_END_TEST;
 
+static gboolean
+count_messages (GstBus * bus, GstMessage * message, guint * p_counter)
+{
+  *p_counter += 1;
+
+  return TRUE;
+}
+
+static void
+check_bus_stats (GstBus * bus, guint64 posted, guint64 dropped)
+{
+  GstStructure *stats;
+  guint64 val;
+
+  stats = gst_bus_get_stats (bus);
+  fail_unless (gst_structure_get_uint64 (stats, "posted", &val));
+  fail_unless_equals_uint64 (val, posted);
+  fail_unless (gst_structure_get_uint64 (stats, "dropped", &val));
+  fail_unless_equals_uint64 (val, dropped);
+  fail_unless (gst_structure_has_field_typed (stats, "coalesced",
+          G_TYPE_UINT64));
+  gst_structure_free (stats);
+}
+
+/* test that messages from many threads arrive in order with coalesced
+ * wakeups and that no wakeup is left pending once the bus is drained */
+GST_START_TEST (test_hammer_bus_coalesced)
+{
+  GThread *threads[NUM_THREADS];
+  GstMessage *messages[64];
+  guint message_ids[NUM_THREADS] = { 0, };
+  guint i, n, total = 0;
+  GPollFD pollfd;
+
+  test_bus = g_object_new (GST_TYPE_BUS, "coalesce-wakeups", TRUE, NULL);
+  gst_object_ref_sink (test_bus);
+
+  for (i = 0; i < NUM_THREADS; i++)
+    threads[i] = g_thread_try_new ("gst-check", pound_bus_with_messages,
+        GINT_TO_POINTER (i), NULL);
+
+  while (total < NUM_THREADS * NUM_MESSAGES) {
+    n = gst_bus_timed_pop_many (test_bus, GST_CLOCK_TIME_NONE, messages,
+        G_N_ELEMENTS (messages));
+    fail_unless (n > 0);
+
+    for (i = 0; i < n; i++) {
+      const GstStructure *s = gst_message_get_structure (messages[i]);
+      gint thread_id, msg_id;
+
+      fail_unless (gst_structure_get_int (s, "thread_id", &thread_id));
+      fail_unless (gst_structure_get_int (s, "msg_id", &msg_id));
+      fail_unless_equals_int (msg_id, message_ids[thread_id]++);
+      gst_message_unref (messages[i]);
+    }
+    total += n;
+  }
+
+  for (i = 0; i < NUM_THREADS; i++)
+    g_thread_join (threads[i]);
+
+  fail_if (gst_bus_have_pending (test_bus));
+  fail_unless_equals_int (gst_bus_pop_many (test_bus, messages,
+          G_N_ELEMENTS (messages)), 0);
+
+  gst_bus_get_pollfd (test_bus, &pollfd);
+  fail_unless_equals_int (g_poll (&pollfd, 1, 0), 0);
+
+  check_bus_stats (test_bus, NUM_THREADS * NUM_MESSAGES, 0);
+
+  gst_object_unref (test_bus);
+}
+
+GST_END_TEST;
+
+/* test that a bus watch handles all queued messages in one dispatch */
+GST_START_TEST (test_watch_coalesced)
+{
+  guint num_messages = 0;
+  guint id;
+
+  test_bus = g_object_new (GST_TYPE_BUS, "coalesce-wakeups", TRUE, NULL);
+  gst_object_ref_sink (test_bus);
+
+  id = gst_bus_add_watch (test_bus, (GstBusFunc) count_messages,
+      &num_messages);
+  fail_if (id == 0);
+
+  send_10_app_messages ();
+
+  fail_unless (g_main_context_iteration (NULL, FALSE));
+  fail_unless_equals_int (num_messages, 10);
+  fail_if (gst_bus_have_pending (test_bus));
+  fail_if (g_main_context_iteration (NULL, FALSE));
+
+  /* messages are dropped while flushing */
+  gst_bus_set_flushing (test_bus, TRUE);
+  send_10_app_messages ();
+  gst_bus_set_flushing (test_bus, FALSE);
+  check_bus_stats (test_bus, 20, 10);
+
+  fail_unless (gst_bus_remove_watch (test_bus));
+  gst_object_unref (test_bus);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_bus_suite (void)
 {
@@ -949,6 +1056,8 @@ gst_bus_suite (void)
   tcase_add_test (tc_chain, test_custom_main_context);
   tcase_add_test (tc_chain, test_async_message);
   tcase_add_test (tc_chain, test_single_gsource);
+  tcase_add_test (tc_chain, test_hammer_bus_coalesced);
+  tcase_add_test (tc_chain, test_watch_coalesced);
   return s;
 }
 
@@ -1842,6 +1842,88 @@ GST_START_TEST (test_fixed)
 
 GST_END_TEST;
 
+GST_START_TEST (test_copy_modify)
+{
+  GstCaps *caps, *copy1, *copy2;
+  GstStructure *s, *s1, *s2;
+
+  caps = gst_caps_from_string ("video/x-raw, format=(string){ I420, NV12 }, "
+      "width=(int)320, height=(int)[ 1, 100 ], framerate=(fraction)25/1");
+
+  copy1 = gst_caps_copy (caps);
+  copy2 = gst_caps_copy (copy1);
+  fail_unless (gst_caps_is_equal (caps, copy1));
+  fail_unless (gst_caps_is_equal (caps, copy2));
+
+  /* modifying a copy doesn't change the others */
+  s1 = gst_caps_get_structure (copy1, 0);
+  gst_structure_set (s1, "width", G_TYPE_INT, 640, NULL);
+  gst_structure_remove_field (s1, "framerate");
+  fail_unless (gst_caps_is_equal (caps, copy2));
+  fail_if (gst_caps_is_equal (caps, copy1));
+
+  s = gst_caps_get_structure (caps, 0);
+  fail_unless (gst_structure_has_field (s, "framerate"));
+  fail_unless_equals_int (g_value_get_int (gst_structure_get_value (s,
+              "width")), 320);
+  fail_unless_equals_int (g_value_get_int (gst_structure_get_value (s1,
+              "width")), 640);
+
+  /* values modified in place through the structure are not shared either */
+  copy1 = gst_caps_make_writable (copy1);
+  s1 = gst_caps_get_structure (copy1, 0);
+  g_value_set_int ((GValue *) gst_structure_get_value (s1, "width"), 800);
+  g_value_set_string ((GValue *)
+      gst_value_list_get_value (gst_structure_get_value (s1, "format"), 0),
+      "YV12");
+  fail_unless_equals_int (g_value_get_int (gst_structure_get_value (s,
+              "width")), 320);
+  fail_unless (gst_caps_is_equal (caps, copy2));
+
+  /* the remaining copy stays valid when the original is modified and freed */
+  gst_structure_fixate_field_nearest_int (s, "height", 50);
+  gst_caps_unref (caps);
+  gst_caps_unref (copy1);
+
+  s2 = gst_caps_get_structure (copy2, 0);
+  fail_unless_equals_int (gst_value_list_get_size (gst_structure_get_value (s2,
+              "format")), 2);
+  fail_unless_equals_string (g_value_get_string (gst_value_list_get_value
+          (gst_structure_get_value (s2, "format"), 1)), "NV12");
+  fail_unless (GST_VALUE_HOLDS_INT_RANGE (gst_structure_get_value (s2,
+              "height")));
+  copy2 = gst_caps_make_writable (copy2);
+  gst_caps_set_simple (copy2, "format", G_TYPE_STRING, "I420", NULL);
+  s2 = gst_caps_get_structure (copy2, 0);
+  fail_unless_equals_string (gst_structure_get_string (s2, "format"), "I420");
+  gst_caps_unref (copy2);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_parse_does_not_intern)
+{
+  GstCaps *caps;
+  GstStructure *s;
+
+  fail_if (g_quark_try_string ("NotAKnownFormat"));
+
+  caps = gst_caps_from_string ("video/x-raw, format=(string)NotAKnownFormat, "
+      "interlace-mode=(string)progressive");
+  s = gst_caps_get_structure (caps, 0);
+  fail_unless_equals_string (gst_structure_get_string (s, "format"),
+      "NotAKnownFormat");
+  /* known values share the interned string */
+  fail_unless (gst_structure_get_string (s, "interlace-mode") ==
+      g_intern_static_string ("progressive"));
+  gst_caps_unref (caps);
+
+  /* parsing doesn't add strings to the table of interned strings */
+  fail_if (g_quark_try_string ("NotAKnownFormat"));
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_caps_suite (void)
 {
@@ -1880,6 +1962,8 @@ gst_caps_suite (void)
   tcase_add_test (tc_chain, test_equality);
   tcase_add_test (tc_chain, test_remains_any);
   tcase_add_test (tc_chain, test_fixed);
+  tcase_add_test (tc_chain, test_copy_modify);
+  tcase_add_test (tc_chain, test_parse_does_not_intern);
 
   return s;
 }
@@ -25,6 +25,7 @@
 
 #include <gst/check/gstcheck.h>
 
+#include <glib/gstdio.h>
 #include <string.h>
 
 #ifndef GST_DISABLE_GST_DEBUG
@@ -437,6 +438,231 @@ GST_START_TEST (info_set_and_unset_multiple)
   fail_unless_equals_int (cat3, GST_LEVEL_WARNING);
 }
 
+GST_END_TEST;
+
+/* layout of the records in a binary log dump, see gst/gstinfo.c */
+typedef struct
+{
+  guint32 size;
+  guint8 level;
+  guint8 flags;
+  guint16 n_args;
+  guint64 ts;
+  guint32 category;
+  guint32 file;
+  guint32 function;
+  guint32 format;
+  gint32 line;
+  guint32 id_len;
+} BinaryLogRecord;
+
+typedef struct
+{
+  guint32 type;
+  guint32 len;
+} BinaryLogArg;
+
+#define BINARY_LOG_ALIGN(s) (((s) + 7) & ~((gsize) 7))
+#define BINARY_LOG_ARG_INT 0
+#define BINARY_LOG_ARG_DOUBLE 1
+#define BINARY_LOG_ARG_STRING 2
+
+typedef struct
+{
+  guint32 type;
+  guint32 len;
+  const guint8 *data;
+} DecodedArg;
+
+static guint32
+read_dump_uint32 (const guint8 ** data)
+{
+  guint32 val;
+
+  memcpy (&val, *data, sizeof (guint32));
+  *data += sizeof (guint32);
+  return val;
+}
+
+/* Returns the number of arguments of the newest record of @format, stored
+ * unformatted, or -1 if there is none */
+static gint
+decode_binary_log_record (const guint8 * data, gsize len,
+    const gchar * format, DecodedArg * args)
+{
+  const guint8 *end = data + len;
+  guint32 n_strings, n_threads, format_id = 0, i;
+  gint n_args = -1;
+
+  /* magic, version, byte order and process id */
+  data += 8 + 3 * sizeof (guint32);
+
+  n_strings = read_dump_uint32 (&data);
+  for (i = 1; i <= n_strings; i++) {
+    guint32 str_len = read_dump_uint32 (&data);
+
+    if (str_len == strlen (format) && memcmp (data, format, str_len) == 0)
+      format_id = i;
+    data += str_len;
+  }
+  fail_unless (format_id != 0);
+
+  n_threads = read_dump_uint32 (&data);
+  for (i = 0; i < n_threads; i++) {
+    const guint8 *records, *records_end;
+    guint64 size;
+
+    memcpy (&size, data + sizeof (guint64), sizeof (guint64));
+    records = data + 2 * sizeof (guint64);
+    records_end = records + size;
+    fail_unless (records_end <= end);
+
+    while (records < records_end) {
+      BinaryLogRecord record;
+      const guint8 *p;
+      guint j;
+
+      memcpy (&record, records, sizeof (BinaryLogRecord));
+      if (record.format == format_id && record.flags == 0) {
+        p = records + sizeof (BinaryLogRecord) +
+            BINARY_LOG_ALIGN (record.id_len);
+        for (j = 0; j < record.n_args; j++) {
+          BinaryLogArg arg;
+
+          memcpy (&arg, p, sizeof (BinaryLogArg));
+          args[j].type = arg.type;
+          args[j].len = arg.len;
+          args[j].data = p + sizeof (BinaryLogArg);
+          p += sizeof (BinaryLogArg) + BINARY_LOG_ALIGN (arg.len);
+        }
+        n_args = record.n_args;
+      }
+      records += record.size;
+    }
+    data = records_end;
+  }
+
+  return n_args;
+}
+
+static gint64
+decoded_arg_int (const DecodedArg * arg)
+{
+  gint64 val;
+
+  fail_unless_equals_int (arg->type, BINARY_LOG_ARG_INT);
+  memcpy (&val, arg->data, sizeof (gint64));
+  return val;
+}
+
+static gdouble
+decoded_arg_double (const DecodedArg * arg)
+{
+  gdouble val;
+
+  fail_unless_equals_int (arg->type, BINARY_LOG_ARG_DOUBLE);
+  memcpy (&val, arg->data, sizeof (gdouble));
+  return val;
+}
+
+static gchar *
+decoded_arg_string (const DecodedArg * arg)
+{
+  fail_unless_equals_int (arg->type, BINARY_LOG_ARG_STRING);
+  return g_strndup ((const gchar *) arg->data, arg->len);
+}
+
+#define BINARY_LOG_VALUES_FORMAT \
+  "int %d, uint64 %" G_GUINT64_FORMAT ", string %s, double %.2f"
+#define BINARY_LOG_PRECISION_FORMAT "fourcc %.4s, prefix %.*s, rest %s"
+
+GST_START_TEST (info_binary_logger)
+{
+  GstElement *e;
+  GError *err = NULL;
+  DecodedArg args[8];
+  gchar *filename, *contents, *str1, *str2, *str3, *expected, *decoded;
+  gchar *unterminated;
+  gsize len;
+  gint fd, i, n_args;
+
+  fd = g_file_open_tmp ("gstinfo-XXXXXX", &filename, NULL);
+  fail_unless (fd >= 0);
+  g_close (fd, NULL);
+
+  /* nothing to dump yet */
+  fail_if (gst_debug_binary_logger_dump (filename, &err));
+  fail_unless (err != NULL);
+  g_clear_error (&err);
+
+  e = gst_element_factory_make ("fakesrc", NULL);
+  gst_debug_set_default_threshold (GST_LEVEL_INFO);
+  gst_debug_add_binary_logger (4096);
+
+  /* enough to wrap around the ring */
+  for (i = 0; i < 200; i++) {
+    GST_INFO (BINARY_LOG_VALUES_FORMAT, -i, G_MAXUINT64, "str", 0.5);
+    GST_INFO ("object %" GST_PTR_FORMAT ", width %*d", e, 5, i);
+    GST_INFO_OBJECT (e, "%s", "with object");
+    GST_INFO ("positional %1$d", i);
+  }
+
+  /* strings limited by a precision don't need to be terminated */
+  unterminated = g_malloc (4);
+  memcpy (unterminated, "abcd", 4);
+  GST_INFO (BINARY_LOG_PRECISION_FORMAT, unterminated, 2, unterminated,
+      "done");
+
+  fail_unless (gst_debug_binary_logger_dump (filename, &err));
+  fail_unless (err == NULL);
+  fail_unless (g_file_get_contents (filename, &contents, &len, NULL));
+  fail_unless (len > 8);
+  fail_unless (memcmp (contents, "GSTBLOG", 8) == 0);
+
+  n_args = decode_binary_log_record ((const guint8 *) contents, len,
+      BINARY_LOG_VALUES_FORMAT, args);
+  fail_unless_equals_int (n_args, 4);
+  str1 = decoded_arg_string (&args[2]);
+  decoded = g_strdup_printf (BINARY_LOG_VALUES_FORMAT,
+      (gint) decoded_arg_int (&args[0]), (guint64) decoded_arg_int (&args[1]),
+      str1, decoded_arg_double (&args[3]));
+  expected = g_strdup_printf (BINARY_LOG_VALUES_FORMAT, -199, G_MAXUINT64,
+      "str", 0.5);
+  fail_unless_equals_string (decoded, expected);
+  g_free (decoded);
+  g_free (expected);
+  g_free (str1);
+
+  n_args = decode_binary_log_record ((const guint8 *) contents, len,
+      BINARY_LOG_PRECISION_FORMAT, args);
+  fail_unless_equals_int (n_args, 4);
+  fail_unless_equals_int (args[0].len, 4);
+  fail_unless_equals_int (args[2].len, 2);
+  str1 = decoded_arg_string (&args[0]);
+  str2 = decoded_arg_string (&args[2]);
+  str3 = decoded_arg_string (&args[3]);
+  decoded = g_strdup_printf (BINARY_LOG_PRECISION_FORMAT, str1,
+      (gint) decoded_arg_int (&args[1]), str2, str3);
+  expected = g_strdup_printf (BINARY_LOG_PRECISION_FORMAT, unterminated, 2,
+      unterminated, "done");
+  fail_unless_equals_string (decoded, "fourcc abcd, prefix ab, rest done");
+  fail_unless_equals_string (decoded, expected);
+  g_free (decoded);
+  g_free (expected);
+  g_free (str1);
+  g_free (str2);
+  g_free (str3);
+  g_free (unterminated);
+  g_free (contents);
+
+  gst_debug_remove_binary_logger ();
+  gst_debug_set_default_threshold (GST_LEVEL_NONE);
+  gst_object_unref (e);
+
+  g_unlink (filename);
+  g_free (filename);
+}
+
 GST_END_TEST;
 #endif
 
@@ -581,6 +807,7 @@ gst_info_suite (void)
   tcase_add_test (tc_chain, info_set_and_unset_multiple);
   tcase_add_test (tc_chain, info_post_gst_init_category_registration);
   tcase_add_test (tc_chain, info_set_and_reset_string);
+  tcase_add_test (tc_chain, info_binary_logger);
 #endif
 
   return s;
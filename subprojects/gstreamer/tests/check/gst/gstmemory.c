@@ -537,6 +537,74 @@ GST_START_TEST (test_alloc_params)
 
 GST_END_TEST;
 
+GST_START_TEST (test_huge_pages)
+{
+  GstAllocator *alloc;
+  GstAllocationParams params;
+  GstMemory *mem[3], *sub, *copy;
+  GstMapInfo info;
+  gsize sizes[3] = { 100, 200 * 1024, 3 * 1024 * 1024 };
+  gsize offset, maxalloc;
+  guint i;
+
+  alloc = gst_allocator_find (GST_ALLOCATOR_HUGE_PAGES);
+  if (alloc == NULL)
+    return;
+
+  gst_allocation_params_init (&params);
+  params.align = 63;
+  params.prefix = 16;
+  params.padding = 16;
+  params.flags = GST_MEMORY_FLAG_ZERO_PREFIXED | GST_MEMORY_FLAG_ZERO_PADDED;
+
+  for (i = 0; i < G_N_ELEMENTS (sizes); i++) {
+    mem[i] = gst_allocator_alloc (alloc, sizes[i], &params);
+    fail_unless (mem[i] != NULL);
+    fail_unless (gst_memory_is_type (mem[i], GST_ALLOCATOR_SYSMEM));
+
+    fail_unless_equals_int (gst_memory_get_sizes (mem[i], &offset, &maxalloc),
+        sizes[i]);
+    fail_unless_equals_int (offset, 16);
+    fail_unless (maxalloc >= sizes[i] + 32);
+
+    fail_unless (gst_memory_map (mem[i], &info, GST_MAP_WRITE));
+    fail_unless (((guintptr) (info.data - 16) & 63) == 0);
+    fail_unless (info.data[-1] == 0);
+    fail_unless (info.data[sizes[i]] == 0);
+    memset (info.data, i + 1, sizes[i]);
+    gst_memory_unmap (mem[i], &info);
+  }
+
+  /* sharing and copying work like for system memory */
+  sub = gst_memory_share (mem[1], 10, 100);
+  fail_unless (gst_memory_map (sub, &info, GST_MAP_READ));
+  fail_unless (info.data[0] == 2 && info.data[99] == 2);
+  gst_memory_unmap (sub, &info);
+  gst_memory_unref (sub);
+
+  copy = gst_memory_copy (mem[2], 0, -1);
+  fail_unless (gst_memory_map (copy, &info, GST_MAP_READ));
+  fail_unless_equals_int (info.size, sizes[2]);
+  fail_unless (info.data[0] == 3 && info.data[sizes[2] - 1] == 3);
+  gst_memory_unmap (copy, &info);
+  gst_memory_unref (copy);
+
+  for (i = 0; i < G_N_ELEMENTS (sizes); i++)
+    gst_memory_unref (mem[i]);
+
+  /* freed blocks are reused */
+  mem[0] = gst_allocator_alloc (alloc, sizes[1], &params);
+  fail_unless (gst_memory_map (mem[0], &info, GST_MAP_READ));
+  fail_unless (info.data[-1] == 0);
+  fail_unless (info.data[sizes[1]] == 0);
+  gst_memory_unmap (mem[0], &info);
+  gst_memory_unref (mem[0]);
+
+  gst_object_unref (alloc);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_lock)
 {
   GstMemory *mem;
@@ -757,6 +825,7 @@ gst_memory_suite (void)
   tcase_add_test (tc_chain, test_map_resize);
   tcase_add_test (tc_chain, test_alloc_params);
   tcase_add_test (tc_chain, test_lock);
+  tcase_add_test (tc_chain, test_huge_pages);
 #ifndef GST_DISABLE_GST_DEBUG
   tcase_add_test (tc_chain, test_no_error_and_no_warning_on_map_failure);
 #endif
@@ -934,6 +934,156 @@ GST_START_TEST (test_push_linked)
 
 GST_END_TEST;
 
+static GstFlowReturn
+push_and_count (GstPad * src, guint expected)
+{
+  GstFlowReturn ret;
+
+  ret = gst_pad_push (src, gst_buffer_new ());
+  fail_unless_equals_int (g_list_length (buffers), expected);
+  gst_check_drop_buffers ();
+
+  return ret;
+}
+
+/* changes done between pushes in the steady state are seen by the next push */
+GST_START_TEST (test_push_linked_steady_state)
+{
+  GstPad *src, *sink;
+  gulong id;
+  gint i;
+
+  sink = gst_pad_new ("sink", GST_PAD_SINK);
+  gst_pad_set_chain_function (sink, gst_check_chain_func);
+  src = gst_pad_new ("src", GST_PAD_SRC);
+
+  gst_pad_set_active (src, TRUE);
+  fail_unless (gst_pad_push_event (src, gst_event_new_stream_start ("test")));
+  fail_unless (gst_pad_push_event (src,
+          gst_event_new_segment (&dummy_segment)));
+  gst_pad_set_active (sink, TRUE);
+  fail_unless (GST_PAD_LINK_SUCCESSFUL (gst_pad_link (src, sink)));
+
+  for (i = 0; i < 3; i++)
+    fail_unless_equals_int (push_and_count (src, 1), GST_FLOW_OK);
+  ASSERT_OBJECT_REFCOUNT (sink, "sink", 1);
+
+  /* a probe added after a few pushes sees the next buffer */
+  id = gst_pad_add_probe (src, GST_PAD_PROBE_TYPE_BUFFER,
+      _probe_handler, GINT_TO_POINTER (GST_PAD_PROBE_DROP), NULL);
+  fail_unless_equals_int (push_and_count (src, 0), GST_FLOW_OK);
+  gst_pad_remove_probe (src, id);
+  fail_unless_equals_int (push_and_count (src, 1), GST_FLOW_OK);
+  fail_unless_equals_int (push_and_count (src, 1), GST_FLOW_OK);
+
+  /* so does a probe on the sink pad */
+  id = gst_pad_add_probe (sink, GST_PAD_PROBE_TYPE_BUFFER,
+      _probe_handler, GINT_TO_POINTER (GST_PAD_PROBE_DROP), NULL);
+  fail_unless_equals_int (push_and_count (src, 0), GST_FLOW_OK);
+  gst_pad_remove_probe (sink, id);
+  fail_unless_equals_int (push_and_count (src, 1), GST_FLOW_OK);
+
+  /* flushing and deactivating */
+  gst_pad_set_active (sink, FALSE);
+  fail_unless_equals_int (push_and_count (src, 0), GST_FLOW_FLUSHING);
+  gst_pad_set_active (sink, TRUE);
+  fail_unless_equals_int (push_and_count (src, 1), GST_FLOW_OK);
+  fail_unless (gst_pad_push_event (src, gst_event_new_flush_start ()));
+  fail_unless_equals_int (push_and_count (src, 0), GST_FLOW_FLUSHING);
+  fail_unless (gst_pad_push_event (src, gst_event_new_flush_stop (TRUE)));
+  fail_unless (gst_pad_push_event (src,
+          gst_event_new_segment (&dummy_segment)));
+  fail_unless_equals_int (push_and_count (src, 1), GST_FLOW_OK);
+  fail_unless_equals_int (push_and_count (src, 1), GST_FLOW_OK);
+
+  /* unlinking, the peer is not kept alive by the pushes */
+  fail_unless (gst_pad_unlink (src, sink));
+  fail_unless_equals_int (push_and_count (src, 0), GST_FLOW_NOT_LINKED);
+  ASSERT_OBJECT_REFCOUNT (sink, "sink", 1);
+
+  gst_object_unref (src);
+  gst_object_unref (sink);
+}
+
+GST_END_TEST;
+
+static gint chained_with_parent;
+
+static GstFlowReturn
+chain_check_parent (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  /* the parent is reffed for the duration of the chain function */
+  fail_unless (GST_IS_ELEMENT (parent));
+  fail_unless (GST_OBJECT_REFCOUNT_VALUE (parent) > 0);
+  g_usleep (100);
+  fail_unless (GST_IS_ELEMENT (parent));
+
+  gst_buffer_unref (buffer);
+  g_atomic_int_inc (&chained_with_parent);
+
+  return GST_FLOW_OK;
+}
+
+static gpointer
+push_until_error (GstPad * src)
+{
+  GstFlowReturn ret;
+
+  do {
+    ret = gst_pad_push (src, gst_buffer_new ());
+  } while (ret == GST_FLOW_OK);
+
+  return GINT_TO_POINTER (ret);
+}
+
+/* removing the sink pad from its element while buffers are pushed in the
+ * steady state, the chain function must never see a freed parent */
+GST_START_TEST (test_push_linked_remove_pad)
+{
+  GstElement *element;
+  GstPad *src, *sink;
+  GThread *thread;
+  GstFlowReturn ret;
+  gint i;
+
+  for (i = 0; i < 20; i++) {
+    element = gst_bin_new (NULL);
+    sink = gst_pad_new ("sink", GST_PAD_SINK);
+    GST_OBJECT_FLAG_SET (sink, GST_PAD_FLAG_NEED_PARENT);
+    gst_pad_set_chain_function (sink, chain_check_parent);
+    src = gst_pad_new ("src", GST_PAD_SRC);
+
+    gst_pad_set_active (src, TRUE);
+    fail_unless (gst_pad_push_event (src,
+            gst_event_new_stream_start ("test")));
+    fail_unless (gst_pad_push_event (src,
+            gst_event_new_segment (&dummy_segment)));
+    gst_pad_set_active (sink, TRUE);
+    fail_unless (gst_element_add_pad (element, gst_object_ref (sink)));
+    fail_unless (GST_PAD_LINK_SUCCESSFUL (gst_pad_link (src, sink)));
+
+    g_atomic_int_set (&chained_with_parent, 0);
+    thread = g_thread_new ("gst-check", (GThreadFunc) push_until_error, src);
+    while (g_atomic_int_get (&chained_with_parent) < 100)
+      g_thread_yield ();
+
+    /* unparents the pad without taking its stream lock, then frees the
+     * element */
+    fail_unless (gst_element_remove_pad (element, sink));
+    gst_object_unref (element);
+
+    ret = GPOINTER_TO_INT (g_thread_join (thread));
+    fail_unless (ret == GST_FLOW_NOT_LINKED || ret == GST_FLOW_FLUSHING);
+    fail_if (GST_OBJECT_PARENT (sink));
+
+    gst_object_unref (src);
+    ASSERT_OBJECT_REFCOUNT (sink, "sink", 1);
+    gst_object_unref (sink);
+  }
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_push_linked_flushing)
 {
   GstPad *src, *sink;
@@ -3413,6 +3563,8 @@ gst_pad_suite (void)
   tcase_add_test (tc_chain, test_name_is_valid);
   tcase_add_test (tc_chain, test_push_unlinked);
   tcase_add_test (tc_chain, test_push_linked);
+  tcase_add_test (tc_chain, test_push_linked_steady_state);
+  tcase_add_test (tc_chain, test_push_linked_remove_pad);
   tcase_add_test (tc_chain, test_push_linked_flushing);
   tcase_add_test (tc_chain, test_push_buffer_list_compat);
   tcase_add_test (tc_chain, test_flowreturn);
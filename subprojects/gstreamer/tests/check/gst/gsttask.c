@@ -464,6 +464,263 @@ GST_START_TEST (test_shared_task_pool_two_threads)
 
 GST_END_TEST;
 
+static gint ws_counter;
+
+static void
+ws_count_cb (gpointer data)
+{
+  g_atomic_int_inc (&ws_counter);
+}
+
+GST_START_TEST (test_work_stealing_task_pool_push)
+{
+  GstTaskPool *pool;
+  gpointer handles[100];
+  GError *err = NULL;
+  guint i;
+
+  pool = gst_work_stealing_task_pool_new ();
+  gst_task_pool_prepare (pool, &err);
+  fail_unless (err == NULL);
+
+  ws_counter = 0;
+  for (i = 0; i < G_N_ELEMENTS (handles); i++) {
+    handles[i] = gst_task_pool_push (pool, ws_count_cb, NULL, &err);
+    fail_unless (err == NULL);
+    fail_unless (handles[i] != NULL);
+  }
+  for (i = 0; i < G_N_ELEMENTS (handles); i++)
+    gst_task_pool_join (pool, handles[i]);
+
+  fail_unless_equals_int (g_atomic_int_get (&ws_counter),
+      G_N_ELEMENTS (handles));
+
+  gst_task_pool_cleanup (pool);
+
+  /* pushing on a cleaned up pool fails */
+  fail_unless (gst_task_pool_push (pool, ws_count_cb, NULL, &err) == NULL);
+  fail_unless (err != NULL);
+  g_clear_error (&err);
+
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
+/* the default pool is shared and can be used right away */
+GST_START_TEST (test_work_stealing_task_pool_default)
+{
+  GstTaskPool *pool;
+  gpointer handle;
+  GError *err = NULL;
+
+  pool = gst_work_stealing_task_pool_get_default ();
+  fail_unless (GST_IS_WORK_STEALING_TASK_POOL (pool));
+  fail_unless (gst_work_stealing_task_pool_get_default () == pool);
+
+  ws_counter = 0;
+  handle = gst_task_pool_push (pool, ws_count_cb, NULL, &err);
+  fail_unless (err == NULL);
+  fail_unless (handle != NULL);
+  gst_task_pool_join (pool, handle);
+
+  fail_unless_equals_int (g_atomic_int_get (&ws_counter), 1);
+}
+
+GST_END_TEST;
+
+#define WS_N_PUSHERS 4
+#define WS_PUSH_BATCH 16
+
+static gint ws_pushed;
+
+/* pushes batches until the pool is cleaned up. Everything that was pushed
+ * successfully must run, so joining it must not hang */
+static gpointer
+ws_pusher_func (GstTaskPool * pool)
+{
+  gpointer handles[WS_PUSH_BATCH];
+  GError *err = NULL;
+  gboolean running = TRUE;
+
+  while (running) {
+    guint i, n = 0;
+
+    for (i = 0; i < WS_PUSH_BATCH; i++) {
+      handles[n] = gst_task_pool_push (pool, ws_count_cb, NULL, &err);
+      if (handles[n] == NULL) {
+        fail_unless (err != NULL);
+        g_clear_error (&err);
+        running = FALSE;
+        break;
+      }
+      n++;
+    }
+    for (i = 0; i < n; i++)
+      gst_task_pool_join (pool, handles[i]);
+    g_atomic_int_add (&ws_pushed, n);
+  }
+
+  return NULL;
+}
+
+/* cleanup races with threads that keep pushing */
+GST_START_TEST (test_work_stealing_task_pool_push_cleanup)
+{
+  GstTaskPool *pool;
+  GThread *pushers[WS_N_PUSHERS];
+  GError *err = NULL;
+  guint i, round;
+
+  pool = gst_work_stealing_task_pool_new ();
+
+  for (round = 0; round < 50; round++) {
+    gst_task_pool_prepare (pool, &err);
+    fail_unless (err == NULL);
+
+    ws_counter = ws_pushed = 0;
+    for (i = 0; i < WS_N_PUSHERS; i++)
+      pushers[i] = g_thread_new ("pusher", (GThreadFunc) ws_pusher_func, pool);
+
+    g_usleep (round % 5 * 100);
+    gst_task_pool_cleanup (pool);
+
+    for (i = 0; i < WS_N_PUSHERS; i++)
+      g_thread_join (pushers[i]);
+
+    fail_unless_equals_int (g_atomic_int_get (&ws_counter),
+        g_atomic_int_get (&ws_pushed));
+  }
+
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
+static gint ws_arrived;
+static gint ws_expected;
+
+static void
+ws_barrier_cb (gpointer data)
+{
+  g_mutex_lock (&task_lock);
+  ws_arrived++;
+  g_cond_broadcast (&task_cond);
+  while (ws_arrived < ws_expected)
+    g_cond_wait (&task_cond, &task_lock);
+  g_mutex_unlock (&task_lock);
+}
+
+/* In this test, we push one blocking function more than the pool has workers.
+ * They can only all return if the pool starts an extra worker */
+GST_START_TEST (test_work_stealing_task_pool_blocking)
+{
+  GstTaskPool *pool;
+  gpointer *handles;
+  GError *err = NULL;
+  gint i;
+
+  g_mutex_init (&task_lock);
+  g_cond_init (&task_cond);
+
+  pool = gst_work_stealing_task_pool_new ();
+  gst_task_pool_prepare (pool, &err);
+  fail_unless (err == NULL);
+
+  ws_arrived = 0;
+  ws_expected = g_get_num_processors () + 1;
+  handles = g_new (gpointer, ws_expected);
+
+  for (i = 0; i < ws_expected; i++) {
+    handles[i] = gst_task_pool_push (pool, ws_barrier_cb, NULL, &err);
+    fail_unless (err == NULL);
+  }
+  for (i = 0; i < ws_expected; i++)
+    gst_task_pool_join (pool, handles[i]);
+
+  fail_unless_equals_int (ws_arrived, ws_expected);
+
+  g_free (handles);
+  gst_task_pool_cleanup (pool);
+  gst_object_unref (pool);
+
+  g_cond_clear (&task_cond);
+  g_mutex_clear (&task_lock);
+}
+
+GST_END_TEST;
+
+static gint ws_entered;
+static gint ws_left;
+
+static void
+ws_enter_cb (GstTask * task, GThread * thread, gpointer user_data)
+{
+  g_atomic_int_inc (&ws_entered);
+}
+
+static void
+ws_leave_cb (GstTask * task, GThread * thread, gpointer user_data)
+{
+  g_atomic_int_inc (&ws_left);
+}
+
+/* A task on a work-stealing pool runs in time slices on the workers, does not
+ * run while paused and can be joined */
+GST_START_TEST (test_work_stealing_task_pool_task)
+{
+  GstTaskPool *pool;
+  GstTask *t;
+  GError *err = NULL;
+  gint count;
+
+  pool = gst_work_stealing_task_pool_new ();
+  gst_work_stealing_task_pool_set_workers_per_core (GST_WORK_STEALING_TASK_POOL
+      (pool), 2);
+  fail_unless_equals_int (gst_work_stealing_task_pool_get_workers_per_core
+      (GST_WORK_STEALING_TASK_POOL (pool)), 2);
+  gst_task_pool_prepare (pool, &err);
+  fail_unless (err == NULL);
+
+  t = gst_task_new (ws_count_cb, NULL, NULL);
+  g_rec_mutex_init (&task_mutex);
+  gst_task_set_lock (t, &task_mutex);
+  gst_task_set_pool (t, pool);
+  gst_task_set_enter_callback (t, ws_enter_cb, NULL, NULL);
+  gst_task_set_leave_callback (t, ws_leave_cb, NULL, NULL);
+
+  ws_counter = ws_entered = ws_left = 0;
+
+  fail_unless (gst_task_start (t));
+  while (g_atomic_int_get (&ws_counter) < 1000)
+    g_usleep (1000);
+
+  /* once the stream lock is ours the task is not in its function */
+  fail_unless (gst_task_pause (t));
+  g_rec_mutex_lock (&task_mutex);
+  g_rec_mutex_unlock (&task_mutex);
+  count = g_atomic_int_get (&ws_counter);
+  g_usleep (G_USEC_PER_SEC / 20);
+  fail_unless_equals_int (g_atomic_int_get (&ws_counter), count);
+
+  fail_unless (gst_task_resume (t));
+  while (g_atomic_int_get (&ws_counter) < count + 1000)
+    g_usleep (1000);
+
+  fail_unless (gst_task_join (t));
+  fail_unless_equals_int (gst_task_get_state (t), GST_TASK_STOPPED);
+  fail_unless_equals_int (g_atomic_int_get (&ws_entered), 1);
+  fail_unless_equals_int (g_atomic_int_get (&ws_left), 1);
+
+  gst_object_unref (t);
+  g_rec_mutex_clear (&task_mutex);
+
+  gst_task_pool_cleanup (pool);
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_task_suite (void)
 {
@@ -480,6 +737,11 @@ gst_task_suite (void)
   tcase_add_test (tc_chain, test_resume);
   tcase_add_test (tc_chain, test_shared_task_pool_shared_thread);
   tcase_add_test (tc_chain, test_shared_task_pool_two_threads);
+  tcase_add_test (tc_chain, test_work_stealing_task_pool_push);
+  tcase_add_test (tc_chain, test_work_stealing_task_pool_default);
+  tcase_add_test (tc_chain, test_work_stealing_task_pool_push_cleanup);
+  tcase_add_test (tc_chain, test_work_stealing_task_pool_blocking);
+  tcase_add_test (tc_chain, test_work_stealing_task_pool_task);
 
   return s;
 }
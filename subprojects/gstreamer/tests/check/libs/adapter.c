@@ -1168,6 +1168,185 @@ GST_START_TEST (test_scan)
 
 GST_END_TEST;
 
+static const guint8 scan_mem0[] = { 0xaa, 0x00, 0x00 };
+static const guint8 scan_mem1[] = { 0x01, 0xb3, 0x55, 0x00 };
+static const guint8 scan_mem2[] = { 0x00, 0x01, 0x65, 0x00, 0x00, 0x00, 0x01,
+  0x41, 0x00
+};
+static const guint8 scan_mem3[] = { 0x00, 0x01, 0x09 };
+
+static GstMemory *
+scan_memory (const guint8 * data, gsize size)
+{
+  return gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY, (gpointer) data,
+      size, 0, size, NULL, NULL);
+}
+
+/* start codes that straddle the memories of a buffer and buffers must be
+ * found without the memories getting merged */
+GST_START_TEST (test_scan_memories)
+{
+  GstAdapter *adapter;
+  GstBuffer *buffer;
+  guint32 value = 0;
+  gssize offset;
+
+  adapter = gst_adapter_new ();
+
+  buffer = gst_buffer_new ();
+  gst_buffer_append_memory (buffer, scan_memory (scan_mem0, 3));
+  gst_buffer_append_memory (buffer, scan_memory (scan_mem1, 4));
+  gst_buffer_append_memory (buffer, scan_memory (scan_mem2, 9));
+  gst_adapter_push (adapter, buffer);
+
+  buffer = gst_buffer_new ();
+  gst_buffer_append_memory (buffer, scan_memory (scan_mem3, 3));
+  gst_adapter_push (adapter, buffer);
+
+  fail_unless_equals_int (gst_adapter_available (adapter), 19);
+
+  /* 0x00 0x00 | 0x01 0xb3 */
+  offset = gst_adapter_find_start_code (adapter, 0, 19, &value);
+  fail_unless_equals_int (offset, 1);
+  fail_unless_equals_int (value, 0x000001b3);
+
+  /* 0x00 | 0x00 0x01 0x65 */
+  offset = gst_adapter_find_start_code (adapter, 2, 17, &value);
+  fail_unless_equals_int (offset, 6);
+  fail_unless_equals_int (value, 0x00000165);
+
+  /* in one memory */
+  offset = gst_adapter_find_start_code (adapter, 7, 12, &value);
+  fail_unless_equals_int (offset, 11);
+  fail_unless_equals_int (value, 0x00000141);
+
+  /* 0x00 | 0x00 0x01 0x09 in the next buffer */
+  offset = gst_adapter_find_start_code (adapter, 12, 7, &value);
+  fail_unless_equals_int (offset, 15);
+  fail_unless_equals_int (value, 0x00000109);
+
+  /* the last byte of the start code is outside of the scanned range */
+  offset = gst_adapter_find_start_code (adapter, 12, 6, NULL);
+  fail_unless_equals_int (offset, -1);
+
+  /* the same for other patterns */
+  offset = gst_adapter_masked_scan_uint32_peek (adapter, 0xffffffff,
+      0x55000001, 0, 19, &value);
+  fail_unless_equals_int (offset, 5);
+  fail_unless_equals_int (value, 0x55000001);
+  offset = gst_adapter_masked_scan_uint32 (adapter, 0xff000000, 0x41000000, 0,
+      19);
+  fail_unless_equals_int (offset, 14);
+
+  /* nothing was merged */
+  buffer = gst_adapter_get_buffer_fast (adapter, 16);
+  fail_unless_equals_int (gst_buffer_n_memory (buffer), 3);
+  gst_buffer_unref (buffer);
+
+  g_object_unref (adapter);
+}
+
+GST_END_TEST;
+
+static gssize
+scan_reference (const guint8 * data, gsize size, guint32 mask,
+    guint32 pattern)
+{
+  gsize i;
+
+  for (i = 0; i + 4 <= size; i++) {
+    if ((GST_READ_UINT32_BE (data + i) & mask) == pattern)
+      return i;
+  }
+
+  return -1;
+}
+
+/* memories long enough for the vector scanners, with start codes at all
+ * positions in and across them */
+GST_START_TEST (test_scan_memories_large)
+{
+  static const gsize mem_sizes[] = { 64, 1, 3, 100, 35, 67, 2, 131 };
+  static const guint32 masks[] = { 0xffffff00, 0xffffffff, 0x00ff0000,
+    0x00f00000, 0x00000001
+  };
+  GstAdapter *adapter;
+  GstBuffer *buffer = NULL;
+  GRand *rand;
+  guint8 *data;
+  gsize size = 0, pos, i;
+  guint m;
+
+  for (i = 0; i < G_N_ELEMENTS (mem_sizes); i++)
+    size += mem_sizes[i];
+
+  rand = g_rand_new_with_seed (0xada9);
+  data = g_malloc (size);
+  for (i = 0; i < size; i++)
+    data[i] = g_rand_int_range (rand, 0, 8) ? 0x80 : 0x00;
+  g_rand_free (rand);
+
+  /* two memories per buffer, the adapter scans the data in place */
+  adapter = gst_adapter_new ();
+  for (i = 0, pos = 0; i < G_N_ELEMENTS (mem_sizes); i++) {
+    if (buffer == NULL)
+      buffer = gst_buffer_new ();
+    gst_buffer_append_memory (buffer, scan_memory (data + pos, mem_sizes[i]));
+    if (i % 2 == 1 || i + 1 == G_N_ELEMENTS (mem_sizes)) {
+      gst_adapter_push (adapter, buffer);
+      buffer = NULL;
+    }
+    pos += mem_sizes[i];
+  }
+  fail_unless_equals_int (gst_adapter_available (adapter), size);
+
+  for (pos = 0; pos + 4 <= size; pos++) {
+    static const guint8 start_code[] = { 0x00, 0x00, 0x01, 0xb5 };
+    guint8 saved[4];
+    gsize offset;
+
+    /* a start code at @pos, found from the offsets before it */
+    memcpy (saved, data + pos, 4);
+    memcpy (data + pos, start_code, 4);
+
+    for (offset = pos >= 40 ? pos - 40 : 0; offset <= pos; offset++) {
+      gssize ref = scan_reference (data + offset, size - offset, 0xffffff00,
+          0x00000100);
+      guint32 value = 0;
+
+      fail_unless_equals_int (gst_adapter_find_start_code (adapter, offset,
+              size - offset, &value), ref + offset);
+      fail_unless_equals_int (value, GST_READ_UINT32_BE (data + ref + offset));
+    }
+
+    memcpy (data + pos, saved, 4);
+  }
+
+  for (m = 0; m < G_N_ELEMENTS (masks); m++) {
+    guint32 pattern = GST_READ_UINT32_BE (data + size / 2) & masks[m];
+    gsize offset;
+
+    for (offset = 0; offset + 4 <= size; offset += 7) {
+      gssize ref = scan_reference (data + offset, size - offset, masks[m],
+          pattern);
+
+      fail_unless_equals_int (gst_adapter_masked_scan_uint32 (adapter,
+              masks[m], pattern, offset, size - offset),
+          ref == -1 ? -1 : ref + offset);
+    }
+  }
+
+  /* nothing was merged */
+  buffer = gst_adapter_get_buffer_fast (adapter, mem_sizes[0] + mem_sizes[1]);
+  fail_unless_equals_int (gst_buffer_n_memory (buffer), 2);
+  gst_buffer_unref (buffer);
+
+  g_object_unref (adapter);
+  g_free (data);
+}
+
+GST_END_TEST;
+
 /* Fill a buffer with a sequence of 32 bit ints and read them back out
  * using take_buffer, checking that they're still in the right order */
 GST_START_TEST (test_take_list)
@@ -1465,6 +1644,8 @@ gst_adapter_suite (void)
   tcase_add_test (tc_chain, test_take_buf_order);
   tcase_add_test (tc_chain, test_timestamp);
   tcase_add_test (tc_chain, test_scan);
+  tcase_add_test (tc_chain, test_scan_memories);
+  tcase_add_test (tc_chain, test_scan_memories_large);
   tcase_add_test (tc_chain, test_take_list);
   tcase_add_test (tc_chain, test_get_list);
   tcase_add_test (tc_chain, test_take_buffer_list);
@@ -1454,6 +1454,58 @@ GST_START_TEST (test_force_live)
 
 GST_END_TEST;
 
+static gboolean
+prepare_pad_count (GstElement * agg, GstPad * pad, gpointer user_data)
+{
+  g_atomic_int_inc ((gint *) user_data);
+  g_object_set_data (G_OBJECT (pad), "prepared", GINT_TO_POINTER (1));
+
+  return TRUE;
+}
+
+static gboolean
+prepare_pad_fail (GstElement * agg, GstPad * pad, gpointer user_data)
+{
+  g_atomic_int_inc ((gint *) user_data);
+
+  return FALSE;
+}
+
+GST_START_TEST (test_prepare_sink_pads)
+{
+  GstElement *agg;
+  GList *l;
+  gint count;
+  guint i, threads[] = { 1, 4 };
+
+  agg = gst_check_setup_element ("testaggregator");
+  for (i = 0; i < 8; i++)
+    gst_object_unref (gst_element_request_pad_simple (agg, "sink_%u"));
+
+  for (i = 0; i < G_N_ELEMENTS (threads); i++) {
+    g_object_set (agg, "prepare-threads", threads[i], NULL);
+
+    count = 0;
+    fail_unless (gst_aggregator_prepare_sink_pads (GST_AGGREGATOR (agg),
+            prepare_pad_count, &count));
+    fail_unless_equals_int (count, 8);
+    for (l = agg->sinkpads; l; l = l->next) {
+      fail_unless (g_object_get_data (l->data, "prepared"));
+      g_object_set_data (l->data, "prepared", NULL);
+    }
+
+    count = 0;
+    fail_if (gst_aggregator_prepare_sink_pads (GST_AGGREGATOR (agg),
+            prepare_pad_fail, &count));
+    /* only the pool prepares the pads after a failure */
+    fail_unless_equals_int (count, threads[i] == 1 ? 1 : 8);
+  }
+
+  gst_check_teardown_element (agg);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_aggregator_suite (void)
 {
@@ -1485,6 +1537,7 @@ gst_aggregator_suite (void)
   tcase_add_test (general, test_flush_on_aggregate);
   tcase_add_test (general, test_remove_pad_on_aggregate);
   tcase_add_test (general, test_force_live);
+  tcase_add_test (general, test_prepare_sink_pads);
 
   return suite;
 }
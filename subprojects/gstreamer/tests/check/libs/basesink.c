@@ -23,6 +23,7 @@
 #endif
 #include <gst/gst.h>
 #include <gst/check/gstcheck.h>
+#include <gst/check/gsttestclock.h>
 #include <gst/base/gstbasesink.h>
 
 GST_START_TEST (basesink_last_sample_enabled)
@@ -345,6 +346,105 @@ GST_START_TEST (basesink_stream_start_after_eos)
 
 GST_END_TEST;
 
+static gpointer
+push_buffer_list (gpointer data)
+{
+  GstPad *pad = data;
+  GstBufferList *list;
+  GstBuffer *buf;
+  guint i;
+
+  list = gst_buffer_list_new ();
+  for (i = 0; i < 3; i++) {
+    buf = gst_buffer_new_and_alloc (4);
+    GST_BUFFER_PTS (buf) = (i + 1) * GST_SECOND;
+    GST_BUFFER_DURATION (buf) = GST_SECOND;
+    gst_buffer_list_add (list, buf);
+  }
+
+  return GINT_TO_POINTER (gst_pad_chain_list (pad, list));
+}
+
+/* pushes a list of buffers from 1 to 4 seconds when the clock is at @now and
+ * returns the rendered and dropped counts */
+static void
+sync_buffer_list (GstClockTime now, guint64 * rendered, guint64 * dropped)
+{
+  GstElement *pipeline, *sink;
+  GstClock *clock;
+  GstClockID id;
+  GstPad *pad;
+  GstEvent *ev;
+  GstSegment segment;
+  GstStructure *stats;
+  GThread *thread;
+  GstFlowReturn ret;
+
+  sink = gst_element_factory_make ("fakesink", "sink");
+  g_object_set (sink, "async", FALSE, "sync", TRUE, "max-lateness",
+      G_GINT64_CONSTANT (0), NULL);
+  pad = gst_element_get_static_pad (sink, "sink");
+
+  pipeline = gst_pipeline_new (NULL);
+  gst_bin_add (GST_BIN (pipeline), sink);
+
+  clock = gst_test_clock_new ();
+  gst_pipeline_use_clock (GST_PIPELINE (pipeline), clock);
+
+  fail_unless_equals_int (gst_element_set_state (pipeline, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_SUCCESS);
+
+  ev = gst_event_new_stream_start ("test");
+  fail_unless (gst_pad_send_event (pad, ev));
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  ev = gst_event_new_segment (&segment);
+  fail_unless (gst_pad_send_event (pad, ev));
+
+  gst_test_clock_set_time (GST_TEST_CLOCK (clock), now);
+
+  thread = g_thread_new ("push-thread", push_buffer_list, pad);
+
+  /* one wait for the whole list, on the start of its first buffer */
+  gst_test_clock_wait_for_next_pending_id (GST_TEST_CLOCK (clock), &id);
+  fail_unless_equals_uint64 (gst_clock_id_get_time (id), GST_SECOND);
+  gst_clock_id_unref (id);
+  fail_unless (gst_test_clock_crank (GST_TEST_CLOCK (clock)));
+
+  ret = GPOINTER_TO_INT (g_thread_join (thread));
+  fail_unless_equals_int (ret, GST_FLOW_OK);
+  fail_unless_equals_int (gst_test_clock_peek_id_count (GST_TEST_CLOCK
+          (clock)), 0);
+
+  g_object_get (sink, "stats", &stats, NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "rendered", rendered));
+  fail_unless (gst_structure_get_uint64 (stats, "dropped", dropped));
+  gst_structure_free (stats);
+
+  fail_unless_equals_int (gst_element_set_state (pipeline, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (clock);
+  gst_object_unref (pad);
+  gst_object_unref (pipeline);
+}
+
+GST_START_TEST (basesink_sync_buffer_list)
+{
+  guint64 rendered, dropped;
+
+  /* late for the first buffers, but not for the end of the list */
+  sync_buffer_list (3500 * GST_MSECOND, &rendered, &dropped);
+  fail_unless_equals_uint64 (rendered, 3);
+  fail_unless_equals_uint64 (dropped, 0);
+
+  /* past the end of the list, all of it is dropped */
+  sync_buffer_list (4500 * GST_MSECOND, &rendered, &dropped);
+  fail_unless_equals_uint64 (rendered, 0);
+  fail_unless_equals_uint64 (dropped, 3);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_basesrc_suite (void)
 {
@@ -358,6 +458,7 @@ gst_basesrc_suite (void)
   tcase_add_test (tc, basesink_test_eos_after_playing);
   tcase_add_test (tc, basesink_position_query_handles_segment_offset);
   tcase_add_test (tc, basesink_stream_start_after_eos);
+  tcase_add_test (tc, basesink_sync_buffer_list);
 
   return s;
 }
@@ -0,0 +1,234 @@
+/* GStreamer
+ *
+ * unit test for the pattern scanning of GstByteReader and GstAdapter
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+
+/* not public API, and the kernels are only selected by the CPU */
+#include "../../../libs/gst/base/gstbytescan.c"
+
+typedef gssize (*ScanStartCodeFunc) (const guint8 * data, gsize size);
+
+/* long enough for several iterations of all the vector loops and a tail */
+static const gsize scan_sizes[] = { 64, 66, 67, 96, 99, 100, 128, 131, 200 };
+
+static gssize
+scan_reference (const guint8 * data, gsize size, guint32 mask,
+    guint32 pattern)
+{
+  gsize i;
+
+  for (i = 0; i + 4 <= size; i++) {
+    if ((GST_READ_UINT32_BE (data + i) & mask) == pattern)
+      return i;
+  }
+
+  return -1;
+}
+
+static gssize
+scan_start_code_c (const guint8 * data, gsize size)
+{
+  return scan_start_code_scalar (data, size, 0);
+}
+
+/* a single start code at every position, with near misses in front of it */
+static void
+check_start_code_lanes (const gchar * name, ScanStartCodeFunc func)
+{
+  guint s;
+
+  for (s = 0; s < G_N_ELEMENTS (scan_sizes); s++) {
+    gsize size = scan_sizes[s];
+    gsize pos;
+
+    for (pos = 0; pos + 4 <= size; pos++) {
+      guint8 *data = g_malloc (size);
+      gssize found;
+
+      memset (data, 0x80, size);
+      if (pos >= 3) {
+        /* 00 00 02 does not match */
+        data[pos - 3] = 0x00;
+        data[pos - 2] = 0x00;
+        data[pos - 1] = 0x02;
+      }
+      data[pos] = 0x00;
+      data[pos + 1] = 0x00;
+      data[pos + 2] = 0x01;
+      data[pos + 3] = 0xb3;
+
+      found = func (data, size);
+      fail_unless (found == (gssize) pos, "%s: start code at %"
+          G_GSIZE_FORMAT " of %" G_GSIZE_FORMAT " bytes found at %"
+          G_GSSIZE_FORMAT, name, pos, size, found);
+      /* without the last byte of the pattern */
+      if (pos > 0) {
+        found = func (data, pos + 3);
+        fail_unless (found == -1, "%s: start code at %" G_GSIZE_FORMAT
+            " found at %" G_GSSIZE_FORMAT " without its last byte", name, pos,
+            found);
+      }
+
+      g_free (data);
+    }
+  }
+}
+
+/* data with many zeros and ones, scanned from every offset */
+static void
+check_start_code_random (const gchar * name, ScanStartCodeFunc func)
+{
+  static const guint8 values[] = { 0x00, 0x00, 0x00, 0x01, 0x01, 0xb3 };
+  GRand *rand = g_rand_new_with_seed (0x5ca7);
+  guint s, round;
+
+  for (round = 0; round < 20; round++) {
+    for (s = 0; s < G_N_ELEMENTS (scan_sizes); s++) {
+      gsize size = scan_sizes[s];
+      guint8 *data = g_malloc (size);
+      gsize i, offset;
+
+      for (i = 0; i < size; i++) {
+        /* mostly bytes that can't be part of a start code, so that the
+         * matches are spread over the lanes */
+        if (g_rand_int_range (rand, 0, 8) == 0)
+          data[i] = values[g_rand_int_range (rand, 0, G_N_ELEMENTS (values))];
+        else
+          data[i] = 0x80;
+      }
+
+      for (offset = 0; offset < 40; offset++) {
+        gssize ref = scan_reference (data + offset, size - offset,
+            GST_BYTE_SCAN_START_CODE_MASK, GST_BYTE_SCAN_START_CODE_PATTERN);
+        gssize found = func (data + offset, size - offset);
+
+        fail_unless (found == ref, "%s: %" G_GSIZE_FORMAT
+            " bytes from offset %" G_GSIZE_FORMAT ", found %" G_GSSIZE_FORMAT
+            " instead of %" G_GSSIZE_FORMAT, name, size, offset, found, ref);
+      }
+
+      g_free (data);
+    }
+  }
+
+  g_rand_free (rand);
+}
+
+static void
+check_start_code_kernel (const gchar * name, ScanStartCodeFunc func)
+{
+  check_start_code_lanes (name, func);
+  check_start_code_random (name, func);
+}
+
+GST_START_TEST (test_scan_start_code_kernels)
+{
+  check_start_code_kernel ("C", scan_start_code_c);
+#ifdef HAVE_SCAN_SSE2
+  check_start_code_kernel ("SSE2", scan_start_code_sse2);
+#endif
+#ifdef HAVE_SCAN_AVX2
+  if (__builtin_cpu_supports ("avx2"))
+    check_start_code_kernel ("AVX2", scan_start_code_avx2);
+#endif
+#ifdef HAVE_SCAN_NEON
+  check_start_code_kernel ("NEON", scan_start_code_neon);
+#endif
+  /* and whatever is selected for this CPU */
+  check_start_code_kernel ("default", scan_start_code);
+}
+
+GST_END_TEST;
+
+/* full, partial and mostly zero masks, which take the memchr() and the
+ * scalar paths */
+GST_START_TEST (test_scan_masked)
+{
+  static const guint32 masks[] = {
+    GST_BYTE_SCAN_START_CODE_MASK, 0xffffffff, 0xff000000, 0x00ff0000,
+    0x0000ff00, 0x000000ff, 0xffe00000, 0x00f00000, 0x0000000f, 0x80000000,
+    0x00000001, 0xf0f0f0f0, 0x00000000
+  };
+  GRand *rand = g_rand_new_with_seed (0x3a5c);
+  guint s, m, round;
+
+  for (round = 0; round < 20; round++) {
+    for (s = 0; s < G_N_ELEMENTS (scan_sizes); s++) {
+      gsize size = scan_sizes[s];
+      guint8 *data = g_malloc (size);
+      gsize i;
+
+      for (i = 0; i < size; i++)
+        data[i] = g_rand_int_range (rand, 0, 4) ? 0x00 : g_rand_int (rand);
+
+      for (m = 0; m < G_N_ELEMENTS (masks); m++) {
+        guint32 mask = masks[m];
+        guint32 patterns[2];
+        gsize pos, offset;
+        guint p;
+
+        /* a pattern that is in the data, and one that might not be */
+        pos = g_rand_int_range (rand, 0, size - 3);
+        patterns[0] = GST_READ_UINT32_BE (data + pos) & mask;
+        patterns[1] = ~patterns[0] & mask;
+
+        for (p = 0; p < G_N_ELEMENTS (patterns); p++) {
+          for (offset = 0; offset < 40; offset++) {
+            gssize ref = scan_reference (data + offset, size - offset, mask,
+                patterns[p]);
+            gssize found = _gst_byte_scan_masked_uint32 (data + offset,
+                size - offset, mask, patterns[p]);
+
+            fail_unless (found == ref, "mask 0x%08x pattern 0x%08x, %"
+                G_GSIZE_FORMAT " bytes from offset %" G_GSIZE_FORMAT
+                ", found %" G_GSSIZE_FORMAT " instead of %" G_GSSIZE_FORMAT,
+                mask, patterns[p], size, offset, found, ref);
+          }
+        }
+      }
+
+      g_free (data);
+    }
+  }
+
+  g_rand_free (rand);
+}
+
+GST_END_TEST;
+
+static Suite *
+gst_byte_scan_suite (void)
+{
+  Suite *s = suite_create ("GstByteScan");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+
+  tcase_add_test (tc_chain, test_scan_start_code_kernels);
+  tcase_add_test (tc_chain, test_scan_masked);
+
+  return s;
+}
+
+GST_CHECK_MAIN (gst_byte_scan);
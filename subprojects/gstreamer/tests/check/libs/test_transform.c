@@ -84,6 +84,10 @@ GstFlowReturn (*klass_submit_input_buffer) (GstBaseTransform * trans,
     gboolean is_discont, GstBuffer * input) = NULL;
 GstFlowReturn (*klass_generate_output) (GstBaseTransform * trans,
     GstBuffer ** outbuf) = NULL;
+static GstFlowReturn (*klass_transform_list_ip) (GstBaseTransform * trans,
+    GstBufferList * list) = NULL;
+static GstFlowReturn (*klass_transform_list) (GstBaseTransform * trans,
+    GstBufferList * inlist, GstBufferList * outlist) = NULL;
 
 static GstStaticPadTemplate *sink_template = &gst_test_trans_sink_template;
 static GstStaticPadTemplate *src_template = &gst_test_trans_src_template;
@@ -122,6 +126,10 @@ gst_test_trans_class_init (GstTestTransClass * klass)
     trans_class->submit_input_buffer = klass_submit_input_buffer;
   if (klass_generate_output)
     trans_class->generate_output = klass_generate_output;
+  if (klass_transform_list_ip != NULL)
+    trans_class->transform_list_ip = klass_transform_list_ip;
+  if (klass_transform_list != NULL)
+    trans_class->transform_list = klass_transform_list;
 }
 
 static void
@@ -282,6 +282,232 @@ GST_START_TEST (basetransform_chain_ip1)
 
 GST_END_TEST;
 
+static guint transform_list_ip_1_called;
+static guint transform_list_ip_1_length;
+static gboolean transform_list_ip_1_writable;
+
+static gboolean
+check_writable (GstBuffer ** buffer, guint idx, gpointer user_data)
+{
+  if (!gst_buffer_is_writable (*buffer))
+    transform_list_ip_1_writable = FALSE;
+
+  return TRUE;
+}
+
+static GstFlowReturn
+transform_list_ip_1 (GstBaseTransform * trans, GstBufferList * list)
+{
+  GST_DEBUG_OBJECT (trans, "transform_list_ip called");
+
+  transform_list_ip_1_called++;
+  transform_list_ip_1_length = gst_buffer_list_length (list);
+  transform_list_ip_1_writable = TRUE;
+  gst_buffer_list_foreach (list, check_writable, NULL);
+
+  return GST_FLOW_OK;
+}
+
+/* in-place with a list vmethod, a buffer list should be transformed with one
+ * call and all its buffers should be writable */
+GST_START_TEST (basetransform_chain_list_ip)
+{
+  TestTransData *trans;
+  GstBufferList *list;
+  GstBuffer *buffer, *extra;
+  GstFlowReturn res;
+  guint i;
+
+  klass_transform_ip = transform_ip_1;
+  klass_transform_list_ip = transform_list_ip_1;
+  trans = gst_test_trans_new ();
+
+  gst_test_trans_push_segment (trans);
+
+  list = gst_buffer_list_new ();
+  for (i = 0; i < 3; i++) {
+    buffer = gst_buffer_new_and_alloc (20);
+    GST_BUFFER_PTS (buffer) = i * GST_SECOND;
+    GST_BUFFER_DURATION (buffer) = GST_SECOND;
+    gst_buffer_list_add (list, buffer);
+  }
+  /* one non-writable buffer, a copy should be transformed */
+  extra = gst_buffer_ref (gst_buffer_list_get (list, 1));
+
+  transform_ip_1_called = FALSE;
+  transform_list_ip_1_called = 0;
+  res = gst_pad_push_list (trans->srcpad, list);
+  fail_unless (res == GST_FLOW_OK);
+  fail_unless (transform_ip_1_called == FALSE);
+  fail_unless_equals_int (transform_list_ip_1_called, 1);
+  fail_unless_equals_int (transform_list_ip_1_length, 3);
+  fail_unless (transform_list_ip_1_writable == TRUE);
+
+  for (i = 0; i < 3; i++) {
+    buffer = gst_test_trans_pop (trans);
+    fail_unless (buffer != NULL);
+    fail_unless (buffer != extra);
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (buffer), i * GST_SECOND);
+    gst_buffer_unref (buffer);
+  }
+  fail_unless (gst_test_trans_pop (trans) == NULL);
+  gst_buffer_unref (extra);
+
+  gst_test_trans_free (trans);
+}
+
+GST_END_TEST;
+
+static guint buffer_probe_called;
+
+static GstPadProbeReturn
+count_buffer_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  buffer_probe_called++;
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* without a list vmethod, the buffers of a list should go through the buffer
+ * probes of the sink pad one by one */
+GST_START_TEST (basetransform_chain_list_split)
+{
+  TestTransData *trans;
+  GstBufferList *list;
+  GstBuffer *buffer;
+  GstPad *sinkpad;
+  GstFlowReturn res;
+  guint i;
+
+  klass_transform_ip = transform_ip_1;
+  trans = gst_test_trans_new ();
+
+  gst_test_trans_push_segment (trans);
+
+  sinkpad = gst_element_get_static_pad (trans->trans, "sink");
+  gst_pad_add_probe (sinkpad, GST_PAD_PROBE_TYPE_BUFFER, count_buffer_probe,
+      NULL, NULL);
+
+  list = gst_buffer_list_new ();
+  for (i = 0; i < 3; i++)
+    gst_buffer_list_add (list, gst_buffer_new_and_alloc (20));
+
+  buffer_probe_called = 0;
+  res = gst_pad_push_list (trans->srcpad, list);
+  fail_unless (res == GST_FLOW_OK);
+  fail_unless_equals_int (buffer_probe_called, 3);
+
+  for (i = 0; i < 3; i++) {
+    buffer = gst_test_trans_pop (trans);
+    fail_unless (buffer != NULL);
+    gst_buffer_unref (buffer);
+  }
+  fail_unless (gst_test_trans_pop (trans) == NULL);
+
+  gst_object_unref (sinkpad);
+  gst_test_trans_free (trans);
+}
+
+GST_END_TEST;
+
+static GstBufferPool *bounded_pool;
+static guint bounded_pool_lengths[5];
+static guint bounded_pool_transformed;
+static guint bounded_pool_pushed[5];
+static guint bounded_pool_lists;
+
+static GstFlowReturn
+transform_bounded_pool (GstBaseTransform * trans, GstBuffer * inbuf,
+    GstBuffer * outbuf)
+{
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+transform_list_bounded_pool (GstBaseTransform * trans, GstBufferList * inlist,
+    GstBufferList * outlist)
+{
+  GST_DEBUG_OBJECT (trans, "transform_list called");
+
+  fail_unless_equals_int (gst_buffer_list_length (inlist),
+      gst_buffer_list_length (outlist));
+  fail_unless (bounded_pool_transformed < G_N_ELEMENTS (bounded_pool_lengths));
+  bounded_pool_lengths[bounded_pool_transformed++] =
+      gst_buffer_list_length (outlist);
+
+  return GST_FLOW_OK;
+}
+
+static gboolean
+bounded_pool_sink_query (GstPad * pad, GstObject * parent, GstQuery * query)
+{
+  if (GST_QUERY_TYPE (query) == GST_QUERY_ALLOCATION) {
+    gst_query_add_allocation_pool (query, bounded_pool, 20, 0, 2);
+    return TRUE;
+  }
+
+  return gst_pad_query_default (pad, parent, query);
+}
+
+/* releases the buffers to the pool right away */
+static GstFlowReturn
+bounded_pool_sink_chain_list (GstPad * pad, GstObject * parent,
+    GstBufferList * list)
+{
+  fail_unless (bounded_pool_lists < G_N_ELEMENTS (bounded_pool_pushed));
+  bounded_pool_pushed[bounded_pool_lists++] = gst_buffer_list_length (list);
+  gst_buffer_list_unref (list);
+
+  return GST_FLOW_OK;
+}
+
+/* copy-transform with a list vmethod and a downstream pool of 2 buffers, a
+ * longer list should be pushed in parts instead of waiting for the pool */
+GST_START_TEST (basetransform_chain_list_bounded_pool)
+{
+  TestTransData *trans;
+  GstBufferList *list;
+  GstFlowReturn res;
+  GstCaps *caps;
+  guint i;
+
+  klass_transform = transform_bounded_pool;
+  klass_transform_list = transform_list_bounded_pool;
+  trans = gst_test_trans_new ();
+
+  bounded_pool = gst_buffer_pool_new ();
+  gst_pad_set_query_function (trans->sinkpad, bounded_pool_sink_query);
+  gst_pad_set_chain_list_function (trans->sinkpad,
+      bounded_pool_sink_chain_list);
+
+  caps = gst_caps_new_empty_simple ("foo/x-bar");
+  fail_unless (gst_test_trans_setcaps (trans, caps));
+  gst_test_trans_push_segment (trans);
+  gst_caps_unref (caps);
+
+  list = gst_buffer_list_new ();
+  for (i = 0; i < 5; i++)
+    gst_buffer_list_add (list, gst_buffer_new_and_alloc (20));
+
+  bounded_pool_transformed = 0;
+  bounded_pool_lists = 0;
+  res = gst_pad_push_list (trans->srcpad, list);
+  fail_unless (res == GST_FLOW_OK);
+
+  fail_unless_equals_int (bounded_pool_transformed, 3);
+  fail_unless_equals_int (bounded_pool_lists, 3);
+  for (i = 0; i < 3; i++) {
+    fail_unless_equals_int (bounded_pool_lengths[i], i < 2 ? 2 : 1);
+    fail_unless_equals_int (bounded_pool_pushed[i], i < 2 ? 2 : 1);
+  }
+  fail_unless (gst_test_trans_pop (trans) == NULL);
+
+  gst_test_trans_free (trans);
+  gst_object_unref (bounded_pool);
+}
+
+GST_END_TEST;
+
 static gboolean set_caps_1_called;
 
 static gboolean
@@ -960,6 +1186,8 @@ transform1_teardown (void)
   klass_fixate_caps = NULL;
   klass_submit_input_buffer = NULL;
   klass_generate_output = NULL;
+  klass_transform_list_ip = NULL;
+  klass_transform_list = NULL;
 }
 
 static Suite *
@@ -977,6 +1205,9 @@ gst_basetransform_suite (void)
   /* in place */
   tcase_add_test (tc, basetransform_chain_ip1);
   tcase_add_test (tc, basetransform_chain_ip2);
+  tcase_add_test (tc, basetransform_chain_list_ip);
+  tcase_add_test (tc, basetransform_chain_list_split);
+  tcase_add_test (tc, basetransform_chain_list_bounded_pool);
   /* copy transform */
   tcase_add_test (tc, basetransform_chain_ct1);
   tcase_add_test (tc, basetransform_chain_ct2);
@@ -0,0 +1,550 @@
+/* GStreamer
+ *
+ * gst-debug-decode.c: format the logs written by the binary logger
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "tools.h"
+
+/* The file layout is described in gst/gstinfo.c, keep in sync */
+#define BINARY_LOG_MAGIC "GSTBLOG"
+#define BINARY_LOG_VERSION 1
+#define BINARY_LOG_BYTE_ORDER 0x01020304
+#define BINARY_LOG_ALIGN(s) (((s) + 7) & ~((gsize) 7))
+
+typedef enum
+{
+  BINARY_LOG_ARG_INT,
+  BINARY_LOG_ARG_DOUBLE,
+  BINARY_LOG_ARG_STRING,
+  BINARY_LOG_ARG_NULL_STRING,
+} GstBinaryLogArgType;
+
+#define BINARY_LOG_RECORD_PREFORMATTED (1 << 0)
+
+typedef struct
+{
+  guint32 size;
+  guint8 level;
+  guint8 flags;
+  guint16 n_args;
+  guint64 ts;
+  guint32 category;
+  guint32 file;
+  guint32 function;
+  guint32 format;
+  gint32 line;
+  guint32 id_len;
+} GstBinaryLogRecord;
+
+typedef struct
+{
+  guint32 type;
+  guint32 len;
+} GstBinaryLogArg;
+
+typedef struct
+{
+  GstBinaryLogArgType type;
+  guint32 len;
+  const guint8 *data;
+} Arg;
+
+typedef struct
+{
+  guint64 thread;
+  const guint8 *record;
+  guint64 seqnum;
+} Entry;
+
+typedef struct
+{
+  const guint8 *data;
+  gsize size;
+  gsize pos;
+} Reader;
+
+static guint32 pid;
+static gchar **strings = NULL;
+static guint32 n_strings = 0;
+
+static gboolean
+read_bytes (Reader * reader, gsize size, const guint8 ** data)
+{
+  if (reader->size - reader->pos < size)
+    return FALSE;
+
+  *data = reader->data + reader->pos;
+  reader->pos += size;
+  return TRUE;
+}
+
+static gboolean
+read_uint32 (Reader * reader, guint32 * val)
+{
+  const guint8 *data;
+
+  if (!read_bytes (reader, sizeof (guint32), &data))
+    return FALSE;
+
+  memcpy (val, data, sizeof (guint32));
+  return TRUE;
+}
+
+static gboolean
+read_uint64 (Reader * reader, guint64 * val)
+{
+  const guint8 *data;
+
+  if (!read_bytes (reader, sizeof (guint64), &data))
+    return FALSE;
+
+  memcpy (val, data, sizeof (guint64));
+  return TRUE;
+}
+
+static const gchar *
+get_string (guint32 id)
+{
+  if (id == 0 || id > n_strings)
+    return "?";
+  return strings[id - 1];
+}
+
+static guint64
+arg_get_int (const Arg * arg)
+{
+  guint64 val = 0;
+
+  if (arg && arg->type == BINARY_LOG_ARG_INT)
+    memcpy (&val, arg->data, sizeof (guint64));
+  return val;
+}
+
+static gdouble
+arg_get_double (const Arg * arg)
+{
+  gdouble val = 0.0;
+
+  if (arg && arg->type == BINARY_LOG_ARG_DOUBLE)
+    memcpy (&val, arg->data, sizeof (gdouble));
+  return val;
+}
+
+/* Returns a newly allocated string, or %NULL for NULL strings */
+static gchar *
+arg_get_string (const Arg * arg)
+{
+  if (arg && arg->type == BINARY_LOG_ARG_STRING)
+    return g_strndup ((const gchar *) arg->data, arg->len);
+  if (arg && arg->type == BINARY_LOG_ARG_NULL_STRING)
+    return NULL;
+  return g_strdup ("?");
+}
+
+/* Replays @format with the stored arguments, the same way the logging side
+ * collected them */
+static void
+format_message (GString * out, const gchar * format, const Arg * args,
+    guint n_args)
+{
+  GString *spec = g_string_new (NULL);
+  const gchar *p = format, *next;
+  const Arg *arg;
+  guint n = 0;
+  gchar conv;
+
+#define NEXT_ARG() (n < n_args ? &args[n++] : NULL)
+
+  while ((next = strchr (p, '%'))) {
+    g_string_append_len (out, p, next - p);
+    p = next + 1;
+
+    if (*p == '%') {
+      g_string_append_c (out, '%');
+      p++;
+      continue;
+    }
+
+    g_string_assign (spec, "%");
+    while (*p && strchr ("-+ #0'", *p))
+      g_string_append_c (spec, *p++);
+
+    do {
+      if (*p == '.')
+        g_string_append_c (spec, *p++);
+      if (*p == '*') {
+        g_string_append_printf (spec, "%d", (gint) arg_get_int (NEXT_ARG ()));
+        p++;
+      } else {
+        while (g_ascii_isdigit (*p))
+          g_string_append_c (spec, *p++);
+      }
+    } while (*p == '.');
+
+    /* all integers were stored as 64 bits */
+    while (*p && strchr ("hlqLjzt", *p))
+      p++;
+    if (p[0] == 'I' && p[1] == '6' && p[2] == '4')
+      p += 3;
+
+    conv = *p;
+    if (conv == '\0')
+      break;
+    p++;
+
+    arg = NEXT_ARG ();
+    switch (conv) {
+      case 'd':
+      case 'i':
+        g_string_append_printf (spec, "%s%c", G_GINT64_MODIFIER, conv);
+        g_string_append_printf (out, spec->str, (gint64) arg_get_int (arg));
+        break;
+      case 'o':
+      case 'u':
+      case 'x':
+      case 'X':
+        g_string_append_printf (spec, "%s%c", G_GINT64_MODIFIER, conv);
+        g_string_append_printf (out, spec->str, arg_get_int (arg));
+        break;
+      case 'c':
+        g_string_append_c (spec, conv);
+        g_string_append_printf (out, spec->str, (gint) arg_get_int (arg));
+        break;
+      case 'e':
+      case 'E':
+      case 'f':
+      case 'F':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
+        g_string_append_c (spec, conv);
+        g_string_append_printf (out, spec->str, arg_get_double (arg));
+        break;
+      case 's':{
+        gchar *str = arg_get_string (arg);
+
+        g_string_append_c (spec, conv);
+        g_string_append_printf (out, spec->str, str ? str : "(null)");
+        g_free (str);
+        break;
+      }
+      case 'p':
+        if (p[0] == '\a' && p[1] != '\0') {
+          /* GST_PTR_FORMAT and friends were formatted when logging */
+          gchar *str = arg_get_string (arg);
+
+          g_string_append (out, str ? str : "(NULL)");
+          g_free (str);
+          p += 2;
+        } else if (arg_get_int (arg) == 0) {
+          g_string_append (out, "(nil)");
+        } else {
+          g_string_append_printf (out, "0x%" G_GINT64_MODIFIER "x",
+              arg_get_int (arg));
+        }
+        break;
+      default:
+        g_string_append_c (out, '?');
+        break;
+    }
+  }
+  g_string_append (out, p);
+
+#undef NEXT_ARG
+
+  g_string_free (spec, TRUE);
+}
+
+static gboolean
+print_record (GString * out, guint64 thread, const guint8 * data)
+{
+  GstBinaryLogRecord record;
+  Arg args[G_MAXUINT8];
+  GstBinaryLogArg arg;
+  Reader reader;
+  const guint8 *id = NULL;
+  gchar *object, *thread_str;
+  guint i;
+
+  memcpy (&record, data, sizeof (GstBinaryLogRecord));
+  reader.data = data;
+  reader.size = record.size;
+  reader.pos = sizeof (GstBinaryLogRecord);
+
+  if (record.id_len && !read_bytes (&reader, BINARY_LOG_ALIGN (record.id_len),
+          &id))
+    return FALSE;
+
+  if (record.n_args > G_N_ELEMENTS (args))
+    return FALSE;
+
+  for (i = 0; i < record.n_args; i++) {
+    const guint8 *arg_data;
+
+    if (!read_bytes (&reader, sizeof (GstBinaryLogArg), &arg_data))
+      return FALSE;
+    memcpy (&arg, arg_data, sizeof (GstBinaryLogArg));
+
+    args[i].type = arg.type;
+    args[i].len = arg.len;
+    if (!read_bytes (&reader, BINARY_LOG_ALIGN (arg.len), &args[i].data))
+      return FALSE;
+  }
+
+  if (id)
+    object = g_strdup_printf ("<%.*s>", (gint) record.id_len, id);
+  else
+    object = g_strdup ("");
+  thread_str = g_strdup_printf ("0x%" G_GINT64_MODIFIER "x", thread);
+
+  /* same layout as the default log function without colors */
+  g_string_truncate (out, 0);
+  g_string_append_printf (out, "%" GST_TIME_FORMAT " %5u %14s %s %20s "
+      "%s:%d:%s:%s ", GST_TIME_ARGS (record.ts), pid, thread_str,
+      gst_debug_level_get_name (record.level), get_string (record.category),
+      get_string (record.file), record.line, get_string (record.function),
+      object);
+
+  g_free (thread_str);
+  g_free (object);
+
+  if (record.flags & BINARY_LOG_RECORD_PREFORMATTED) {
+    gchar *message = arg_get_string (record.n_args ? &args[0] : NULL);
+
+    g_string_append (out, message ? message : "");
+    g_free (message);
+  } else {
+    format_message (out, get_string (record.format), args, record.n_args);
+  }
+
+  g_print ("%s\n", out->str);
+
+  return TRUE;
+}
+
+static gint
+compare_entries (gconstpointer a, gconstpointer b)
+{
+  const Entry *entry1 = a, *entry2 = b;
+  guint64 ts1, ts2;
+
+  memcpy (&ts1, entry1->record + G_STRUCT_OFFSET (GstBinaryLogRecord, ts),
+      sizeof (guint64));
+  memcpy (&ts2, entry2->record + G_STRUCT_OFFSET (GstBinaryLogRecord, ts),
+      sizeof (guint64));
+
+  if (ts1 != ts2)
+    return ts1 < ts2 ? -1 : 1;
+  /* keep the order of the records of the same thread */
+  return entry1->seqnum < entry2->seqnum ? -1 : 1;
+}
+
+static gboolean
+decode (const gchar * filename, gboolean per_thread)
+{
+  gchar *contents = NULL;
+  gsize length;
+  GError *err = NULL;
+  GArray *entries;
+  GString *out;
+  Reader reader;
+  const guint8 *data;
+  guint32 val, n_threads, i;
+  gboolean ret = FALSE;
+  guint64 seqnum = 0;
+
+  if (!g_file_get_contents (filename, &contents, &length, &err)) {
+    g_printerr ("Could not read %s: %s\n", filename, err->message);
+    g_clear_error (&err);
+    return FALSE;
+  }
+
+  reader.data = (const guint8 *) contents;
+  reader.size = length;
+  reader.pos = 0;
+  entries = g_array_new (FALSE, FALSE, sizeof (Entry));
+  out = g_string_new (NULL);
+
+  if (!read_bytes (&reader, sizeof (BINARY_LOG_MAGIC), &data)
+      || memcmp (data, BINARY_LOG_MAGIC, sizeof (BINARY_LOG_MAGIC)) != 0)
+    goto not_binary_log;
+
+  if (!read_uint32 (&reader, &val))
+    goto truncated;
+  if (val != BINARY_LOG_VERSION)
+    goto wrong_version;
+
+  if (!read_uint32 (&reader, &val))
+    goto truncated;
+  if (val != BINARY_LOG_BYTE_ORDER)
+    goto wrong_byte_order;
+
+  if (!read_uint32 (&reader, &pid) || !read_uint32 (&reader, &n_strings))
+    goto truncated;
+
+  strings = g_new0 (gchar *, n_strings + 1);
+  for (i = 0; i < n_strings; i++) {
+    if (!read_uint32 (&reader, &val) || !read_bytes (&reader, val, &data))
+      goto truncated;
+    strings[i] = g_strndup ((const gchar *) data, val);
+  }
+
+  if (!read_uint32 (&reader, &n_threads))
+    goto truncated;
+
+  for (i = 0; i < n_threads; i++) {
+    Reader records;
+    Entry entry;
+    guint64 size;
+
+    if (!read_uint64 (&reader, &entry.thread) || !read_uint64 (&reader, &size)
+        || !read_bytes (&reader, size, &data))
+      goto truncated;
+
+    records.data = data;
+    records.size = size;
+    records.pos = 0;
+    while (records.pos < records.size) {
+      guint32 record_size;
+
+      if (!read_uint32 (&records, &record_size)
+          || record_size < sizeof (GstBinaryLogRecord))
+        goto truncated;
+
+      records.pos -= sizeof (guint32);
+      if (!read_bytes (&records, record_size, &entry.record))
+        goto truncated;
+
+      entry.seqnum = seqnum++;
+      g_array_append_val (entries, entry);
+    }
+  }
+
+  if (!per_thread)
+    g_array_sort (entries, compare_entries);
+
+  for (i = 0; i < entries->len; i++) {
+    Entry *entry = &g_array_index (entries, Entry, i);
+
+    if (!print_record (out, entry->thread, entry->record))
+      goto truncated;
+  }
+
+  ret = TRUE;
+
+done:
+  g_string_free (out, TRUE);
+  g_array_unref (entries);
+  g_strfreev (strings);
+  strings = NULL;
+  g_free (contents);
+
+  return ret;
+
+not_binary_log:
+  g_printerr ("%s is not a binary log file\n", filename);
+  goto done;
+wrong_version:
+  g_printerr ("%s was written with an unsupported version %u\n", filename,
+      val);
+  goto done;
+wrong_byte_order:
+  g_printerr ("%s was written on a machine with a different byte order\n",
+      filename);
+  goto done;
+truncated:
+  g_printerr ("%s is truncated or corrupted\n", filename);
+  goto done;
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  gchar **filenames = NULL;
+  gboolean per_thread = FALSE;
+  guint num;
+  gint ret;
+  GError *err = NULL;
+  GOptionContext *ctx;
+  GOptionEntry options[] = {
+    GST_TOOLS_GOPTION_VERSION,
+    {"per-thread", 't', 0, G_OPTION_ARG_NONE, &per_thread,
+        "Print the messages of each thread in turn instead of merging them "
+          "by time", NULL},
+    {G_OPTION_REMAINING, 0, 0, G_OPTION_ARG_FILENAME_ARRAY, &filenames, NULL}
+    ,
+    {NULL}
+  };
+
+#ifdef ENABLE_NLS
+  bindtextdomain (GETTEXT_PACKAGE, LOCALEDIR);
+  bind_textdomain_codeset (GETTEXT_PACKAGE, "UTF-8");
+  textdomain (GETTEXT_PACKAGE);
+#endif
+
+  g_set_prgname ("gst-debug-decode-" GST_API_VERSION);
+
+#ifdef G_OS_WIN32
+  argv = g_win32_get_command_line ();
+#endif
+
+  ctx = g_option_context_new ("FILE");
+  g_option_context_add_main_entries (ctx, options, GETTEXT_PACKAGE);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+#ifdef G_OS_WIN32
+  if (!g_option_context_parse_strv (ctx, &argv, &err))
+#else
+  if (!g_option_context_parse (ctx, &argc, &argv, &err))
+#endif
+  {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    exit (1);
+  }
+  g_option_context_free (ctx);
+
+  gst_tools_print_version ();
+
+  if (filenames == NULL || *filenames == NULL) {
+    g_print ("Please give one filename to %s\n\n", g_get_prgname ());
+    return 1;
+  }
+  num = g_strv_length (filenames);
+  if (num > 1) {
+    g_print ("Please give exactly one filename to %s (%d given).\n\n",
+        g_get_prgname (), num);
+    return 1;
+  }
+
+  ret = decode (filenames[0], per_thread) ? 0 : 1;
+
+  g_strfreev (filenames);
+
+#ifdef G_OS_WIN32
+  g_strfreev (argv);
+#endif
+
+  return ret;
+}